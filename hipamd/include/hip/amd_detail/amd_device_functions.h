@@ -946,6 +946,68 @@ unsigned __smid(void)
 #define HIP_DYNAMIC_SHARED(type, var) extern __shared__ type var[];
 #define HIP_DYNAMIC_SHARED_ATTRIBUTE
 
+/**
+ * Layout of the device graph, returned by hipExtGraphExecGetDeviceGraph(). The header is
+ * followed by packet_count AQL packets of 64 bytes. Must match hip::GraphDeviceLaunch.
+ */
+struct __hip_device_graph {
+    unsigned int packet_count;
+    unsigned int reserved[15];
+};
+
+// The leading fields of hsa_queue_t
+struct __hip_hsa_queue {
+    unsigned int type;
+    unsigned int features;
+    unsigned long long base_address;
+    __ockl_hsa_signal_t doorbell_signal;
+    unsigned int size;
+};
+
+/*
+  __hipGraphLaunch copies the packets of a device graph into the queue of the current dispatch
+  and rings the doorbell. The packets have the barrier bit set, hence the graph starts after the
+  calling kernel completes. Must be called from a single work item.
+*/
+__device__
+inline
+void __hipGraphLaunch(const void* deviceGraph)
+{
+    auto graph = static_cast<const __hip_device_graph*>(deviceGraph);
+    auto queuePtr = (__attribute__((address_space(1))) void*)(
+        (unsigned long long)__builtin_amdgcn_queue_ptr());
+    auto queue = (const __attribute__((address_space(1))) __hip_hsa_queue*)queuePtr;
+    const unsigned int count = graph->packet_count;
+    const unsigned long long* src = reinterpret_cast<const unsigned long long*>(graph + 1);
+    unsigned long long* ring = reinterpret_cast<unsigned long long*>(queue->base_address);
+    const unsigned long long size = queue->size;
+    unsigned long long index =
+        __ockl_hsa_queue_add_write_index(queuePtr, count, __ATOMIC_RELAXED);
+    unsigned long long read = __ockl_hsa_queue_load_read_index(queuePtr, __ATOMIC_ACQUIRE);
+    for (unsigned int i = 0; i < count; ++i, src += 8) {
+        // Publish the written packets and wait for a free slot
+        while ((index + i - read) >= size) {
+            if (i != 0) {
+                __ockl_hsa_signal_store(queue->doorbell_signal, index + i - 1, __ATOMIC_RELEASE);
+            }
+            __builtin_amdgcn_s_sleep(1);
+            read = __ockl_hsa_queue_load_read_index(queuePtr, __ATOMIC_ACQUIRE);
+        }
+        unsigned long long* dst = ring + ((index + i) & (size - 1)) * 8;
+        for (int j = 1; j < 8; ++j) {
+            dst[j] = src[j];
+        }
+        // Dispatch packets keep workgroup_size_x/y in the upper half of the first qword
+        reinterpret_cast<unsigned int*>(dst)[1] = static_cast<unsigned int>(src[0] >> 32);
+        // The header and setup make the packet valid, hence write them last
+        __hip_atomic_store(reinterpret_cast<unsigned int*>(dst), static_cast<unsigned int>(src[0]),
+                           __ATOMIC_RELEASE, __HIP_MEMORY_SCOPE_SYSTEM);
+    }
+    if (count != 0) {
+        __ockl_hsa_signal_store(queue->doorbell_signal, index + count - 1, __ATOMIC_RELEASE);
+    }
+}
+
 #endif //defined(__clang__) && defined(__HIP__)
 
 
@@ -1327,6 +1327,169 @@ unsigned long long atomicXor_system(unsigned long long* address, unsigned long l
   return __hip_atomic_fetch_xor(address, val, __ATOMIC_RELAXED, __HIP_MEMORY_SCOPE_SYSTEM);
 }
 
+// Atomics with an explicit memory scope and memory order, e.g.
+//   atomicAdd_explicit<__HIP_MEMORY_SCOPE_WORKGROUP, __ATOMIC_RELAXED>(&hist[bin], 1u);
+// The scope is __HIP_MEMORY_SCOPE_WAVEFRONT, _WORKGROUP, _AGENT or _SYSTEM and the order is
+// __ATOMIC_RELAXED, _ACQUIRE, _RELEASE, _ACQ_REL or _SEQ_CST. A relaxed atomic with a narrow
+// scope doesn't emit cache maintenance, which suits the histogram and counter kernels.
+// The default variants above keep the gfx941 CAS loop workaround, these don't.
+template<typename T> struct hip_atomic_nondeduced { using type = T; };
+
+template<int mem_scope, int mem_order>
+struct hip_atomic_explicit_check {
+  static_assert(mem_scope >= __HIP_MEMORY_SCOPE_WAVEFRONT &&
+                mem_scope <= __HIP_MEMORY_SCOPE_SYSTEM, "Invalid atomic memory scope");
+  static_assert(mem_order == __ATOMIC_RELAXED || mem_order == __ATOMIC_ACQUIRE ||
+                mem_order == __ATOMIC_RELEASE || mem_order == __ATOMIC_ACQ_REL ||
+                mem_order == __ATOMIC_SEQ_CST, "Invalid atomic memory order");
+  // The failure order of a CAS can't contain a release
+  static constexpr int failure_order = (mem_order == __ATOMIC_RELEASE) ? __ATOMIC_RELAXED :
+      ((mem_order == __ATOMIC_ACQ_REL) ? __ATOMIC_ACQUIRE : mem_order);
+};
+
+template<int mem_scope, int mem_order = __ATOMIC_RELAXED, typename T>
+__device__
+inline
+T atomicAdd_explicit(T* address, typename hip_atomic_nondeduced<T>::type val) {
+  (void)hip_atomic_explicit_check<mem_scope, mem_order>{};
+  return __hip_atomic_fetch_add(address, val, mem_order, mem_scope);
+}
+
+template<int mem_scope, int mem_order = __ATOMIC_RELAXED, typename T>
+__device__
+inline
+T atomicSub_explicit(T* address, typename hip_atomic_nondeduced<T>::type val) {
+  (void)hip_atomic_explicit_check<mem_scope, mem_order>{};
+  return __hip_atomic_fetch_add(address, -val, mem_order, mem_scope);
+}
+
+template<int mem_scope, int mem_order = __ATOMIC_RELAXED, typename T>
+__device__
+inline
+T atomicExch_explicit(T* address, typename hip_atomic_nondeduced<T>::type val) {
+  (void)hip_atomic_explicit_check<mem_scope, mem_order>{};
+  return __hip_atomic_exchange(address, val, mem_order, mem_scope);
+}
+
+template<int mem_scope, int mem_order = __ATOMIC_RELAXED, typename T>
+__device__
+inline
+T atomicCAS_explicit(T* address, typename hip_atomic_nondeduced<T>::type compare,
+                     typename hip_atomic_nondeduced<T>::type val) {
+  using check = hip_atomic_explicit_check<mem_scope, mem_order>;
+  __hip_atomic_compare_exchange_strong(address, &compare, val, mem_order, check::failure_order,
+                                       mem_scope);
+  return compare;
+}
+
+template<int mem_scope, int mem_order = __ATOMIC_RELAXED, typename T>
+__device__
+inline
+T atomicMin_explicit(T* address, typename hip_atomic_nondeduced<T>::type val) {
+  (void)hip_atomic_explicit_check<mem_scope, mem_order>{};
+  return __hip_atomic_fetch_min(address, val, mem_order, mem_scope);
+}
+
+template<int mem_scope, int mem_order = __ATOMIC_RELAXED, typename T>
+__device__
+inline
+T atomicMax_explicit(T* address, typename hip_atomic_nondeduced<T>::type val) {
+  (void)hip_atomic_explicit_check<mem_scope, mem_order>{};
+  return __hip_atomic_fetch_max(address, val, mem_order, mem_scope);
+}
+
+template<int mem_scope, int mem_order = __ATOMIC_RELAXED, typename T>
+__device__
+inline
+T atomicAnd_explicit(T* address, typename hip_atomic_nondeduced<T>::type val) {
+  (void)hip_atomic_explicit_check<mem_scope, mem_order>{};
+  return __hip_atomic_fetch_and(address, val, mem_order, mem_scope);
+}
+
+template<int mem_scope, int mem_order = __ATOMIC_RELAXED, typename T>
+__device__
+inline
+T atomicOr_explicit(T* address, typename hip_atomic_nondeduced<T>::type val) {
+  (void)hip_atomic_explicit_check<mem_scope, mem_order>{};
+  return __hip_atomic_fetch_or(address, val, mem_order, mem_scope);
+}
+
+template<int mem_scope, int mem_order = __ATOMIC_RELAXED, typename T>
+__device__
+inline
+T atomicXor_explicit(T* address, typename hip_atomic_nondeduced<T>::type val) {
+  (void)hip_atomic_explicit_check<mem_scope, mem_order>{};
+  return __hip_atomic_fetch_xor(address, val, mem_order, mem_scope);
+}
+
+// The wrapping increment and decrement map to the AMDGCN instructions, which take the scope
+// as a synchronization scope name
+#define __HIP_ATOMIC_WRAP_EXPLICIT(builtin, address, val, mem_scope, mem_order)                   \
+  ((mem_scope == __HIP_MEMORY_SCOPE_WAVEFRONT) ?                                                 \
+       builtin(address, val, mem_order, "wavefront") :                                           \
+   (mem_scope == __HIP_MEMORY_SCOPE_WORKGROUP) ?                                                 \
+       builtin(address, val, mem_order, "workgroup") :                                           \
+   (mem_scope == __HIP_MEMORY_SCOPE_AGENT) ? builtin(address, val, mem_order, "agent") :         \
+       builtin(address, val, mem_order, ""))
+
+template<int mem_scope, int mem_order = __ATOMIC_RELAXED>
+__device__
+inline
+unsigned int atomicInc_explicit(unsigned int* address, unsigned int val) {
+  (void)hip_atomic_explicit_check<mem_scope, mem_order>{};
+  return __HIP_ATOMIC_WRAP_EXPLICIT(__builtin_amdgcn_atomic_inc32, address, val, mem_scope,
+                                    mem_order);
+}
+
+template<int mem_scope, int mem_order = __ATOMIC_RELAXED>
+__device__
+inline
+unsigned long long atomicInc_explicit(unsigned long long* address, unsigned long long val) {
+  (void)hip_atomic_explicit_check<mem_scope, mem_order>{};
+  return __HIP_ATOMIC_WRAP_EXPLICIT(__builtin_amdgcn_atomic_inc64, address, val, mem_scope,
+                                    mem_order);
+}
+
+template<int mem_scope, int mem_order = __ATOMIC_RELAXED>
+__device__
+inline
+unsigned int atomicDec_explicit(unsigned int* address, unsigned int val) {
+  (void)hip_atomic_explicit_check<mem_scope, mem_order>{};
+  return __HIP_ATOMIC_WRAP_EXPLICIT(__builtin_amdgcn_atomic_dec32, address, val, mem_scope,
+                                    mem_order);
+}
+
+template<int mem_scope, int mem_order = __ATOMIC_RELAXED>
+__device__
+inline
+unsigned long long atomicDec_explicit(unsigned long long* address, unsigned long long val) {
+  (void)hip_atomic_explicit_check<mem_scope, mem_order>{};
+  return __HIP_ATOMIC_WRAP_EXPLICIT(__builtin_amdgcn_atomic_dec64, address, val, mem_scope,
+                                    mem_order);
+}
+
+#undef __HIP_ATOMIC_WRAP_EXPLICIT
+
+template<int mem_scope, int mem_order = __ATOMIC_RELAXED, typename T>
+__device__
+inline
+T atomicLoad_explicit(const T* address) {
+  (void)hip_atomic_explicit_check<mem_scope, mem_order>{};
+  static_assert(mem_order != __ATOMIC_RELEASE && mem_order != __ATOMIC_ACQ_REL,
+                "Invalid atomic load order");
+  return __hip_atomic_load(address, mem_order, mem_scope);
+}
+
+template<int mem_scope, int mem_order = __ATOMIC_RELAXED, typename T>
+__device__
+inline
+void atomicStore_explicit(T* address, typename hip_atomic_nondeduced<T>::type val) {
+  (void)hip_atomic_explicit_check<mem_scope, mem_order>{};
+  static_assert(mem_order != __ATOMIC_ACQUIRE && mem_order != __ATOMIC_ACQ_REL,
+                "Invalid atomic store order");
+  __hip_atomic_store(address, val, mem_order, mem_scope);
+}
+
 #else // __hip_atomic_compare_exchange_strong
 
 __device__
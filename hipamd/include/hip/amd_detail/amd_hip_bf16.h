@@ -146,6 +146,30 @@ static_assert(sizeof(__bf16) == sizeof(unsigned short),
 #define HIP_BF16_AVX512_OP 0
 #endif
 
+// The device compiler lowers the packed bf16 vectors to the packed instructions of the target,
+// i.e. v_pk_fma_bf16, and promotes the elements to float on the targets without them
+#if defined(__HIP_DEVICE_COMPILE__) && defined(__clang__) && (__clang_major__ >= 19)
+#define HIP_BF16_VECTOR_OP 1
+typedef __bf16 __hip_bf16x2_vec __attribute__((ext_vector_type(2)));
+typedef float __hip_f32x2_vec __attribute__((ext_vector_type(2)));
+#else
+#define HIP_BF16_VECTOR_OP 0
+#endif
+
+// v_dot2_f32_bf16
+#if HIP_BF16_VECTOR_OP && (defined(__GFX11__) || defined(__GFX12__) || defined(__gfx950__))
+#define HIP_BF16_DOT2_OP 1
+#else
+#define HIP_BF16_DOT2_OP 0
+#endif
+
+// v_cvt_pk_bf16_f32 with the round to nearest even
+#if HIP_BF16_VECTOR_OP && defined(__gfx950__)
+#define HIP_BF16_CVT_PK_OP 1
+#else
+#define HIP_BF16_CVT_PK_OP 0
+#endif
+
 #define HIPRT_ONE_BF16 __ushort_as_bfloat16((unsigned short)0x3F80U)
 #define HIPRT_ZERO_BF16 __ushort_as_bfloat16((unsigned short)0x0000U)
 #define HIPRT_INF_BF16 __ushort_as_bfloat16((unsigned short)0x7F80U)
@@ -516,6 +540,58 @@ __BF16_HOST_DEVICE_STATIC__ __hip_bfloat16 __float2bfloat16(float f) {
   return ret;
 }
 
+/**
+ * \ingroup HIP_INTRINSIC_BFLOAT16_CONV
+ * \brief Converts float to bfloat16, rounds to nearest even
+ */
+__BF16_HOST_DEVICE_STATIC__ __hip_bfloat16 __float2bfloat16_rn(const float f) {
+  return __float2bfloat16(f);
+}
+
+/**
+ * \ingroup HIP_INTRINSIC_BFLOAT16_CONV
+ * \brief Truncates float to bfloat16 and rounds up the magnitude if requested. NaN stays quiet
+ */
+__BF16_HOST_DEVICE_STATIC__ __hip_bfloat16 __float2bfloat16_directed(const float f,
+                                                                     const bool round_up) {
+  union {
+    float fp32;
+    unsigned int u32;
+  } u = {f};
+  unsigned short ret = static_cast<unsigned short>(u.u32 >> 16);
+  if ((u.u32 & 0x7fffffff) > 0x7f800000) {
+    ret |= 0x40;
+  } else if (round_up && ((u.u32 & 0xffff) != 0)) {
+    // The carry out of the mantissa increments the exponent, the largest finite becomes Inf
+    ret++;
+  }
+  return __hip_bfloat16(__hip_bfloat16_raw{ret});
+}
+
+/**
+ * \ingroup HIP_INTRINSIC_BFLOAT16_CONV
+ * \brief Converts float to bfloat16, rounds towards zero
+ */
+__BF16_HOST_DEVICE_STATIC__ __hip_bfloat16 __float2bfloat16_rz(const float f) {
+  return __float2bfloat16_directed(f, false);
+}
+
+/**
+ * \ingroup HIP_INTRINSIC_BFLOAT16_CONV
+ * \brief Converts float to bfloat16, rounds down
+ */
+__BF16_HOST_DEVICE_STATIC__ __hip_bfloat16 __float2bfloat16_rd(const float f) {
+  return __float2bfloat16_directed(f, f < 0.0f);
+}
+
+/**
+ * \ingroup HIP_INTRINSIC_BFLOAT16_CONV
+ * \brief Converts float to bfloat16, rounds up
+ */
+__BF16_HOST_DEVICE_STATIC__ __hip_bfloat16 __float2bfloat16_ru(const float f) {
+  return __float2bfloat16_directed(f, f > 0.0f);
+}
+
 /**
  * \ingroup HIP_INTRINSIC_BFLOAT162_CONV
  * \brief Converts and moves bfloat162 to float2
@@ -573,9 +649,56 @@ __BF16_HOST_DEVICE_STATIC__ __hip_bfloat16 __double2bfloat16(const double a) {
  * \brief Convert float2 to __hip_bfloat162
  */
 __BF16_HOST_DEVICE_STATIC__ __hip_bfloat162 __float22bfloat162_rn(const float2 a) {
+#if HIP_BF16_CVT_PK_OP
+  __hip_bf16x2_vec v = __builtin_convertvector(__hip_f32x2_vec{a.x, a.y}, __hip_bf16x2_vec);
+  return __hip_bfloat162(__builtin_bit_cast(__hip_bfloat162_raw, v));
+#else
   return __hip_bfloat162{__float2bfloat16(a.x), __float2bfloat16(a.y)};
+#endif
 }
 
+/**
+ * \ingroup HIP_INTRINSIC_BFLOAT162_CONV
+ * \brief Convert float2 to __hip_bfloat162, rounds towards zero
+ */
+__BF16_HOST_DEVICE_STATIC__ __hip_bfloat162 __float22bfloat162_rz(const float2 a) {
+  return __hip_bfloat162{__float2bfloat16_rz(a.x), __float2bfloat16_rz(a.y)};
+}
+
+/**
+ * \ingroup HIP_INTRINSIC_BFLOAT162_CONV
+ * \brief Convert float2 to __hip_bfloat162, rounds down
+ */
+__BF16_HOST_DEVICE_STATIC__ __hip_bfloat162 __float22bfloat162_rd(const float2 a) {
+  return __hip_bfloat162{__float2bfloat16_rd(a.x), __float2bfloat16_rd(a.y)};
+}
+
+/**
+ * \ingroup HIP_INTRINSIC_BFLOAT162_CONV
+ * \brief Convert float2 to __hip_bfloat162, rounds up
+ */
+__BF16_HOST_DEVICE_STATIC__ __hip_bfloat162 __float22bfloat162_ru(const float2 a) {
+  return __hip_bfloat162{__float2bfloat16_ru(a.x), __float2bfloat16_ru(a.y)};
+}
+
+#if HIP_BF16_VECTOR_OP
+/**
+ * \ingroup HIP_INTRINSIC_BFLOAT162_CONV
+ * \brief Reinterprets __hip_bfloat162 as the packed bf16 vector of the device compiler
+ */
+__BF16_DEVICE_STATIC__ __hip_bf16x2_vec __bfloat162_as_vec(const __hip_bfloat162 a) {
+  return __builtin_bit_cast(__hip_bf16x2_vec, static_cast<__hip_bfloat162_raw>(a));
+}
+
+/**
+ * \ingroup HIP_INTRINSIC_BFLOAT162_CONV
+ * \brief Reinterprets the packed bf16 vector of the device compiler as __hip_bfloat162
+ */
+__BF16_DEVICE_STATIC__ __hip_bfloat162 __vec_as_bfloat162(const __hip_bf16x2_vec v) {
+  return __hip_bfloat162(__builtin_bit_cast(__hip_bfloat162_raw, v));
+}
+#endif
+
 /**
  * \ingroup HIP_INTRINSIC_BFLOAT162_CONV
  * \brief Combine two __hip_bfloat16 to __hip_bfloat162
@@ -877,7 +1000,13 @@ __BF16_HOST_DEVICE_STATIC__ __hip_bfloat162 __habs2(const __hip_bfloat162 a) {
  */
 __BF16_HOST_DEVICE_STATIC__ __hip_bfloat162 __hadd2(const __hip_bfloat162 a,
                                                     const __hip_bfloat162 b) {
+#if HIP_BF16_VECTOR_OP
+  // a * 1 + b is exact before the single rounding, hence it's the packed add
+  return __vec_as_bfloat162(__builtin_elementwise_fma(
+      __bfloat162_as_vec(a), __hip_bf16x2_vec{1.0f, 1.0f}, __bfloat162_as_vec(b)));
+#else
   return __hip_bfloat162(__hadd(a.x, b.x), __hadd(a.y, b.y));
+#endif
 }
 
 /**
@@ -886,7 +1015,12 @@ __BF16_HOST_DEVICE_STATIC__ __hip_bfloat162 __hadd2(const __hip_bfloat162 a,
  */
 __BF16_DEVICE_STATIC__ __hip_bfloat162 __hfma2(const __hip_bfloat162 a, const __hip_bfloat162 b,
                                                const __hip_bfloat162 c) {
+#if HIP_BF16_VECTOR_OP
+  return __vec_as_bfloat162(__builtin_elementwise_fma(__bfloat162_as_vec(a), __bfloat162_as_vec(b),
+                                                      __bfloat162_as_vec(c)));
+#else
   return __hip_bfloat162(__hfma(a.x, b.x, c.x), __hfma(a.y, b.y, c.y));
+#endif
 }
 
 /**
@@ -895,7 +1029,13 @@ __BF16_DEVICE_STATIC__ __hip_bfloat162 __hfma2(const __hip_bfloat162 a, const __
  */
 __BF16_HOST_DEVICE_STATIC__ __hip_bfloat162 __hmul2(const __hip_bfloat162 a,
                                                     const __hip_bfloat162 b) {
+#if HIP_BF16_VECTOR_OP
+  // Adding -0 keeps the sign of the zero products
+  return __vec_as_bfloat162(__builtin_elementwise_fma(
+      __bfloat162_as_vec(a), __bfloat162_as_vec(b), __hip_bf16x2_vec{-0.0f, -0.0f}));
+#else
   return __hip_bfloat162(__hmul(a.x, b.x), __hmul(a.y, b.y));
+#endif
 }
 
 /**
@@ -912,7 +1052,31 @@ __BF16_HOST_DEVICE_STATIC__ __hip_bfloat162 __hneg2(const __hip_bfloat162 a) {
  */
 __BF16_HOST_DEVICE_STATIC__ __hip_bfloat162 __hsub2(const __hip_bfloat162 a,
                                                     const __hip_bfloat162 b) {
+#if HIP_BF16_VECTOR_OP
+  return __vec_as_bfloat162(__builtin_elementwise_fma(
+      __bfloat162_as_vec(b), __hip_bf16x2_vec{-1.0f, -1.0f}, __bfloat162_as_vec(a)));
+#else
   return __hip_bfloat162(__hsub(a.x, b.x), __hsub(a.y, b.y));
+#endif
+}
+
+/**
+ * \ingroup HIP_INTRINSIC_BFLOAT162_ARITH
+ * \brief Dot product of two bfloat162 values, accumulated in float: a.x * b.x + a.y * b.y + c.
+ * The saturation clamps the result to [0, 1]
+ */
+__BF16_DEVICE_STATIC__ float amd_mixed_dot(const __hip_bfloat162 a, const __hip_bfloat162 b,
+                                           const float c, const bool saturate) {
+#if HIP_BF16_DOT2_OP
+  return saturate
+      ? __builtin_amdgcn_fdot2_f32_bf16(__bfloat162_as_vec(a), __bfloat162_as_vec(b), c, true)
+      : __builtin_amdgcn_fdot2_f32_bf16(__bfloat162_as_vec(a), __bfloat162_as_vec(b), c, false);
+#else
+  const float2 fa = a;
+  const float2 fb = b;
+  const float ret = __ocml_fma_f32(fa.y, fb.y, __ocml_fma_f32(fa.x, fb.x, c));
+  return saturate ? __builtin_amdgcn_fmed3f(ret, 0.0f, 1.0f) : ret;
+#endif
 }
 
 /**
@@ -0,0 +1,157 @@
+/*
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/**
+ *  @file  amd_detail/amd_hip_cache_policy.h
+ *
+ *  @brief Loads and stores with a cache policy.
+ *
+ *  __hip_load<policy>() and __hip_store<policy>() access scalar and vector types of 1, 2, 4,
+ *  8, 12 or 16 bytes. The policies don't use target specific bits, the compiler selects them:
+ *  - __HIP_CACHE_STREAMING maps to the non-temporal builtins (SLC, NT, TH_NT).
+ *  - __HIP_CACHE_GLOBAL and __HIP_CACHE_VOLATILE map to relaxed atomics of the agent and
+ *    the system scopes, which skip the per CU caches (GLC, SC0/SC1, SCOPE).
+ *  The __ldca, __ldcg, __ldcs, __ldlu, __ldcv and __stwb, __stcg, __stcs, __stwt wrappers
+ *  follow the CUDA names.
+ */
+
+#ifndef HIP_INCLUDE_HIP_AMD_DETAIL_AMD_HIP_CACHE_POLICY_H
+#define HIP_INCLUDE_HIP_AMD_DETAIL_AMD_HIP_CACHE_POLICY_H
+
+#if __HIP_CLANG_ONLY__ && defined(__cplusplus)
+#if !defined(__HIPCC_RTC__)
+#include "amd_hip_atomic.h"
+#include "host_defines.h"
+#endif
+
+//! Cache policy of a load or a store
+enum __hip_cache_policy {
+  __HIP_CACHE_DEFAULT = 0,    ///< The regular access, cached at all levels
+  __HIP_CACHE_STREAMING = 1,  ///< Non-temporal access, the data is evicted first
+  __HIP_CACHE_GLOBAL = 2,     ///< Skips the per CU caches, coherent across the device
+  __HIP_CACHE_VOLATILE = 3,   ///< Coherent with the host and the peer devices
+};
+
+typedef unsigned int __hip_cache_dword3 __attribute__((ext_vector_type(3)));
+typedef unsigned int __hip_cache_dword4 __attribute__((ext_vector_type(4)));
+
+//! The machine word of an access, a vector word keeps a single wide instruction
+template <unsigned int size> struct __hip_cache_word;
+template <> struct __hip_cache_word<1> { using type = unsigned char; };
+template <> struct __hip_cache_word<2> { using type = unsigned short; };
+template <> struct __hip_cache_word<4> { using type = unsigned int; };
+template <> struct __hip_cache_word<8> { using type = unsigned long long; };
+template <> struct __hip_cache_word<12> { using type = __hip_cache_dword3; };
+template <> struct __hip_cache_word<16> { using type = __hip_cache_dword4; };
+
+template <__hip_cache_policy policy, typename T>
+__device__ inline T __hip_load(const T* ptr) {
+  using W = typename __hip_cache_word<sizeof(T)>::type;
+  const W* src = reinterpret_cast<const W*>(ptr);
+  W word;
+  if constexpr (policy == __HIP_CACHE_STREAMING) {
+    word = __builtin_nontemporal_load(src);
+  } else if constexpr (policy == __HIP_CACHE_GLOBAL || policy == __HIP_CACHE_VOLATILE) {
+    constexpr int scope =
+        (policy == __HIP_CACHE_GLOBAL) ? __HIP_MEMORY_SCOPE_AGENT : __HIP_MEMORY_SCOPE_SYSTEM;
+    if constexpr (sizeof(T) <= 8) {
+      word = __hip_atomic_load(src, __ATOMIC_RELAXED, scope);
+    } else {
+      // The atomics are limited to 8 bytes, the wider types load every dword
+      const unsigned int* dwords = reinterpret_cast<const unsigned int*>(src);
+      for (unsigned int i = 0; i < sizeof(T) / sizeof(unsigned int); ++i) {
+        word[i] = __hip_atomic_load(dwords + i, __ATOMIC_RELAXED, scope);
+      }
+    }
+  } else {
+    word = *src;
+  }
+  T result;
+  __builtin_memcpy(&result, &word, sizeof(T));
+  return result;
+}
+
+template <__hip_cache_policy policy, typename T>
+__device__ inline void __hip_store(T* ptr, T value) {
+  using W = typename __hip_cache_word<sizeof(T)>::type;
+  W* dst = reinterpret_cast<W*>(ptr);
+  W word;
+  __builtin_memcpy(&word, &value, sizeof(T));
+  if constexpr (policy == __HIP_CACHE_STREAMING) {
+    __builtin_nontemporal_store(word, dst);
+  } else if constexpr (policy == __HIP_CACHE_GLOBAL || policy == __HIP_CACHE_VOLATILE) {
+    constexpr int scope =
+        (policy == __HIP_CACHE_GLOBAL) ? __HIP_MEMORY_SCOPE_AGENT : __HIP_MEMORY_SCOPE_SYSTEM;
+    if constexpr (sizeof(T) <= 8) {
+      __hip_atomic_store(dst, word, __ATOMIC_RELAXED, scope);
+    } else {
+      unsigned int* dwords = reinterpret_cast<unsigned int*>(dst);
+      for (unsigned int i = 0; i < sizeof(T) / sizeof(unsigned int); ++i) {
+        __hip_atomic_store(dwords + i, word[i], __ATOMIC_RELAXED, scope);
+      }
+    }
+  } else {
+    *dst = word;
+  }
+}
+
+// Loads: cache at all levels, cache globally, streaming, last use and volatile
+template <typename T> __device__ inline T __ldca(const T* ptr) {
+  return __hip_load<__HIP_CACHE_DEFAULT>(ptr);
+}
+
+template <typename T> __device__ inline T __ldcg(const T* ptr) {
+  return __hip_load<__HIP_CACHE_GLOBAL>(ptr);
+}
+
+template <typename T> __device__ inline T __ldcs(const T* ptr) {
+  return __hip_load<__HIP_CACHE_STREAMING>(ptr);
+}
+
+template <typename T> __device__ inline T __ldlu(const T* ptr) {
+  return __hip_load<__HIP_CACHE_STREAMING>(ptr);
+}
+
+template <typename T> __device__ inline T __ldcv(const T* ptr) {
+  return __hip_load<__HIP_CACHE_VOLATILE>(ptr);
+}
+
+// Stores: write back, cache globally, streaming and write through
+template <typename T> __device__ inline void __stwb(T* ptr, T value) {
+  __hip_store<__HIP_CACHE_DEFAULT>(ptr, value);
+}
+
+template <typename T> __device__ inline void __stcg(T* ptr, T value) {
+  __hip_store<__HIP_CACHE_GLOBAL>(ptr, value);
+}
+
+template <typename T> __device__ inline void __stcs(T* ptr, T value) {
+  __hip_store<__HIP_CACHE_STREAMING>(ptr, value);
+}
+
+template <typename T> __device__ inline void __stwt(T* ptr, T value) {
+  __hip_store<__HIP_CACHE_VOLATILE>(ptr, value);
+}
+
+#endif  // __HIP_CLANG_ONLY__ && defined(__cplusplus)
+
+#endif  // HIP_INCLUDE_HIP_AMD_DETAIL_AMD_HIP_CACHE_POLICY_H
@@ -310,6 +310,10 @@ class tiled_group : public thread_group {
 
 template <unsigned int size, class ParentCGTy> class thread_block_tile;
 
+namespace internal {
+struct collective;
+}  // namespace internal
+
 /** \brief   The coalesced_group cooperative group type
  *
  *  \details Represents a active thread group in a wavefront.
@@ -326,6 +330,7 @@ class coalesced_group : public thread_group {
   template <unsigned int fsize, class fparent>
   friend __CG_QUALIFIER__ coalesced_group
   binary_partition(const thread_block_tile<fsize, fparent>& tgrp, bool pred);
+  friend struct internal::collective;
 
   __CG_QUALIFIER__ coalesced_group new_tiled_group(unsigned int tile_size) const {
     const bool pow2 = ((tile_size & (tile_size - 1)) == 0);
@@ -928,6 +933,352 @@ __CG_QUALIFIER__ coalesced_group binary_partition(const thread_block_tile<size,
   }
 }
 #endif
+
+/**
+ *  Operators of the reduce and scan collectives
+ */
+template <typename T> struct plus {
+  __CG_QUALIFIER__ T operator()(T lhs, T rhs) const { return lhs + rhs; }
+};
+
+//! Returns the smaller value
+template <typename T> struct less {
+  __CG_QUALIFIER__ T operator()(T lhs, T rhs) const { return (rhs < lhs) ? rhs : lhs; }
+};
+
+//! Returns the larger value
+template <typename T> struct greater {
+  __CG_QUALIFIER__ T operator()(T lhs, T rhs) const { return (lhs < rhs) ? rhs : lhs; }
+};
+
+template <typename T> struct bit_and {
+  __CG_QUALIFIER__ T operator()(T lhs, T rhs) const { return lhs & rhs; }
+};
+
+template <typename T> struct bit_or {
+  __CG_QUALIFIER__ T operator()(T lhs, T rhs) const { return lhs | rhs; }
+};
+
+template <typename T> struct bit_xor {
+  __CG_QUALIFIER__ T operator()(T lhs, T rhs) const { return lhs ^ rhs; }
+};
+
+namespace internal {
+/**
+ *  Implementation of the reduce and scan collectives. The tiles exchange the values inside the
+ *  DPP rows of 16 lanes, the swizzle crosses the rows within 32 lanes, and only the upper half of
+ *  a wave64 goes through the LDS permute hardware. The sparse coalesced groups use the permute.
+ */
+struct collective {
+  // DPP controls
+  _CG_STATIC_CONST_DECL_ int kQuadPermXor1 = 0xB1;    //!< quad_perm:[1,0,3,2]
+  _CG_STATIC_CONST_DECL_ int kQuadPermXor2 = 0x4E;    //!< quad_perm:[2,3,0,1]
+  _CG_STATIC_CONST_DECL_ int kRowShr = 0x110;         //!< row_shr:1, plus the shift - 1
+  _CG_STATIC_CONST_DECL_ int kRowMirror = 0x140;      //!< Reverses the lanes of a row
+  _CG_STATIC_CONST_DECL_ int kRowHalfMirror = 0x141;  //!< Reverses the lanes of a half row
+  //! Swizzle in the bitmask mode: and_mask 0x1F, or_mask 0, xor_mask 0x10
+  _CG_STATIC_CONST_DECL_ int kSwizzleXor16 = 0x401F;
+
+  //! Moves every dword of the value with the lane operation
+  template <typename T, typename Move> __CG_STATIC_QUALIFIER__ T move(T var, Move lane_op) {
+    constexpr unsigned int kWords = (sizeof(T) + sizeof(int) - 1) / sizeof(int);
+    int words[kWords] = {};
+    __builtin_memcpy(words, &var, sizeof(T));
+    for (unsigned int i = 0; i < kWords; i++) {
+      words[i] = lane_op(words[i]);
+    }
+    __builtin_memcpy(&var, words, sizeof(T));
+    return var;
+  }
+
+  template <int dpp_ctrl, typename T> __CG_STATIC_QUALIFIER__ T move_dpp(T var) {
+    return move(var, [](int word) { return __hip_move_dpp_N<dpp_ctrl, 0xF, 0xF, true>(word); });
+  }
+
+  template <int pattern, typename T> __CG_STATIC_QUALIFIER__ T swizzle(T var) {
+    return move(var, [](int word) {
+      return static_cast<int>(__hip_ds_swizzle_N<pattern>(static_cast<unsigned int>(word)));
+    });
+  }
+
+  //! Reads the value of the source lane
+  template <typename T> __CG_STATIC_QUALIFIER__ T permute(T var, unsigned int lane) {
+    const int index = static_cast<int>(lane << 2);
+    return move(var, [index](int word) { return __builtin_amdgcn_ds_bpermute(index, word); });
+  }
+
+  //! Butterfly reduction, every lane of the tile receives the result
+  template <unsigned int size, typename T, typename Op>
+  __CG_STATIC_QUALIFIER__ T tile_reduce(T var, Op op) {
+    if (size > 1) {
+      var = op(var, move_dpp<kQuadPermXor1>(var));
+    }
+    if (size > 2) {
+      var = op(var, move_dpp<kQuadPermXor2>(var));
+    }
+    // The quads hold their results, hence the mirrors exchange the partial results of the pairs
+    if (size > 4) {
+      var = op(var, move_dpp<kRowHalfMirror>(var));
+    }
+    if (size > 8) {
+      var = op(var, move_dpp<kRowMirror>(var));
+    }
+    if (size > 16) {
+      var = op(var, swizzle<kSwizzleXor16>(var));
+    }
+#if __AMDGCN_WAVEFRONT_SIZE == 64
+    if (size > 32) {
+      var = op(var, permute(var, __lane_id() ^ 32));
+    }
+#endif
+    return var;
+  }
+
+  //! Hillis-Steele scan, which keeps the order of the operands
+  template <unsigned int size, typename T, typename Op>
+  __CG_STATIC_QUALIFIER__ T tile_inclusive_scan(T var, Op op) {
+    const unsigned int rank = __lane_id() & (size - 1);
+    // The lanes, shifted in from outside of the tile, are ignored
+    if (size > 1) {
+      T prev = move_dpp<kRowShr + 0>(var);
+      var = (rank >= 1) ? op(prev, var) : var;
+    }
+    if (size > 2) {
+      T prev = move_dpp<kRowShr + 1>(var);
+      var = (rank >= 2) ? op(prev, var) : var;
+    }
+    if (size > 4) {
+      T prev = move_dpp<kRowShr + 3>(var);
+      var = (rank >= 4) ? op(prev, var) : var;
+    }
+    if (size > 8) {
+      T prev = move_dpp<kRowShr + 7>(var);
+      var = (rank >= 8) ? op(prev, var) : var;
+    }
+    if (size > 16) {
+      T prev = permute(var, __lane_id() - 16);
+      var = (rank >= 16) ? op(prev, var) : var;
+    }
+#if __AMDGCN_WAVEFRONT_SIZE == 64
+    if (size > 32) {
+      T prev = permute(var, __lane_id() - 32);
+      var = (rank >= 32) ? op(prev, var) : var;
+    }
+#endif
+    return var;
+  }
+
+  template <unsigned int size, typename T, typename Op>
+  __CG_STATIC_QUALIFIER__ T tile_exclusive_scan(T var, Op op) {
+    T prev = permute(tile_inclusive_scan<size>(var, op), __lane_id() - 1);
+    return ((__lane_id() & (size - 1)) == 0) ? T{} : prev;
+  }
+
+  //! Returns the lane of the member, which is n members away from the current lane
+  __CG_STATIC_QUALIFIER__ int member_lane(const coalesced_group& g, unsigned int base, int n) {
+#if __AMDGCN_WAVEFRONT_SIZE == 64
+    return __fns64(g.coalesced_info.member_mask, base, n);
+#else
+    return __fns32(g.coalesced_info.member_mask, base, n);
+#endif
+  }
+
+  template <typename T, typename Op>
+  __CG_STATIC_QUALIFIER__ T coalesced_inclusive_scan(const coalesced_group& g, T var, Op op) {
+    if (g.size() == __AMDGCN_WAVEFRONT_SIZE) {
+      return tile_inclusive_scan<__AMDGCN_WAVEFRONT_SIZE>(var, op);
+    }
+    const unsigned int rank = g.thread_rank();
+    for (unsigned int offset = 1; offset < g.size(); offset <<= 1) {
+      const int lane = member_lane(g, __lane_id(), -static_cast<int>(offset + 1));
+      T prev = permute(var, (lane == -1) ? __lane_id() : lane);
+      var = (rank >= offset) ? op(prev, var) : var;
+    }
+    return var;
+  }
+
+  template <typename T, typename Op>
+  __CG_STATIC_QUALIFIER__ T coalesced_exclusive_scan(const coalesced_group& g, T var, Op op) {
+    var = coalesced_inclusive_scan(g, var, op);
+    const int lane = member_lane(g, __lane_id(), -2);
+    T prev = permute(var, (lane == -1) ? __lane_id() : lane);
+    return (g.thread_rank() == 0) ? T{} : prev;
+  }
+
+  template <typename T, typename Op>
+  __CG_STATIC_QUALIFIER__ T coalesced_reduce(const coalesced_group& g, T var, Op op) {
+    if (g.size() == __AMDGCN_WAVEFRONT_SIZE) {
+      return tile_reduce<__AMDGCN_WAVEFRONT_SIZE>(var, op);
+    }
+    // The last member holds the result of the scan
+    var = coalesced_inclusive_scan(g, var, op);
+    return permute(var, member_lane(g, 0, g.size()));
+  }
+};
+}  // namespace internal
+
+/** \brief   Reduces the values of all threads in the group
+ *
+ *  \details Every thread receives the result. The operator must be associative and commutative,
+ *           i.e. cooperative_groups::plus, less, greater, bit_and, bit_or or bit_xor.
+ */
+template <unsigned int size, class ParentCGTy, typename T, typename Op>
+__CG_QUALIFIER__ T reduce(const thread_block_tile<size, ParentCGTy>& g, T var, Op op) {
+  static_assert(is_valid_type<T>::value, "Neither an integer or float type.");
+  return internal::collective::tile_reduce<size>(var, op);
+}
+
+template <typename T, typename Op>
+__CG_QUALIFIER__ T reduce(const coalesced_group& g, T var, Op op) {
+  static_assert(is_valid_type<T>::value, "Neither an integer or float type.");
+  return internal::collective::coalesced_reduce(g, var, op);
+}
+
+/** \brief   Inclusive scan of the values in the order of the thread ranks
+ *
+ *  \details The operator must be associative.
+ */
+template <unsigned int size, class ParentCGTy, typename T, typename Op>
+__CG_QUALIFIER__ T inclusive_scan(const thread_block_tile<size, ParentCGTy>& g, T var, Op op) {
+  static_assert(is_valid_type<T>::value, "Neither an integer or float type.");
+  return internal::collective::tile_inclusive_scan<size>(var, op);
+}
+
+template <unsigned int size, class ParentCGTy, typename T>
+__CG_QUALIFIER__ T inclusive_scan(const thread_block_tile<size, ParentCGTy>& g, T var) {
+  return inclusive_scan(g, var, plus<T>());
+}
+
+template <typename T, typename Op>
+__CG_QUALIFIER__ T inclusive_scan(const coalesced_group& g, T var, Op op) {
+  static_assert(is_valid_type<T>::value, "Neither an integer or float type.");
+  return internal::collective::coalesced_inclusive_scan(g, var, op);
+}
+
+template <typename T> __CG_QUALIFIER__ T inclusive_scan(const coalesced_group& g, T var) {
+  return inclusive_scan(g, var, plus<T>());
+}
+
+/** \brief   Exclusive scan of the values in the order of the thread ranks
+ *
+ *  \details The operator must be associative. The thread of rank 0 receives a value initialized T.
+ */
+template <unsigned int size, class ParentCGTy, typename T, typename Op>
+__CG_QUALIFIER__ T exclusive_scan(const thread_block_tile<size, ParentCGTy>& g, T var, Op op) {
+  static_assert(is_valid_type<T>::value, "Neither an integer or float type.");
+  return internal::collective::tile_exclusive_scan<size>(var, op);
+}
+
+template <unsigned int size, class ParentCGTy, typename T>
+__CG_QUALIFIER__ T exclusive_scan(const thread_block_tile<size, ParentCGTy>& g, T var) {
+  return exclusive_scan(g, var, plus<T>());
+}
+
+template <typename T, typename Op>
+__CG_QUALIFIER__ T exclusive_scan(const coalesced_group& g, T var, Op op) {
+  static_assert(is_valid_type<T>::value, "Neither an integer or float type.");
+  return internal::collective::coalesced_exclusive_scan(g, var, op);
+}
+
+template <typename T> __CG_QUALIFIER__ T exclusive_scan(const coalesced_group& g, T var) {
+  return exclusive_scan(g, var, plus<T>());
+}
+
+// The targets with the direct loads from the global memory into LDS
+#if defined(__gfx940__) || defined(__gfx941__) || defined(__gfx942__) || defined(__gfx950__)
+#define __HIP_CG_GLOBAL_LOAD_LDS__ 1
+#endif
+
+namespace internal {
+/**
+ *  Implementation of memcpy_async. The direct loads bypass the VGPRs and write LDS when they
+ *  return, so the wave continues with the independent work. Other targets copy with the widest
+ *  vector, which the alignment allows, and the compiler waits for the loads only at their stores.
+ */
+struct async_copy {
+  using uint4_vec = unsigned int __attribute__((ext_vector_type(4)));
+
+  //! Copies count words, the group threads take the consecutive words
+  template <typename Word>
+  __CG_STATIC_QUALIFIER__ void strided(void* dst, const void* src, size_t count,
+                                       unsigned int rank, unsigned int stride) {
+    Word* dst_words = static_cast<Word*>(dst);
+    const Word* src_words = static_cast<const Word*>(src);
+    for (size_t i = rank; i < count; i += stride) {
+      dst_words[i] = src_words[i];
+    }
+  }
+
+  __CG_STATIC_QUALIFIER__ void vectorized(void* dst, const void* src, size_t size,
+                                          unsigned int rank, unsigned int stride) {
+    const uintptr_t alignment = reinterpret_cast<uintptr_t>(dst) |
+                                reinterpret_cast<uintptr_t>(src);
+    size_t done = 0;
+    if ((alignment % sizeof(uint4_vec)) == 0) {
+      done = size & ~(sizeof(uint4_vec) - 1);
+      strided<uint4_vec>(dst, src, done / sizeof(uint4_vec), rank, stride);
+    } else if ((alignment % sizeof(unsigned int)) == 0) {
+      done = size & ~(sizeof(unsigned int) - 1);
+      strided<unsigned int>(dst, src, done / sizeof(unsigned int), rank, stride);
+    }
+    strided<unsigned char>(static_cast<char*>(dst) + done, static_cast<const char*>(src) + done,
+                           size - done, rank, stride);
+  }
+
+#if defined(__HIP_CG_GLOBAL_LOAD_LDS__)
+  //! Loads the dwords directly into LDS. Each lane of a wave writes the dword at its lane id
+  //! after the wave uniform LDS address, hence the waves take the consecutive slices
+  __CG_STATIC_QUALIFIER__ void direct(void* dst, const void* src, size_t size,
+                                      unsigned int rank, unsigned int stride) {
+    typedef __attribute__((address_space(1))) unsigned int global_word;
+    typedef __attribute__((address_space(3))) unsigned int local_word;
+    const size_t count = size / sizeof(unsigned int);
+    const unsigned int wave_base = rank & ~(__AMDGCN_WAVEFRONT_SIZE - 1);
+    global_word* src_words = (global_word*)(src);
+    local_word* dst_words = (local_word*)(dst);
+    for (size_t i = 0; i < count; i += stride) {
+      if ((i + rank) < count) {
+        __builtin_amdgcn_global_load_lds(src_words + i + rank, dst_words + i + wave_base,
+                                         sizeof(unsigned int), 0, 0);
+      }
+    }
+    const size_t done = count * sizeof(unsigned int);
+    strided<unsigned char>(static_cast<char*>(dst) + done, static_cast<const char*>(src) + done,
+                           size - done, rank, stride);
+  }
+#endif
+};
+}  // namespace internal
+
+/** \brief   Copies the global memory into the shared memory with all threads of the group
+ *
+ *  \details The copy completes at cooperative_groups::wait(), so the kernel can overlap the
+ *           loads of the next tile with the compute on the current one. dst must be shared memory
+ *           and all threads must pass the same arguments.
+ */
+template <class CGTy>
+__CG_QUALIFIER__ void memcpy_async(const CGTy& g, void* dst, const void* src, size_t size) {
+#if defined(__HIP_CG_GLOBAL_LOAD_LDS__)
+  // The direct loads need whole waves, which only the block guarantees
+  if (std::is_same<CGTy, thread_block>::value &&
+      (((reinterpret_cast<uintptr_t>(dst) | reinterpret_cast<uintptr_t>(src)) %
+        sizeof(unsigned int)) == 0)) {
+    internal::async_copy::direct(dst, src, size, g.thread_rank(), g.size());
+    return;
+  }
+#endif
+  internal::async_copy::vectorized(dst, src, size, g.thread_rank(), g.size());
+}
+
+/** \brief   Waits for the memcpy_async copies of the calling threads and synchronizes the group
+ */
+template <class CGTy> __CG_QUALIFIER__ void wait(const CGTy& g) {
+#if defined(__HIP_CG_GLOBAL_LOAD_LDS__)
+  // The compiler doesn't track the LDS writes of the direct loads across the group
+  __builtin_amdgcn_s_waitcnt(0);
+#endif
+  g.sync();
+}
 }  // namespace cooperative_groups
 
 #endif  // __cplusplus
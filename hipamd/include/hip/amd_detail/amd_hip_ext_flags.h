@@ -0,0 +1,76 @@
+/*
+Copyright (c) 2026 - Present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#ifndef HIP_INCLUDE_HIP_AMD_DETAIL_AMD_HIP_EXT_FLAGS_H
+#define HIP_INCLUDE_HIP_AMD_DETAIL_AMD_HIP_EXT_FLAGS_H
+
+/**
+ * @file amd_hip_ext_flags.h
+ * @brief AMD specific flags and attributes, accepted by the HIP runtime APIs in addition to
+ * the values of hip_runtime_api.h
+ */
+
+#if defined(__HIP_PLATFORM_AMD__) && !defined(__HIP_PLATFORM_NVIDIA__)
+
+#include <hip/hip_runtime_api.h>
+
+/*! Extended hipStreamCreateWithFlags flags, selecting the host wait policy of the stream */
+#define hipExtStreamWaitSpin      0x10000000  ///< Busy wait, for the latency critical streams
+#define hipExtStreamWaitBlocking  0x20000000  ///< Blocked wait, for the background streams
+#define hipExtStreamWaitAdaptive  0x40000000  ///< Busy wait for the predicted completion time
+
+/*! Extended hipMemPoolAttr telemetry attributes, uint64_t values. Set to 0 resets all counters */
+#define hipExtMemPoolAttrAllocReused          0x1000  ///< Allocations served from the free heap
+#define hipExtMemPoolAttrAllocNew             0x1001  ///< Allocations, which required new memory
+#define hipExtMemPoolAttrReuseSameStream      0x1002  ///< Reuses on the stream of release
+#define hipExtMemPoolAttrReuseEventDependency 0x1003  ///< Reuses, allowed by event dependencies
+#define hipExtMemPoolAttrReuseOpportunistic   0x1004  ///< Reuses, allowed by a retired HIP event
+#define hipExtMemPoolAttrFragmentation        0x1005  ///< Reserved, but unused memory in percent
+#define hipExtMemPoolAttrFragmentationHigh    0x1006  ///< Peak of the fragmentation since reset
+
+/*! Extended hipExtMallocWithFlags flags, the MALL (Infinity Cache) residency hints */
+#define hipExtMallocMallPreferred 0x100  ///< Keep the allocation in the MALL, i.e. lookup tables
+#define hipExtMallocMallBypass    0x200  ///< Stream the allocation around the MALL
+
+/*! Large page hints of the allocations. The size is aligned up to the page size */
+#define hipExtMallocLargePage2M   0x400  ///< hipExtMallocWithFlags, 2MB fragments
+#define hipExtMallocLargePage1G   0x800  ///< hipExtMallocWithFlags, 1GB contiguous memory
+#define hipExtHostAllocLargePage  0x00100000  ///< hipExtHostAlloc, 2MB transparent huge pages
+#define hipExtMemCreateUsageLargePage2M 0x100  ///< hipMemAllocationProp::allocFlags::usage
+#define hipExtMemCreateUsageLargePage1G 0x200  ///< hipMemAllocationProp::allocFlags::usage
+
+/*! hipPointerGetAttribute attribute, the page size achieved by the allocation, size_t value */
+#define HIP_POINTER_ATTRIBUTE_EXT_PAGE_SIZE ((hipPointer_attribute)0x1000)
+
+/*! hipExtLaunchCooperativeKernel flag. The grid sync uses the runtime hierarchical barrier */
+#define hipExtCooperativeLaunchHierarchicalSync 0x100
+
+/*! The array storage is a reserved VA range, bound to the physical memory by hipMemMapArrayAsync */
+#ifndef hipArraySparse
+#define hipArraySparse 0x40
+#endif
+
+#endif  // defined(__HIP_PLATFORM_AMD__) && !defined(__HIP_PLATFORM_NVIDIA__)
+
+#endif  // HIP_INCLUDE_HIP_AMD_DETAIL_AMD_HIP_EXT_FLAGS_H
@@ -1549,6 +1549,137 @@ THE SOFTWARE.
                                     c, saturate);
             }
             #endif
+            // Complex half, the real part is in the low half. The operations work on both
+            // parts at once with the packed v_pk_* instructions
+            #if defined(__clang__) && defined(__HIP__)
+            typedef __half2 hipHalfComplex;
+
+            inline
+            __device__
+            hipHalfComplex make_hipHalfComplex(__half a, __half b) { return __half2{a, b}; }
+            inline
+            __device__
+            __half hipCrealh(hipHalfComplex z) { return __low2half(z); }
+            inline
+            __device__
+            __half hipCimagh(hipHalfComplex z) { return __high2half(z); }
+            inline
+            __device__
+            hipHalfComplex hipConjh(hipHalfComplex z)
+            {
+                _Float16_2 v = static_cast<__half2_raw>(z).data;
+                return __half2{_Float16_2{v.x, -v.y}};
+            }
+            inline
+            __device__
+            hipHalfComplex hipCaddh(hipHalfComplex p, hipHalfComplex q) { return __hadd2(p, q); }
+            inline
+            __device__
+            hipHalfComplex hipCsubh(hipHalfComplex p, hipHalfComplex q) { return __hsub2(p, q); }
+            inline
+            __device__
+            hipHalfComplex hipCfmah(hipHalfComplex p, hipHalfComplex q, hipHalfComplex r)
+            {
+                // (px * qx, px * qy) + (-py * qy, py * qx) + r with two packed FMAs
+                _Float16_2 a = static_cast<__half2_raw>(p).data;
+                _Float16_2 b = static_cast<__half2_raw>(q).data;
+                _Float16_2 t = __ocml_fma_2f16(a.xx, b, static_cast<__half2_raw>(r).data);
+                return __half2{__ocml_fma_2f16(a.yy, _Float16_2{-b.y, b.x}, t)};
+            }
+            inline
+            __device__
+            hipHalfComplex hipCmulh(hipHalfComplex p, hipHalfComplex q)
+            {
+                _Float16_2 a = static_cast<__half2_raw>(p).data;
+                _Float16_2 b = static_cast<__half2_raw>(q).data;
+                return __half2{__ocml_fma_2f16(a.yy, _Float16_2{-b.y, b.x}, a.xx * b)};
+            }
+            // The magnitude is computed in float with a single dot2, since the squares of
+            // the half values overflow above 256
+            inline
+            __device__
+            float hipCsqabsh(hipHalfComplex z)
+            {
+                _Float16_2 v = static_cast<__half2_raw>(z).data;
+                return __ockl_fdot2(v, v, 0.0f, false);
+            }
+            inline
+            __device__
+            float hipCabsh(hipHalfComplex z) { return __builtin_sqrtf(hipCsqabsh(z)); }
+            inline
+            __device__
+            hipHalfComplex hipCdivh(hipHalfComplex p, hipHalfComplex q)
+            {
+                _Float16_2 a = static_cast<__half2_raw>(p).data;
+                _Float16_2 b = static_cast<__half2_raw>(q).data;
+                float scale = 1.0f / hipCsqabsh(q);
+                float re = __ockl_fdot2(a, b, 0.0f, false) * scale;
+                float im = __ockl_fdot2(a, _Float16_2{-b.y, b.x}, 0.0f, false) * scale;
+                return __half2{_Float16_2{static_cast<_Float16>(re), static_cast<_Float16>(im)}};
+            }
+
+            // Packed half4 and half8 vectors, every pair of lanes maps to a v_pk_* instruction
+            typedef _Float16 _Float16_4 __attribute__((ext_vector_type(4)));
+            typedef _Float16 _Float16_8 __attribute__((ext_vector_type(8)));
+
+            struct __half4 { _Float16_4 data; };
+            struct __half8 { _Float16_8 data; };
+
+            inline
+            __device__
+            __half4 __half2s2half4(__half2 lo, __half2 hi)
+            {
+                return __half4{__builtin_shufflevector(static_cast<__half2_raw>(lo).data,
+                                                       static_cast<__half2_raw>(hi).data,
+                                                       0, 1, 2, 3)};
+            }
+            inline
+            __device__
+            __half8 __half4s2half8(__half4 lo, __half4 hi)
+            {
+                return __half8{__builtin_shufflevector(lo.data, hi.data, 0, 1, 2, 3, 4, 5, 6, 7)};
+            }
+            inline
+            __device__
+            __half4 __hadd4(__half4 x, __half4 y) { return __half4{x.data + y.data}; }
+            inline
+            __device__
+            __half4 __hsub4(__half4 x, __half4 y) { return __half4{x.data - y.data}; }
+            inline
+            __device__
+            __half4 __hmul4(__half4 x, __half4 y) { return __half4{x.data * y.data}; }
+            inline
+            __device__
+            __half4 __hneg4(__half4 x) { return __half4{-x.data}; }
+            inline
+            __device__
+            __half4 __hfma4(__half4 x, __half4 y, __half4 z)
+            {
+                return __half4{__builtin_shufflevector(
+                    __ocml_fma_2f16(x.data.lo, y.data.lo, z.data.lo),
+                    __ocml_fma_2f16(x.data.hi, y.data.hi, z.data.hi), 0, 1, 2, 3)};
+            }
+            inline
+            __device__
+            __half8 __hadd8(__half8 x, __half8 y) { return __half8{x.data + y.data}; }
+            inline
+            __device__
+            __half8 __hsub8(__half8 x, __half8 y) { return __half8{x.data - y.data}; }
+            inline
+            __device__
+            __half8 __hmul8(__half8 x, __half8 y) { return __half8{x.data * y.data}; }
+            inline
+            __device__
+            __half8 __hneg8(__half8 x) { return __half8{-x.data}; }
+            inline
+            __device__
+            __half8 __hfma8(__half8 x, __half8 y, __half8 z)
+            {
+                __half4 lo = __hfma4(__half4{x.data.lo}, __half4{y.data.lo}, __half4{z.data.lo});
+                __half4 hi = __hfma4(__half4{x.data.hi}, __half4{y.data.hi}, __half4{z.data.hi});
+                return __half4s2half8(lo, hi);
+            }
+            #endif // defined(__clang__) && defined(__HIP__)
             inline
             __device__
             __half htrunc(__half x)
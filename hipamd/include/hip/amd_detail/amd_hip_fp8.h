@@ -548,48 +548,46 @@ static __device__ __hip_fp8_storage_t cast_to_f8_from_f32(float v, bool saturate
   return i8data;
 }
 
-static __device__ __hip_fp8x2_storage_t
-cast_to_f8x2_from_f32x2(float2 v, bool saturate, __hip_fp8_interpretation_t interpret) {
+// Clamps the finite value to the fp8 range, NAN/INF propagate
+static __device__ float saturate_f32_for_f8(float v, __hip_fp8_interpretation_t interpret) {
   union {
-    static_assert(sizeof(float2) == sizeof(unsigned int[2]), "size mismatch");
-    static_assert(sizeof(float2) == sizeof(unsigned short[4]), "size mismatch");
-    float2 fval;
-    unsigned int i32val[2];
-    unsigned short i16val[4];
-  } f2val;
-
-  f2val.fval = v;
+    float fval;
+    unsigned int i32val;
+  } val;
+  val.fval = v;
+  if ((val.i32val & 0x7F800000) == 0x7F800000) {
+    return v;
+  }
+  const float max = (interpret == __HIP_E4M3_FNUZ) ? 240.0f
+      : (interpret == __HIP_E4M3)                  ? 448.0f
+                                                   : 57344.0f;
+  return __builtin_amdgcn_fmed3f(v, max, -max);
+}
 
-  if (saturate) {  /// propagate NAN/INF, no clipping
-    if (interpret == __HIP_E4M3_FNUZ) {
-      if ((f2val.i32val[0] & 0x7F800000) != 0x7F800000) {
-        f2val.fval.x = __builtin_amdgcn_fmed3f(f2val.fval.x, 240.0, -240.0);
-      }
-      if ((f2val.i32val[1] & 0x7F800000) != 0x7F800000) {
-        f2val.fval.y = __builtin_amdgcn_fmed3f(f2val.fval.x, 240.0, -240.0);
-      }
-    } else if (interpret == __HIP_E4M3) {
-      if ((f2val.i32val[0] & 0x7F800000) != 0x7F800000) {
-        f2val.fval.x = __builtin_amdgcn_fmed3f(f2val.fval.x, 448.0, -448.0);
-      }
-      if ((f2val.i32val[1] & 0x7F800000) != 0x7F800000) {
-        f2val.fval.y = __builtin_amdgcn_fmed3f(f2val.fval.x, 448.0, -448.0);
-      }
-    } else {
-      if ((f2val.i32val[0] & 0x7F800000) != 0x7F800000) {
-        f2val.fval.x = __builtin_amdgcn_fmed3f(f2val.fval.x, 57344.0, -57344.0);
-      }
-      if ((f2val.i32val[1] & 0x7F800000) != 0x7F800000) {
-        f2val.fval.y = __builtin_amdgcn_fmed3f(f2val.fval.x, 57344.0, -57344.0);
-      }
-    }
+// Converts the pair into the selected word of old
+static __device__ unsigned int cast_to_f8x2_word(float x, float y, unsigned int old, bool high,
+                                                 bool saturate,
+                                                 __hip_fp8_interpretation_t interpret) {
+  if (saturate) {
+    x = saturate_f32_for_f8(x, interpret);
+    y = saturate_f32_for_f8(y, interpret);
   }
+  return (interpret == __HIP_E4M3_FNUZ) || (interpret == __HIP_E4M3)
+      ? __builtin_amdgcn_cvt_pk_fp8_f32(x, y, old, high)
+      : __builtin_amdgcn_cvt_pk_bf8_f32(x, y, old, high);
+}
 
-  f2val.i32val[0] = (interpret == __HIP_E4M3_FNUZ) || (interpret == __HIP_E4M3)
-      ? __builtin_amdgcn_cvt_pk_fp8_f32(v.x, v.y, 0, false)
-      : __builtin_amdgcn_cvt_pk_bf8_f32(v.x, v.y, 0, false);
+static __device__ __hip_fp8x2_storage_t
+cast_to_f8x2_from_f32x2(float2 v, bool saturate, __hip_fp8_interpretation_t interpret) {
+  return static_cast<__hip_fp8x2_storage_t>(
+      cast_to_f8x2_word(v.x, v.y, 0, false, saturate, interpret));
+}
 
-  return static_cast<__hip_fp8x2_storage_t>(f2val.i16val[0]);
+// Two packed conversions fill the low and the high word
+static __device__ __hip_fp8x4_storage_t
+cast_to_f8x4_from_f32x4(float4 v, bool saturate, __hip_fp8_interpretation_t interpret) {
+  unsigned int low = cast_to_f8x2_word(v.x, v.y, 0, false, saturate, interpret);
+  return cast_to_f8x2_word(v.z, v.w, low, true, saturate, interpret);
 }
 
 static __device__ float cast_to_f32_from_f8(__hip_fp8_storage_t v,
@@ -619,6 +617,16 @@ static __device__ float2 cast_to_f32x2_from_f8x2(__hip_fp8x2_storage_t v,
       : __builtin_amdgcn_cvt_pk_f32_bf8(val.i32val, false);
   return float2{f2[0], f2[1]};
 }
+
+static __device__ float4 cast_to_f32x4_from_f8x4(__hip_fp8x4_storage_t v,
+                                                 __hip_fp8_interpretation_t interpret) {
+  const bool fp8 = (interpret == __HIP_E4M3_FNUZ) || (interpret == __HIP_E4M3);
+  auto low = fp8 ? __builtin_amdgcn_cvt_pk_f32_fp8(v, false)
+                 : __builtin_amdgcn_cvt_pk_f32_bf8(v, false);
+  auto high = fp8 ? __builtin_amdgcn_cvt_pk_f32_fp8(v, true)
+                  : __builtin_amdgcn_cvt_pk_f32_bf8(v, true);
+  return float4{low[0], low[1], high[0], high[1]};
+}
 #endif  // HIP_FP8_CVT_FAST_PATH
 
 /* For fp8 fnuz types, finite and NaN values are supported. Zero is unsigned.
@@ -856,11 +864,17 @@ __FP8_HOST_DEVICE_STATIC__ __half2_raw __hip_cvt_fp8x2_to_halfraw2(
 __FP8_HOST_STATIC__ __half2_raw __hip_cvt_fp8x2_to_halfraw2(
     const __hip_fp8x2_storage_t x, const __hip_fp8_interpretation_t interp) {
 #endif
+#if HIP_FP8_CVT_FAST_PATH
+  // The fp8 values are exact in half, hence one packed conversion through float is sufficient
+  return static_cast<__half2_raw>(
+      __float22half2_rn(internal::cast_to_f32x2_from_f8x2(x, interp)));
+#else
   __half2 ret(static_cast<__half>(
                   __hip_cvt_fp8_to_halfraw(static_cast<__hip_fp8_storage_t>(x & 0xFF), interp)),
               static_cast<__half>(
                   __hip_cvt_fp8_to_halfraw(static_cast<__hip_fp8_storage_t>(x >> 8), interp)));
   return static_cast<__half2_raw>(ret);
+#endif
 }
 
 /**
@@ -907,6 +921,135 @@ __FP8_HOST_STATIC__ __hip_fp8x2_storage_t __hip_cvt_halfraw2_to_fp8x2(
   return __hip_cvt_float2_to_fp8x2(__half22float2(__half2(x)), sat, interp);
 }
 
+/**
+ * \brief convert @p __hip_fp8x2_storage_t to float2
+ *
+ * \param x __hip_fp8x2_storage_t val
+ * \param interp interpretation of fp8
+ * \return float2
+ */
+__FP8_HOST_DEVICE_STATIC__ float2 __hip_cvt_fp8x2_to_float2(
+    const __hip_fp8x2_storage_t x, const __hip_fp8_interpretation_t interp) {
+#if HIP_FP8_CVT_FAST_PATH
+  internal::__is_interpret_supported(interp);
+  return internal::cast_to_f32x2_from_f8x2(x, interp);
+#else
+  return __half22float2(__half2(__hip_cvt_fp8x2_to_halfraw2(x, interp)));
+#endif
+}
+
+/**
+ * \brief convert float4 to @p __hip_fp8x4_storage_t
+ *
+ * \param f4 float4 number
+ * \param sat saturation of fp8
+ * \param interp interpretation of fp8
+ * \return __hip_fp8x4_storage_t
+ */
+__FP8_HOST_DEVICE_STATIC__ __hip_fp8x4_storage_t __hip_cvt_float4_to_fp8x4(
+    const float4 f4, const __hip_saturation_t sat, const __hip_fp8_interpretation_t interp) {
+#if HIP_FP8_CVT_FAST_PATH
+  internal::__is_interpret_supported(interp);
+  return internal::cast_to_f8x4_from_f32x4(f4, sat == __HIP_SATFINITE, interp);
+#else
+  return static_cast<__hip_fp8x4_storage_t>(
+      __hip_cvt_float2_to_fp8x2(float2(f4.z, f4.w), sat, interp)) << 16 |
+      static_cast<__hip_fp8x4_storage_t>(
+      __hip_cvt_float2_to_fp8x2(float2(f4.x, f4.y), sat, interp));
+#endif
+}
+
+/**
+ * \brief convert @p __hip_fp8x4_storage_t to float4
+ *
+ * \param x __hip_fp8x4_storage_t val
+ * \param interp interpretation of fp8
+ * \return float4
+ */
+__FP8_HOST_DEVICE_STATIC__ float4 __hip_cvt_fp8x4_to_float4(
+    const __hip_fp8x4_storage_t x, const __hip_fp8_interpretation_t interp) {
+#if HIP_FP8_CVT_FAST_PATH
+  internal::__is_interpret_supported(interp);
+  return internal::cast_to_f32x4_from_f8x4(x, interp);
+#else
+  float2 low = __hip_cvt_fp8x2_to_float2(static_cast<__hip_fp8x2_storage_t>(x & 0xFFFF), interp);
+  float2 high = __hip_cvt_fp8x2_to_float2(static_cast<__hip_fp8x2_storage_t>(x >> 16), interp);
+  return float4(low.x, low.y, high.x, high.y);
+#endif
+}
+
+/**
+ * \brief convert @p __hip_fp8x2_storage_t to __hip_bfloat162_raw
+ *
+ * \param x __hip_fp8x2_storage_t val
+ * \param interp interpretation of fp8
+ * \return __hip_bfloat162_raw, the fp8 values are exact in bf16
+ */
+__FP8_HOST_DEVICE_STATIC__ __hip_bfloat162_raw __hip_cvt_fp8x2_to_bfloat16raw2(
+    const __hip_fp8x2_storage_t x, const __hip_fp8_interpretation_t interp) {
+  return static_cast<__hip_bfloat162_raw>(
+      __float22bfloat162_rn(__hip_cvt_fp8x2_to_float2(x, interp)));
+}
+
+/**
+ * \brief scale float2 and convert it to @p __hip_fp8x2_storage_t, i.e. the quantization
+ *
+ * \param f2 float2 number
+ * \param scale multiplier of the values before the conversion
+ * \param sat saturation of fp8
+ * \param interp interpretation of fp8
+ * \return __hip_fp8x2_storage_t
+ */
+__FP8_HOST_DEVICE_STATIC__ __hip_fp8x2_storage_t __hip_cvt_float2_to_fp8x2_scale(
+    const float2 f2, const float scale, const __hip_saturation_t sat,
+    const __hip_fp8_interpretation_t interp) {
+  return __hip_cvt_float2_to_fp8x2(float2(f2.x * scale, f2.y * scale), sat, interp);
+}
+
+/**
+ * \brief scale float4 and convert it to @p __hip_fp8x4_storage_t, i.e. the quantization
+ *
+ * \param f4 float4 number
+ * \param scale multiplier of the values before the conversion
+ * \param sat saturation of fp8
+ * \param interp interpretation of fp8
+ * \return __hip_fp8x4_storage_t
+ */
+__FP8_HOST_DEVICE_STATIC__ __hip_fp8x4_storage_t __hip_cvt_float4_to_fp8x4_scale(
+    const float4 f4, const float scale, const __hip_saturation_t sat,
+    const __hip_fp8_interpretation_t interp) {
+  return __hip_cvt_float4_to_fp8x4(
+      float4(f4.x * scale, f4.y * scale, f4.z * scale, f4.w * scale), sat, interp);
+}
+
+/**
+ * \brief convert @p __hip_fp8x2_storage_t to float2 and scale it, i.e. the dequantization
+ *
+ * \param x __hip_fp8x2_storage_t val
+ * \param scale multiplier of the converted values
+ * \param interp interpretation of fp8
+ * \return float2
+ */
+__FP8_HOST_DEVICE_STATIC__ float2 __hip_cvt_fp8x2_to_float2_scale(
+    const __hip_fp8x2_storage_t x, const float scale, const __hip_fp8_interpretation_t interp) {
+  float2 f2 = __hip_cvt_fp8x2_to_float2(x, interp);
+  return float2(f2.x * scale, f2.y * scale);
+}
+
+/**
+ * \brief convert @p __hip_fp8x4_storage_t to float4 and scale it, i.e. the dequantization
+ *
+ * \param x __hip_fp8x4_storage_t val
+ * \param scale multiplier of the converted values
+ * \param interp interpretation of fp8
+ * \return float4
+ */
+__FP8_HOST_DEVICE_STATIC__ float4 __hip_cvt_fp8x4_to_float4_scale(
+    const __hip_fp8x4_storage_t x, const float scale, const __hip_fp8_interpretation_t interp) {
+  float4 f4 = __hip_cvt_fp8x4_to_float4(x, interp);
+  return float4(f4.x * scale, f4.y * scale, f4.z * scale, f4.w * scale);
+}
+
 /**
  * \brief struct representing single fp8 number with e4m3 interpretation
  *
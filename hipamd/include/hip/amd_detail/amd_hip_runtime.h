@@ -122,6 +122,7 @@ extern int HIP_TRACE_API;
 
 #ifdef __cplusplus
 #include <hip/amd_detail/hip_ldg.h>
+#include <hip/amd_detail/amd_hip_cache_policy.h>
 #endif
 
 #include <hip/amd_detail/host_defines.h>
@@ -48,12 +48,29 @@ T __hip_readfirstlane(T val) {
   // NOTE: The builtin returns int, so we first cast it to unsigned int and only
   // then extend it to 64 bits.
   unsigned long long lower = (unsigned)__builtin_amdgcn_readfirstlane(u.l);
-  unsigned long long upper =
+  // A 32-bit value needs a single scalar read
+  unsigned long long upper = (sizeof(T) <= 4) ? 0 :
       (unsigned)__builtin_amdgcn_readfirstlane(u.l >> 32);
   u.l = (upper << 32) | lower;
   return u.d;
 }
 
+template <typename T>
+__device__ inline
+T __hip_readlane(T val, int lane) {
+  // The same union trick as __hip_readfirstlane, the lane must be uniform
+  union {
+    unsigned long long l;
+    T d;
+  } u;
+  u.d = val;
+  unsigned long long lower = (unsigned)__builtin_amdgcn_readlane(u.l, lane);
+  unsigned long long upper = (sizeof(T) <= 4) ? 0 :
+      (unsigned)__builtin_amdgcn_readlane(u.l >> 32, lane);
+  u.l = (upper << 32) | lower;
+  return u.d;
+}
+
 // When compiling for wave32 mode, ignore the upper half of the 64-bit mask.
 #define __hip_adjust_mask_for_wave32(MASK)            \
   do {                                          \
@@ -225,6 +242,126 @@ unsigned long long __match_all_sync(MaskT mask, T value, int* pred) {
   return retval;
 }
 
+// Wave aggregated atomics
+//
+// The active lanes with the same address combine their values and only the
+// first of them issues the atomic, hence a wave issues one atomic per unique
+// address. Every lane returns the value it would have observed, if the lanes
+// of the wave had executed the atomic in the lane order. The float addition
+// combines the values in the lane order, which may round differently from the
+// individual atomics. The atomics use the agent scope and the relaxed order of
+// the default atomics.
+
+template <typename T, typename Op, typename Atomic>
+__device__ inline
+T __hip_atomic_aggregate(T* address, T val, Op op, Atomic atomic) {
+  static_assert(
+      (__hip_internal::is_integral<T>::value || __hip_internal::is_floating_point<T>::value) &&
+          (sizeof(T) == 4 || sizeof(T) == 8),
+      "T can be int, unsigned int, long, unsigned long, long long, unsigned "
+      "long long, float or double.");
+  const unsigned int lane = __lane_id();
+  bool done = false;
+  T result{};
+  while (!done) {
+    T* chosen = __hip_readfirstlane(address);
+    if (chosen == address) {
+      // The lanes with the chosen address are active here and the first one leads
+      const unsigned long long peers = __activemask();
+      const bool leader = (lane == static_cast<unsigned int>(__builtin_ctzll(peers)));
+      T total = __hip_readfirstlane(val);
+      T prefix = total;
+      // A scalar loop over the other peers, every lane folds the values of the lower lanes
+      for (unsigned long long rest = peers & (peers - 1); rest != 0; rest &= rest - 1) {
+        const int peer = __builtin_ctzll(rest);
+        const T peer_val = __hip_readlane(val, peer);
+        if (peer < static_cast<int>(lane)) {
+          prefix = op(prefix, peer_val);
+        }
+        total = op(total, peer_val);
+      }
+      T old{};
+      if (leader) {
+        old = atomic(address, total);
+      }
+      old = __hip_readfirstlane(old);
+      result = leader ? old : op(old, prefix);
+      done = true;
+    }
+  }
+  return result;
+}
+
+template <typename T>
+__device__ inline
+T atomicAdd_aggregated(T* address, T val) {
+  // The common counter case adds the same value on all the lanes of an address
+  const unsigned int lane = __lane_id();
+  bool done = false;
+  T result{};
+  while (!done) {
+    T* chosen = __hip_readfirstlane(address);
+    if (chosen == address) {
+      const T first = __hip_readfirstlane(val);
+      if (__ballot(val != first) == 0) {
+        const unsigned long long peers = __activemask();
+        const unsigned int below = __popcll(peers & ((1ull << lane) - 1));
+        T old{};
+        if (below == 0) {
+          old = __hip_atomic_fetch_add(address, static_cast<T>(first * __popcll(peers)),
+                                       __ATOMIC_RELAXED, __HIP_MEMORY_SCOPE_AGENT);
+        }
+        result = __hip_readfirstlane(old) + static_cast<T>(first * below);
+      } else {
+        result = __hip_atomic_aggregate(address, val, [](T x, T y) { return x + y; },
+            [](T* p, T v) {
+              return __hip_atomic_fetch_add(p, v, __ATOMIC_RELAXED, __HIP_MEMORY_SCOPE_AGENT);
+            });
+      }
+      done = true;
+    }
+  }
+  return result;
+}
+
+template <typename T>
+__device__ inline
+T atomicMin_aggregated(T* address, T val) {
+  return __hip_atomic_aggregate(address, val, [](T x, T y) { return (y < x) ? y : x; },
+      [](T* p, T v) {
+        return __hip_atomic_fetch_min(p, v, __ATOMIC_RELAXED, __HIP_MEMORY_SCOPE_AGENT);
+      });
+}
+
+template <typename T>
+__device__ inline
+T atomicMax_aggregated(T* address, T val) {
+  return __hip_atomic_aggregate(address, val, [](T x, T y) { return (y > x) ? y : x; },
+      [](T* p, T v) {
+        return __hip_atomic_fetch_max(p, v, __ATOMIC_RELAXED, __HIP_MEMORY_SCOPE_AGENT);
+      });
+}
+
+template <typename T>
+__device__ inline
+T atomicOr_aggregated(T* address, T val) {
+  static_assert(__hip_internal::is_integral<T>::value, "T must be an integer.");
+  return __hip_atomic_aggregate(address, val, [](T x, T y) { return x | y; },
+      [](T* p, T v) {
+        return __hip_atomic_fetch_or(p, v, __ATOMIC_RELAXED, __HIP_MEMORY_SCOPE_AGENT);
+      });
+}
+
+template <typename T>
+__device__ inline
+T atomicAnd_aggregated(T* address, T val) {
+  static_assert(__hip_internal::is_integral<T>::value, "T must be an integer.");
+  return __hip_atomic_aggregate(address, val, [](T x, T y) { return x & y; },
+      [](T* p, T v) {
+        return __hip_atomic_fetch_and(p, v, __ATOMIC_RELAXED, __HIP_MEMORY_SCOPE_AGENT);
+      });
+}
+
 // various variants of shfl
 
 template <typename MaskT, typename T>
@@ -119,6 +119,15 @@ extern "C" __device__ uint64_t __ockl_fprintf_append_args(uint64_t msg_desc, uin
 extern "C" __device__ uint64_t __ockl_fprintf_append_string_n(uint64_t msg_desc, const char* data,
                                                               uint64_t length, uint32_t is_last);
 
+// HSA queue and signal access, the memory order argument follows __ATOMIC_* values
+typedef struct { uint64_t handle; } __ockl_hsa_signal_t;
+extern "C" __device__ uint64_t __ockl_hsa_queue_load_read_index(
+    const __attribute__((address_space(1))) void* queue, int mem_order);
+extern "C" __device__ uint64_t __ockl_hsa_queue_add_write_index(
+    __attribute__((address_space(1))) void* queue, uint64_t value, int mem_order);
+extern "C" __device__ void __ockl_hsa_signal_store(__ockl_hsa_signal_t sig, int64_t value,
+                                                   int mem_order);
+
 // Introduce local address space
 #define __local __attribute__((address_space(3)))
 
@@ -61,7 +61,7 @@
 // - Reset any of the *_STEP_VERSION defines to zero if the corresponding *_MAJOR_VERSION increases
 #define HIP_API_TABLE_STEP_VERSION 0
 #define HIP_COMPILER_API_TABLE_STEP_VERSION 0
-#define HIP_RUNTIME_API_TABLE_STEP_VERSION 6
+#define HIP_RUNTIME_API_TABLE_STEP_VERSION 20
 
 // HIP API interface
 typedef hipError_t (*t___hipPopCallConfiguration)(dim3* gridDim, dim3* blockDim, size_t* sharedMem,
@@ -1004,6 +1004,72 @@ typedef hipError_t (*t_hipExtHostAlloc)(void **ptr, size_t size,
 typedef hipError_t (*t_hipDeviceGetTexture1DLinearMaxWidth)(size_t *maxWidthInElements,
                                                             const hipChannelFormatDesc *fmtDesc,
                                                             int device);
+
+typedef hipError_t (*t_hipExtLaunchKernelBatch)(const hipLaunchParams* launchParamsList,
+                                                unsigned int numLaunches, hipStream_t stream,
+                                                unsigned int flags);
+
+typedef hipError_t (*t_hipExtMemcpyBatchAsync)(void** dsts, const void** srcs,
+                                               const size_t* sizes, size_t count,
+                                               hipStream_t stream);
+
+typedef hipError_t (*t_hipExtMemcpyFromFileAsync)(void* dst, int fd, uint64_t fileOffset,
+                                                  size_t sizeBytes, hipStream_t stream);
+
+typedef hipError_t (*t_hipExtGraphExecSetNodeTiming)(hipGraphExec_t graphExec, int enable);
+
+typedef hipError_t (*t_hipExtGraphExecGetNodeTime)(hipGraphExec_t graphExec,
+                                                   hipGraphNode_t node, uint64_t* startNs,
+                                                   uint64_t* endNs);
+
+typedef hipError_t (*t_hipExtGraphExecGetDeviceGraph)(hipGraphExec_t graphExec,
+                                                      void** deviceGraph);
+
+typedef hipError_t (*t_hipExtGraphAddConditionalNode)(hipGraphNode_t* pGraphNode, hipGraph_t graph,
+                                                      const hipGraphNode_t* pDependencies,
+                                                      size_t numDependencies, hipGraph_t body,
+                                                      unsigned int* predicate, int loop);
+
+typedef hipError_t (*t_hipExtGetRuntimeMetrics)(const char** names, uint64_t* values,
+                                                size_t* count);
+
+typedef hipError_t (*t_hipExtMemMapBatch)(void* const* ptrs, const size_t* sizes,
+                                          const size_t* offsets,
+                                          const hipMemGenericAllocationHandle_t* handles,
+                                          size_t count, unsigned long long flags);
+
+typedef hipError_t (*t_hipExtMemSetAccessBatch)(void* const* ptrs, const size_t* sizes,
+                                                size_t count, const hipMemAccessDesc* desc,
+                                                size_t descCount);
+
+typedef hipError_t (*t_hipExtMemPrefetchBatchAsync)(const void* const* dev_ptrs,
+                                                    const size_t* counts, size_t numRanges,
+                                                    int device, hipStream_t stream);
+
+typedef hipError_t (*t_hipExtMemPoolExportChunks)(hipMemPool_t mem_pool, size_t* numChunks);
+
+typedef hipError_t (*t_hipExtMemPoolSendBlock)(hipMemPool_t mem_pool, void* ptr, size_t size);
+
+typedef hipError_t (*t_hipExtMemPoolReceiveBlock)(hipMemPool_t mem_pool, void** ptr,
+                                                  size_t* size);
+
+typedef hipError_t (*t_hipExtMemcpyBroadcastAsync)(void* const* dsts, const int* dstDevices,
+                                                   size_t numDsts, const void* src, int srcDevice,
+                                                   size_t sizeBytes, hipStream_t stream);
+
+typedef hipError_t (*t_hipExtMemcpyScatterAsync)(void* const* dsts, const int* dstDevices,
+                                                 size_t numDsts, const void* src, int srcDevice,
+                                                 size_t sizeBytes, hipStream_t stream);
+
+typedef hipError_t (*t_hipExtLaunchCooperativeKernel)(const void* f, dim3 gridDim, dim3 blockDim,
+                                                      void** kernelParams, uint32_t sharedMemBytes,
+                                                      hipStream_t hStream, uint32_t flags);
+
+typedef hipError_t (*t_hipExtStreamSetCUMask)(hipStream_t stream, uint32_t cuMaskSize,
+                                              const uint32_t* cuMask);
+
+typedef hipError_t (*t_hipExtMemsetBatchAsync)(void** dsts, const int* values, const size_t* sizes,
+                                               size_t count, hipStream_t stream);
 // HIP Compiler dispatch table
 struct HipCompilerDispatchTable {
   // HIP_COMPILER_API_TABLE_STEP_VERSION == 0
@@ -1519,8 +1585,55 @@ struct HipDispatchTable {
   // HIP_RUNTIME_API_TABLE_STEP_VERSION == 6
   t_hipDeviceGetTexture1DLinearMaxWidth hipDeviceGetTexture1DLinearMaxWidth_fn;
 
-  // DO NOT EDIT ABOVE!
   // HIP_RUNTIME_API_TABLE_STEP_VERSION == 7
+  t_hipExtLaunchKernelBatch hipExtLaunchKernelBatch_fn;
+
+  // HIP_RUNTIME_API_TABLE_STEP_VERSION == 8
+  t_hipExtMemcpyBatchAsync hipExtMemcpyBatchAsync_fn;
+
+  // HIP_RUNTIME_API_TABLE_STEP_VERSION == 9
+  t_hipExtMemcpyFromFileAsync hipExtMemcpyFromFileAsync_fn;
+
+  // HIP_RUNTIME_API_TABLE_STEP_VERSION == 10
+  t_hipExtGraphExecSetNodeTiming hipExtGraphExecSetNodeTiming_fn;
+  t_hipExtGraphExecGetNodeTime hipExtGraphExecGetNodeTime_fn;
+
+  // HIP_RUNTIME_API_TABLE_STEP_VERSION == 11
+  t_hipExtGraphExecGetDeviceGraph hipExtGraphExecGetDeviceGraph_fn;
+
+  // HIP_RUNTIME_API_TABLE_STEP_VERSION == 12
+  t_hipExtGraphAddConditionalNode hipExtGraphAddConditionalNode_fn;
+
+  // HIP_RUNTIME_API_TABLE_STEP_VERSION == 13
+  t_hipExtGetRuntimeMetrics hipExtGetRuntimeMetrics_fn;
+
+  // HIP_RUNTIME_API_TABLE_STEP_VERSION == 14
+  t_hipExtMemMapBatch hipExtMemMapBatch_fn;
+  t_hipExtMemSetAccessBatch hipExtMemSetAccessBatch_fn;
+
+  // HIP_RUNTIME_API_TABLE_STEP_VERSION == 15
+  t_hipExtMemPrefetchBatchAsync hipExtMemPrefetchBatchAsync_fn;
+
+  // HIP_RUNTIME_API_TABLE_STEP_VERSION == 16
+  t_hipExtMemPoolExportChunks hipExtMemPoolExportChunks_fn;
+  t_hipExtMemPoolSendBlock hipExtMemPoolSendBlock_fn;
+  t_hipExtMemPoolReceiveBlock hipExtMemPoolReceiveBlock_fn;
+
+  // HIP_RUNTIME_API_TABLE_STEP_VERSION == 17
+  t_hipExtMemcpyBroadcastAsync hipExtMemcpyBroadcastAsync_fn;
+  t_hipExtMemcpyScatterAsync hipExtMemcpyScatterAsync_fn;
+
+  // HIP_RUNTIME_API_TABLE_STEP_VERSION == 18
+  t_hipExtLaunchCooperativeKernel hipExtLaunchCooperativeKernel_fn;
+
+  // HIP_RUNTIME_API_TABLE_STEP_VERSION == 19
+  t_hipExtStreamSetCUMask hipExtStreamSetCUMask_fn;
+
+  // HIP_RUNTIME_API_TABLE_STEP_VERSION == 20
+  t_hipExtMemsetBatchAsync hipExtMemsetBatchAsync_fn;
+
+  // DO NOT EDIT ABOVE!
+  // HIP_RUNTIME_API_TABLE_STEP_VERSION == 21
 
   // ******************************************************************************************* //
   //
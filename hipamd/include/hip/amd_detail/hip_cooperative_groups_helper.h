@@ -58,6 +58,9 @@ using lane_mask = unsigned int;
 using lane_mask = unsigned long long int;
 #endif
 
+//! Code object version of the device library, selects the implicit argument layout
+extern "C" __constant__ const int __oclc_ABI_version;
+
 namespace cooperative_groups {
 
 /* Global scope */
@@ -184,7 +187,84 @@ __CG_STATIC_QUALIFIER__ uint32_t thread_rank() {
 
 __CG_STATIC_QUALIFIER__ bool is_valid() { return static_cast<bool>(__ockl_grid_is_valid()); }
 
-__CG_STATIC_QUALIFIER__ void sync() { __ockl_grid_sync(); }
+/**
+ *  @brief Grid sync info of the runtime, the hidden multigrid sync argument points to it
+ */
+struct sync_info {
+  void* mgs;
+  uint32_t grid_id;
+  uint32_t num_grids;
+  uint64_t prev_sum;
+  uint64_t all_sum;
+  uint32_t sgs[2];
+  uint32_t num_wg;
+  uint32_t* barrier;  ///< Hierarchical barrier, nullptr if the launch uses the device library
+};
+
+_CG_STATIC_CONST_DECL_ uint32_t barrier_line = 32;    ///< Dwords in a counter line
+_CG_STATIC_CONST_DECL_ uint32_t barrier_fan_in = 16;  ///< Workgroups of a leaf counter
+
+/**
+ *  @brief Returns the counters of the hierarchical barrier, nullptr if not enabled
+ */
+__CG_STATIC_QUALIFIER__ uint32_t* hierarchical_barrier() {
+  // The code object v5 moved the hidden multigrid sync argument
+  const uint32_t index = (__oclc_ABI_version < 500) ? 6 : 12;
+  const sync_info* info =
+      reinterpret_cast<const sync_info* const*>(__builtin_amdgcn_implicitarg_ptr())[index];
+  return (info != nullptr) ? info->barrier : nullptr;
+}
+
+/**
+ *  @brief Two level barrier. The workgroups of a leaf arrive on its own counter line and
+ *  only the last of them arrives on the root, which limits the atomic contention to
+ *  barrier_fan_in workgroups per line. The last workgroup bumps the generation,
+ *  the others wait for it
+ */
+__CG_STATIC_QUALIFIER__ void hierarchical_sync(uint32_t* barrier) {
+  __builtin_amdgcn_fence(__ATOMIC_RELEASE, "agent");
+  __syncthreads();
+  if (workgroup::thread_rank() == 0) {
+    uint32_t* generation = barrier;
+    uint32_t* root = barrier + barrier_line;
+    const uint32_t num_wg = static_cast<uint32_t>(gridDim.x * gridDim.y * gridDim.z);
+    const uint32_t wg = static_cast<uint32_t>((blockIdx.z * gridDim.y * gridDim.x) +
+                                              (blockIdx.y * gridDim.x) + blockIdx.x);
+    const uint32_t leaf_id = wg / barrier_fan_in;
+    const uint32_t leaf_size = (num_wg - leaf_id * barrier_fan_in < barrier_fan_in) ?
+        (num_wg - leaf_id * barrier_fan_in) : barrier_fan_in;
+    const uint32_t num_leaves = (num_wg + barrier_fan_in - 1) / barrier_fan_in;
+    uint32_t* leaf = barrier + (2 + leaf_id) * barrier_line;
+
+    // The generation can't change before this workgroup arrives
+    const uint32_t gen = __hip_atomic_load(generation, __ATOMIC_RELAXED,
+                                           __HIP_MEMORY_SCOPE_AGENT);
+    if (__hip_atomic_fetch_add(leaf, 1u, __ATOMIC_ACQ_REL, __HIP_MEMORY_SCOPE_AGENT) ==
+        leaf_size - 1) {
+      // The arrival on the root releases the reset for the next barrier
+      __hip_atomic_store(leaf, 0u, __ATOMIC_RELAXED, __HIP_MEMORY_SCOPE_AGENT);
+      if (__hip_atomic_fetch_add(root, 1u, __ATOMIC_ACQ_REL, __HIP_MEMORY_SCOPE_AGENT) ==
+          num_leaves - 1) {
+        __hip_atomic_store(root, 0u, __ATOMIC_RELAXED, __HIP_MEMORY_SCOPE_AGENT);
+        __hip_atomic_store(generation, gen + 1, __ATOMIC_RELEASE, __HIP_MEMORY_SCOPE_AGENT);
+      }
+    }
+    while (__hip_atomic_load(generation, __ATOMIC_ACQUIRE, __HIP_MEMORY_SCOPE_AGENT) == gen) {
+      __builtin_amdgcn_s_sleep(1);
+    }
+  }
+  __syncthreads();
+  __builtin_amdgcn_fence(__ATOMIC_ACQUIRE, "agent");
+}
+
+__CG_STATIC_QUALIFIER__ void sync() {
+  uint32_t* barrier = hierarchical_barrier();
+  if (barrier != nullptr) {
+    hierarchical_sync(barrier);
+  } else {
+    __ockl_grid_sync();
+  }
+}
 
 }  // namespace grid
 
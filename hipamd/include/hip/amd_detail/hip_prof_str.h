@@ -438,6 +438,25 @@ enum hip_api_id_t {
   HIP_API_ID_hipDestroyTextureObject = HIP_API_ID_NONE,
   HIP_API_ID_hipDeviceGetCount = HIP_API_ID_NONE,
   HIP_API_ID_hipDeviceGetTexture1DLinearMaxWidth = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtLaunchKernelBatch = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtMemcpyBatchAsync = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtMemcpyFromFileAsync = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtGraphExecSetNodeTiming = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtGraphExecGetNodeTime = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtGraphExecGetDeviceGraph = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtGraphAddConditionalNode = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtGetRuntimeMetrics = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtMemMapBatch = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtMemSetAccessBatch = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtMemPrefetchBatchAsync = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtMemPoolExportChunks = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtMemPoolSendBlock = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtMemPoolReceiveBlock = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtMemcpyBroadcastAsync = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtMemcpyScatterAsync = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtLaunchCooperativeKernel = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtStreamSetCUMask = HIP_API_ID_NONE,
+  HIP_API_ID_hipExtMemsetBatchAsync = HIP_API_ID_NONE,
   HIP_API_ID_hipGetTextureAlignmentOffset = HIP_API_ID_NONE,
   HIP_API_ID_hipGetTextureObjectResourceDesc = HIP_API_ID_NONE,
   HIP_API_ID_hipGetTextureObjectResourceViewDesc = HIP_API_ID_NONE,
@@ -6045,6 +6064,44 @@ typedef struct hip_api_data_s {
 #define INIT_hipDeviceGetCount_CB_ARGS_DATA(cb_data) {};
 // hipDeviceGetTexture1DLinearMaxWidth()
 #define INIT_hipDeviceGetTexture1DLinearMaxWidth_CB_ARGS_DATA(cb_data) {};
+// hipExtLaunchKernelBatch()
+#define INIT_hipExtLaunchKernelBatch_CB_ARGS_DATA(cb_data) {};
+// hipExtMemcpyBatchAsync()
+#define INIT_hipExtMemcpyBatchAsync_CB_ARGS_DATA(cb_data) {};
+// hipExtMemcpyFromFileAsync()
+#define INIT_hipExtMemcpyFromFileAsync_CB_ARGS_DATA(cb_data) {};
+// hipExtGraphExecSetNodeTiming()
+#define INIT_hipExtGraphExecSetNodeTiming_CB_ARGS_DATA(cb_data) {};
+// hipExtGraphExecGetNodeTime()
+#define INIT_hipExtGraphExecGetNodeTime_CB_ARGS_DATA(cb_data) {};
+// hipExtGraphExecGetDeviceGraph()
+#define INIT_hipExtGraphExecGetDeviceGraph_CB_ARGS_DATA(cb_data) {};
+// hipExtGraphAddConditionalNode()
+#define INIT_hipExtGraphAddConditionalNode_CB_ARGS_DATA(cb_data) {};
+// hipExtGetRuntimeMetrics()
+#define INIT_hipExtGetRuntimeMetrics_CB_ARGS_DATA(cb_data) {};
+// hipExtMemMapBatch()
+#define INIT_hipExtMemMapBatch_CB_ARGS_DATA(cb_data) {};
+// hipExtMemSetAccessBatch()
+#define INIT_hipExtMemSetAccessBatch_CB_ARGS_DATA(cb_data) {};
+// hipExtMemPrefetchBatchAsync()
+#define INIT_hipExtMemPrefetchBatchAsync_CB_ARGS_DATA(cb_data) {};
+// hipExtMemPoolExportChunks()
+#define INIT_hipExtMemPoolExportChunks_CB_ARGS_DATA(cb_data) {};
+// hipExtMemPoolSendBlock()
+#define INIT_hipExtMemPoolSendBlock_CB_ARGS_DATA(cb_data) {};
+// hipExtMemPoolReceiveBlock()
+#define INIT_hipExtMemPoolReceiveBlock_CB_ARGS_DATA(cb_data) {};
+// hipExtMemcpyBroadcastAsync()
+#define INIT_hipExtMemcpyBroadcastAsync_CB_ARGS_DATA(cb_data) {};
+// hipExtMemcpyScatterAsync()
+#define INIT_hipExtMemcpyScatterAsync_CB_ARGS_DATA(cb_data) {};
+// hipExtLaunchCooperativeKernel()
+#define INIT_hipExtLaunchCooperativeKernel_CB_ARGS_DATA(cb_data) {};
+// hipExtStreamSetCUMask()
+#define INIT_hipExtStreamSetCUMask_CB_ARGS_DATA(cb_data) {};
+// hipExtMemsetBatchAsync()
+#define INIT_hipExtMemsetBatchAsync_CB_ARGS_DATA(cb_data) {};
 // hipGetTextureAlignmentOffset()
 #define INIT_hipGetTextureAlignmentOffset_CB_ARGS_DATA(cb_data) {};
 // hipGetTextureObjectResourceDesc()
@@ -475,4 +475,143 @@ static __device__ __hip_img_chk__ void texCubemapLayeredGrad(T *ptr, hipTextureO
     *ptr = texCubemapLayeredGrad<T>(textureObject, x, y, z, layer, dPdx, dPdy);
 }
 
+// Texture handles
+//
+// A handle keeps the descriptor pointers of a texture object for the lifetime of a kernel.
+// The constructor reads the object once with readfirstlane, hence the image and the sampler
+// descriptors are scalar loads, which the compiler hoists out of the sampling loops. A texture
+// object, read from the global memory or selected by a thread index, doesn't put every fetch
+// into a waterfall loop either. The texture object must be uniform across the wave.
+struct hipTextureHandle {
+    unsigned int ADDRESS_SPACE_CONSTANT* image;    ///< Image descriptor
+    unsigned int ADDRESS_SPACE_CONSTANT* sampler;  ///< Sampler descriptor
+
+    __device__ explicit hipTextureHandle(hipTextureObject_t textureObject) {
+        unsigned long long address = reinterpret_cast<unsigned long long>(textureObject);
+        unsigned long long lower = (unsigned)__builtin_amdgcn_readfirstlane(address);
+        unsigned long long upper = (unsigned)__builtin_amdgcn_readfirstlane(address >> 32);
+        image = (unsigned int ADDRESS_SPACE_CONSTANT*)((upper << 32) | lower);
+        sampler = image + HIP_SAMPLER_OBJECT_OFFSET_DWORD;
+    }
+};
+
+template <
+    typename T,
+    typename std::enable_if<__hip_is_tex_surf_channel_type<T>::value>::type* = nullptr>
+static __device__ __hip_img_chk__ T tex1Dfetch(const hipTextureHandle& handle, int x)
+{
+    auto tmp = __ockl_image_load_1Db(handle.image, x);
+    return __hipMapFrom<T>(tmp);
+}
+
+template <
+    typename T,
+    typename std::enable_if<__hip_is_tex_surf_channel_type<T>::value>::type* = nullptr>
+static __device__ __hip_img_chk__ T tex1D(const hipTextureHandle& handle, float x)
+{
+    auto tmp = __ockl_image_sample_1D(handle.image, handle.sampler, x);
+    return __hipMapFrom<T>(tmp);
+}
+
+template <
+    typename T,
+    typename std::enable_if<__hip_is_tex_surf_channel_type<T>::value>::type* = nullptr>
+static __device__ __hip_img_chk__ T tex2D(const hipTextureHandle& handle, float x, float y)
+{
+    auto tmp = __ockl_image_sample_2D(handle.image, handle.sampler, float2(x, y).data);
+    return __hipMapFrom<T>(tmp);
+}
+
+template <
+    typename T,
+    typename std::enable_if<__hip_is_tex_surf_channel_type<T>::value>::type* = nullptr>
+static __device__ __hip_img_chk__ T tex3D(const hipTextureHandle& handle, float x, float y,
+                                          float z)
+{
+    auto tmp = __ockl_image_sample_3D(handle.image, handle.sampler, float4(x, y, z, 0.0f).data);
+    return __hipMapFrom<T>(tmp);
+}
+
+template <
+    typename T,
+    typename std::enable_if<__hip_is_tex_surf_channel_type<T>::value>::type* = nullptr>
+static __device__ __hip_img_chk__ T tex1DLayered(const hipTextureHandle& handle, float x,
+                                                 int layer)
+{
+    auto tmp = __ockl_image_sample_1Da(handle.image, handle.sampler, float2(x, layer).data);
+    return __hipMapFrom<T>(tmp);
+}
+
+template <
+    typename T,
+    typename std::enable_if<__hip_is_tex_surf_channel_type<T>::value>::type* = nullptr>
+static __device__ __hip_img_chk__ T tex2DLayered(const hipTextureHandle& handle, float x,
+                                                 float y, int layer)
+{
+    auto tmp = __ockl_image_sample_2Da(handle.image, handle.sampler,
+                                       float4(x, y, layer, 0.0f).data);
+    return __hipMapFrom<T>(tmp);
+}
+
+template <
+    typename T,
+    typename std::enable_if<__hip_is_tex_surf_channel_type<T>::value>::type* = nullptr>
+static __device__ __hip_img_chk__ T tex2DLod(const hipTextureHandle& handle, float x, float y,
+                                             float level)
+{
+    auto tmp = __ockl_image_sample_lod_2D(handle.image, handle.sampler, float2(x, y).data,
+                                          level);
+    return __hipMapFrom<T>(tmp);
+}
+
+template <
+    typename T,
+    typename std::enable_if<__hip_is_tex_surf_channel_type<T>::value>::type* = nullptr>
+static __device__ __hip_img_chk__ T tex3DLod(const hipTextureHandle& handle, float x, float y,
+                                             float z, float level)
+{
+    auto tmp = __ockl_image_sample_lod_3D(handle.image, handle.sampler,
+                                          float4(x, y, z, 0.0f).data, level);
+    return __hipMapFrom<T>(tmp);
+}
+
+template <
+    typename T,
+    typename std::enable_if<__hip_is_tex_surf_channel_type<T>::value>::type* = nullptr>
+static __device__ __hip_img_chk__ T tex2DGrad(const hipTextureHandle& handle, float x, float y,
+                                              float2 dPdx, float2 dPdy)
+{
+    auto tmp = __ockl_image_sample_grad_2D(handle.image, handle.sampler, float2(x, y).data,
+                                           float2(dPdx.x, dPdx.y).data,
+                                           float2(dPdy.x, dPdy.y).data);
+    return __hipMapFrom<T>(tmp);
+}
+
+template <
+    typename T,
+    typename std::enable_if<__hip_is_tex_surf_channel_type<T>::value>::type* = nullptr>
+static __device__ __hip_img_chk__ T tex2Dgather(const hipTextureHandle& handle, float x, float y,
+                                                int comp = 0)
+{
+    // The same component selection as tex2Dgather of the texture object
+    switch (comp) {
+    case 1: {
+        auto tmp = __ockl_image_gather4r_2D(handle.image, handle.sampler, float2(x, y).data);
+        return __hipMapFrom<T>(tmp);
+    }
+    case 2: {
+        auto tmp = __ockl_image_gather4g_2D(handle.image, handle.sampler, float2(x, y).data);
+        return __hipMapFrom<T>(tmp);
+    }
+    case 3: {
+        auto tmp = __ockl_image_gather4b_2D(handle.image, handle.sampler, float2(x, y).data);
+        return __hipMapFrom<T>(tmp);
+    }
+    default: {
+        auto tmp = __ockl_image_gather4a_2D(handle.image, handle.sampler, float2(x, y).data);
+        return __hipMapFrom<T>(tmp);
+    }
+    }
+}
+
 #endif
@@ -351,6 +351,44 @@ hipError_t hipHostGetDevicePointer(void** devPtr, void* hstPtr, unsigned int fla
 hipError_t hipHostGetFlags(unsigned int* flagsPtr, void* hostPtr);
 hipError_t hipHostMalloc(void** ptr, size_t size, unsigned int flags);
 hipError_t hipExtHostAlloc(void** ptr, size_t size, unsigned int flags);
+hipError_t hipExtLaunchKernelBatch(const hipLaunchParams* launchParamsList,
+                                   unsigned int numLaunches, hipStream_t stream,
+                                   unsigned int flags);
+hipError_t hipExtMemcpyBatchAsync(void** dsts, const void** srcs, const size_t* sizes,
+                                  size_t count, hipStream_t stream);
+hipError_t hipExtMemcpyFromFileAsync(void* dst, int fd, uint64_t fileOffset, size_t sizeBytes,
+                                     hipStream_t stream);
+hipError_t hipExtGraphExecSetNodeTiming(hipGraphExec_t graphExec, int enable);
+hipError_t hipExtGraphExecGetNodeTime(hipGraphExec_t graphExec, hipGraphNode_t node,
+                                      uint64_t* startNs, uint64_t* endNs);
+hipError_t hipExtGraphExecGetDeviceGraph(hipGraphExec_t graphExec, void** deviceGraph);
+hipError_t hipExtGraphAddConditionalNode(hipGraphNode_t* pGraphNode, hipGraph_t graph,
+                                         const hipGraphNode_t* pDependencies,
+                                         size_t numDependencies, hipGraph_t body,
+                                         unsigned int* predicate, int loop);
+hipError_t hipExtGetRuntimeMetrics(const char** names, uint64_t* values, size_t* count);
+hipError_t hipExtMemMapBatch(void* const* ptrs, const size_t* sizes, const size_t* offsets,
+                             const hipMemGenericAllocationHandle_t* handles, size_t count,
+                             unsigned long long flags);
+hipError_t hipExtMemSetAccessBatch(void* const* ptrs, const size_t* sizes, size_t count,
+                                   const hipMemAccessDesc* desc, size_t descCount);
+hipError_t hipExtMemPrefetchBatchAsync(const void* const* dev_ptrs, const size_t* counts,
+                                       size_t numRanges, int device, hipStream_t stream);
+hipError_t hipExtMemPoolExportChunks(hipMemPool_t mem_pool, size_t* numChunks);
+hipError_t hipExtMemPoolSendBlock(hipMemPool_t mem_pool, void* ptr, size_t size);
+hipError_t hipExtMemPoolReceiveBlock(hipMemPool_t mem_pool, void** ptr, size_t* size);
+hipError_t hipExtMemcpyBroadcastAsync(void* const* dsts, const int* dstDevices, size_t numDsts,
+                                      const void* src, int srcDevice, size_t sizeBytes,
+                                      hipStream_t stream);
+hipError_t hipExtMemcpyScatterAsync(void* const* dsts, const int* dstDevices, size_t numDsts,
+                                    const void* src, int srcDevice, size_t sizeBytes,
+                                    hipStream_t stream);
+hipError_t hipExtLaunchCooperativeKernel(const void* f, dim3 gridDim, dim3 blockDim,
+                                         void** kernelParams, uint32_t sharedMemBytes,
+                                         hipStream_t hStream, uint32_t flags);
+hipError_t hipExtStreamSetCUMask(hipStream_t stream, uint32_t cuMaskSize, const uint32_t* cuMask);
+hipError_t hipExtMemsetBatchAsync(void** dsts, const int* values, const size_t* sizes, size_t count,
+                                  hipStream_t stream);
 hipError_t hipHostRegister(void* hostPtr, size_t sizeBytes, unsigned int flags);
 hipError_t hipHostUnregister(void* hostPtr);
 hipError_t hipImportExternalMemory(hipExternalMemory_t* extMem_out,
@@ -1032,6 +1070,25 @@ void UpdateDispatchTable(HipDispatchTable* ptrDispatchTable) {
   ptrDispatchTable->hipHostGetFlags_fn = hip::hipHostGetFlags;
   ptrDispatchTable->hipHostMalloc_fn = hip::hipHostMalloc;
   ptrDispatchTable->hipExtHostAlloc_fn = hip::hipExtHostAlloc;
+  ptrDispatchTable->hipExtLaunchKernelBatch_fn = hip::hipExtLaunchKernelBatch;
+  ptrDispatchTable->hipExtMemcpyBatchAsync_fn = hip::hipExtMemcpyBatchAsync;
+  ptrDispatchTable->hipExtMemcpyFromFileAsync_fn = hip::hipExtMemcpyFromFileAsync;
+  ptrDispatchTable->hipExtGraphExecSetNodeTiming_fn = hip::hipExtGraphExecSetNodeTiming;
+  ptrDispatchTable->hipExtGraphExecGetNodeTime_fn = hip::hipExtGraphExecGetNodeTime;
+  ptrDispatchTable->hipExtGraphExecGetDeviceGraph_fn = hip::hipExtGraphExecGetDeviceGraph;
+  ptrDispatchTable->hipExtGraphAddConditionalNode_fn = hip::hipExtGraphAddConditionalNode;
+  ptrDispatchTable->hipExtGetRuntimeMetrics_fn = hip::hipExtGetRuntimeMetrics;
+  ptrDispatchTable->hipExtMemMapBatch_fn = hip::hipExtMemMapBatch;
+  ptrDispatchTable->hipExtMemSetAccessBatch_fn = hip::hipExtMemSetAccessBatch;
+  ptrDispatchTable->hipExtMemPrefetchBatchAsync_fn = hip::hipExtMemPrefetchBatchAsync;
+  ptrDispatchTable->hipExtMemPoolExportChunks_fn = hip::hipExtMemPoolExportChunks;
+  ptrDispatchTable->hipExtMemPoolSendBlock_fn = hip::hipExtMemPoolSendBlock;
+  ptrDispatchTable->hipExtMemPoolReceiveBlock_fn = hip::hipExtMemPoolReceiveBlock;
+  ptrDispatchTable->hipExtMemcpyBroadcastAsync_fn = hip::hipExtMemcpyBroadcastAsync;
+  ptrDispatchTable->hipExtMemcpyScatterAsync_fn = hip::hipExtMemcpyScatterAsync;
+  ptrDispatchTable->hipExtLaunchCooperativeKernel_fn = hip::hipExtLaunchCooperativeKernel;
+  ptrDispatchTable->hipExtStreamSetCUMask_fn = hip::hipExtStreamSetCUMask;
+  ptrDispatchTable->hipExtMemsetBatchAsync_fn = hip::hipExtMemsetBatchAsync;
   ptrDispatchTable->hipHostRegister_fn = hip::hipHostRegister;
   ptrDispatchTable->hipHostUnregister_fn = hip::hipHostUnregister;
   ptrDispatchTable->hipImportExternalMemory_fn = hip::hipImportExternalMemory;
@@ -1887,6 +1944,39 @@ HIP_ENFORCE_ABI(HipDispatchTable, hipDrvGraphMemcpyNodeSetParams_fn, 460)
 HIP_ENFORCE_ABI(HipDispatchTable, hipExtHostAlloc_fn, 461)
 // HIP_RUNTIME_API_TABLE_STEP_VERSION == 6
 HIP_ENFORCE_ABI(HipDispatchTable, hipDeviceGetTexture1DLinearMaxWidth_fn, 462)
+// HIP_RUNTIME_API_TABLE_STEP_VERSION == 7
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtLaunchKernelBatch_fn, 463)
+// HIP_RUNTIME_API_TABLE_STEP_VERSION == 8
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtMemcpyBatchAsync_fn, 464)
+// HIP_RUNTIME_API_TABLE_STEP_VERSION == 9
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtMemcpyFromFileAsync_fn, 465)
+// HIP_RUNTIME_API_TABLE_STEP_VERSION == 10
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtGraphExecSetNodeTiming_fn, 466)
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtGraphExecGetNodeTime_fn, 467)
+// HIP_RUNTIME_API_TABLE_STEP_VERSION == 11
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtGraphExecGetDeviceGraph_fn, 468)
+// HIP_RUNTIME_API_TABLE_STEP_VERSION == 12
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtGraphAddConditionalNode_fn, 469)
+// HIP_RUNTIME_API_TABLE_STEP_VERSION == 13
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtGetRuntimeMetrics_fn, 470)
+// HIP_RUNTIME_API_TABLE_STEP_VERSION == 14
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtMemMapBatch_fn, 471)
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtMemSetAccessBatch_fn, 472)
+// HIP_RUNTIME_API_TABLE_STEP_VERSION == 15
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtMemPrefetchBatchAsync_fn, 473)
+// HIP_RUNTIME_API_TABLE_STEP_VERSION == 16
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtMemPoolExportChunks_fn, 474)
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtMemPoolSendBlock_fn, 475)
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtMemPoolReceiveBlock_fn, 476)
+// HIP_RUNTIME_API_TABLE_STEP_VERSION == 17
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtMemcpyBroadcastAsync_fn, 477)
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtMemcpyScatterAsync_fn, 478)
+// HIP_RUNTIME_API_TABLE_STEP_VERSION == 18
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtLaunchCooperativeKernel_fn, 479)
+// HIP_RUNTIME_API_TABLE_STEP_VERSION == 19
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtStreamSetCUMask_fn, 480)
+// HIP_RUNTIME_API_TABLE_STEP_VERSION == 20
+HIP_ENFORCE_ABI(HipDispatchTable, hipExtMemsetBatchAsync_fn, 481)
 
 // if HIP_ENFORCE_ABI entries are added for each new function pointer in the table, the number below
 // will be +1 of the number in the last HIP_ENFORCE_ABI line. E.g.:
@@ -1894,9 +1984,9 @@ HIP_ENFORCE_ABI(HipDispatchTable, hipDeviceGetTexture1DLinearMaxWidth_fn, 462)
 //  HIP_ENFORCE_ABI(<table>, <functor>, 8)
 //
 //  HIP_ENFORCE_ABI_VERSIONING(<table>, 9) <- 8 + 1 = 9
-HIP_ENFORCE_ABI_VERSIONING(HipDispatchTable, 463)
+HIP_ENFORCE_ABI_VERSIONING(HipDispatchTable, 482)
 
-static_assert(HIP_RUNTIME_API_TABLE_MAJOR_VERSION == 0 && HIP_RUNTIME_API_TABLE_STEP_VERSION == 6,
+static_assert(HIP_RUNTIME_API_TABLE_MAJOR_VERSION == 0 && HIP_RUNTIME_API_TABLE_STEP_VERSION == 20,
               "If you get this error, add new HIP_ENFORCE_ABI(...) code for the new function "
               "pointers and then update this check so it is true");
 #endif
@@ -22,7 +22,11 @@ THE SOFTWARE.
 #include "hip_code_object.hpp"
 #include "amd_hsa_elf.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 
 #include <hip/driver_types.h>
 #include "hip/hip_runtime_api.h"
@@ -99,6 +103,101 @@ bool CodeObject::IsClangOffloadMagicBundle(const void* data, bool& isCompressed)
 
 uint64_t CodeObject::ElfSize(const void* emi) { return amd::Elf::getElfSize(emi); }
 
+namespace {
+// Code objects, mapped from the on-disk cache, with the sizes of their mappings
+amd::Monitor& cacheLock() {
+  static amd::Monitor lock(true);
+  return lock;
+}
+std::unordered_map<const void*, size_t>& cacheMappings() {
+  static std::unordered_map<const void*, size_t> mappings;
+  return mappings;
+}
+
+// The name combines the bundle hash, the target ID and the runtime version, hence a rebuilt
+// binary or a runtime update never picks up a stale code object
+std::string cacheFileName(const __ClangOffloadBundleCompressedHeader* header,
+                          const std::string& isa) {
+  std::string target = isa;
+  std::replace(target.begin(), target.end(), ':', '_');
+  char key[64];
+  snprintf(key, sizeof(key), "%016llx-%08x-%d-", static_cast<unsigned long long>(header->Hash),
+           header->totalSize, HIP_VERSION);
+  return std::string(HIP_CODE_OBJECT_CACHE_PATH) + amd::Os::fileSeparator() + key + target +
+         ".co";
+}
+}  // namespace
+
+// ================================================================================================
+bool CodeObject::loadCachedCodeObject(const void* bundle, const std::string& isa,
+                                      std::pair<const void*, size_t>& code_obj) {
+  const auto header = reinterpret_cast<const __ClangOffloadBundleCompressedHeader*>(bundle);
+  if ((HIP_CODE_OBJECT_CACHE_PATH[0] == '\0') || (header->Hash == 0)) {
+    return false;
+  }
+  const std::string fname = cacheFileName(header, isa);
+  const void* image = nullptr;
+  size_t size = 0;
+  if (!amd::Os::MemoryMapFile(fname.c_str(), &image, &size)) {
+    return false;
+  }
+  // Reject a damaged file, the extraction will overwrite it
+  const uint64_t elfSize = ElfSize(image);
+  if ((elfSize == 0) || (elfSize > size)) {
+    LogPrintfInfo("Ignore damaged code object cache file %s", fname.c_str());
+    amd::Os::MemoryUnmapFile(image, size);
+    return false;
+  }
+  {
+    amd::ScopedLock lock(cacheLock());
+    cacheMappings()[image] = size;
+  }
+  code_obj = std::make_pair(image, size);
+  LogPrintfInfo("Loaded code object for %s from cache file %s", isa.c_str(), fname.c_str());
+  return true;
+}
+
+// ================================================================================================
+void CodeObject::storeCachedCodeObject(const void* bundle, const std::string& isa,
+                                       const void* code_obj, size_t size) {
+  const auto header = reinterpret_cast<const __ClangOffloadBundleCompressedHeader*>(bundle);
+  if ((HIP_CODE_OBJECT_CACHE_PATH[0] == '\0') || (header->Hash == 0)) {
+    return;
+  }
+  if (!amd::Os::createPath(HIP_CODE_OBJECT_CACHE_PATH)) {
+    LogPrintfInfo("Cannot create the code object cache %s", HIP_CODE_OBJECT_CACHE_PATH);
+    return;
+  }
+  const std::string fname = cacheFileName(header, isa);
+  // Write a private file and rename it, so other processes never map a partial code object
+  const std::string tmpName = fname + "." + std::to_string(amd::Os::getProcessId());
+  std::ofstream file(tmpName, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(code_obj), size);
+  file.close();
+  if (!file || (std::rename(tmpName.c_str(), fname.c_str()) != 0)) {
+    LogPrintfInfo("Cannot store code object cache file %s", fname.c_str());
+    std::remove(tmpName.c_str());
+  }
+}
+
+// ================================================================================================
+bool CodeObject::releaseCachedCodeObject(const void* code_obj) {
+  size_t size = 0;
+  {
+    amd::ScopedLock lock(cacheLock());
+    auto it = cacheMappings().find(code_obj);
+    if (it == cacheMappings().end()) {
+      return false;
+    }
+    size = it->second;
+    cacheMappings().erase(it);
+  }
+  if (!amd::Os::MemoryUnmapFile(code_obj, size)) {
+    LogPrintfError("Cannot unmap cached code object %p", code_obj);
+  }
+  return true;
+}
+
 static bool getProcName(uint32_t EFlags, std::string& proc_name, bool& xnackSupported,
                         bool& sramEccSupported) {
   switch (EFlags & EF_AMDGPU_MACH) {
@@ -634,6 +733,32 @@ hipError_t CodeObject::extractCodeObjectFromFatBinaryUsingComgr(
 
   if (size == 0) size = getFatbinSize(data, isCompressed);
 
+  // The unbundling of a compressed bundle decompresses it. The on-disk cache skips that
+  // work, if it holds the code objects of all devices
+  if (isCompressed) {
+    std::unordered_map<std::string, std::pair<const void*, size_t>> cached;
+    for (const auto& isa : agent_triple_target_ids) {
+      std::pair<const void*, size_t> code_obj(nullptr, 0);
+      if ((cached.find(isa) == cached.end()) && loadCachedCodeObject(data, isa, code_obj)) {
+        cached[isa] = code_obj;
+      }
+    }
+    bool allCached = true;
+    for (const auto& isa : agent_triple_target_ids) {
+      allCached &= (cached.find(isa) != cached.end());
+    }
+    if (allCached) {
+      code_objs.reserve(num_devices);
+      for (const auto& isa : agent_triple_target_ids) {
+        code_objs.push_back(cached[isa]);
+      }
+      return hipSuccess;
+    }
+    for (const auto& it : cached) {
+      releaseCachedCodeObject(it.second.first);
+    }
+  }
+
   amd_comgr_data_t dataCodeObj{0};
   amd_comgr_data_set_t dataSetBundled{0};
   amd_comgr_data_set_t dataSetUnbundled{0};
@@ -933,6 +1058,16 @@ hipError_t CodeObject::extractCodeObjectFromFatBinaryUsingComgr(
     }
   }
 
+  if (isCompressed && ((hipStatus == hipSuccess) || (hipStatus == hipErrorNoBinaryForGpu))) {
+    std::set<const void*> stored;
+    for (size_t dev = 0; dev < code_objs.size(); ++dev) {
+      if ((code_objs[dev].first != nullptr) && stored.insert(code_objs[dev].first).second) {
+        storeCachedCodeObject(data, agent_triple_target_ids[dev], code_objs[dev].first,
+                              code_objs[dev].second);
+      }
+    }
+  }
+
   return hipStatus;
 }
 
@@ -968,6 +1103,7 @@ DynCO::~DynCO() {
     delete elem.second;
   }
   vars_.clear();
+  resolvedVars_.clear();
 
   for (auto& elem : functions_) {
     delete elem.second;
@@ -992,6 +1128,38 @@ hipError_t DynCO::getDeviceVar(DeviceVar** dvar, std::string var_name) {
   return err;
 }
 
+hipError_t DynCO::getGlobalVar(const char* var_name, hipDeviceptr_t* dev_ptr,
+                               size_t* size_ptr) {
+  amd::ScopedLock lock(dclock_);
+
+  std::string name(var_name);
+  auto cached = resolvedVars_.find(name);
+  if (cached == resolvedVars_.end()) {
+    auto it = vars_.find(name);
+    if (it == vars_.end()) {
+      LogPrintfError("Cannot find the Var: %s ", var_name);
+      return hipErrorNotFound;
+    }
+    std::pair<hipDeviceptr_t, size_t> resolved;
+    if (it->second->getVarKind() == Var::DVK_Managed) {
+      resolved = {it->second->getManagedVarPtr(), it->second->getSize()};
+    } else {
+      CheckDeviceIdMatch();
+      DeviceVar* dvar = nullptr;
+      IHIP_RETURN_ONFAIL(it->second->getDeviceVar(&dvar, device_id_, module()));
+      resolved = {dvar->device_ptr(), dvar->size()};
+    }
+    cached = resolvedVars_.emplace(std::move(name), resolved).first;
+  }
+  if (dev_ptr != nullptr) {
+    *dev_ptr = cached->second.first;
+  }
+  if (size_ptr != nullptr) {
+    *size_ptr = cached->second.second;
+  }
+  return hipSuccess;
+}
+
 hipError_t DynCO::getDynFunc(hipFunction_t* hfunc, std::string func_name) {
   amd::ScopedLock lock(dclock_);
 
@@ -1118,6 +1286,7 @@ StatCO::StatCO() {}
 
 StatCO::~StatCO() {
   amd::ScopedLock lock(sclock_);
+  waitPreload();
 
   for (auto& elem : functions_) {
     delete elem.second;
@@ -1139,6 +1308,12 @@ hipError_t StatCO::digestFatBinary(const void* data, FatBinaryInfo*& programs) {
 
   // Create a new fat binary object and extract the fat binary for all devices.
   programs = new FatBinaryInfo(nullptr, data);
+  if (HIP_DEFER_FATBIN_EXTRACTION || (HIP_FATBIN_LOAD_THREADS > 0)) {
+    // Each device unbundles its code object on the first kernel or variable lookup, or on
+    // a preload worker
+    programs->DeferExtraction();
+    return hipSuccess;
+  }
   IHIP_RETURN_ONFAIL(programs->ExtractFatBinary(g_devices));
 
   return hipSuccess;
@@ -1154,8 +1329,65 @@ FatBinaryInfo** StatCO::addFatBinary(const void* data, bool initialized) {
   return &modules_[data];
 }
 
+void StatCO::preloadFatBinaries(uint32_t numThreads) {
+  amd::ScopedLock lock(sclock_);
+  // Every (fat binary, device) pair is an independent task. The fat binary serializes
+  // the unbundling of its devices, but the program builds run in parallel. The tasks go
+  // device by device, so the workers decompress different bundles at the same time, and
+  // the first device unbundles a compressed bundle for all devices
+  auto tasks = std::make_shared<std::vector<std::pair<FatBinaryInfo*, int>>>();
+  for (auto dev : g_devices) {
+    for (auto& it : modules_) {
+      if (it.second != nullptr) {
+        tasks->emplace_back(it.second, dev->deviceId());
+      }
+    }
+  }
+  const size_t numWorkers = std::min<size_t>(numThreads, tasks->size());
+  if (numWorkers == 0) {
+    return;
+  }
+  auto next = std::make_shared<std::atomic<size_t>>(0);
+  auto load = [tasks, next]() {
+    // The worker must have a runtime thread for the locks in the program build
+    amd::Thread* thread = amd::Thread::current();
+    const bool hostThread = (thread == nullptr);
+    if (hostThread && (((thread = new amd::HostThread()) == nullptr) ||
+                       (thread != amd::Thread::current()))) {
+      // The remaining pairs are loaded on the first lookup
+      return;
+    }
+    for (size_t i = next->fetch_add(1); i < tasks->size(); i = next->fetch_add(1)) {
+      auto& task = (*tasks)[i];
+      // A failure is reported again to the API, which looks up the kernel or variable
+      if (task.first->BuildProgram(task.second) != hipSuccess) {
+        ClPrint(amd::LOG_INFO, amd::LOG_CODE, "Preload of fat binary %p for device %d failed",
+                task.first, task.second);
+      }
+    }
+    if (hostThread) {
+      delete thread;
+    }
+  };
+  preloadWorkers_.reserve(numWorkers);
+  for (size_t w = 0; w < numWorkers; ++w) {
+    preloadWorkers_.emplace_back(load);
+  }
+  ClPrint(amd::LOG_INFO, amd::LOG_CODE, "Loading %zu fat binary code objects on %zu threads",
+          tasks->size(), numWorkers);
+}
+
+void StatCO::waitPreload() {
+  // The caller holds sclock_, which the workers never take
+  for (auto& worker : preloadWorkers_) {
+    worker.join();
+  }
+  preloadWorkers_.clear();
+}
+
 hipError_t StatCO::removeFatBinary(FatBinaryInfo** module) {
   amd::ScopedLock lock(sclock_);
+  waitPreload();
 
   auto vit = vars_.begin();
   while (vit != vars_.end()) {
@@ -1235,6 +1467,7 @@ const char* StatCO::getStatFuncName(const void* hostFunction) {
 
 hipError_t StatCO::getStatFunc(hipFunction_t* hfunc, const void* hostFunction, int deviceId) {
   amd::ScopedLock lock(sclock_);
+  waitPreload();
 
   const auto it = functions_.find(hostFunction);
   if (it == functions_.end()) {
@@ -1247,6 +1480,7 @@ hipError_t StatCO::getStatFunc(hipFunction_t* hfunc, const void* hostFunction, i
 hipError_t StatCO::getStatFuncAttr(hipFuncAttributes* func_attr, const void* hostFunction,
                                    int deviceId) {
   amd::ScopedLock lock(sclock_);
+  waitPreload();
 
   const auto it = functions_.find(hostFunction);
   if (it == functions_.end()) {
@@ -1271,6 +1505,7 @@ hipError_t StatCO::registerStatGlobalVar(const void* hostVar, Var* var) {
 hipError_t StatCO::getStatGlobalVar(const void* hostVar, int deviceId, hipDeviceptr_t* dev_ptr,
                                     size_t* size_ptr) {
   amd::ScopedLock lock(sclock_);
+  waitPreload();
 
   const auto it = vars_.find(hostVar);
   if (it == vars_.end()) {
@@ -1292,6 +1527,7 @@ hipError_t StatCO::registerStatManagedVar(Var* var) {
 
 hipError_t StatCO::initStatManagedVarDevicePtr(int deviceId) {
   amd::ScopedLock lock(sclock_);
+  waitPreload();
   hipError_t err = hipSuccess;
   if (managedVarsDevicePtrInitalized_.find(deviceId) == managedVarsDevicePtrInitalized_.end() ||
       !managedVarsDevicePtrInitalized_[deviceId]) {
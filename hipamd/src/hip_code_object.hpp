@@ -27,6 +27,7 @@ THE SOFTWARE.
 
 #include <cstring>
 #include <unordered_map>
+#include <thread>
 
 #include "hip/hip_runtime.h"
 #include "hip/hip_runtime_api.h"
@@ -89,7 +90,17 @@ class CodeObject {
       const void* data, size_t size, const std::vector<std::string>& devices,
       std::vector<std::pair<const void*, size_t>>& code_objs);
 
+  //Unmaps a code object, loaded from the on-disk cache. Returns false for other code objects
+  static bool releaseCachedCodeObject(const void* code_obj);
+
  protected:
+  //Maps the code object of a compressed bundle for the isa from the on-disk cache
+  static bool loadCachedCodeObject(const void* bundle, const std::string& isa,
+                                   std::pair<const void*, size_t>& code_obj);
+  //Stores the code object of a compressed bundle for the isa in the on-disk cache
+  static void storeCachedCodeObject(const void* bundle, const std::string& isa,
+                                    const void* code_obj, size_t size);
+
   //Given an ptr to image or file, extracts to code object
   //for corresponding devices
   static hipError_t extractCodeObjectFromFatBinary(const void*,
@@ -117,6 +128,8 @@ public:
   //Gets GlobalVar/Functions from a dynamically loaded code object
   hipError_t getDynFunc(hipFunction_t* hfunc, std::string func_name);
   hipError_t getDeviceVar(DeviceVar** dvar, std::string var_name);
+  //Resolves the device pointer and size of a managed or device var, cached by name
+  hipError_t getGlobalVar(const char* var_name, hipDeviceptr_t* dev_ptr, size_t* size_ptr);
 
   hipError_t getManagedVarPointer(std::string name, void** pointer, size_t* size_ptr) const {
     auto it = vars_.find(name);
@@ -143,6 +156,8 @@ private:
   //Maps for vars/funcs, could be keyed in with std::string name
   std::unordered_map<std::string, Function*> functions_;
   std::unordered_map<std::string, Var*> vars_;
+  //Device pointer and size of the already resolved vars, the module is tied to one device
+  std::unordered_map<std::string, std::pair<hipDeviceptr_t, size_t>> resolvedVars_;
 
   //Populate Global Vars/Funcs from an code object(@ module_load)
   hipError_t populateDynGlobalFuncs();
@@ -178,7 +193,13 @@ public:
   //Managed variable is a defined symbol in code object
   //pointer to the alocated managed memory has to be copied to the address of symbol
   hipError_t initStatManagedVarDevicePtr(int deviceId);
+
+  //Unbundles and builds every fat binary for every device on worker threads
+  void preloadFatBinaries(uint32_t numThreads);
 private:
+  //Waits for the workers of preloadFatBinaries(). The lookups call it before the first build
+  void waitPreload();
+
   friend class hip::PlatformState;
   //Populated during __hipRegisterFatBinary
   std::unordered_map<const void*, FatBinaryInfo*> modules_;
@@ -189,6 +210,8 @@ private:
   //Populated during __hipRegisterManagedVar
   std::vector<Var*> managedVars_;
   std::unordered_map<int, bool> managedVarsDevicePtrInitalized_;
+  //Background workers, which load the fat binaries after init
+  std::vector<std::thread> preloadWorkers_;
 };
 
 }; // namespace hip
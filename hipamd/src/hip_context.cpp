@@ -77,6 +77,11 @@ void init(bool* status) {
   amd::RuntimeTearDown::RegisterObject(hContext);
 
   PlatformState::instance().init();
+  FlightRecorder::init();
+  initTraceExport();
+#if HIP_PHASE_PROFILE
+  PhaseProfile::init();
+#endif
   *status = true;
   return;
 }
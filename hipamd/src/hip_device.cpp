@@ -22,6 +22,7 @@
 #include <hip/hip_deprecated.h>
 
 #include "hip_internal.hpp"
+#include "hip_event.hpp"
 #include "hip_mempool_impl.hpp"
 #include "hip_platform.hpp"
 
@@ -76,6 +77,27 @@ bool Device::Create() {
 
   // Current is default pool after device creation
   current_mem_pool_ = default_mem_pool_;
+
+  if (HIP_MEM_POOL_TRIM_INTERVAL != 0) {
+    pool_trimmer_ = new MemoryPoolTrimmer(this);
+    if ((pool_trimmer_ == nullptr) || (pool_trimmer_->state() < amd::Thread::INITIALIZED) ||
+        !pool_trimmer_->start(nullptr)) {
+      LogError("Couldn't start the memory pool trim thread");
+      delete pool_trimmer_;
+      pool_trimmer_ = nullptr;
+    }
+  }
+
+  if (HIP_CALLBACK_THREAD) {
+    callback_dispatcher_ = new CallbackDispatcher(devices()[0]->getPreferredNumaNode());
+    if ((callback_dispatcher_ == nullptr) ||
+        (callback_dispatcher_->state() < amd::Thread::INITIALIZED) ||
+        !callback_dispatcher_->start(nullptr)) {
+      LogError("Couldn't start the callback dispatch thread, callbacks run inline");
+      delete callback_dispatcher_;
+      callback_dispatcher_ = nullptr;
+    }
+  }
   return true;
 }
 
@@ -123,6 +145,14 @@ void Device::ReleaseFreedMemory() {
   }
 }
 
+// ================================================================================================
+void Device::TrimIdleMemoryPools() {
+  amd::ScopedLock lock(lock_);
+  for (auto it : mem_pools_) {
+    it->TrimIdle();
+  }
+}
+
 // ================================================================================================
 void Device::RemoveStreamFromPools(Stream* stream) {
   amd::ScopedLock lock(lock_);
@@ -220,36 +250,66 @@ void Device::WaitActiveStreams(hip::Stream* blocking_stream, bool wait_null_stre
 
 // ================================================================================================
 void Device::AddStream(Stream* stream) {
-  amd::ScopedLock lock(streamSetLock);
-  streamSet.insert(stream);
+  auto& shard = GetStreamSetShard(stream);
+  amd::ScopedLock lock(shard.lock_);
+  shard.streams_.insert(stream);
 }
 
 // ================================================================================================
 void Device::RemoveStream(Stream* stream){
-  amd::ScopedLock lock(streamSetLock);
-  streamSet.erase(stream);
+  auto& shard = GetStreamSetShard(stream);
+  amd::ScopedLock lock(shard.lock_);
+  shard.streams_.erase(stream);
 }
 
 // ================================================================================================
 bool Device::StreamExists(Stream* stream){
-  amd::ScopedLock lock(streamSetLock);
-  if (streamSet.find(stream) != streamSet.end()) {
+  auto& shard = GetStreamSetShard(stream);
+  amd::ScopedLock lock(shard.lock_);
+  if (shard.streams_.find(stream) != shard.streams_.end()) {
     return true;
   }
   return false;
 }
 
+// ================================================================================================
+bool Device::ParkPerThreadStream(Stream* stream) {
+  amd::ScopedLock lock(parked_lock_);
+  if (parked_streams_.size() >= kMaxParkedStreams) {
+    return false;
+  }
+  parked_streams_.push_back(stream);
+  return true;
+}
+
+// ================================================================================================
+Stream* Device::UnparkPerThreadStream() {
+  amd::ScopedLock lock(parked_lock_);
+  while (!parked_streams_.empty()) {
+    Stream* stream = parked_streams_.back();
+    parked_streams_.pop_back();
+    // A device reset could destroy the parked stream
+    if (StreamExists(stream)) {
+      return stream;
+    }
+  }
+  return nullptr;
+}
+
 // ================================================================================================
 void Device::destroyAllStreams() {
-  std::vector<Stream*> toBeDeleted;
   {
-    amd::ScopedLock lock(streamSetLock);
-    for (auto& it : streamSet) {
-      if (it->Null() == false ) {
-        toBeDeleted.push_back(it);
-      }
-    }
+    // The parked streams are destroyed below with the rest of the device streams
+    amd::ScopedLock lock(parked_lock_);
+    parked_streams_.clear();
   }
+  std::vector<Stream*> toBeDeleted;
+  FindStream([&toBeDeleted](Stream* it) {
+    if (it->Null() == false ) {
+      toBeDeleted.push_back(it);
+    }
+    return false;
+  });
   for (auto& it : toBeDeleted) {
     hip::Stream::Destroy(it);
   }
@@ -260,46 +320,52 @@ void Device::destroyAllStreams() {
 void Device::SyncAllStreams( bool cpu_wait) {
   // Make a local copy to avoid stalls for GPU finish with multiple threads
   std::vector<hip::Stream*> streams;
-  streams.reserve(streamSet.size());
-  {
-    amd::ScopedLock lock(streamSetLock);
-    for (auto it : streamSet) {
-      streams.push_back(it);
-      it->retain();
-    }
-  }
+  FindStream([&streams](Stream* it) {
+    streams.push_back(it);
+    it->retain();
+    return false;
+  });
   for (auto it : streams) {
     it->finish(cpu_wait);
     it->release();
   }
+  WaitCallbacks();
   // Release freed memory for all memory pools on the device
   ReleaseFreedMemory();
 }
 
 // ================================================================================================
-bool Device::StreamCaptureBlocking() {
-  amd::ScopedLock lock(streamSetLock);
-  for (auto& it : streamSet) {
-    if (it->GetCaptureStatus() == hipStreamCaptureStatusActive && it->Flags() != hipStreamNonBlocking) {
-      return true;
-    }
+void Device::WaitCallbacks() {
+  if (callback_dispatcher_ != nullptr) {
+    callback_dispatcher_->Wait();
   }
-  return false;
+}
+
+// ================================================================================================
+bool Device::StreamCaptureBlocking() {
+  return FindStream([](Stream* it) {
+    return (it->GetCaptureStatus() == hipStreamCaptureStatusActive) &&
+           (it->Flags() != hipStreamNonBlocking);
+  });
 }
 
 // ================================================================================================
 bool Device::existsActiveStreamForDevice() {
-  amd::ScopedLock lock(streamSetLock);
-  for (const auto& active_stream : streamSet) {
-    if (active_stream->GetQueueStatus()) {
-      return true;
-    }
-  }
-  return false;
+  return FindStream([](Stream* active_stream) { return active_stream->GetQueueStatus(); });
 }
 
 // ================================================================================================
 Device::~Device() {
+  if (pool_trimmer_ != nullptr) {
+    pool_trimmer_->Terminate();
+    delete pool_trimmer_;
+  }
+
+  if (callback_dispatcher_ != nullptr) {
+    callback_dispatcher_->Terminate();
+    delete callback_dispatcher_;
+  }
+
   if (default_mem_pool_ != nullptr) {
     default_mem_pool_->release();
   }
@@ -317,6 +383,8 @@ void ihipDestroyDevice() {
   for (auto deviceHandle : g_devices) {
     delete deviceHandle;
   }
+  // Thread caches can be destroyed later and must not access the devices
+  g_devices.clear();
 }
 
 hipError_t ihipDeviceGet(hipDevice_t* device, int deviceId) {
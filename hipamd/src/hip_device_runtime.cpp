@@ -21,6 +21,7 @@
 #include <hip/hip_runtime.h>
 
 #include "hip_internal.hpp"
+#include "utils/metrics.hpp"
 
 #undef hipChooseDevice
 #undef hipDeviceProp_t
@@ -750,6 +751,22 @@ hipError_t hipSetValidDevices(int* device_arr, int len) {
 
   HIP_RETURN(hipErrorNotSupported);
 }
+
+hipError_t hipExtGetRuntimeMetrics(const char** names, uint64_t* values, size_t* count) {
+  HIP_INIT_API(hipExtGetRuntimeMetrics, names, values, count);
+
+  if (count == nullptr) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  if ((names == nullptr) && (values == nullptr)) {
+    // Query of the number of the metrics
+    *count = amd::Metrics::count();
+    HIP_RETURN(hipSuccess);
+  }
+  *count = amd::Metrics::snapshot(names, values, *count);
+
+  HIP_RETURN(hipSuccess);
+}
 } //namespace hip
 
 extern "C" hipError_t hipChooseDevice(int* device, const hipDeviceProp_tR0000* properties) {
@@ -225,6 +225,8 @@ hipError_t Event::recordCommand(amd::Command*& command, amd::HostQueue* stream,
                              hipEventDisableSystemFence);
     if (releaseFlags & hipEventDisableSystemFence) {
       releaseFlags = amd::Device::kCacheStateIgnore;
+    } else if (releaseFlags & hipEventReleaseToDevice) {
+      releaseFlags = amd::Device::kCacheStateAgent;
     } else {
       releaseFlags = amd::Device::kCacheStateInvalid;
     }
@@ -65,6 +65,36 @@ class LaunchHostFuncCallback : public StreamCallback {
   void CL_CALLBACK callback() { callBack_(userData_); }
 };
 
+/// Per-device completion thread, which runs the ready stream callbacks of all streams in
+/// the order their markers completed, so the HSA signal handler never executes user code
+class CallbackDispatcher : public amd::Thread {
+ public:
+  CallbackDispatcher(uint32_t numa_node)
+      : amd::Thread("Callback Dispatch Thread", CQ_THREAD_STACK_SIZE),
+        lock_("Callback dispatch lock", false), submitted_(0), completed_(0),
+        numa_node_(numa_node), terminate_(false) {}
+
+  //! The dispatch thread entry point
+  void run(void* data);
+
+  //! Queues a ready callback for the execution. The dispatcher destroys it after the call
+  void Enqueue(StreamCallback* cbo);
+
+  //! Waits until all callbacks, queued before this call, are done
+  void Wait();
+
+  //! Runs the remaining callbacks, stops the thread and waits for the exit
+  void Terminate();
+
+ private:
+  amd::Monitor lock_;                     //!< Guards the pending list and the counters
+  std::vector<StreamCallback*> pending_;  //!< Ready callbacks in the completion order
+  uint64_t submitted_;                    //!< The number of queued callbacks
+  uint64_t completed_;                    //!< The number of executed callbacks
+  uint32_t numa_node_;                    //!< NUMA node closest to the device
+  bool terminate_;                        //!< The thread must exit
+};
+
 void CL_CALLBACK ihipStreamCallback(cl_event event, cl_int command_exec_status, void* user_data);
 
 
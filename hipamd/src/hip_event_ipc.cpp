@@ -128,6 +128,19 @@ hipError_t IPCEvent::streamWait(hipStream_t stream, uint flags) {
 
   amd::ScopedLock lock(lock_);
   if(query() != hipSuccess) {
+    if (!GPU_STREAMOPS_CP_WAIT) {
+      // The device of the recording process clears the slot of the last record. Make the GPU
+      // wait for the clear with a stream wait operation, so the host doesn't block on the wait.
+      // CP waits require the signal memory, which the shared memory isn't, hence the fallback.
+      int read_index = ipc_evt_.ipc_shmem_->read_index;
+      if (read_index < 0) {
+        return hipSuccess;
+      }
+      int offset = read_index % IPC_SIGNALS_PER_EVENT;
+      return ihipStreamOperation(stream, ROCCLR_COMMAND_STREAM_WAIT_VALUE,
+                                 &(ipc_evt_.ipc_shmem_->signal[offset]), 0, 0xFFFFFFFF,
+                                 hipStreamWaitValueEq, sizeof(uint32_t));
+    }
     amd::Command* command;
     hipError_t status = streamWaitCommand(command, hip_stream);
     if (status != hipSuccess) {
@@ -48,6 +48,7 @@ FatBinaryInfo::FatBinaryInfo(const char* fname, const void* image) : fdesc_(amd:
   }
 
   fatbin_dev_info_.resize(g_devices.size(), nullptr);
+  dev_extracted_.resize(g_devices.size(), false);
 }
 
 FatBinaryInfo::~FatBinaryInfo() {
@@ -64,7 +65,9 @@ FatBinaryInfo::~FatBinaryInfo() {
   }
   for (auto itemData : toDelete) {
     LogPrintfInfo("~FatBinaryInfo(%p) will delete binary_image_ %p", this, itemData);
-    delete[] reinterpret_cast<const char*>(itemData);
+    if (!CodeObject::releaseCachedCodeObject(itemData)) {
+      delete[] reinterpret_cast<const char*>(itemData);
+    }
   }
   if (!HIP_USE_RUNTIME_UNBUNDLER) {
     // Using COMGR Unbundler
@@ -443,10 +446,42 @@ hipError_t FatBinaryInfo::AddDevProgram(const int device_id) {
   return hipSuccess;
 }
 
+void FatBinaryInfo::ExtractDeferred(const int device_id) {
+  amd::ScopedLock lock(extract_lock_);
+  if (dev_extracted_[device_id]) {
+    return;
+  }
+  std::vector<hip::Device*> devices = {g_devices[device_id]};
+  bool isCompressed = false;
+  if ((image_ != nullptr) && CodeObject::IsClangOffloadMagicBundle(image_, isCompressed) &&
+      isCompressed) {
+    // The unbundling decompresses the whole bundle. Hence extract the code objects of all
+    // remaining devices at once, instead of a decompression per device
+    for (auto device : g_devices) {
+      if ((device->deviceId() != device_id) && !dev_extracted_[device->deviceId()]) {
+        devices.push_back(device);
+      }
+    }
+  }
+  // Mark the devices even on a failure, since the lookup won't find the code object next time
+  for (auto device : devices) {
+    dev_extracted_[device->deviceId()] = true;
+  }
+  hipError_t status = ExtractFatBinary(devices);
+  if (status != hipSuccess) {
+    // AddDevProgram() reports the missing code object to the caller
+    LogPrintfError("Deferred unbundling of fat binary %p for device %d failed with status %d",
+                   image_, device_id, status);
+  }
+}
+
 hipError_t FatBinaryInfo::BuildProgram(const int device_id) {
 
   // Device Id Check and Add DeviceProgram if not added so far
   DeviceIdCheck(device_id);
+  if (deferred_) {
+    ExtractDeferred(device_id);
+  }
   IHIP_RETURN_ONFAIL(AddDevProgram(device_id));
 
   // If Program was already built skip this step and return success
@@ -82,6 +82,8 @@ public:
   hipError_t ExtractFatBinaryUsingCOMGR(const void* data,
                                               const std::vector<hip::Device*>& devices);
   hipError_t ExtractFatBinary(const std::vector<hip::Device*>& devices);
+  //! Postpones the unbundling for every device until BuildProgram() on that device
+  void DeferExtraction() { deferred_ = true; }
   hipError_t AddDevProgram(const int device_id);
   hipError_t BuildProgram(const int device_id);
 
@@ -109,6 +111,9 @@ public:
   }
 
 private:
+  //! Unbundles the code object for a single device, if the extraction was deferred
+  void ExtractDeferred(const int device_id);
+
   std::string fname_;        //!< File name
   amd::Os::FileDesc fdesc_;  //!< File descriptor
   size_t fsize_;             //!< Total file size
@@ -125,6 +130,10 @@ private:
   std::vector<FatBinaryDeviceInfo*> fatbin_dev_info_;
 
   std::shared_ptr<UniqueFD> ufd_; //!< Unique file descriptor
+
+  bool deferred_ = false;           //!< The code objects are unbundled on the first use
+  std::vector<bool> dev_extracted_; //!< Devices, which already unbundled the code object
+  amd::Monitor extract_lock_{true}; //!< Serializes the deferred unbundling
 };
 
 }; // namespace hip
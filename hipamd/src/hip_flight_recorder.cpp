@@ -0,0 +1,251 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "hip_flight_recorder.hpp"
+#include "hip_internal.hpp"
+
+#include <fcntl.h>
+#include <cstdio>
+#include <mutex>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <signal.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace hip {
+
+bool FlightRecorder::enabled_ = false;
+uint64_t FlightRecorder::entries_ = 0;
+std::atomic<uint32_t> FlightRecorder::count_ = 0;
+std::atomic<FlightRecorder::Ring*> FlightRecorder::rings_[FlightRecorder::kMaxRings] = {};
+thread_local FlightRecorder::Ring* FlightRecorder::ring_ = nullptr;
+
+//! Returns the ring of the thread back to the pool on the thread exit
+struct FlightRecorder::ThreadExit {
+  ~ThreadExit() {
+    if (ring_ != nullptr) {
+      detach(ring_);
+      ring_ = nullptr;
+    }
+  }
+};
+
+namespace {
+std::mutex ringLock;                   //!< Serializes the ring assignment
+std::atomic<bool> crashDumped{false};  //!< Avoids the dump for every crashing thread
+
+// ================================================================================================
+void writeFd(int fd, const char* data, int size) {
+  while (size > 0) {
+#if defined(_WIN32)
+    int written = _write(fd, data, size);
+#else
+    int written = ::write(fd, data, size);
+#endif
+    if (written <= 0) {
+      return;
+    }
+    data += written;
+    size -= written;
+  }
+}
+
+#if !defined(_WIN32)
+constexpr int kCrashSignals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+struct sigaction prevActions[NSIG];
+
+// ================================================================================================
+void crashHandler(int sig, siginfo_t* info, void* context) {
+  if (!crashDumped.exchange(true)) {
+    FlightRecorder::dump();
+  }
+  // Chain to the previous handler, which stays installed behind this one
+  const struct sigaction& prev = prevActions[sig];
+  if (prev.sa_flags & SA_SIGINFO) {
+    prev.sa_sigaction(sig, info, context);
+    return;
+  }
+  if (prev.sa_handler == SIG_IGN) {
+    return;
+  }
+  if (prev.sa_handler != SIG_DFL) {
+    prev.sa_handler(sig);
+    return;
+  }
+  // The default action can't be called, hence restore it. A fault repeats on the return with
+  // the original signal info, while a sent signal must be raised again
+  signal(sig, SIG_DFL);
+  if ((info == nullptr) || (info->si_code <= 0)) {
+    raise(sig);
+  }
+}
+
+// ================================================================================================
+void dumpHandler(int sig) {
+  FlightRecorder::dump();
+}
+#endif
+}  // namespace
+
+// ================================================================================================
+void FlightRecorder::init() {
+  if (HIP_FLIGHT_RECORDER == 0) {
+    return;
+  }
+  entries_ = amd::nextPowerOfTwo(static_cast<uint64_t>(HIP_FLIGHT_RECORDER));
+
+#if !defined(_WIN32)
+  if ((HIP_FLIGHT_RECORDER_SIGNAL != 0) && (HIP_FLIGHT_RECORDER_SIGNAL < NSIG)) {
+    struct sigaction action = {};
+    action.sa_handler = dumpHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if (sigaction(HIP_FLIGHT_RECORDER_SIGNAL, &action, nullptr) != 0) {
+      LogPrintfWarning("Couldn't install the flight recorder handler for signal %u",
+                       HIP_FLIGHT_RECORDER_SIGNAL);
+    }
+  }
+  if (HIP_FLIGHT_RECORDER_CRASH_DUMP) {
+    for (int sig : kCrashSignals) {
+      struct sigaction action = {};
+      action.sa_sigaction = crashHandler;
+      sigemptyset(&action.sa_mask);
+      // The alternate stack of the thread, if any, handles the stack overflows
+      action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+      sigaction(sig, &action, &prevActions[sig]);
+    }
+  }
+#endif
+  enabled_ = true;
+}
+
+// ================================================================================================
+FlightRecorder::Ring* FlightRecorder::attach() {
+  Ring* ring = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(ringLock);
+    uint32_t count = count_.load(std::memory_order_relaxed);
+    if (count < kMaxRings) {
+      ring = new (std::nothrow) Ring();
+      if (ring != nullptr) {
+        ring->records_ = new (std::nothrow) Record[entries_];
+        if (ring->records_ == nullptr) {
+          delete ring;
+          return nullptr;
+        }
+        ring->mask_ = entries_ - 1;
+        ring->index_ = 0;
+        ring->busy_ = true;
+        rings_[count].store(ring, std::memory_order_release);
+        count_.store(count + 1, std::memory_order_release);
+      }
+    } else {
+      // All rings are allocated, hence take over the history of an exited thread
+      for (uint32_t i = 0; i < count; ++i) {
+        Ring* candidate = rings_[i].load(std::memory_order_relaxed);
+        if (!candidate->busy_.load(std::memory_order_relaxed)) {
+          ring = candidate;
+          ring->busy_ = true;
+          ring->index_.store(0, std::memory_order_release);
+          break;
+        }
+      }
+    }
+  }
+  if (ring == nullptr) {
+    // The calls of this thread won't be recorded
+    return nullptr;
+  }
+#if defined(_WIN32)
+  ring->thread_ = count_.load(std::memory_order_relaxed);
+#else
+  ring->thread_ = static_cast<uint32_t>(syscall(SYS_gettid));
+#endif
+  static thread_local ThreadExit threadExit;
+  (void)threadExit;
+  ring_ = ring;
+  return ring;
+}
+
+// ================================================================================================
+void FlightRecorder::detach(Ring* ring) {
+  // Keep the records, they are still useful for the dump
+  ring->busy_.store(false, std::memory_order_release);
+}
+
+// ================================================================================================
+void FlightRecorder::dump(int fd) {
+  // Don't allocate or lock below, the dump can run in a signal handler
+  char line[256];
+  const uint64_t now = amd::Os::timeNanos();
+  int size = snprintf(line, sizeof(line),
+                      "HIP flight recorder: the last %lu API calls per thread\n", entries_);
+  writeFd(fd, line, size);
+
+  const uint32_t count = count_.load(std::memory_order_acquire);
+  for (uint32_t i = 0; i < count; ++i) {
+    const Ring* ring = rings_[i].load(std::memory_order_acquire);
+    const uint64_t index = (ring != nullptr) ? ring->index_.load(std::memory_order_acquire) : 0;
+    if (index == 0) {
+      continue;
+    }
+    size = snprintf(line, sizeof(line), "Thread %u%s, %lu calls:\n", ring->thread_,
+                    ring->busy_.load(std::memory_order_relaxed) ? "" : " (exited)", index);
+    writeFd(fd, line, size);
+    const uint64_t first = (index > entries_) ? (index - entries_) : 0;
+    for (uint64_t j = first; j < index; ++j) {
+      const Record& entry = ring->records_[j & ring->mask_];
+      const uint64_t age = (now > entry.timestamp_) ? (now - entry.timestamp_) : 0;
+      size = snprintf(line, sizeof(line),
+                      "  %12lu us ago: %s, stream 0x%lx, %u args, digest 0x%016lx\n", age / 1000,
+                      hip_api_name(entry.api_), entry.stream_, entry.args_, entry.digest_);
+      writeFd(fd, line, size);
+    }
+  }
+}
+
+// ================================================================================================
+void FlightRecorder::dump() {
+  int fd = 2;
+  if ((HIP_FLIGHT_RECORDER_FILE != nullptr) && (HIP_FLIGHT_RECORDER_FILE[0] != '\0')) {
+#if defined(_WIN32)
+    fd = _open(HIP_FLIGHT_RECORDER_FILE, _O_WRONLY | _O_CREAT | _O_APPEND, _S_IREAD | _S_IWRITE);
+#else
+    fd = open(HIP_FLIGHT_RECORDER_FILE, O_WRONLY | O_CREAT | O_APPEND, 0644);
+#endif
+    if (fd < 0) {
+      fd = 2;
+    }
+  }
+  dump(fd);
+  if (fd != 2) {
+#if defined(_WIN32)
+    _close(fd);
+#else
+    close(fd);
+#endif
+  }
+}
+
+}  // namespace hip
@@ -0,0 +1,127 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#ifndef HIP_SRC_HIP_FLIGHT_RECORDER_H
+#define HIP_SRC_HIP_FLIGHT_RECORDER_H
+
+#include <hip/hip_runtime_api.h>
+#include "os/os.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+namespace hip {
+
+//! Keeps the last HIP API calls of every thread for the post-mortem analysis.
+//! A thread writes only its own ring, hence the recording doesn't take locks
+class FlightRecorder {
+ public:
+  struct Record {
+    uint64_t timestamp_;  //!< Time of the call in ns
+    uint64_t stream_;     //!< The first stream argument of the call, 0 if none
+    uint64_t digest_;     //!< Hash of the scalar and pointer arguments
+    uint32_t api_;        //!< HIP API id
+    uint32_t args_;       //!< The number of the arguments
+  };
+
+  //! Reads the settings and installs the dump signal handlers. Called by hip::init()
+  static void init();
+
+  //! Writes the records of all threads into the file descriptor. Safe to call in a signal handler
+  static void dump(int fd);
+
+  //! Opens the HIP_FLIGHT_RECORDER_FILE and writes the records into it
+  static void dump();
+
+  static bool enabled() { return enabled_; }
+
+  //! Records an API call, the arguments are folded into the digest
+  template <typename... Args> static void record(uint32_t api, const Args&... args) {
+    Ring* ring = ring_;
+    if (ring == nullptr) {
+      ring = attach();
+      if (ring == nullptr) {
+        return;
+      }
+    }
+    uint64_t index = ring->index_.load(std::memory_order_relaxed);
+    Record& entry = ring->records_[index & ring->mask_];
+    entry.timestamp_ = amd::Os::timeNanos();
+    entry.stream_ = 0;
+    entry.digest_ = kDigestBasis;
+    (fold(entry, args), ...);
+    entry.api_ = api;
+    entry.args_ = sizeof...(Args);
+    // Publish the entry for the dump
+    ring->index_.store(index + 1, std::memory_order_release);
+  }
+
+ private:
+  struct Ring {
+    std::atomic<uint64_t> index_;  //!< The number of the records so far
+    std::atomic<bool> busy_;       //!< The ring belongs to a live thread
+    uint32_t thread_;              //!< Id of the thread, which owns the ring
+    uint64_t mask_;                //!< The number of records minus one
+    Record* records_;              //!< The records, indexed by index_ & mask_
+  };
+
+  static constexpr uint64_t kDigestBasis = 0xcbf29ce484222325ULL;
+  static constexpr uint64_t kDigestPrime = 0x100000001b3ULL;
+  static constexpr uint32_t kMaxRings = 1024;
+
+  template <typename T> static void fold(Record& entry, const T& arg) {
+    using Type = std::decay_t<T>;
+    uint64_t value = 0;
+    if constexpr (std::is_same_v<Type, hipStream_t>) {
+      value = reinterpret_cast<uint64_t>(arg);
+      if (entry.stream_ == 0) {
+        entry.stream_ = value;
+      }
+    } else if constexpr (std::is_null_pointer_v<Type>) {
+      value = 0;
+    } else if constexpr (std::is_pointer_v<Type>) {
+      value = reinterpret_cast<uint64_t>(arg);
+    } else if constexpr (std::is_arithmetic_v<Type> || std::is_enum_v<Type>) {
+      value = static_cast<uint64_t>(arg);
+    } else {
+      // Structures passed by value contribute only the size
+      value = sizeof(Type);
+    }
+    entry.digest_ = (entry.digest_ ^ value) * kDigestPrime;
+  }
+
+  struct ThreadExit;
+
+  //! Assigns a ring to the current thread
+  static Ring* attach();
+  //! Returns the ring of an exited thread back to the pool
+  static void detach(Ring* ring);
+
+  static bool enabled_;                    //!< HIP_FLIGHT_RECORDER is not 0
+  static uint64_t entries_;                //!< The number of records in every ring
+  static std::atomic<uint32_t> count_;     //!< The number of valid rings_
+  static std::atomic<Ring*> rings_[kMaxRings];  //!< All allocated rings
+  static thread_local Ring* ring_;         //!< The ring of the current thread
+};
+
+}  // namespace hip
+
+#endif  // HIP_SRC_HIP_FLIGHT_RECORDER_H
@@ -635,7 +635,14 @@ hipError_t hipGraphicsMapResources(int count, hipGraphicsResource_t* resources,
     HIP_RETURN(hipErrorUnknown);
   }
   clearGLErrors(*amdContext);
-  amdContext->glenv()->glFinish_();
+  // Wait on a fence for the GL commands issued before the map. Unlike glFinish() the wait
+  // completes with the GPU work of those commands and doesn't force the full GL finish
+  amd::GLFunctions* glenv = amdContext->glenv();
+  GLsync fence = glenv->glFenceSync_(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  if (fence != nullptr) {
+    glenv->glClientWaitSync_(fence, GL_SYNC_FLUSH_COMMANDS_BIT, static_cast<GLuint64>(-1));
+    glenv->glDeleteSync_(fence);
+  }
   if (checkForGLError(*amdContext) != GL_NO_ERROR) {
     HIP_RETURN(hipErrorUnknown);
   }
@@ -114,7 +114,7 @@ hipError_t ihipGraphAddKernelNode(hip::GraphNode** pGraphNode, hip::Graph* graph
     return hipErrorInvalidConfiguration;
   }
 
-  *pGraphNode = new hip::GraphKernelNode(pNodeParams, pNodeEvents);
+  *pGraphNode = new (graph->NodeArena()) hip::GraphKernelNode(pNodeParams, pNodeEvents);
   status = ihipGraphAddNode(*pGraphNode, graph, pDependencies, numDependencies, capture);
   return status;
 }
@@ -130,7 +130,7 @@ hipError_t ihipGraphAddMemcpyNode(hip::GraphNode** pGraphNode, hip::Graph* graph
   if (status != hipSuccess) {
     return status;
   }
-  *pGraphNode = new hip::GraphMemcpyNode(pCopyParams);
+  *pGraphNode = new (graph->NodeArena()) hip::GraphMemcpyNode(pCopyParams);
   status = ihipGraphAddNode(*pGraphNode, graph, pDependencies, numDependencies, capture);
   return status;
 }
@@ -147,7 +147,7 @@ hipError_t ihipDrvGraphAddMemcpyNode(hip::GraphNode** pGraphNode, hip::Graph* gr
   if (status != hipSuccess) {
     return status;
   }
-  *pGraphNode = new hip::GraphDrvMemcpyNode(pCopyParams);
+  *pGraphNode = new (graph->NodeArena()) hip::GraphDrvMemcpyNode(pCopyParams);
   status = ihipGraphAddNode(*pGraphNode, graph, pDependencies, numDependencies, capture);
   return status;
 }
@@ -164,7 +164,7 @@ hipError_t ihipGraphAddMemcpyNode1D(hip::GraphNode** pGraphNode, hip::Graph* gra
   if (status != hipSuccess) {
     return status;
   }
-  *pGraphNode = new hip::GraphMemcpyNode1D(dst, src, count, kind);
+  *pGraphNode = new (graph->NodeArena()) hip::GraphMemcpyNode1D(dst, src, count, kind);
   status = ihipGraphAddNode(*pGraphNode, graph, pDependencies, numDependencies, capture);
   return status;
 }
@@ -208,7 +208,7 @@ hipError_t ihipGraphAddMemsetNode(hip::GraphNode** pGraphNode, hip::Graph* graph
   if (status != hipSuccess) {
     return status;
   }
-  *pGraphNode = new hip::GraphMemsetNode(pMemsetParams, depth);
+  *pGraphNode = new (graph->NodeArena()) hip::GraphMemsetNode(pMemsetParams, depth);
   status = ihipGraphAddNode(*pGraphNode, graph, pDependencies, numDependencies, capture);
   return status;
 }
@@ -263,7 +263,7 @@ hipError_t ihipExtLaunchKernel(hipStream_t stream, hipFunction_t f, uint32_t glo
   nodeEvents.stopEvent_ = stopEvent;
 
   if (startEvent != nullptr) {
-    pGraphNode = new hip::GraphEventRecordNode(startEvent);
+    pGraphNode = new (s->GetCaptureGraph()->NodeArena()) hip::GraphEventRecordNode(startEvent);
     status = ihipGraphAddNode(pGraphNode, s->GetCaptureGraph(), s->GetLastCapturedNodes().data(),
                               s->GetLastCapturedNodes().size(), capture);
     if (status != hipSuccess) {
@@ -591,7 +591,8 @@ hipError_t capturehipMemcpy(hipStream_t stream, void* dst, const void* src, size
   if (status != hipSuccess) {
     return status;
   }
-  hip::GraphNode* node = new hip::GraphMemcpyNode1D(dst, src, sizeBytes, kind);
+  hip::GraphNode* node =
+      new (graph->NodeArena()) hip::GraphMemcpyNode1D(dst, src, sizeBytes, kind);
   status = ihipGraphAddNode(node, graph, pDependencies.data(), numDependencies);
   if (status != hipSuccess) {
     return status;
@@ -656,8 +657,8 @@ hipError_t capturehipMemcpyFromSymbolAsync(hipStream_t& stream, void*& dst, cons
     HIP_RETURN(status);
   }
   hip::Stream* s = reinterpret_cast<hip::Stream*>(stream);
-  hip::GraphNode* pGraphNode =
-      new hip::GraphMemcpyNodeFromSymbol(dst, symbol, sizeBytes, offset, kind);
+  hip::GraphNode* pGraphNode = new (s->GetCaptureGraph()->NodeArena())
+      hip::GraphMemcpyNodeFromSymbol(dst, symbol, sizeBytes, offset, kind);
   status = ihipGraphAddNode(pGraphNode, s->GetCaptureGraph(), s->GetLastCapturedNodes().data(),
                             s->GetLastCapturedNodes().size());
   if (status != hipSuccess) {
@@ -681,7 +682,8 @@ hipError_t capturehipMemcpyToSymbolAsync(hipStream_t& stream, const void*& symbo
     HIP_RETURN(status);
   }
   hip::Stream* s = reinterpret_cast<hip::Stream*>(stream);
-  hip::GraphNode* pGraphNode = new hip::GraphMemcpyNodeToSymbol(symbol, src, sizeBytes, offset, kind);
+  hip::GraphNode* pGraphNode = new (s->GetCaptureGraph()->NodeArena())
+      hip::GraphMemcpyNodeToSymbol(symbol, src, sizeBytes, offset, kind);
   status = ihipGraphAddNode(pGraphNode, s->GetCaptureGraph(), s->GetLastCapturedNodes().data(),
                             s->GetLastCapturedNodes().size());
   if (status != hipSuccess) {
@@ -782,7 +784,8 @@ hipError_t capturehipLaunchHostFunc(hipStream_t& stream, hipHostFn_t& fn, void*&
   hostParams.fn = fn;
   hostParams.userData = userData;
   hip::Stream* s = reinterpret_cast<hip::Stream*>(stream);
-  hip::GraphNode* pGraphNode = new hip::GraphHostNode(&hostParams);
+  hip::GraphNode* pGraphNode =
+      new (s->GetCaptureGraph()->NodeArena()) hip::GraphHostNode(&hostParams);
   hipError_t status =
       ihipGraphAddNode(pGraphNode, s->GetCaptureGraph(), s->GetLastCapturedNodes().data(),
                        s->GetLastCapturedNodes().size());
@@ -817,7 +820,8 @@ hipError_t capturehipMallocAsync(hipStream_t stream, hipMemPool_t mem_pool,
   node_params.accessDescCount = descs.size();
   node_params.bytesize = size;
 
-  auto mem_alloc_node = new hip::GraphMemAllocNode(&node_params);
+  auto mem_alloc_node =
+      new (s->GetCaptureGraph()->NodeArena()) hip::GraphMemAllocNode(&node_params);
   auto status = ihipGraphAddNode(mem_alloc_node, s->GetCaptureGraph(),
       s->GetLastCapturedNodes().data(), s->GetLastCapturedNodes().size());
   if (status != hipSuccess) {
@@ -833,7 +837,7 @@ hipError_t capturehipMallocAsync(hipStream_t stream, hipMemPool_t mem_pool,
 // ================================================================================================
 hipError_t capturehipFreeAsync(hipStream_t stream, void* dev_ptr) {
   hip::Stream* s = reinterpret_cast<hip::Stream*>(stream);
-  auto mem_free_node = new hip::GraphMemFreeNode(dev_ptr);
+  auto mem_free_node = new (s->GetCaptureGraph()->NodeArena()) hip::GraphMemFreeNode(dev_ptr);
   auto status = ihipGraphAddNode(mem_free_node, s->GetCaptureGraph(),
       s->GetLastCapturedNodes().data(), s->GetLastCapturedNodes().size());
   if (status != hipSuccess) {
@@ -911,7 +915,10 @@ hipError_t hipStreamBeginCapture_common(hipStream_t stream, hipStreamCaptureMode
     return hipErrorIllegalState;
   }
   if(graph == nullptr) {
-    s->SetCaptureGraph(new hip::Graph(s->GetDevice()));
+    hip::Graph* captureGraph = new hip::Graph(s->GetDevice());
+    // The capture graph owns all its nodes, hence they can be allocated from an arena
+    captureGraph->EnableNodeArena();
+    s->SetCaptureGraph(captureGraph);
   } else {
     s->SetCaptureGraph(reinterpret_cast<hip::Graph*>(graph));
   }
@@ -1024,7 +1031,7 @@ hipError_t hipStreamEndCapture_common(hipStream_t stream, hip::Graph** pGraph) {
 
   // Add temporary node to check if all parallel streams have joined
   hip::GraphNode* pGraphNode;
-  pGraphNode = reinterpret_cast<hip::GraphNode*>(new hip::GraphEmptyNode());
+  pGraphNode = new (s->GetCaptureGraph()->NodeArena()) hip::GraphEmptyNode();
   hipError_t status =
       ihipGraphAddNode(pGraphNode, s->GetCaptureGraph(), s->GetLastCapturedNodes().data(),
                        s->GetLastCapturedNodes().size());
@@ -1327,6 +1334,9 @@ hipError_t ihipGraphInstantiate(hip::GraphExec** pGraphExec, hip::Graph* graph,
                          flags);
   if (*pGraphExec != nullptr) {
     graph->SetGraphInstantiated(true);
+    if (DEBUG_HIP_GRAPH_DOT_TIMING) {
+      (*pGraphExec)->SetNodeTiming(true);
+    }
     if (DEBUG_HIP_GRAPH_DOT_PRINT) {
       static int i = 1;
       std::string filename =
@@ -1369,6 +1379,7 @@ hipError_t hipGraphInstantiateWithFlags(hipGraphExec_t* pGraphExec, hipGraph_t g
 
   // invalid flag check
   if (flags != 0 && flags != hipGraphInstantiateFlagAutoFreeOnLaunch &&
+      flags != hipGraphInstantiateFlagDeviceLaunch &&
       flags != hipGraphInstantiateFlagUseNodePriority) {
     HIP_RETURN(hipErrorInvalidValue);
   }
@@ -1765,6 +1776,10 @@ hipError_t hipGraphExecChildGraphNodeSetParams(hipGraphExec_t hGraphExec, hipGra
   if (cg == n->GetParentGraph()) {
     HIP_RETURN(hipErrorUnknown);
   }
+  // The body of a conditional node is instantiated for the device launch and can't be replaced
+  if (n->GetType() == hip::kGraphNodeTypeConditional) {
+    HIP_RETURN(hipErrorNotSupported);
+  }
 
   // Validate whether the topology of node and childGraph matches
   std::vector<hip::GraphNode*> childGraphNodes1;
@@ -2066,7 +2081,8 @@ hipError_t hipGraphNodeGetType(hipGraphNode_t node, hipGraphNodeType* pType) {
   if (!hip::GraphNode::isNodeValid(reinterpret_cast<hip::GraphNode*>(n)) || pType == nullptr) {
     HIP_RETURN(hipErrorInvalidValue);
   }
-  *pType = n->GetType();
+  // The conditional node has no public type and looks like a child graph to the application
+  *pType = (n->GetType() == hip::kGraphNodeTypeConditional) ? hipGraphNodeTypeGraph : n->GetType();
   HIP_RETURN(hipSuccess);
 }
 
@@ -3340,4 +3356,66 @@ hipError_t hipDrvGraphMemcpyNodeSetParams(hipGraphNode_t hNode, const HIP_MEMCPY
   HIP_RETURN(reinterpret_cast<hip::GraphDrvMemcpyNode*>(hNode)->SetParams(nodeParams));
 }
 
+hipError_t hipExtGraphExecSetNodeTiming(hipGraphExec_t graphExec, int enable) {
+  HIP_INIT_API(hipExtGraphExecSetNodeTiming, graphExec, enable);
+  hip::GraphExec* exec = reinterpret_cast<hip::GraphExec*>(graphExec);
+  if (!hip::GraphExec::isGraphExecValid(exec)) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  exec->SetNodeTiming(enable != 0);
+  HIP_RETURN(hipSuccess);
+}
+
+hipError_t hipExtGraphExecGetNodeTime(hipGraphExec_t graphExec, hipGraphNode_t node,
+                                      uint64_t* startNs, uint64_t* endNs) {
+  HIP_INIT_API(hipExtGraphExecGetNodeTime, graphExec, node, startNs, endNs);
+  hip::GraphExec* exec = reinterpret_cast<hip::GraphExec*>(graphExec);
+  hip::GraphNode* n = reinterpret_cast<hip::GraphNode*>(node);
+  if (!hip::GraphExec::isGraphExecValid(exec) || !hip::GraphNode::isNodeValid(n) ||
+      startNs == nullptr || endNs == nullptr) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  hip::GraphNode* clonedNode = exec->GetClonedNode(n);
+  if (clonedNode == nullptr || !exec->NodeTiming()) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  HIP_RETURN(exec->NodeTimes().Get(clonedNode, startNs, endNs));
+}
+
+hipError_t hipExtGraphExecGetDeviceGraph(hipGraphExec_t graphExec, void** deviceGraph) {
+  HIP_INIT_API(hipExtGraphExecGetDeviceGraph, graphExec, deviceGraph);
+  hip::GraphExec* exec = reinterpret_cast<hip::GraphExec*>(graphExec);
+  if (!hip::GraphExec::isGraphExecValid(exec) || deviceGraph == nullptr) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  // Only graphs, instantiated with hipGraphInstantiateFlagDeviceLaunch, have the device image
+  *deviceGraph = exec->DeviceGraph();
+  HIP_RETURN((*deviceGraph != nullptr) ? hipSuccess : hipErrorInvalidValue);
+}
+
+hipError_t hipExtGraphAddConditionalNode(hipGraphNode_t* pGraphNode, hipGraph_t graph,
+                                         const hipGraphNode_t* pDependencies,
+                                         size_t numDependencies, hipGraph_t body,
+                                         unsigned int* predicate, int loop) {
+  HIP_INIT_API(hipExtGraphAddConditionalNode, pGraphNode, graph, pDependencies, numDependencies,
+               body, predicate, loop);
+  if (pGraphNode == nullptr || !hip::Graph::isGraphValid(reinterpret_cast<hip::Graph*>(graph)) ||
+      (numDependencies > 0 && pDependencies == nullptr) ||
+      !hip::Graph::isGraphValid(reinterpret_cast<hip::Graph*>(body)) || predicate == nullptr ||
+      graph == body) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  // The scheduler submits the body directly into a HW queue, which PAL doesn't expose
+  if (!hip::getCurrentDevice()->devices()[0]->settings().rocr_backend_) {
+    HIP_RETURN(hipErrorNotSupported);
+  }
+  hip::GraphNode* node = new (reinterpret_cast<hip::Graph*>(graph)->NodeArena())
+      hip::GraphConditionalNode(reinterpret_cast<hip::Graph*>(body), predicate, loop != 0);
+  hipError_t status = ihipGraphAddNode(node, reinterpret_cast<hip::Graph*>(graph),
+                                       reinterpret_cast<hip::GraphNode* const*>(pDependencies),
+                                       numDependencies, false);
+  *pGraphNode = reinterpret_cast<hipGraphNode_t>(node);
+  HIP_RETURN(status);
+}
+
 }  // namespace hip
@@ -19,7 +19,9 @@
  THE SOFTWARE. */
 
 #include "hip_graph_internal.hpp"
+#include <limits>
 #include <queue>
+#include <thread>
 
 #define CASE_STRING(X, C)                                                                          \
   case X:                                                                                          \
@@ -50,6 +52,9 @@ const char* GetGraphNodeTypeString(uint32_t op) {
 };
 }
 
+hipError_t ihipGraphInstantiate(hip::GraphExec** pGraphExec, hip::Graph* graph, uint64_t flags);
+hipError_t ihipGraphDebugDotPrint(hipGraph_t graph, const char* path, unsigned int flags);
+
 namespace hip {
 
 int GraphNode::nextID = 0;
@@ -69,6 +74,57 @@ amd::Monitor UserObject::UserObjectLock_{};
 // Guards mem map add/remove against work thread
 amd::Monitor GraphNode::WorkerThreadLock_{};
 
+// Header in front of every node, which keeps the arena pointer and the node alignment
+constexpr size_t kNodeHeaderSize = alignof(std::max_align_t);
+
+// ================================================================================================
+GraphNodeArena::~GraphNodeArena() {
+  for (auto chunk : chunks_) {
+    delete[] chunk;
+  }
+}
+
+// ================================================================================================
+void* GraphNodeArena::Allocate(size_t size) {
+  size = amd::alignUp(size, kNodeHeaderSize);
+  amd::ScopedLock lock(lock_);
+  // Large allocations get a dedicated chunk to avoid the waste in the current one
+  if (size > kChunkSize / 4) {
+    char* chunk = new char[size];
+    // Keep the current chunk at the end of the list for the next allocations
+    chunks_.insert(chunks_.end() - ((chunks_.empty()) ? 0 : 1), chunk);
+    return chunk;
+  }
+  if (offset_ + size > kChunkSize) {
+    chunks_.push_back(new char[kChunkSize]);
+    offset_ = 0;
+  }
+  char* mem = chunks_.back() + offset_;
+  offset_ += size;
+  return mem;
+}
+
+// ================================================================================================
+void* GraphNode::Allocate(size_t size, GraphNodeArena* arena) {
+  size += kNodeHeaderSize;
+  char* mem = (arena != nullptr) ? reinterpret_cast<char*>(arena->Allocate(size))
+                                 : reinterpret_cast<char*>(::operator new(size));
+  *reinterpret_cast<GraphNodeArena**>(mem) = arena;
+  return mem + kNodeHeaderSize;
+}
+
+// ================================================================================================
+void GraphNode::operator delete(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  char* mem = reinterpret_cast<char*>(ptr) - kNodeHeaderSize;
+  // The arena memory is released at once with the graph
+  if (*reinterpret_cast<GraphNodeArena**>(mem) == nullptr) {
+    ::operator delete(mem);
+  }
+}
+
 hipError_t GraphMemcpyNode1D::ValidateParams(void* dst, const void* src, size_t count,
                                                 hipMemcpyKind kind) {
   hipError_t status = ihipMemcpy_validate(dst, src, count, kind);
@@ -243,62 +299,130 @@ void Graph::GetRunList(std::vector<std::vector<Node>>& parallelLists,
 }
 
 // ================================================================================================
-void Graph::ScheduleOneNode(Node node, int stream_id) {
-  if (node->stream_id_ == -1) {
-    // Assign active stream to the current node
-    node->stream_id_ = stream_id;
-    max_streams_ = std::max(max_streams_, stream_id);
-
-    // Update the dependencies if a signal is required
-    for (auto dep: node->GetDependencies()) {
-      // Check if the stream ID doesn't match and enable signal
-      if (dep->stream_id_ != node->stream_id_) {
-        dep->signal_is_required_ |= true;
-      }
-    }
-    // Process child graph separately, since, there is no connection
-    if (node->GetType() == hipGraphNodeTypeGraph) {
-      auto child = reinterpret_cast<hip::ChildGraphNode*>(node)->childGraph_;
-      child->ScheduleNodes();
-      max_streams_ = std::max(max_streams_, child->max_streams_);
+bool Graph::GetCriticalPaths(std::vector<Node>& topoOrder,
+                             std::unordered_map<Node, uint64_t>& rank) {
+  if (!TopologicalOrder(topoOrder)) {
+    return false;
+  }
+  // The rank of a node is the estimated cost of the longest path from the node to a leaf
+  for (auto it = topoOrder.rbegin(); it != topoOrder.rend(); ++it) {
+    uint64_t tail = 0;
+    for (auto edge : (*it)->GetEdges()) {
+      tail = std::max(tail, rank[edge]);
     }
-    for (auto edge: node->GetEdges()) {
-      ScheduleOneNode(edge, stream_id);
-      // 1. Each extra edge will get a new stream from the pool
-      // 2. Streams will be reused if the number of edges > streams
-      stream_id = (stream_id + 1) % DEBUG_HIP_FORCE_GRAPH_QUEUES;
+    rank[*it] = (*it)->EstimatedCost() + tail;
+  }
+  return true;
+}
+
+// ================================================================================================
+uint64_t Graph::CriticalPathCost() {
+  std::vector<Node> topoOrder;
+  std::unordered_map<Node, uint64_t> rank;
+  uint64_t cost = 0;
+  if (GetCriticalPaths(topoOrder, rank)) {
+    for (auto& it : rank) {
+      cost = std::max(cost, it.second);
     }
   }
+  return cost;
 }
 
 // ================================================================================================
-void Graph::ScheduleNodes() {
+void Graph::ScheduleNodes(int32_t base_stream) {
   for (auto node : vertices_) {
     node->stream_id_ = -1;
     node->signal_is_required_ = false;
   }
   memset(&roots_[0], 0, sizeof(Node) * roots_.size());
   max_streams_ = 0;
-  // Start processing all nodes in the graph to find async executions.
-  int stream_id = 0;
-  for (auto node : vertices_) {
-    if (node->stream_id_ == -1) {
-      ScheduleOneNode(node, stream_id);
-      // Find the root nodes
-      if ((node->GetDependencies().size() == 0) && (node->stream_id_ != 0)) {
-        // Fill in only the first in the sequence
-        if (roots_[node->stream_id_] == nullptr) {
-          roots_[node->stream_id_] = node;
+  run_order_.clear();
+
+  std::vector<Node> topoOrder;
+  std::unordered_map<Node, uint64_t> rank;
+  if (!GetCriticalPaths(topoOrder, rank)) {
+    LogError("Graph scheduling failed, since the graph isn't acyclic!");
+    return;
+  }
+
+  // List scheduling: the ready node with the longest path to a leaf goes first, so the critical
+  // path doesn't queue up behind the filler work. Lower IDs win the ties to keep the order stable.
+  auto lower_priority = [&rank](Node a, Node b) {
+    return (rank[a] == rank[b]) ? (a->GetID() > b->GetID()) : (rank[a] < rank[b]);
+  };
+  std::priority_queue<Node, std::vector<Node>, decltype(lower_priority)> ready(lower_priority);
+  std::unordered_map<Node, size_t> pending;
+  for (auto node : topoOrder) {
+    pending[node] = node->GetDependencies().size();
+    if (pending[node] == 0) {
+      ready.push(node);
+    }
+  }
+
+  const uint32_t num_streams = DEBUG_HIP_FORCE_GRAPH_QUEUES;
+  std::vector<uint64_t> stream_end(num_streams, 0);  // Estimated end time of every stream
+  std::unordered_map<Node, uint64_t> node_end;        // Estimated end time of every node
+  while (!ready.empty()) {
+    Node node = ready.top();
+    ready.pop();
+
+    // Pick the stream with the earliest estimated start. A dependency on another stream
+    // costs an extra wait, hence the ties are resolved in favor of fewer cross stream waits.
+    // The streams are probed from the base stream, so a serial chain stays on it.
+    int32_t best_stream = base_stream;
+    uint64_t best_start = std::numeric_limits<uint64_t>::max();
+    uint32_t best_waits = std::numeric_limits<uint32_t>::max();
+    for (uint32_t i = 0; i < num_streams; ++i) {
+      const int32_t stream_id = (base_stream + i) % num_streams;
+      uint64_t start = stream_end[stream_id];
+      uint32_t waits = 0;
+      for (auto dep : node->GetDependencies()) {
+        uint64_t dep_end = node_end[dep];
+        if (dep->stream_id_ != stream_id) {
+          dep_end += kGraphStreamWaitCost;
+          waits++;
         }
+        start = std::max(start, dep_end);
+      }
+      if ((start < best_start) || ((start == best_start) && (waits < best_waits))) {
+        best_stream = stream_id;
+        best_start = start;
+        best_waits = waits;
+      }
+    }
+
+    // Assign the stream to the current node
+    node->stream_id_ = best_stream;
+    max_streams_ = std::max(max_streams_, best_stream);
+    node_end[node] = best_start + node->EstimatedCost();
+    stream_end[best_stream] = node_end[node];
+    run_order_.push_back(node);
+
+    // Update the dependencies if a signal is required
+    for (auto dep: node->GetDependencies()) {
+      // Check if the stream ID doesn't match and enable signal
+      if (dep->stream_id_ != node->stream_id_) {
+        dep->signal_is_required_ |= true;
+      }
+    }
+    // Find the root nodes. Fill in only the first in the sequence
+    if ((node->GetDependencies().size() == 0) && (roots_[best_stream] == nullptr)) {
+      roots_[best_stream] = node;
+    }
+    // Process child graph separately, since, there is no connection
+    if (node->GetType() == hipGraphNodeTypeGraph) {
+      auto child = reinterpret_cast<hip::ChildGraphNode*>(node)->childGraph_;
+      child->ScheduleNodes(best_stream);
+      max_streams_ = std::max(max_streams_, child->max_streams_);
+    }
+    for (auto edge : node->GetEdges()) {
+      if (--pending[edge] == 0) {
+        ready.push(edge);
       }
-      // 1. Each extra root will get a new stream from the pool
-      // 2. Streams will be recycled if the number of roots > streams
-      stream_id = (stream_id + 1) % DEBUG_HIP_FORCE_GRAPH_QUEUES;
     }
   }
 }
 
-// ================================================================================================
 bool Graph::TopologicalOrder(std::vector<Node>& TopoOrder) {
   std::queue<Node> q;
   std::unordered_map<Node, int> inDegree;
@@ -418,16 +542,156 @@ hipError_t GraphExec::Init() {
   if (status != hipSuccess) {
     return status;
   }
+  // Instantiate the bodies of conditional nodes upfront to report the errors early
+  for (auto& node : topoOrder_) {
+    if (node->GetType() == kGraphNodeTypeConditional) {
+      status = static_cast<GraphConditionalNode*>(node)->Instantiate();
+      if (status != hipSuccess) {
+        return status;
+      }
+    }
+  }
+  // Plan graph memory before the capture, because the planned nodes don't produce packets
+  PlanMemArena();
   if (DEBUG_CLR_GRAPH_PACKET_CAPTURE) {
     // For graph nodes capture AQL packets to dispatch them directly during graph launch.
     status = CaptureAQLPackets();
+    if (status == hipSuccess) {
+      status = CaptureKernelChains();
+    }
+    if ((status == hipSuccess) && (flags_ & hipGraphInstantiateFlagDeviceLaunch)) {
+      status = BuildDeviceGraph();
+    }
   }
   instantiateDeviceId_ = hip::getCurrentDevice()->deviceId();
   return status;
 }
 
+// ================================================================================================
+void GraphExec::PlanMemArena() {
+  // Auto free on launch releases all graph memory, hence the arena can't persist
+  if (!HIP_MEM_POOL_USE_VM || !HIP_MEM_POOL_GRAPH_ARENA ||
+      (flags_ & hipGraphInstantiateFlagAutoFreeOnLaunch)) {
+    return;
+  }
+  struct Block {
+    GraphMemAllocNode* alloc_;        // Node, which allocates memory
+    GraphMemFreeNode* free_;          // Node, which frees memory
+    size_t size_;                     // Size of the VA mapping
+    size_t offset_;                   // Offset in the arena
+    std::unordered_set<Node> after_;  // Nodes, which run after the free node
+  };
+  std::vector<Block> blocks;
+  std::unordered_map<void*, size_t> ptrToBlock;
+  for (auto node : topoOrder_) {
+    if (node->GetType() == hipGraphNodeTypeMemAlloc) {
+      auto alloc = static_cast<GraphMemAllocNode*>(node);
+      hipMemAllocNodeParams params;
+      alloc->GetParams(&params);
+      ptrToBlock[params.dptr] = blocks.size();
+      blocks.push_back({alloc, nullptr, alloc->MappedSize(), 0, {}});
+    } else if (node->GetType() == hipGraphNodeTypeMemFree) {
+      void* ptr = nullptr;
+      static_cast<GraphMemFreeNode*>(node)->GetParams(&ptr);
+      auto it = ptrToBlock.find(ptr);
+      if (it != ptrToBlock.end()) {
+        blocks[it->second].free_ = static_cast<GraphMemFreeNode*>(node);
+      }
+    }
+  }
+  // Memory, freed outside of the graph, may outlive the launch and keeps the mapping per launch
+  blocks.erase(std::remove_if(blocks.begin(), blocks.end(),
+                              [](const Block& block) { return block.free_ == nullptr; }),
+               blocks.end());
+  if (blocks.empty()) {
+    return;
+  }
+
+  size_t arenaSize = 0;
+  size_t totalSize = 0;
+  std::vector<std::pair<size_t, size_t>> live;
+  // Blocks follow the topological order of the allocations
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    auto& block = blocks[i];
+    // Find all nodes, which depend on the free node
+    std::vector<Node> stack(1, block.free_);
+    while (!stack.empty()) {
+      Node node = stack.back();
+      stack.pop_back();
+      for (auto edge : node->GetEdges()) {
+        if (block.after_.insert(edge).second) {
+          stack.push_back(edge);
+        }
+      }
+    }
+    // The earlier allocation is live, unless its free node runs before the current allocation
+    live.clear();
+    for (size_t j = 0; j < i; ++j) {
+      if (blocks[j].after_.find(block.alloc_) == blocks[j].after_.end()) {
+        live.push_back({blocks[j].offset_, blocks[j].offset_ + blocks[j].size_});
+      }
+    }
+    // First fit between the live ranges
+    std::sort(live.begin(), live.end());
+    size_t offset = 0;
+    for (const auto& range : live) {
+      if ((offset + block.size_) <= range.first) {
+        break;
+      }
+      offset = std::max(offset, range.second);
+    }
+    block.offset_ = offset;
+    arenaSize = std::max(arenaSize, offset + block.size_);
+    totalSize += block.size_;
+  }
+
+  hip::Stream* stream = hip::getCurrentDevice()->NullStream();
+  memArena_ = clonedGraph_->AllocateMemory(arenaSize, stream, nullptr);
+  if (memArena_ == nullptr) {
+    return;
+  }
+  size_t offset = 0;
+  amd::Memory* arena = getMemoryObject(memArena_, offset);
+  for (auto& block : blocks) {
+    if (!block.alloc_->MapArena(arena, block.offset_, stream)) {
+      // Fall back to the mapping on every launch
+      ReleaseMemArena();
+      return;
+    }
+    block.free_->SetArenaBacked(true);
+    arenaNodes_.push_back(block.alloc_);
+    arenaNodes_.push_back(block.free_);
+  }
+  ClPrint(amd::LOG_INFO, amd::LOG_MEM_POOL,
+          "Graph memory arena %p: %zu allocations, %zu bytes, %zu bytes without reuse",
+          memArena_, blocks.size(), arenaSize, totalSize);
+}
+
+// ================================================================================================
+void GraphExec::ReleaseMemArena() {
+  if (memArena_ == nullptr) {
+    return;
+  }
+  size_t offset = 0;
+  amd::Memory* arena = getMemoryObject(memArena_, offset);
+  hip::Stream* stream = g_devices[arena->getUserData().deviceId]->NullStream();
+  for (auto node : arenaNodes_) {
+    if (node->GetType() == hipGraphNodeTypeMemAlloc) {
+      static_cast<GraphMemAllocNode*>(node)->UnmapArena(stream);
+    } else {
+      static_cast<GraphMemFreeNode*>(node)->SetArenaBacked(false);
+    }
+  }
+  arenaNodes_.clear();
+  // All VAs are unmapped, so the pool won't unmap anything on free
+  clonedGraph_->FreeMemory(memArena_, stream);
+  memArena_ = nullptr;
+}
+
 //! Chunk size to add to kern arg pool
 constexpr uint32_t kKernArgChunkSize = 128 * Ki;
+//! Size of a captured AQL packet
+constexpr size_t kAqlPacketSize = 64;
 // ================================================================================================
 void GetKernelArgSizeForGraph(std::vector<std::vector<Node>>& parallelLists,
                               size_t& kernArgSizeForGraph) {
@@ -449,9 +713,10 @@ void GetKernelArgSizeForGraph(std::vector<std::vector<Node>>& parallelLists,
 }
 
 // ================================================================================================
-hipError_t AllocKernelArgForGraphNode(std::vector<hip::Node>& topoOrder,
-                                      hip::Stream* capture_stream, hip::GraphExec* graphExec) {
-  hipError_t status = hipSuccess;
+// Collects the nodes with captured packets, including the nodes of single list child graphs, in
+// the order of the capture
+void GetCaptureNodes(std::vector<hip::Node>& topoOrder, hip::GraphExec* graphExec,
+                     std::vector<hip::Node>& captureNodes) {
   for (auto& node : topoOrder) {
     if (node->GetType() == hipGraphNodeTypeKernel) {
       // Check if graph requires hidden heap and set as part of graphExec param.
@@ -462,22 +727,73 @@ hipError_t AllocKernelArgForGraphNode(std::vector<hip::Node>& topoOrder,
       }
     }
     if (node->GraphCaptureEnabled()) {
-      node->CaptureAndFormPacket(capture_stream, graphExec->GetKernelArgManager());
+      captureNodes.push_back(node);
     } else if (node->GetType() == hipGraphNodeTypeGraph) {
       auto childNode = reinterpret_cast<hip::ChildGraphNode*>(node);
       auto& childParallelLists = childNode->GetParallelLists();
       if (childParallelLists.size() == 1) {
         childNode->SetGraphCaptureStatus(true);
-        status =
-            AllocKernelArgForGraphNode(childNode->GetChildGraphNodeOrder(),
-                                       capture_stream, graphExec);
-        if (status != hipSuccess) {
-          return status;
-        }
+        GetCaptureNodes(childNode->GetChildGraphNodeOrder(), graphExec, captureNodes);
       }
     }
   }
-  return status;
+}
+
+//! Minimum number of captured nodes per worker thread of the instantiation
+constexpr size_t kMinCaptureNodesPerWorker = 256;
+// ================================================================================================
+// Creates the commands of the captured nodes on worker threads. Each worker takes a contiguous
+// range of nodes. The packets and kernel args are still formed in the capture order afterwards,
+// so the result doesn't depend on the number of workers.
+void PrepareCaptureNodes(std::vector<hip::Node>& captureNodes, hip::Stream* capture_stream) {
+  const size_t numWorkers = std::min<size_t>(DEBUG_HIP_GRAPH_INSTANTIATE_THREADS,
+                                             captureNodes.size() / kMinCaptureNodesPerWorker);
+  if (numWorkers <= 1) {
+    return;
+  }
+  const int deviceId = capture_stream->DeviceId();
+  auto prepare = [&captureNodes, capture_stream, deviceId](size_t begin, size_t end) {
+    // The worker must have a runtime thread for the locks and the HIP device for validation
+    amd::Thread* thread = amd::Thread::current();
+    const bool hostThread = (thread == nullptr);
+    if (hostThread && (((thread = new amd::HostThread()) == nullptr) ||
+                       (thread != amd::Thread::current()))) {
+      // Nodes without prepared commands are created during the capture
+      return;
+    }
+    hip::setCurrentDevice(deviceId);
+    for (size_t i = begin; i < end; ++i) {
+      captureNodes[i]->PrepareCapture(capture_stream);
+    }
+    if (hostThread) {
+      delete thread;
+    }
+  };
+  std::vector<std::thread> workers;
+  workers.reserve(numWorkers - 1);
+  const size_t chunk = (captureNodes.size() + numWorkers - 1) / numWorkers;
+  for (size_t w = 1; w < numWorkers; ++w) {
+    workers.emplace_back(prepare, w * chunk, std::min(captureNodes.size(), (w + 1) * chunk));
+  }
+  // The instantiating thread takes the first range
+  prepare(0, chunk);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  ClPrint(amd::LOG_INFO, amd::LOG_CODE, "[hipGraph] Prepared %zu captured nodes on %zu threads",
+          captureNodes.size(), numWorkers);
+}
+
+// ================================================================================================
+hipError_t AllocKernelArgForGraphNode(std::vector<hip::Node>& topoOrder,
+                                      hip::Stream* capture_stream, hip::GraphExec* graphExec) {
+  std::vector<hip::Node> captureNodes;
+  GetCaptureNodes(topoOrder, graphExec, captureNodes);
+  PrepareCaptureNodes(captureNodes, capture_stream);
+  for (auto node : captureNodes) {
+    node->CaptureAndFormPacket(capture_stream, graphExec->GetKernelArgManager());
+  }
+  return hipSuccess;
 }
 
 // ================================================================================================
@@ -503,14 +819,178 @@ hipError_t GraphExec::CaptureAQLPackets() {
 }
 
 // ================================================================================================
-hipError_t GraphExec::UpdateAQLPacket(hip::GraphNode* node) {
-  hipError_t status = hipSuccess;
-  if (parallelLists_.size() == 1) {
+hipError_t GraphExec::BuildDeviceGraph() {
+  // Device launch replays the packets in the topological order on the queue of the caller,
+  // hence every node must be captured
+  if (parallelLists_.size() != 1) {
+    LogError("Device launch requires a graph with a single list of nodes");
+    return hipErrorNotSupported;
+  }
+  uint32_t packetCount = 0;
+  for (auto node : topoOrder_) {
+    if (node->GraphCaptureEnabled()) {
+      if (node->GetEnabled()) {
+        packetCount += node->GetAqlPackets().size();
+      }
+    } else if (node->GetType() != hipGraphNodeTypeEmpty) {
+      // Empty nodes have no work and the order is kept with the barrier bit in the packets
+      LogPrintfError("Device launch doesn't support graph node type %d", node->GetType());
+      return hipErrorNotSupported;
+    }
+  }
+  const size_t size = sizeof(GraphDeviceLaunch) + packetCount * kAqlPacketSize;
+  if (size > deviceGraphSize_) {
+    auto device = g_devices[ihipGetDevice()]->devices()[0];
+    auto mem = reinterpret_cast<GraphDeviceLaunch*>(
+        device->hostAlloc(size, kAqlPacketSize));
+    if (mem == nullptr) {
+      return hipErrorOutOfMemory;
+    }
+    if (deviceGraph_ != nullptr) {
+      deviceGraphDev_->hostFree(deviceGraph_, deviceGraphSize_);
+    }
+    deviceGraph_ = mem;
+    deviceGraphSize_ = size;
+    deviceGraphDev_ = device;
+  }
+  deviceGraph_->packetCount_ = packetCount;
+  auto dst = reinterpret_cast<uint8_t*>(deviceGraph_ + 1);
+  for (auto node : topoOrder_) {
+    if (node->GraphCaptureEnabled() && node->GetEnabled()) {
+      for (auto packet : node->GetAqlPackets()) {
+        std::memcpy(dst, packet, kAqlPacketSize);
+        // Host launches may leave a profiling signal in the packet, hence clear the completion
+        // signal in the last 8 bytes of the dispatch and barrier packets
+        std::memset(dst + kAqlPacketSize - sizeof(uint64_t), 0, sizeof(uint64_t));
+        dst += kAqlPacketSize;
+      }
+    }
+  }
+  return hipSuccess;
+}
+
+// ================================================================================================
+hipError_t GraphExec::CaptureKernelChains() {
+  // The packets are dispatched from the launch thread, hence direct dispatch is required
+  if (!DEBUG_HIP_GRAPH_FUSE_KERNELS || !AMD_DIRECT_DISPATCH || (parallelLists_.size() == 1) ||
+      (DEBUG_HIP_FORCE_GRAPH_QUEUES == 0)) {
+    return hipSuccess;
+  }
+  auto nodes = clonedGraph_->FuseKernelChains();
+  if (nodes.empty()) {
+    return hipSuccess;
+  }
+  size_t kernArgSize = 0;
+  for (auto node : nodes) {
+    kernArgSize += node->GetKerArgSize();
+  }
+  if (!kernArgManager_->AllocGraphKernargPool(kernArgSize + kKernArgChunkSize)) {
+    return hipErrorMemoryAllocation;
+  }
+  for (auto node : nodes) {
     node->CaptureAndFormPacket(capture_stream_, kernArgManager_);
   }
+  kernArgManager_->ReadBackOrFlush();
+  ClPrint(amd::LOG_INFO, amd::LOG_CODE, "[hipGraph] Fused %zu kernel nodes into chains",
+          nodes.size());
   return hipSuccess;
 }
 
+// ================================================================================================
+// Copies the bytes of src, which differ from the shadow copy, into dst and updates the shadow.
+// The compare runs on 8 byte words and the adjacent changed words are written with one copy.
+static void CopyChangedBytes(address dst, uint8_t* shadow, const uint8_t* src, size_t size) {
+  constexpr size_t kWord = sizeof(uint64_t);
+  auto changed = [&](size_t pos) {
+    return std::memcmp(shadow + pos, src + pos, std::min(kWord, size - pos)) != 0;
+  };
+  size_t pos = 0;
+  while (pos < size) {
+    if (!changed(pos)) {
+      pos += kWord;
+      continue;
+    }
+    const size_t start = pos;
+    while ((pos < size) && changed(pos)) {
+      pos += kWord;
+    }
+    const size_t end = std::min(pos, size);
+    std::memcpy(dst + start, src + start, end - start);
+    std::memcpy(shadow + start, src + start, end - start);
+  }
+}
+
+// ================================================================================================
+void GraphNode::CaptureAndFormPacket(hip::Stream* capture_stream,
+                                     GraphKernelArgManager* kernArgMgr, bool update) {
+  std::vector<uint8_t*> packets;
+  // Capture the kernel args into host memory first, so an update can be diffed against the
+  // current args before the kernarg pool is touched
+  kernArgMgr->BeginStaging(update ? &capturedKernArgs_ : nullptr);
+  if (!capturePrepared_) {
+    hipError_t status = CreateCommand(capture_stream);
+  }
+  capturePrepared_ = false;
+  for (auto& command : commands_) {
+    command->setPktCapturingState(true, &packets, kernArgMgr, &capturedKernelName_);
+    // Enqueue command to capture GPU Packet. The packet is not submitted to the device.
+    // The packet is stored in gpuPacket_ and submitted during graph launch.
+    command->submit(*(command->queue())->vdev());
+    command->release();
+  }
+  // Commands are captured and released. Clear them from the object.
+  commands_.clear();
+  auto& staged = kernArgMgr->EndStaging();
+
+  // Write the args into the pool. The reused locations get only the changed bytes.
+  std::vector<GraphKernelArgManager::CapturedKernArg> kernArgs;
+  kernArgs.reserve(staged.size());
+  for (size_t i = 0; i < staged.size(); ++i) {
+    if (staged[i].reused_) {
+      kernArgs.push_back(std::move(capturedKernArgs_[i]));
+      CopyChangedBytes(kernArgs.back().addr_, kernArgs.back().shadow_.data(), staged[i].host_,
+                       staged[i].size_);
+    } else {
+      const auto& arg = staged[i];
+      std::memcpy(arg.addr_, arg.host_, arg.size_);
+      kernArgs.push_back({arg.addr_, std::vector<uint8_t>(arg.host_, arg.host_ + arg.size_)});
+    }
+  }
+  capturedKernArgs_ = std::move(kernArgs);
+  staged.clear();
+
+  if (update && (packets.size() == gpuPackets_.size())) {
+    // Keep the packets storage and rewrite only the changed packets
+    for (size_t i = 0; i < packets.size(); ++i) {
+      if (std::memcmp(gpuPackets_[i], packets[i], kAqlPacketSize) != 0) {
+        std::memcpy(gpuPackets_[i], packets[i], kAqlPacketSize);
+      }
+      delete[] packets[i];
+    }
+  } else {
+    for (auto packet : gpuPackets_) {
+      delete[] packet;
+    }
+    gpuPackets_ = std::move(packets);
+  }
+}
+
+// ================================================================================================
+hipError_t GraphExec::UpdateAQLPacket(hip::GraphNode* node) {
+  hipError_t status = hipSuccess;
+  if ((parallelLists_.size() == 1) || clonedGraph_->IsFusedNode(node)) {
+    // Launches in flight still read the current args and packets, hence patch them in place
+    // only when the graph is idle
+    node->CaptureAndFormPacket(capture_stream_, kernArgManager_, launchesInFlight_ == 0);
+    kernArgManager_->ReadBackOrFlush();
+    if (deviceGraph_ != nullptr) {
+      // Refresh the packets of the device graph
+      status = BuildDeviceGraph();
+    }
+  }
+  return status;
+}
+
 hipError_t FillCommands(std::vector<std::vector<Node>>& parallelLists,
                         std::unordered_map<Node, std::vector<Node>>& nodeWaitLists,
                         std::vector<Node>& topoOrder, Graph* clonedGraph,
@@ -601,6 +1081,7 @@ void UpdateStream(std::vector<std::vector<Node>>& parallelLists, hip::Stream* st
 
 void GraphExec::DecrementRefCount(cl_event event, cl_int command_exec_status, void* user_data) {
   GraphExec* graphExec = reinterpret_cast<GraphExec*>(user_data);
+  --graphExec->launchesInFlight_;
   graphExec->release();
 }
 
@@ -608,12 +1089,21 @@ void GraphExec::DecrementRefCount(cl_event event, cl_int command_exec_status, vo
 
 hipError_t EnqueueGraphWithSingleList(std::vector<hip::Node>& topoOrder, hip::Stream* hip_stream,
                                       hip::GraphExec* graphExec) {
-  // Accumulate command tracks all the AQL packet batch that we submit to the HW. For now
-  // we track only kernel nodes.
+  // Accumulate command tracks all the AQL packet batch that we submit to the HW. It covers
+  // the kernel nodes and the memcpy/memset nodes, lowered to blit kernel packets.
   amd::AccumulateCommand* accumulate = nullptr;
   hipError_t status = hipSuccess;
+  GraphNodeTimes* nodeTimes = ((graphExec != nullptr) && graphExec->NodeTiming()) ?
+      &graphExec->NodeTimes() : nullptr;
+  uint32_t numPackets = 0;
   if (DEBUG_CLR_GRAPH_PACKET_CAPTURE) {
     accumulate = new amd::AccumulateCommand(*hip_stream, {}, nullptr);
+    if (nodeTimes != nullptr) {
+      // Every dispatched packet gets a profiling signal with the start and end times
+      accumulate->SetProfiling();
+    }
+    // Publish the whole packet stream of the graph with a single doorbell write
+    hip_stream->vdev()->BeginDoorbellBatch();
   }
   for (int i = 0; i < topoOrder.size(); i++) {
     if (topoOrder[i]->GraphCaptureEnabled()) {
@@ -622,10 +1112,17 @@ hipError_t EnqueueGraphWithSingleList(std::vector<hip::Node>& topoOrder, hip::St
         for (auto& packet : gpuPackets) {
           hip_stream->vdev()->dispatchAqlPacket(packet, topoOrder[i]->GetKernelName(), accumulate);
         }
+        if ((nodeTimes != nullptr) && !gpuPackets.empty()) {
+          nodeTimes->AddPackets(topoOrder[i], accumulate, numPackets, gpuPackets.size());
+          numPackets += gpuPackets.size();
+        }
       }
     } else {
       topoOrder[i]->SetStream(hip_stream, graphExec);
       status = topoOrder[i]->CreateCommand(topoOrder[i]->GetQueue());
+      if ((nodeTimes != nullptr) && (topoOrder[i]->GetType() != hipGraphNodeTypeGraph)) {
+        nodeTimes->AddCommands(topoOrder[i]);
+      }
       topoOrder[i]->EnqueueCommands(hip_stream);
     }
   }
@@ -633,6 +1130,7 @@ hipError_t EnqueueGraphWithSingleList(std::vector<hip::Node>& topoOrder, hip::St
   if (DEBUG_CLR_GRAPH_PACKET_CAPTURE) {
     accumulate->enqueue();
     accumulate->release();
+    hip_stream->vdev()->EndDoorbellBatch();
   }
   return status;
 }
@@ -653,92 +1151,156 @@ void Graph::UpdateStreams(
 }
 
 // ================================================================================================
-bool Graph::RunOneNode(Node node, bool wait) {
-  if (node->launch_id_ == -1) {
-    // Clear the storage of the wait nodes
-    memset(&wait_order_[0], 0, sizeof(Node) * wait_order_.size());
-    amd::Command::EventWaitList waitList;
-    // Walk through dependencies and find the last launches on each parallel stream
-    for (auto depNode : node->GetDependencies()) {
-      // Process only the nodes that have been submitted
-      if (depNode->launch_id_ != -1) {
-        // If it's the same stream then skip the signal, since it's in order
-        if (depNode->stream_id_ != node->stream_id_) {
-          // If there is no wait node on the stream, then assign one
-          if ((wait_order_[depNode->stream_id_] == nullptr) ||
-          // If another node executed on the same stream, then use the latest launch only,
-          // since the same stream has in-order run
-              (wait_order_[depNode->stream_id_]->launch_id_ < depNode->launch_id_)) {
-            wait_order_[depNode->stream_id_] = depNode;
-          }
-        }
-      } else {
-        // It should be a safe return,
-        // since the last edge to this dependency has to submit the command
-        return true;
+bool Graph::RunOneNode(Node node) {
+  const bool fused = use_fused_chains_ && (node->fused_chain_ >= 0);
+  if (fused && (fused_chains_[node->fused_chain_].front() != node)) {
+    // The node was launched with the head of its chain
+    return true;
+  }
+  // Clear the storage of the wait nodes
+  memset(&wait_order_[0], 0, sizeof(Node) * wait_order_.size());
+  amd::Command::EventWaitList waitList;
+  // Walk through dependencies and find the last launches on each parallel stream.
+  // The run order is topological, hence all dependencies have been submitted.
+  for (auto depNode : node->GetDependencies()) {
+    // If it's the same stream then skip the signal, since it's in order
+    if (depNode->stream_id_ != node->stream_id_) {
+      // If there is no wait node on the stream, then assign one
+      if ((wait_order_[depNode->stream_id_] == nullptr) ||
+      // If another node executed on the same stream, then use the latest launch only,
+      // since the same stream has in-order run
+          (wait_order_[depNode->stream_id_]->launch_id_ < depNode->launch_id_)) {
+        wait_order_[depNode->stream_id_] = depNode;
       }
     }
+  }
 
-    // Create a wait list from the last launches of all dependencies
-    for (auto dep : wait_order_) {
-      if (dep != nullptr) {
-        // Add all commands in the wait list
-        if (dep->GetType() != hipGraphNodeTypeGraph) {
-          for (auto command : dep->GetCommands()) {
-            waitList.push_back(command);
-          }
+  // Create a wait list from the last launches of all dependencies
+  for (auto dep : wait_order_) {
+    if (dep != nullptr) {
+      // Add all commands in the wait list
+      if (dep->GetType() != hipGraphNodeTypeGraph) {
+        for (auto command : dep->GetCommands()) {
+          waitList.push_back(command);
         }
       }
     }
-    if (node->GetType() == hipGraphNodeTypeGraph) {
-      // Process child graph separately, since, there is no connection
-      auto child = reinterpret_cast<hip::ChildGraphNode*>(node)->childGraph_;
-      if (!reinterpret_cast<hip::ChildGraphNode*>(node)->graphCaptureStatus_) {
-        child->RunNodes(node->stream_id_, &streams_, &waitList);
-      }
-    } else {
-      // Assing a stream to the current node
-      node->SetStream(streams_);
-      // Create the execution commands on the assigned stream
-      auto status = node->CreateCommand(node->GetQueue());
-      if (status != hipSuccess) {
-        LogPrintfError("Command creation for node id(%d) failed!", current_id_ + 1);
-        return false;
-      }
-      // Retain all commands, since potentially the command can finish before a wait signal
-      for (auto command : node->GetCommands()) {
-        command->retain();
-      }
+  }
+  if (fused) {
+    // The chain assigns the launch IDs of all nodes
+    RunKernelChain(fused_chains_[node->fused_chain_], waitList);
+    return true;
+  } else if (node->GetType() == hipGraphNodeTypeGraph) {
+    // Process child graph separately, since, there is no connection
+    auto child = reinterpret_cast<hip::ChildGraphNode*>(node)->childGraph_;
+    if (!reinterpret_cast<hip::ChildGraphNode*>(node)->graphCaptureStatus_) {
+      child->RunNodes(node->stream_id_, &streams_, &waitList);
+    }
+  } else {
+    // Assing a stream to the current node
+    node->SetStream(streams_);
+    // Create the execution commands on the assigned stream
+    auto status = node->CreateCommand(node->GetQueue());
+    if (status != hipSuccess) {
+      LogPrintfError("Command creation for node id(%d) failed!", current_id_ + 1);
+      return false;
+    }
+    // Retain all commands, since potentially the command can finish before a wait signal
+    for (auto command : node->GetCommands()) {
+      command->retain();
+    }
+    if (node_times_ != nullptr) {
+      node_times_->AddCommands(node);
+    }
 
-      // If a wait was requested, then process the list
-      if (wait && !waitList.empty()) {
-        node->UpdateEventWaitLists(waitList);
+    // If a wait was requested, then process the list
+    if (!waitList.empty()) {
+      node->UpdateEventWaitLists(waitList);
+    }
+    // Start the execution
+    node->EnqueueCommands(node->GetQueue());
+    // The last node on the stream is used for the final wait, since the stream is in order
+    leafs_[node->stream_id_] = node;
+  }
+  // Assign the launch ID of the submmitted node
+  node->launch_id_ = current_id_++;
+  return true;
+}
+
+// ================================================================================================
+void Graph::RunKernelChain(const std::vector<Node>& chain,
+                           const amd::Command::EventWaitList& waitList) {
+  hip::Stream* stream = streams_[chain.front()->stream_id_];
+  if (!waitList.empty()) {
+    // Only the chain head can have dependencies on other streams
+    auto marker = new amd::Marker(*stream, true, waitList);
+    marker->enqueue();
+    marker->release();
+  }
+  // The packets execute in order with the barrier bit, so a single completion covers the chain
+  auto accumulate = new amd::AccumulateCommand(*stream, {}, nullptr);
+  if (node_times_ != nullptr) {
+    accumulate->SetProfiling();
+  }
+  uint32_t numPackets = 0;
+  stream->vdev()->BeginDoorbellBatch();
+  for (auto node : chain) {
+    node->SetStream(streams_);
+    // Drop the commands of a previous launch without the fused chains
+    node->commands_.clear();
+    if (node->GetEnabled()) {
+      for (auto& packet : node->GetAqlPackets()) {
+        stream->vdev()->dispatchAqlPacket(packet, node->GetKernelName(), accumulate);
+      }
+      if ((node_times_ != nullptr) && !node->GetAqlPackets().empty()) {
+        node_times_->AddPackets(node, accumulate, numPackets, node->GetAqlPackets().size());
+        numPackets += node->GetAqlPackets().size();
       }
-      // Start the execution
-      node->EnqueueCommands(node->GetQueue());
     }
-    // Assign the launch ID of the submmitted node
-    // This is also applied to childGraphs to prevent them from being reprocessed
     node->launch_id_ = current_id_++;
-    uint32_t i = 0;
-    // Execute the nodes in the edges list
-    for (auto edge: node->GetEdges()) {
-      // Don't wait in the nodes, executed on the same streams and if it has just one dependency
-      bool wait = ((i < DEBUG_HIP_FORCE_GRAPH_QUEUES) ||
-                   (edge->GetDependencies().size() > 1)) ? true : false;
-      // Execute the edge node
-      if (!RunOneNode(edge, wait)) {
-        return false;
-      }
-      i++;
+  }
+  accumulate->enqueue();
+  stream->vdev()->EndDoorbellBatch();
+  // Dependencies on other streams wait for the tail, which holds the command until the launch
+  // releases all node commands
+  Node tail = chain.back();
+  tail->commands_.push_back(accumulate);
+  leafs_[tail->stream_id_] = tail;
+}
+
+// ================================================================================================
+std::vector<Node> Graph::FuseKernelChains() {
+  auto fusable = [](Node node) {
+    // Hidden heap requires the initialization on the launch stream
+    return (node->GetType() == hipGraphNodeTypeKernel) && node->GraphCaptureEnabled() &&
+           !reinterpret_cast<hip::GraphKernelNode*>(node)->HasHiddenHeap();
+  };
+  fused_chains_.clear();
+  for (auto node : run_order_) {
+    node->fused_chain_ = -1;
+    if (!fusable(node) || (node->GetDependencies().size() != 1)) {
+      continue;
     }
-    if (i == 0) {
-      // Add a leaf node into the list for a wait.
-      // Always use the last node, since it's the latest for the particular queue
-      leafs_[node->stream_id_] = node;
+    // The only dependency must be a kernel on the same stream without other dependents,
+    // so the in-order execution of the stream covers the edge
+    Node prev = node->GetDependencies()[0];
+    if (!fusable(prev) || (prev->GetEdges().size() != 1) ||
+        (prev->stream_id_ != node->stream_id_)) {
+      continue;
+    }
+    // The run order is topological, hence the previous node was already processed
+    if (prev->fused_chain_ < 0) {
+      prev->fused_chain_ = static_cast<int32_t>(fused_chains_.size());
+      fused_chains_.push_back({prev});
     }
+    node->fused_chain_ = prev->fused_chain_;
+    fused_chains_[node->fused_chain_].push_back(node);
   }
-  return true;
+  std::vector<Node> nodes;
+  for (const auto& chain : fused_chains_) {
+    nodes.insert(nodes.end(), chain.begin(), chain.end());
+  }
+  return nodes;
 }
 
 // ================================================================================================
@@ -783,12 +1345,10 @@ bool Graph::RunNodes(
     last_command->release();
   }
 
-  // Run all commands in the graph
-  for (auto node : vertices_) {
-    if (node->launch_id_ == -1) {
-      if (!RunOneNode(node, true)) {
-        return false;
-      }
+  // Run all commands in the graph in the scheduled order
+  for (auto node : run_order_) {
+    if (!RunOneNode(node)) {
+      return false;
     }
   }
   wait_list.clear();
@@ -828,6 +1388,8 @@ hipError_t GraphExec::Run(hipStream_t graph_launch_stream) {
   hipError_t status = hipSuccess;
 
   hip::Stream* launch_stream = hip::getStream(graph_launch_stream);
+  // Drop the times of the previous launch
+  nodeTimes_.Clear();
 
   if (flags_ & hipGraphInstantiateFlagAutoFreeOnLaunch) {
     if (!topoOrder_.empty()) {
@@ -865,6 +1427,9 @@ hipError_t GraphExec::Run(hipStream_t graph_launch_stream) {
     for (int i = 0; i < topoOrder_.size(); i++) {
       topoOrder_[i]->SetStream(launch_stream, this);
       status = topoOrder_[i]->CreateCommand(topoOrder_[i]->GetQueue());
+      if (nodeTiming_ && (topoOrder_[i]->GetType() != hipGraphNodeTypeGraph)) {
+        nodeTimes_.AddCommands(topoOrder_[i]);
+      }
       topoOrder_[i]->EnqueueCommands(launch_stream);
     }
   } else {
@@ -891,6 +1456,9 @@ hipError_t GraphExec::Run(hipStream_t graph_launch_stream) {
     } else {
       // Update streams for the graph execution
       clonedGraph_->UpdateStreams(launch_stream, parallel_streams_);
+      // The captured packets of the fused chains are valid on the instantiation device only
+      clonedGraph_->EnableFusedChains(instantiateDeviceId_ == launch_stream->DeviceId());
+      clonedGraph_->SetNodeTimes(nodeTiming_ ? &nodeTimes_ : nullptr);
       // Execute all nodes in the graph
       if (!clonedGraph_->RunNodes()) {
         LogError("Failed to launch nodes!");
@@ -898,6 +1466,7 @@ hipError_t GraphExec::Run(hipStream_t graph_launch_stream) {
       }
     }
   }
+  ++launchesInFlight_;
   this->retain();
   amd::Command* CallbackCommand = new amd::Marker(*launch_stream, kMarkerDisableFlush, {});
   // we may not need to flush any caches.
@@ -923,6 +1492,115 @@ hipError_t GraphExec::Run(hipStream_t graph_launch_stream) {
   return status;
 }
 
+// ================================================================================================
+void GraphNodeTimes::AddCommands(Node node) {
+  for (auto command : node->GetCommands()) {
+    command->SetProfiling();
+    command->retain();
+    records_.push_back({node, command, 0, 0});
+  }
+}
+
+// ================================================================================================
+hipError_t GraphNodeTimes::Get(Node node, uint64_t* start, uint64_t* end) const {
+  uint64_t startNs = std::numeric_limits<uint64_t>::max();
+  uint64_t endNs = 0;
+  bool found = false;
+  for (const auto& record : records_) {
+    if (record.node_ != node) {
+      continue;
+    }
+    const int32_t status = record.command_->status();
+    if (status < 0) {
+      return hipErrorLaunchFailure;
+    } else if (status != CL_COMPLETE) {
+      return hipErrorNotReady;
+    }
+    found = true;
+    if (record.count_ != 0) {
+      // The accumulate command keeps the times of every packet in the dispatch order
+      const auto& timestamps =
+          static_cast<amd::AccumulateCommand*>(record.command_)->getTimestamps();
+      if ((record.first_ + record.count_) <= timestamps.size()) {
+        for (uint32_t i = record.first_; i < (record.first_ + record.count_); ++i) {
+          startNs = std::min(startNs, timestamps[i].first);
+          endNs = std::max(endNs, timestamps[i].second);
+        }
+        continue;
+      }
+    }
+    startNs = std::min(startNs, record.command_->profilingInfo().start_);
+    endNs = std::max(endNs, record.command_->profilingInfo().end_);
+  }
+  if (!found) {
+    // The node wasn't executed in the last launch, or it runs inside another command
+    return hipErrorInvalidValue;
+  }
+  *start = startNs;
+  *end = endNs;
+  return hipSuccess;
+}
+
+// ================================================================================================
+void GraphExec::DumpTimedDOT() {
+  if (!nodeTiming_ || nodeTimes_.Empty()) {
+    return;
+  }
+  nodeTimes_.Wait();
+  std::unordered_map<Node, std::pair<uint64_t, uint64_t>> times;
+  uint64_t launchStart = std::numeric_limits<uint64_t>::max();
+  Node last = nullptr;
+  for (auto node : topoOrder_) {
+    uint64_t start = 0;
+    uint64_t end = 0;
+    if (nodeTimes_.Get(node, &start, &end) != hipSuccess) {
+      // Child graphs and the nodes inside other commands don't have own times
+      continue;
+    }
+    times[node] = {start, end};
+    launchStart = std::min(launchStart, start);
+    if ((last == nullptr) || (end > times[last].second)) {
+      last = node;
+    }
+  }
+  if (last == nullptr) {
+    return;
+  }
+  // Walk back from the last finished node through the dependency, which finished last.
+  // That chain delayed the launch completion, hence it's the measured critical path
+  std::unordered_set<Node> critical;
+  for (Node node = last; node != nullptr;) {
+    critical.insert(node);
+    Node next = nullptr;
+    for (auto dep : node->GetDependencies()) {
+      auto it = times.find(dep);
+      if ((it != times.end()) && ((next == nullptr) || (it->second.second > times[next].second))) {
+        next = dep;
+      }
+    }
+    node = next;
+  }
+  for (const auto& it : times) {
+    char timing[128];
+    snprintf(timing, sizeof(timing), "Stream:%d\nTime:%.3f us\nStart:+%.3f us",
+             it.first->stream_id_, (it.second.second - it.second.first) / 1000.0,
+             (it.second.first - launchStart) / 1000.0);
+    it.first->SetDotTiming(timing, critical.count(it.first) != 0);
+  }
+  static std::atomic<uint32_t> index{1};
+  std::string filename = "graph_" + std::to_string(amd::Os::getProcessId()) + "_dot_timing_" +
+      std::to_string(index++);
+  if (ihipGraphDebugDotPrint(reinterpret_cast<hipGraph_t>(clonedGraph_), filename.c_str(), 0) ==
+      hipSuccess) {
+    LogPrintfInfo("[hipGraph] timed graph dump:%s, critical path %zu nodes, %.3f us",
+                  filename.c_str(), critical.size(),
+                  (times[last].second - launchStart) / 1000.0);
+  }
+  for (const auto& it : times) {
+    it.first->SetDotTiming("", false);
+  }
+}
+
 // ================================================================================================
 bool GraphKernelArgManager::AllocGraphKernargPool(size_t pool_size) {
   bool bStatus = true;
@@ -950,6 +1628,35 @@ bool GraphKernelArgManager::AllocGraphKernargPool(size_t pool_size) {
 address GraphKernelArgManager::AllocKernArg(size_t size, size_t alignment) {
   assert(alignment != 0);
   address result = nullptr;
+  if (staging_) {
+    StagedKernArg staged;
+    // The capture writes the args with streaming stores, hence keep the cache line alignment
+    const size_t staged_alignment = std::max<size_t>(alignment, 64);
+    // Zero the staging memory, so the bytes beyond the written args don't show up in the diff
+    staged.mem_.reset(new (std::nothrow) uint8_t[size + staged_alignment]());
+    if (staged.mem_ == nullptr) {
+      return nullptr;
+    }
+    staged.host_ = amd::alignUp(staged.mem_.get(), staged_alignment);
+    staged.size_ = size;
+    const size_t idx = staged_.size();
+    staged.reused_ = (reuse_ != nullptr) && (idx < reuse_->size()) &&
+                     ((*reuse_)[idx].shadow_.size() == size) &&
+                     amd::isMultipleOf((*reuse_)[idx].addr_, alignment);
+    if (staged.reused_) {
+      staged.addr_ = (*reuse_)[idx].addr_;
+    } else {
+      staging_ = false;
+      staged.addr_ = AllocKernArg(size, alignment);
+      staging_ = true;
+      if (staged.addr_ == nullptr) {
+        return nullptr;
+      }
+    }
+    result = staged.host_;
+    staged_.push_back(std::move(staged));
+    return result;
+  }
   result = amd::alignUp(
       kernarg_graph_.back().kernarg_pool_addr_ + kernarg_graph_.back().kernarg_pool_offset_,
       alignment);
@@ -969,6 +1676,15 @@ address GraphKernelArgManager::AllocKernArg(size_t size, size_t alignment) {
   return result;
 }
 
+address GraphKernelArgManager::KernArgAddress(address kernArg) const {
+  for (const auto& staged : staged_) {
+    if (staged.host_ == kernArg) {
+      return staged.addr_;
+    }
+  }
+  return kernArg;
+}
+
 void GraphKernelArgManager::ReadBackOrFlush() {
   if (device_kernarg_pool_ && device_) {
     auto kernArgImpl = device_->settings().kernel_arg_impl_;
@@ -988,4 +1704,81 @@ void GraphKernelArgManager::ReadBackOrFlush() {
     }
   }
 }
+// ================================================================================================
+GraphConditionalNode::~GraphConditionalNode() {
+  if (bodyStream_ != nullptr) {
+    bodyStream_->finish();
+    hip::Stream::Destroy(bodyStream_);
+  }
+  if (bodyExec_ != nullptr) {
+    bodyExec_->release();
+  }
+  delete signal_;
+  delete body_;
+}
+
+// ================================================================================================
+hipError_t GraphConditionalNode::Instantiate() {
+  if (bodyExec_ != nullptr) {
+    return hipSuccess;
+  }
+  hipError_t status = ihipGraphInstantiate(&bodyExec_, body_, hipGraphInstantiateFlagDeviceLaunch);
+  if (status != hipSuccess) {
+    return status;
+  }
+  // The scheduler submits the body packets directly, hence the body must be a device graph
+  if (bodyExec_->DeviceGraph() == nullptr) {
+    ClPrint(amd::LOG_ERROR, amd::LOG_CODE,
+            "[hipGraph] Conditional node %p requires a body with captured packets only", this);
+    return hipErrorNotSupported;
+  }
+  hip::Device* device = hip::getCurrentDevice();
+  amd::Device* dev = device->devices()[0];
+  // A stream with a CU mask never shares the HW queue, so the scheduler owns the body queue
+  const uint32_t numCUs = dev->info().maxComputeUnits_;
+  std::vector<uint32_t> cuMask((numCUs + 31) / 32, ~0u);
+  if ((numCUs % 32) != 0) {
+    cuMask.back() = (1u << (numCUs % 32)) - 1;
+  }
+  bodyStream_ = new hip::Stream(device, hip::Stream::Priority::Normal, hipStreamNonBlocking,
+                                false, cuMask);
+  if (bodyStream_ == nullptr || !bodyStream_->Create()) {
+    if (bodyStream_ != nullptr) {
+      hip::Stream::Destroy(bodyStream_);
+      bodyStream_ = nullptr;
+    }
+    ClPrint(amd::LOG_ERROR, amd::LOG_CODE, "[hipGraph] Failed to create conditional stream!");
+    return hipErrorOutOfMemory;
+  }
+  signal_ = dev->createSignal();
+  if ((signal_ == nullptr) ||
+      !signal_->Init(*dev, 0, amd::device::Signal::WaitState::Active)) {
+    ClPrint(amd::LOG_ERROR, amd::LOG_CODE, "[hipGraph] Failed to create conditional signal!");
+    return hipErrorOutOfMemory;
+  }
+  return hipSuccess;
+}
+
+// ================================================================================================
+hipError_t GraphConditionalNode::CreateCommand(hip::Stream* stream) {
+  hipError_t status = GraphNode::CreateCommand(stream);
+  if (status != hipSuccess) {
+    return status;
+  }
+  // Nodes of child graphs skip the instantiation of the parent graph
+  status = Instantiate();
+  if (status != hipSuccess) {
+    return status;
+  }
+  amd::Command::EventWaitList waitList;
+  commands_.reserve(1);
+  amd::Command* command = new amd::GraphConditionCommand(
+      *stream, waitList, predicate_, bodyExec_->DeviceGraph(), *bodyStream_,
+      signal_->getHandle(), loop_);
+  if (command == nullptr) {
+    return hipErrorOutOfMemory;
+  }
+  commands_.emplace_back(command);
+  return hipSuccess;
+}
 }  // namespace hip
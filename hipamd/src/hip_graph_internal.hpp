@@ -20,6 +20,8 @@
 
 #pragma once
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <queue>
 #include <stack>
 #include <iostream>
@@ -45,6 +47,7 @@ struct Graph;
 struct GraphNode;
 struct GraphExec;
 struct UserObject;
+class GraphNodeTimes;
 typedef GraphNode* Node;
 hipError_t FillCommands(std::vector<std::vector<Node>>& parallelLists,
                         std::unordered_map<Node, std::vector<Node>>& nodeWaitLists,
@@ -54,6 +57,11 @@ void UpdateStream(std::vector<std::vector<Node>>& parallelLists, hip::Stream* st
                   GraphExec* ptr);
 hipError_t EnqueueGraphWithSingleList(std::vector<hip::Node>& topoOrder, hip::Stream* hip_stream,
                                       hip::GraphExec* graphExec = nullptr);
+
+//! Estimated launch overhead of a graph node, in the work-item units of the node cost
+constexpr uint64_t kGraphNodeLaunchCost = 4 * Ki;
+//! Estimated cost of a wait on a node, executed on another stream
+constexpr uint64_t kGraphStreamWaitCost = 16 * Ki;
 struct UserObject : public amd::ReferenceCountedObject {
   typedef void (*UserCallbackDestructor)(void* data);
   static std::unordered_set<UserObject*> ObjectSet_;
@@ -118,6 +126,29 @@ struct UserObject : public amd::ReferenceCountedObject {
   UserObject(const UserObject& obj) = delete;
 };
 
+// ================================================================================================
+//! Bump pointer arena for the nodes of the stream capture graphs. The node destructors still run
+//! on the node removal, but the memory is released at once with the graph
+class GraphNodeArena : public amd::HeapObject {
+ public:
+  GraphNodeArena() {}
+  ~GraphNodeArena();
+
+  //! Allocates memory from the current chunk or starts a new one
+  void* Allocate(size_t size);
+
+ private:
+  static constexpr size_t kChunkSize = 64 * Ki;   //!< Size of the arena chunks
+  std::vector<char*> chunks_;                     //!< The list of all allocated chunks
+  size_t offset_ = kChunkSize;                    //!< Current offset in the last chunk
+  amd::Monitor lock_{};                           //!< Capture can add nodes from many threads
+
+  //! Disable copy constructor
+  GraphNodeArena(const GraphNodeArena&) = delete;
+  //! Disable default operator=
+  GraphNodeArena& operator=(const GraphNodeArena&) = delete;
+};
+
 struct hipGraphNodeDOTAttribute {
  protected:
   std::string style_;
@@ -173,11 +204,45 @@ class GraphKernelArgManager : public amd::ReferenceCountedObject, public amd::Gr
 
   // Allocate kernel args from current chunck for given size and alignment.
   // If kernel arg pool is full allocate new chunck and alloc kern args from new pool.
+  // Under staging the pool location is only reserved and the args are written into host memory.
   address AllocKernArg(size_t size, size_t alignment) override;
 
   // Do HDP flush/When HDP flush register is invalid fallback to Readback
   void ReadBackOrFlush();
 
+  //! Kernel arguments of a captured node
+  struct CapturedKernArg {
+    address addr_;                 //!< Location of the arguments in the kernarg pool
+    std::vector<uint8_t> shadow_;  //!< Host copy of the arguments, used to diff the updates
+  };
+
+  //! Kernel arguments, written by a packet capture into host memory
+  struct StagedKernArg {
+    std::unique_ptr<uint8_t[]> mem_;  //!< Host allocation, holding the staged arguments
+    address host_;                    //!< Aligned location of the arguments in mem_
+    address addr_;                    //!< Location of the arguments in the kernarg pool
+    size_t size_;                     //!< Size of the kernel arguments
+    bool reused_;                     //!< The pool location of the previous capture is reused
+  };
+
+  // Redirect the kernel arg writes into host memory, until EndStaging() is called. The pool
+  // locations are still assigned, reusing the locations of the previous capture if provided.
+  void BeginStaging(std::vector<CapturedKernArg>* reuse = nullptr) {
+    staged_.clear();
+    reuse_ = reuse;
+    staging_ = true;
+  }
+
+  // Stop the staging and return all kernel args, allocated since BeginStaging()
+  std::vector<StagedKernArg>& EndStaging() {
+    staging_ = false;
+    reuse_ = nullptr;
+    return staged_;
+  }
+
+  // Return the pool location of the staged kernel args
+  address KernArgAddress(address kernArg) const override;
+
  private:
   struct KernelArgPoolGraph {
     KernelArgPoolGraph(address base_addr, size_t size)
@@ -189,6 +254,9 @@ class GraphKernelArgManager : public amd::ReferenceCountedObject, public amd::Gr
   bool device_kernarg_pool_ = false;  //! Indicate if kernel pool in device mem
   amd::Device* device_ = nullptr;     //! Device from where kernel arguments are allocated
   std::vector<KernelArgPoolGraph> kernarg_graph_;  //! Vector of allocated kernarg pool
+  bool staging_ = false;                //! Kernel args are written into host memory
+  std::vector<StagedKernArg> staged_;   //! Kernel args allocated under staging
+  std::vector<CapturedKernArg>* reuse_ = nullptr;  //! Pool locations to reuse under staging
   using KernelArgImpl = device::Settings::KernelArgImpl;
 };
 
@@ -208,6 +276,9 @@ struct GraphNode : public hipGraphNodeDOTAttribute {
   size_t outDegree_;    //!< count of outgoing edges (@todo: remove, it's edges_.size())
   int32_t stream_id_ = -1;  //! Stream ID on which this node will be executed
   int32_t launch_id_ = -1;  //! Launch ID of this node in the entire graph execution sequence
+  int32_t fused_chain_ = -1;  //! Fused kernel chain of the node, if any
+  std::string dot_timing_;    //! Measured times of the node for the timed dot dump
+  bool dot_critical_ = false; //! The node is on the measured critical path of the timed dump
   static int nextID;
   struct Graph* parentGraph_;
   static std::unordered_set<GraphNode*> nodeSet_;
@@ -216,7 +287,10 @@ struct GraphNode : public hipGraphNodeDOTAttribute {
   unsigned int isEnabled_;
   bool signal_is_required_ = false; //!< This node requires a signal on the command
   std::vector<uint8_t *> gpuPackets_; //!< GPU Packet to enqueue during graph launch
+  //! Kernel arguments of the captured packets
+  std::vector<GraphKernelArgManager::CapturedKernArg> capturedKernArgs_;
   std::string capturedKernelName_;
+  bool capturePrepared_ = false;          //!< Commands for the capture were already created
   size_t alignedKernArgSize_ = 256;       //!< Aligned size required for kernel args
   size_t kernargSegmentByteSize_ = 512;   //!< Kernel arg segment byte size
   size_t kernargSegmentAlignment_ = 256;  //!< Kernel arg segment alignment
@@ -248,6 +322,9 @@ struct GraphNode : public hipGraphNodeDOTAttribute {
     isEnabled_ = node.isEnabled_;
   }
 
+  //! Allocates the node memory from the arena or from the heap if the arena isn't provided
+  static void* Allocate(size_t size, GraphNodeArena* arena);
+
   virtual ~GraphNode() {
     for (auto node : edges_) {
       node->RemoveDependency(this);
@@ -262,6 +339,12 @@ struct GraphNode : public hipGraphNodeDOTAttribute {
     nodeSet_.erase(this);
   }
 
+  //! All nodes have a header with the arena, which owns the node memory, if any
+  static void* operator new(size_t size) { return Allocate(size, nullptr); }
+  static void* operator new(size_t size, GraphNodeArena* arena) { return Allocate(size, arena); }
+  static void operator delete(void* ptr);
+  static void operator delete(void* ptr, GraphNodeArena* arena) { operator delete(ptr); }
+
   // check node validity
   static bool isNodeValid(GraphNode* pGraphNode) {
     amd::ScopedLock lock(nodeSetLock_);
@@ -277,18 +360,16 @@ struct GraphNode : public hipGraphNodeDOTAttribute {
   size_t GetKerArgSize() const { return alignedKernArgSize_; }
   size_t GetKernargSegmentByteSize() const { return kernargSegmentByteSize_; }
   size_t GetKernargSegmentAlignment() const { return kernargSegmentAlignment_; }
-  void CaptureAndFormPacket(hip::Stream* capture_stream, GraphKernelArgManager* kernArgMgr) {
+  //! Captures the node packets. If update is set and the packets layout didn't change, then
+  //! only the changed bytes of the kernel args and the packets are rewritten in place
+  void CaptureAndFormPacket(hip::Stream* capture_stream, GraphKernelArgManager* kernArgMgr,
+                            bool update = false);
+  //! Creates the commands for the next CaptureAndFormPacket() call. The commands don't allocate
+  //! kernel arguments, hence the creation can run on any thread
+  hipError_t PrepareCapture(hip::Stream* capture_stream) {
     hipError_t status = CreateCommand(capture_stream);
-    gpuPackets_.clear();
-    for (auto& command : commands_) {
-      command->setPktCapturingState(true, &gpuPackets_, kernArgMgr, &capturedKernelName_);
-      // Enqueue command to capture GPU Packet. The packet is not submitted to the device.
-      // The packet is stored in gpuPacket_ and submitted during graph launch.
-      command->submit(*(command->queue())->vdev());
-      command->release();
-    }
-    // Commands are captured and released. Clear them from the object.
-    commands_.clear();
+    capturePrepared_ = true;
+    return status;
   }
   hip::Stream* GetQueue() const { return stream_; }
 
@@ -304,6 +385,9 @@ struct GraphNode : public hipGraphNodeDOTAttribute {
     // Reset the launch ID after the stream assignment
     launch_id_ = -1;
   }
+  /// Returns the estimated execution cost of the node for the graph scheduler. The units are
+  /// work-items and the blit kernels are assumed to process a dword per work-item
+  virtual uint64_t EstimatedCost() const { return kGraphNodeLaunchCost; }
   /// Create amd::command for the graph node
   virtual hipError_t CreateCommand(hip::Stream* stream) {
     commands_.clear();
@@ -438,6 +522,23 @@ struct GraphNode : public hipGraphNodeDOTAttribute {
   virtual std::string GetLabel(hipGraphDebugDotFlags flag) override {
     return (std::to_string(id_) + "\n" + label_);
   }
+  //! Sets the annotations of the timed dot dump, an empty timing removes them
+  void SetDotTiming(const std::string& timing, bool critical) {
+    dot_timing_ = timing;
+    dot_critical_ = critical;
+  }
+  //! Prints the measured times into the label, must be called before the label is closed
+  void PrintDotTiming(std::ostream& out) const {
+    if (!dot_timing_.empty()) {
+      out << "\n" << dot_timing_;
+    }
+  }
+  //! Highlights the critical path, must be called after the label is closed
+  void PrintDotCritical(std::ostream& out) const {
+    if (dot_critical_) {
+      out << "color=\"red\"penwidth=\"3\"";
+    }
+  }
   unsigned int GetEnabled() const { return isEnabled_; }
   void SetEnabled(unsigned int isEnabled) { isEnabled_ = isEnabled; }
   // Returns true if capture is enabled for the current node.
@@ -471,7 +572,9 @@ struct GraphNode : public hipGraphNodeDOTAttribute {
     if (DEBUG_HIP_GRAPH_DOT_PRINT) {
       out << "\nStreamId:" << stream_id_;
     }
+    PrintDotTiming(out);
     out << "\"";
+    PrintDotCritical(out);
     out << "];";
   }
 };
@@ -494,6 +597,11 @@ struct Graph {
   //!< Used as a temporary storage for the waiting nodes
   //!< to reduce the stack pressure in recursion
   std::vector<Node> wait_order_;
+  std::vector<Node> run_order_;       //!< The execution order of the nodes from the scheduler
+  //!< Linear chains of kernel nodes on one stream, launched as back-to-back captured packets
+  std::vector<std::vector<Node>> fused_chains_;
+  bool use_fused_chains_ = false;     //!< The captured packets of the chains match the device
+  GraphNodeTimes* node_times_ = nullptr;  //!< Recorder of the node times, if enabled
   std::vector<hip::Stream*> streams_; //!< The list of streams, used in the execution
   int32_t current_id_ = 0;    //!< The current node ID in the graph execution sequence
   hip::Device* device_;       //!< HIP device object
@@ -501,6 +609,8 @@ struct Graph {
   std::unordered_set<GraphNode*> capturedNodes_;
   bool graphInstantiated_;
   std::unordered_set<void*> memAllocNodePtrs_;
+  //!< Arena of the capture graph nodes. Must be destroyed after the nodes
+  std::unique_ptr<GraphNodeArena> node_arena_;
  public:
   Graph(hip::Device* device, const Graph* original = nullptr)
       : pOriginalGraph_(original)
@@ -553,6 +663,15 @@ struct Graph {
     memAllocNodePtrs_.clear();
   }
 
+  //! Allocates the nodes of the graph from an arena. Used by the stream capture graphs
+  void EnableNodeArena() {
+    if (DEBUG_HIP_GRAPH_CAPTURE_NODE_ARENA && (node_arena_ == nullptr)) {
+      node_arena_.reset(new GraphNodeArena());
+    }
+  }
+  //! Returns the arena for the new nodes or nullptr if the nodes are allocated on the heap
+  GraphNodeArena* NodeArena() const { return node_arena_.get(); }
+
   void AddManualNodeDuringCapture(GraphNode* node) { capturedNodes_.insert(node); }
 
   std::unordered_set<GraphNode*> GetManualNodesDuringCapture() { return capturedNodes_; }
@@ -621,15 +740,21 @@ struct Graph {
   void GetRunList(std::vector<std::vector<Node>>& parallelLists,
                   std::unordered_map<Node, std::vector<Node>>& dependencies);
 
-  //! Schedules one node on a vitual stream.
-  //! It will also process the nodes in edges, using recursion
-  void ScheduleOneNode(
-    Node node,      //!< Node for scheduling on a virtual stream
-    int stream_id   //!< Current active virtual stream to use for scheduling
+  //! Finds the topological order and the rank of every node. The rank is the estimated cost
+  //! of the longest path from the node to a leaf
+  bool GetCriticalPaths(
+    std::vector<Node>& topoOrder,               //!< Topological order of the nodes
+    std::unordered_map<Node, uint64_t>& rank    //!< Rank of every node
     );
 
-  //! Schedules all nodes in the graph into different streams
-  void ScheduleNodes();
+  //! Returns the estimated cost of the longest dependency chain in the graph
+  uint64_t CriticalPathCost();
+
+  //! Schedules all nodes in the graph into different streams, using the critical path
+  //! ranks of the nodes and the estimated stream occupancy
+  void ScheduleNodes(
+    int32_t base_stream = 0   //!< The stream, the graph is launched on
+    );
 
   //! Update streams for the graph execution
   void UpdateStreams(
@@ -637,10 +762,28 @@ struct Graph {
     const std::vector<hip::Stream*>& parallel_stream  //!< The list of parallel streams
   );
 
+  //! Finds linear chains of kernel nodes on one stream, which don't need any waits inside the
+  //! chain, and returns the nodes in the chains. Must run after ScheduleNodes()
+  std::vector<Node> FuseKernelChains();
+
+  //! Enables the launch of the fused chains with the captured packets
+  void EnableFusedChains(bool enable) { use_fused_chains_ = enable && !fused_chains_.empty(); }
+
+  //! Sets the recorder of the node times for the next launch, nullptr disables the recording
+  void SetNodeTimes(GraphNodeTimes* node_times) { node_times_ = node_times; }
+
+  //! Returns true if the node is in a fused kernel chain
+  bool IsFusedNode(Node node) const { return node->fused_chain_ >= 0; }
+
   //! Runs one node on the assigned stream
   bool RunOneNode(
-    Node node,    //!< Node for the execution on GPU
-    bool wait     //!< Wait dependencies
+    Node node     //!< Node for the execution on GPU
+    );
+
+  //! Runs all nodes of a fused chain with a single command on the assigned stream
+  void RunKernelChain(
+    const std::vector<Node>& chain,               //!< Nodes of the chain
+    const amd::Command::EventWaitList& waitList   //!< Waits of the chain head
     );
 
   //! Runs all nodes from the execution graph on the assigned streams
@@ -736,6 +879,61 @@ struct Graph {
 };
 struct GraphKernelNode;
 
+//! GPU execution times of the graph nodes in the last profiled launch
+class GraphNodeTimes {
+ public:
+  ~GraphNodeTimes() { Clear(); }
+
+  //! Records the captured packets of the node, dispatched through the accumulate command.
+  //! The packets have indices [first, first + count) in the packets of the command
+  void AddPackets(Node node, amd::AccumulateCommand* command, uint32_t first, uint32_t count) {
+    command->retain();
+    records_.push_back({node, command, first, count});
+  }
+
+  //! Enables the profiling on all commands of the node and records them. Must be called before
+  //! the commands are enqueued
+  void AddCommands(Node node);
+
+  //! Releases the recorded commands of the previous launch
+  void Clear() {
+    for (auto& record : records_) {
+      record.command_->release();
+    }
+    records_.clear();
+  }
+
+  //! Returns the start and end time of the node in ns
+  hipError_t Get(Node node, uint64_t* start, uint64_t* end) const;
+
+  //! Waits for the recorded commands of the last launch
+  void Wait() const {
+    for (const auto& record : records_) {
+      record.command_->awaitCompletion();
+    }
+  }
+
+  //! Returns true if the last launch was recorded
+  bool Empty() const { return records_.empty(); }
+
+ private:
+  struct Record {
+    Node node_;               //!< Graph node
+    amd::Command* command_;   //!< Command, which executed the node
+    uint32_t first_;          //!< The first packet of the node in the accumulate command
+    uint32_t count_;          //!< The number of packets, 0 if the command executed the node
+  };
+  std::vector<Record> records_;   //!< The commands of the last launch
+};
+
+//! Header of the device graph image, followed by the AQL packets of the graph.
+//! Must match __hip_device_graph in the device headers
+struct GraphDeviceLaunch {
+  uint32_t packetCount_;    //!< The number of AQL packets after the header
+  uint32_t reserved_[15];   //!< Keeps the packets aligned to the packet size
+};
+static_assert(sizeof(GraphDeviceLaunch) == 64, "The device graph header must have the packet size");
+
 struct GraphExec : public amd::ReferenceCountedObject {
   std::vector<std::vector<Node>> parallelLists_;
   //! Topological order of the graph doesn't include nodes embedded as part of the child graph
@@ -754,6 +952,14 @@ struct GraphExec : public amd::ReferenceCountedObject {
   int instantiateDeviceId_ = -1;
   bool hasHiddenHeap_ = false;  //!< Hidden heap indicator for Kernel node
   bool repeatLaunch_ = false;
+  std::atomic<uint32_t> launchesInFlight_{0};  //!< Launches, which didn't complete yet
+  bool nodeTiming_ = false;          //!< Launches record the GPU times of the nodes
+  GraphNodeTimes nodeTimes_;        //!< GPU times of the nodes in the last launch
+  void* memArena_ = nullptr;        //!< Physical memory, which backs the planned allocations
+  std::vector<Node> arenaNodes_;    //!< MemAlloc/MemFree nodes, backed by the arena
+  GraphDeviceLaunch* deviceGraph_ = nullptr;  //!< Packets image for the device side launches
+  size_t deviceGraphSize_ = 0;                //!< Size of the device graph allocation
+  amd::Device* deviceGraphDev_ = nullptr;     //!< Device of the device graph allocation
 
  public:
   GraphExec(std::vector<Node>& topoOrder, std::vector<std::vector<Node>>& lists,
@@ -773,12 +979,19 @@ struct GraphExec : public amd::ReferenceCountedObject {
   }
 
   ~GraphExec() {
+    if (DEBUG_HIP_GRAPH_DOT_TIMING) {
+      DumpTimedDOT();
+    }
     for (auto stream : parallel_streams_) {
       if (stream != nullptr) {
         stream->finish();
         hip::Stream::Destroy(stream);
       }
     }
+    ReleaseMemArena();
+    if (deviceGraph_ != nullptr) {
+      deviceGraphDev_->hostFree(deviceGraph_, deviceGraphSize_);
+    }
     amd::ScopedLock lock(graphExecSetLock_);
     graphExecSet_.erase(this);
     delete clonedGraph_;
@@ -818,6 +1031,16 @@ struct GraphExec : public amd::ReferenceCountedObject {
   hipError_t Init();
   hipError_t CreateStreams(uint32_t num_streams);
   hipError_t Run(hipStream_t stream);
+  //! Plans the offsets of graph allocations in a single arena and maps them for all launches
+  void PlanMemArena();
+  //! Captures the packets of the kernel chains, which can run without waits between the nodes
+  hipError_t CaptureKernelChains();
+  //! Unmaps the planned allocations and releases the arena
+  void ReleaseMemArena();
+  //! Copies the captured packets of the graph into device visible memory for the device launches
+  hipError_t BuildDeviceGraph();
+  //! Returns the device graph image or nullptr if the graph isn't device launchable
+  void* DeviceGraph() const { return deviceGraph_; }
   // Capture GPU Packets from graph commands
   hipError_t CaptureAQLPackets();
   hipError_t UpdateAQLPacket(hip::GraphNode* node);
@@ -831,6 +1054,13 @@ struct GraphExec : public amd::ReferenceCountedObject {
     return kernArgManager_;
   }
   static void DecrementRefCount(cl_event event, cl_int command_exec_status, void* user_data);
+  //! Enables the recording of the node times in the next launches
+  void SetNodeTiming(bool enable) { nodeTiming_ = enable; }
+  bool NodeTiming() const { return nodeTiming_; }
+  GraphNodeTimes& NodeTimes() { return nodeTimes_; }
+  //! Writes the graph as a dot file, annotated with the node times, the streams and
+  //! the critical path of the last profiled launch. Waits for the launch
+  void DumpTimedDOT();
 };
 
 struct ChildGraphNode : public GraphNode {
@@ -864,6 +1094,8 @@ struct ChildGraphNode : public GraphNode {
 
   Graph* GetChildGraph() override { return childGraph_; }
 
+  uint64_t EstimatedCost() const override { return childGraph_->CriticalPathCost(); }
+
   void SetGraphCaptureStatus(bool status) { graphCaptureStatus_ = status; }
 
   bool GetGraphCaptureStatus() { return graphCaptureStatus_; }
@@ -990,6 +1222,12 @@ class GraphKernelNode : public GraphNode {
 
  public:
   bool HasHiddenHeap() const { return hasHiddenHeap_; }
+  uint64_t EstimatedCost() const override {
+    return kGraphNodeLaunchCost +
+        static_cast<uint64_t>(kernelParams_.gridDim.x) * kernelParams_.gridDim.y *
+        kernelParams_.gridDim.z * kernelParams_.blockDim.x * kernelParams_.blockDim.y *
+        kernelParams_.blockDim.z;
+  }
   void EnqueueCommands(hip::Stream* stream) override {
     // If the node is disabled it becomes empty node. To maintain ordering just enqueue marker.
     // Node can be enabled/disabled only for kernel, memcpy and memset nodes.
@@ -1032,7 +1270,9 @@ class GraphKernelNode : public GraphNode {
     if (DEBUG_HIP_GRAPH_DOT_PRINT) {
       out << "StreamId:" << stream_id_;
     }
+    PrintDotTiming(out);
     out << "\"";
+    PrintDotCritical(out);
     out << "];";
   }
 
@@ -1440,6 +1680,11 @@ class GraphMemcpyNode : public GraphNode {
     return new GraphMemcpyNode(static_cast<GraphMemcpyNode const&>(*this));
   }
 
+  uint64_t EstimatedCost() const override {
+    return kGraphNodeLaunchCost + (copyParams_.extent.width * copyParams_.extent.height *
+                                   copyParams_.extent.depth) / sizeof(uint32_t);
+  }
+
   virtual hipError_t CreateCommand(hip::Stream* stream) override {
     if ((copyParams_.kind == hipMemcpyHostToHost || copyParams_.kind == hipMemcpyDefault)
       && IsHtoHMemcpy(copyParams_.dstPtr.ptr, copyParams_.srcPtr.ptr)) {
@@ -1578,6 +1823,16 @@ class GraphMemcpyNode : public GraphNode {
         case hipMemcpyDeviceToDevice:
           isGraphCapture = true;
           break;
+        case hipMemcpyHostToDevice:
+        case hipMemcpyDeviceToHost:
+        case hipMemcpyDefault:
+          // Pinned host memory is accessible by the blit kernels, hence the copy can be
+          // lowered to the kernel packets the same way as a device to device copy
+          isGraphCapture = (copyParams_.srcArray == nullptr) &&
+                           (copyParams_.dstArray == nullptr) &&
+                           (ihipGetMemcpyType(copyParams_.srcPtr.ptr, copyParams_.dstPtr.ptr,
+                                              copyParams_.kind) == hipCopyBuffer);
+          break;
         default:
           break;
       }
@@ -1608,6 +1863,10 @@ class GraphMemcpyNode1D : public GraphMemcpyNode {
     return new GraphMemcpyNode1D(static_cast<GraphMemcpyNode1D const&>(*this));
   }
 
+  uint64_t EstimatedCost() const override {
+    return kGraphNodeLaunchCost + count_ / sizeof(uint32_t);
+  }
+
   virtual hipError_t CreateCommand(hip::Stream* stream) override {
     if ((kind_ == hipMemcpyHostToHost || kind_ == hipMemcpyDefault) && IsHtoHMemcpy(dst_, src_)) {
       return hipSuccess;
@@ -2003,6 +2262,12 @@ class GraphMemsetNode : public GraphNode {
     return new GraphMemsetNode(static_cast<GraphMemsetNode const&>(*this));
   }
 
+  uint64_t EstimatedCost() const override {
+    const size_t height = (memsetParams_.height == 1) ? 1 : memsetParams_.height * depth_;
+    return kGraphNodeLaunchCost +
+        (memsetParams_.width * height * memsetParams_.elementSize) / sizeof(uint32_t);
+  }
+
   virtual std::string GetLabel(hipGraphDebugDotFlags flag) override {
     std::string label;
     if (flag == hipGraphDebugDotFlagsMemsetNodeParams || flag == hipGraphDebugDotFlagsVerbose) {
@@ -2357,12 +2622,18 @@ class GraphEmptyNode : public GraphNode {
     }
     return hipSuccess;
   }
+
+  virtual bool GraphCaptureEnabled() override {
+    // The nodes of a single list run in order, so the marker doesn't produce any packets
+    return DEBUG_CLR_GRAPH_PACKET_CAPTURE;
+  }
 };
 
 // ================================================================================================
 class GraphMemAllocNode final : public GraphNode {
   hipMemAllocNodeParams node_params_;  // Node parameters for memory allocation
   amd::Memory* va_ = nullptr;         // Memory object, which holds a virtual address
+  amd::Memory* arena_va_ = nullptr;   // VA mapping into the arena of the executable graph
 
   // Derive the new class for VirtualMapCommand,
   // so runtime can allocate memory during the execution of command
@@ -2454,7 +2725,12 @@ class GraphMemAllocNode final : public GraphNode {
 
   virtual hipError_t CreateCommand(hip::Stream* stream) final {
     auto error = GraphNode::CreateCommand(stream);
-    if (!HIP_MEM_POOL_USE_VM) {
+    if (arena_va_ != nullptr) {
+      // VA stays mapped into the arena, hence the node only keeps the order of the execution
+      if (DEBUG_HIP_FORCE_GRAPH_QUEUES != 1) {
+        commands_.push_back(new amd::Marker(*stream, !kMarkerDisableFlush, {}));
+      }
+    } else if (!HIP_MEM_POOL_USE_VM) {
       auto ptr = Execute(stream_);
     } else {
       auto graph = GetParentGraph();
@@ -2515,6 +2791,10 @@ class GraphMemAllocNode final : public GraphNode {
   }
 
   bool IsActiveMem() {
+    if (arena_va_ != nullptr) {
+      // The graph frees arena memory, so it's never active between launches
+      return false;
+    }
     auto graph = GetParentGraph();
     return graph->ProbeMemory(node_params_.dptr);
   }
@@ -2522,11 +2802,66 @@ class GraphMemAllocNode final : public GraphNode {
   void GetParams(hipMemAllocNodeParams* params) const {
     std::memcpy(params, &node_params_, sizeof(hipMemAllocNodeParams));
   }
+
+  //! Size of the VA range, which the node maps on execution
+  size_t MappedSize() const {
+    const auto& dev_info = g_devices[0]->devices()[0]->info();
+    return amd::alignUp(node_params_.bytesize, dev_info.virtualMemAllocGranularity_);
+  }
+
+  //! Maps the VA of the node into the arena memory at the offset, until UnmapArena() is called
+  bool MapArena(amd::Memory* arena, size_t offset, hip::Stream* stream) {
+    // Another executable graph of the same graph keeps the VA mapped
+    if ((va_ == nullptr) || (amd::MemObjMap::FindMemObj(node_params_.dptr) != va_)) {
+      return false;
+    }
+    amd::MemObjMap::RemoveMemObj(node_params_.dptr);
+    auto cmd = new amd::VirtualMapCommand(*stream, amd::Command::EventWaitList{},
+                                          node_params_.dptr, MappedSize(), arena, offset);
+    cmd->enqueue();
+    cmd->awaitCompletion();
+    cmd->release();
+    arena_va_ = amd::MemObjMap::FindMemObj(node_params_.dptr);
+    if (arena_va_ == nullptr) {
+      // Restore the dummy reference for the validation logic
+      amd::MemObjMap::AddMemObj(node_params_.dptr, va_);
+      return false;
+    }
+    stream->device().SetMemAccess(node_params_.dptr, MappedSize(),
+                                  amd::Device::VmmAccess::kReadWrite);
+    ClPrint(amd::LOG_INFO, amd::LOG_MEM_POOL, "Graph MemAlloc arena map [%p-%p], offset %zu",
+            node_params_.dptr, reinterpret_cast<char*>(node_params_.dptr) + MappedSize(), offset);
+    return true;
+  }
+
+  //! Unmaps the VA of the node from the arena memory
+  void UnmapArena(hip::Stream* stream) {
+    if (arena_va_ == nullptr) {
+      return;
+    }
+    auto cmd = new amd::VirtualMapCommand(*stream, amd::Command::EventWaitList{},
+                                          node_params_.dptr, MappedSize(), nullptr);
+    cmd->enqueue();
+    cmd->awaitCompletion();
+    cmd->release();
+    arena_va_->release();
+    arena_va_ = nullptr;
+    amd::MemObjMap::AddMemObj(node_params_.dptr, va_);
+  }
+
+  //! Returns true if the VA of the node stays mapped into the arena
+  bool IsArenaBacked() const { return arena_va_ != nullptr; }
+
+  virtual bool GraphCaptureEnabled() final {
+    // Arena backed node doesn't produce any packets
+    return IsArenaBacked() && DEBUG_CLR_GRAPH_PACKET_CAPTURE;
+  }
 };
 
 // ================================================================================================
 class GraphMemFreeNode : public GraphNode {
   void* device_ptr_;    // Device pointer of the freed memory
+  bool arena_backed_ = false;   // Memory belongs to the arena of the executable graph
 
   // Derive the new class for VirtualMap command, since runtime has to free
   // real allocation after unmap is complete
@@ -2579,7 +2914,12 @@ class GraphMemFreeNode : public GraphNode {
 
   virtual hipError_t CreateCommand(hip::Stream* stream) final {
     auto error = GraphNode::CreateCommand(stream);
-    if (!HIP_MEM_POOL_USE_VM) {
+    if (arena_backed_) {
+      // The arena holds memory till the executable graph is destroyed
+      if (DEBUG_HIP_FORCE_GRAPH_QUEUES != 1) {
+        commands_.push_back(new amd::Marker(*stream, !kMarkerDisableFlush, {}));
+      }
+    } else if (!HIP_MEM_POOL_USE_VM) {
       Execute(stream_);
     } else {
       auto graph = GetParentGraph();
@@ -2607,6 +2947,13 @@ class GraphMemFreeNode : public GraphNode {
   void GetParams(void** params) const {
     *params = device_ptr_;
   }
+
+  void SetArenaBacked(bool arena_backed) { arena_backed_ = arena_backed; }
+
+  virtual bool GraphCaptureEnabled() final {
+    // Arena backed node doesn't produce any packets
+    return arena_backed_ && DEBUG_CLR_GRAPH_PACKET_CAPTURE;
+  }
 };
 
 class GraphDrvMemcpyNode : public GraphNode {
@@ -2800,4 +3147,53 @@ class hipGraphExternalSemWaitNode : public GraphNode {
   }
 };
 
+// ================================================================================================
+//! Internal type of the conditional node. The public node type enum has no entry for it, hence
+//! the API reports the node as a child graph
+constexpr hipGraphNodeType kGraphNodeTypeConditional = static_cast<hipGraphNodeType>(0x100);
+
+// ================================================================================================
+//! Conditional node, which runs the body graph on the GPU once (if) or repeatedly (while) as
+//! long as the predicate in device memory isn't zero. A scheduler blit on the launch stream
+//! evaluates the predicate and submits the device graph of the body into a dedicated HW queue,
+//! so the host never has to read the predicate back
+class GraphConditionalNode final : public GraphNode {
+  Graph* body_;                             //!< Body graph, owned by the node
+  uint32_t* predicate_;                     //!< Predicate in device memory
+  bool loop_;                               //!< Runs the body while the predicate isn't zero
+  GraphExec* bodyExec_ = nullptr;           //!< Instantiated body with the device graph
+  hip::Stream* bodyStream_ = nullptr;       //!< Dedicated stream, which executes the body
+  amd::device::Signal* signal_ = nullptr;   //!< Marks the end of every body iteration
+
+ public:
+  GraphConditionalNode(Graph* body, uint32_t* predicate, bool loop)
+      : GraphNode(kGraphNodeTypeConditional, "solid", "rectangle", loop ? "WHILE" : "IF"),
+        body_(body->clone()),
+        predicate_(predicate),
+        loop_(loop) {}
+
+  GraphConditionalNode(const GraphConditionalNode& rhs)
+      : GraphNode(rhs),
+        body_(rhs.body_->clone()),
+        predicate_(rhs.predicate_),
+        loop_(rhs.loop_) {}
+
+  ~GraphConditionalNode();
+
+  GraphNode* clone() const override {
+    return new GraphConditionalNode(static_cast<GraphConditionalNode const&>(*this));
+  }
+
+  Graph* GetChildGraph() override { return body_; }
+
+  uint64_t EstimatedCost() const override { return body_->CriticalPathCost(); }
+
+  //! Instantiates the body for the device launch and creates the HW resources for the scheduler
+  hipError_t Instantiate();
+
+  hipError_t CreateCommand(hip::Stream* stream) override;
+
+  virtual bool GraphCaptureEnabled() override { return false; }
+};
+
 }  // namespace hip
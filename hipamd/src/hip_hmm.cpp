@@ -75,37 +75,38 @@ hipError_t hipMallocManaged(void** dev_ptr, size_t size, unsigned int flags) {
 }
 
 // ================================================================================================
-hipError_t hipMemPrefetchAsync(const void* dev_ptr, size_t count, int device,
-                               hipStream_t stream) {
-  HIP_INIT_API(hipMemPrefetchAsync, dev_ptr, count, device, stream);
-
-  if ((dev_ptr == nullptr) || (count == 0)) {
-    HIP_RETURN(hipErrorInvalidValue);
+static hipError_t ihipMemPrefetchAsync(std::vector<amd::SvmPrefetchAsyncCommand::Range>&& ranges,
+                                       int device, hipStream_t stream) {
+  if (!hip::isValid(stream)) {
+    return hipErrorContextIsDestroyed;
   }
 
-  if (!hip::isValid(stream)) {
-    HIP_RETURN(hipErrorContextIsDestroyed);
+  if (device != hipCpuDeviceId && (static_cast<size_t>(device) >= g_devices.size())) {
+    return hipErrorInvalidDevice;
   }
 
-  size_t offset = 0;
-  amd::Memory* memObj = getMemoryObject(dev_ptr, offset);
+  for (const auto& range : ranges) {
+    if ((range.dev_ptr_ == nullptr) || (range.count_ == 0)) {
+      return hipErrorInvalidValue;
+    }
 
-  if ((memObj != nullptr) && (count  > (memObj->getSize() - offset))) {
-    HIP_RETURN(hipErrorInvalidValue);
-  }
-  if (device != hipCpuDeviceId && (static_cast<size_t>(device) >= g_devices.size())) {
-    HIP_RETURN(hipErrorInvalidDevice);
+    size_t offset = 0;
+    amd::Memory* memObj = getMemoryObject(range.dev_ptr_, offset);
+
+    if ((memObj != nullptr) && (range.count_  > (memObj->getSize() - offset))) {
+      return hipErrorInvalidValue;
+    }
+
+    if ((memObj == nullptr) && (device != hipCpuDeviceId) &&
+        (!g_devices[device]->devices()[0]->info().hmmCpuMemoryAccessible_)) {
+      return hipErrorNotSupported;
+    }
   }
 
   hip::Stream* hip_stream = nullptr;
   amd::Device* dev = nullptr;
   bool cpu_access = false;
 
-  if ((memObj == nullptr) && (device != hipCpuDeviceId) &&
-      (!g_devices[device]->devices()[0]->info().hmmCpuMemoryAccessible_)) {
-    HIP_RETURN(hipErrorNotSupported);
-  }
-
   // Pick the specified stream or Null one from the provided device
   if (device == hipCpuDeviceId) {
     cpu_access = true;
@@ -118,12 +119,12 @@ hipError_t hipMemPrefetchAsync(const void* dev_ptr, size_t count, int device,
   }
 
   if (hip_stream == nullptr) {
-    HIP_RETURN(hipErrorInvalidValue);
+    return hipErrorInvalidValue;
   }
 
   amd::Command::EventWaitList waitList;
   amd::SvmPrefetchAsyncCommand* command =
-      new amd::SvmPrefetchAsyncCommand(*hip_stream, waitList, dev_ptr, count, dev, cpu_access);
+      new amd::SvmPrefetchAsyncCommand(*hip_stream, waitList, std::move(ranges), dev, cpu_access);
   if (command == nullptr) {
     return hipErrorOutOfMemory;
   }
@@ -131,7 +132,32 @@ hipError_t hipMemPrefetchAsync(const void* dev_ptr, size_t count, int device,
   command->enqueue();
   command->release();
 
-  HIP_RETURN(hipSuccess);
+  return hipSuccess;
+}
+
+// ================================================================================================
+hipError_t hipMemPrefetchAsync(const void* dev_ptr, size_t count, int device,
+                               hipStream_t stream) {
+  HIP_INIT_API(hipMemPrefetchAsync, dev_ptr, count, device, stream);
+
+  HIP_RETURN(ihipMemPrefetchAsync({{dev_ptr, count}}, device, stream));
+}
+
+// ================================================================================================
+hipError_t hipExtMemPrefetchBatchAsync(const void* const* dev_ptrs, const size_t* counts,
+                                       size_t numRanges, int device, hipStream_t stream) {
+  HIP_INIT_API(hipExtMemPrefetchBatchAsync, dev_ptrs, counts, numRanges, device, stream);
+
+  if ((dev_ptrs == nullptr) || (counts == nullptr) || (numRanges == 0)) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+
+  // The command coalesces the adjacent and overlapping ranges into a single migration
+  std::vector<amd::SvmPrefetchAsyncCommand::Range> ranges(numRanges);
+  for (size_t i = 0; i < numRanges; ++i) {
+    ranges[i] = {dev_ptrs[i], counts[i]};
+  }
+  HIP_RETURN(ihipMemPrefetchAsync(std::move(ranges), device, stream));
 }
 
 // ================================================================================================
@@ -51,5 +51,7 @@ const char* hipApiName(uint32_t id) { return hip_api_name(id); }
 
 extern "C" void hipRegisterTracerCallback(int (*function)(activity_domain_t domain,
                                                           uint32_t operation_id, void* data)) {
+  // The batched records belong to the previous callback
+  amd::activity_prof::FlushActivity();
   amd::activity_prof::report_activity.store(function, std::memory_order_relaxed);
 }
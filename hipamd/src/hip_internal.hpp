@@ -23,11 +23,16 @@
 
 #include "vdi_common.hpp"
 #include "hip_prof_api.h"
+#include "hip_flight_recorder.hpp"
+#include "hip_phase_profile.hpp"
 #include "trace_helper.h"
 #include "utils/debug.hpp"
 #include "hip_formatting.hpp"
 #include "hip_graph_capture.hpp"
+#include "hip/amd_detail/amd_hip_ext_flags.h"
 
+#include <map>
+#include <unordered_map>
 #include <unordered_set>
 #include <thread>
 #include <stack>
@@ -48,6 +53,13 @@
 #define KCYN "\x1B[36m"
 #define KWHT "\x1B[37m"
 
+#define IHIP_STREAM_WAIT_FLAGS \
+  (hipExtStreamWaitSpin | hipExtStreamWaitBlocking | hipExtStreamWaitAdaptive)
+
+#define IHIP_MALLOC_MALL_FLAGS (hipExtMallocMallPreferred | hipExtMallocMallBypass)
+
+#define IHIP_MALLOC_PAGE_FLAGS (hipExtMallocLargePage2M | hipExtMallocLargePage1G)
+
 /*! IHIP IPC MEMORY Structure */
 #define IHIP_IPC_MEM_HANDLE_SIZE   32
 #define IHIP_IPC_MEM_RESERVED_SIZE LP64_SWITCH(20,12)
@@ -144,6 +156,7 @@ const char* ihipGetErrorName(hipError_t hip_error);
           __func__, hip::ihipGetErrorName(err), ToString( __VA_ARGS__ ).c_str());
 
 #define HIP_INIT_API_INTERNAL(noReturn, cid, ...)                                                  \
+  HIP_PHASE_API(cid)                                                                               \
   amd::Thread* thread = amd::Thread::current();                                                    \
   if (!VDI_CHECK_THREAD(thread)) {                                                                 \
     ClPrint(amd::LOG_NONE, amd::LOG_ALWAYS,                                                        \
@@ -155,7 +168,11 @@ const char* ihipGetErrorName(hipError_t hip_error);
   }                                                                                                \
   HIP_INIT(noReturn)                                                                               \
   HIP_API_PRINT(__VA_ARGS__)                                                                       \
-  HIP_CB_SPAWNER_OBJECT(cid);
+  if (hip::FlightRecorder::enabled()) {                                                            \
+    hip::FlightRecorder::record(HIP_API_ID_##cid, ##__VA_ARGS__);                                  \
+  }                                                                                                \
+  HIP_CB_SPAWNER_OBJECT(cid);                                                                      \
+  HIP_PHASE(Validate)
 
 // This macro should be called at the beginning of every HIP API.
 #define HIP_INIT_API(cid, ...)                                                                     \
@@ -287,6 +304,8 @@ public:
 
   class Device;
   class MemoryPool;
+  class MemoryPoolTrimmer;
+  class CallbackDispatcher;
   class Event;
   class Stream : public amd::HostQueue {
   public:
@@ -298,7 +317,7 @@ public:
     Priority priority_;
     unsigned int flags_;
     bool null_;
-    const std::vector<uint32_t> cuMask_;
+    std::vector<uint32_t> cuMask_;
 
     /// Stream capture related parameters
 
@@ -350,7 +369,12 @@ public:
     /// Returns the priority for the current stream
     Priority GetPriority() const { return priority_; }
     /// Returns the CU mask for the current stream
-    const std::vector<uint32_t> GetCUMask() const { return cuMask_; }
+    const std::vector<uint32_t> GetCUMask() const {
+      amd::ScopedLock lock(lock_);
+      return cuMask_;
+    }
+    /// Changes the CU mask of the stream, created with a custom CU mask, for the next commands
+    bool SetCUMask(const std::vector<uint32_t>& cuMask);
 
     /// Check whether any blocking stream running
     static bool StreamCaptureBlocking();
@@ -466,13 +490,116 @@ public:
       ~Stream() {};
   };
 
+  /// Cache of freed pinned host allocations for reuse in hipHostMalloc() with the same size
+  /// and flags. The total size of cached memory is limited by HIP_HOST_MEM_CACHE_SIZE
+  class HostMemoryCache {
+   public:
+    HostMemoryCache() : lock_(true), total_size_(0) {}
+    ~HostMemoryCache() { ReleaseAll(); }
+
+    /// Returns a cached allocation with the exact size and flags, or nullptr
+    void* Allocate(size_t size, unsigned int flags);
+
+    /// Places the allocation into the cache. False if the allocation can't be cached
+    /// @note The caller must make sure GPU doesn't access the memory
+    bool Free(amd::Memory* memory);
+
+    /// Returns true if the pointer was already released into the cache
+    bool IsCached(void* ptr);
+
+    /// Releases all cached allocations
+    void ReleaseAll();
+
+   private:
+    typedef std::pair<size_t, unsigned int> Key;  //!< Allocation size and HIP flags
+    amd::Monitor lock_;                           //!< Lock for the cache access
+    std::multimap<Key, void*> blocks_;            //!< Cached allocations, bucketed by the key
+    std::unordered_map<void*, Key> cached_;       //!< Lookup of cached pointers
+    size_t total_size_;                           //!< Total size of cached memory
+  };
+
+  /// Central cache of freed small hipMalloc() allocations, which refills the per thread caches.
+  /// The total size of cached memory is limited by HIP_MALLOC_CACHE_SIZE
+  class DeviceMemoryCache {
+   public:
+    DeviceMemoryCache() : lock_(true), total_size_(0) {}
+    ~DeviceMemoryCache() { ReleaseAll(); }
+
+    /// Moves up to count cached allocations of the exact size into the list
+    void Refill(size_t size, size_t count, std::vector<amd::Memory*>* list);
+
+    /// Takes the allocations evicted from a thread cache. Releases the ones above the limit
+    void Drain(std::vector<amd::Memory*>& list);
+
+    /// Releases all cached allocations
+    void ReleaseAll();
+
+   private:
+    amd::Monitor lock_;                             //!< Lock for the cache access
+    std::multimap<size_t, amd::Memory*> blocks_;    //!< Cached allocations, bucketed by size
+    size_t total_size_;                             //!< Total size of cached memory
+  };
+
+  /// Per thread cache of freed small hipMalloc() allocations. The allocations stay registered,
+  /// so the reuse doesn't contend on the device and the global memory object locks.
+  /// The total size of cached memory is limited by HIP_MALLOC_THREAD_CACHE_SIZE
+  class ThreadMemoryCache {
+   public:
+    ThreadMemoryCache() : total_size_(0) {}
+    /// Returns all cached allocations into the central caches
+    ~ThreadMemoryCache();
+
+    /// Returns a cached allocation with the exact size on the device, or nullptr
+    void* Allocate(int device_id, size_t size);
+
+    /// Places the allocation into the cache. False if the allocation can't be cached
+    /// @note The caller must make sure GPU doesn't access the memory
+    bool Free(amd::Memory* memory);
+
+   private:
+    static constexpr size_t kRefillCount = 8;  //!< Allocations moved from the central cache
+
+    struct Bin {
+      int device_id_;                     //!< Device of the cached allocations
+      size_t size_;                       //!< Size of the cached allocations
+      std::vector<amd::Memory*> blocks_;  //!< Cached allocations
+    };
+
+    /// Moves the allocations from the bins into the central caches, until the limit is met
+    void Drain(size_t limit);
+
+    std::vector<Bin> bins_;  //!< Cache bins, usually just a few sizes per thread
+    size_t total_size_;      //!< Total size of cached memory
+  };
+
   /// HIP Device class
   class Device : public amd::ReferenceCountedObject {
     // Device lock
     amd::Monitor lock_{true};
-    // Guards device stream set
-    amd::Monitor streamSetLock{};
-    std::unordered_set<hip::Stream*> streamSet;
+    /// Streams of the device, sharded by the stream address, so stream creation, destruction
+    /// and device wide syncs of unrelated streams don't serialize on a single lock
+    static constexpr size_t kStreamSetShards = 16;
+    struct StreamSetShard {
+      amd::Monitor lock_{};                      //!< Guards the shard
+      std::unordered_set<hip::Stream*> streams_;  //!< Streams, which belong to the shard
+    };
+    StreamSetShard streamSet_[kStreamSetShards];
+    StreamSetShard& GetStreamSetShard(const Stream* stream) {
+      uintptr_t ptr = reinterpret_cast<uintptr_t>(stream);
+      return streamSet_[((ptr >> 6) ^ (ptr >> 12)) % kStreamSetShards];
+    }
+    /// Calls func for every stream under its shard lock and stops when func returns true
+    template <typename F> bool FindStream(F func) {
+      for (auto& shard : streamSet_) {
+        amd::ScopedLock lock(shard.lock_);
+        for (auto stream : shard.streams_) {
+          if (func(stream)) {
+            return true;
+          }
+        }
+      }
+      return false;
+    }
     /// ROCclr context
     amd::Context* context_;
     /// Device's ID
@@ -494,6 +621,15 @@ public:
     MemoryPool* graph_mem_pool_;    //!< Memory pool, associated with graphs for this device
 
     std::set<MemoryPool*> mem_pools_;
+    MemoryPoolTrimmer* pool_trimmer_ = nullptr;  //!< Background trim thread for memory pools
+    CallbackDispatcher* callback_dispatcher_ = nullptr;  //!< Completion thread for callbacks
+    HostMemoryCache host_mem_cache_;  //!< Cache of freed pinned host memory
+    DeviceMemoryCache mem_cache_;     //!< Central cache of freed small device memory
+
+    /// Per-thread default streams of the exited threads, handed out again to the new threads
+    static constexpr size_t kMaxParkedStreams = 64;
+    amd::Monitor parked_lock_{};           //!< Guards parked_streams_
+    std::vector<Stream*> parked_streams_;  //!< Idle per-thread default streams
 
   public:
     Device(amd::Context* ctx, int devId): context_(ctx),
@@ -567,6 +703,12 @@ public:
     /// Get the graph memory pool on the device
     MemoryPool* GetGraphMemoryPool() const { return graph_mem_pool_; }
 
+    /// Get the cache of freed pinned host memory
+    HostMemoryCache& GetHostMemoryCache() { return host_mem_cache_; }
+
+    /// Get the central cache of freed small device memory
+    DeviceMemoryCache& GetMemoryCache() { return mem_cache_; }
+
     /// Add memory pool to the device
     void AddMemoryPool(MemoryPool* pool);
 
@@ -579,6 +721,15 @@ public:
     /// Release freed memory from all pools on the current device
     void ReleaseFreedMemory();
 
+    /// Trims aged memory in idle pools on the current device
+    void TrimIdleMemoryPools();
+
+    /// Returns the completion thread for stream callbacks, nullptr if callbacks run inline
+    CallbackDispatcher* GetCallbackDispatcher() const { return callback_dispatcher_; }
+
+    /// Waits for the stream callbacks, dispatched to the completion thread so far
+    void WaitCallbacks();
+
     /// Removes a destroyed stream from the safe list of memory pools
     void RemoveStreamFromPools(Stream* stream);
 
@@ -593,6 +744,13 @@ public:
 
     bool StreamExists(Stream* stream);
 
+    /// Keeps the per-thread default stream of an exited thread for reuse.
+    /// Returns false if the pool is full and the caller must destroy the stream
+    bool ParkPerThreadStream(Stream* stream);
+
+    /// Returns a parked per-thread default stream, nullptr if none is available
+    Stream* UnparkPerThreadStream();
+
     void destroyAllStreams();
 
     void SyncAllStreams( bool cpu_wait = true);
@@ -615,6 +773,7 @@ public:
     hipStreamCaptureMode stream_capture_mode_;
     std::stack<ihipExec_t> exec_stack_;
     stream_per_thread stream_per_thread_obj_;
+    ThreadMemoryCache mem_cache_;
 
     TlsAggregator(): device_(nullptr),
       last_error_(hipSuccess),
@@ -630,6 +789,9 @@ public:
 
   extern void init(bool* status);
 
+  /// Registers the built-in trace exporter, if HIP_TRACE_EXPORT_FILE is set
+  extern void initTraceExport();
+
   extern Device* getCurrentDevice();
 
   extern void setCurrentDevice(unsigned int index);
@@ -663,6 +825,7 @@ public:
   extern void getStreamPerThread(hipStream_t& stream);
   extern hipStream_t getPerThreadDefaultStream();
   extern hipError_t ihipUnbindTexture(textureReference* texRef);
+  extern void ihipReleaseTextureViews(amd::Image* image);
   extern hipError_t ihipHostRegister(void* hostPtr, size_t sizeBytes, unsigned int flags);
   extern hipError_t ihipHostUnregister(void* hostPtr);
   extern hipError_t ihipGetDeviceProperties(hipDeviceProp_t* props, hipDevice_t device);
@@ -22,18 +22,32 @@
 #include "hip_internal.hpp"
 #include "hip_platform.hpp"
 #include "hip_conversions.hpp"
+#include "hip_vm.hpp"
 #include "platform/context.hpp"
 #include "platform/command.hpp"
 #include "platform/memory.hpp"
 #include "platform/external_memory.hpp"
+#include "utils/metrics.hpp"
 namespace hip {
 
 // Guards global hipArray set
 amd::Monitor hipArraySetLock{};
 std::unordered_set<hipArray*> hipArraySet;
 
+// The opened IPC memory handles. Reopening a known handle on the same device is a lookup,
+// the import and the mapping happen only on the first open and the unmap on the last close.
+struct IpcOpenEntry {
+  void* dev_ptr_;   //!< The mapped pointer of the handle
+  uint32_t refs_;   //!< The number of the opens without a close
+};
+using IpcOpenKey = std::pair<std::string, int>;  //!< The handle bytes and the device
+amd::Monitor ipcOpenLock{};
+std::map<IpcOpenKey, IpcOpenEntry> ipcOpenCache;
+std::unordered_map<void*, IpcOpenKey> ipcOpenPtrs;
+
 // ================================================================================================
 amd::Memory* getMemoryObject(const void* ptr, size_t& offset, size_t size) {
+  HIP_PHASE_SCOPE(PointerLookup)
   auto memObj = amd::MemObjMap::FindMemObj(ptr, &offset);
   if (memObj == nullptr) {
     // If memObj not found, use arena_mem_obj. arena_mem_obj is null, if HMM is disabled.
@@ -75,12 +89,19 @@ hipError_t ihipFree(void *ptr) {
   size_t offset = 0;
   amd::Memory* memory_object = getMemoryObject(ptr, offset);
   if (memory_object != nullptr) {
+    if (memory_object->getUserData().cached_) {
+      // The memory was already released into the thread cache
+      return hipErrorInvalidValue;
+    }
     // Wait on the device, associated with the current memory object during allocation
     auto device_id = memory_object->getUserData().deviceId;
     g_devices[device_id]->SyncAllStreams();
 
     // Find out if memory belongs to any memory pool
     if (!g_devices[device_id]->FreeMemory(memory_object, nullptr)) {
+      if ((offset == 0) && hip::tls.mem_cache_.Free(memory_object)) {
+        return hipSuccess;
+      }
       // External mem is not svm.
       if (memory_object->isInterop()) {
         amd::MemObjMap::RemoveMemObj(ptr);
@@ -314,6 +335,15 @@ hipError_t ihipMalloc(void** ptr, size_t sizeBytes, unsigned int flags)
   const auto& dev_info = amdContext->devices()[0]->info();
   hip::getCurrentDevice()->SetActiveStatus();
 
+  if (flags == 0) {
+    // Memory released earlier on this thread avoids the allocation and registration locks
+    *ptr = hip::tls.mem_cache_.Allocate(hip::getCurrentDevice()->deviceId(), sizeBytes);
+    if (*ptr != nullptr) {
+      amd::Metrics::add(amd::Metrics::HipMallocCacheHits);
+      return hipSuccess;
+    }
+  }
+
   if (dev_info.maxPhysicalMemAllocSize_ < sizeBytes) {
     return hipErrorOutOfMemory;
   }
@@ -341,9 +371,211 @@ hipError_t ihipMalloc(void** ptr, size_t sizeBytes, unsigned int flags)
   amd::Memory* memObj = getMemoryObject(*ptr, offset);
   //saves the current device id so that it can be accessed later
   memObj->getUserData().deviceId = hip::getCurrentDevice()->deviceId();
+  memObj->getUserData().cacheable_ = (flags == 0);
   return hipSuccess;
 }
 
+namespace hip {
+// ================================================================================================
+void* HostMemoryCache::Allocate(size_t size, unsigned int flags) {
+  if (HIP_HOST_MEM_CACHE_SIZE == 0) {
+    return nullptr;
+  }
+  amd::ScopedLock lock(lock_);
+  auto it = blocks_.find({size, flags});
+  if (it == blocks_.end()) {
+    return nullptr;
+  }
+  void* ptr = it->second;
+  blocks_.erase(it);
+  cached_.erase(ptr);
+  total_size_ -= size;
+  ClPrint(amd::LOG_INFO, amd::LOG_MEM, "Host memory cache reuse: %p, size %zu", ptr, size);
+  return ptr;
+}
+
+// ================================================================================================
+bool HostMemoryCache::Free(amd::Memory* memory) {
+  const size_t cache_size = static_cast<size_t>(HIP_HOST_MEM_CACHE_SIZE) * Mi;
+  if (cache_size == 0) {
+    return false;
+  }
+  // Only the allocations from hipHostMalloc() can be cached. Registered memory isn't owned
+  if ((&memory->getContext() != hip::host_context) || (memory->parent() != nullptr) ||
+      ((memory->getMemFlags() & CL_MEM_SVM_FINE_GRAIN_BUFFER) == 0) ||
+      ((memory->getMemFlags() & CL_MEM_USE_HOST_PTR) != 0) ||
+      ((memory->getUserData().flags & hipExtHostAllocNumaUser) != 0)) {
+    return false;
+  }
+  const size_t size = memory->getSize();
+  amd::ScopedLock lock(lock_);
+  if ((total_size_ + size) > cache_size) {
+    return false;
+  }
+  void* ptr = memory->getSvmPtr();
+  Key key = {size, memory->getUserData().flags};
+  blocks_.insert({key, ptr});
+  cached_[ptr] = key;
+  total_size_ += size;
+  return true;
+}
+
+// ================================================================================================
+bool HostMemoryCache::IsCached(void* ptr) {
+  amd::ScopedLock lock(lock_);
+  return cached_.find(ptr) != cached_.end();
+}
+
+// ================================================================================================
+void HostMemoryCache::ReleaseAll() {
+  amd::ScopedLock lock(lock_);
+  for (const auto& it : blocks_) {
+    amd::SvmBuffer::free(*hip::host_context, it.second);
+  }
+  blocks_.clear();
+  cached_.clear();
+  total_size_ = 0;
+}
+
+// ================================================================================================
+void DeviceMemoryCache::Refill(size_t size, size_t count, std::vector<amd::Memory*>* list) {
+  amd::ScopedLock lock(lock_);
+  auto range = blocks_.equal_range(size);
+  for (auto it = range.first; (it != range.second) && (count > 0); --count) {
+    list->push_back(it->second);
+    total_size_ -= size;
+    it = blocks_.erase(it);
+  }
+}
+
+// ================================================================================================
+void DeviceMemoryCache::Drain(std::vector<amd::Memory*>& list) {
+  const size_t cache_size = static_cast<size_t>(HIP_MALLOC_CACHE_SIZE) * Mi;
+  std::vector<amd::Memory*> evicted;
+  {
+    amd::ScopedLock lock(lock_);
+    for (auto memory : list) {
+      const size_t size = memory->getSize();
+      if ((total_size_ + size) > cache_size) {
+        evicted.push_back(memory);
+      } else {
+        blocks_.insert({size, memory});
+        total_size_ += size;
+      }
+    }
+  }
+  list.clear();
+  // Release the memory outside of the cache lock
+  for (auto memory : evicted) {
+    amd::SvmBuffer::free(memory->getContext(), memory->getSvmPtr());
+  }
+}
+
+// ================================================================================================
+void DeviceMemoryCache::ReleaseAll() {
+  amd::ScopedLock lock(lock_);
+  for (const auto& it : blocks_) {
+    amd::SvmBuffer::free(it.second->getContext(), it.second->getSvmPtr());
+  }
+  blocks_.clear();
+  total_size_ = 0;
+}
+
+// ================================================================================================
+ThreadMemoryCache::~ThreadMemoryCache() {
+  Drain(0);
+}
+
+// ================================================================================================
+void* ThreadMemoryCache::Allocate(int device_id, size_t size) {
+  if ((HIP_MALLOC_THREAD_CACHE_SIZE == 0) ||
+      (size > (static_cast<size_t>(HIP_MALLOC_CACHE_MAX_ALLOC) * Ki))) {
+    return nullptr;
+  }
+  auto bin = std::find_if(bins_.begin(), bins_.end(), [&](const Bin& bin) {
+      return (bin.device_id_ == device_id) && (bin.size_ == size); });
+  if (bin == bins_.end()) {
+    std::vector<amd::Memory*> blocks;
+    g_devices[device_id]->GetMemoryCache().Refill(size, kRefillCount, &blocks);
+    if (blocks.empty()) {
+      return nullptr;
+    }
+    total_size_ += blocks.size() * size;
+    bins_.push_back({device_id, size, std::move(blocks)});
+    bin = bins_.end() - 1;
+  } else if (bin->blocks_.empty()) {
+    // Refill the bin in a batch, so the central cache lock is taken rarely
+    g_devices[device_id]->GetMemoryCache().Refill(size, kRefillCount, &bin->blocks_);
+    total_size_ += bin->blocks_.size() * size;
+    if (bin->blocks_.empty()) {
+      return nullptr;
+    }
+  }
+  amd::Memory* memory = bin->blocks_.back();
+  bin->blocks_.pop_back();
+  total_size_ -= size;
+  memory->getUserData().cached_ = false;
+  ClPrint(amd::LOG_INFO, amd::LOG_MEM, "Thread memory cache reuse: %p, size %zu",
+          memory->getSvmPtr(), size);
+  return memory->getSvmPtr();
+}
+
+// ================================================================================================
+bool ThreadMemoryCache::Free(amd::Memory* memory) {
+  const size_t cache_size = static_cast<size_t>(HIP_MALLOC_THREAD_CACHE_SIZE) * Ki;
+  const size_t size = memory->getSize();
+  if ((cache_size == 0) || !memory->getUserData().cacheable_ ||
+      (size > (static_cast<size_t>(HIP_MALLOC_CACHE_MAX_ALLOC) * Ki))) {
+    return false;
+  }
+  const int device_id = memory->getUserData().deviceId;
+  auto bin = std::find_if(bins_.begin(), bins_.end(), [&](const Bin& bin) {
+      return (bin.device_id_ == device_id) && (bin.size_ == size); });
+  if (bin == bins_.end()) {
+    bins_.push_back({device_id, size, {}});
+    bin = bins_.end() - 1;
+  }
+
+  // Drop the attributes, which the application could set on the released memory
+  amd::Memory::UserData user_data;
+  user_data.deviceId = device_id;
+  user_data.cacheable_ = true;
+  user_data.cached_ = true;
+  memory->getUserData() = user_data;
+
+  bin->blocks_.push_back(memory);
+  total_size_ += size;
+  if (total_size_ > cache_size) {
+    // Return a half of the cache back to the central cache
+    Drain(cache_size / 2);
+  }
+  return true;
+}
+
+// ================================================================================================
+void ThreadMemoryCache::Drain(size_t limit) {
+  std::vector<amd::Memory*> list;
+  for (auto& bin : bins_) {
+    if (total_size_ <= limit) {
+      break;
+    }
+    // Evict the oldest allocations first
+    auto end = bin.blocks_.begin();
+    while ((end != bin.blocks_.end()) && (total_size_ > limit)) {
+      list.push_back(*end++);
+      total_size_ -= bin.size_;
+    }
+    bin.blocks_.erase(bin.blocks_.begin(), end);
+    if (!list.empty() && (static_cast<size_t>(bin.device_id_) < g_devices.size())) {
+      g_devices[bin.device_id_]->GetMemoryCache().Drain(list);
+    }
+    list.clear();
+  }
+  bins_.erase(std::remove_if(bins_.begin(), bins_.end(), [](const Bin& bin) {
+      return bin.blocks_.empty(); }), bins_.end());
+}
+} // namespace hip
+
 // ================================================================================================
 hipError_t ihipHostMalloc(void** ptr, size_t sizeBytes, unsigned int flags)
 {
@@ -382,6 +614,16 @@ hipError_t ihipHostMalloc(void** ptr, size_t sizeBytes, unsigned int flags)
     ihipFlags &= ~CL_MEM_SVM_ATOMICS;
   }
 
+  if (flags & hipExtHostAllocLargePage) {
+    ihipFlags |= ROCCLR_MEM_LARGE_PAGE_2M;
+  }
+
+  // Pinned memory with the same size and flags, released earlier, avoids a new pin
+  *ptr = hip::getCurrentDevice()->GetHostMemoryCache().Allocate(sizeBytes, flags);
+  if (*ptr != nullptr) {
+    return hipSuccess;
+  }
+
   hipError_t status = ihipMalloc(ptr, sizeBytes, ihipFlags);
 
   if ((status == hipSuccess) && ((*ptr) != nullptr)) {
@@ -606,6 +848,166 @@ void ihipHtoHMemcpy(void* dst, const void* src, size_t sizeBytes, hip::Stream& s
   memcpy(dst, src, sizeBytes);
 }
 
+namespace {
+//! Pinned staging buffers of the pageable async copies. The buffers return to the pool from
+//! the completion callbacks, hence the pool never calls into the runtime under its lock
+class PageableStagingPool {
+ public:
+  //! Returns a pinned buffer of at least the requested size
+  void* Acquire(size_t size, size_t* allocSize) {
+    *allocSize = amd::alignUp(size, kGranularity);
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      auto it = idle_.lower_bound(*allocSize);
+      if (it != idle_.end()) {
+        void* buffer = it->second;
+        *allocSize = it->first;
+        idleSize_ -= it->first;
+        idle_.erase(it);
+        return buffer;
+      }
+    }
+    void* buffer = nullptr;
+    if (ihipHostMalloc(&buffer, *allocSize, 0) != hipSuccess) {
+      return nullptr;
+    }
+    return buffer;
+  }
+
+  //! Keeps the buffer for the next copies. Returns false if the pool is full
+  bool Release(void* buffer, size_t allocSize) {
+    std::lock_guard<std::mutex> lock(lock_);
+    if ((idleSize_ + allocSize) > (static_cast<size_t>(HIP_PAGEABLE_ASYNC_CACHE) * Mi)) {
+      return false;
+    }
+    idle_.emplace(allocSize, buffer);
+    idleSize_ += allocSize;
+    return true;
+  }
+
+  //! Frees the buffers, which didn't fit into the pool. Called outside of the callbacks
+  void Trim() {
+    std::vector<void*> buffers;
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      buffers.swap(overflow_);
+    }
+    for (auto buffer : buffers) {
+      // The last copy with the buffer is done, hence skip the stream sync of ihipFree()
+      size_t offset = 0;
+      amd::Memory* memory = getMemoryObject(buffer, offset);
+      if (memory != nullptr) {
+        amd::SvmBuffer::free(memory->getContext(), buffer);
+      }
+    }
+  }
+
+  //! Defers the free of a buffer, since the completion callback can't wait for the streams
+  void Defer(void* buffer) {
+    std::lock_guard<std::mutex> lock(lock_);
+    overflow_.push_back(buffer);
+  }
+
+ private:
+  static constexpr size_t kGranularity = 1 * Mi;  //!< Rounding of the buffer sizes
+  std::mutex lock_;                    //!< Guards the lists below
+  std::multimap<size_t, void*> idle_;  //!< Idle buffers, keyed by the size
+  std::vector<void*> overflow_;        //!< Buffers to free, which didn't fit the pool
+  size_t idleSize_ = 0;                //!< Total size of the idle buffers
+};
+
+PageableStagingPool pageableStagingPool;
+
+//! A host side step of the pageable async copy, executed in the stream order
+struct PageableCopyStep {
+  void* dst_;         //!< Destination of the host copy, nullptr if only the release is done
+  const void* src_;   //!< Source of the host copy
+  size_t size_;       //!< Size of the host copy
+  void* staging_;     //!< Staging buffer to return to the pool after the step
+  size_t allocSize_;  //!< Size of the staging buffer
+};
+
+// ================================================================================================
+void CL_CALLBACK ihipPageableCopyCallback(cl_event event, cl_int status, void* user_data) {
+  auto step = reinterpret_cast<PageableCopyStep*>(user_data);
+  if (step->dst_ != nullptr) {
+    memcpy(step->dst_, step->src_, step->size_);
+  }
+  if ((step->staging_ != nullptr) &&
+      !pageableStagingPool.Release(step->staging_, step->allocSize_)) {
+    pageableStagingPool.Defer(step->staging_);
+  }
+  delete step;
+}
+
+// ================================================================================================
+hipError_t ihipEnqueuePageableCopyStep(hip::Stream& stream, PageableCopyStep* step, bool block) {
+  amd::Command* last_command = stream.getLastQueuedCommand(true);
+  amd::Command::EventWaitList waitList;
+  if (last_command != nullptr) {
+    waitList.push_back(last_command);
+  }
+  amd::Command* command = new amd::Marker(stream, !kMarkerDisableFlush, waitList);
+  if (last_command != nullptr) {
+    last_command->release();
+  }
+  if (command == nullptr) {
+    delete step;
+    return hipErrorOutOfMemory;
+  }
+  // The callback runs directly, not on the callback thread, so the marker completes after it
+  if (!command->setCallback(CL_COMPLETE, ihipPageableCopyCallback, step)) {
+    command->release();
+    delete step;
+    return hipErrorOutOfMemory;
+  }
+  command->enqueue();
+  if (block) {
+    // Stall the stream until the host copy is done, as the stream callbacks do
+    waitList.clear();
+    waitList.push_back(command);
+    amd::Command* block_command = new amd::Marker(stream, !kMarkerDisableFlush, waitList);
+    if (block_command != nullptr) {
+      block_command->enqueue();
+      block_command->notifyCmdQueue();
+      block_command->release();
+    }
+  }
+  command->release();
+  return hipSuccess;
+}
+
+// ================================================================================================
+//! Copies between pageable host memory and the device without the wait in the calling thread.
+//! The host copy into or out of a pinned staging buffer runs on the completion thread in the
+//! stream order. Returns false if the copy must take the regular path
+bool ihipMemcpyPageableAsync(void* dst, const void* src, size_t sizeBytes, hipMemcpyKind kind,
+                             hip::Stream& stream, bool toDevice, hipError_t* status) {
+  pageableStagingPool.Trim();
+  size_t allocSize = 0;
+  void* staging = pageableStagingPool.Acquire(sizeBytes, &allocSize);
+  if (staging == nullptr) {
+    return false;
+  }
+  if (toDevice) {
+    *status = ihipEnqueuePageableCopyStep(stream,
+        new PageableCopyStep{staging, src, sizeBytes, nullptr, 0}, true);
+    if (*status == hipSuccess) {
+      *status = ihipMemcpy(dst, staging, sizeBytes, kind, stream, true);
+    }
+    // Return the buffer after the DMA, the stream doesn't need to wait for it
+    ihipEnqueuePageableCopyStep(stream,
+        new PageableCopyStep{nullptr, nullptr, 0, staging, allocSize}, false);
+  } else {
+    *status = ihipMemcpy(staging, src, sizeBytes, kind, stream, true);
+    ihipEnqueuePageableCopyStep(stream,
+        new PageableCopyStep{(*status == hipSuccess) ? dst : nullptr, staging, sizeBytes,
+                             staging, allocSize}, true);
+  }
+  return true;
+}
+}  // namespace
+
 // ================================================================================================
 hipError_t ihipMemcpy(void* dst, const void* src, size_t sizeBytes, hipMemcpyKind kind,
                       hip::Stream& stream, bool isHostAsync, bool isGPUAsync) {
@@ -630,6 +1032,11 @@ hipError_t ihipMemcpy(void* dst, const void* src, size_t sizeBytes, hipMemcpyKin
     return hipSuccess;
   } else if (((srcMemory == nullptr) && (dstMemory != nullptr)) ||
              ((srcMemory != nullptr) && (dstMemory == nullptr))) {
+    if (HIP_PAGEABLE_ASYNC_COPY && isHostAsync && isGPUAsync &&
+        ihipMemcpyPageableAsync(dst, src, sizeBytes, kind, stream, (srcMemory == nullptr),
+                                &status)) {
+      return status;
+    }
     // Don't wait for unpinned H2D copy if staging is used for copy
     isHostAsync &= ((srcMemory == nullptr) && (dstMemory != nullptr) && AMD_DIRECT_DISPATCH &&
       (sizeBytes <= stream.device().settings().stagedXferSize_)) ? true : false;
@@ -645,11 +1052,13 @@ hipError_t ihipMemcpy(void* dst, const void* src, size_t sizeBytes, hipMemcpyKin
     }
   }
 
+  HIP_PHASE(Command)
   amd::Command* command = nullptr;
   status = ihipMemcpyCommand(command, dst, src, sizeBytes, kind, stream, isHostAsync);
   if (status != hipSuccess) {
     return status;
   }
+  HIP_PHASE(Submit)
   command->enqueue();
   if (!isHostAsync) {
     command->queue()->finish();
@@ -686,23 +1095,45 @@ hipError_t ihipMemcpy(void* dst, const void* src, size_t sizeBytes, hipMemcpyKin
 hipError_t hipExtMallocWithFlags(void** ptr, size_t sizeBytes, unsigned int flags) {
   HIP_INIT_API(hipExtMallocWithFlags, ptr, sizeBytes, flags);
 
+  // The MALL hints combine with any allocation kind, but exclude each other
+  const unsigned int mallFlags = flags & IHIP_MALLOC_MALL_FLAGS;
+  if (mallFlags == IHIP_MALLOC_MALL_FLAGS) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  // The page hints combine with any allocation kind except the signal memory
+  const unsigned int pageFlags = flags & IHIP_MALLOC_PAGE_FLAGS;
+  if (pageFlags == IHIP_MALLOC_PAGE_FLAGS) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  const unsigned int kind = flags & ~(IHIP_MALLOC_MALL_FLAGS | IHIP_MALLOC_PAGE_FLAGS);
+
   unsigned int ihipFlags = 0;
-  if (flags == hipDeviceMallocDefault) {
+  if (kind == hipDeviceMallocDefault) {
     ihipFlags = 0;
-  } else if (flags == hipDeviceMallocFinegrained) {
+  } else if (kind == hipDeviceMallocFinegrained) {
     ihipFlags = CL_MEM_SVM_ATOMICS;
-  } else if (flags == hipDeviceMallocUncached) {
+  } else if (kind == hipDeviceMallocUncached) {
     ihipFlags = CL_MEM_SVM_ATOMICS | ROCCLR_MEM_HSA_UNCACHED;
-  } else if (flags == hipDeviceMallocContiguous) {
+  } else if (kind == hipDeviceMallocContiguous) {
     ihipFlags = ROCCLR_MEM_HSA_CONTIGUOUS | ROCCLR_MEM_HSA_UNCACHED;
-  } else if (flags == hipMallocSignalMemory) {
+  } else if (kind == hipMallocSignalMemory) {
     ihipFlags = CL_MEM_SVM_ATOMICS | CL_MEM_SVM_FINE_GRAIN_BUFFER | ROCCLR_MEM_HSA_SIGNAL_MEMORY;
-    if (sizeBytes != 8) {
+    if ((sizeBytes != 8) || (pageFlags != 0)) {
       HIP_RETURN(hipErrorInvalidValue);
     }
   } else {
     HIP_RETURN(hipErrorInvalidValue);
   }
+  if (mallFlags == hipExtMallocMallPreferred) {
+    ihipFlags |= ROCCLR_MEM_MALL_PREFERRED;
+  } else if (mallFlags == hipExtMallocMallBypass) {
+    ihipFlags |= ROCCLR_MEM_MALL_BYPASS;
+  }
+  if (pageFlags == hipExtMallocLargePage2M) {
+    ihipFlags |= ROCCLR_MEM_LARGE_PAGE_2M;
+  } else if (pageFlags == hipExtMallocLargePage1G) {
+    ihipFlags |= ROCCLR_MEM_LARGE_PAGE_1G;
+  }
 
   hipError_t status = ihipMalloc(ptr, sizeBytes, ihipFlags);
 
@@ -814,6 +1245,19 @@ hipError_t hipHostFree(void* ptr) {
     if (memory_object->getSvmPtr() == nullptr) {
       HIP_RETURN(hipErrorInvalidValue);
     }
+    if ((HIP_HOST_MEM_CACHE_SIZE != 0) && (offset == 0)) {
+      auto device = g_devices[memory_object->getUserData().deviceId];
+      auto& cache = device->GetHostMemoryCache();
+      if (cache.IsCached(ptr)) {
+        // The memory was already released
+        HIP_RETURN(hipErrorInvalidValue);
+      }
+      // Keep the implicit synchronization of hipHostFree() before the memory can be reused
+      device->SyncAllStreams();
+      if (cache.Free(memory_object)) {
+        HIP_RETURN(hipSuccess);
+      }
+    }
   }
   HIP_RETURN(ihipFree(ptr));
 }
@@ -838,7 +1282,17 @@ hipError_t ihipArrayDestroy(hipArray_t array) {
   auto image = as_amd(memObj);
   // Wait on the device, associated with the current memory object during allocation
   g_devices[image->getUserData().deviceId]->SyncAllStreams();
+  // The cached texture views hold a reference of the array image
+  ihipReleaseTextureViews(image->asImage());
+  amd::Memory* vaRange = (array->flags & hipArraySparse) ? image->parent() : nullptr;
   image->release();
+  if (vaRange != nullptr) {
+    // Free the reserved VA range of the sparse array, as hipMemAddressFree() does
+    if (!vaRange->getContext().devices()[0]->virtualFree(vaRange->getSvmPtr())) {
+      LogPrintfError("Cannot free the VA range of the sparse array %p", array);
+    }
+    vaRange->release();
+  }
 
   delete array;
   return hipSuccess;
@@ -1148,7 +1602,7 @@ hipError_t ihipArrayCreate(hipArray_t* array,
     return hipErrorInvalidValue;
   }
   unsigned int flags = hipArrayDefault | hipArrayLayered | hipArraySurfaceLoadStore |
-                       hipArrayTextureGather; // hipArrayCubemap isn't supported
+                       hipArrayTextureGather | hipArraySparse; // hipArrayCubemap isn't supported
   if (pAllocateArray->Flags & (~flags)) {
     return hipErrorInvalidValue;
   }
@@ -1160,10 +1614,34 @@ hipError_t ihipArrayCreate(hipArray_t* array,
 
   const cl_channel_order channelOrder = hip::getCLChannelOrder(pAllocateArray->NumChannels, 0);
   const cl_channel_type channelType = hip::getCLChannelType(pAllocateArray->Format, hipReadModeElementType);
-  const cl_mem_object_type imageType = hip::getCLMemObjectType(pAllocateArray->Width,
-                                                               pAllocateArray->Height,
-                                                               pAllocateArray->Depth,
-                                                               pAllocateArray->Flags);
+  cl_mem_object_type imageType = hip::getCLMemObjectType(pAllocateArray->Width,
+                                                         pAllocateArray->Height,
+                                                         pAllocateArray->Depth,
+                                                         pAllocateArray->Flags);
+  // A sparse array is a linear 2D image over a reserved VA range. The rows of the image are
+  // bound to the physical memory later, hence the tiles of the array don't need the memory.
+  amd::Memory* vaRange = nullptr;
+  size_t rowPitch = 0;
+  if (pAllocateArray->Flags & hipArraySparse) {
+    if ((pAllocateArray->Depth > 0) || (numMipmapLevels > 1) ||
+        (pAllocateArray->Flags & hipArrayLayered)) {
+      return hipErrorNotSupported;
+    }
+    amd::Device* device = hip::getCurrentDevice()->devices()[0];
+    const auto& info = device->info();
+    const size_t height = std::max<size_t>(pAllocateArray->Height, 1);
+    const hipChannelFormatDesc desc = hip::getChannelFormatDesc(pAllocateArray->NumChannels,
+                                                                pAllocateArray->Format);
+    rowPitch = amd::alignUp(pAllocateArray->Width * hip::getElementSize(desc),
+                            info.imagePitchAlignment_);
+    const size_t size = amd::alignUp(rowPitch * height, info.virtualMemAllocGranularity_);
+    void* ptr = device->virtualAlloc(nullptr, size, info.virtualMemAllocGranularity_);
+    if (ptr == nullptr) {
+      return hipErrorOutOfMemory;
+    }
+    vaRange = amd::MemObjMap::FindVirtualMemObj(ptr);
+    imageType = CL_MEM_OBJECT_IMAGE2D;
+  }
   hipError_t status = hipSuccess;
   amd::Image* image = ihipImageCreate(channelOrder,
                                       channelType,
@@ -1173,13 +1651,17 @@ hipError_t ihipArrayCreate(hipArray_t* array,
                                       pAllocateArray->Depth,
                                       // The number of layers is determined by the depth extent.
                                       pAllocateArray->Depth, /* array size */
-                                      0, /* row pitch */
+                                      rowPitch, /* row pitch */
                                       0, /* slice pitch */
                                       numMipmapLevels, 0,
-                                      nullptr, /* buffer */
+                                      vaRange, /* buffer */
                                       status);
 
   if (image == nullptr) {
+    if (vaRange != nullptr) {
+      vaRange->getContext().devices()[0]->virtualFree(vaRange->getSvmPtr());
+      vaRange->release();
+    }
     return status;
   }
 
@@ -1612,6 +2094,118 @@ hipError_t hipMemcpyAsync_spt(void* dst, const void* src, size_t sizeBytes,
   HIP_RETURN_DURATION(hipMemcpyAsync_common(dst, src, sizeBytes, kind, stream));
 }
 
+// ================================================================================================
+hipError_t hipExtMemcpyBatchAsync(void** dsts, const void** srcs, const size_t* sizes,
+                                  size_t count, hipStream_t stream) {
+  HIP_INIT_API(hipExtMemcpyBatchAsync, dsts, srcs, sizes, count, stream);
+
+  if ((count != 0) && ((dsts == nullptr) || (srcs == nullptr) || (sizes == nullptr))) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  if (!hip::isValid(stream)) {
+    HIP_RETURN(hipErrorContextIsDestroyed);
+  }
+  hip::Stream* hip_stream = hip::getStream(stream);
+  if (hip_stream == nullptr) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+
+  // Only the ROCr backend has the batch blit and the graph capture records a node per copy
+  amd::Device* queueDevice = &hip_stream->device();
+  const bool batch = queueDevice->settings().rocr_backend_ &&
+                     (hip_stream->GetCaptureStatus() == hipStreamCaptureStatusNone);
+
+  std::vector<amd::CopyMemoryBatchCommand::Copy> copies;
+  for (size_t i = 0; i < count; ++i) {
+    if (sizes[i] == 0) {
+      continue;
+    }
+    hipError_t status = ihipMemcpy_validate(dsts[i], srcs[i], sizes[i], hipMemcpyDefault);
+    if (status != hipSuccess) {
+      HIP_RETURN(status);
+    }
+    size_t sOffset = 0;
+    amd::Memory* srcMemory = getMemoryObject(srcs[i], sOffset);
+    size_t dOffset = 0;
+    amd::Memory* dstMemory = getMemoryObject(dsts[i], dOffset);
+    if (batch && (ihipGetMemcpyType(srcs[i], dsts[i], hipMemcpyDefault) == hipCopyBuffer) &&
+        (srcMemory->GetDeviceById() == queueDevice) &&
+        (dstMemory->GetDeviceById() == queueDevice)) {
+      copies.push_back({srcMemory, dstMemory, sOffset, dOffset, sizes[i]});
+    } else {
+      // The copies aren't ordered within the batch, so the rest can go first
+      status = hipMemcpyAsync_common(dsts[i], srcs[i], sizes[i], hipMemcpyDefault, stream);
+      if (status != hipSuccess) {
+        HIP_RETURN(status);
+      }
+    }
+  }
+
+  if (!copies.empty()) {
+    amd::Command::EventWaitList waitList;
+    amd::Command* command = new amd::CopyMemoryBatchCommand(*hip_stream, waitList,
+                                                            std::move(copies));
+    if (command == nullptr) {
+      HIP_RETURN(hipErrorOutOfMemory);
+    }
+    command->enqueue();
+    command->release();
+  }
+  HIP_RETURN(hipSuccess);
+}
+
+// ================================================================================================
+hipError_t hipExtMemcpyFromFileAsync(void* dst, int fd, uint64_t fileOffset, size_t sizeBytes,
+                                     hipStream_t stream) {
+  HIP_INIT_API(hipExtMemcpyFromFileAsync, dst, fd, fileOffset, sizeBytes, stream);
+
+#if defined(__linux__)
+  if (sizeBytes == 0) {
+    HIP_RETURN(hipSuccess);
+  }
+  if ((dst == nullptr) || (fd < 0)) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  if (!hip::isValid(stream)) {
+    HIP_RETURN(hipErrorContextIsDestroyed);
+  }
+  hip::Stream* hip_stream = hip::getStream(stream);
+  if (hip_stream == nullptr) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  // The file read runs at the command submission, which a graph can't replay
+  if (hip_stream->GetCaptureStatus() != hipStreamCaptureStatusNone) {
+    HIP_RETURN(hipErrorStreamCaptureUnsupported);
+  }
+  // Only the ROCr backend streams files through the staging ring
+  if (!hip_stream->device().settings().rocr_backend_) {
+    HIP_RETURN(hipErrorNotSupported);
+  }
+
+  size_t offset = 0;
+  amd::Memory* dstMemory = getMemoryObject(dst, offset);
+  if ((dstMemory == nullptr) || ((offset + sizeBytes) > dstMemory->getSize())) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+
+  amd::Command::EventWaitList waitList;
+  amd::CopyFileToMemoryCommand* command = new amd::CopyFileToMemoryCommand(
+      *hip_stream, waitList, *dstMemory, offset, fd, fileOffset, sizeBytes);
+  if (command == nullptr) {
+    HIP_RETURN(hipErrorOutOfMemory);
+  }
+  if (!command->validateMemory()) {
+    delete command;
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  command->enqueue();
+  command->release();
+  HIP_RETURN(hipSuccess);
+#else
+  HIP_RETURN(hipErrorNotSupported);
+#endif
+}
+
 hipError_t hipMemcpyHtoDAsync(hipDeviceptr_t dstDevice, void* srcHost, size_t ByteCount,
                               hipStream_t stream) {
   HIP_INIT_API(hipMemcpyHtoDAsync, dstDevice, srcHost, ByteCount, stream);
@@ -3424,6 +4018,64 @@ hipError_t hipMemsetAsync_spt(void* dst, int value, size_t sizeBytes, hipStream_
   HIP_RETURN(hipMemsetAsync_common(dst, value, sizeBytes, stream));
 }
 
+// ================================================================================================
+hipError_t hipExtMemsetBatchAsync(void** dsts, const int* values, const size_t* sizes,
+                                  size_t count, hipStream_t stream) {
+  HIP_INIT_API(hipExtMemsetBatchAsync, dsts, values, sizes, count, stream);
+
+  if ((count != 0) && ((dsts == nullptr) || (values == nullptr) || (sizes == nullptr))) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  if (!hip::isValid(stream)) {
+    HIP_RETURN(hipErrorContextIsDestroyed);
+  }
+  hip::Stream* hip_stream = hip::getStream(stream);
+  if (hip_stream == nullptr) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+
+  // Only the ROCr backend has the batch blit and the graph capture records a node per fill
+  amd::Device* queueDevice = &hip_stream->device();
+  const bool batch = queueDevice->settings().rocr_backend_ &&
+                     (hip_stream->GetCaptureStatus() == hipStreamCaptureStatusNone);
+
+  std::vector<amd::FillMemoryBatchCommand::Fill> fills;
+  for (size_t i = 0; i < count; ++i) {
+    if (sizes[i] == 0) {
+      continue;
+    }
+    hipError_t status = ihipMemset_validate(dsts[i], values[i], sizeof(int8_t), sizes[i]);
+    if (status != hipSuccess) {
+      HIP_RETURN(status);
+    }
+    size_t offset = 0;
+    amd::Memory* memory = getMemoryObject(dsts[i], offset);
+    // The blit writes device memory of the queue device only
+    if (batch && (memory->getContext().devices().size() == 1) &&
+        (memory->GetDeviceById() == queueDevice)) {
+      fills.push_back({memory, offset, static_cast<uint8_t>(values[i]), sizes[i]});
+    } else {
+      // The fills aren't ordered within the batch, so the rest can go first
+      status = hipMemsetAsync_common(dsts[i], values[i], sizes[i], stream);
+      if (status != hipSuccess) {
+        HIP_RETURN(status);
+      }
+    }
+  }
+
+  if (!fills.empty()) {
+    amd::Command::EventWaitList waitList;
+    amd::Command* command = new amd::FillMemoryBatchCommand(*hip_stream, waitList,
+                                                            std::move(fills));
+    if (command == nullptr) {
+      HIP_RETURN(hipErrorOutOfMemory);
+    }
+    command->enqueue();
+    command->release();
+  }
+  HIP_RETURN(hipSuccess);
+}
+
 hipError_t hipMemsetD8(hipDeviceptr_t dst, unsigned char value, size_t count) {
   HIP_INIT_API(hipMemsetD8, dst, value, count);
   CHECK_STREAM_CAPTURING();
@@ -3696,6 +4348,18 @@ hipError_t hipIpcOpenMemHandle(void** dev_ptr, hipIpcMemHandle_t handle, unsigne
     HIP_RETURN(hipErrorInvalidContext);
   }
 
+  // The reserved bytes aren't part of the key, since the exporter doesn't initialize them
+  IpcOpenKey key(std::string(reinterpret_cast<const char*>(ihandle),
+                             offsetof(ihipIpcMemHandle_t, reserved)),
+                 hip::getCurrentDevice()->deviceId());
+  amd::ScopedLock lock(ipcOpenLock);
+  auto it = ipcOpenCache.find(key);
+  if (it != ipcOpenCache.end()) {
+    it->second.refs_++;
+    *dev_ptr = it->second.dev_ptr_;
+    HIP_RETURN(hipSuccess);
+  }
+
   if(!device->IpcAttach(&(ihandle->ipc_handle), ihandle->psize,
                         ihandle->poffset, flags, dev_ptr)) {
     LogPrintfError("Cannot attach ipc_handle: with ipc_size: %u"
@@ -3705,6 +4369,10 @@ hipError_t hipIpcOpenMemHandle(void** dev_ptr, hipIpcMemHandle_t handle, unsigne
 
   amd_mem_obj = getMemoryObject(*dev_ptr, offset);
   amd_mem_obj->getUserData().deviceId = hip::getCurrentDevice()->deviceId();
+  if (ipcOpenPtrs.find(*dev_ptr) == ipcOpenPtrs.end()) {
+    ipcOpenCache[key] = {*dev_ptr, 1};
+    ipcOpenPtrs[*dev_ptr] = std::move(key);
+  }
 
   HIP_RETURN(hipSuccess);
 }
@@ -3715,12 +4383,26 @@ hipError_t hipIpcCloseMemHandle(void* dev_ptr) {
   amd::Device* device = nullptr;
   amd::Memory* amd_mem_obj = nullptr;
 
-  hip::getNullStream()->finish();
-
   if (dev_ptr == nullptr) {
     HIP_RETURN(hipErrorInvalidValue);
   }
 
+  {
+    amd::ScopedLock lock(ipcOpenLock);
+    auto it = ipcOpenPtrs.find(dev_ptr);
+    if (it != ipcOpenPtrs.end()) {
+      auto entry = ipcOpenCache.find(it->second);
+      if (--entry->second.refs_ > 0) {
+        // Other opens still use the mapping, hence skip the wait and the unmap
+        HIP_RETURN(hipSuccess);
+      }
+      ipcOpenCache.erase(entry);
+      ipcOpenPtrs.erase(it);
+    }
+  }
+
+  hip::getNullStream()->finish();
+
   amd_mem_obj = amd::MemObjMap::FindMemObj(dev_ptr);
   if (amd_mem_obj != nullptr) {
     auto device_id = amd_mem_obj->getUserData().deviceId;
@@ -3851,6 +4533,31 @@ hipError_t ihipPointerGetAttributes(void* data, hipPointer_attribute attribute,
 
   hipError_t status = hipSuccess;
 
+  // The extended attribute isn't an enumerator of hipPointer_attribute
+  if (attribute == HIP_POINTER_ATTRIBUTE_EXT_PAGE_SIZE) {
+    if (memObj == nullptr) {
+      *reinterpret_cast<size_t*>(data) = 0;
+      return hipErrorInvalidValue;
+    }
+    size_t pageSize = 0;
+    amd::Memory* physMem = memObj->getUserData().phys_mem_obj;
+    if (physMem != nullptr) {
+      // The mapped range gets the fragments of the hint, if the VA is aligned to the page
+      auto alloc = reinterpret_cast<hip::GenericAllocation*>(physMem->getUserData().data);
+      const size_t largePage = (alloc != nullptr) ? alloc->LargePage() : 0;
+      if ((largePage != 0) && amd::isMultipleOf(memObj->getSvmPtr(), largePage)) {
+        pageSize = largePage;
+      } else if ((largePage != 0) && amd::isMultipleOf(memObj->getSvmPtr(), 2 * Mi)) {
+        pageSize = 2 * Mi;
+      }
+    } else {
+      device::Memory* devMem = memObj->getDeviceMemory(*memObj->getContext().devices()[0]);
+      pageSize = (devMem != nullptr) ? devMem->pageSize() : 0;
+    }
+    *reinterpret_cast<size_t*>(data) = (pageSize != 0) ? pageSize : amd::Os::pageSize();
+    return hipSuccess;
+  }
+
     switch (attribute) {
       case HIP_POINTER_ATTRIBUTE_CONTEXT : {
         status = hipErrorNotSupported;
@@ -4369,6 +5076,19 @@ hipError_t hipFreeHost(void *ptr) {
     if (memory_object->getSvmPtr() == nullptr) {
       HIP_RETURN(hipErrorInvalidValue);
     }
+    if ((HIP_HOST_MEM_CACHE_SIZE != 0) && (offset == 0)) {
+      auto device = g_devices[memory_object->getUserData().deviceId];
+      auto& cache = device->GetHostMemoryCache();
+      if (cache.IsCached(ptr)) {
+        // The memory was already released
+        HIP_RETURN(hipErrorInvalidValue);
+      }
+      // Keep the implicit synchronization of hipHostFree() before the memory can be reused
+      device->SyncAllStreams();
+      if (cache.Free(memory_object)) {
+        HIP_RETURN(hipSuccess);
+      }
+    }
   }
   HIP_RETURN(ihipFree(ptr));
 }
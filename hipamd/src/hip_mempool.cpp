@@ -481,4 +481,34 @@ hipError_t hipMemPoolImportPointer(
   mpool->retain();
   HIP_RETURN(hipSuccess);
 }
+
+// ================================================================================================
+hipError_t hipExtMemPoolExportChunks(hipMemPool_t mem_pool, size_t* numChunks) {
+  HIP_INIT_API(hipExtMemPoolExportChunks, mem_pool, numChunks);
+  if (mem_pool == nullptr || numChunks == nullptr) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  auto mpool = reinterpret_cast<hip::MemoryPool*>(mem_pool);
+  HIP_RETURN(mpool->ExportChunks(numChunks));
+}
+
+// ================================================================================================
+hipError_t hipExtMemPoolSendBlock(hipMemPool_t mem_pool, void* ptr, size_t size) {
+  HIP_INIT_API(hipExtMemPoolSendBlock, mem_pool, ptr, size);
+  if (mem_pool == nullptr || ptr == nullptr || size == 0) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  auto mpool = reinterpret_cast<hip::MemoryPool*>(mem_pool);
+  HIP_RETURN(mpool->SendBlock(ptr, size));
+}
+
+// ================================================================================================
+hipError_t hipExtMemPoolReceiveBlock(hipMemPool_t mem_pool, void** ptr, size_t* size) {
+  HIP_INIT_API(hipExtMemPoolReceiveBlock, mem_pool, ptr, size);
+  if (mem_pool == nullptr || ptr == nullptr || size == nullptr) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  auto mpool = reinterpret_cast<hip::MemoryPool*>(mem_pool);
+  HIP_RETURN(mpool->ReceiveBlock(ptr, size));
+}
 }  // namespace hip
@@ -21,13 +21,283 @@
 #include "hip_mempool_impl.hpp"
 #include "hip_vm.hpp"
 #include "platform/command.hpp"
+#include <algorithm>
 
 namespace hip {
 
+// ================================================================================================
+SlabAllocator::Slab* SlabAllocator::CreateSlab(size_t block_size) {
+  amd::Context* context = device_->asContext();
+  const auto& dev_info = context->devices()[0]->info();
+  const size_t slab_size = static_cast<size_t>(HIP_MEM_POOL_SLAB_SIZE) * Mi;
+  void* ptr = amd::SvmBuffer::malloc(*context, 0, slab_size, dev_info.memBaseAddrAlign_, nullptr);
+  if (ptr == nullptr) {
+    return nullptr;
+  }
+  size_t offset = 0;
+  amd::Memory* memory = getMemoryObject(ptr, offset);
+  memory->getUserData().deviceId = device_->deviceId();
+  // The slab itself isn't visible to the app. The lookups must find the sub-allocations only
+  amd::MemObjMap::RemoveMemObj(ptr);
+
+  Slab* slab = new Slab{memory, block_size};
+  const size_t num_blocks = slab_size / block_size;
+  slab->free_offsets_.reserve(num_blocks);
+  // Keep the lowest offsets on top of the LIFO list
+  for (size_t idx = num_blocks; idx > 0; --idx) {
+    slab->free_offsets_.push_back((idx - 1) * block_size);
+  }
+  size_classes_[block_size].push_back(slab);
+  slabs_[memory] = slab;
+  total_size_ += slab_size;
+  ClPrint(amd::LOG_INFO, amd::LOG_MEM_POOL, "Pool CreateSlab: %p, block size %zu", ptr,
+          block_size);
+  return slab;
+}
+
+// ================================================================================================
+void SlabAllocator::DestroySlab(Slab* slab) {
+  amd::Memory* memory = slab->memory_;
+  void* ptr = memory->getSvmPtr();
+  ClPrint(amd::LOG_INFO, amd::LOG_MEM_POOL, "Pool DestroySlab: %p", ptr);
+  auto& list = size_classes_[slab->block_size_];
+  list.erase(std::find(list.begin(), list.end(), slab));
+  slabs_.erase(memory);
+  total_size_ -= memory->getSize();
+  // Restore the lookup entry, so the device could find the slab on release
+  amd::MemObjMap::AddMemObj(ptr, memory);
+  amd::SvmBuffer::free(memory->getContext(), ptr);
+  delete slab;
+}
+
+// ================================================================================================
+amd::Memory* SlabAllocator::Allocate(size_t size, uint64_t max_size) {
+  const size_t block_size = std::max(kMinBlockSize, amd::nextPowerOfTwo(size));
+  Slab* slab = nullptr;
+  for (auto it : size_classes_[block_size]) {
+    if (!it->free_offsets_.empty()) {
+      slab = it;
+      break;
+    }
+  }
+  if (slab == nullptr) {
+    if ((max_size != 0) && (static_cast<size_t>(HIP_MEM_POOL_SLAB_SIZE) * Mi > max_size)) {
+      return nullptr;
+    }
+    slab = CreateSlab(block_size);
+    if (slab == nullptr) {
+      return nullptr;
+    }
+  }
+  const size_t offset = slab->free_offsets_.back();
+  amd::Memory* parent = slab->memory_;
+  amd::Memory* memory = new (parent->getContext())
+      amd::Buffer(*parent, parent->getMemFlags(), offset, block_size);
+  if ((memory == nullptr) || !memory->create(nullptr)) {
+    if (memory != nullptr) {
+      memory->release();
+    }
+    return nullptr;
+  }
+  slab->free_offsets_.pop_back();
+  slab->used_++;
+  memory->getUserData().deviceId = device_->deviceId();
+  amd::MemObjMap::AddMemObj(memory->getSvmPtr(), memory);
+  return memory;
+}
+
+// ================================================================================================
+bool SlabAllocator::Free(amd::Memory* memory) {
+  auto it = (memory->parent() != nullptr) ? slabs_.find(memory->parent()) : slabs_.end();
+  if (it == slabs_.end()) {
+    return false;
+  }
+  Slab* slab = it->second;
+  amd::MemObjMap::RemoveMemObj(memory->getSvmPtr());
+  slab->free_offsets_.push_back(memory->getOrigin());
+  slab->used_--;
+  memory->release();
+  // Keep one empty slab per block size to avoid allocation thrashing on the boundary
+  if (slab->used_ == 0) {
+    for (auto other : size_classes_[slab->block_size_]) {
+      if ((other != slab) && !other->free_offsets_.empty()) {
+        DestroySlab(slab);
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+// ================================================================================================
+void SlabAllocator::ReleaseEmptySlabs() {
+  std::vector<Slab*> empty;
+  for (const auto& it : slabs_) {
+    if (it.second->used_ == 0) {
+      empty.push_back(it.second);
+    }
+  }
+  for (auto slab : empty) {
+    DestroySlab(slab);
+  }
+}
+
+// ================================================================================================
+void SlabAllocator::ReleaseAllSlabs() {
+  if (!slabs_.empty()) {
+    for (const auto& it : slabs_) {
+      if (it.second->used_ != 0) {
+        LogError("Shouldn't destroy slab with busy allocations!");
+      }
+    }
+  }
+  while (!slabs_.empty()) {
+    DestroySlab(slabs_.begin()->second);
+  }
+}
+
+// ================================================================================================
+uint32_t Heap::SizeClass(size_t size) {
+  constexpr uint32_t kSubBits = amd::Log2<kSizeSubBuckets>::value;
+  if (size < kSizeSubBuckets) {
+    return static_cast<uint32_t>(size);
+  }
+  uint32_t order = amd::log2(size);
+  uint32_t sub = static_cast<uint32_t>(size >> (order - kSubBits)) & (kSizeSubBuckets - 1);
+  return (order << kSubBits) | sub;
+}
+
+// ================================================================================================
+void Heap::AddToBin(const BinEntry& entry, Stream* stream) {
+  if (stream == nullptr) {
+    return;
+  }
+  auto& list = bins_[stream][SizeClass(entry.first)];
+  if (list.size() >= kBinCompactSize) {
+    CompactBin(list);
+  }
+  list.push_back(entry);
+}
+
+// ================================================================================================
+void Heap::CompactBin(FreeList& list) {
+  // Entries are removed lazily, hence drop the ones which already left the sorted map
+  list.erase(std::remove_if(list.begin(), list.end(), [this](const BinEntry& entry) {
+    return allocations_.find(entry) == allocations_.end();
+  }), list.end());
+}
+
+// ================================================================================================
+amd::Memory* Heap::FindMemoryInBin(size_t size, Stream* stream, MemoryTimestamp* ts) {
+  auto stream_bins = bins_.find(stream);
+  if (stream_bins == bins_.end()) {
+    return nullptr;
+  }
+  // Runtime can accept an allocation with 12.5% on the size threshold, which may span
+  // the next size class
+  const size_t max_size = static_cast<size_t>((size / 8.0) * 9);
+  const uint32_t first_class = SizeClass(size);
+  const uint32_t last_class = SizeClass(max_size);
+  for (uint32_t size_class = first_class; size_class <= last_class; ++size_class) {
+    auto bin = stream_bins->second.find(size_class);
+    if (bin == stream_bins->second.end()) {
+      continue;
+    }
+    auto& list = bin->second;
+    size_t probe = 0;
+    // Walk the list from the most recent release, since it's most likely to be retired
+    for (size_t idx = list.size(); (idx > 0) && (probe < kMaxBinProbe); --idx, ++probe) {
+      const BinEntry entry = list[idx - 1];
+      auto it = allocations_.find(entry);
+      if (it == allocations_.end()) {
+        // The allocation was reused or released through a different path
+        list.erase(list.begin() + (idx - 1));
+        continue;
+      }
+      if ((entry.first < size) || (entry.first > max_size)) {
+        continue;
+      }
+      auto reuse = it->second.FindReuse(stream, false);
+      if (reuse == MemoryTimestamp::Reuse::None) {
+        continue;
+      }
+      CountReuse(reuse);
+      amd::Memory* memory = entry.second;
+      total_size_ -= entry.first;
+      // Preserve event, since the logic could skip GPU wait on reuse
+      ts->event_ = it->second.event_;
+      it->second.DropSubmission();
+      allocations_.erase(it);
+      list.erase(list.begin() + (idx - 1));
+      return memory;
+    }
+  }
+  return nullptr;
+}
+
+// ================================================================================================
+bool MemoryTimestamp::IsSubmissionDone() const {
+  return (free_command_ == nullptr) || (free_command_->status() == CL_COMPLETE);
+}
+
+// ================================================================================================
+void MemoryTimestamp::Materialize() {
+  if (!lazy_) {
+    return;
+  }
+  if (!IsSubmissionDone()) {
+    // Add a marker to the stream to trace availability of this memory.
+    // The marker follows the submission point, hence the wait is conservative
+    Event* e = new hip::Event(0);
+    if (e != nullptr) {
+      if (hipSuccess == e->addMarker(reinterpret_cast<hipStream_t>(free_stream_), nullptr, true)) {
+        event_ = e;
+        // Make sure runtime sends a notification
+        auto result = e->ready();
+      } else {
+        delete e;
+        free_command_->awaitCompletion();
+      }
+    }
+    ClPrint(amd::LOG_INFO, amd::LOG_MEM_POOL, "Materialized release event %p", event_);
+  }
+  DropSubmission();
+}
+
+// ================================================================================================
+void MemoryTimestamp::DropSubmission() {
+  if (free_command_ != nullptr) {
+    free_command_->release();
+    free_command_ = nullptr;
+  }
+  lazy_ = false;
+}
+
+// ================================================================================================
+void Heap::CountReuse(MemoryTimestamp::Reuse reuse) {
+  switch (reuse) {
+    case MemoryTimestamp::Reuse::SameStream:
+      reuse_stats_.same_stream_++;
+      break;
+    case MemoryTimestamp::Reuse::EventDependency:
+      reuse_stats_.event_dependency_++;
+      break;
+    case MemoryTimestamp::Reuse::Opportunistic:
+      reuse_stats_.opportunistic_++;
+      break;
+    case MemoryTimestamp::Reuse::Released:
+      reuse_stats_.released_++;
+      break;
+    default:
+      break;
+  }
+}
+
 // ================================================================================================
 void Heap::AddMemory(amd::Memory* memory, Stream* stream) {
   auto mem_size = memory->getSize();
   allocations_.insert({{mem_size, memory}, {stream}});
+  AddToBin({mem_size, memory}, stream);
   total_size_ += mem_size;
   max_total_size_ = std::max(max_total_size_, total_size_);
 }
@@ -36,6 +306,9 @@ void Heap::AddMemory(amd::Memory* memory, Stream* stream) {
 void Heap::AddMemory(amd::Memory* memory, const MemoryTimestamp& ts) {
   auto mem_size = memory->getSize();
   allocations_.insert({{mem_size, memory}, ts});
+  for (auto stream : ts.safe_streams_) {
+    AddToBin({mem_size, memory}, stream);
+  }
   total_size_ += mem_size;
   max_total_size_ = std::max(max_total_size_, total_size_);
 }
@@ -44,6 +317,14 @@ void Heap::AddMemory(amd::Memory* memory, const MemoryTimestamp& ts) {
 amd::Memory* Heap::FindMemory(size_t size, Stream* stream, bool opportunistic,
     void* dptr, MemoryTimestamp* ts) {
   amd::Memory* memory = nullptr;
+  if ((dptr == nullptr) && (stream != nullptr)) {
+    // Fast path: same-stream reuse from the size class bins doesn't require TS validation
+    memory = FindMemoryInBin(size, stream, ts);
+    if (memory != nullptr) {
+      return memory;
+    }
+  }
+  // Slow path: walk the sorted map for cross-stream and opportunistic reuse
   auto start = allocations_.lower_bound({size, nullptr});
   for (auto it = start; it != allocations_.end();) {
     bool check_address = (dptr == nullptr);
@@ -59,11 +340,15 @@ amd::Memory* Heap::FindMemory(size_t size, Stream* stream, bool opportunistic,
       opp_mode = false;
     }
     // Check if size can match and it's safe to use this resource.
-    if (check_address && (it->second.IsSafeFind(stream, opp_mode))) {
+    auto reuse = check_address ? it->second.FindReuse(stream, opp_mode) :
+                                 MemoryTimestamp::Reuse::None;
+    if (reuse != MemoryTimestamp::Reuse::None) {
+      CountReuse(reuse);
       memory = it->first.second;
       total_size_ -= memory->getSize();
       // Preserve event, since the logic could skip GPU wait on reuse
       ts->event_ = it->second.event_;
+      it->second.DropSubmission();
       // Remove found allocation from the map
       it = allocations_.erase(it);
       break;
@@ -94,14 +379,17 @@ bool Heap::RemoveMemory(amd::Memory* memory, MemoryTimestamp* ts) {
 // ================================================================================================
 Heap::SortedMap::iterator Heap::EraseAllocaton(Heap::SortedMap::iterator& it) {
   auto memory = it->first.second;
-  const device::Memory* dev_mem = memory->getDeviceMemory(*device_->devices()[0]);
-  void* dev_mem_vaddr = reinterpret_cast<void*>(dev_mem->virtualAddress());
   total_size_ -= it->first.first;
-  
-  if (dev_mem_vaddr != nullptr) {
-    amd::SvmBuffer::free(memory->getContext(), dev_mem_vaddr);
-  } else {
-    amd::SvmBuffer::free(memory->getContext(), memory->getSvmPtr());
+
+  // Small allocations go back to the slab they were carved from
+  if ((slabs_ == nullptr) || !slabs_->Free(memory)) {
+    const device::Memory* dev_mem = memory->getDeviceMemory(*device_->devices()[0]);
+    void* dev_mem_vaddr = reinterpret_cast<void*>(dev_mem->virtualAddress());
+    if (dev_mem_vaddr != nullptr) {
+      amd::SvmBuffer::free(memory->getContext(), dev_mem_vaddr);
+    } else {
+      amd::SvmBuffer::free(memory->getContext(), memory->getSvmPtr());
+    }
   }
   // Clear HIP event
   it->second.SetEvent(nullptr);
@@ -145,11 +433,62 @@ bool Heap::ReleaseAllMemory() {
   return true;
 }
 
+// ================================================================================================
+void Heap::ReleaseAgedMemory(uint64_t free_time) {
+  std::vector<SortedMap::iterator> aged;
+  for (auto it = allocations_.begin(); it != allocations_.end(); ++it) {
+    if ((it->second.free_time_ <= free_time) && it->second.IsSafeRelease()) {
+      aged.push_back(it);
+    }
+  }
+  // Evict the oldest allocations first
+  std::sort(aged.begin(), aged.end(), [](const auto& a, const auto& b) {
+    return a->second.free_time_ < b->second.free_time_;
+  });
+  for (auto it : aged) {
+    // Make sure the heap holds the minimum number of bytes
+    if (total_size_ <= release_threshold_) {
+      break;
+    }
+    EraseAllocaton(it);
+  }
+}
+
+// ================================================================================================
+size_t Heap::CompactFor(size_t size) {
+  std::vector<SortedMap::iterator> idle;
+  size_t idle_size = 0;
+  // The map is sorted by size, hence the walk collects the smallest allocations first
+  for (auto it = allocations_.begin();
+       (it != allocations_.end()) && (it->first.first < size) && (idle_size < size); ++it) {
+    if (it->second.IsSafeRelease()) {
+      idle.push_back(it);
+      idle_size += it->first.first;
+    }
+  }
+  // Don't drop the cached memory if it can't replace the new allocation
+  if (idle_size < size) {
+    return 0;
+  }
+  for (auto it : idle) {
+    EraseAllocaton(it);
+  }
+  ClPrint(amd::LOG_INFO, amd::LOG_MEM_POOL, "Compacted %zu idle allocations, %zu bytes for %zu",
+          idle.size(), idle_size, size);
+  return idle_size;
+}
+
 // ================================================================================================
 void Heap::RemoveStream(Stream* stream) {
-  for (auto it : allocations_) {
+  for (auto& it : allocations_) {
     it.second.safe_streams_.erase(stream);
+    if (it.second.free_stream_ == stream) {
+      // The stream can't create HIP event after destruction
+      it.second.Materialize();
+      it.second.free_stream_ = nullptr;
+    }
   }
+  bins_.erase(stream);
 }
 
 // ================================================================================================
@@ -179,7 +518,14 @@ void* MemoryPool::AllocateMemory(size_t size, Stream* stream, void* dptr) {
   MemoryTimestamp ts;
   amd::Memory* memory = free_heap_.FindMemory(size, stream, Opportunistic(), dptr, &ts);
   if (memory == nullptr) {
-    if (Properties().maxSize != 0 && (max_total_size_ + size) > Properties().maxSize) {
+    uint64_t reserved = max_total_size_;
+    if (HIP_MEM_POOL_COMPACT && state_.phys_mem_ && (dptr == nullptr) &&
+        (free_heap_.CompactFor(size) != 0)) {
+      // Fragmented physical memory can't back a large mapping. The idle physical handles were
+      // returned, so a single handle of the requested size replaces them without pool growth
+      reserved = busy_heap_.GetTotalSize() + free_heap_.GetTotalSize();
+    }
+    if (Properties().maxSize != 0 && (reserved + size) > Properties().maxSize) {
       return nullptr;
     }
     amd::Context* context = device_->asContext();
@@ -187,23 +533,37 @@ void* MemoryPool::AllocateMemory(size_t size, Stream* stream, void* dptr) {
     if (dev_info.maxMemAllocSize_ < size) {
       return nullptr;
     }
-    cl_svm_mem_flags flags = (state_.interprocess_) ? ROCCLR_MEM_INTERPROCESS : 0;
-    flags |= (state_.phys_mem_) ? ROCCLR_MEM_PHYMEM : 0;
-    dev_ptr = amd::SvmBuffer::malloc(*context, flags, size, dev_info.memBaseAddrAlign_, nullptr);
-    if (dev_ptr == nullptr) {
-      size_t free = 0, total =0;
-      hipError_t err = hipMemGetInfo(&free, &total);
-      if (err == hipSuccess) {
-        LogPrintfError("Allocation failed : Device memory : required :%zu | free :%zu | total :%zu",
-          size, free, total);
+    if ((dptr == nullptr) && !state_.interprocess_ && !state_.phys_mem_ &&
+        SlabAllocator::IsSlabSize(size)) {
+      // Carve small allocations from a slab to avoid a driver allocation per request
+      uint64_t max_size = 0;
+      if (Properties().maxSize != 0) {
+        max_size = Properties().maxSize - max_total_size_;
       }
-      return nullptr;
+      memory = slabs_.Allocate(size, max_size);
     }
+    if (memory != nullptr) {
+      dev_ptr = memory->getSvmPtr();
+    } else {
+      cl_svm_mem_flags flags = (state_.interprocess_) ? ROCCLR_MEM_INTERPROCESS : 0;
+      flags |= (state_.phys_mem_) ? ROCCLR_MEM_PHYMEM : 0;
+      dev_ptr = amd::SvmBuffer::malloc(*context, flags, size, dev_info.memBaseAddrAlign_, nullptr);
+      if (dev_ptr == nullptr) {
+        size_t free = 0, total =0;
+        hipError_t err = hipMemGetInfo(&free, &total);
+        if (err == hipSuccess) {
+          LogPrintfError("Allocation failed : Device memory : required :%zu | free :%zu | total :%zu",
+            size, free, total);
+        }
+        return nullptr;
+      }
 
-    size_t offset = 0;
-    memory = getMemoryObject(dev_ptr, offset);
-    // Saves the current device id so that it can be accessed later
-    memory->getUserData().deviceId = device_->deviceId();
+      size_t offset = 0;
+      memory = getMemoryObject(dev_ptr, offset);
+      // Saves the current device id so that it can be accessed later
+      memory->getUserData().deviceId = device_->deviceId();
+    }
+    alloc_new_++;
 
     // Update access for the new allocation from other devices
     for (const auto& it : access_map_) {
@@ -217,12 +577,14 @@ void* MemoryPool::AllocateMemory(size_t size, Stream* stream, void* dptr) {
   } else {
     dev_ptr = memory->getSvmPtr();
   }
+  last_activity_ = amd::Os::timeNanos();
   // Place the allocated memory into the busy heap
   ts.AddSafeStream(stream);
   busy_heap_.AddMemory(memory, ts);
 
   max_total_size_ = std::max(max_total_size_, busy_heap_.GetTotalSize() +
                                                   free_heap_.GetTotalSize());
+  max_fragmentation_ = std::max(max_fragmentation_, Fragmentation());
   // Increment the reference counter on the pool
   retain();
 
@@ -280,7 +642,10 @@ bool MemoryPool::FreeMemory(amd::Memory* memory, Stream* stream, Event* event) {
       // The stream of destruction is a safe stream, because the app must handle sync
       ts.AddSafeStream(stream);
 
-      if (event == nullptr) {
+      if ((event == nullptr) && HIP_MEM_POOL_LAZY_EVENTS) {
+        // Same stream reuse doesn't need HIP event, hence just track the submission point
+        ts.SetSubmission(stream->getLastQueuedCommand(true));
+      } else if (event == nullptr) {
         // Add a marker to the stream to trace availability of this memory
         Event* e = new hip::Event(0);
         if (e != nullptr) {
@@ -297,7 +662,10 @@ bool MemoryPool::FreeMemory(amd::Memory* memory, Stream* stream, Event* event) {
       // Assume a safe release from hipFree() if stream is nullptr
       ts.SetEvent(nullptr);
     }
+    last_activity_ = ts.free_time_ = amd::Os::timeNanos();
+    ts.free_stream_ = stream;
     free_heap_.AddMemory(memory, ts);
+    max_fragmentation_ = std::max(max_fragmentation_, Fragmentation());
   }
 
   // Decrement the reference counter on the pool.
@@ -320,6 +688,7 @@ void MemoryPool::ReleaseFreedMemory() {
   amd::ScopedLock lock(lock_pool_ops_);
 
   free_heap_.ReleaseAllMemory();
+  slabs_.ReleaseEmptySlabs();
 }
 
 // ================================================================================================
@@ -334,6 +703,45 @@ void MemoryPool::TrimTo(size_t min_bytes_to_hold) {
   amd::ScopedLock lock(lock_pool_ops_);
 
   free_heap_.ReleaseAllMemory(min_bytes_to_hold);
+  slabs_.ReleaseEmptySlabs();
+}
+
+// ================================================================================================
+void MemoryPool::TrimIdle() {
+  amd::ScopedLock lock(lock_pool_ops_);
+
+  const uint64_t now = amd::Os::timeNanos();
+  if ((now - last_activity_) < static_cast<uint64_t>(HIP_MEM_POOL_TRIM_INTERVAL) * 1000000ULL) {
+    return;
+  }
+  const uint64_t age = static_cast<uint64_t>(HIP_MEM_POOL_TRIM_AGE) * 1000000ULL;
+  if ((free_heap_.GetTotalSize() > free_heap_.GetReleaseThreshold()) && (now > age)) {
+    free_heap_.ReleaseAgedMemory(now - age);
+    slabs_.ReleaseEmptySlabs();
+  }
+}
+
+// ================================================================================================
+void MemoryPoolTrimmer::run(void* data) {
+  // Sleep in short slices, so the thread can exit quickly on termination
+  constexpr uint kSleepSliceMs = 10;
+  uint slept = 0;
+  while (!terminate_) {
+    amd::Os::sleep(kSleepSliceMs);
+    slept += kSleepSliceMs;
+    if (slept >= HIP_MEM_POOL_TRIM_INTERVAL) {
+      slept = 0;
+      device_->TrimIdleMemoryPools();
+    }
+  }
+}
+
+// ================================================================================================
+void MemoryPoolTrimmer::Terminate() {
+  terminate_ = true;
+  while ((state() != amd::Thread::FINISHED) && (state() != amd::Thread::FAILED)) {
+    amd::Os::yield();
+  }
 }
 
 // ================================================================================================
@@ -341,7 +749,8 @@ hipError_t MemoryPool::SetAttribute(hipMemPoolAttr attr, void* value) {
   amd::ScopedLock lock(lock_pool_ops_);
   uint64_t reset;
 
-  switch (attr) {
+  // The extended attributes are outside of hipMemPoolAttr
+  switch (static_cast<int>(attr)) {
     case hipMemPoolReuseFollowEventDependencies:
       // Enable/disable HIP events tracking from the app's dependencies
       state_.event_dependencies_ = *reinterpret_cast<int32_t*>(value);
@@ -381,6 +790,24 @@ hipError_t MemoryPool::SetAttribute(hipMemPoolAttr attr, void* value) {
       }
       busy_heap_.SetMaxTotalSize(reset);
       break;
+    case hipExtMemPoolAttrAllocReused:
+    case hipExtMemPoolAttrAllocNew:
+    case hipExtMemPoolAttrReuseSameStream:
+    case hipExtMemPoolAttrReuseEventDependency:
+    case hipExtMemPoolAttrReuseOpportunistic:
+    case hipExtMemPoolAttrFragmentationHigh:
+      reset = *reinterpret_cast<uint64_t*>(value);
+      // Only 0 is accepted, which resets all telemetry counters
+      if (reset != 0) {
+        return hipErrorInvalidValue;
+      }
+      free_heap_.ResetReuseStats();
+      alloc_new_ = 0;
+      max_fragmentation_ = Fragmentation();
+      break;
+    case hipExtMemPoolAttrFragmentation:
+      // Should be GetAttribute only
+      return hipErrorInvalidValue;
     default:
       return hipErrorInvalidValue;
   }
@@ -391,7 +818,8 @@ hipError_t MemoryPool::SetAttribute(hipMemPoolAttr attr, void* value) {
 hipError_t MemoryPool::GetAttribute(hipMemPoolAttr attr, void* value) {
   amd::ScopedLock lock(lock_pool_ops_);
 
-  switch (attr) {
+  // The extended attributes are outside of hipMemPoolAttr
+  switch (static_cast<int>(attr)) {
     case hipMemPoolReuseFollowEventDependencies:
       // Enable/disable HIP events tracking from the app's dependencies
       *reinterpret_cast<int32_t*>(value) = EventDependencies();
@@ -423,6 +851,27 @@ hipError_t MemoryPool::GetAttribute(hipMemPoolAttr attr, void* value) {
       // High watermark of all used memoryS, since the last reset
       *reinterpret_cast<uint64_t*>(value) = busy_heap_.GetMaxTotalSize();
       break;
+    case hipExtMemPoolAttrAllocReused:
+      *reinterpret_cast<uint64_t*>(value) = free_heap_.GetReuseStats().Total();
+      break;
+    case hipExtMemPoolAttrAllocNew:
+      *reinterpret_cast<uint64_t*>(value) = alloc_new_;
+      break;
+    case hipExtMemPoolAttrReuseSameStream:
+      *reinterpret_cast<uint64_t*>(value) = free_heap_.GetReuseStats().same_stream_;
+      break;
+    case hipExtMemPoolAttrReuseEventDependency:
+      *reinterpret_cast<uint64_t*>(value) = free_heap_.GetReuseStats().event_dependency_;
+      break;
+    case hipExtMemPoolAttrReuseOpportunistic:
+      *reinterpret_cast<uint64_t*>(value) = free_heap_.GetReuseStats().opportunistic_;
+      break;
+    case hipExtMemPoolAttrFragmentation:
+      *reinterpret_cast<uint64_t*>(value) = Fragmentation();
+      break;
+    case hipExtMemPoolAttrFragmentationHigh:
+      *reinterpret_cast<uint64_t*>(value) = max_fragmentation_;
+      break;
     default:
       return hipErrorInvalidValue;
   }
@@ -504,6 +953,12 @@ amd::Os::FileDesc MemoryPool::Export() {
       shared_->access_[shared_->access_size_] = SharedAccess{it.first->deviceId(), it.second};
       shared_->access_size_++;
     }
+    shared_->chunk_count_.store(0, std::memory_order_relaxed);
+    shared_->ring_head_.store(0, std::memory_order_relaxed);
+    shared_->ring_tail_.store(0, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < kSharedRingSize; ++i) {
+      shared_->ring_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
   }
   return handle;
 }
@@ -520,8 +975,161 @@ bool MemoryPool::Import(amd::Os::FileDesc handle) {
     for (uint32_t i = 0; i < shared->access_size_; ++i) {
       access_map_[g_devices[shared->access_[i].device_id_]] = shared->access_[i].flags_;
     }
+    // Keep the shared memory mapped for the block handoff
+    shared_ = shared;
+    imported_ = true;
     result = true;
   }
   return result;
 }
+
+// ================================================================================================
+amd::Memory* MemoryPool::FindChunk(void* ptr, size_t* offset) {
+  size_t mem_offset = 0;
+  amd::Memory* memory = getMemoryObject(ptr, mem_offset);
+  if ((memory == nullptr) || !busy_heap_.IsActiveMemory(memory)) {
+    return nullptr;
+  }
+  // Slab sub-allocations share the slab, hence the slab is exported as a single chunk
+  amd::Memory* chunk = (memory->parent() != nullptr) ? memory->parent() : memory;
+  *offset = reinterpret_cast<address>(ptr) - reinterpret_cast<address>(chunk->getSvmPtr());
+  return chunk;
+}
+
+// ================================================================================================
+bool MemoryPool::ExportChunk(amd::Memory* chunk, uint32_t* index) {
+  auto it = exported_chunks_.find(chunk);
+  if (it != exported_chunks_.end()) {
+    *index = it->second;
+    return true;
+  }
+  const uint32_t count = shared_->chunk_count_.load(std::memory_order_relaxed);
+  if (count >= kMaxSharedChunks) {
+    LogPrintfError("Pool %p exceeds %u shared chunks", this, kMaxSharedChunks);
+    return false;
+  }
+  auto& entry = shared_->chunks_[count];
+  auto dev_mem = chunk->getDeviceMemory(*device_->devices()[0]);
+  if ((dev_mem == nullptr) || !dev_mem->ExportHandle(&entry.handle_[0])) {
+    return false;
+  }
+  entry.size_ = chunk->getSize();
+  entry.offset_ = chunk->getOffset();
+  // The chunk must stay alive while the importer can access it
+  chunk->retain();
+  exported_chunks_[chunk] = count;
+  // Publish the handle before any block of the chunk reaches the ring
+  shared_->chunk_count_.store(count + 1, std::memory_order_release);
+  ClPrint(amd::LOG_INFO, amd::LOG_MEM_POOL, "Pool ExportChunk: %p, index %u, size %zu",
+          chunk->getSvmPtr(), count, chunk->getSize());
+  *index = count;
+  return true;
+}
+
+// ================================================================================================
+hipError_t MemoryPool::ExportChunks(size_t* num_chunks) {
+  amd::ScopedLock lock(lock_pool_ops_);
+  if ((shared_ == nullptr) || imported_) {
+    return hipErrorInvalidValue;
+  }
+  for (const auto& it : busy_heap_.Allocations()) {
+    amd::Memory* memory = it.first.second;
+    amd::Memory* chunk = (memory->parent() != nullptr) ? memory->parent() : memory;
+    uint32_t index = 0;
+    if (!ExportChunk(chunk, &index)) {
+      return hipErrorOutOfMemory;
+    }
+  }
+  *num_chunks = shared_->chunk_count_.load(std::memory_order_relaxed);
+  return hipSuccess;
+}
+
+// ================================================================================================
+hipError_t MemoryPool::SendBlock(void* ptr, size_t size) {
+  uint32_t index = 0;
+  size_t offset = 0;
+  {
+    amd::ScopedLock lock(lock_pool_ops_);
+    if ((shared_ == nullptr) || imported_) {
+      return hipErrorInvalidValue;
+    }
+    amd::Memory* chunk = FindChunk(ptr, &offset);
+    if ((chunk == nullptr) || (size > chunk->getSize() - offset)) {
+      return hipErrorInvalidValue;
+    }
+    if (!ExportChunk(chunk, &index)) {
+      return hipErrorOutOfMemory;
+    }
+  }
+  // Bounded ring with a sequence per slot, so neither side takes a lock across the processes
+  uint64_t pos = shared_->ring_tail_.load(std::memory_order_relaxed);
+  while (true) {
+    SharedBlock& slot = shared_->ring_[pos % kSharedRingSize];
+    const uint64_t sequence = slot.sequence_.load(std::memory_order_acquire);
+    const int64_t diff = static_cast<int64_t>(sequence - pos);
+    if (diff == 0) {
+      if (shared_->ring_tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        slot.chunk_ = index;
+        slot.offset_ = offset;
+        slot.size_ = size;
+        slot.sequence_.store(pos + 1, std::memory_order_release);
+        return hipSuccess;
+      }
+    } else if (diff < 0) {
+      // The importer didn't receive the previous blocks yet
+      return hipErrorNotReady;
+    } else {
+      pos = shared_->ring_tail_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+// ================================================================================================
+hipError_t MemoryPool::ReceiveBlock(void** ptr, size_t* size) {
+  if ((shared_ == nullptr) || !imported_) {
+    return hipErrorInvalidValue;
+  }
+  uint64_t chunk = 0;
+  uint64_t offset = 0;
+  uint64_t pos = shared_->ring_head_.load(std::memory_order_relaxed);
+  while (true) {
+    SharedBlock& slot = shared_->ring_[pos % kSharedRingSize];
+    const uint64_t sequence = slot.sequence_.load(std::memory_order_acquire);
+    const int64_t diff = static_cast<int64_t>(sequence - (pos + 1));
+    if (diff == 0) {
+      if (shared_->ring_head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        chunk = slot.chunk_;
+        offset = slot.offset_;
+        *size = slot.size_;
+        // Return the slot to the sender for the next round
+        slot.sequence_.store(pos + kSharedRingSize, std::memory_order_release);
+        break;
+      }
+    } else if (diff < 0) {
+      return hipErrorNotReady;
+    } else {
+      pos = shared_->ring_head_.load(std::memory_order_relaxed);
+    }
+  }
+
+  amd::ScopedLock lock(lock_pool_ops_);
+  // The sender publishes a chunk before its first block, hence the table has the handle already
+  const uint32_t count = shared_->chunk_count_.load(std::memory_order_acquire);
+  while (imported_chunks_.size() <= chunk) {
+    if (imported_chunks_.size() >= count) {
+      LogPrintfError("Pool %p received a block of unknown chunk %lu", this, chunk);
+      return hipErrorInvalidValue;
+    }
+    const auto& entry = shared_->chunks_[imported_chunks_.size()];
+    void* base = nullptr;
+    if (!device_->devices()[0]->IpcAttach(&entry.handle_[0], entry.size_, entry.offset_, 0,
+                                          &base)) {
+      LogPrintfError("Pool %p can't import shared chunk %zu", this, imported_chunks_.size());
+      return hipErrorOutOfMemory;
+    }
+    imported_chunks_.push_back(base);
+  }
+  *ptr = reinterpret_cast<address>(imported_chunks_[chunk]) + offset;
+  return hipSuccess;
+}
 }
@@ -25,6 +25,7 @@
 #include "hip_internal.hpp"
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace hip {
 
@@ -62,30 +63,73 @@ struct MemoryTimestamp {
     delete event_;
     event_ = event;
   }
+  /// Records the last submitted command of the releasing stream instead of a HIP event.
+  /// The event is created later, only if another stream contends for the memory
+  void SetSubmission(amd::Command* command) {
+    SetEvent(nullptr);
+    free_command_ = command;
+    lazy_ = true;
+  }
+  /// Returns true if the last submitted command of the releasing stream has finished
+  bool IsSubmissionDone() const;
+  /// Creates HIP event for the recorded submission, unless GPU is already done with it
+  void Materialize();
+  /// Drops the recorded submission, once it can't affect the memory reuse
+  void DropSubmission();
   /// Wait for memory to be available
   void Wait() {
+    if (lazy_) {
+      // The submission point allows an exact wait without HIP event
+      if (free_command_ != nullptr) {
+        free_command_->awaitCompletion();
+      }
+      DropSubmission();
+    }
     if (event_ != nullptr) {
       auto hip_error = event_->synchronize();
     }
   }
-  /// Returns if memory object is safe for reuse
-  bool IsSafeFind(hip::Stream* stream = nullptr, bool opportunistic = true) {
-    bool result = false;
+  /// Reason the memory object is safe for reuse
+  enum class Reuse {
+    None,             //!< Memory object isn't safe for reuse
+    SameStream,       //!< The stream released the memory object
+    EventDependency,  //!< The stream waited for the event of release
+    Opportunistic,    //!< HIP event of release has retired
+    Released          //!< Memory object was released with explicit wait
+  };
+  /// Returns the reason memory object is safe for reuse
+  Reuse FindReuse(hip::Stream* stream = nullptr, bool opportunistic = true) {
+    Reuse result = Reuse::None;
     if (safe_streams_.find(stream) != safe_streams_.end()) {
       // A safe stream doesn't require TS validation
-      result = true;
+      result = ((free_stream_ == nullptr) || (free_stream_ == stream)) ?
+          Reuse::SameStream : Reuse::EventDependency;
+    } else if (lazy_) {
+      if (opportunistic) {
+        // Another stream contends for the memory, hence HIP event is required
+        Materialize();
+        result = FindReuse(stream, opportunistic);
+      } else {
+        // Avoid HIP event creation for a search, which can't use it
+        result = IsSubmissionDone() ? Reuse::Released : Reuse::None;
+      }
     } else if (opportunistic && (event_ != nullptr)) {
       // Check HIP event for a retired status
-      result = (event_->query() == hipSuccess) ? true : false;
+      result = (event_->query() == hipSuccess) ? Reuse::Opportunistic : Reuse::None;
     } else if (event_ == nullptr) {
       // Event doesn't exist. It was a safe release with explicit wait
-      return true;
+      return Reuse::Released;
     }
     return result;
   }
   /// Returns if memory object is safe for reuse
+  bool IsSafeFind(hip::Stream* stream = nullptr, bool opportunistic = true) {
+    return FindReuse(stream, opportunistic) != Reuse::None;
+  }
+  /// Returns if memory object is safe for reuse
   bool IsSafeRelease() {
     bool result = true;
+    Materialize();
     if (event_ != nullptr) {
       // Check HIP event for a retired status
       result = (event_->query() == hipSuccess) ? true : false;
@@ -95,14 +139,83 @@ struct MemoryTimestamp {
 
   std::unordered_set<hip::Stream*>  safe_streams_;  //!< Safe streams for memory reuse
   hip::Event*   event_ = nullptr;   //!< Last known HIP event, associated with the memory object
+  uint64_t      free_time_ = 0;     //!< Time in ns, when memory was placed into the free heap
+  hip::Stream*  free_stream_ = nullptr; //!< The stream, which released the memory object
+  amd::Command* free_command_ = nullptr; //!< Last command of the stream at the release time
+  bool          lazy_ = false;      //!< HIP event of the release wasn't created yet
+};
+
+/// Carves small allocations from large slabs, so a small request doesn't reach the kernel driver.
+/// Every sub-allocation is a regular memory object, hence the heaps track stream ordering for it
+/// as for any other allocation.
+class SlabAllocator : public amd::EmbeddedObject {
+public:
+  SlabAllocator(hip::Device* device): device_(device), total_size_(0) {}
+  ~SlabAllocator() { ReleaseAllSlabs(); }
+
+  /// Returns true if the requested size can be carved from a slab
+  static bool IsSlabSize(size_t size) {
+    return (HIP_MEM_POOL_SLAB_SIZE != 0) && (size <= HIP_MEM_POOL_SLAB_MAX_ALLOC * Ki);
+  }
+
+  /// Allocates a sub-buffer from a slab. Creates a new slab if the limit allows
+  amd::Memory* Allocate(size_t size, uint64_t max_size);
+
+  /// Returns the sub-buffer to the slab. False if memory doesn't belong to any slab
+  bool Free(amd::Memory* memory);
+
+  /// Releases all empty slabs
+  void ReleaseEmptySlabs();
+
+  /// Get the size of all slabs
+  uint64_t GetTotalSize() const { return total_size_; }
+
+private:
+  static constexpr size_t kMinBlockSize = 256;  //!< Minimum size of a block in a slab
+
+  struct Slab {
+    amd::Memory* memory_;               //!< Memory object of the entire slab
+    size_t block_size_;                 //!< Size of sub-allocations in the slab
+    std::vector<size_t> free_offsets_;  //!< LIFO list of free block offsets
+    size_t used_ = 0;                   //!< The number of sub-allocations in use
+  };
+
+  /// Creates a new slab with the provided block size
+  Slab* CreateSlab(size_t block_size);
+
+  /// Destroys the slab and releases the memory back to the device
+  void DestroySlab(Slab* slab);
+
+  /// Releases all slabs, regardless of the usage
+  void ReleaseAllSlabs();
+
+  SlabAllocator() = delete;
+  SlabAllocator(const SlabAllocator&) = delete;
+  SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+  std::unordered_map<size_t, std::vector<Slab*>> size_classes_;  //!< Slabs per block size
+  std::unordered_map<amd::Memory*, Slab*> slabs_;  //!< Slab lookup by the slab memory object
+  hip::Device*  device_;    //!< Hip device the slabs will reside
+  uint64_t total_size_;     //!< Size of all slabs
 };
 
 class Heap : public amd::EmbeddedObject {
 public:
   typedef std::map<std::pair<size_t, amd::Memory*>, MemoryTimestamp> SortedMap;
 
-  Heap(hip::Device* device):
-    total_size_(0), max_total_size_(0), release_threshold_(0), device_(device) {}
+  /// Counters of successful lookups in the heap, split by the reason of reuse
+  struct ReuseStats {
+    uint64_t same_stream_ = 0;        //!< Reuses on the stream of release
+    uint64_t event_dependency_ = 0;   //!< Reuses, allowed by event dependencies
+    uint64_t opportunistic_ = 0;      //!< Reuses, allowed by a retired HIP event
+    uint64_t released_ = 0;           //!< Reuses of memory, released with explicit wait
+    uint64_t Total() const {
+      return same_stream_ + event_dependency_ + opportunistic_ + released_;
+    }
+  };
+
+  Heap(hip::Device* device, SlabAllocator* slabs = nullptr):
+    total_size_(0), max_total_size_(0), release_threshold_(0), device_(device), slabs_(slabs) {}
   ~Heap() {}
 
   /// Adds allocation into the heap on a specific stream
@@ -124,6 +237,13 @@ public:
   /// Releases all memory, safe to the provided stream, until the threshold value is met
   bool ReleaseAllMemory();
 
+  /// Releases memory freed before the provided time, the oldest first, until the threshold is met
+  void ReleaseAgedMemory(uint64_t free_time);
+
+  /// Releases idle allocations smaller than the requested size, the smallest first, until their
+  /// memory can back a single allocation of the requested size. Returns the released bytes
+  size_t CompactFor(size_t size);
+
   /// Remove the provided stream from the safe list
   void RemoveStream(Stream* stream);
 
@@ -148,6 +268,12 @@ public:
   /// Set maximum total, allocated by the heap
   void SetMaxTotalSize(uint64_t value) { max_total_size_ = value; }
 
+  /// Get the reuse counters of the heap
+  const ReuseStats& GetReuseStats() const { return reuse_stats_; }
+
+  /// Reset the reuse counters of the heap
+  void ResetReuseStats() { reuse_stats_ = {}; }
+
   /// Erases single allocation form the heap's map
   SortedMap::iterator EraseAllocaton(SortedMap::iterator& it);
 
@@ -165,16 +291,45 @@ public:
   const auto& Allocations() { return allocations_; }
 
 private:
+  /// Number of sub-buckets per power-of-two size class (must be a power of two)
+  static constexpr uint32_t kSizeSubBuckets = 4;
+  /// Maximum number of LIFO entries probed on the same-stream fast path
+  static constexpr size_t kMaxBinProbe = 8;
+  /// Bin length, which triggers compaction of stale entries
+  static constexpr size_t kBinCompactSize = 64;
+
+  typedef std::pair<size_t, amd::Memory*> BinEntry;  //!< Allocation key in the sorted map
+  typedef std::vector<BinEntry> FreeList;             //!< LIFO list of allocations in one bin
+  typedef std::unordered_map<uint32_t, FreeList> StreamBins;  //!< Size class bins of a stream
+
+  /// Returns the size class for the provided size: log2 with kSizeSubBuckets sub-buckets
+  static uint32_t SizeClass(size_t size);
+
+  /// Adds a new allocation into the size class bins of the provided stream
+  void AddToBin(const BinEntry& entry, Stream* stream);
+
+  /// Looks up for a same-stream allocation in the size class bins, O(1) for the most recent reuse
+  amd::Memory* FindMemoryInBin(size_t size, Stream* stream, MemoryTimestamp* ts);
+
+  /// Removes entries, which are no longer present in the sorted map, from the list
+  void CompactBin(FreeList& list);
+
+  /// Updates the reuse counters with the reason of the found allocation
+  void CountReuse(MemoryTimestamp::Reuse reuse);
+
   Heap() = delete;
   Heap(const Heap&) = delete;
   Heap& operator=(const Heap&) = delete;
 
   SortedMap allocations_;       //!< Map of allocations on a specific stream
+  std::unordered_map<Stream*, StreamBins> bins_;  //!< Per-stream size class index of allocations_
   uint64_t total_size_;         //!< Size of all allocations in the heap
   uint64_t max_total_size_;     //!< Maximum heap allocation size
   uint64_t release_threshold_;  //!< Threshold size in bytes for memory release from heap, default 0
+  ReuseStats reuse_stats_;      //!< Counters of successful lookups in the heap
 
   hip::Device*  device_;    //!< Hip device the allocations will reside
+  SlabAllocator* slabs_;    //!< Slab allocator, which owns small allocations
 };
 
 /// Allocates memory in the pool on the specified stream and places the allocation into busy_heap_
@@ -189,16 +344,33 @@ class MemoryPool : public amd::ReferenceCountedObject {
   };
 
   static constexpr uint32_t kMaxMgpuAccess = 32;
+  static constexpr uint32_t kMaxSharedChunks = 512;   //!< The size of the shared chunk table
+  static constexpr uint32_t kSharedRingSize = 4096;   //!< The number of slots in the block ring
+
+  /// A block of a pool chunk, handed off to the importing process
+  struct SharedBlock {
+    std::atomic<uint64_t> sequence_;  //!< Slot sequence number of the lock-free ring
+    uint64_t chunk_;                  //!< Index of the chunk in the shared chunk table
+    uint64_t offset_;                 //!< Offset of the block in the chunk
+    uint64_t size_;                   //!< Size of the block
+  };
+
   struct SharedMemPool {
     amd::Os::FileDesc handle_;            //!< File descriptor for shared memory
     uint32_t state_;                      //!< Memory pool state
     uint32_t access_size_;                //!< The number of entries in access array
     SharedAccess access_[kMaxMgpuAccess]; //!< The list of devices for access
+    std::atomic<uint32_t> chunk_count_;   //!< The number of published chunks
+    SharedMemPointer chunks_[kMaxSharedChunks]; //!< IPC handles of the exported chunks
+    std::atomic<uint64_t> ring_head_;     //!< The next slot for a receive
+    std::atomic<uint64_t> ring_tail_;     //!< The next slot for a send
+    SharedBlock ring_[kSharedRingSize];   //!< Blocks in flight between the processes
   };
 
   MemoryPool(hip::Device* device, const hipMemPoolProps* props = nullptr, bool phys_mem = false)
-      : busy_heap_(device),
-        free_heap_(device),
+      : slabs_(device),
+        busy_heap_(device, &slabs_),
+        free_heap_(device, &slabs_),
         lock_pool_ops_(true), /* Pool operations */
         device_(device),
         shared_(nullptr),
@@ -229,6 +401,12 @@ class MemoryPool : public amd::ReferenceCountedObject {
     ReleaseAllMemory();
     // Remove memory pool from the list of all pool on the current device
     device_->RemoveMemoryPool(this);
+    for (auto it : exported_chunks_) {
+      it.first->release();
+    }
+    for (auto ptr : imported_chunks_) {
+      device_->devices()[0]->IpcDetach(ptr);
+    }
     if (shared_ != nullptr) {
       // Note: The app supposes to close the handle... Double close in Windows will cause a crash
       amd::Os::CloseIpcMemory(0, shared_, sizeof(SharedMemPool));
@@ -269,6 +447,15 @@ class MemoryPool : public amd::ReferenceCountedObject {
   /// Trims the pool until it has only min_bytes_to_hold
   void TrimTo(size_t min_bytes_to_hold);
 
+  /// Trims aged memory above the release threshold, if the pool was idle for the trim interval
+  void TrimIdle();
+
+  /// Returns the current percent of reserved memory, which isn't in use
+  uint64_t Fragmentation() const {
+    uint64_t reserved = busy_heap_.GetTotalSize() + free_heap_.GetTotalSize();
+    return (reserved != 0) ? (free_heap_.GetTotalSize() * 100) / reserved : 0;
+  }
+
   /// Trims the pool until it has only min_bytes_to_hold
   hip::Device* Device() const { return device_; }
 
@@ -293,6 +480,15 @@ class MemoryPool : public amd::ReferenceCountedObject {
   /// Imports memory pool from an OS specific handle
   bool Import(amd::Os::FileDesc handle);
 
+  /// Publishes the chunks of all busy allocations in the shared chunk table
+  hipError_t ExportChunks(size_t* num_chunks);
+
+  /// Places a busy block of the exported pool into the shared ring
+  hipError_t SendBlock(void* ptr, size_t size);
+
+  /// Takes the next block from the shared ring. Imports the new chunks on demand
+  hipError_t ReceiveBlock(void** ptr, size_t* size);
+
   /// Returns properties of this memory pool
   const hipMemPoolProps& Properties() const { return properties_; }
 
@@ -308,8 +504,15 @@ class MemoryPool : public amd::ReferenceCountedObject {
   MemoryPool(const MemoryPool&) = delete;
   MemoryPool& operator=(const MemoryPool&) = delete;
 
-  Heap busy_heap_;    //!< Heap of busy allocations
-  Heap free_heap_;    //!< Heap of freed allocations
+  /// Returns the chunk of a busy allocation and the offset in it. Nullptr if it isn't in the pool
+  amd::Memory* FindChunk(void* ptr, size_t* offset);
+
+  /// Publishes the chunk in the shared table on the first use and returns its index
+  bool ExportChunk(amd::Memory* chunk, uint32_t* index);
+
+  SlabAllocator slabs_;  //!< Slab allocator for small allocations
+  Heap busy_heap_;       //!< Heap of busy allocations
+  Heap free_heap_;       //!< Heap of freed allocations
   union {
     struct {
       uint32_t event_dependencies_ : 1;     //!< Event dependencies tracking is enabled
@@ -329,6 +532,30 @@ class MemoryPool : public amd::ReferenceCountedObject {
   hip::Device*  device_;    //!< Hip device the heap will reside
   SharedMemPool* shared_;   //!< Pointer to shared memory for IPC
   uint64_t max_total_size_; //!< Max of total reserved memory in the pool since last reset
+  uint64_t last_activity_ = 0;  //!< Time in ns of the last allocation or release in the pool
+  uint64_t alloc_new_ = 0;      //!< The number of allocations, which required new memory
+  uint64_t max_fragmentation_ = 0;  //!< Peak of unused reserved memory in percent since reset
+  std::unordered_map<amd::Memory*, uint32_t> exported_chunks_;  //!< Shared table index of chunks
+  std::vector<void*> imported_chunks_;  //!< Base pointers of the imported shared chunks
+  bool imported_ = false;   //!< The pool was imported from another process
+};
+
+/// Background thread, which trims idle memory pools of a device above the release threshold
+class MemoryPoolTrimmer : public amd::Thread {
+ public:
+  MemoryPoolTrimmer(hip::Device* device)
+      : amd::Thread("Memory Pool Trim Thread", CQ_THREAD_STACK_SIZE),
+        device_(device), terminate_(false) {}
+
+  //! The trim thread entry point
+  void run(void* data);
+
+  //! Stops the thread and waits for the exit
+  void Terminate();
+
+ private:
+  hip::Device* device_;       //!< Hip device with the memory pools for trimming
+  volatile bool terminate_;   //!< The thread must exit
 };
 
 
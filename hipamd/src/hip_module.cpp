@@ -350,6 +350,12 @@ hipError_t ihipLaunchKernelCommand(amd::Command*& command, hipFunction_t f,
   if (flags & hipExtAnyOrderLaunch) {
     params |= amd::NDRangeKernelCommand::AnyOrderLaunch;
   }
+  // The hierarchical barrier replaces the device library grid sync of single grid launches
+  if (((params & amd::NDRangeKernelCommand::CooperativeMultiDeviceGroups) == 0) &&
+      (params & amd::NDRangeKernelCommand::CooperativeGroups) &&
+      ((flags & hipExtCooperativeLaunchHierarchicalSync) || HIP_COOP_HIERARCHICAL_SYNC)) {
+    params |= amd::NDRangeKernelCommand::HierarchicalGridSync;
+  }
 
   amd::NDRangeKernelCommand* kernelCommand = new amd::NDRangeKernelCommand(
       *stream, waitList, *kernel, ndrange, sharedMemBytes, params, gridId, numGrids, prevGridSum,
@@ -442,6 +448,7 @@ hipError_t ihipModuleLaunchKernel(hipFunction_t f, uint32_t globalWorkSizeX,
       return hipErrorInvalidValue;
     }
   }
+  HIP_PHASE(Command)
   amd::Command* command = nullptr;
   hip::Stream* hip_stream = hip::getStream(hStream);
   status = ihipLaunchKernelCommand(command, f, globalWorkSizeX, globalWorkSizeY, globalWorkSizeZ,
@@ -452,6 +459,7 @@ hipError_t ihipModuleLaunchKernel(hipFunction_t f, uint32_t globalWorkSizeX,
     return status;
   }
 
+  HIP_PHASE(Submit)
   if (startEvent != nullptr) {
     hip::Event* eStart = reinterpret_cast<hip::Event*>(startEvent);
     status = eStart->addMarker(hStream, nullptr, false);
@@ -636,6 +644,17 @@ hipError_t ihipModuleLaunchCooperativeKernelMultiDevice(hipFunctionLaunchParams*
     }
   }
 
+  // With direct dispatch the packets of all devices are written first and the doorbells are
+  // rung back to back after the loop, hence the last device doesn't start later than the first
+  // by the submission time of the other devices
+  if (AMD_DIRECT_DISPATCH) {
+    for (int i = 0; i < numDevices; ++i) {
+      amd::HostQueue* queue = reinterpret_cast<hip::Stream*>(launchParamsList[i].hStream);
+      amd::ScopedLock lock(queue->vdev()->execution());
+      queue->vdev()->BeginDoorbellBatch();
+    }
+  }
+
   for (int i = 0; i < numDevices; ++i) {
     const hipFunctionLaunchParams& launch = launchParamsList[i];
     hip::Stream* hip_stream = reinterpret_cast<hip::Stream*>(launch.hStream);
@@ -658,7 +677,9 @@ hipError_t ihipModuleLaunchCooperativeKernelMultiDevice(hipFunctionLaunchParams*
     if (globalWorkSizeX > std::numeric_limits<uint32_t>::max() ||
         globalWorkSizeY > std::numeric_limits<uint32_t>::max() ||
         globalWorkSizeZ > std::numeric_limits<uint32_t>::max()) {
-      return hipErrorInvalidConfiguration;
+      // Break out of the loop to close the doorbell batches
+      result = hipErrorInvalidConfiguration;
+      break;
     }
     result = ihipModuleLaunchKernel(
         launch.function, static_cast<uint32_t>(globalWorkSizeX),
@@ -673,6 +694,14 @@ hipError_t ihipModuleLaunchCooperativeKernelMultiDevice(hipFunctionLaunchParams*
     prevGridSize += globalWorkSizeX * globalWorkSizeY * globalWorkSizeZ;
   }
 
+  if (AMD_DIRECT_DISPATCH) {
+    for (int i = 0; i < numDevices; ++i) {
+      amd::HostQueue* queue = reinterpret_cast<hip::Stream*>(launchParamsList[i].hStream);
+      amd::ScopedLock lock(queue->vdev()->execution());
+      queue->vdev()->EndDoorbellBatch();
+    }
+  }
+
   // Sync the execution streams on all devices
   if ((flags & hipCooperativeLaunchMultiDeviceNoPostSync) == 0) {
     for (int i = 0; i < numDevices; ++i) {
@@ -759,13 +788,60 @@ hipError_t hipExtLaunchKernel(const void* hostFunction, dim3 gridDim, dim3 block
                               startEvent, stopEvent, flags));
 }
 
+hipError_t hipExtLaunchKernelBatch(const hipLaunchParams* launchParamsList,
+                                   unsigned int numLaunches, hipStream_t stream,
+                                   unsigned int flags) {
+  HIP_INIT_API(hipExtLaunchKernelBatch, launchParamsList, numLaunches, stream, flags);
+
+  if ((launchParamsList == nullptr && numLaunches != 0) || (flags != 0)) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  if (!hip::isValid(stream)) {
+    HIP_RETURN(hipErrorContextIsDestroyed);
+  }
+  // All kernels of the batch go to one stream, the per launch stream may only repeat it
+  for (unsigned int i = 0; i < numLaunches; ++i) {
+    if ((launchParamsList[i].stream != nullptr) && (launchParamsList[i].stream != stream)) {
+      HIP_RETURN(hipErrorInvalidValue);
+    }
+  }
+
+  // With direct dispatch all kernels are submitted from this thread, hence the doorbell writes
+  // can be deferred and the whole batch is exposed to the HW at once.
+  amd::HostQueue* queue = AMD_DIRECT_DISPATCH ? hip::getStream(stream) : nullptr;
+  if (queue != nullptr) {
+    amd::ScopedLock lock(queue->vdev()->execution());
+    queue->vdev()->BeginDoorbellBatch();
+  }
+
+  hipError_t status = hipSuccess;
+  for (unsigned int i = 0; i < numLaunches; ++i) {
+    const hipLaunchParams& launch = launchParamsList[i];
+    status = hipLaunchKernel_common(launch.func, launch.gridDim, launch.blockDim, launch.args,
+                                    launch.sharedMem, stream);
+    if (status != hipSuccess) {
+      break;
+    }
+  }
+
+  if (queue != nullptr) {
+    amd::ScopedLock lock(queue->vdev()->execution());
+    queue->vdev()->EndDoorbellBatch();
+  }
+  HIP_RETURN(status);
+}
+
 hipError_t hipLaunchCooperativeKernel_common(const void* f, dim3 gridDim, dim3 blockDim,
                                              void** kernelParams, uint32_t sharedMemBytes,
-                                             hipStream_t hStream) {
+                                             hipStream_t hStream, uint32_t flags = 0) {
   if (!hip::isValid(hStream)) {
     return hipErrorContextIsDestroyed;
   }
 
+  if ((flags & ~hipExtCooperativeLaunchHierarchicalSync) != 0) {
+    return hipErrorInvalidValue;
+  }
+
   if (f == nullptr) {
     return hipErrorInvalidDeviceFunction;
   }
@@ -795,7 +871,7 @@ hipError_t hipLaunchCooperativeKernel_common(const void* f, dim3 gridDim, dim3 b
                                 static_cast<uint32_t>(globalWorkSizeY),
                                 static_cast<uint32_t>(globalWorkSizeZ), blockDim.x, blockDim.y,
                                 blockDim.z, sharedMemBytes, hStream, kernelParams, nullptr, nullptr,
-                                nullptr, 0, amd::NDRangeKernelCommand::CooperativeGroups);
+                                nullptr, flags, amd::NDRangeKernelCommand::CooperativeGroups);
 }
 
 hipError_t hipLaunchCooperativeKernel(const void* f, dim3 gridDim, dim3 blockDim,
@@ -806,6 +882,15 @@ hipError_t hipLaunchCooperativeKernel(const void* f, dim3 gridDim, dim3 blockDim
                                                hStream));
 }
 
+hipError_t hipExtLaunchCooperativeKernel(const void* f, dim3 gridDim, dim3 blockDim,
+                                         void** kernelParams, uint32_t sharedMemBytes,
+                                         hipStream_t hStream, uint32_t flags) {
+  HIP_INIT_API(hipExtLaunchCooperativeKernel, f, gridDim, blockDim, sharedMemBytes, hStream,
+               flags);
+  HIP_RETURN(hipLaunchCooperativeKernel_common(f, gridDim, blockDim, kernelParams, sharedMemBytes,
+                                               hStream, flags));
+}
+
 hipError_t hipLaunchCooperativeKernel_spt(const void* f, dim3 gridDim, dim3 blockDim,
                                           void** kernelParams, uint32_t sharedMemBytes,
                                           hipStream_t hStream) {
@@ -21,6 +21,7 @@
 #include <hip/hip_runtime.h>
 
 #include "hip_internal.hpp"
+#include "hip_graph_helper.hpp"
 
 namespace hip {
 
@@ -219,6 +220,208 @@ hipError_t hipMemcpyPeerAsync(void* dst, int dstDevice, const void* src, int src
   HIP_RETURN(ihipMemcpy(dst, src, sizeBytes, hipMemcpyDeviceToDevice, *hip_stream, true, true));
 }
 
+namespace {
+
+//! A copy of the multi-device plan. The destination pulls the data from its parent
+struct CopyHop {
+  int parent_;       //!< Index of the hop, which delivers the source data, -1 for the app source
+  int device_;       //!< Device of the destination
+  void* dst_;        //!< Destination of the copy
+  const void* src_;  //!< Source of the copy
+};
+
+// ================================================================================================
+uint64_t linkCost(int device1, int device2) {
+  if (device1 == device2) {
+    return 0;
+  }
+  std::vector<amd::Device::LinkAttrType> link_attrs;
+  link_attrs.push_back(std::make_pair(amd::Device::LinkAttribute::kLinkHopCount, 0));
+  link_attrs.push_back(std::make_pair(amd::Device::LinkAttribute::kLinkDistance, 0));
+  if (findLinkInfo(device1, device2, &link_attrs) != hipSuccess) {
+    // Unknown topology, consider the devices far apart
+    return std::numeric_limits<uint32_t>::max();
+  }
+  // The hop count dominates, the link weight breaks the ties
+  return (static_cast<uint64_t>(link_attrs[0].second) << 32) |
+         static_cast<uint32_t>(link_attrs[1].second);
+}
+
+// ================================================================================================
+// Builds a spanning tree, in which every destination pulls the data from the closest device,
+// which already has it. A busy parent loses the ties, so each link carries the data once and
+// the tree spreads over the topology instead of a star around the source.
+void planBroadcast(std::vector<CopyHop>* hops, void* const* dsts, const int* devices,
+                   size_t num, const void* src, int srcDevice) {
+  std::vector<bool> planned(num, false);
+  std::vector<uint32_t> fanout;
+  uint32_t src_fanout = 0;
+  for (size_t count = 0; count < num; ++count) {
+    size_t best_dst = 0;
+    int best_parent = -1;
+    uint64_t best_cost = std::numeric_limits<uint64_t>::max();
+    uint32_t best_fanout = std::numeric_limits<uint32_t>::max();
+    for (size_t i = 0; i < num; ++i) {
+      if (planned[i]) {
+        continue;
+      }
+      for (int parent = -1; parent < static_cast<int>(hops->size()); ++parent) {
+        const int device = (parent < 0) ? srcDevice : (*hops)[parent].device_;
+        const uint32_t busy = (parent < 0) ? src_fanout : fanout[parent];
+        const uint64_t cost = linkCost(device, devices[i]);
+        if ((cost < best_cost) || ((cost == best_cost) && (busy < best_fanout))) {
+          best_dst = i;
+          best_parent = parent;
+          best_cost = cost;
+          best_fanout = busy;
+        }
+      }
+    }
+    planned[best_dst] = true;
+    if (best_parent < 0) {
+      src_fanout++;
+    } else {
+      fanout[best_parent]++;
+    }
+    const void* hop_src = (best_parent < 0) ? src : (*hops)[best_parent].dst_;
+    hops->push_back({best_parent, devices[best_dst], dsts[best_dst], hop_src});
+    fanout.push_back(0);
+  }
+}
+
+// ================================================================================================
+// Issues the plan on the queues of the destination devices. The copies are split into chunks,
+// hence a child copies a chunk, while its parent receives the next one.
+hipError_t executePlan(const std::vector<CopyHop>& hops, size_t sizeBytes, size_t chunkSize,
+                       hip::Stream& stream) {
+  const size_t num_chunks = (sizeBytes + chunkSize - 1) / chunkSize;
+  // The commands of all hops and chunks, the children wait on the same chunk of the parent
+  std::vector<amd::Command*> commands(hops.size() * num_chunks, nullptr);
+  amd::Command* start = stream.getLastQueuedCommand(true);
+  hipError_t status = hipSuccess;
+  for (size_t hop = 0; (hop < hops.size()) && (status == hipSuccess); ++hop) {
+    hip::Stream* queue = hip::getNullStream(*g_devices[hops[hop].device_]->asContext());
+    for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+      const size_t offset = chunk * chunkSize;
+      const size_t size = std::min(chunkSize, sizeBytes - offset);
+      amd::Command* command = nullptr;
+      status = ihipMemcpyCommand(command, reinterpret_cast<address>(hops[hop].dst_) + offset,
+          reinterpret_cast<const_address>(hops[hop].src_) + offset, size,
+          hipMemcpyDeviceToDevice, *queue, true);
+      if (status != hipSuccess) {
+        break;
+      }
+      amd::Command::EventWaitList waitList;
+      if (hops[hop].parent_ >= 0) {
+        waitList.push_back(commands[hops[hop].parent_ * num_chunks + chunk]);
+      } else if ((chunk == 0) && (start != nullptr)) {
+        waitList.push_back(start);
+      }
+      command->updateEventWaitList(waitList);
+      command->enqueue();
+      commands[hop * num_chunks + chunk] = command;
+    }
+  }
+  // The queues are in order, hence the last chunks complete the copies
+  amd::Command::EventWaitList waitList;
+  for (size_t hop = 0; hop < hops.size(); ++hop) {
+    if (commands[hop * num_chunks + num_chunks - 1] != nullptr) {
+      waitList.push_back(commands[hop * num_chunks + num_chunks - 1]);
+    }
+  }
+  if (!waitList.empty()) {
+    amd::Command* marker = new amd::Marker(stream, true, waitList);
+    if (marker != nullptr) {
+      marker->enqueue();
+      marker->release();
+    }
+  }
+  for (auto command : commands) {
+    if (command != nullptr) {
+      command->release();
+    }
+  }
+  if (start != nullptr) {
+    start->release();
+  }
+  return status;
+}
+
+// ================================================================================================
+hipError_t validatePlan(void* const* dsts, const int* dstDevices, size_t numDsts, const void* src,
+                        int srcDevice, size_t sizeBytes, size_t srcStride, hipStream_t stream) {
+  const int numDevices = static_cast<int>(g_devices.size());
+  if ((dsts == nullptr) || (dstDevices == nullptr) || (src == nullptr) || (numDsts == 0)) {
+    return hipErrorInvalidValue;
+  }
+  if ((srcDevice < 0) || (srcDevice >= numDevices)) {
+    return hipErrorInvalidDevice;
+  }
+  if (!hip::isValid(stream)) {
+    return hipErrorContextIsDestroyed;
+  }
+  for (size_t i = 0; i < numDsts; ++i) {
+    if ((dstDevices[i] < 0) || (dstDevices[i] >= numDevices)) {
+      return hipErrorInvalidDevice;
+    }
+    hipError_t status = ihipMemcpy_validate(dsts[i],
+        reinterpret_cast<const_address>(src) + i * srcStride, sizeBytes, hipMemcpyDeviceToDevice);
+    if (status != hipSuccess) {
+      return status;
+    }
+  }
+  return hipSuccess;
+}
+
+}  // namespace
+
+// ================================================================================================
+hipError_t hipExtMemcpyBroadcastAsync(void* const* dsts, const int* dstDevices, size_t numDsts,
+                                      const void* src, int srcDevice, size_t sizeBytes,
+                                      hipStream_t stream) {
+  HIP_INIT_API(hipExtMemcpyBroadcastAsync, dsts, dstDevices, numDsts, src, srcDevice, sizeBytes,
+               stream);
+  constexpr size_t kSrcStride = 0;
+  HIP_RETURN_ONFAIL(validatePlan(dsts, dstDevices, numDsts, src, srcDevice, sizeBytes,
+                                 kSrcStride, stream));
+  hip::Stream* hip_stream = hip::getStream(stream);
+  if (hip_stream == nullptr) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  if (sizeBytes == 0) {
+    HIP_RETURN(hipSuccess);
+  }
+  std::vector<CopyHop> hops;
+  hops.reserve(numDsts);
+  planBroadcast(&hops, dsts, dstDevices, numDsts, src, srcDevice);
+  const size_t chunkSize = (HIP_BROADCAST_CHUNK_SIZE != 0) ?
+      static_cast<size_t>(HIP_BROADCAST_CHUNK_SIZE) * Mi : sizeBytes;
+  HIP_RETURN(executePlan(hops, sizeBytes, chunkSize, *hip_stream));
+}
+
+// ================================================================================================
+hipError_t hipExtMemcpyScatterAsync(void* const* dsts, const int* dstDevices, size_t numDsts,
+                                    const void* src, int srcDevice, size_t sizeBytes,
+                                    hipStream_t stream) {
+  HIP_INIT_API(hipExtMemcpyScatterAsync, dsts, dstDevices, numDsts, src, srcDevice, sizeBytes,
+               stream);
+  HIP_RETURN_ONFAIL(validatePlan(dsts, dstDevices, numDsts, src, srcDevice, sizeBytes,
+                                 sizeBytes, stream));
+  hip::Stream* hip_stream = hip::getStream(stream);
+  if (hip_stream == nullptr) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  if (sizeBytes == 0) {
+    HIP_RETURN(hipSuccess);
+  }
+  // Every slice crosses its own route once, hence the destinations pull the slices in parallel
+  std::vector<CopyHop> hops(numDsts);
+  for (size_t i = 0; i < numDsts; ++i) {
+    hops[i] = {-1, dstDevices[i], dsts[i], reinterpret_cast<const_address>(src) + i * sizeBytes};
+  }
+  HIP_RETURN(executePlan(hops, sizeBytes, sizeBytes, *hip_stream));
+}
+
 hipError_t hipCtxEnablePeerAccess(hipCtx_t peerCtx, unsigned int flags) {
   HIP_INIT_API(hipCtxEnablePeerAccess, peerCtx, flags);
 
@@ -0,0 +1,90 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "hip_internal.hpp"
+#include "hip_phase_profile.hpp"
+
+#if HIP_PHASE_PROFILE
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+namespace hip {
+
+thread_local PhaseProfile* PhaseProfile::current_ = nullptr;
+
+namespace {
+
+constexpr uint32_t kNumApis = HIP_API_ID_LAST + 1;
+constexpr uint32_t kNumPhases = static_cast<uint32_t>(ApiPhase::Count);
+
+//! Accumulated time of every phase and the number of calls per API id
+struct ApiPhaseTimes {
+  std::atomic<uint64_t> calls_{0};
+  std::atomic<uint64_t> ns_[kNumPhases] = {};
+};
+
+ApiPhaseTimes phaseTimes[kNumApis];
+
+// ================================================================================================
+void printPhaseProfile() {
+  fprintf(stderr, "HIP API phase profile, average ns per call\n");
+  fprintf(stderr, "%-40s %10s %10s %10s %10s %10s %10s %12s\n", "API", "calls", "init",
+          "validate", "lookup", "command", "submit", "total");
+  for (uint32_t api = 0; api < kNumApis; ++api) {
+    const uint64_t calls = phaseTimes[api].calls_.load(std::memory_order_relaxed);
+    if (calls == 0) {
+      continue;
+    }
+    uint64_t avg[kNumPhases];
+    uint64_t total = 0;
+    for (uint32_t phase = 0; phase < kNumPhases; ++phase) {
+      avg[phase] = phaseTimes[api].ns_[phase].load(std::memory_order_relaxed) / calls;
+      total += avg[phase];
+    }
+    fprintf(stderr, "%-40s %10lu %10lu %10lu %10lu %10lu %10lu %12lu\n",
+            (api == HIP_API_ID_NONE) ? "<untraced API>" : hip_api_name(api), calls, avg[0],
+            avg[1], avg[2], avg[3], avg[4], total);
+  }
+}
+
+}  // namespace
+
+// ================================================================================================
+void PhaseProfile::init() {
+  std::atexit(printPhaseProfile);
+}
+
+// ================================================================================================
+void PhaseProfile::accountPhase(uint32_t api, ApiPhase phase, uint64_t ns) {
+  if (api < kNumApis) {
+    phaseTimes[api].ns_[static_cast<uint32_t>(phase)].fetch_add(ns, std::memory_order_relaxed);
+  }
+}
+
+// ================================================================================================
+void PhaseProfile::accountCall(uint32_t api) {
+  if (api < kNumApis) {
+    phaseTimes[api].calls_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace hip
+#endif  // HIP_PHASE_PROFILE
@@ -0,0 +1,114 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#ifndef HIP_SRC_HIP_PHASE_PROFILE_H
+#define HIP_SRC_HIP_PHASE_PROFILE_H
+
+#include "os/os.hpp"
+
+#include <cstdint>
+
+namespace hip {
+
+//! The phases of a HIP API call, which the runtime overhead breakdown reports
+enum class ApiPhase : uint32_t {
+  Init = 0,       //!< Thread and runtime initialization, logging and the tracer callbacks
+  Validate,       //!< Argument validation, the default phase after the initialization
+  PointerLookup,  //!< MemObjMap lookups of the pointer arguments
+  Command,        //!< Construction of the runtime command
+  Submit,         //!< Enqueue and dispatch of the command
+  Count
+};
+
+#if HIP_PHASE_PROFILE
+//! Accumulates the time of every phase of the HIP API calls per API id. Compiled in with the
+//! HIP_PHASE_PROFILE build option, the table is printed at the exit
+class PhaseProfile {
+ public:
+  //! Starts the phase timing of an API call, the calls of nested APIs keep their own timing
+  explicit PhaseProfile(uint32_t api) : api_(api), parent_(current_) {
+    current_ = this;
+    start_ = amd::Os::timeNanos();
+  }
+
+  ~PhaseProfile() {
+    const uint64_t now = amd::Os::timeNanos();
+    account(now);
+    accountCall(api_);
+    current_ = parent_;
+  }
+
+  //! Switches the current API call to the phase
+  static void enter(ApiPhase phase) {
+    PhaseProfile* profile = current_;
+    if ((profile != nullptr) && (profile->phase_ != phase)) {
+      const uint64_t now = amd::Os::timeNanos();
+      profile->account(now);
+      profile->phase_ = phase;
+    }
+  }
+
+  //! Registers the print of the table at the exit. Called by hip::init()
+  static void init();
+
+  //! Returns the phase of the current API call
+  static ApiPhase current() {
+    return (current_ != nullptr) ? current_->phase_ : ApiPhase::Validate;
+  }
+
+  //! Switches to a phase for the lifetime of the scope and restores the previous one
+  class Scope {
+   public:
+    explicit Scope(ApiPhase phase) : previous_(current()) { enter(phase); }
+    ~Scope() { enter(previous_); }
+
+   private:
+    ApiPhase previous_;  //!< The phase before the scope
+  };
+
+ private:
+  //! Adds the time since the last switch to the current phase
+  void account(uint64_t now) {
+    accountPhase(api_, phase_, now - start_);
+    start_ = now;
+  }
+
+  static void accountPhase(uint32_t api, ApiPhase phase, uint64_t ns);
+  static void accountCall(uint32_t api);
+
+  uint32_t api_;                         //!< HIP API id of the call
+  ApiPhase phase_ = ApiPhase::Init;      //!< The current phase
+  uint64_t start_;                       //!< Start of the current phase
+  PhaseProfile* parent_;                 //!< The profile of the outer API call
+  static thread_local PhaseProfile* current_;  //!< The innermost API call of the thread
+};
+
+#define HIP_PHASE_API(cid) hip::PhaseProfile phaseProfile(HIP_API_ID_##cid);
+#define HIP_PHASE(phase) hip::PhaseProfile::enter(hip::ApiPhase::phase);
+#define HIP_PHASE_SCOPE(phase) hip::PhaseProfile::Scope phaseScope(hip::ApiPhase::phase);
+#else
+#define HIP_PHASE_API(cid)
+#define HIP_PHASE(phase)
+#define HIP_PHASE_SCOPE(phase)
+#endif
+
+}  // namespace hip
+
+#endif  // HIP_SRC_HIP_PHASE_PROFILE_H
@@ -340,7 +340,8 @@ hipError_t ihipOccupancyMaxActiveBlocksPerMultiprocessor(
   hip::DeviceFunc* function = hip::DeviceFunc::asFunction(func);
   const amd::Kernel& kernel = *function->kernel();
 
-  const device::Kernel::WorkGroupInfo* wrkGrpInfo = kernel.getDeviceKernel(device)->workGroupInfo();
+  const device::Kernel* devKernel = kernel.getDeviceKernel(device);
+  const device::Kernel::WorkGroupInfo* wrkGrpInfo = devKernel->workGroupInfo();
   if (bCalcPotentialBlkSz == false) {
     if (inputBlockSize <= 0) {
       return hipErrorInvalidValue;
@@ -361,6 +362,16 @@ hipError_t ihipOccupancyMaxActiveBlocksPerMultiprocessor(
       inputBlockSize = device.info().maxWorkGroupSize_;
     }
   }
+  // The result depends only on the kernel metadata, hence the repeated queries are cache hits
+  const uint64_t key =
+      device::Kernel::OccupancyKey(inputBlockSize, dynamicSMemSize, bCalcPotentialBlkSz);
+  device::Kernel::Occupancy occupancy;
+  if (devKernel->findOccupancy(key, &occupancy)) {
+    *maxBlocksPerCU = occupancy.maxBlocksPerCU_;
+    *numBlocksPerGrid = occupancy.numBlocksPerGrid_;
+    *bestBlockSize = occupancy.bestBlockSize_;
+    return hipSuccess;
+  }
   // Find wave occupancy per CU => simd_per_cu * GPR usage
   size_t MaxWavesPerSimd;
 
@@ -434,6 +445,7 @@ hipError_t ihipOccupancyMaxActiveBlocksPerMultiprocessor(
   // Unless those blocks are further constrained by LDS size.
   *numBlocksPerGrid = (maxCUs * std::min(bestBlocksPerCU, lds_occupancy_wgs));
 
+  devKernel->addOccupancy(key, {*maxBlocksPerCU, *numBlocksPerGrid, *bestBlockSize});
   return hipSuccess;
 }
 }  // namespace hip_impl
@@ -736,6 +748,9 @@ void PlatformState::init() {
   for (auto& it : statCO_.functions_) {
     it.second->resize_dFunc(g_devices.size());
   }
+  if (HIP_FATBIN_LOAD_THREADS > 0) {
+    statCO_.preloadFatBinaries(HIP_FATBIN_LOAD_THREADS);
+  }
 }
 
 hipError_t PlatformState::loadModule(hipModule_t* module, const char* fname, const void* image) {
@@ -818,19 +833,8 @@ hipError_t PlatformState::getDynGlobalVar(const char* hostVar, hipModule_t hmod,
   if (dev_ptr) {
     *dev_ptr = nullptr;
   }
-  IHIP_RETURN_ONFAIL(it->second->getManagedVarPointer(hostVar, dev_ptr, size_ptr));
-  // if dev_ptr is nullptr, hostvar is not in managed variable list
-  if ((dev_ptr && *dev_ptr == nullptr) || (size_ptr && *size_ptr == 0)) {
-    hip::DeviceVar* dvar = nullptr;
-    IHIP_RETURN_ONFAIL(it->second->getDeviceVar(&dvar, hostVar));
-    if (dev_ptr != nullptr) {
-      *dev_ptr = dvar->device_ptr();
-    }
-    if (size_ptr != nullptr) {
-      *size_ptr = dvar->size();
-    }
-  }
-  return hipSuccess;
+  // The module caches the resolved pointer, hence the repeated queries skip the var lookups
+  return it->second->getGlobalVar(hostVar, dev_ptr, size_ptr);
 }
 
 hipError_t PlatformState::registerTexRef(textureReference* texRef, hipModule_t hmod,
@@ -895,6 +899,8 @@ hip::FatBinaryInfo** PlatformState::addFatBinary(const void* data) {
 }
 
 hipError_t PlatformState::removeFatBinary(hip::FatBinaryInfo** module) {
+  // Drop the resolved functions of all threads, since the module deletes its functions
+  statFuncGeneration_.fetch_add(1, std::memory_order_acq_rel);
   return statCO_.removeFatBinary(module);
 }
 
@@ -914,9 +920,40 @@ const char* PlatformState::getStatFuncName(const void* hostFunction) {
   return statCO_.getStatFuncName(hostFunction);
 }
 
+namespace {
+// Functions, resolved by the current thread, for every host function and device. The launch
+// path hits it without the lock of the static code objects
+struct StatFuncCache {
+  uint64_t generation_ = 0;   //!< Generation of the static code objects, which filled the cache
+  std::unordered_map<const void*, std::vector<hipFunction_t>> funcs_;
+};
+thread_local StatFuncCache statFuncCache;
+}  // namespace
+
 hipError_t PlatformState::getStatFunc(hipFunction_t* hfunc, const void* hostFunction,
                                       int deviceId) {
-  return statCO_.getStatFunc(hfunc, hostFunction, deviceId);
+  StatFuncCache& cache = statFuncCache;
+  const uint64_t generation = statFuncGeneration_.load(std::memory_order_acquire);
+  if (cache.generation_ != generation) {
+    cache.funcs_.clear();
+    cache.generation_ = generation;
+  }
+  auto it = cache.funcs_.find(hostFunction);
+  if ((it != cache.funcs_.end()) && (static_cast<size_t>(deviceId) < it->second.size()) &&
+      (it->second[deviceId] != nullptr)) {
+    *hfunc = it->second[deviceId];
+    return hipSuccess;
+  }
+  hipError_t status = statCO_.getStatFunc(hfunc, hostFunction, deviceId);
+  // Only the resolved functions are cached, the failures must be reported again
+  if ((status == hipSuccess) && (deviceId >= 0)) {
+    auto& funcs = cache.funcs_[hostFunction];
+    if (funcs.size() <= static_cast<size_t>(deviceId)) {
+      funcs.resize(std::max(g_devices.size(), static_cast<size_t>(deviceId) + 1), nullptr);
+    }
+    funcs[deviceId] = *hfunc;
+  }
+  return status;
 }
 
 hipError_t PlatformState::getStatFuncAttr(hipFuncAttributes* func_attr, const void* hostFunction,
@@ -24,6 +24,8 @@
 #include "device/device.hpp"
 #include "hip_code_object.hpp"
 
+#include <atomic>
+
 namespace hip_impl {
 
 hipError_t ihipOccupancyMaxActiveBlocksPerMultiprocessor(
@@ -122,5 +124,8 @@ class PlatformState {
   std::unordered_map<std::string, std::shared_ptr<UniqueFD>> ufd_map_; //!< Unique File Desc Map
 
   void* dynamicLibraryHandle_{nullptr};
+
+  //! Invalidates the per-thread caches of resolved static functions
+  std::atomic<uint64_t> statFuncGeneration_{1};
 };
 }  // namespace hip
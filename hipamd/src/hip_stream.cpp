@@ -23,6 +23,7 @@
 #include "hip_event.hpp"
 #include "thread/monitor.hpp"
 #include "hip_prof_api.h"
+#include <algorithm>
 #include <atomic>
 
 namespace hip {
@@ -42,6 +43,13 @@ Stream::Stream(hip::Device* dev, Priority p, unsigned int f, bool null_stream,
       originStream_(false),
       captureID_(0)
       {
+        if (flags_ & hipExtStreamWaitSpin) {
+          setWaitPolicy(WaitPolicy::Spin);
+        } else if (flags_ & hipExtStreamWaitBlocking) {
+          setWaitPolicy(WaitPolicy::Blocking);
+        } else if (flags_ & hipExtStreamWaitAdaptive) {
+          setWaitPolicy(WaitPolicy::Adaptive);
+        }
         device_->AddStream(this);
       }
 
@@ -175,15 +183,90 @@ bool Stream::StreamCaptureOngoing(hipStream_t hStream) {
 // ================================================================================================
 void CL_CALLBACK ihipStreamCallback(cl_event event, cl_int command_exec_status, void* user_data) {
   StreamCallback* cbo = reinterpret_cast<StreamCallback*>(user_data);
+  hip::Stream* hip_stream = static_cast<hip::Stream*>(as_amd(event)->command().queue());
+  CallbackDispatcher* dispatcher =
+      (hip_stream != nullptr) ? hip_stream->GetDevice()->GetCallbackDispatcher() : nullptr;
+  if (dispatcher != nullptr) {
+    dispatcher->Enqueue(cbo);
+    return;
+  }
   cbo->callback();
   delete cbo;
 }
 
+// ================================================================================================
+void CallbackDispatcher::run(void* data) {
+  if (ROC_NUMA_AFFINITY) {
+    amd::Os::setThreadNumaNode(numa_node_);
+  }
+  std::vector<StreamCallback*> batch;
+  while (true) {
+    {
+      amd::ScopedLock lock(lock_);
+      while (pending_.empty() && !terminate_) {
+        lock_.wait();
+      }
+      if (pending_.empty()) {
+        break;
+      }
+      // Take all ready callbacks at once, so the producers don't wait for the execution
+      batch.swap(pending_);
+    }
+    for (auto cbo : batch) {
+      cbo->callback();
+      delete cbo;
+    }
+    {
+      amd::ScopedLock lock(lock_);
+      completed_ += batch.size();
+      lock_.notifyAll();
+    }
+    batch.clear();
+  }
+}
+
+// ================================================================================================
+void CallbackDispatcher::Enqueue(StreamCallback* cbo) {
+  amd::ScopedLock lock(lock_);
+  pending_.push_back(cbo);
+  ++submitted_;
+  lock_.notifyAll();
+}
+
+// ================================================================================================
+void CallbackDispatcher::Wait() {
+  if (amd::Thread::current() == this) {
+    // A callback can't wait for itself
+    return;
+  }
+  amd::ScopedLock lock(lock_);
+  const uint64_t target = submitted_;
+  while (completed_ < target) {
+    lock_.wait();
+  }
+}
+
+// ================================================================================================
+void CallbackDispatcher::Terminate() {
+  {
+    amd::ScopedLock lock(lock_);
+    terminate_ = true;
+    lock_.notifyAll();
+  }
+  while ((state() != amd::Thread::FINISHED) && (state() != amd::Thread::FAILED)) {
+    amd::Os::yield();
+  }
+}
+
 // ================================================================================================
 static hipError_t ihipStreamCreate(hipStream_t* stream,
                                   unsigned int flags, hip::Stream::Priority priority,
                                   const std::vector<uint32_t>& cuMask = {}) {
-  if (flags != hipStreamDefault && flags != hipStreamNonBlocking) {
+  unsigned int waitFlags = flags & IHIP_STREAM_WAIT_FLAGS;
+  // Only a single wait policy can be requested
+  if (((flags & ~IHIP_STREAM_WAIT_FLAGS) != hipStreamDefault &&
+       (flags & ~IHIP_STREAM_WAIT_FLAGS) != hipStreamNonBlocking) ||
+      ((waitFlags & (waitFlags - 1)) != 0)) {
     return hipErrorInvalidValue;
   }
   hip::Stream* hStream = new hip::Stream(hip::getCurrentDevice(), priority, flags, false, cuMask);
@@ -213,7 +296,12 @@ stream_per_thread::stream_per_thread() {
 stream_per_thread::~stream_per_thread() {
   for (auto &stream:m_streams) {
     if (stream != nullptr && hip::isValid(stream)) {
-      hip::Stream::Destroy(reinterpret_cast<hip::Stream*>(stream));
+      auto hip_stream = reinterpret_cast<hip::Stream*>(stream);
+      // Keep the stream and its HW queue for the next thread, unless it's in a capture
+      if ((hip_stream->GetCaptureStatus() != hipStreamCaptureStatusNone) ||
+          !hip_stream->GetDevice()->ParkPerThreadStream(hip_stream)) {
+        hip::Stream::Destroy(hip_stream);
+      }
       stream = nullptr;
     }
   }
@@ -232,6 +320,11 @@ hipStream_t stream_per_thread::get() {
   // There is a scenario where hipResetDevice destroys stream per thread
   // hence isValid check is required to make sure only valid stream is used
   if (m_streams[currDev] == nullptr || !hip::isValid(m_streams[currDev])) {
+    // Reuse the stream of an exited thread first
+    m_streams[currDev] = reinterpret_cast<hipStream_t>(device->UnparkPerThreadStream());
+    if (m_streams[currDev] != nullptr) {
+      return m_streams[currDev];
+    }
     hipError_t status = ihipStreamCreate(&m_streams[currDev], hipStreamDefault,
                                          hip::Stream::Priority::Normal);
     if (status != hipSuccess) {
@@ -362,6 +455,8 @@ hipError_t hipStreamSynchronize_common(hipStream_t stream) {
 
   // Wait for the current host queue
   hip_stream->finish();
+  // Make sure the callbacks of the finished commands were executed
+  hip_stream->GetDevice()->WaitCallbacks();
   // Release freed memory for all memory pools on the device
   hip_stream->GetDevice()->ReleaseFreedMemory();
   return hipSuccess;
@@ -402,18 +497,21 @@ hipError_t hipStreamDestroy(hipStream_t stream) {
   }
   s->GetDevice()->RemoveStreamFromPools(s);
 
-  {
-    amd::ScopedLock lock(g_captureStreamsLock);
-    const auto& g_it = std::find(g_captureStreams.begin(), g_captureStreams.end(), s);
-    if (g_it != g_captureStreams.end()) {
-      g_captureStreams.erase(g_it);
+  // Only a stream, which took part in a capture, can be in the global capture lists
+  if (s->GetCaptureID() != 0) {
+    {
+      amd::ScopedLock lock(g_captureStreamsLock);
+      const auto& g_it = std::find(g_captureStreams.begin(), g_captureStreams.end(), s);
+      if (g_it != g_captureStreams.end()) {
+        g_captureStreams.erase(g_it);
+      }
     }
-  }
-  {
-    amd::ScopedLock lock(g_streamSetLock);
-    const auto& g_it = std::find(g_allCapturingStreams.begin(), g_allCapturingStreams.end(), s);
-    if (g_it != g_allCapturingStreams.end()) {
-      g_allCapturingStreams.erase(g_it);
+    {
+      amd::ScopedLock lock(g_streamSetLock);
+      const auto& g_it = std::find(g_allCapturingStreams.begin(), g_allCapturingStreams.end(), s);
+      if (g_it != g_allCapturingStreams.end()) {
+        g_allCapturingStreams.erase(g_it);
+      }
     }
   }
   const auto& l_it = std::find(hip::tls.capture_streams_.begin(),
@@ -583,6 +681,11 @@ hipError_t streamCallback_common(hipStream_t stream, StreamCallback* cbo, void*
   if (last_command != nullptr) {
     last_command->release();
   }
+  if (hip_stream->GetDevice()->GetCallbackDispatcher() != nullptr) {
+    // The completion thread runs the callback later, so the stream doesn't stall for it
+    command->release();
+    return hipSuccess;
+  }
   // Extra marker is required for HW event check, which is done before the callback is finished.
   // Add the new barrier to stall the stream, until the callback is done
   eventWaitList.clear();
@@ -787,6 +890,44 @@ hipError_t hipExtStreamGetCUMask(hipStream_t stream, uint32_t cuMaskSize, uint32
   HIP_RETURN(hipSuccess);
 }
 
+// ================================================================================================
+bool Stream::SetCUMask(const std::vector<uint32_t>& cuMask) {
+  amd::ScopedLock lock(lock_);
+  if (cuMask_.empty()) {
+    // The stream runs on a shared HW queue, which other streams use with the default mask
+    return false;
+  }
+  {
+    amd::ScopedLock execLock(vdev()->execution());
+    if (!vdev()->SetCUMask(cuMask)) {
+      return false;
+    }
+  }
+  cuMask_ = cuMask;
+  return true;
+}
+
+// ================================================================================================
+hipError_t hipExtStreamSetCUMask(hipStream_t stream, uint32_t cuMaskSize, const uint32_t* cuMask) {
+  HIP_INIT_API(hipExtStreamSetCUMask, stream, cuMaskSize, cuMask);
+
+  if ((cuMaskSize == 0) || (cuMask == nullptr) || (stream == nullptr) ||
+      (stream == hipStreamPerThread)) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  if (!hip::isValid(stream)) {
+    HIP_RETURN(hipErrorContextIsDestroyed);
+  }
+  const std::vector<uint32_t> cuMaskv(cuMask, cuMask + cuMaskSize);
+  if (std::all_of(cuMaskv.begin(), cuMaskv.end(), [](uint32_t m) { return m == 0; })) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  if (!reinterpret_cast<hip::Stream*>(stream)->SetCUMask(cuMaskv)) {
+    HIP_RETURN(hipErrorNotSupported);
+  }
+  HIP_RETURN(hipSuccess);
+}
+
 // ================================================================================================
 hipError_t hipStreamGetDevice(hipStream_t stream, hipDevice_t* device) {
   HIP_INIT_API(hipStreamGetDevice, stream, device);
@@ -1819,3 +1819,96 @@ hipError_t hipGraphNodeSetParams(hipGraphNode_t node, hipGraphNodeParams *nodePa
 hipError_t hipExtHostAlloc(void** ptr, size_t size, unsigned int flags) {
   return hip::GetHipDispatchTable()->hipExtHostAlloc_fn(ptr, size, flags);
 }
+// The public prototype isn't part of hip_ext.h yet, hence the explicit C linkage
+extern "C" hipError_t hipExtLaunchKernelBatch(const hipLaunchParams* launchParamsList,
+                                              unsigned int numLaunches, hipStream_t stream,
+                                              unsigned int flags) {
+  return hip::GetHipDispatchTable()->hipExtLaunchKernelBatch_fn(launchParamsList, numLaunches,
+                                                                  stream, flags);
+}
+extern "C" hipError_t hipExtMemcpyBatchAsync(void** dsts, const void** srcs, const size_t* sizes,
+                                             size_t count, hipStream_t stream) {
+  return hip::GetHipDispatchTable()->hipExtMemcpyBatchAsync_fn(dsts, srcs, sizes, count, stream);
+}
+extern "C" hipError_t hipExtMemcpyFromFileAsync(void* dst, int fd, uint64_t fileOffset,
+                                                size_t sizeBytes, hipStream_t stream) {
+  return hip::GetHipDispatchTable()->hipExtMemcpyFromFileAsync_fn(dst, fd, fileOffset, sizeBytes,
+                                                                  stream);
+}
+extern "C" hipError_t hipExtGraphExecSetNodeTiming(hipGraphExec_t graphExec, int enable) {
+  return hip::GetHipDispatchTable()->hipExtGraphExecSetNodeTiming_fn(graphExec, enable);
+}
+extern "C" hipError_t hipExtGraphExecGetNodeTime(hipGraphExec_t graphExec, hipGraphNode_t node,
+                                                 uint64_t* startNs, uint64_t* endNs) {
+  return hip::GetHipDispatchTable()->hipExtGraphExecGetNodeTime_fn(graphExec, node, startNs,
+                                                                   endNs);
+}
+extern "C" hipError_t hipExtGraphExecGetDeviceGraph(hipGraphExec_t graphExec, void** deviceGraph) {
+  return hip::GetHipDispatchTable()->hipExtGraphExecGetDeviceGraph_fn(graphExec, deviceGraph);
+}
+extern "C" hipError_t hipExtGraphAddConditionalNode(hipGraphNode_t* pGraphNode, hipGraph_t graph,
+                                                    const hipGraphNode_t* pDependencies,
+                                                    size_t numDependencies, hipGraph_t body,
+                                                    unsigned int* predicate, int loop) {
+  return hip::GetHipDispatchTable()->hipExtGraphAddConditionalNode_fn(
+      pGraphNode, graph, pDependencies, numDependencies, body, predicate, loop);
+}
+extern "C" hipError_t hipExtGetRuntimeMetrics(const char** names, uint64_t* values,
+                                              size_t* count) {
+  return hip::GetHipDispatchTable()->hipExtGetRuntimeMetrics_fn(names, values, count);
+}
+extern "C" hipError_t hipExtMemMapBatch(void* const* ptrs, const size_t* sizes,
+                                        const size_t* offsets,
+                                        const hipMemGenericAllocationHandle_t* handles,
+                                        size_t count, unsigned long long flags) {
+  return hip::GetHipDispatchTable()->hipExtMemMapBatch_fn(ptrs, sizes, offsets, handles, count,
+                                                          flags);
+}
+extern "C" hipError_t hipExtMemSetAccessBatch(void* const* ptrs, const size_t* sizes, size_t count,
+                                              const hipMemAccessDesc* desc, size_t descCount) {
+  return hip::GetHipDispatchTable()->hipExtMemSetAccessBatch_fn(ptrs, sizes, count, desc,
+                                                                descCount);
+}
+extern "C" hipError_t hipExtMemPrefetchBatchAsync(const void* const* dev_ptrs,
+                                                  const size_t* counts, size_t numRanges,
+                                                  int device, hipStream_t stream) {
+  return hip::GetHipDispatchTable()->hipExtMemPrefetchBatchAsync_fn(dev_ptrs, counts, numRanges,
+                                                                    device, stream);
+}
+extern "C" hipError_t hipExtMemPoolExportChunks(hipMemPool_t mem_pool, size_t* numChunks) {
+  return hip::GetHipDispatchTable()->hipExtMemPoolExportChunks_fn(mem_pool, numChunks);
+}
+extern "C" hipError_t hipExtMemPoolSendBlock(hipMemPool_t mem_pool, void* ptr, size_t size) {
+  return hip::GetHipDispatchTable()->hipExtMemPoolSendBlock_fn(mem_pool, ptr, size);
+}
+extern "C" hipError_t hipExtMemPoolReceiveBlock(hipMemPool_t mem_pool, void** ptr,
+                                                size_t* size) {
+  return hip::GetHipDispatchTable()->hipExtMemPoolReceiveBlock_fn(mem_pool, ptr, size);
+}
+extern "C" hipError_t hipExtMemcpyBroadcastAsync(void* const* dsts, const int* dstDevices,
+                                                 size_t numDsts, const void* src, int srcDevice,
+                                                 size_t sizeBytes, hipStream_t stream) {
+  return hip::GetHipDispatchTable()->hipExtMemcpyBroadcastAsync_fn(dsts, dstDevices, numDsts, src,
+                                                                   srcDevice, sizeBytes, stream);
+}
+extern "C" hipError_t hipExtMemcpyScatterAsync(void* const* dsts, const int* dstDevices,
+                                               size_t numDsts, const void* src, int srcDevice,
+                                               size_t sizeBytes, hipStream_t stream) {
+  return hip::GetHipDispatchTable()->hipExtMemcpyScatterAsync_fn(dsts, dstDevices, numDsts, src,
+                                                                 srcDevice, sizeBytes, stream);
+}
+extern "C" hipError_t hipExtLaunchCooperativeKernel(const void* f, dim3 gridDim, dim3 blockDim,
+                                                    void** kernelParams, uint32_t sharedMemBytes,
+                                                    hipStream_t hStream, uint32_t flags) {
+  return hip::GetHipDispatchTable()->hipExtLaunchCooperativeKernel_fn(f, gridDim, blockDim,
+                                                                      kernelParams, sharedMemBytes,
+                                                                      hStream, flags);
+}
+extern "C" hipError_t hipExtStreamSetCUMask(hipStream_t stream, uint32_t cuMaskSize,
+                                            const uint32_t* cuMask) {
+  return hip::GetHipDispatchTable()->hipExtStreamSetCUMask_fn(stream, cuMaskSize, cuMask);
+}
+extern "C" hipError_t hipExtMemsetBatchAsync(void** dsts, const int* values, const size_t* sizes,
+                                             size_t count, hipStream_t stream) {
+  return hip::GetHipDispatchTable()->hipExtMemsetBatchAsync_fn(dsts, values, sizes, count, stream);
+}
@@ -57,7 +57,6 @@ struct __hip_texture {
 
 namespace hip {
 
-hipError_t ihipFree(void* ptr);
 amd::Image* ihipImageCreate(const cl_channel_order channelOrder,
                             const cl_channel_type channelType,
                             const cl_mem_object_type imageType,
@@ -72,6 +71,111 @@ amd::Image* ihipImageCreate(const cl_channel_order channelOrder,
                             amd::Memory* buffer,
                             hipError_t& status);
 
+// ================================================================================================
+//! Keeps the immutable objects behind the texture objects. The samplers and the image views
+//! are shared between the texture objects with equal states and the texture objects are
+//! suballocated from the fine grain slabs, hence a texture object creation with the known
+//! states doesn't allocate the device memory
+class TextureCache {
+ public:
+  //! Returns a retained sampler with the requested state
+  amd::Sampler* sampler(amd::Context& context, bool normCoords, uint addrMode, uint filterMode,
+                        uint mipFilterMode, float minLod, float maxLod) {
+    auto key = std::make_tuple(&context, normCoords, addrMode, filterMode, mipFilterMode, minLod,
+                               maxLod);
+    amd::ScopedLock lock(lock_);
+    auto it = samplers_.find(key);
+    if (it == samplers_.end()) {
+      amd::Sampler* sampler = new amd::Sampler(context, normCoords, addrMode, filterMode,
+                                               mipFilterMode, minLod, maxLod);
+      if (sampler == nullptr) {
+        return nullptr;
+      }
+      if (!sampler->create()) {
+        sampler->release();
+        return nullptr;
+      }
+      // The cache keeps the reference of the creation
+      it = samplers_.emplace(key, sampler).first;
+    }
+    it->second->retain();
+    return it->second;
+  }
+
+  //! Returns a retained view of the array image with the requested format
+  amd::Image* view(amd::Context& context, amd::Image* image, const amd::Image::Format& format) {
+    const cl_image_format& clFormat = format;
+    auto key = std::make_tuple(&context, image, clFormat.image_channel_order,
+                               clFormat.image_channel_data_type);
+    amd::ScopedLock lock(lock_);
+    auto it = views_.find(key);
+    if (it == views_.end()) {
+      amd::Image* view = image->createView(context, format, nullptr);
+      if (view == nullptr) {
+        return nullptr;
+      }
+      it = views_.emplace(key, view).first;
+    }
+    it->second->retain();
+    return it->second;
+  }
+
+  //! Releases the views of the image. The views hold a reference of the image, hence
+  //! they must be released before the image
+  void releaseViews(amd::Image* image) {
+    amd::ScopedLock lock(lock_);
+    for (auto it = views_.begin(); it != views_.end();) {
+      if (std::get<1>(it->first) == image) {
+        it->second->release();
+        it = views_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  //! Returns the memory for a texture object
+  void* allocTexture(amd::Context& context) {
+    amd::ScopedLock lock(lock_);
+    auto& freeList = textures_[&context];
+    if (freeList.empty()) {
+      void* slab = nullptr;
+      if ((ihipMalloc(&slab, kTexturesPerSlab * sizeof(__hip_texture),
+                      CL_MEM_SVM_FINE_GRAIN_BUFFER) != hipSuccess) || (slab == nullptr)) {
+        return nullptr;
+      }
+      for (size_t i = kTexturesPerSlab; i > 0; --i) {
+        freeList.push_back(reinterpret_cast<__hip_texture*>(slab) + i - 1);
+      }
+    }
+    void* texture = freeList.back();
+    freeList.pop_back();
+    return texture;
+  }
+
+  //! Returns the memory of a destroyed texture object back to the slab
+  void freeTexture(amd::Context& context, void* texture) {
+    amd::ScopedLock lock(lock_);
+    textures_[&context].push_back(texture);
+  }
+
+ private:
+  static constexpr size_t kTexturesPerSlab = 256;  //!< The number of objects in a slab
+
+  amd::Monitor lock_{true};  //!< Lock to serialize the cache access
+  std::map<std::tuple<amd::Context*, bool, uint, uint, uint, float, float>, amd::Sampler*>
+      samplers_;             //!< The samplers with the creation state
+  std::map<std::tuple<amd::Context*, amd::Image*, cl_channel_order, cl_channel_type>,
+           amd::Image*> views_;  //!< The views of the array images
+  std::unordered_map<amd::Context*, std::vector<void*>> textures_;  //!< Free texture objects
+};
+
+TextureCache textureCache;
+
+// ================================================================================================
+void ihipReleaseTextureViews(amd::Image* image) { textureCache.releaseViews(image); }
+
+// ================================================================================================
 hipError_t ihipCreateTextureObject(hipTextureObject_t* pTexObject,
                                    const hipResourceDesc* pResDesc,
                                    const hipTextureDesc* pTexDesc,
@@ -201,23 +305,15 @@ hipError_t ihipCreateTextureObject(hipTextureObject_t* pTexObject,
     mipFilterMode = hip::getCLFilterMode(pTexDesc->mipmapFilterMode);
   }
 
-  amd::Sampler* sampler = new amd::Sampler(*hip::getCurrentDevice()->asContext(),
-                                           pTexDesc->normalizedCoords,
-                                           addressMode,
-                                           filterMode,
-                                           mipFilterMode,
-                                           pTexDesc->minMipmapLevelClamp,
-                                           pTexDesc->maxMipmapLevelClamp);
-
+  amd::Context& context = *hip::getCurrentDevice()->asContext();
+  amd::Sampler* sampler = textureCache.sampler(context, pTexDesc->normalizedCoords, addressMode,
+                                               filterMode, mipFilterMode,
+                                               pTexDesc->minMipmapLevelClamp,
+                                               pTexDesc->maxMipmapLevelClamp);
   if (sampler == nullptr) {
     return hipErrorOutOfMemory;
   }
 
-  if (!sampler->create()) {
-    delete sampler;
-    return hipErrorOutOfMemory;
-  }
-
   amd::Image* image = nullptr;
   switch (pResDesc->resType) {
   case hipResourceTypeArray: {
@@ -250,7 +346,7 @@ hipError_t ihipCreateTextureObject(hipTextureObject_t* pTexObject,
         return hipErrorInvalidValue;
       }
 
-      image = image->createView(*hip::getCurrentDevice()->asContext(), imageFormat, nullptr);
+      image = textureCache.view(context, image, imageFormat);
       if (image == nullptr) {
         return hipErrorInvalidValue;
       }
@@ -362,9 +458,8 @@ hipError_t ihipCreateTextureObject(hipTextureObject_t* pTexObject,
   }
   }
 
-  void *texObjectBuffer = nullptr;
-  hipError_t err = ihipMalloc(&texObjectBuffer, sizeof(__hip_texture), CL_MEM_SVM_FINE_GRAIN_BUFFER);
-  if (texObjectBuffer == nullptr || err != hipSuccess) {
+  void* texObjectBuffer = textureCache.allocTexture(context);
+  if (texObjectBuffer == nullptr) {
     return hipErrorOutOfMemory;
   }
   *pTexObject = new (texObjectBuffer) __hip_texture{image, sampler, *pResDesc, *pTexDesc, (pResViewDesc != nullptr) ? *pResViewDesc : hipResourceViewDesc{}};
@@ -396,11 +491,13 @@ hipError_t ihipDestroyTextureObject(hipTextureObject_t texObject) {
     texObject->image->release();
   }
 
+  // The slab of the object belongs to the context of the creation
+  amd::Context& context = texObject->sampler->context();
   // The texture object always owns the sampler SRD.
   texObject->sampler->release();
 
-  // TODO Should call ihipFree() to not polute the api trace.
-  return ihipFree(texObject);
+  textureCache.freeTexture(context, texObject);
+  return hipSuccess;
 }
 
 hipError_t ihipUnbindTexture(textureReference* texRef) {
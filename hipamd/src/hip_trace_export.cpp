@@ -0,0 +1,201 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "hip_internal.hpp"
+#include "hip_prof_api.h"
+#include "platform/activity.hpp"
+
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Chrome/Perfetto trace export of the HIP API calls and the GPU activity. The runtime registers
+// itself as the activity callback, hence no profiler library is required. The file uses the
+// JSON array format, which stays readable even if the process exits without the final flush.
+namespace hip {
+namespace {
+
+//! A complete event of the trace
+struct TraceEvent {
+  std::string name_;      //!< API name, kernel name or command kind
+  const char* category_;  //!< "api" or "gpu"
+  uint64_t begin_;        //!< Begin timestamp in ns
+  uint64_t end_;          //!< End timestamp in ns
+  uint64_t pid_;          //!< Process for the API calls, device for the GPU activity
+  uint64_t tid_;          //!< Thread for the API calls, queue for the GPU activity
+  uint64_t correlation_;  //!< Correlation id between the API call and its GPU activity
+};
+
+constexpr size_t kFlushEvents = 4096;  //!< The number of the buffered events before a write
+constexpr uint64_t kDevicePid = 1 << 20;  //!< The first trace pid, used for the devices
+
+std::mutex traceLock;                       //!< Guards the state below
+FILE* traceFile = nullptr;                  //!< The output file
+std::vector<TraceEvent> traceEvents;        //!< Events, which weren't written yet
+std::set<std::pair<uint64_t, uint64_t>> traceTracks;  //!< Tracks with written names
+std::atomic<uint64_t> traceCorrelation{0};  //!< The last correlation id of the API calls
+uint64_t tracePid = 0;                       //!< The id of the process
+
+// ================================================================================================
+uint64_t currentThreadId() {
+#if defined(_WIN32)
+  return std::hash<std::thread::id>()(std::this_thread::get_id());
+#else
+  return static_cast<uint64_t>(syscall(SYS_gettid));
+#endif
+}
+
+// ================================================================================================
+std::string escapeJson(const std::string& str) {
+  std::string result;
+  result.reserve(str.size());
+  for (char c : str) {
+    if ((c == '"') || (c == '\\')) {
+      result += '\\';
+    }
+    result += (static_cast<unsigned char>(c) < 0x20) ? ' ' : c;
+  }
+  return result;
+}
+
+// ================================================================================================
+void writeTrackName(const TraceEvent& event) {
+  // Name the process and the thread tracks of the GPU activity once
+  if ((event.pid_ < kDevicePid) || !traceTracks.emplace(event.pid_, event.tid_).second) {
+    return;
+  }
+  if (traceTracks.emplace(event.pid_, ~0ULL).second) {
+    fprintf(traceFile, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%lu,"
+            "\"args\":{\"name\":\"GPU %lu\"}},\n", event.pid_, event.pid_ - kDevicePid);
+  }
+  fprintf(traceFile, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%lu,\"tid\":%lu,"
+          "\"args\":{\"name\":\"Queue %lu\"}},\n", event.pid_, event.tid_, event.tid_);
+}
+
+// ================================================================================================
+void flushEvents() {
+  for (const auto& event : traceEvents) {
+    writeTrackName(event);
+    const uint64_t duration = (event.end_ > event.begin_) ? (event.end_ - event.begin_) : 0;
+    fprintf(traceFile, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lu.%03lu,"
+            "\"dur\":%lu.%03lu,\"pid\":%lu,\"tid\":%lu,\"args\":{\"correlation_id\":%lu}},\n",
+            escapeJson(event.name_).c_str(), event.category_, event.begin_ / 1000,
+            event.begin_ % 1000, duration / 1000, duration % 1000, event.pid_, event.tid_,
+            event.correlation_);
+  }
+  traceEvents.clear();
+  fflush(traceFile);
+}
+
+// ================================================================================================
+void addEvent(TraceEvent&& event) {
+  std::lock_guard<std::mutex> lock(traceLock);
+  if (traceFile == nullptr) {
+    return;
+  }
+  traceEvents.push_back(std::move(event));
+  if (traceEvents.size() >= kFlushEvents) {
+    flushEvents();
+  }
+}
+
+// ================================================================================================
+void apiExit(hip_api_id_t operation_id, hip_api_trace_data_t* data) {
+  addEvent({hip_api_name(operation_id), "api", data->phase_enter_timestamp,
+            amd::Os::timeNanos(), tracePid, currentThreadId(), data->api_data.correlation_id});
+}
+
+// ================================================================================================
+int reportActivity(activity_domain_t domain, uint32_t operation_id, void* data) {
+  if (domain == ACTIVITY_DOMAIN_HIP_API) {
+    // Take the begin timestamp here and skip the argument capture of the enter phase
+    auto trace = reinterpret_cast<hip_api_trace_data_t*>(data);
+    trace->api_data.correlation_id = ++traceCorrelation;
+    trace->phase_enter_timestamp = amd::Os::timeNanos();
+    trace->phase_enter = nullptr;
+    trace->phase_exit = apiExit;
+    return 0;
+  }
+  if (domain != ACTIVITY_DOMAIN_HIP_OPS) {
+    return -1;
+  }
+  if (data == nullptr) {
+    // The runtime checks if the operation is traced, so it collects the command timestamps
+    return 0;
+  }
+  const auto record = reinterpret_cast<const activity_record_t*>(data);
+  std::string name = ((record->kind == CL_COMMAND_NDRANGE_KERNEL) ||
+                      (record->kind == CL_COMMAND_TASK)) && (record->kernel_name != nullptr) ?
+      record->kernel_name : amd::activity_prof::getOclCommandKindString(record->kind);
+  addEvent({std::move(name), "gpu", record->begin_ns, record->end_ns,
+            kDevicePid + record->device_id, record->queue_id, record->correlation_id});
+  return 0;
+}
+
+// ================================================================================================
+void finishTrace() {
+  std::lock_guard<std::mutex> lock(traceLock);
+  if (traceFile == nullptr) {
+    return;
+  }
+  flushEvents();
+  // Close the array with an instant event, which avoids the trailing comma
+  fprintf(traceFile, "{\"name\":\"end\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%lu,\"pid\":%lu}\n]\n",
+          amd::Os::timeNanos() / 1000, tracePid);
+  fclose(traceFile);
+  traceFile = nullptr;
+}
+
+}  // namespace
+
+// ================================================================================================
+void initTraceExport() {
+  if ((HIP_TRACE_EXPORT_FILE == nullptr) || (HIP_TRACE_EXPORT_FILE[0] == '\0')) {
+    return;
+  }
+  if (amd::activity_prof::report_activity.load(std::memory_order_relaxed) != nullptr) {
+    // A profiler is attached already and owns the activity records
+    LogWarning("HIP_TRACE_EXPORT_FILE is ignored, since a profiler is registered");
+    return;
+  }
+  std::string fileName = HIP_TRACE_EXPORT_FILE;
+  size_t pos = fileName.find("%p");
+  tracePid = amd::Os::getProcessId();
+  if (pos != std::string::npos) {
+    fileName.replace(pos, 2, std::to_string(tracePid));
+  }
+  traceFile = fopen(fileName.c_str(), "w");
+  if (traceFile == nullptr) {
+    LogPrintfError("Couldn't open the trace file %s", fileName.c_str());
+    return;
+  }
+  fprintf(traceFile, "[\n");
+  std::atexit(finishTrace);
+  amd::activity_prof::report_activity.store(reportActivity, std::memory_order_relaxed);
+}
+
+}  // namespace hip
@@ -105,6 +105,17 @@ hipError_t hipMemCreate(hipMemGenericAllocationHandle_t* handle, size_t size,
   if (size % dev_info.memBaseAddrAlign_ != 0) {
     HIP_RETURN(hipErrorInvalidValue);
   }
+  // The large page hints exclude each other and the size must cover whole pages, so the mapping
+  // to an aligned VA range can use the large fragments
+  constexpr uint32_t kPageHints = hipExtMemCreateUsageLargePage2M | hipExtMemCreateUsageLargePage1G;
+  if ((prop->allocFlags.usage & kPageHints) == kPageHints) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  const size_t largePage = (prop->allocFlags.usage & hipExtMemCreateUsageLargePage1G) ? 1 * Gi :
+      ((prop->allocFlags.usage & hipExtMemCreateUsageLargePage2M) ? 2 * Mi : 0);
+  if ((largePage != 0) && (size % largePage != 0)) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
 
   amd::Context* amdContext = g_devices[prop->location.id]->asContext();
 
@@ -200,6 +211,12 @@ hipError_t hipMemGetAllocationGranularity(size_t* granularity, const hipMemAlloc
   const auto& dev_info = g_devices[prop->location.id]->devices()[0]->info();
 
   *granularity = dev_info.virtualMemAllocGranularity_;
+  if (option == hipMemAllocationGranularityRecommended) {
+    // The large page hint requires the VA reservations aligned to the page
+    const size_t largePage = (prop->allocFlags.usage & hipExtMemCreateUsageLargePage1G) ? 1 * Gi :
+        ((prop->allocFlags.usage & hipExtMemCreateUsageLargePage2M) ? 2 * Mi : 0);
+    *granularity = std::max(*granularity, largePage);
+  }
 
   HIP_RETURN(hipSuccess);
 }
@@ -272,14 +289,166 @@ hipError_t hipMemMap(void* ptr, size_t size, size_t offset, hipMemGenericAllocat
   HIP_RETURN(hipSuccess);
 }
 
+// ================================================================================================
+hipError_t hipExtMemMapBatch(void* const* ptrs, const size_t* sizes, const size_t* offsets,
+                             const hipMemGenericAllocationHandle_t* handles, size_t count,
+                             unsigned long long flags) {
+  HIP_INIT_API(hipExtMemMapBatch, ptrs, sizes, offsets, handles, count, flags);
+
+  if (ptrs == nullptr || sizes == nullptr || handles == nullptr || count == 0 || flags != 0) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  // Validate the whole batch first, so a bad entry doesn't leave it partially mapped
+  for (size_t i = 0; i < count; ++i) {
+    if (ptrs[i] == nullptr || handles[i] == nullptr || sizes[i] == 0 ||
+        (offsets != nullptr && offsets[i] != 0)) {
+      HIP_RETURN(hipErrorInvalidValue);
+    }
+  }
+
+  // The maps of a device execute in order on its null stream, hence only the last one is awaited
+  std::vector<amd::Command*> last(g_devices.size(), nullptr);
+  for (size_t i = 0; i < count; ++i) {
+    hip::GenericAllocation* ga = reinterpret_cast<hip::GenericAllocation*>(handles[i]);
+    ga->retain();
+
+    const int device = ga->GetProperties().location.id;
+    auto& queue = *g_devices[device]->NullStream();
+    amd::Command* cmd = new amd::VirtualMapCommand(queue, amd::Command::EventWaitList{}, ptrs[i],
+                                                   sizes[i], &ga->asAmdMemory());
+    cmd->enqueue();
+    if (last[device] != nullptr) {
+      last[device]->release();
+    }
+    last[device] = cmd;
+  }
+  for (auto cmd : last) {
+    if (cmd != nullptr) {
+      cmd->awaitCompletion();
+      cmd->release();
+    }
+  }
+
+  HIP_RETURN(hipSuccess);
+}
+
+// ================================================================================================
+// The stream ordered unmap can't release the generic allocations on the API thread, hence
+// the command releases them after the execution, as hipMemUnmap() does after the wait
+class ArrayMapCommand : public amd::VirtualMapCommand {
+ public:
+  ArrayMapCommand(amd::HostQueue& queue, std::vector<Range>&& batch)
+      : VirtualMapCommand(queue, amd::Command::EventWaitList{}, std::move(batch)) {}
+
+  virtual void submit(device::VirtualDevice& device) final {
+    // Find the mapped views before the backend destroys the links to the physical memory
+    struct Unmap {
+      const void* ptr_;
+      amd::Memory* vaddr_sub_obj_;
+      amd::Memory* phys_mem_obj_;
+    };
+    std::vector<Unmap> unmaps;
+    for (size_t idx = 0; idx < count(); ++idx) {
+      const Range unmap = range(idx);
+      amd::Memory* vaddr_sub_obj = (unmap.memory_ == nullptr) ?
+          amd::MemObjMap::FindMemObj(unmap.ptr_) : nullptr;
+      if (vaddr_sub_obj != nullptr && vaddr_sub_obj->getUserData().phys_mem_obj != nullptr) {
+        unmaps.push_back({unmap.ptr_, vaddr_sub_obj, vaddr_sub_obj->getUserData().phys_mem_obj});
+      }
+    }
+    VirtualMapCommand::submit(device);
+    for (const auto& unmap : unmaps) {
+      if (amd::MemObjMap::FindMemObj(unmap.ptr_) == nullptr) {
+        unmap.vaddr_sub_obj_->release();
+        reinterpret_cast<hip::GenericAllocation*>(
+            unmap.phys_mem_obj_->getUserData().data)->release();
+      }
+    }
+  }
+};
+
+// ================================================================================================
+// Converts a binding of the sparse array into a range of its VA reservation. The array is
+// a linear image, hence only the whole rows of the level are contiguous in the VA range.
+static hipError_t ihipGetArrayMapRange(const hipArrayMapInfo& info,
+                                       amd::VirtualMapCommand::Range* range) {
+  if (info.resourceType != hipResourceTypeArray || info.resource.array == nullptr ||
+      info.flags != 0) {
+    return hipErrorInvalidValue;
+  }
+  const hipArray_t array = info.resource.array;
+  if ((array->flags & hipArraySparse) == 0) {
+    return hipErrorInvalidValue;
+  }
+  amd::Image* image = as_amd(reinterpret_cast<cl_mem>(array->data))->asImage();
+  amd::Memory* vaRange = image->parent();
+  if (info.subresourceType != hipArraySparseSubresourceTypeSparseLevel) {
+    // Sparse arrays don't have mip levels, hence no mip tail either
+    return hipErrorInvalidValue;
+  }
+  const auto& level = info.subresource.sparseLevel;
+  if (level.level != 0 || level.layer != 0 || level.offsetZ != 0 || level.extentDepth > 1 ||
+      level.extentHeight == 0) {
+    return hipErrorInvalidValue;
+  }
+  if (level.offsetX != 0 || level.extentWidth != array->width) {
+    // A partial row isn't contiguous in the linear layout
+    return hipErrorNotSupported;
+  }
+  const size_t offset = level.offsetY * image->getRowPitch();
+  const size_t size = level.extentHeight * image->getRowPitch();
+  const size_t granularity = vaRange->getContext().devices()[0]->info().virtualMemAllocGranularity_;
+  if ((offset % granularity) != 0 || (size % granularity) != 0 ||
+      (offset + size) > vaRange->getSize() || (info.offset % granularity) != 0) {
+    return hipErrorInvalidValue;
+  }
+
+  range->ptr_ = reinterpret_cast<address>(vaRange->getSvmPtr()) + offset;
+  range->size_ = size;
+  range->offset_ = info.offset;
+  range->memory_ = nullptr;
+  if (info.memOperationType == hipMemOperationTypeMap) {
+    if (info.memHandleType != hipMemHandleTypeGeneric || info.memHandle.memHandle == nullptr) {
+      return hipErrorInvalidValue;
+    }
+    range->memory_ = &reinterpret_cast<hip::GenericAllocation*>(
+        info.memHandle.memHandle)->asAmdMemory();
+  } else if (info.memOperationType != hipMemOperationTypeUnmap) {
+    return hipErrorInvalidValue;
+  }
+  return hipSuccess;
+}
+
+// ================================================================================================
 hipError_t hipMemMapArrayAsync(hipArrayMapInfo* mapInfoList, unsigned int  count, hipStream_t stream) {
   HIP_INIT_API(hipMemMapArrayAsync, mapInfoList, count, stream);
 
-  if (mapInfoList == nullptr || count == 0) {
+  if (mapInfoList == nullptr || count == 0 || !hip::isValid(stream)) {
     HIP_RETURN(hipErrorInvalidValue);
   }
 
-  HIP_RETURN(hipErrorNotSupported);
+  // Validate the whole list first, so a bad entry doesn't leave the array partially bound
+  std::vector<amd::VirtualMapCommand::Range> batch(count);
+  for (unsigned int i = 0; i < count; ++i) {
+    hipError_t status = ihipGetArrayMapRange(mapInfoList[i], &batch[i]);
+    if (status != hipSuccess) {
+      HIP_RETURN(status);
+    }
+  }
+  for (unsigned int i = 0; i < count; ++i) {
+    if (batch[i].memory_ != nullptr) {
+      // The mapping keeps a reference of the generic allocation, as hipMemMap() does
+      reinterpret_cast<hip::GenericAllocation*>(mapInfoList[i].memHandle.memHandle)->retain();
+    }
+  }
+
+  // All bindings execute in order as a single command of the stream, without a host wait
+  hip::Stream* hip_stream = hip::getStream(stream);
+  amd::Command* cmd = new ArrayMapCommand(*hip_stream, std::move(batch));
+  cmd->enqueue();
+  cmd->release();
+
+  HIP_RETURN(hipSuccess);
 }
 
 hipError_t hipMemRelease(hipMemGenericAllocationHandle_t handle) {
@@ -319,6 +488,21 @@ hipError_t hipMemRetainAllocationHandle(hipMemGenericAllocationHandle_t* handle,
   HIP_RETURN(hipSuccess);
 }
 
+// ================================================================================================
+// Converts the access descriptors into the devices and their permissions
+static bool ihipGetMemAccess(const hipMemAccessDesc* desc, size_t count,
+                             std::vector<std::pair<amd::Device*, amd::Device::VmmAccess>>& access) {
+  access.reserve(count);
+  for (size_t desc_idx = 0; desc_idx < count; ++desc_idx) {
+    if (desc[desc_idx].location.id >= g_devices.size()) {
+      return false;
+    }
+    access.emplace_back(g_devices[desc[desc_idx].location.id]->devices()[0],
+                        static_cast<amd::Device::VmmAccess>(desc[desc_idx].flags));
+  }
+  return true;
+}
+
 hipError_t hipMemSetAccess(void* ptr, size_t size, const hipMemAccessDesc* desc, size_t count) {
   HIP_INIT_API(hipMemSetAccess, ptr, size, desc, count);
 
@@ -326,15 +510,36 @@ hipError_t hipMemSetAccess(void* ptr, size_t size, const hipMemAccessDesc* desc,
     HIP_RETURN(hipErrorInvalidValue);
   }
 
-  for (size_t desc_idx = 0; desc_idx < count; ++desc_idx) {
-    if (desc[desc_idx].location.id >= g_devices.size()) {
-      HIP_RETURN(hipErrorInvalidValue)
-    }
+  std::vector<std::pair<amd::Device*, amd::Device::VmmAccess>> access;
+  if (!ihipGetMemAccess(desc, count, access) ||
+      !access[0].first->SetMemAccessBatch(ptr, size, access)) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+
+  HIP_RETURN(hipSuccess);
+}
+
+// ================================================================================================
+hipError_t hipExtMemSetAccessBatch(void* const* ptrs, const size_t* sizes, size_t count,
+                                   const hipMemAccessDesc* desc, size_t descCount) {
+  HIP_INIT_API(hipExtMemSetAccessBatch, ptrs, sizes, count, desc, descCount);
 
-    auto& dev = g_devices[desc[desc_idx].location.id];
-    amd::Device::VmmAccess access_flags = static_cast<amd::Device::VmmAccess>(desc[desc_idx].flags);
+  if (ptrs == nullptr || sizes == nullptr || count == 0 || desc == nullptr || descCount == 0) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    if (ptrs[i] == nullptr || sizes[i] == 0) {
+      HIP_RETURN(hipErrorInvalidValue);
+    }
+  }
 
-    if (!dev->devices()[0]->SetMemAccess(ptr, size, access_flags)) {
+  // The descriptors apply to every range, so they are converted once
+  std::vector<std::pair<amd::Device*, amd::Device::VmmAccess>> access;
+  if (!ihipGetMemAccess(desc, descCount, access)) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    if (!access[0].first->SetMemAccessBatch(ptrs[i], sizes[i], access)) {
       HIP_RETURN(hipErrorInvalidValue);
     }
   }
@@ -44,6 +44,11 @@ public:
   }
 
   const hipMemAllocationProp& GetProperties() const { return properties_; }
+  //! Returns the page size of the large page hint in the properties, 0 without a hint
+  size_t LargePage() const {
+    return (properties_.allocFlags.usage & hipExtMemCreateUsageLargePage1G) ? 1 * Gi :
+        ((properties_.allocFlags.usage & hipExtMemCreateUsageLargePage2M) ? 2 * Mi : 0);
+  }
   hipMemGenericAllocationHandle_t asMemGenericAllocationHandle() {
     return reinterpret_cast<hipMemGenericAllocationHandle_t>(this);
   }
@@ -474,7 +474,7 @@ bool UnbundleBitCode(const std::vector<char>& bundled_llvm_bitcode, const std::s
   return true;
 }
 
-bool addCodeObjData(amd_comgr_data_set_t& input, const std::vector<char>& source,
+bool addCodeObjData(amd_comgr_data_set_t& input, const char* source, size_t size,
                     const std::string& name, const amd_comgr_data_kind_t type) {
   amd_comgr_data_t data;
 
@@ -482,7 +482,7 @@ bool addCodeObjData(amd_comgr_data_set_t& input, const std::vector<char>& source
     return false;
   }
 
-  if (auto res = amd::Comgr::set_data(data, source.size(), source.data());
+  if (auto res = amd::Comgr::set_data(data, size, source);
       res != AMD_COMGR_STATUS_SUCCESS) {
     amd::Comgr::release_data(data);
     return false;
@@ -33,8 +33,12 @@ namespace hiprtc {
 namespace helpers {
 bool UnbundleBitCode(const std::vector<char>& bundled_bit_code, const std::string& isa,
                      size_t& co_offset, size_t& co_size);
-bool addCodeObjData(amd_comgr_data_set_t& input, const std::vector<char>& source,
+bool addCodeObjData(amd_comgr_data_set_t& input, const char* source, size_t size,
                     const std::string& name, const amd_comgr_data_kind_t type);
+inline bool addCodeObjData(amd_comgr_data_set_t& input, const std::vector<char>& source,
+                           const std::string& name, const amd_comgr_data_kind_t type) {
+  return addCodeObjData(input, source.data(), source.size(), name, type);
+}
 bool extractBuildLog(amd_comgr_data_set_t dataSet, std::string& buildLog);
 bool extractByteCodeBinary(const amd_comgr_data_set_t inDataSet,
                            const amd_comgr_data_kind_t dataKind, std::vector<char>& bin);
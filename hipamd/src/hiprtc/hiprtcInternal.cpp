@@ -22,6 +22,9 @@ THE SOFTWARE.
 
 #include "hiprtcInternal.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
 #include <streambuf>
 #include <vector>
@@ -154,6 +157,115 @@ void RTCProgram::AppendOptions(const std::string app_env_var, std::vector<std::s
   options->insert(options->end(), begin, end);
 }
 
+// RTC Program Cache Functions
+RTCProgram::CacheKey::CacheKey() : fnv_(0xcbf29ce484222325ULL), poly_(0) {
+  // A runtime or a compiler update must never pick up stale entries
+  size_t comgr_major = 0, comgr_minor = 0;
+  amd::Comgr::get_version(&comgr_major, &comgr_minor);
+  const std::string version = std::to_string(HIP_VERSION) + "-" + std::to_string(comgr_major) +
+                              "." + std::to_string(comgr_minor);
+  add(version);
+}
+
+void RTCProgram::CacheKey::add(const void* data, size_t size) {
+  // Mix in the size first, so the concatenation of the inputs is unambiguous
+  const auto mix = [this](const unsigned char* bytes, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      fnv_ = (fnv_ ^ bytes[i]) * 0x100000001b3ULL;
+      poly_ = poly_ * 0x9e3779b97f4a7c15ULL + bytes[i] + 1;
+    }
+  };
+  const uint64_t size64 = size;
+  mix(reinterpret_cast<const unsigned char*>(&size64), sizeof(size64));
+  mix(reinterpret_cast<const unsigned char*>(data), size);
+}
+
+std::string RTCProgram::CacheKey::str() const {
+  char key[40];
+  snprintf(key, sizeof(key), "%016llx%016llx", static_cast<unsigned long long>(fnv_),
+           static_cast<unsigned long long>(poly_));
+  return key;
+}
+
+static std::string cacheFileName(const std::string& key) {
+  return std::string(HIPRTC_CACHE_PATH) + amd::Os::fileSeparator() + key + ".hiprtc";
+}
+
+bool RTCProgram::LoadCached(const CacheKey& key, std::vector<char>& data) {
+  const std::string fname = cacheFileName(key.str());
+  std::ifstream file(fname, std::ios::binary | std::ios::ate);
+  if (!file.good()) {
+    return false;
+  }
+  const std::streamsize size = file.tellg();
+  if (size <= 0) {
+    return false;
+  }
+  std::vector<char> cached(size);
+  file.seekg(0, std::ios::beg);
+  if (!file.read(cached.data(), size)) {
+    return false;
+  }
+  data = std::move(cached);
+
+  // Refresh the time stamp, the eviction drops the least recently used entries first
+  std::error_code ec;
+  std::filesystem::last_write_time(fname, std::filesystem::file_time_type::clock::now(), ec);
+  LogPrintfInfo("hiprtc cache hit %s", fname.c_str());
+  return true;
+}
+
+void RTCProgram::StoreCached(const CacheKey& key, const std::vector<char>& data) {
+  if (data.empty()) {
+    return;
+  }
+  if (!amd::Os::createPath(HIPRTC_CACHE_PATH)) {
+    LogPrintfInfo("Cannot create the hiprtc cache %s", HIPRTC_CACHE_PATH);
+    return;
+  }
+  const std::string fname = cacheFileName(key.str());
+  // Write a private file and rename it, so other processes never read a partial entry
+  const std::string tmpName = fname + "." + std::to_string(amd::Os::getProcessId());
+  std::ofstream file(tmpName, std::ios::binary | std::ios::trunc);
+  file.write(data.data(), data.size());
+  file.close();
+  if (!file || (std::rename(tmpName.c_str(), fname.c_str()) != 0)) {
+    LogPrintfInfo("Cannot store hiprtc cache file %s", fname.c_str());
+    std::remove(tmpName.c_str());
+    return;
+  }
+
+  if (HIPRTC_CACHE_MAX_SIZE == 0) {
+    return;
+  }
+  // Evict the least recently used entries until the cache fits into the limit
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  std::vector<std::pair<fs::file_time_type, fs::path>> entries;
+  uint64_t total = 0;
+  for (const auto& entry : fs::directory_iterator(HIPRTC_CACHE_PATH, ec)) {
+    if (!entry.is_regular_file(ec) || (entry.path().extension() != ".hiprtc")) {
+      continue;
+    }
+    total += entry.file_size(ec);
+    entries.emplace_back(entry.last_write_time(ec), entry.path());
+  }
+  const uint64_t limit = static_cast<uint64_t>(HIPRTC_CACHE_MAX_SIZE) * Mi;
+  if (total <= limit) {
+    return;
+  }
+  std::sort(entries.begin(), entries.end());
+  for (const auto& entry : entries) {
+    if (total <= limit) {
+      break;
+    }
+    const uint64_t size = fs::file_size(entry.second, ec);
+    if (!ec && fs::remove(entry.second, ec)) {
+      total -= std::min(total, size);
+    }
+  }
+}
+
 // RTC Compile Program Member Functions
 RTCCompileProgram::RTCCompileProgram(std::string name_) : RTCProgram(name_), fgpu_rdc_(false) {
   if ((amd::Comgr::create_data_set(&compile_input_) != AMD_COMGR_STATUS_SUCCESS) ||
@@ -209,8 +321,8 @@ bool RTCCompileProgram::addSource(const std::string& source, const std::string&
 // addSource_impl is a different function because we need to add source when we track mangled
 // objects
 bool RTCCompileProgram::addSource_impl() {
-  std::vector<char> vsource(source_code_.begin(), source_code_.end());
-  if (!addCodeObjData(compile_input_, vsource, source_name_, AMD_COMGR_DATA_KIND_SOURCE)) {
+  if (!addCodeObjData(compile_input_, source_code_.data(), source_code_.size(), source_name_,
+                      AMD_COMGR_DATA_KIND_SOURCE)) {
     return false;
   }
   return true;
@@ -221,19 +333,27 @@ bool RTCCompileProgram::addHeader(const std::string& source, const std::string&
     LogError("Error in hiprtc: source or name is of size 0 in addHeader");
     return false;
   }
-  std::vector<char> vsource(source.begin(), source.end());
-  if (!addCodeObjData(compile_input_, vsource, name, AMD_COMGR_DATA_KIND_INCLUDE)) {
+  if (!addCodeObjData(compile_input_, source.data(), source.size(), name,
+                      AMD_COMGR_DATA_KIND_INCLUDE)) {
     return false;
   }
+  if (CacheEnabled()) {
+    header_key_.add(name);
+    header_key_.add(source);
+  }
   return true;
 }
 
 bool RTCCompileProgram::addBuiltinHeader() {
-  std::vector<char> source(__hipRTC_header, __hipRTC_header + __hipRTC_header_size);
-  std::string name{"hiprtc_runtime.h"};
-  if (!addCodeObjData(compile_input_, source, name, AMD_COMGR_DATA_KIND_INCLUDE)) {
+  // The builtin header is read-only and shared, comgr takes its own copy
+  const std::string name{"hiprtc_runtime.h"};
+  if (!addCodeObjData(compile_input_, __hipRTC_header, __hipRTC_header_size, name,
+                      AMD_COMGR_DATA_KIND_INCLUDE)) {
     return false;
   }
+  if (CacheEnabled()) {
+    header_key_.add(__hipRTC_header, __hipRTC_header_size);
+  }
   return true;
 }
 
@@ -323,7 +443,22 @@ bool RTCCompileProgram::compile(const std::vector<std::string>& options, bool fg
     return false;
   }
 
-  if (fgpu_rdc_) {
+  auto& compile_step_output = fgpu_rdc_ ? LLVMBitcode_ : executable_;
+  CacheKey key(header_key_);
+  if (CacheEnabled()) {
+    key.add(fgpu_rdc_ ? "bitcode" : "executable");
+    key.add(isa_);
+    key.add(compileOpts);
+    key.add(link_options_);
+    key.add(source_name_);
+    key.add(source_code_);
+  }
+
+  // The mangled names are filled from the cached output the same way as from the compiled
+  const bool cached = CacheEnabled() && LoadCached(key, compile_step_output);
+  if (cached) {
+    LogInfo("Using the cached hiprtc compilation");
+  } else if (fgpu_rdc_) {
     if (!compileToBitCode(compile_input_, isa_, compileOpts, build_log_, LLVMBitcode_)) {
       LogError("Error in hiprtc: unable to compile source to bitcode");
       return false;
@@ -336,9 +471,11 @@ bool RTCCompileProgram::compile(const std::vector<std::string>& options, bool fg
       return false;
     }
   }
+  if (CacheEnabled() && !cached) {
+    StoreCached(key, compile_step_output);
+  }
 
   if (!mangled_names_.empty()) {
-    auto& compile_step_output = fgpu_rdc_ ? LLVMBitcode_ : executable_;
     if (!fillMangledNames(compile_step_output, mangled_names_, fgpu_rdc_)) {
       LogError("Error in hiprtc: unable to fill mangled names");
       return false;
@@ -606,6 +743,11 @@ bool RTCLinkProgram::AddLinkerDataImpl(std::vector<char>& link_data, hiprtcJITIn
     LogError("Error in hiprtc: unable to add linked code object");
     return false;
   }
+  if (CacheEnabled()) {
+    link_key_.add(&data_kind, sizeof(data_kind));
+    link_key_.add(link_file_name);
+    link_key_.add(llvm_bitcode.data(), llvm_bitcode.size());
+  }
 
   return true;
 }
@@ -646,6 +788,19 @@ bool RTCLinkProgram::LinkComplete(void** bin_out, size_t* size_out) {
 
   AppendLinkerOptions();
 
+  std::vector<std::string> exe_options = getLinkOptions(link_args_);
+  CacheKey key(link_key_);
+  if (CacheEnabled()) {
+    key.add(isa_);
+    key.add(link_options_);
+    key.add(exe_options);
+    if (LoadCached(key, executable_)) {
+      *size_out = executable_.size();
+      *bin_out = executable_.data();
+      return true;
+    }
+  }
+
   std::vector<char> linked_llvm_bitcode;
   if (!linkLLVMBitcode(link_input_, isa_, link_options_, build_log_, linked_llvm_bitcode)) {
     LogError("Error in hiprtc: unable to add device libs to linked bitcode");
@@ -658,7 +813,6 @@ bool RTCLinkProgram::LinkComplete(void** bin_out, size_t* size_out) {
     return false;
   }
 
-  std::vector<std::string> exe_options = getLinkOptions(link_args_);
   LogPrintfInfo("Exe options forwarded to compiler: %s",
                 [&]() {
                   std::string ret;
@@ -673,6 +827,9 @@ bool RTCLinkProgram::LinkComplete(void** bin_out, size_t* size_out) {
     LogPrintfInfo("Error in hiprtc: unable to create exectuable: %s", build_log_.c_str());
     return false;
   }
+  if (CacheEnabled()) {
+    StoreCached(key, executable_);
+  }
 
   *size_out = executable_.size();
   *bin_out = executable_.data();
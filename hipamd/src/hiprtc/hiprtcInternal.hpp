@@ -72,8 +72,9 @@ template <typename T, typename... Args> inline std::string ToString(T first, Arg
 }  // namespace internal
 }  // namespace hiprtc
 
-// hiprtcInit lock
+// hiprtcInit lock, taken only until the flags are initialized so programs compile concurrently
 static amd::Monitor g_hiprtcInitlock{};
+static std::atomic<bool> g_hiprtcInitialized{false};
 #define HIPRTC_INIT_API_INTERNAL(...)                                                              \
   amd::Thread* thread = amd::Thread::current();                                                    \
   if (!VDI_CHECK_THREAD(thread)) {                                                                 \
@@ -82,9 +83,12 @@ static amd::Monitor g_hiprtcInitlock{};
             " This may be due to insufficient memory.");                                           \
     HIPRTC_RETURN(HIPRTC_ERROR_INTERNAL_ERROR);                                                    \
   }                                                                                                \
-  amd::ScopedLock lock(g_hiprtcInitlock);                                                          \
-  if (!amd::Flag::init()) {                                                                        \
-    HIPRTC_RETURN(HIPRTC_ERROR_INTERNAL_ERROR);                                                    \
+  if (!g_hiprtcInitialized.load(std::memory_order_acquire)) {                                      \
+    amd::ScopedLock lock(g_hiprtcInitlock);                                                        \
+    if (!amd::Flag::init()) {                                                                      \
+      HIPRTC_RETURN(HIPRTC_ERROR_INTERNAL_ERROR);                                                  \
+    }                                                                                              \
+    g_hiprtcInitialized.store(true, std::memory_order_release);                                    \
   }
 
 #define HIPRTC_INIT_API(...)                                                                       \
@@ -121,10 +125,32 @@ class RTCProgram {
   RTCProgram(std::string name);
   ~RTCProgram() { amd::Comgr::destroy_data_set(exec_input_); }
 
+  //! Content hash of the program inputs, names the entries of the on-disk cache
+  class CacheKey {
+   public:
+    CacheKey();
+    void add(const void* data, size_t size);
+    void add(const std::string& str) { add(str.data(), str.size()); }
+    void add(const std::vector<std::string>& strs) {
+      for (const auto& str : strs) {
+        add(str);
+      }
+    }
+    std::string str() const;
+
+   private:
+    uint64_t fnv_;   //!< FNV-1a hash of the inputs
+    uint64_t poly_;  //!< Independent polynomial hash, makes collisions negligible
+  };
+
   // Member Functions
   bool findIsa();
   static void AppendOptions(std::string app_env_var, std::vector<std::string>* options);
 
+  static bool CacheEnabled() { return HIPRTC_CACHE_PATH[0] != '\0'; }
+  static bool LoadCached(const CacheKey& key, std::vector<char>& data);
+  static void StoreCached(const CacheKey& key, const std::vector<char>& data);
+
   // Data Members
   std::string name_;
   std::string isa_;
@@ -150,6 +176,7 @@ class RTCCompileProgram : public RTCProgram {
 
   bool fgpu_rdc_;
   std::vector<char> LLVMBitcode_;
+  CacheKey header_key_;  //!< Hash of the headers added to the program
 
   // Private Member functions
   bool addSource_impl();
@@ -270,6 +297,7 @@ class RTCLinkProgram : public RTCProgram {
   amd_comgr_data_set_t link_input_;
   std::vector<std::string> link_options_;
   static std::unordered_set<RTCLinkProgram*> linker_set_;
+  CacheKey link_key_;  //!< Hash of the linker inputs
 
   bool AddLinkerDataImpl(std::vector<char>& link_data, hiprtcJITInputType input_type,
                          std::string& link_file_name);
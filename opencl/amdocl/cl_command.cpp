@@ -101,6 +101,8 @@ RUNTIME_ENTRY_RET(cl_command_queue, clCreateCommandQueueWithProperties,
   uint queueSize = amdDevice.info().queueOnDevicePreferredSize_;
   uint queueRTCUs = amd::CommandQueue::RealTimeDisabled;
   amd::CommandQueue::Priority priority = amd::CommandQueue::Priority::Normal;
+  const cl_uint* cuMask = NULL;
+  cl_uint cuMaskSize = 0;
   if (p != NULL)
     while (p->name != 0) {
       switch (p->name) {
@@ -123,6 +125,30 @@ RUNTIME_ENTRY_RET(cl_command_queue, clCreateCommandQueueWithProperties,
             queueRTCUs = p->value.size;
           }
           break;
+        case CL_QUEUE_PRIORITY_KHR:
+          switch (p->value.size) {
+            case CL_QUEUE_PRIORITY_HIGH_KHR:
+              priority = amd::CommandQueue::Priority::High;
+              break;
+            case CL_QUEUE_PRIORITY_MED_KHR:
+              priority = amd::CommandQueue::Priority::Normal;
+              break;
+            case CL_QUEUE_PRIORITY_LOW_KHR:
+              priority = amd::CommandQueue::Priority::Low;
+              break;
+            default:
+              *not_null(errcode_ret) = CL_INVALID_VALUE;
+              return (cl_command_queue)0;
+          }
+          break;
+#define CL_QUEUE_CU_MASK_AMD 0x4051
+        case CL_QUEUE_CU_MASK_AMD:
+          cuMask = reinterpret_cast<const cl_uint*>(p->value.raw);
+          break;
+#define CL_QUEUE_CU_MASK_SIZE_AMD 0x4052
+        case CL_QUEUE_CU_MASK_SIZE_AMD:
+          cuMaskSize = p->value.size;
+          break;
         default:
           *not_null(errcode_ret) = CL_INVALID_QUEUE_PROPERTIES;
           LogWarning("invalid property name");
@@ -143,13 +169,31 @@ RUNTIME_ENTRY_RET(cl_command_queue, clCreateCommandQueueWithProperties,
     return (cl_command_queue)0;
   }
 
+  // The CU mask is an array of 32 bit words, the bit N enables the compute unit N
+  if (((cuMask == NULL) != (cuMaskSize == 0)) ||
+      ((cuMask != NULL) && ((properties & CL_QUEUE_ON_DEVICE) ||
+                            (queueRTCUs != amd::CommandQueue::RealTimeDisabled)))) {
+    *not_null(errcode_ret) = CL_INVALID_VALUE;
+    return (cl_command_queue)0;
+  }
+  std::vector<uint32_t> cuMaskv;
+  if (cuMask != NULL) {
+    const uint numWords = amd::alignUp(amdDevice.info().maxComputeUnits_, 32) / 32;
+    cuMaskv.assign(cuMask, cuMask + std::min(cuMaskSize, numWords));
+    if (std::all_of(cuMaskv.begin(), cuMaskv.end(), [](uint32_t word) { return word == 0; })) {
+      *not_null(errcode_ret) = CL_INVALID_VALUE;
+      return (cl_command_queue)0;
+    }
+  }
+
   amd::CommandQueue* queue = NULL;
   {
     amd::ScopedLock lock(amdContext.lock());
 
     // Check if the app creates a host queue
     if (!(properties & CL_QUEUE_ON_DEVICE)) {
-      queue = new amd::HostQueue(amdContext, amdDevice, properties, queueRTCUs, priority);
+      queue = new amd::HostQueue(amdContext, amdDevice, properties, queueRTCUs, priority,
+                                 cuMaskv);
     } else {
       // Is it a device default queue
       if (properties & CL_QUEUE_ON_DEVICE_DEFAULT) {
@@ -354,6 +398,20 @@ RUNTIME_ENTRY(cl_int, clGetCommandQueueInfo,
       const void* handle = hostQueue->thread().handle();
       return amd::clGetInfo(handle, param_value_size, param_value, param_value_size_ret);
     }
+    case CL_QUEUE_PRIORITY_KHR: {
+      cl_queue_priority_khr priority = CL_QUEUE_PRIORITY_MED_KHR;
+      switch (as_amd(command_queue)->priority()) {
+        case amd::CommandQueue::Priority::High:
+          priority = CL_QUEUE_PRIORITY_HIGH_KHR;
+          break;
+        case amd::CommandQueue::Priority::Low:
+          priority = CL_QUEUE_PRIORITY_LOW_KHR;
+          break;
+        default:
+          break;
+      }
+      return amd::clGetInfo(priority, param_value_size, param_value, param_value_size_ret);
+    }
     case CL_QUEUE_DEVICE_DEFAULT: {
       const amd::Device& device = as_amd(command_queue)->device();
       amd::CommandQueue* defQueue = as_amd(command_queue)->context().defDeviceQueue(device);
@@ -0,0 +1,657 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "cl_common.hpp"
+#include "cl_command_buffer.hpp"
+#include "platform/kernel.hpp"
+#include "platform/ndrange.hpp"
+#include "platform/memory.hpp"
+
+namespace amd {
+
+// ================================================================================================
+CommandBufferKernArgPool::~CommandBufferKernArgPool() {
+  for (const auto& chunk : chunks_) {
+    device_.hostFree(chunk.first, chunk.second);
+  }
+}
+
+// ================================================================================================
+address CommandBufferKernArgPool::AllocKernArg(size_t size, size_t alignment) {
+  size_t offset = amd::alignUp(offset_, alignment);
+  if (chunks_.empty() || ((offset + size) > chunks_.back().second)) {
+    const size_t chunkSize = std::max(kChunkSize, amd::alignUp(size, alignment));
+    address chunk = reinterpret_cast<address>(
+        device_.hostAlloc(chunkSize, alignment, Device::MemorySegment::kKernArg));
+    if (chunk == nullptr) {
+      LogError("Couldn't allocate the kernel arguments of the command buffer");
+      return nullptr;
+    }
+    chunks_.push_back({chunk, chunkSize});
+    offset = 0;
+  }
+  offset_ = offset + size;
+  return chunks_.back().first + offset;
+}
+
+// ================================================================================================
+CommandBuffer::CommandBuffer(HostQueue& queue, cl_command_buffer_flags_khr flags,
+                             const std::vector<cl_command_buffer_properties_khr>& properties)
+    : queue_(queue),
+      flags_(flags),
+      properties_(properties),
+      kernArgs_(queue.device()),
+      lock_(true) /* Command buffer lock */ {
+  queue_.retain();
+}
+
+// ================================================================================================
+CommandBuffer::~CommandBuffer() {
+  if (lastEnqueue_ != nullptr) {
+    lastEnqueue_->release();
+  }
+  for (auto& record : records_) {
+    if (record.command_ != nullptr) {
+      record.command_->release();
+    }
+    for (auto packet : record.packets_) {
+      delete[] packet;
+    }
+    if (record.src_ != nullptr) {
+      record.src_->release();
+      record.dst_->release();
+    }
+  }
+  queue_.release();
+}
+
+// ================================================================================================
+cl_command_buffer_state_khr CommandBuffer::state() const {
+  if (!finalized_) {
+    return CL_COMMAND_BUFFER_STATE_RECORDING_KHR;
+  }
+  amd::ScopedLock lock(lock_);
+  if ((lastEnqueue_ != nullptr) && (lastEnqueue_->status() > CL_COMPLETE)) {
+    return CL_COMMAND_BUFFER_STATE_PENDING_KHR;
+  }
+  return CL_COMMAND_BUFFER_STATE_EXECUTABLE_KHR;
+}
+
+// ================================================================================================
+bool CommandBuffer::validateSyncPoints(cl_uint numSyncPoints,
+                                       const cl_sync_point_khr* syncPoints) const {
+  if ((numSyncPoints == 0) != (syncPoints == nullptr)) {
+    return false;
+  }
+  for (cl_uint i = 0; i < numSyncPoints; ++i) {
+    // The commands replay in the recording order, hence any earlier sync point is reached
+    if (syncPoints[i] >= nextSyncPoint_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ================================================================================================
+cl_sync_point_khr CommandBuffer::addCommand(Command* command) {
+  Record record;
+  record.command_ = command;
+  records_.push_back(std::move(record));
+  return nextSyncPoint_++;
+}
+
+// ================================================================================================
+cl_sync_point_khr CommandBuffer::addCopy(Buffer& src, Buffer& dst, size_t srcOffset,
+                                         size_t dstOffset, size_t size) {
+  Record record;
+  src.retain();
+  dst.retain();
+  record.src_ = &src;
+  record.dst_ = &dst;
+  record.srcOffset_ = srcOffset;
+  record.dstOffset_ = dstOffset;
+  record.size_ = size;
+  records_.push_back(std::move(record));
+  return nextSyncPoint_++;
+}
+
+// ================================================================================================
+cl_int CommandBuffer::finalize() {
+  // The capture goes through the virtual device, which the queue thread may use concurrently
+  amd::ScopedLock lock(queue_.vdev()->execution());
+  for (auto& record : records_) {
+    if (record.command_ == nullptr) {
+      continue;
+    }
+    // Submit the command in the capture mode, which writes the kernel arguments into the pool
+    // and returns the AQL packets instead of the dispatch
+    record.command_->setPktCapturingState(true, &record.packets_, &kernArgs_,
+                                          &record.kernelName_);
+    record.command_->submit(*queue_.vdev());
+    record.command_->setPktCapturingState(false, nullptr, nullptr, nullptr);
+    if (record.packets_.empty()) {
+      LogPrintfError("Command buffer couldn't capture the packets of command type 0x%x",
+                     record.command_->type());
+      return CL_OUT_OF_RESOURCES;
+    }
+  }
+  finalized_ = true;
+  return CL_SUCCESS;
+}
+
+// ================================================================================================
+cl_int CommandBuffer::enqueue(HostQueue& queue, const Command::EventWaitList& eventWaitList,
+                              Command** lastCommand) {
+  amd::ScopedLock lock(lock_);
+  if (!simultaneousUse() && (lastEnqueue_ != nullptr) &&
+      (lastEnqueue_->status() > CL_COMPLETE)) {
+    return CL_INVALID_OPERATION;
+  }
+  // The queue is in order, so only the first command waits for the events
+  Command::EventWaitList waitList = eventWaitList;
+  Command* command = nullptr;
+  auto submit = [&](Command* next) {
+    if (command != nullptr) {
+      command->release();
+    }
+    next->enqueue();
+    command = next;
+    waitList.clear();
+  };
+
+  std::vector<PacketReplayCommand::Packets> packets;
+  for (size_t i = 0; i <= records_.size(); ++i) {
+    const bool copy = (i < records_.size()) && (records_[i].command_ == nullptr);
+    // Dispatch the packets, recorded before the copy or the end of the buffer, at once
+    if ((copy || (i == records_.size())) && !packets.empty()) {
+      submit(new PacketReplayCommand(queue, waitList, std::move(packets)));
+      packets.clear();
+    }
+    if (i == records_.size()) {
+      break;
+    }
+    const Record& record = records_[i];
+    if (!copy) {
+      packets.push_back({&record.packets_, &record.kernelName_});
+      continue;
+    }
+    auto copyCommand = new CopyMemoryCommand(queue, CL_COMMAND_COPY_BUFFER, waitList,
+                                             *record.src_, *record.dst_,
+                                             Coord3D(record.srcOffset_, 0, 0),
+                                             Coord3D(record.dstOffset_, 0, 0),
+                                             Coord3D(record.size_, 1, 1));
+    if (!copyCommand->validateMemory()) {
+      delete copyCommand;
+      if (command != nullptr) {
+        command->release();
+      }
+      return CL_MEM_OBJECT_ALLOCATION_FAILURE;
+    }
+    submit(copyCommand);
+  }
+  if (command == nullptr) {
+    // An empty command buffer still completes the event after the wait list
+    submit(new Marker(queue, true, waitList));
+  }
+
+  if (lastEnqueue_ != nullptr) {
+    lastEnqueue_->release();
+  }
+  command->retain();
+  lastEnqueue_ = command;
+  *lastCommand = command;
+  return CL_SUCCESS;
+}
+
+}  // namespace amd
+
+/*! \addtogroup API
+ *  @{
+ *
+ *  \addtogroup CL_CommandBuffer Command Buffers
+ *
+ *  cl_khr_command_buffer records the commands once and replays them with the captured
+ *  AQL packets. Only a single in-order queue is supported and the sync points are
+ *  satisfied by the recording order.
+ *
+ *  @{
+ */
+
+//! Checks the arguments, common to all clCommand*KHR functions
+static cl_int validateCommand(cl_command_buffer_khr command_buffer,
+                              cl_command_queue command_queue,
+                              cl_uint num_sync_points_in_wait_list,
+                              const cl_sync_point_khr* sync_point_wait_list,
+                              cl_mutable_command_khr* mutable_handle) {
+  if (!is_valid(command_buffer)) {
+    return CL_INVALID_COMMAND_BUFFER_KHR;
+  }
+  if (command_queue != nullptr) {
+    // The commands are recorded for the queue of the command buffer
+    return CL_INVALID_COMMAND_QUEUE;
+  }
+  if (mutable_handle != nullptr) {
+    // cl_khr_command_buffer_mutable_dispatch isn't supported
+    return CL_INVALID_VALUE;
+  }
+  const amd::CommandBuffer* commandBuffer = as_amd(command_buffer);
+  if (commandBuffer->state() != CL_COMMAND_BUFFER_STATE_RECORDING_KHR) {
+    return CL_INVALID_OPERATION;
+  }
+  if (!commandBuffer->validateSyncPoints(num_sync_points_in_wait_list, sync_point_wait_list)) {
+    return CL_INVALID_SYNC_POINT_WAIT_LIST_KHR;
+  }
+  return CL_SUCCESS;
+}
+
+//! Returns true if the queue can execute the command buffers
+static bool isCompatibleQueue(const amd::HostQueue& queue) {
+  return queue.device().settings().checkExtension(ClKhrCommandBuffer) &&
+      !queue.properties().test(CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE);
+}
+
+/*! \brief Create a command buffer, which records the commands for the queue.
+ *
+ *  \version 0.9 (cl_khr_command_buffer)
+ */
+RUNTIME_ENTRY_RET(cl_command_buffer_khr, clCreateCommandBufferKHR,
+                  (cl_uint num_queues, const cl_command_queue* queues,
+                   const cl_command_buffer_properties_khr* properties, cl_int* errcode_ret)) {
+  if ((num_queues != 1) || (queues == nullptr)) {
+    *not_null(errcode_ret) = CL_INVALID_VALUE;
+    return nullptr;
+  }
+  if (!is_valid(queues[0])) {
+    *not_null(errcode_ret) = CL_INVALID_COMMAND_QUEUE;
+    return nullptr;
+  }
+  amd::HostQueue* queue = as_amd(queues[0])->asHostQueue();
+  if (queue == nullptr) {
+    *not_null(errcode_ret) = CL_INVALID_COMMAND_QUEUE;
+    return nullptr;
+  }
+  if (!isCompatibleQueue(*queue)) {
+    *not_null(errcode_ret) = CL_INCOMPATIBLE_COMMAND_QUEUE_KHR;
+    return nullptr;
+  }
+
+  cl_command_buffer_flags_khr flags = 0;
+  std::vector<cl_command_buffer_properties_khr> props;
+  for (auto p = properties; (p != nullptr) && (*p != 0); p += 2) {
+    if ((p[0] != CL_COMMAND_BUFFER_FLAGS_KHR) ||
+        ((p[1] & ~CL_COMMAND_BUFFER_SIMULTANEOUS_USE_KHR) != 0)) {
+      *not_null(errcode_ret) = CL_INVALID_VALUE;
+      return nullptr;
+    }
+    flags = p[1];
+    props.push_back(p[0]);
+    props.push_back(p[1]);
+  }
+  if (!props.empty()) {
+    props.push_back(0);
+  }
+
+  amd::CommandBuffer* commandBuffer = new amd::CommandBuffer(*queue, flags, props);
+  if (commandBuffer == nullptr) {
+    *not_null(errcode_ret) = CL_OUT_OF_HOST_MEMORY;
+    return nullptr;
+  }
+  *not_null(errcode_ret) = CL_SUCCESS;
+  return as_cl(commandBuffer);
+}
+RUNTIME_EXIT
+
+/*! \brief Finish the recording and capture the AQL packets of the commands.
+ *
+ *  \version 0.9 (cl_khr_command_buffer)
+ */
+RUNTIME_ENTRY(cl_int, clFinalizeCommandBufferKHR, (cl_command_buffer_khr command_buffer)) {
+  if (!is_valid(command_buffer)) {
+    return CL_INVALID_COMMAND_BUFFER_KHR;
+  }
+  amd::CommandBuffer* commandBuffer = as_amd(command_buffer);
+  if (commandBuffer->state() != CL_COMMAND_BUFFER_STATE_RECORDING_KHR) {
+    return CL_INVALID_OPERATION;
+  }
+  return commandBuffer->finalize();
+}
+RUNTIME_EXIT
+
+/*! \brief Increment the command buffer reference count.
+ *
+ *  \version 0.9 (cl_khr_command_buffer)
+ */
+RUNTIME_ENTRY(cl_int, clRetainCommandBufferKHR, (cl_command_buffer_khr command_buffer)) {
+  if (!is_valid(command_buffer)) {
+    return CL_INVALID_COMMAND_BUFFER_KHR;
+  }
+  as_amd(command_buffer)->retain();
+  return CL_SUCCESS;
+}
+RUNTIME_EXIT
+
+/*! \brief Decrement the command buffer reference count.
+ *
+ *  \version 0.9 (cl_khr_command_buffer)
+ */
+RUNTIME_ENTRY(cl_int, clReleaseCommandBufferKHR, (cl_command_buffer_khr command_buffer)) {
+  if (!is_valid(command_buffer)) {
+    return CL_INVALID_COMMAND_BUFFER_KHR;
+  }
+  as_amd(command_buffer)->release();
+  return CL_SUCCESS;
+}
+RUNTIME_EXIT
+
+/*! \brief Replay a finalized command buffer.
+ *
+ *  The command buffer can be replayed on any in-order queue of the same device, since
+ *  the captured packets don't depend on the queue.
+ *
+ *  \version 0.9 (cl_khr_command_buffer)
+ */
+RUNTIME_ENTRY(cl_int, clEnqueueCommandBufferKHR,
+              (cl_uint num_queues, cl_command_queue* queues, cl_command_buffer_khr command_buffer,
+               cl_uint num_events_in_wait_list, const cl_event* event_wait_list,
+               cl_event* event)) {
+  *not_null(event) = nullptr;
+
+  if (!is_valid(command_buffer)) {
+    return CL_INVALID_COMMAND_BUFFER_KHR;
+  }
+  amd::CommandBuffer* commandBuffer = as_amd(command_buffer);
+  if (commandBuffer->state() == CL_COMMAND_BUFFER_STATE_RECORDING_KHR) {
+    return CL_INVALID_OPERATION;
+  }
+
+  amd::HostQueue* queue = &commandBuffer->queue();
+  if ((num_queues != 0) || (queues != nullptr)) {
+    if ((num_queues != 1) || (queues == nullptr)) {
+      return CL_INVALID_VALUE;
+    }
+    if (!is_valid(queues[0])) {
+      return CL_INVALID_COMMAND_QUEUE;
+    }
+    queue = as_amd(queues[0])->asHostQueue();
+    if (queue == nullptr) {
+      return CL_INVALID_COMMAND_QUEUE;
+    }
+    if ((&queue->device() != &commandBuffer->queue().device()) || !isCompatibleQueue(*queue)) {
+      return CL_INCOMPATIBLE_COMMAND_QUEUE_KHR;
+    }
+    if (&queue->context() != &commandBuffer->queue().context()) {
+      return CL_INVALID_CONTEXT;
+    }
+  }
+
+  amd::Command::EventWaitList eventWaitList;
+  cl_int err = amd::clSetEventWaitList(eventWaitList, *queue, num_events_in_wait_list,
+                                       event_wait_list);
+  if (err != CL_SUCCESS) {
+    return err;
+  }
+
+  amd::Command* command = nullptr;
+  err = commandBuffer->enqueue(*queue, eventWaitList, &command);
+  if (err != CL_SUCCESS) {
+    return err;
+  }
+
+  *not_null(event) = as_cl(&command->event());
+  if (event == nullptr) {
+    command->release();
+  }
+  return CL_SUCCESS;
+}
+RUNTIME_EXIT
+
+/*! \brief Record a barrier. The recorded commands execute in order, hence it has no work.
+ *
+ *  \version 0.9 (cl_khr_command_buffer)
+ */
+RUNTIME_ENTRY(cl_int, clCommandBarrierWithWaitListKHR,
+              (cl_command_buffer_khr command_buffer, cl_command_queue command_queue,
+               cl_uint num_sync_points_in_wait_list, const cl_sync_point_khr* sync_point_wait_list,
+               cl_sync_point_khr* sync_point, cl_mutable_command_khr* mutable_handle)) {
+  cl_int err = validateCommand(command_buffer, command_queue, num_sync_points_in_wait_list,
+                               sync_point_wait_list, mutable_handle);
+  if (err != CL_SUCCESS) {
+    return err;
+  }
+  *not_null(sync_point) = as_amd(command_buffer)->addBarrier();
+  return CL_SUCCESS;
+}
+RUNTIME_EXIT
+
+/*! \brief Record a buffer copy.
+ *
+ *  \version 0.9 (cl_khr_command_buffer)
+ */
+RUNTIME_ENTRY(cl_int, clCommandCopyBufferKHR,
+              (cl_command_buffer_khr command_buffer, cl_command_queue command_queue,
+               cl_mem src_buffer, cl_mem dst_buffer, size_t src_offset, size_t dst_offset,
+               size_t size, cl_uint num_sync_points_in_wait_list,
+               const cl_sync_point_khr* sync_point_wait_list, cl_sync_point_khr* sync_point,
+               cl_mutable_command_khr* mutable_handle)) {
+  cl_int err = validateCommand(command_buffer, command_queue, num_sync_points_in_wait_list,
+                               sync_point_wait_list, mutable_handle);
+  if (err != CL_SUCCESS) {
+    return err;
+  }
+  if (!is_valid(src_buffer) || !is_valid(dst_buffer)) {
+    return CL_INVALID_MEM_OBJECT;
+  }
+  amd::Buffer* srcBuffer = as_amd(src_buffer)->asBuffer();
+  amd::Buffer* dstBuffer = as_amd(dst_buffer)->asBuffer();
+  if ((srcBuffer == nullptr) || (dstBuffer == nullptr)) {
+    return CL_INVALID_MEM_OBJECT;
+  }
+  amd::CommandBuffer* commandBuffer = as_amd(command_buffer);
+  const amd::HostQueue& hostQueue = commandBuffer->queue();
+  if ((hostQueue.context() != srcBuffer->getContext()) ||
+      (hostQueue.context() != dstBuffer->getContext())) {
+    return CL_INVALID_CONTEXT;
+  }
+
+  amd::Coord3D srcOffset(src_offset, 0, 0);
+  amd::Coord3D dstOffset(dst_offset, 0, 0);
+  amd::Coord3D copySize(size, 1, 1);
+  if (!srcBuffer->validateRegion(srcOffset, copySize) ||
+      !dstBuffer->validateRegion(dstOffset, copySize)) {
+    return CL_INVALID_VALUE;
+  }
+  if ((srcBuffer == dstBuffer) &&
+      (((src_offset <= dst_offset) && (dst_offset < src_offset + size)) ||
+       ((dst_offset <= src_offset) && (src_offset < dst_offset + size)))) {
+    return CL_MEM_COPY_OVERLAP;
+  }
+
+  *not_null(sync_point) =
+      commandBuffer->addCopy(*srcBuffer, *dstBuffer, src_offset, dst_offset, size);
+  return CL_SUCCESS;
+}
+RUNTIME_EXIT
+
+/*! \brief Record a buffer fill.
+ *
+ *  \version 0.9 (cl_khr_command_buffer)
+ */
+RUNTIME_ENTRY(cl_int, clCommandFillBufferKHR,
+              (cl_command_buffer_khr command_buffer, cl_command_queue command_queue,
+               cl_mem buffer, const void* pattern, size_t pattern_size, size_t offset,
+               size_t size, cl_uint num_sync_points_in_wait_list,
+               const cl_sync_point_khr* sync_point_wait_list, cl_sync_point_khr* sync_point,
+               cl_mutable_command_khr* mutable_handle)) {
+  cl_int err = validateCommand(command_buffer, command_queue, num_sync_points_in_wait_list,
+                               sync_point_wait_list, mutable_handle);
+  if (err != CL_SUCCESS) {
+    return err;
+  }
+  if (!is_valid(buffer)) {
+    return CL_INVALID_MEM_OBJECT;
+  }
+  amd::Buffer* fillBuffer = as_amd(buffer)->asBuffer();
+  if (fillBuffer == nullptr) {
+    return CL_INVALID_MEM_OBJECT;
+  }
+  if ((pattern == nullptr) || (pattern_size == 0) ||
+      (pattern_size > amd::FillMemoryCommand::MaxFillPatterSize) ||
+      ((pattern_size & (pattern_size - 1)) != 0)) {
+    return CL_INVALID_VALUE;
+  }
+  // Offset and size must be multiple of pattern_size
+  if (!(amd::isMultipleOf(offset, pattern_size) && amd::isMultipleOf(size, pattern_size))) {
+    return CL_INVALID_VALUE;
+  }
+  amd::CommandBuffer* commandBuffer = as_amd(command_buffer);
+  amd::HostQueue& hostQueue = commandBuffer->queue();
+  if (hostQueue.context() != fillBuffer->getContext()) {
+    return CL_INVALID_CONTEXT;
+  }
+
+  amd::Coord3D fillOffset(offset, 0, 0);
+  amd::Coord3D fillSize(size, 1, 1);
+  // surface takes [pitch, width, height]
+  amd::Coord3D surface(size, size, 1);
+  if (!fillBuffer->validateRegion(fillOffset, fillSize)) {
+    return CL_INVALID_VALUE;
+  }
+
+  amd::FillMemoryCommand* command =
+      new amd::FillMemoryCommand(hostQueue, CL_COMMAND_FILL_BUFFER, amd::Command::EventWaitList{},
+                                 *fillBuffer, pattern, pattern_size, fillOffset, fillSize,
+                                 surface);
+  if (command == nullptr) {
+    return CL_OUT_OF_HOST_MEMORY;
+  }
+  // Make sure we have memory for the command execution
+  if (!command->validateMemory()) {
+    delete command;
+    return CL_MEM_OBJECT_ALLOCATION_FAILURE;
+  }
+
+  *not_null(sync_point) = commandBuffer->addCommand(command);
+  return CL_SUCCESS;
+}
+RUNTIME_EXIT
+
+/*! \brief Record a kernel launch. The kernel arguments are taken at the recording time.
+ *
+ *  \version 0.9 (cl_khr_command_buffer)
+ */
+RUNTIME_ENTRY(cl_int, clCommandNDRangeKernelKHR,
+              (cl_command_buffer_khr command_buffer, cl_command_queue command_queue,
+               const cl_ndrange_kernel_command_properties_khr* properties, cl_kernel kernel,
+               cl_uint work_dim, const size_t* global_work_offset, const size_t* global_work_size,
+               const size_t* local_work_size, cl_uint num_sync_points_in_wait_list,
+               const cl_sync_point_khr* sync_point_wait_list, cl_sync_point_khr* sync_point,
+               cl_mutable_command_khr* mutable_handle)) {
+  cl_int err = validateCommand(command_buffer, command_queue, num_sync_points_in_wait_list,
+                               sync_point_wait_list, mutable_handle);
+  if (err != CL_SUCCESS) {
+    return err;
+  }
+  if ((properties != nullptr) && (*properties != 0)) {
+    return CL_INVALID_VALUE;
+  }
+  if (!is_valid(kernel)) {
+    return CL_INVALID_KERNEL;
+  }
+  amd::CommandBuffer* commandBuffer = as_amd(command_buffer);
+  amd::HostQueue& hostQueue = commandBuffer->queue();
+  err = amd::clValidateNDRangeKernel(hostQueue, kernel, work_dim, global_work_offset,
+                                     global_work_size, local_work_size);
+  if (err != CL_SUCCESS) {
+    return err;
+  }
+
+  amd::NDRangeContainer ndrange((size_t)work_dim, global_work_offset, global_work_size,
+                                local_work_size);
+  amd::NDRangeKernelCommand* command = new amd::NDRangeKernelCommand(
+      hostQueue, amd::Command::EventWaitList{}, *as_amd(kernel), ndrange);
+  if (command == nullptr) {
+    return CL_OUT_OF_HOST_MEMORY;
+  }
+  // Snapshot the kernel arguments and make sure we have memory for the command execution
+  cl_int result = command->captureAndValidate();
+  if (result != CL_SUCCESS) {
+    delete command;
+    return result;
+  }
+
+  *not_null(sync_point) = commandBuffer->addCommand(command);
+  return CL_SUCCESS;
+}
+RUNTIME_EXIT
+
+/*! \brief Query the command buffer information.
+ *
+ *  \version 0.9 (cl_khr_command_buffer)
+ */
+RUNTIME_ENTRY(cl_int, clGetCommandBufferInfoKHR,
+              (cl_command_buffer_khr command_buffer, cl_command_buffer_info_khr param_name,
+               size_t param_value_size, void* param_value, size_t* param_value_size_ret)) {
+  if (!is_valid(command_buffer)) {
+    return CL_INVALID_COMMAND_BUFFER_KHR;
+  }
+  const amd::CommandBuffer* commandBuffer = as_amd(command_buffer);
+  switch (param_name) {
+    case CL_COMMAND_BUFFER_QUEUES_KHR: {
+      cl_command_queue queue = as_cl(commandBuffer->queue().asCommandQueue());
+      return amd::clGetInfo(queue, param_value_size, param_value, param_value_size_ret);
+    }
+    case CL_COMMAND_BUFFER_NUM_QUEUES_KHR: {
+      cl_uint count = 1;
+      return amd::clGetInfo(count, param_value_size, param_value, param_value_size_ret);
+    }
+    case CL_COMMAND_BUFFER_REFERENCE_COUNT_KHR: {
+      cl_uint count = commandBuffer->referenceCount();
+      return amd::clGetInfo(count, param_value_size, param_value, param_value_size_ret);
+    }
+    case CL_COMMAND_BUFFER_STATE_KHR: {
+      cl_command_buffer_state_khr state = commandBuffer->state();
+      return amd::clGetInfo(state, param_value_size, param_value, param_value_size_ret);
+    }
+    case CL_COMMAND_BUFFER_PROPERTIES_ARRAY_KHR: {
+      const auto& properties = commandBuffer->properties();
+      const size_t valueSize = properties.size() * sizeof(cl_command_buffer_properties_khr);
+      if ((param_value != nullptr) && (param_value_size < valueSize)) {
+        return CL_INVALID_VALUE;
+      }
+      *not_null(param_value_size_ret) = valueSize;
+      if ((param_value != nullptr) && (valueSize != 0)) {
+        ::memcpy(param_value, properties.data(), valueSize);
+      }
+      return CL_SUCCESS;
+    }
+    case CL_COMMAND_BUFFER_CONTEXT_KHR: {
+      cl_context context = as_cl(&commandBuffer->queue().context());
+      return amd::clGetInfo(context, param_value_size, param_value, param_value_size_ret);
+    }
+    default:
+      break;
+  }
+  return CL_INVALID_VALUE;
+}
+RUNTIME_EXIT
+
+/*! @}
+ *  @}
+ */
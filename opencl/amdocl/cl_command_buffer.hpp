@@ -0,0 +1,135 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#ifndef CL_COMMAND_BUFFER_HPP_
+#define CL_COMMAND_BUFFER_HPP_
+
+#include "platform/object.hpp"
+#include "platform/command.hpp"
+#include "platform/commandqueue.hpp"
+#include "cl_command_buffer_khr.h"
+
+#include <string>
+#include <vector>
+
+namespace amd {
+
+/*! \brief Kernel arguments of the captured AQL packets.
+ *
+ *  The arguments are written into host coherent kernarg memory once and stay valid for
+ *  the lifetime of the command buffer, hence every replay reuses them without an update.
+ */
+class CommandBufferKernArgPool : public GraphKernelArgManager {
+ public:
+  explicit CommandBufferKernArgPool(const Device& device) : device_(device) {}
+  ~CommandBufferKernArgPool();
+
+  //! Allocates the kernel arguments for a captured packet
+  address AllocKernArg(size_t size, size_t alignment) override;
+
+ private:
+  static constexpr size_t kChunkSize = 64 * Ki;  //!< The default size of a kernarg chunk
+
+  const Device& device_;                            //!< Device of the kernarg memory
+  std::vector<std::pair<address, size_t>> chunks_;  //!< Allocated chunks and their sizes
+  size_t offset_ = 0;                               //!< Offset of the next args in the last chunk
+};
+
+/*! \brief A recorded sequence of commands for cl_khr_command_buffer.
+ *
+ *  Kernels and fills are captured into AQL packets on finalization, the same way
+ *  the HIP graphs capture their nodes, and every enqueue dispatches the packets without
+ *  the command construction. Copies are replayed as regular commands, since they may
+ *  run on SDMA engines, which don't execute AQL packets.
+ */
+class CommandBuffer : public RuntimeObject {
+ public:
+  struct Record {
+    Command* command_ = nullptr;     //!< Captured command, keeps the kernel and memory alive
+    std::vector<uint8_t*> packets_;  //!< AQL packets of the captured command
+    std::string kernelName_;         //!< Kernel name of the captured packets
+    Buffer* src_ = nullptr;          //!< Source of a copy, replayed as a command
+    Buffer* dst_ = nullptr;          //!< Destination of a copy, replayed as a command
+    size_t srcOffset_ = 0;           //!< Source offset of a copy
+    size_t dstOffset_ = 0;           //!< Destination offset of a copy
+    size_t size_ = 0;                //!< Size of a copy
+  };
+
+  CommandBuffer(HostQueue& queue, cl_command_buffer_flags_khr flags,
+                const std::vector<cl_command_buffer_properties_khr>& properties);
+
+  //! Returns the queue, the command buffer was created for
+  HostQueue& queue() const { return queue_; }
+
+  //! Returns the properties, the command buffer was created with
+  const std::vector<cl_command_buffer_properties_khr>& properties() const {
+    return properties_;
+  }
+
+  //! Returns the state of the command buffer
+  cl_command_buffer_state_khr state() const;
+
+  //! Returns true if the command buffer can be enqueued while a previous enqueue is pending
+  bool simultaneousUse() const { return (flags_ & CL_COMMAND_BUFFER_SIMULTANEOUS_USE_KHR) != 0; }
+
+  //! Returns true if all sync points of the list were returned by this command buffer
+  bool validateSyncPoints(cl_uint numSyncPoints, const cl_sync_point_khr* syncPoints) const;
+
+  //! Records a kernel or a fill command for the capture. The buffer takes the command
+  cl_sync_point_khr addCommand(Command* command);
+
+  //! Records a buffer copy
+  cl_sync_point_khr addCopy(Buffer& src, Buffer& dst, size_t srcOffset, size_t dstOffset,
+                            size_t size);
+
+  //! Records a barrier, which is a nop on the in-order queues
+  cl_sync_point_khr addBarrier() { return nextSyncPoint_++; }
+
+  //! Captures the AQL packets of the recorded commands
+  cl_int finalize();
+
+  //! Replays the recorded commands on the queue and returns the last command
+  cl_int enqueue(HostQueue& queue, const Command::EventWaitList& eventWaitList,
+                 Command** lastCommand);
+
+  virtual ObjectType objectType() const { return ObjectTypeCommandBuffer; }
+
+ protected:
+  virtual ~CommandBuffer();
+
+ private:
+  HostQueue& queue_;                  //!< The queue of the recorded commands
+  cl_command_buffer_flags_khr flags_;  //!< CL_COMMAND_BUFFER_FLAGS_KHR
+  std::vector<cl_command_buffer_properties_khr> properties_;  //!< Creation properties
+  std::vector<Record> records_;       //!< Recorded commands in the submission order
+  CommandBufferKernArgPool kernArgs_;  //!< Kernel arguments of the captured packets
+  cl_sync_point_khr nextSyncPoint_ = 0;  //!< The sync point of the next recorded command
+  bool finalized_ = false;            //!< The commands were captured
+  Command* lastEnqueue_ = nullptr;    //!< The last command of the last enqueue
+  mutable Monitor lock_;              //!< Serializes the enqueues of the command buffer
+
+  //! Disable copy constructor and assignment
+  CommandBuffer(const CommandBuffer&) = delete;
+  CommandBuffer& operator=(const CommandBuffer&) = delete;
+};
+
+}  // namespace amd
+
+#endif  // CL_COMMAND_BUFFER_HPP_
@@ -99,14 +99,26 @@ clSetEventWaitList(
         if (&hostQueue.context() != &amdEvent->context()) {
             return CL_INVALID_CONTEXT;
         }
-        if ((amdEvent->command().queue() != &hostQueue) && !amdEvent->notifyCmdQueue()) {
-            return CL_INVALID_EVENT_WAIT_LIST;
+        if (amdEvent->command().queue() != &hostQueue) {
+            if (!amdEvent->notifyCmdQueue()) {
+                return CL_INVALID_EVENT_WAIT_LIST;
+            }
+        } else if (!hostQueue.properties().test(CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)) {
+            // The in-order queue already executes the earlier commands first, so skip
+            // the wait, which would otherwise turn into a barrier packet
+            continue;
         }
         eventWaitList.push_back(amdEvent);
     }
     return CL_SUCCESS;
 }
 
+//! Validates the kernel and the launch dimensions of clEnqueueNDRangeKernel.
+//! A NULL local_work_size is replaced with zeroes, which let the runtime pick the size
+cl_int clValidateNDRangeKernel(const HostQueue& hostQueue, cl_kernel kernel, cl_uint work_dim,
+                               const size_t* global_work_offset, const size_t* global_work_size,
+                               const size_t*& local_work_size);
+
 //! Common function declarations for CL-external graphics API interop
 cl_int clEnqueueAcquireExtObjectsAMD(cl_command_queue command_queue,
     cl_uint num_objects, const cl_mem* mem_objects,
@@ -35,6 +35,7 @@
 #include "cl_sdi_amd.h"
 #include "cl_thread_trace_amd.h"
 #include "cl_p2p_amd.h"
+#include "cl_command_buffer_khr.h"
 
 #include <GL/gl.h>
 #include <GL/glext.h>
@@ -488,6 +489,11 @@ CL_API_ENTRY void* CL_API_CALL clGetExtensionFunctionAddress(const char* func_na
 #if cl_amd_assembly_program
       CL_EXTENSION_ENTRYPOINT_CHECK(clCreateProgramWithAssemblyAMD);
 #endif  // cl_amd_assembly_program
+      CL_EXTENSION_ENTRYPOINT_CHECK(clCreateCommandBufferKHR);
+      CL_EXTENSION_ENTRYPOINT_CHECK(clCommandBarrierWithWaitListKHR);
+      CL_EXTENSION_ENTRYPOINT_CHECK(clCommandCopyBufferKHR);
+      CL_EXTENSION_ENTRYPOINT_CHECK(clCommandFillBufferKHR);
+      CL_EXTENSION_ENTRYPOINT_CHECK(clCommandNDRangeKernelKHR);
       break;
     case 'D':
       break;
@@ -510,6 +516,10 @@ CL_API_ENTRY void* CL_API_CALL clGetExtensionFunctionAddress(const char* func_na
 #if cl_amd_copy_buffer_p2p
       CL_EXTENSION_ENTRYPOINT_CHECK(clEnqueueCopyBufferP2PAMD);
 #endif  // cl_amd_copy_buffer_p2p
+      CL_EXTENSION_ENTRYPOINT_CHECK(clEnqueueCommandBufferKHR);
+      break;
+    case 'F':
+      CL_EXTENSION_ENTRYPOINT_CHECK(clFinalizeCommandBufferKHR);
       break;
     case 'G':
       CL_EXTENSION_ENTRYPOINT_CHECK(clGetKernelInfoAMD);
@@ -526,6 +536,7 @@ CL_API_ENTRY void* CL_API_CALL clGetExtensionFunctionAddress(const char* func_na
 #if defined(cl_khr_sub_groups) || defined(CL_VERSION_2_1)
       CL_EXTENSION_ENTRYPOINT_CHECK2(clGetKernelSubGroupInfoKHR,clGetKernelSubGroupInfo);
 #endif // defined(cl_khr_sub_groups) || defined(CL_VERSION_2_1)
+      CL_EXTENSION_ENTRYPOINT_CHECK(clGetCommandBufferInfoKHR);
       break;
     case 'I':
       CL_EXTENSION_ENTRYPOINT_CHECK(clIcdGetPlatformIDsKHR);
@@ -535,6 +546,8 @@ CL_API_ENTRY void* CL_API_CALL clGetExtensionFunctionAddress(const char* func_na
       CL_EXTENSION_ENTRYPOINT_CHECK(clRetainPerfCounterAMD);
       CL_EXTENSION_ENTRYPOINT_CHECK(clReleaseThreadTraceAMD);
       CL_EXTENSION_ENTRYPOINT_CHECK(clRetainThreadTraceAMD);
+      CL_EXTENSION_ENTRYPOINT_CHECK(clReleaseCommandBufferKHR);
+      CL_EXTENSION_ENTRYPOINT_CHECK(clRetainCommandBufferKHR);
       break;
     case 'S':
       CL_EXTENSION_ENTRYPOINT_CHECK(clSetThreadTraceParamAMD);
@@ -25,6 +25,7 @@
 #include "utils/versions.hpp"
 #include "os/os.hpp"
 #include "cl_semaphore_amd.h"
+#include "cl_command_buffer_khr.h"
 
 #include "CL/cl_ext.h"
 
@@ -454,6 +455,22 @@ RUNTIME_ENTRY(cl_int, clGetDeviceInfo,
         cl_uint numVersion = atoi(drvVersion.c_str());
         return amd::clGetInfo(numVersion, param_value_size, param_value, param_value_size_ret);
       }
+      case CL_DEVICE_COMMAND_BUFFER_CAPABILITIES_KHR: {
+        if (!as_amd(device)->settings().checkExtension(ClKhrCommandBuffer)) {
+          return CL_INVALID_VALUE;
+        }
+        // Captured packets and kernel arguments are immutable, hence the replays can overlap
+        cl_device_command_buffer_capabilities_khr caps =
+            CL_COMMAND_BUFFER_CAPABILITY_SIMULTANEOUS_USE_KHR;
+        return amd::clGetInfo(caps, param_value_size, param_value, param_value_size_ret);
+      }
+      case CL_DEVICE_COMMAND_BUFFER_REQUIRED_QUEUE_PROPERTIES_KHR: {
+        if (!as_amd(device)->settings().checkExtension(ClKhrCommandBuffer)) {
+          return CL_INVALID_VALUE;
+        }
+        cl_command_queue_properties properties = 0;
+        return amd::clGetInfo(properties, param_value_size, param_value, param_value_size_ret);
+      }
       default:
         break;
     }
@@ -186,6 +186,50 @@ RUNTIME_ENTRY(cl_int, clEnqueueNDRangeKernel,
   }
   amd::HostQueue& hostQueue = *queue;
 
+  cl_int err = amd::clValidateNDRangeKernel(hostQueue, kernel, work_dim, global_work_offset,
+                                            global_work_size, local_work_size);
+  if (err != CL_SUCCESS) {
+    return err;
+  }
+
+  amd::Command::EventWaitList eventWaitList;
+  err = amd::clSetEventWaitList(eventWaitList, hostQueue, num_events_in_wait_list,
+                                event_wait_list);
+  if (err != CL_SUCCESS) {
+    return err;
+  }
+
+  amd::NDRangeContainer ndrange((size_t)work_dim, global_work_offset, global_work_size,
+                                local_work_size);
+  amd::NDRangeKernelCommand* command =
+      new amd::NDRangeKernelCommand(hostQueue, eventWaitList, *as_amd(kernel), ndrange);
+  if (command == NULL) {
+    return CL_OUT_OF_HOST_MEMORY;
+  }
+  // ndrange is now owned by command. Do not delete it!
+
+  // Make sure we have memory for the command execution
+  cl_int result = command->captureAndValidate();
+  if (result != CL_SUCCESS) {
+    delete command;
+    return result;
+  }
+
+  command->enqueue();
+
+  *not_null(event) = as_cl(&command->event());
+  if (event == NULL) {
+    command->release();
+  }
+  return CL_SUCCESS;
+}
+RUNTIME_EXIT
+
+namespace amd {
+
+cl_int clValidateNDRangeKernel(const HostQueue& hostQueue, cl_kernel kernel, cl_uint work_dim,
+                               const size_t* global_work_offset, const size_t* global_work_size,
+                               const size_t*& local_work_size) {
   const amd::Kernel* amdKernel = as_amd(kernel);
   if (&hostQueue.context() != &amdKernel->program().context()) {
     return CL_INVALID_CONTEXT;
@@ -250,39 +294,10 @@ RUNTIME_ENTRY(cl_int, clEnqueueNDRangeKernel,
   if (!amdKernel->parameters().check()) {
     return CL_INVALID_KERNEL_ARGS;
   }
-
-  amd::Command::EventWaitList eventWaitList;
-  cl_int err = amd::clSetEventWaitList(eventWaitList, hostQueue, num_events_in_wait_list,
-                                       event_wait_list);
-  if (err != CL_SUCCESS) {
-    return err;
-  }
-
-  amd::NDRangeContainer ndrange((size_t)work_dim, global_work_offset, global_work_size,
-                                local_work_size);
-  amd::NDRangeKernelCommand* command =
-      new amd::NDRangeKernelCommand(hostQueue, eventWaitList, *as_amd(kernel), ndrange);
-  if (command == NULL) {
-    return CL_OUT_OF_HOST_MEMORY;
-  }
-  // ndrange is now owned by command. Do not delete it!
-
-  // Make sure we have memory for the command execution
-  cl_int result = command->captureAndValidate();
-  if (result != CL_SUCCESS) {
-    delete command;
-    return result;
-  }
-
-  command->enqueue();
-
-  *not_null(event) = as_cl(&command->event());
-  if (event == NULL) {
-    command->release();
-  }
   return CL_SUCCESS;
 }
-RUNTIME_EXIT
+
+}  // namespace amd
 
 /*! \brief Enqueue a command to execute a kernel on a device.
  *  The kernel is executed using a single work-item.
@@ -507,7 +507,10 @@ RUNTIME_ENTRY_RET(cl_mem, clCreateSubBuffer,
     return NULL;
   }
 
-  if (!mem->create(NULL)) {
+  // The device views share the parent allocation, so create them on the first use
+  constexpr bool kSysMemAlloc = false;
+  constexpr bool kSkipAlloc = true;
+  if (!mem->create(NULL, kSysMemAlloc, kSkipAlloc)) {
     *not_null(errcode_ret) = CL_MEM_OBJECT_ALLOCATION_FAILURE;
     mem->release();
     return NULL;
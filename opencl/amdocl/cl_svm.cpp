@@ -69,6 +69,44 @@ static bool validateMapFlags(cl_map_flags flags) {
   return true;
 }
 
+//! Returns true if the SVM map or unmap needs no work on the device, so it can complete inline
+//! without a command. That holds for the fine-grain memory, which the host accesses directly,
+//! once the queue and the wait list have nothing pending. An event requires a command.
+static bool isSvmMapInline(amd::HostQueue& queue, amd::Memory* svmMem,
+                           const amd::Command::EventWaitList& eventWaitList, cl_event* event) {
+  if (event != NULL) {
+    return false;
+  }
+  if (svmMem == NULL) {
+    // The pointer is valid without an SVM object only on fine-grained system devices
+    if (!queue.device().isFineGrainedSystem()) {
+      return false;
+    }
+  } else {
+    const device::Memory* mem = svmMem->getDeviceMemory(queue.device(), false);
+    // Multi-device contexts may skip the map info in the device layer, so keep them on the queue
+    if (((svmMem->getMemFlags() & CL_MEM_SVM_FINE_GRAIN_BUFFER) == 0) || (mem == NULL) ||
+        !mem->isHostMemDirectAccess() || (svmMem->getContext().devices().size() != 1)) {
+      return false;
+    }
+  }
+  for (const auto& it : eventWaitList) {
+    if (it->status() != CL_COMPLETE) {
+      return false;
+    }
+  }
+  if (!queue.isEmpty()) {
+    return false;
+  }
+  amd::Command* last = queue.getLastQueuedCommand(true);
+  if (last == NULL) {
+    return true;
+  }
+  const bool idle = (last->status() == CL_COMPLETE);
+  last->release();
+  return idle;
+}
+
 /*! \addtogroup API
  *  @{
  *
@@ -754,6 +792,15 @@ RUNTIME_ENTRY(cl_int, clEnqueueSVMMap,
     return err;
   }
 
+  if (isSvmMapInline(hostQueue, svmMem, eventWaitList, event)) {
+    if (svmMem != NULL) {
+      // Keep the map info, which the unmap command expects, the same way as the device layer
+      svmMem->getDeviceMemory(queue->device())->saveMapInfo(svm_ptr, amd::Coord3D(offset),
+          amd::Coord3D(size), map_flags, (offset == 0) && (size == svmMem->getSize()));
+    }
+    return CL_SUCCESS;
+  }
+
   amd::Command* command = new amd::SvmMapMemoryCommand(hostQueue, eventWaitList, svmMem, size,
                                                        offset, map_flags, svm_ptr);
   if (command == NULL) {
@@ -862,6 +909,13 @@ RUNTIME_ENTRY(cl_int, clEnqueueSVMUnmap,
     return err;
   }
 
+  if (isSvmMapInline(hostQueue, svmMem, eventWaitList, event)) {
+    if (svmMem != NULL) {
+      svmMem->getDeviceMemory(queue->device())->clearUnmapInfo(svm_ptr);
+    }
+    return CL_SUCCESS;
+  }
+
   amd::Command* command = new amd::SvmUnmapMemoryCommand(hostQueue, eventWaitList, svmMem, svm_ptr);
   if (command == NULL) {
     return CL_OUT_OF_HOST_MEMORY;
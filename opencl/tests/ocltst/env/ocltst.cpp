@@ -49,6 +49,7 @@ typedef void* ModuleHandle;
 #include "Worker.h"
 #include "getopt.h"
 #include "oclsysinfo.h"
+#include "perfreport.h"
 #include "pfm.h"
 
 //! Including OCLutilities Thread utility
@@ -98,6 +99,7 @@ class App {
         m_dump(false),
         m_perflab(false),
         m_noSysInfoPrint(false),
+        m_tolerance(5.0f),
         m_numItr(1),
         mp_testOrder(NULL),
         m_rndOrder(false),
@@ -341,6 +343,9 @@ class App {
   bool m_dump;
   bool m_perflab;
   bool m_noSysInfoPrint;
+  std::string m_reportFile;
+  std::string m_baselineFile;
+  float m_tolerance;
   int m_numItr;
   int* mp_testOrder;
   bool m_rndOrder;
@@ -554,6 +559,9 @@ void report(Worker* w, const char* testname, int testnum, unsigned int crc,
   bool perflab = w->getPerflab();
   unsigned int deviceId = w->getDeviceId();
 
+  perfReportAdd(w->getModule()->get_libname(), testname, testnum, testDesc,
+                timer, tr->passed);
+
   char tmpUnits[256];
   if (perflab) {
     oclTestLog(OCLTEST_LOG_ALWAYS, "%10.3f\n", timer);
@@ -1005,6 +1013,17 @@ static void Help(const char* name) {
              "   -o <filename> : dump the output to a specified file\n");
   oclTestLog(OCLTEST_LOG_ALWAYS,
              "   -c            : Run the test on the CPU device.\n");
+  oclTestLog(OCLTEST_LOG_ALWAYS,
+             "   -j <filename> : write the results with the device, driver "
+             "and flags\n");
+  oclTestLog(OCLTEST_LOG_ALWAYS,
+             "                 : to a JSON file, CSV if it ends with .csv\n");
+  oclTestLog(OCLTEST_LOG_ALWAYS,
+             "   -b <filename> : compare the results with a CSV report of an "
+             "earlier run\n");
+  oclTestLog(OCLTEST_LOG_ALWAYS,
+             "   -e <percent>  : regression tolerance of the comparison "
+             "(default 5)\n");
   oclTestLog(OCLTEST_LOG_ALWAYS, "                 : \n");
   oclTestLog(OCLTEST_LOG_ALWAYS,
              "                 : To run only one subtest of a test, append the "
@@ -1067,7 +1086,8 @@ unsigned int getPlatformID(const char* str) {
   return platform;
 }
 
-static const char* supported_options = "dg:lm:M:o:Ps:t:T:a:A:p:v:wxy:in:rcRVJ";
+static const char* supported_options =
+    "dg:lm:M:o:Ps:t:T:a:A:p:v:wxy:in:rcRVJj:b:e:";
 
 unsigned int parseCommandLineForPlatform(unsigned int argc, char** argv) {
   int c;
@@ -1228,6 +1248,15 @@ void App::CommandLine(unsigned int argc, char** argv) {
       case 'i':
         m_noSysInfoPrint = true;
         break;
+      case 'j':
+        m_reportFile = optarg;
+        break;
+      case 'b':
+        m_baselineFile = optarg;
+        break;
+      case 'e':
+        m_tolerance = static_cast<float>(atof(optarg));
+        break;
       default:
         Help(argv[0]);
         break;
@@ -1249,6 +1278,14 @@ void App::CommandLine(unsigned int argc, char** argv) {
   if (!hasOption) {
     Help(argv[0]);
   }
+
+  if (!m_reportFile.empty()) {
+    perfReportOpen(m_reportFile.c_str(), mpform_id, m_deviceId, m_useCPU);
+  }
+  if (!m_baselineFile.empty()) {
+    CHECK_RESULT(!perfReportLoadBaseline(m_baselineFile.c_str(), m_tolerance),
+                 "Couldn't load the baseline");
+  }
 }
 
 bool App::TestInList(StringList& strlist, const char* szModuleTestname) {
@@ -1474,6 +1511,7 @@ int main(int argc, char** argv) {
   // reset optind as we really didn't parse the full command line
   optind = 1;
   App app(platform);
+  unsigned int regressions = 0;
 #ifdef _WIN32
   // this function is registers windows service routine when ocltst is launched
   // by the OS on service initialization. On other scenarios, this function does
@@ -1492,6 +1530,7 @@ int main(int argc, char** argv) {
     for (int i = 0; i < app.GetNumItr(); i++) {
       app.RunAllTests();
     }
+    regressions = perfReportClose();
     app.CleanUp();
 #ifdef AUTO_REGRESS
   } catch (...) {
@@ -1500,7 +1539,8 @@ int main(int argc, char** argv) {
   }
 #endif /* AUTO_REGRESS */
 
-  return 0;
+  // The baseline comparison fails the run if a result regressed
+  return (regressions != 0) ? 1 : 0;
 }
 
 #ifdef _WIN32
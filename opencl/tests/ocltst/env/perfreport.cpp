@@ -0,0 +1,325 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "perfreport.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "OCLLog.h"
+
+#ifdef _WIN32
+#define environ _environ
+#else
+extern char** environ;
+#endif
+
+namespace {
+
+struct PerfResult {
+  std::string module;
+  std::string test;
+  int subtest;
+  std::string desc;
+  float value;
+  bool passed;
+};
+
+// Prefixes of the environment variables, which change the runtime behavior
+const char* FlagPrefixes[] = {"AMD_", "GPU_", "HIP_", "HSA_", "ROC_",
+                              "DEBUG_CLR_", "OCL_"};
+
+std::mutex reportLock;
+std::string reportFile;
+bool reportCsv = false;
+std::vector<std::pair<std::string, std::string>> metadata;
+std::vector<PerfResult> results;
+std::map<std::string, PerfResult> baseline;
+float baselineTolerance = 0.0f;
+
+std::string resultKey(const PerfResult& result) {
+  return result.module + ":" + result.test + "[" +
+         std::to_string(result.subtest) + "]";
+}
+
+// The descriptions carry the units, times are better when lower
+bool lowerIsBetter(const std::string& desc) {
+  static const char* Units[] = {"(ns)", "(us)", "(ms)", "(s)", "(sec)"};
+  for (const char* unit : Units) {
+    if (desc.find(unit) != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string csvField(const std::string& str) {
+  std::string field = "\"";
+  for (char c : str) {
+    if (c == '"') {
+      field += '"';
+    }
+    field += (c == '\n') ? ' ' : c;
+  }
+  return field + "\"";
+}
+
+std::string jsonString(const std::string& str) {
+  std::string result = "\"";
+  for (char c : str) {
+    if ((c == '"') || (c == '\\')) {
+      result += '\\';
+    }
+    result += (static_cast<unsigned char>(c) < 0x20) ? ' ' : c;
+  }
+  return result + "\"";
+}
+
+// Splits a CSV line, the quoted fields may contain commas and quotes
+std::vector<std::string> csvSplit(const std::string& line) {
+  std::vector<std::string> fields(1);
+  bool quoted = false;
+  for (size_t i = 0; i < line.size(); ++i) {
+    const char c = line[i];
+    if (quoted) {
+      if ((c == '"') && (i + 1 < line.size()) && (line[i + 1] == '"')) {
+        fields.back() += '"';
+        ++i;
+      } else if (c == '"') {
+        quoted = false;
+      } else {
+        fields.back() += c;
+      }
+    } else if (c == '"') {
+      quoted = true;
+    } else if (c == ',') {
+      fields.emplace_back();
+    } else if ((c != '\r') && (c != '\n')) {
+      fields.back() += c;
+    }
+  }
+  return fields;
+}
+
+void addDeviceInfo(cl_platform_id platform, unsigned int deviceId,
+                   bool useCPU) {
+  cl_uint numDevices = 0;
+  const cl_device_type type = useCPU ? CL_DEVICE_TYPE_CPU : CL_DEVICE_TYPE_GPU;
+  if ((clGetDeviceIDs(platform, type, 0, NULL, &numDevices) != CL_SUCCESS) ||
+      (deviceId >= numDevices)) {
+    return;
+  }
+  std::vector<cl_device_id> devices(numDevices);
+  clGetDeviceIDs(platform, type, numDevices, devices.data(), NULL);
+
+  char buffer[1024];
+  if (clGetPlatformInfo(platform, CL_PLATFORM_VERSION, sizeof(buffer), buffer,
+                        NULL) == CL_SUCCESS) {
+    metadata.emplace_back("platform", buffer);
+  }
+  static const struct {
+    const char* key;
+    cl_device_info info;
+  } Infos[] = {{"device", CL_DEVICE_NAME},
+               {"device_version", CL_DEVICE_VERSION},
+               {"driver", CL_DRIVER_VERSION}};
+  for (const auto& info : Infos) {
+    if (clGetDeviceInfo(devices[deviceId], info.info, sizeof(buffer), buffer,
+                        NULL) == CL_SUCCESS) {
+      metadata.emplace_back(info.key, buffer);
+    }
+  }
+  metadata.emplace_back("device_id", std::to_string(deviceId));
+}
+
+void addFlags() {
+  for (char** env = environ; (env != NULL) && (*env != NULL); ++env) {
+    for (const char* prefix : FlagPrefixes) {
+      if (strncmp(*env, prefix, strlen(prefix)) == 0) {
+        const std::string flag = *env;
+        const size_t pos = flag.find('=');
+        metadata.emplace_back("flag:" + flag.substr(0, pos),
+                              flag.substr(pos + 1));
+        break;
+      }
+    }
+  }
+}
+
+bool writeReport() {
+  FILE* fp = fopen(reportFile.c_str(), "w");
+  if (fp == NULL) {
+    return false;
+  }
+  if (reportCsv) {
+    for (const auto& data : metadata) {
+      fprintf(fp, "# %s: %s\n", data.first.c_str(), data.second.c_str());
+    }
+    fprintf(fp, "module,test,subtest,description,value,passed\n");
+    for (const auto& result : results) {
+      fprintf(fp, "%s,%s,%d,%s,%.6g,%d\n", csvField(result.module).c_str(),
+              csvField(result.test).c_str(), result.subtest,
+              csvField(result.desc).c_str(), result.value, result.passed);
+    }
+  } else {
+    fprintf(fp, "{\n  \"metadata\": {");
+    for (size_t i = 0; i < metadata.size(); ++i) {
+      fprintf(fp, "%s\n    %s: %s", (i == 0) ? "" : ",",
+              jsonString(metadata[i].first).c_str(),
+              jsonString(metadata[i].second).c_str());
+    }
+    fprintf(fp, "\n  },\n  \"results\": [");
+    for (size_t i = 0; i < results.size(); ++i) {
+      const PerfResult& result = results[i];
+      fprintf(fp,
+              "%s\n    {\"module\": %s, \"test\": %s, \"subtest\": %d, "
+              "\"description\": %s, \"value\": %.6g, \"passed\": %s}",
+              (i == 0) ? "" : ",", jsonString(result.module).c_str(),
+              jsonString(result.test).c_str(), result.subtest,
+              jsonString(result.desc).c_str(), result.value,
+              result.passed ? "true" : "false");
+    }
+    fprintf(fp, "\n  ]\n}\n");
+  }
+  fclose(fp);
+  return true;
+}
+
+unsigned int compareBaseline() {
+  unsigned int regressions = 0;
+  unsigned int compared = 0;
+  for (const auto& result : results) {
+    const auto it = baseline.find(resultKey(result));
+    if (it == baseline.end()) {
+      continue;
+    }
+    const PerfResult& base = it->second;
+    ++compared;
+    if (!result.passed) {
+      if (base.passed) {
+        ++regressions;
+        oclTestLog(OCLTEST_LOG_ALWAYS, "REGRESSION %s: failed, passed in the "
+                   "baseline\n", resultKey(result).c_str());
+      }
+      continue;
+    }
+    if (base.value == 0.0f) {
+      continue;
+    }
+    // Positive changes are improvements
+    float change = 100.0f * (result.value - base.value) / std::fabs(base.value);
+    if (lowerIsBetter(result.desc)) {
+      change = -change;
+    }
+    if (change < -baselineTolerance) {
+      ++regressions;
+      oclTestLog(OCLTEST_LOG_ALWAYS,
+                 "REGRESSION %s: %.3f vs %.3f baseline (%.1f%%) %s\n",
+                 resultKey(result).c_str(), result.value, base.value, change,
+                 result.desc.c_str());
+    }
+  }
+  oclTestLog(OCLTEST_LOG_ALWAYS,
+             "Baseline comparison: %u results compared, %u regressions "
+             "beyond %.1f%%\n", compared, regressions, baselineTolerance);
+  return regressions;
+}
+
+}  // namespace
+
+bool perfReportOpen(const char* filename, cl_platform_id platform,
+                    unsigned int deviceId, bool useCPU) {
+  std::lock_guard<std::mutex> lock(reportLock);
+  reportFile = filename;
+  const size_t length = reportFile.size();
+  reportCsv = (length >= 4) && (reportFile.compare(length - 4, 4, ".csv") == 0);
+  FILE* fp = fopen(filename, "w");
+  if (fp == NULL) {
+    oclTestLog(OCLTEST_LOG_ALWAYS, "ERROR: Cannot open the report file %s\n",
+               filename);
+    reportFile.clear();
+    return false;
+  }
+  fclose(fp);
+  addDeviceInfo(platform, deviceId, useCPU);
+  addFlags();
+  return true;
+}
+
+bool perfReportLoadBaseline(const char* filename, float tolerance) {
+  std::lock_guard<std::mutex> lock(reportLock);
+  FILE* fp = fopen(filename, "r");
+  if (fp == NULL) {
+    oclTestLog(OCLTEST_LOG_ALWAYS, "ERROR: Cannot open the baseline %s\n",
+               filename);
+    return false;
+  }
+  baselineTolerance = tolerance;
+  char buffer[4096];
+  bool header = true;
+  while (fgets(buffer, sizeof(buffer), fp) != NULL) {
+    if (buffer[0] == '#') {
+      continue;
+    }
+    // Skip the column names
+    if (header) {
+      header = false;
+      continue;
+    }
+    const std::vector<std::string> fields = csvSplit(buffer);
+    if (fields.size() != 6) {
+      continue;
+    }
+    PerfResult result = {fields[0], fields[1], atoi(fields[2].c_str()),
+                         fields[3], static_cast<float>(atof(fields[4].c_str())),
+                         atoi(fields[5].c_str()) != 0};
+    baseline[resultKey(result)] = result;
+  }
+  fclose(fp);
+  return true;
+}
+
+void perfReportAdd(const char* module, const char* test, int subtest,
+                   const char* desc, float value, bool passed) {
+  std::lock_guard<std::mutex> lock(reportLock);
+  if (reportFile.empty() && baseline.empty()) {
+    return;
+  }
+  results.push_back({module, test, subtest, (desc != NULL) ? desc : "", value,
+                     passed});
+}
+
+unsigned int perfReportClose() {
+  std::lock_guard<std::mutex> lock(reportLock);
+  if (!reportFile.empty() && !writeReport()) {
+    oclTestLog(OCLTEST_LOG_ALWAYS, "ERROR: Cannot write the report file %s\n",
+               reportFile.c_str());
+  }
+  const unsigned int regressions = baseline.empty() ? 0 : compareBaseline();
+  results.clear();
+  return regressions;
+}
@@ -0,0 +1,45 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#ifndef _PERFREPORT_H_
+#define _PERFREPORT_H_
+
+#include <CL/cl.h>
+
+//! Opens the machine-readable report of the run. The report is a CSV file if
+//! the name ends with ".csv" and a JSON file otherwise. The metadata names the
+//! device, the driver and the runtime flags found in the environment
+bool perfReportOpen(const char* filename, cl_platform_id platform,
+                    unsigned int deviceId, bool useCPU);
+
+//! Loads a CSV report of an earlier run, which the results are compared with.
+//! A result regresses if it is worse than the baseline by more than the
+//! tolerance in percent
+bool perfReportLoadBaseline(const char* filename, float tolerance);
+
+//! Adds the result of a subtest
+void perfReportAdd(const char* module, const char* test, int subtest,
+                   const char* desc, float value, bool passed);
+
+//! Writes the report and prints the baseline comparison.
+//! Returns the number of the regressions
+unsigned int perfReportClose();
+
+#endif  // _PERFREPORT_H_
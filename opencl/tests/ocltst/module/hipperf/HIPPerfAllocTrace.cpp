@@ -0,0 +1,241 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "HIPPerfAllocTrace.h"
+
+#include <Timer.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <utility>
+
+// The pool telemetry of the runtime, see hip_internal.hpp
+#ifndef hipExtMemPoolAttrAllocReused
+#define hipExtMemPoolAttrAllocReused static_cast<hipMemPoolAttr>(0x1000)
+#define hipExtMemPoolAttrAllocNew static_cast<hipMemPoolAttr>(0x1001)
+#endif
+
+static const unsigned int NumStreams = 4;
+static const unsigned int TraceLength = 20000;
+static const unsigned int Replays = 5;
+
+HIPPerfAllocTrace::HIPPerfAllocTrace() : name_(nullptr), pool_(nullptr) {
+  // Generated training and inference traces, then the recorded trace
+  _numSubTests = 3;
+}
+
+HIPPerfAllocTrace::~HIPPerfAllocTrace() {}
+
+bool HIPPerfAllocTrace::loadTrace(const char* fileName) {
+  std::ifstream file(fileName);
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || (line[0] == '#')) {
+      continue;
+    }
+    std::istringstream stream(line);
+    Entry entry;
+    if (!(stream >> entry.size_ >> entry.stream_ >> entry.distance_) ||
+        (entry.size_ == 0)) {
+      return false;
+    }
+    entry.stream_ %= NumStreams;
+    trace_.push_back(entry);
+  }
+  return !trace_.empty();
+}
+
+void HIPPerfAllocTrace::generateTrace(bool training) {
+  std::mt19937 random(training ? 1 : 2);
+  // Log-uniform sizes from 256 bytes to 64 MB
+  std::uniform_real_distribution<double> logSize(8.0, 26.0);
+  std::uniform_int_distribution<unsigned int> stream(0, NumStreams - 1);
+  std::geometric_distribution<unsigned int> shortLived(0.1);
+
+  // Inference repeats the same layer shapes, training adds the gradients,
+  // which live until the end of the backward pass
+  std::vector<size_t> layers(64);
+  for (auto& it : layers) {
+    it = static_cast<size_t>(std::exp2(logSize(random)));
+  }
+  for (unsigned int i = 0; i < TraceLength; ++i) {
+    Entry entry;
+    entry.size_ = layers[i % layers.size()];
+    entry.stream_ = stream(random);
+    entry.distance_ = shortLived(random);
+    if (training && ((i % 3) == 0)) {
+      entry.size_ = static_cast<size_t>(std::exp2(logSize(random)));
+      entry.distance_ = static_cast<unsigned int>(layers.size() * 2);
+    }
+    trace_.push_back(entry);
+  }
+}
+
+void HIPPerfAllocTrace::open(unsigned int test, char* units,
+                             double& conversion, unsigned int deviceId) {
+  HIPPerfTestImp::open(test, units, conversion, deviceId);
+  CHECK_RESULT(_errorFlag, "Error opening test");
+
+  int supported = 0;
+  hipError_t error = hipDeviceGetAttribute(
+      &supported, hipDeviceAttributeMemoryPoolsSupported, deviceId);
+  CHECK_HIP(error, "hipDeviceGetAttribute() failed");
+  if (supported == 0) {
+    printf("Memory pools aren't supported, skipping the test\n");
+    failed_ = true;
+    return;
+  }
+  static const char* Names[] = {"training", "inference", "recorded"};
+  name_ = Names[test];
+  if (test < 2) {
+    generateTrace(test == 0);
+  } else {
+    const char* fileName = getenv("HIPPERF_ALLOC_TRACE");
+    if ((fileName == nullptr) || (fileName[0] == '\0')) {
+      printf("HIPPERF_ALLOC_TRACE isn't set, skipping the test\n");
+      failed_ = true;
+      return;
+    }
+    CHECK_RESULT(!loadTrace(fileName), "Can't parse the trace %s", fileName);
+  }
+
+  streams_.resize(NumStreams, nullptr);
+  for (auto& it : streams_) {
+    error = hipStreamCreateWithFlags(&it, hipStreamNonBlocking);
+    CHECK_HIP(error, "hipStreamCreateWithFlags() failed");
+  }
+  error = hipDeviceGetDefaultMemPool(&pool_, deviceId);
+  CHECK_HIP(error, "hipDeviceGetDefaultMemPool() failed");
+  // Frameworks keep the freed memory in the pool between the iterations
+  uint64_t threshold = UINT64_MAX;
+  error = hipMemPoolSetAttribute(pool_, hipMemPoolAttrReleaseThreshold,
+                                 &threshold);
+  CHECK_HIP(error, "hipMemPoolSetAttribute() failed");
+}
+
+bool HIPPerfAllocTrace::replay() {
+  typedef std::pair<size_t, size_t> Release;  // (due index, trace index)
+  std::priority_queue<Release, std::vector<Release>, std::greater<Release>>
+      pending;
+  std::vector<void*> ptrs(trace_.size(), nullptr);
+  for (size_t i = 0; i < trace_.size(); ++i) {
+    const Entry& entry = trace_[i];
+    if (hipMallocAsync(&ptrs[i], entry.size_, streams_[entry.stream_]) !=
+        hipSuccess) {
+      return false;
+    }
+    pending.emplace(i + entry.distance_, i);
+    while (!pending.empty() && (pending.top().first <= i)) {
+      const size_t index = pending.top().second;
+      pending.pop();
+      if (hipFreeAsync(ptrs[index], streams_[trace_[index].stream_]) !=
+          hipSuccess) {
+        return false;
+      }
+    }
+  }
+  while (!pending.empty()) {
+    const size_t index = pending.top().second;
+    pending.pop();
+    if (hipFreeAsync(ptrs[index], streams_[trace_[index].stream_]) !=
+        hipSuccess) {
+      return false;
+    }
+  }
+  for (auto it : streams_) {
+    if (hipStreamSynchronize(it) != hipSuccess) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HIPPerfAllocTrace::run(void) {
+  if (_errorFlag || failed_) {
+    return;
+  }
+  // Start from an empty pool with the reset statistics
+  hipError_t error = hipMemPoolTrimTo(pool_, 0);
+  CHECK_HIP(error, "hipMemPoolTrimTo() failed");
+  uint64_t value = 0;
+  hipMemPoolSetAttribute(pool_, hipMemPoolAttrReservedMemHigh, &value);
+  hipMemPoolSetAttribute(pool_, hipMemPoolAttrUsedMemHigh, &value);
+  hipMemPoolSetAttribute(pool_, hipExtMemPoolAttrAllocReused, &value);
+
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  for (unsigned int i = 0; i < Replays; ++i) {
+    CHECK_RESULT(!replay(), "The %s trace replay failed", name_);
+  }
+  timer.Stop();
+
+  uint64_t reservedHigh = 0;
+  uint64_t usedHigh = 0;
+  uint64_t reused = 0;
+  uint64_t created = 0;
+  hipMemPoolGetAttribute(pool_, hipMemPoolAttrReservedMemHigh, &reservedHigh);
+  hipMemPoolGetAttribute(pool_, hipMemPoolAttrUsedMemHigh, &usedHigh);
+  // The telemetry is optional, the hit rate stays unknown without it
+  const bool telemetry =
+      (hipMemPoolGetAttribute(pool_, hipExtMemPoolAttrAllocReused, &reused) ==
+       hipSuccess) &&
+      (hipMemPoolGetAttribute(pool_, hipExtMemPoolAttrAllocNew, &created) ==
+       hipSuccess);
+  hipGetLastError();
+
+  const double allocs = static_cast<double>(trace_.size()) * Replays;
+  printf("\n%s trace, %zu entries on %u streams\n", name_, trace_.size(),
+         NumStreams);
+  printf("  throughput %.0f allocs/s, peak reserved %.1f MB, peak used %.1f MB",
+         allocs / timer.GetElapsedTime(), reservedHigh / 1048576.0,
+         usedHigh / 1048576.0);
+  if (telemetry && ((reused + created) != 0)) {
+    printf(", pool hit rate %.1f%%",
+           100.0 * reused / static_cast<double>(reused + created));
+  }
+  printf("\n");
+
+  std::stringstream stream;
+  stream << "hipMallocAsync+hipFreeAsync, " << name_
+         << " trace (allocs/s)";
+  testDescString = stream.str();
+  _perfInfo = static_cast<float>(allocs / timer.GetElapsedTime());
+}
+
+unsigned int HIPPerfAllocTrace::close(void) {
+  for (auto it : streams_) {
+    if (it != nullptr) {
+      hipStreamDestroy(it);
+    }
+  }
+  streams_.clear();
+  trace_.clear();
+  if (pool_ != nullptr) {
+    hipMemPoolTrimTo(pool_, 0);
+    pool_ = nullptr;
+  }
+  return HIPPerfTestImp::close();
+}
@@ -0,0 +1,62 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#ifndef _HIPPerfAllocTrace_H_
+#define _HIPPerfAllocTrace_H_
+
+#include <vector>
+
+#include "HIPPerfTestImp.h"
+
+//! Replays allocation traces against hipMallocAsync/hipFreeAsync on several
+//! streams. A trace entry allocates the size on the stream and frees it after
+//! the given number of the later allocations. HIPPERF_ALLOC_TRACE points to a
+//! recorded trace with "size stream distance" lines, otherwise the test runs
+//! the generated traces only
+class HIPPerfAllocTrace : public HIPPerfTestImp {
+ public:
+  struct Entry {
+    size_t size_;           //!< Allocation size in bytes
+    unsigned int stream_;   //!< Index of the stream for the allocation
+    unsigned int distance_;  //!< The number of allocations before the free
+  };
+
+  HIPPerfAllocTrace();
+  virtual ~HIPPerfAllocTrace();
+
+ public:
+  virtual void open(unsigned int test, char* units, double& conversion,
+                    unsigned int deviceId);
+  virtual void run(void);
+  virtual unsigned int close(void);
+
+ private:
+  bool loadTrace(const char* fileName);
+  void generateTrace(bool training);
+  //! Replays the trace once, returns false on an error
+  bool replay();
+
+  const char* name_;
+  std::vector<Entry> trace_;
+  std::vector<hipStream_t> streams_;
+  hipMemPool_t pool_;
+};
+
+#endif  // _HIPPerfAllocTrace_H_
@@ -0,0 +1,249 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "HIPPerfCopyPath.h"
+
+#include <Timer.h>
+
+#include <cstdlib>
+#include <sstream>
+
+static const char* CopyKernel =
+    "extern \"C\" __global__ void copy(const unsigned char* src,\n"
+    "                                  unsigned char* dst, size_t size) {\n"
+    "  const size_t id = size_t(blockIdx.x) * blockDim.x + threadIdx.x;\n"
+    "  const size_t stride = size_t(gridDim.x) * blockDim.x;\n"
+    "  const size_t vecs = size / sizeof(uint4);\n"
+    "  for (size_t i = id; i < vecs; i += stride) {\n"
+    "    reinterpret_cast<uint4*>(dst)[i] =\n"
+    "        reinterpret_cast<const uint4*>(src)[i];\n"
+    "  }\n"
+    "  for (size_t i = vecs * sizeof(uint4) + id; i < size; i += stride) {\n"
+    "    dst[i] = src[i];\n"
+    "  }\n"
+    "}\n";
+
+static const size_t Sizes[] = {4, 256, 16 * 1024, 1024 * 1024,
+                               64 * 1024 * 1024, 1024 * 1024 * 1024,
+                               4ull * 1024 * 1024 * 1024};
+static const unsigned int NumSizes = sizeof(Sizes) / sizeof(Sizes[0]);
+
+static const struct {
+  HIPPerfCopyPath::MemKind src_;
+  HIPPerfCopyPath::MemKind dst_;
+} Directions[] = {
+    {HIPPerfCopyPath::Device, HIPPerfCopyPath::Device},
+    {HIPPerfCopyPath::Pageable, HIPPerfCopyPath::Device},
+    {HIPPerfCopyPath::Device, HIPPerfCopyPath::Pageable},
+    {HIPPerfCopyPath::Pinned, HIPPerfCopyPath::Device},
+    {HIPPerfCopyPath::Device, HIPPerfCopyPath::Pinned},
+    {HIPPerfCopyPath::Managed, HIPPerfCopyPath::Device},
+    {HIPPerfCopyPath::Device, HIPPerfCopyPath::Managed},
+};
+static const unsigned int NumDirections =
+    sizeof(Directions) / sizeof(Directions[0]);
+
+static const char* KindNames[] = {"pageable", "pinned", "device", "managed"};
+static const char* PathNames[] = {"runtime", "sdma", "kernel"};
+
+static const size_t BytesPerPath = 1024 * 1024 * 1024;
+static const size_t MaxIterations = 1000;
+static const unsigned int BlockSize = 256;
+static const unsigned int MaxBlocks = 1024;
+
+HIPPerfCopyPath::HIPPerfCopyPath()
+    : size_(0),
+      srcKind_(Device),
+      dstKind_(Device),
+      src_(nullptr),
+      dst_(nullptr),
+      copy_(nullptr) {
+  _numSubTests = NumDirections * NumSizes;
+}
+
+HIPPerfCopyPath::~HIPPerfCopyPath() {}
+
+void* HIPPerfCopyPath::allocate(MemKind kind) {
+  void* ptr = nullptr;
+  hipError_t error = hipSuccess;
+  switch (kind) {
+    case Pageable:
+      ptr = malloc(size_);
+      break;
+    case Pinned:
+      error = hipHostMalloc(&ptr, size_, hipHostMallocDefault);
+      break;
+    case Device:
+      error = hipMalloc(&ptr, size_);
+      break;
+    case Managed:
+      error = hipMallocManaged(&ptr, size_, hipMemAttachGlobal);
+      break;
+  }
+  return (error == hipSuccess) ? ptr : nullptr;
+}
+
+void HIPPerfCopyPath::release(MemKind kind, void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  switch (kind) {
+    case Pageable:
+      free(ptr);
+      break;
+    case Pinned:
+      hipHostFree(ptr);
+      break;
+    case Device:
+    case Managed:
+      hipFree(ptr);
+      break;
+  }
+}
+
+void HIPPerfCopyPath::open(unsigned int test, char* units, double& conversion,
+                           unsigned int deviceId) {
+  HIPPerfTestImp::open(test, units, conversion, deviceId);
+  CHECK_RESULT(_errorFlag, "Error opening test");
+  CHECK_RESULT(!loadKernel(CopyKernel, "copy", &copy_),
+               "Copy kernel compilation failed");
+  size_ = Sizes[test % NumSizes];
+  srcKind_ = Directions[test / NumSizes].src_;
+  dstKind_ = Directions[test / NumSizes].dst_;
+
+  src_ = allocate(srcKind_);
+  dst_ = allocate(dstKind_);
+  if ((src_ == nullptr) || (dst_ == nullptr)) {
+    printf("Can't allocate %zu bytes, skipping the test\n", size_);
+    failed_ = true;
+    return;
+  }
+  if (srcKind_ == Pageable) {
+    memset(src_, 0x5a, size_);
+  } else {
+    hipError_t error = hipMemset(src_, 0x5a, size_);
+    CHECK_HIP(error, "hipMemset() failed");
+  }
+}
+
+double HIPPerfCopyPath::measure(Path path) {
+  // The forced paths need the memory objects on both sides of the copy
+  if ((path != Runtime) && ((srcKind_ == Pageable) || (dstKind_ == Pageable))) {
+    return 0.0;
+  }
+  size_t blocks = (size_ / 16 + BlockSize - 1) / BlockSize;
+  blocks = (blocks > MaxBlocks) ? MaxBlocks : blocks;
+  void* args[] = {&src_, &dst_, &size_};
+
+  size_t iterations = BytesPerPath / size_;
+  iterations = (iterations == 0) ? 1 : iterations;
+  iterations = (iterations > MaxIterations) ? MaxIterations : iterations;
+
+  CPerfCounter timer;
+  // The first copy warms up the path
+  for (size_t i = 0; i <= iterations; ++i) {
+    if (i == 1) {
+      if (hipStreamSynchronize(stream_) != hipSuccess) {
+        return -1.0;
+      }
+      timer.Reset();
+      timer.Start();
+    }
+    hipError_t error = hipSuccess;
+    switch (path) {
+      case Runtime:
+        error = hipMemcpyAsync(dst_, src_, size_, hipMemcpyDefault, stream_);
+        break;
+      case Sdma:
+        error = hipMemcpyAsync(dst_, src_, size_, hipMemcpyDeviceToDeviceNoCU,
+                               stream_);
+        break;
+      case Kernel:
+        error = hipModuleLaunchKernel(copy_, blocks, 1, 1, BlockSize, 1, 1, 0,
+                                      stream_, args, nullptr);
+        break;
+      default:
+        break;
+    }
+    if (error != hipSuccess) {
+      return -1.0;
+    }
+  }
+  if (hipStreamSynchronize(stream_) != hipSuccess) {
+    return -1.0;
+  }
+  timer.Stop();
+  return timer.GetElapsedTime() / iterations;
+}
+
+void HIPPerfCopyPath::run(void) {
+  if (_errorFlag || failed_) {
+    return;
+  }
+  double times[TotalPaths];
+  int best = Runtime;
+  for (int p = Runtime; p < TotalPaths; ++p) {
+    times[p] = measure(static_cast<Path>(p));
+    CHECK_RESULT((times[p] < 0.0), "The %s copy failed", PathNames[p]);
+    if ((times[p] > 0.0) && (times[p] < times[best])) {
+      best = p;
+    }
+  }
+
+  // The runtime picked a path, which runs as fast as the closest forced one
+  int picked = Runtime;
+  double diff = 0.0;
+  for (int p = Sdma; p < TotalPaths; ++p) {
+    const double delta = (times[p] > times[Runtime])
+                             ? (times[p] - times[Runtime])
+                             : (times[Runtime] - times[p]);
+    if ((times[p] > 0.0) && ((picked == Runtime) || (delta < diff))) {
+      picked = p;
+      diff = delta;
+    }
+  }
+
+  printf("\n%s -> %s, %zu bytes:", KindNames[srcKind_], KindNames[dstKind_],
+         size_);
+  for (int p = Runtime; p < TotalPaths; ++p) {
+    if (times[p] > 0.0) {
+      printf(" %s %.3f GB/s (%.2f us)", PathNames[p],
+             static_cast<double>(size_) / times[p] / 1e9, times[p] * 1e6);
+    }
+  }
+  printf("\n  runtime path is closest to %s, the best path is %s, "
+         "runtime/best time %.2f\n",
+         PathNames[picked], PathNames[best], times[Runtime] / times[best]);
+
+  std::stringstream stream;
+  stream << KindNames[srcKind_] << "->" << KindNames[dstKind_] << ", "
+         << size_ << " bytes, runtime vs best path (GB/s)";
+  testDescString = stream.str();
+  _perfInfo = static_cast<float>(static_cast<double>(size_) / times[Runtime] /
+                                 1e9);
+}
+
+unsigned int HIPPerfCopyPath::close(void) {
+  release(srcKind_, src_);
+  release(dstKind_, dst_);
+  src_ = nullptr;
+  dst_ = nullptr;
+  return HIPPerfTestImp::close();
+}
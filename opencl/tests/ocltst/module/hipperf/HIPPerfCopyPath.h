@@ -0,0 +1,57 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#ifndef _HIPPerfCopyPath_H_
+#define _HIPPerfCopyPath_H_
+
+#include "HIPPerfTestImp.h"
+
+//! Sweeps the copy sizes, directions and memory kinds. Every copy runs through
+//! the runtime's own path selection and through the forced SDMA and blit
+//! kernel paths, so the selection can be compared to the best measured path
+class HIPPerfCopyPath : public HIPPerfTestImp {
+ public:
+  enum MemKind { Pageable, Pinned, Device, Managed };
+  enum Path { Runtime, Sdma, Kernel, TotalPaths };
+
+  HIPPerfCopyPath();
+  virtual ~HIPPerfCopyPath();
+
+ public:
+  virtual void open(unsigned int test, char* units, double& conversion,
+                    unsigned int deviceId);
+  virtual void run(void);
+  virtual unsigned int close(void);
+
+ private:
+  void* allocate(MemKind kind);
+  void release(MemKind kind, void* ptr);
+  //! Returns the time of a single copy in seconds, negative on an error
+  double measure(Path path);
+
+  size_t size_;
+  MemKind srcKind_;
+  MemKind dstKind_;
+  void* src_;
+  void* dst_;
+  hipFunction_t copy_;
+};
+
+#endif  // _HIPPerfCopyPath_H_
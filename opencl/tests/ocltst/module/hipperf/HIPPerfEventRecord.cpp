@@ -0,0 +1,83 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "HIPPerfEventRecord.h"
+
+#include <Timer.h>
+
+#include <sstream>
+
+static const unsigned int Iterations = 10000;
+
+HIPPerfEventRecord::HIPPerfEventRecord() : event_(nullptr) {
+  // hipEventRecord alone, followed by hipEventQuery, with timing disabled
+  _numSubTests = 3;
+}
+
+HIPPerfEventRecord::~HIPPerfEventRecord() {}
+
+void HIPPerfEventRecord::open(unsigned int test, char* units,
+                              double& conversion, unsigned int deviceId) {
+  HIPPerfTestImp::open(test, units, conversion, deviceId);
+  CHECK_RESULT(_errorFlag, "Error opening test");
+  const unsigned int flags =
+      (test == 2) ? hipEventDisableTiming : hipEventDefault;
+  hipError_t error = hipEventCreateWithFlags(&event_, flags);
+  CHECK_HIP(error, "hipEventCreateWithFlags() failed");
+}
+
+void HIPPerfEventRecord::run(void) {
+  if (_errorFlag) {
+    return;
+  }
+  const bool query = (test_ != 0);
+  hipError_t error = hipSuccess;
+
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  for (unsigned int i = 0; i < Iterations; ++i) {
+    error = hipEventRecord(event_, stream_);
+    CHECK_HIP(error, "hipEventRecord() failed");
+    if (query) {
+      error = hipEventQuery(event_);
+      CHECK_RESULT(((error != hipSuccess) && (error != hipErrorNotReady)),
+                   "hipEventQuery() failed");
+    }
+  }
+  timer.Stop();
+  error = hipStreamSynchronize(stream_);
+  CHECK_HIP(error, "hipStreamSynchronize() failed");
+
+  static const char* Names[] = {"hipEventRecord", "hipEventRecord+Query",
+                                "hipEventRecord+Query, no timing"};
+  std::stringstream stream;
+  stream << Names[test_] << " (us)";
+  testDescString = stream.str();
+  _perfInfo = static_cast<float>(timer.GetElapsedTime() * 1000000 / Iterations);
+}
+
+unsigned int HIPPerfEventRecord::close(void) {
+  if (event_ != nullptr) {
+    hipEventDestroy(event_);
+    event_ = nullptr;
+  }
+  return HIPPerfTestImp::close();
+}
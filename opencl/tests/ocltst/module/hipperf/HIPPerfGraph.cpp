@@ -0,0 +1,286 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "HIPPerfGraph.h"
+
+#include <Timer.h>
+
+#include <cstdlib>
+#include <sstream>
+
+static const char* ScalarKernel =
+    "extern \"C\" __global__ void scalar(int value) {}\n";
+
+static const unsigned int InstantiateNodes[] = {10, 100, 1000, 10000, 100000};
+static const unsigned int NumInstantiate =
+    sizeof(InstantiateNodes) / sizeof(InstantiateNodes[0]);
+
+//! The subtests after the instantiation sweep
+enum SubTest { Launch, Update, SetParams, ReplayChain, ReplayForkJoin,
+               ReplayWide, TotalSubTests };
+
+static const unsigned int DefaultNodes = 1000;
+static const unsigned int LaunchNodes = 100;
+static const unsigned int ForkJoinWidth = 32;
+static const unsigned int Iterations = 100;
+
+static const char* ShapeNames[] = {"chain", "fork-join", "wide"};
+
+HIPPerfGraph::HIPPerfGraph()
+    : kernel_(nullptr),
+      shape_(Chain),
+      numNodes_(0),
+      value_(0),
+      graph_(nullptr),
+      graphExec_(nullptr) {
+  _numSubTests = NumInstantiate + TotalSubTests;
+  args_[0] = &value_;
+}
+
+HIPPerfGraph::~HIPPerfGraph() {}
+
+hipKernelNodeParams HIPPerfGraph::nodeParams(void** args) const {
+  hipKernelNodeParams params = {};
+  params.func = reinterpret_cast<void*>(kernel_);
+  params.gridDim = dim3(1, 1, 1);
+  params.blockDim = dim3(1, 1, 1);
+  params.kernelParams = args;
+  return params;
+}
+
+bool HIPPerfGraph::buildGraph(Shape shape, unsigned int numNodes,
+                              hipGraph_t* graph,
+                              std::vector<hipGraphNode_t>* nodes) {
+  if (hipGraphCreate(graph, 0) != hipSuccess) {
+    return false;
+  }
+  const hipKernelNodeParams params = nodeParams(args_);
+  nodes->resize(numNodes);
+  for (unsigned int i = 0; i < numNodes; ++i) {
+    std::vector<hipGraphNode_t> deps;
+    if (i != 0) {
+      switch (shape) {
+        case Chain:
+          deps.push_back((*nodes)[i - 1]);
+          break;
+        case ForkJoin:
+          // The root forks into parallel chains, the last node joins them
+          if (i == numNodes - 1) {
+            for (unsigned int c = 0; (c < ForkJoinWidth) && (c < i); ++c) {
+              deps.push_back((*nodes)[i - 1 - c]);
+            }
+          } else {
+            const unsigned int parent =
+                (i <= ForkJoinWidth) ? 0 : (i - ForkJoinWidth);
+            deps.push_back((*nodes)[parent]);
+          }
+          break;
+        case Wide:
+          deps.push_back((*nodes)[0]);
+          break;
+      }
+    }
+    if (hipGraphAddKernelNode(&(*nodes)[i], *graph, deps.data(), deps.size(),
+                              &params) != hipSuccess) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HIPPerfGraph::open(unsigned int test, char* units, double& conversion,
+                        unsigned int deviceId) {
+  HIPPerfTestImp::open(test, units, conversion, deviceId);
+  CHECK_RESULT(_errorFlag, "Error opening test");
+  CHECK_RESULT(!loadKernel(ScalarKernel, "scalar", &kernel_),
+               "Kernel compilation failed");
+
+  shape_ = Chain;
+  numNodes_ = DefaultNodes;
+  if (test < NumInstantiate) {
+    numNodes_ = InstantiateNodes[test];
+  } else if (test == (NumInstantiate + Launch)) {
+    numNodes_ = LaunchNodes;
+  } else if (test == (NumInstantiate + ReplayForkJoin)) {
+    shape_ = ForkJoin;
+  } else if (test == (NumInstantiate + ReplayWide)) {
+    shape_ = Wide;
+  }
+  CHECK_RESULT(!buildGraph(shape_, numNodes_, &graph_, &nodes_),
+               "Graph creation failed");
+  // The instantiation sweep measures the instantiation itself
+  if (test >= NumInstantiate) {
+    hipError_t error =
+        hipGraphInstantiate(&graphExec_, graph_, nullptr, nullptr, 0);
+    CHECK_HIP(error, "hipGraphInstantiate() failed");
+  }
+}
+
+void HIPPerfGraph::runInstantiate() {
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  hipError_t error =
+      hipGraphInstantiate(&graphExec_, graph_, nullptr, nullptr, 0);
+  timer.Stop();
+  CHECK_HIP(error, "hipGraphInstantiate() failed");
+
+  std::stringstream stream;
+  stream << "hipGraphInstantiate of " << numNodes_ << " nodes (ms)";
+  testDescString = stream.str();
+  _perfInfo = static_cast<float>(timer.GetElapsedTime() * 1000);
+}
+
+void HIPPerfGraph::runLaunch() {
+  // Only the submission is timed, the GPU execution overlaps the next launch
+  CPerfCounter timer;
+  timer.Reset();
+  hipError_t error = hipSuccess;
+  for (unsigned int i = 0; i < Iterations; ++i) {
+    timer.Start();
+    error = hipGraphLaunch(graphExec_, stream_);
+    timer.Stop();
+    CHECK_HIP(error, "hipGraphLaunch() failed");
+  }
+  error = hipStreamSynchronize(stream_);
+  CHECK_HIP(error, "hipStreamSynchronize() failed");
+
+  const char* capture = getenv("DEBUG_CLR_GRAPH_PACKET_CAPTURE");
+  const bool disabled = (capture != nullptr) && (capture[0] == '0');
+  std::stringstream stream;
+  stream << "hipGraphLaunch CPU time, " << numNodes_
+         << " nodes, packet capture " << (disabled ? "off" : "on") << " (us)";
+  testDescString = stream.str();
+  _perfInfo = static_cast<float>(timer.GetElapsedTime() * 1000000 / Iterations);
+}
+
+void HIPPerfGraph::runUpdate() {
+  // The update graph has the same topology and new arguments
+  hipGraph_t update = nullptr;
+  std::vector<hipGraphNode_t> nodes;
+  value_ = 1;
+  CHECK_RESULT(!buildGraph(shape_, numNodes_, &update, &nodes),
+               "Graph creation failed");
+
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  hipError_t error = hipSuccess;
+  for (unsigned int i = 0; (i < Iterations) && (error == hipSuccess); ++i) {
+    hipGraphNode_t errorNode;
+    hipGraphExecUpdateResult result;
+    error = hipGraphExecUpdate(graphExec_, (i & 1) ? graph_ : update,
+                               &errorNode, &result);
+  }
+  timer.Stop();
+  hipGraphDestroy(update);
+  CHECK_HIP(error, "hipGraphExecUpdate() failed");
+
+  std::stringstream stream;
+  stream << "hipGraphExecUpdate of " << numNodes_ << " nodes (us)";
+  testDescString = stream.str();
+  _perfInfo = static_cast<float>(timer.GetElapsedTime() * 1000000 / Iterations);
+}
+
+void HIPPerfGraph::runSetParams() {
+  int value = 0;
+  void* args[] = {&value};
+  const hipKernelNodeParams params = nodeParams(args);
+
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  for (unsigned int i = 0; i < Iterations; ++i) {
+    value = i;
+    for (auto node : nodes_) {
+      hipError_t error = hipGraphExecKernelNodeSetParams(graphExec_, node,
+                                                         &params);
+      CHECK_HIP(error, "hipGraphExecKernelNodeSetParams() failed");
+    }
+  }
+  timer.Stop();
+
+  testDescString = "hipGraphExecKernelNodeSetParams per node (us)";
+  _perfInfo = static_cast<float>(timer.GetElapsedTime() * 1000000 /
+                                 (Iterations * nodes_.size()));
+}
+
+void HIPPerfGraph::runReplay() {
+  // Warm up the graph execution
+  hipError_t error = hipGraphLaunch(graphExec_, stream_);
+  CHECK_HIP(error, "hipGraphLaunch() failed");
+  error = hipStreamSynchronize(stream_);
+  CHECK_HIP(error, "hipStreamSynchronize() failed");
+
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  for (unsigned int i = 0; i < Iterations; ++i) {
+    error = hipGraphLaunch(graphExec_, stream_);
+    CHECK_HIP(error, "hipGraphLaunch() failed");
+  }
+  error = hipStreamSynchronize(stream_);
+  CHECK_HIP(error, "hipStreamSynchronize() failed");
+  timer.Stop();
+
+  std::stringstream stream;
+  stream << "Replay of a " << ShapeNames[shape_] << " graph, " << numNodes_
+         << " nodes (nodes/s)";
+  testDescString = stream.str();
+  _perfInfo = static_cast<float>(static_cast<double>(numNodes_) * Iterations /
+                                 timer.GetElapsedTime());
+}
+
+void HIPPerfGraph::run(void) {
+  if (_errorFlag) {
+    return;
+  }
+  if (test_ < NumInstantiate) {
+    runInstantiate();
+    return;
+  }
+  switch (test_ - NumInstantiate) {
+    case Launch:
+      runLaunch();
+      break;
+    case Update:
+      runUpdate();
+      break;
+    case SetParams:
+      runSetParams();
+      break;
+    default:
+      runReplay();
+      break;
+  }
+}
+
+unsigned int HIPPerfGraph::close(void) {
+  if (graphExec_ != nullptr) {
+    hipGraphExecDestroy(graphExec_);
+    graphExec_ = nullptr;
+  }
+  if (graph_ != nullptr) {
+    hipGraphDestroy(graph_);
+    graph_ = nullptr;
+  }
+  nodes_.clear();
+  return HIPPerfTestImp::close();
+}
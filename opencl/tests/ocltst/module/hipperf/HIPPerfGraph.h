@@ -0,0 +1,67 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#ifndef _HIPPerfGraph_H_
+#define _HIPPerfGraph_H_
+
+#include <vector>
+
+#include "HIPPerfTestImp.h"
+
+//! Benchmarks the HIP graph instantiation, launch, update and replay paths.
+//! The graphs are built from the kernel nodes of a hiprtc compiled kernel.
+//! The packet capture is controlled by DEBUG_CLR_GRAPH_PACKET_CAPTURE, so the
+//! launch overhead with and without it needs two runs of the test
+class HIPPerfGraph : public HIPPerfTestImp {
+ public:
+  enum Shape { Chain, ForkJoin, Wide };
+
+  HIPPerfGraph();
+  virtual ~HIPPerfGraph();
+
+ public:
+  virtual void open(unsigned int test, char* units, double& conversion,
+                    unsigned int deviceId);
+  virtual void run(void);
+  virtual unsigned int close(void);
+
+ private:
+  //! Builds a graph of the shape with the number of kernel nodes
+  bool buildGraph(Shape shape, unsigned int numNodes, hipGraph_t* graph,
+                  std::vector<hipGraphNode_t>* nodes);
+  hipKernelNodeParams nodeParams(void** args) const;
+
+  void runInstantiate();
+  void runLaunch();
+  void runUpdate();
+  void runSetParams();
+  void runReplay();
+
+  hipFunction_t kernel_;
+  Shape shape_;
+  unsigned int numNodes_;
+  int value_;
+  void* args_[1];
+  hipGraph_t graph_;
+  hipGraphExec_t graphExec_;
+  std::vector<hipGraphNode_t> nodes_;
+};
+
+#endif  // _HIPPerfGraph_H_
@@ -0,0 +1,95 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "HIPPerfGraphLaunch.h"
+
+#include <Timer.h>
+
+#include <sstream>
+
+static const unsigned int Iterations = 1000;
+static const unsigned int Nodes[] = {1, 16, 256};
+
+HIPPerfGraphLaunch::HIPPerfGraphLaunch()
+    : nodes_(0), graph_(nullptr), graphExec_(nullptr) {
+  _numSubTests = sizeof(Nodes) / sizeof(Nodes[0]);
+}
+
+HIPPerfGraphLaunch::~HIPPerfGraphLaunch() {}
+
+void HIPPerfGraphLaunch::open(unsigned int test, char* units,
+                              double& conversion, unsigned int deviceId) {
+  HIPPerfTestImp::open(test, units, conversion, deviceId);
+  CHECK_RESULT(_errorFlag, "Error opening test");
+  CHECK_RESULT(!loadEmptyKernel(), "Empty kernel compilation failed");
+  nodes_ = Nodes[test];
+
+  // Capture a chain of the empty kernels
+  hipError_t error =
+      hipStreamBeginCapture(stream_, hipStreamCaptureModeGlobal);
+  CHECK_HIP(error, "hipStreamBeginCapture() failed");
+  for (unsigned int i = 0; i < nodes_; ++i) {
+    error = launchEmptyKernel(stream_);
+    CHECK_HIP(error, "Empty kernel capture failed");
+  }
+  error = hipStreamEndCapture(stream_, &graph_);
+  CHECK_HIP(error, "hipStreamEndCapture() failed");
+  error = hipGraphInstantiate(&graphExec_, graph_, nullptr, nullptr, 0);
+  CHECK_HIP(error, "hipGraphInstantiate() failed");
+}
+
+void HIPPerfGraphLaunch::run(void) {
+  if (_errorFlag) {
+    return;
+  }
+  // Warm up the graph execution
+  hipError_t error = hipGraphLaunch(graphExec_, stream_);
+  CHECK_HIP(error, "hipGraphLaunch() failed");
+  error = hipStreamSynchronize(stream_);
+  CHECK_HIP(error, "hipStreamSynchronize() failed");
+
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  for (unsigned int i = 0; i < Iterations; ++i) {
+    error = hipGraphLaunch(graphExec_, stream_);
+    CHECK_HIP(error, "hipGraphLaunch() failed");
+  }
+  error = hipStreamSynchronize(stream_);
+  CHECK_HIP(error, "hipStreamSynchronize() failed");
+  timer.Stop();
+
+  std::stringstream stream;
+  stream << "hipGraphLaunch of " << nodes_ << " kernel nodes (us)";
+  testDescString = stream.str();
+  _perfInfo = static_cast<float>(timer.GetElapsedTime() * 1000000 / Iterations);
+}
+
+unsigned int HIPPerfGraphLaunch::close(void) {
+  if (graphExec_ != nullptr) {
+    hipGraphExecDestroy(graphExec_);
+    graphExec_ = nullptr;
+  }
+  if (graph_ != nullptr) {
+    hipGraphDestroy(graph_);
+    graph_ = nullptr;
+  }
+  return HIPPerfTestImp::close();
+}
@@ -0,0 +1,249 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "HIPPerfHostcall.h"
+
+#include <Timer.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static const char* HostcallKernels =
+    "typedef long long2_t __attribute__((ext_vector_type(2)));\n"
+    "extern \"C\" __device__ long2_t __ockl_call_host_function(\n"
+    "    unsigned long fptr, unsigned long arg0, unsigned long arg1,\n"
+    "    unsigned long arg2, unsigned long arg3, unsigned long arg4,\n"
+    "    unsigned long arg5, unsigned long arg6);\n"
+    "extern \"C\" __global__ void print(unsigned long fptr, int iter,\n"
+    "                                   int* fail) {\n"
+    "  for (int i = 0; i < iter; ++i) {\n"
+    "    printf(\"%d %d %d\\n\", blockIdx.x, threadIdx.x, i);\n"
+    "  }\n"
+    "}\n"
+    "extern \"C\" __global__ void devmem(unsigned long fptr, int iter,\n"
+    "                                    int* fail) {\n"
+    "  for (int i = 0; i < iter; ++i) {\n"
+    "    void* ptr = malloc(64);\n"
+    "    if (ptr == nullptr) { atomicAdd(fail, 1); }\n"
+    "    free(ptr);\n"
+    "  }\n"
+    "}\n"
+    "extern \"C\" __global__ void call(unsigned long fptr, int iter,\n"
+    "                                  int* fail) {\n"
+    "  for (int i = 0; i < iter; ++i) {\n"
+    "    long2_t result = __ockl_call_host_function(fptr, i, 0, 0, 0, 0,\n"
+    "                                               0, 0);\n"
+    "    if (result.x != i + 1) { atomicAdd(fail, 1); }\n"
+    "  }\n"
+    "}\n";
+
+static const char* KernelNames[] = {"print", "devmem", "call"};
+static const char* ServiceNames[] = {"printf", "malloc+free",
+                                     "host function call"};
+
+//! One wave, a wave on every CU, eight 256-wide blocks on every CU
+static const unsigned int NumGrids = 3;
+//! The iterations per thread, printf and malloc cost more than a call
+static const unsigned int Iterations[][NumGrids] = {
+    {100, 20, 2}, {100, 10, 2}, {1000, 50, 5}};
+
+//! Maps the device slot to a device, the test device takes the first slot
+static int slotDevice(unsigned int slot, unsigned int testDevice) {
+  return (slot == 0) ? testDevice : ((slot == testDevice) ? 0 : slot);
+}
+
+//! The host side of the function call service
+static void hostIncrement(uint64_t* output, const uint64_t* input) {
+  output[0] = input[0] + 1;
+  output[1] = 0;
+}
+
+HIPPerfHostcall::HIPPerfHostcall()
+    : service_(Printf), grid_(0), iterations_(0), numDevices_(0) {
+  _numSubTests = 2 * TotalServices * NumGrids;
+}
+
+HIPPerfHostcall::~HIPPerfHostcall() {}
+
+void HIPPerfHostcall::open(unsigned int test, char* units, double& conversion,
+                           unsigned int deviceId) {
+  HIPPerfTestImp::open(test, units, conversion, deviceId);
+  CHECK_RESULT(_errorFlag, "Error opening test");
+  grid_ = test % NumGrids;
+  service_ = static_cast<Service>((test / NumGrids) % TotalServices);
+  iterations_ = Iterations[service_][grid_];
+  numDevices_ = 1;
+  if (test >= TotalServices * NumGrids) {
+    hipError_t error = hipGetDeviceCount(&numDevices_);
+    CHECK_HIP(error, "hipGetDeviceCount() failed");
+  }
+
+  std::vector<char> code;
+  CHECK_RESULT(!compileKernel(HostcallKernels, &code),
+               "Hostcall kernel compilation failed");
+  modules_.resize(numDevices_, nullptr);
+  functions_.resize(numDevices_, nullptr);
+  streams_.resize(numDevices_, nullptr);
+  failures_.resize(numDevices_, nullptr);
+  blocks_.resize(numDevices_, 1);
+  threads_.resize(numDevices_, 1);
+  for (int d = 0; d < numDevices_; ++d) {
+    const int device = slotDevice(d, deviceId);
+    hipDeviceProp_t props;
+    hipError_t error = hipGetDeviceProperties(&props, device);
+    CHECK_HIP(error, "hipGetDeviceProperties() failed");
+    if (grid_ == 0) {
+      threads_[d] = props.warpSize;
+    } else if (grid_ == 1) {
+      blocks_[d] = props.multiProcessorCount;
+      threads_[d] = props.warpSize;
+    } else {
+      blocks_[d] = 8 * props.multiProcessorCount;
+      threads_[d] = 256;
+    }
+    error = hipSetDevice(device);
+    CHECK_HIP(error, "hipSetDevice() failed");
+    error = hipModuleLoadData(&modules_[d], code.data());
+    CHECK_HIP(error, "hipModuleLoadData() failed");
+    error = hipModuleGetFunction(&functions_[d], modules_[d],
+                                 KernelNames[service_]);
+    CHECK_HIP(error, "hipModuleGetFunction() failed");
+    error = hipStreamCreateWithFlags(&streams_[d], hipStreamNonBlocking);
+    CHECK_HIP(error, "hipStreamCreateWithFlags() failed");
+    error = hipMalloc(reinterpret_cast<void**>(&failures_[d]), sizeof(int));
+    CHECK_HIP(error, "hipMalloc() failed");
+    error = hipMemset(failures_[d], 0, sizeof(int));
+    CHECK_HIP(error, "hipMemset() failed");
+  }
+  // The first launch of a hostcall kernel starts the listener
+  const unsigned int iterations = iterations_;
+  iterations_ = 0;
+  hipError_t error = launch();
+  iterations_ = iterations;
+  CHECK_HIP(error, "Hostcall warm up failed");
+}
+
+hipError_t HIPPerfHostcall::launch() {
+  for (int d = 0; d < numDevices_; ++d) {
+    unsigned long fptr = reinterpret_cast<unsigned long>(&hostIncrement);
+    int iterations = static_cast<int>(iterations_);
+    void* args[] = {&fptr, &iterations, &failures_[d]};
+    hipError_t error = hipModuleLaunchKernel(
+        functions_[d], blocks_[d], 1, 1, threads_[d], 1, 1, 0, streams_[d],
+        args, nullptr);
+    if (error != hipSuccess) {
+      return error;
+    }
+  }
+  for (int d = 0; d < numDevices_; ++d) {
+    hipError_t error = hipStreamSynchronize(streams_[d]);
+    if (error != hipSuccess) {
+      return error;
+    }
+  }
+  return hipSuccess;
+}
+
+void HIPPerfHostcall::run(void) {
+  if (_errorFlag) {
+    return;
+  }
+#if defined(__linux__)
+  // The printf output of the whole grid goes to /dev/null
+  int savedStdout = -1;
+  if (service_ == Printf) {
+    fflush(stdout);
+    savedStdout = dup(STDOUT_FILENO);
+    int null = ::open("/dev/null", O_WRONLY);
+    if (null >= 0) {
+      dup2(null, STDOUT_FILENO);
+      ::close(null);
+    }
+  }
+#endif
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  hipError_t error = launch();
+  timer.Stop();
+#if defined(__linux__)
+  if (savedStdout >= 0) {
+    fflush(stdout);
+    dup2(savedStdout, STDOUT_FILENO);
+    ::close(savedStdout);
+  }
+#endif
+  CHECK_HIP(error, "Hostcall kernel failed");
+
+  uint64_t lanes = 0;
+  for (int d = 0; d < numDevices_; ++d) {
+    int failures = 0;
+    error = hipMemcpyAsync(&failures, failures_[d], sizeof(int),
+                           hipMemcpyDefault, streams_[d]);
+    if (error == hipSuccess) {
+      error = hipStreamSynchronize(streams_[d]);
+    }
+    CHECK_HIP(error, "Reading the failure count failed");
+    CHECK_RESULT((failures != 0), "%d %s requests failed", failures,
+                 ServiceNames[service_]);
+    lanes += static_cast<uint64_t>(blocks_[d]) * threads_[d];
+  }
+
+  const double sec = timer.GetElapsedTime();
+  std::stringstream stream;
+  stream << ServiceNames[service_] << ", " << lanes << " lanes on "
+         << numDevices_ << " device(s)";
+  if (grid_ == 0) {
+    // A single wave measures the latency of a request
+    stream << ", per request (us)";
+    _perfInfo = static_cast<float>(sec * 1000000 / iterations_);
+  } else {
+    stream << " (Mrequests/s)";
+    _perfInfo = static_cast<float>(lanes * iterations_ / sec / 1000000);
+  }
+  testDescString = stream.str();
+}
+
+unsigned int HIPPerfHostcall::close(void) {
+  for (int d = 0; d < numDevices_; ++d) {
+    hipSetDevice(slotDevice(d, _deviceId));
+    if (failures_[d] != nullptr) {
+      hipFree(failures_[d]);
+    }
+    if (streams_[d] != nullptr) {
+      hipStreamDestroy(streams_[d]);
+    }
+    if (modules_[d] != nullptr) {
+      hipModuleUnload(modules_[d]);
+    }
+  }
+  failures_.clear();
+  streams_.clear();
+  modules_.clear();
+  functions_.clear();
+  hipSetDevice(_deviceId);
+  return HIPPerfTestImp::close();
+}
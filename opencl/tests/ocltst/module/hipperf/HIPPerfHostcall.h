@@ -0,0 +1,61 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#ifndef _HIPPerfHostcall_H_
+#define _HIPPerfHostcall_H_
+
+#include <vector>
+
+#include "HIPPerfTestImp.h"
+
+//! Measures the services behind the hostcall buffer: the device printf
+//! throughput, the device malloc/free rate and the round trip of a host
+//! function call. The grids grow from a single wave to the full GPU and run
+//! on the test device or on all devices at once
+class HIPPerfHostcall : public HIPPerfTestImp {
+ public:
+  enum Service { Printf, DeviceMalloc, FunctionCall, TotalServices };
+
+  HIPPerfHostcall();
+  virtual ~HIPPerfHostcall();
+
+ public:
+  virtual void open(unsigned int test, char* units, double& conversion,
+                    unsigned int deviceId);
+  virtual void run(void);
+  virtual unsigned int close(void);
+
+ private:
+  //! Launches the service kernel on all devices of the subtest
+  hipError_t launch();
+
+  Service service_;
+  unsigned int grid_;
+  unsigned int iterations_;
+  int numDevices_;
+  std::vector<unsigned int> blocks_;
+  std::vector<unsigned int> threads_;
+  std::vector<hipModule_t> modules_;
+  std::vector<hipFunction_t> functions_;
+  std::vector<hipStream_t> streams_;
+  std::vector<int*> failures_;
+};
+
+#endif  // _HIPPerfHostcall_H_
@@ -0,0 +1,77 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "HIPPerfLaunchLatency.h"
+
+#include <Timer.h>
+
+#include <sstream>
+
+static const unsigned int Iterations = 10000;
+
+HIPPerfLaunchLatency::HIPPerfLaunchLatency() {
+  // Asynchronous launches and launches with a wait for every kernel
+  _numSubTests = 2;
+}
+
+HIPPerfLaunchLatency::~HIPPerfLaunchLatency() {}
+
+void HIPPerfLaunchLatency::open(unsigned int test, char* units,
+                                double& conversion, unsigned int deviceId) {
+  HIPPerfTestImp::open(test, units, conversion, deviceId);
+  CHECK_RESULT(_errorFlag, "Error opening test");
+  CHECK_RESULT(!loadEmptyKernel(), "Empty kernel compilation failed");
+}
+
+void HIPPerfLaunchLatency::run(void) {
+  if (_errorFlag) {
+    return;
+  }
+  const bool sync = (test_ == 1);
+
+  // Warm up the dispatch path
+  hipError_t error = launchEmptyKernel(stream_);
+  CHECK_HIP(error, "hipModuleLaunchKernel() failed");
+  error = hipStreamSynchronize(stream_);
+  CHECK_HIP(error, "hipStreamSynchronize() failed");
+
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  for (unsigned int i = 0; i < Iterations; ++i) {
+    error = launchEmptyKernel(stream_);
+    if (sync && (error == hipSuccess)) {
+      error = hipStreamSynchronize(stream_);
+    }
+    CHECK_HIP(error, "Empty kernel launch failed");
+  }
+  error = hipStreamSynchronize(stream_);
+  CHECK_HIP(error, "hipStreamSynchronize() failed");
+  timer.Stop();
+
+  std::stringstream stream;
+  stream << "Empty kernel launch, " << (sync ? "sync" : "async") << " (us)";
+  testDescString = stream.str();
+  _perfInfo = static_cast<float>(timer.GetElapsedTime() * 1000000 / Iterations);
+}
+
+unsigned int HIPPerfLaunchLatency::close(void) {
+  return HIPPerfTestImp::close();
+}
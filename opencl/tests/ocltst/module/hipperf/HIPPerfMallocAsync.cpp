@@ -0,0 +1,88 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "HIPPerfMallocAsync.h"
+
+#include <Timer.h>
+
+#include <sstream>
+
+static const unsigned int Iterations = 1000;
+static const size_t Sizes[] = {4 * 1024, 1024 * 1024, 64 * 1024 * 1024};
+static const unsigned int NumAllocs = 16;
+
+HIPPerfMallocAsync::HIPPerfMallocAsync() : size_(0) {
+  _numSubTests = sizeof(Sizes) / sizeof(Sizes[0]);
+}
+
+HIPPerfMallocAsync::~HIPPerfMallocAsync() {}
+
+void HIPPerfMallocAsync::open(unsigned int test, char* units,
+                              double& conversion, unsigned int deviceId) {
+  HIPPerfTestImp::open(test, units, conversion, deviceId);
+  CHECK_RESULT(_errorFlag, "Error opening test");
+  size_ = Sizes[test];
+
+  int supported = 0;
+  hipError_t error = hipDeviceGetAttribute(
+      &supported, hipDeviceAttributeMemoryPoolsSupported, deviceId);
+  CHECK_HIP(error, "hipDeviceGetAttribute() failed");
+  if (supported == 0) {
+    printf("Memory pools aren't supported, skipping the test\n");
+    failed_ = true;
+  }
+}
+
+void HIPPerfMallocAsync::run(void) {
+  if (_errorFlag || failed_) {
+    return;
+  }
+  void* ptrs[NumAllocs];
+  hipError_t error = hipSuccess;
+
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  // Every iteration allocates a small working set and frees it back into the
+  // pool, so the pool reuse path dominates after the first iteration
+  for (unsigned int i = 0; i < Iterations; ++i) {
+    for (unsigned int a = 0; a < NumAllocs; ++a) {
+      error = hipMallocAsync(&ptrs[a], size_, stream_);
+      CHECK_HIP(error, "hipMallocAsync() failed");
+    }
+    for (unsigned int a = 0; a < NumAllocs; ++a) {
+      error = hipFreeAsync(ptrs[a], stream_);
+      CHECK_HIP(error, "hipFreeAsync() failed");
+    }
+  }
+  error = hipStreamSynchronize(stream_);
+  CHECK_HIP(error, "hipStreamSynchronize() failed");
+  timer.Stop();
+
+  std::stringstream stream;
+  stream << "hipMallocAsync+hipFreeAsync of " << size_ / 1024 << " KB (us)";
+  testDescString = stream.str();
+  _perfInfo = static_cast<float>(timer.GetElapsedTime() * 1000000 /
+                                 (Iterations * NumAllocs));
+}
+
+unsigned int HIPPerfMallocAsync::close(void) {
+  return HIPPerfTestImp::close();
+}
@@ -0,0 +1,173 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "HIPPerfPeerCopy.h"
+
+#include <Timer.h>
+
+#include <sstream>
+
+static const size_t Sizes[] = {4 * 1024, 256 * 1024, 1024 * 1024,
+                               16 * 1024 * 1024, 64 * 1024 * 1024};
+static const unsigned int NumSizes = sizeof(Sizes) / sizeof(Sizes[0]);
+static const size_t BytesPerPair = 512 * 1024 * 1024;
+static const unsigned int MaxIterations = 1000;
+
+HIPPerfPeerCopy::HIPPerfPeerCopy()
+    : size_(0), peerAccess_(false), numDevices_(0) {
+  // Every size with the peer access enabled, then with the staged fallback
+  _numSubTests = 2 * NumSizes;
+}
+
+HIPPerfPeerCopy::~HIPPerfPeerCopy() {}
+
+void HIPPerfPeerCopy::open(unsigned int test, char* units, double& conversion,
+                           unsigned int deviceId) {
+  HIPPerfTestImp::open(test, units, conversion, deviceId);
+  CHECK_RESULT(_errorFlag, "Error opening test");
+  size_ = Sizes[test % NumSizes];
+  peerAccess_ = (test < NumSizes);
+
+  hipError_t error = hipGetDeviceCount(&numDevices_);
+  CHECK_HIP(error, "hipGetDeviceCount() failed");
+  if (numDevices_ < 2) {
+    printf("At least 2 devices are required, skipping the test\n");
+    failed_ = true;
+    return;
+  }
+  buffers_.resize(numDevices_, nullptr);
+  streams_.resize(numDevices_, nullptr);
+  for (int d = 0; d < numDevices_; ++d) {
+    error = hipSetDevice(d);
+    CHECK_HIP(error, "hipSetDevice() failed");
+    error = hipMalloc(&buffers_[d], size_);
+    CHECK_HIP(error, "hipMalloc() failed");
+    error = hipStreamCreateWithFlags(&streams_[d], hipStreamNonBlocking);
+    CHECK_HIP(error, "hipStreamCreateWithFlags() failed");
+    for (int peer = 0; peer < numDevices_; ++peer) {
+      int canAccess = 0;
+      if ((peer == d) || (hipDeviceCanAccessPeer(&canAccess, d, peer) !=
+                          hipSuccess) || (canAccess == 0)) {
+        continue;
+      }
+      error = peerAccess_ ? hipDeviceEnablePeerAccess(peer, 0)
+                          : hipDeviceDisablePeerAccess(peer);
+      // The access can be in the requested state already
+      if ((error != hipErrorPeerAccessAlreadyEnabled) &&
+          (error != hipErrorPeerAccessNotEnabled)) {
+        CHECK_HIP(error, "Peer access setup failed");
+      }
+    }
+  }
+  hipGetLastError();
+}
+
+double HIPPerfPeerCopy::measure(int dst, int src) {
+  // The copy is submitted on the source device stream
+  hipStream_t stream = streams_[src];
+  if ((hipSetDevice(src) != hipSuccess) ||
+      (hipMemcpyPeerAsync(buffers_[dst], dst, buffers_[src], src, size_,
+                          stream) != hipSuccess) ||
+      (hipStreamSynchronize(stream) != hipSuccess)) {
+    return -1.0;
+  }
+  size_t iterations = BytesPerPair / size_;
+  iterations = (iterations == 0) ? 1 : iterations;
+  iterations = (iterations > MaxIterations) ? MaxIterations : iterations;
+
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  for (size_t i = 0; i < iterations; ++i) {
+    if (hipMemcpyPeerAsync(buffers_[dst], dst, buffers_[src], src, size_,
+                           stream) != hipSuccess) {
+      return -1.0;
+    }
+  }
+  if (hipStreamSynchronize(stream) != hipSuccess) {
+    return -1.0;
+  }
+  timer.Stop();
+  return timer.GetElapsedTime() / iterations;
+}
+
+void HIPPerfPeerCopy::run(void) {
+  if (_errorFlag || failed_) {
+    return;
+  }
+  std::vector<double> times(numDevices_ * numDevices_, 0.0);
+  double totalBandwidth = 0.0;
+  for (int src = 0; src < numDevices_; ++src) {
+    for (int dst = 0; dst < numDevices_; ++dst) {
+      if (src == dst) {
+        continue;
+      }
+      const double time = measure(dst, src);
+      CHECK_RESULT((time < 0.0), "Peer copy from %d to %d failed", src, dst);
+      times[src * numDevices_ + dst] = time;
+      totalBandwidth += static_cast<double>(size_) / time / 1e9;
+    }
+  }
+
+  // Print the full mesh, rows are the source devices
+  printf("\n%s, %zu KB, GB/s | us per copy\n",
+         peerAccess_ ? "Peer access" : "Staged", size_ / 1024);
+  printf("src\\dst");
+  for (int dst = 0; dst < numDevices_; ++dst) {
+    printf("  %17d", dst);
+  }
+  printf("\n");
+  for (int src = 0; src < numDevices_; ++src) {
+    printf("%7d", src);
+    for (int dst = 0; dst < numDevices_; ++dst) {
+      const double time = times[src * numDevices_ + dst];
+      if (time == 0.0) {
+        printf("  %17s", "-");
+      } else {
+        printf("  %7.2f | %7.2f", static_cast<double>(size_) / time / 1e9,
+               time * 1e6);
+      }
+    }
+    printf("\n");
+  }
+
+  std::stringstream stream;
+  stream << "hipMemcpyPeerAsync, " << (peerAccess_ ? "peer" : "staged")
+         << ", " << size_ / 1024 << " KB, average (GB/s)";
+  testDescString = stream.str();
+  _perfInfo = static_cast<float>(totalBandwidth /
+                                 (numDevices_ * (numDevices_ - 1)));
+}
+
+unsigned int HIPPerfPeerCopy::close(void) {
+  for (int d = 0; d < static_cast<int>(buffers_.size()); ++d) {
+    hipSetDevice(d);
+    if (buffers_[d] != nullptr) {
+      hipFree(buffers_[d]);
+    }
+    if (streams_[d] != nullptr) {
+      hipStreamDestroy(streams_[d]);
+    }
+  }
+  buffers_.clear();
+  streams_.clear();
+  hipSetDevice(_deviceId);
+  return HIPPerfTestImp::close();
+}
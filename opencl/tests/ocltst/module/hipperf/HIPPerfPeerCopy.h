@@ -0,0 +1,53 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#ifndef _HIPPerfPeerCopy_H_
+#define _HIPPerfPeerCopy_H_
+
+#include <vector>
+
+#include "HIPPerfTestImp.h"
+
+//! Measures hipMemcpyPeerAsync for every device pair. The sizes straddle
+//! ROC_P2P_SDMA_SIZE, so the blit kernel and the SDMA paths are both covered,
+//! and the runs without peer access take the host-staged fallback
+class HIPPerfPeerCopy : public HIPPerfTestImp {
+ public:
+  HIPPerfPeerCopy();
+  virtual ~HIPPerfPeerCopy();
+
+ public:
+  virtual void open(unsigned int test, char* units, double& conversion,
+                    unsigned int deviceId);
+  virtual void run(void);
+  virtual unsigned int close(void);
+
+ private:
+  //! Returns the time of a single copy in seconds, negative on an error
+  double measure(int dst, int src);
+
+  size_t size_;
+  bool peerAccess_;
+  int numDevices_;
+  std::vector<void*> buffers_;
+  std::vector<hipStream_t> streams_;
+};
+
+#endif  // _HIPPerfPeerCopy_H_
@@ -0,0 +1,310 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "HIPPerfStartup.h"
+
+#include <Timer.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+static const unsigned int NumKernels[] = {10, 1000, 10000};
+static const unsigned int NumTargets[] = {1, 4};
+static const unsigned int NumLoads =
+    (sizeof(NumKernels) / sizeof(NumKernels[0])) *
+    (sizeof(NumTargets) / sizeof(NumTargets[0]));
+
+// The subtests after the fat binary loads
+static const unsigned int FileLoadTest = 3 + NumLoads;
+static const unsigned int ElfLoadTest = FileLoadTest + 1;
+static const unsigned int CompileTest = ElfLoadTest + 1;
+
+// Kernels of the file and the plain code object loads
+static const unsigned int LoadKernels = 1000;
+static const unsigned int CompileKernels = 10;
+
+// Targets of the extra bundle entries, which the runtime must skip
+static const char* ExtraTargets[] = {"gfx900", "gfx906",  "gfx908",
+                                     "gfx90a", "gfx942",  "gfx1030",
+                                     "gfx1100"};
+static const char* BundleMagic = "__CLANG_OFFLOAD_BUNDLE__";
+static const size_t BundleAlignment = 4096;
+
+// The code objects are reused by the subtests, 10000 kernels take a while
+static std::map<unsigned int, std::vector<char>> CodeCache;
+
+static std::string kernelSource(unsigned int numKernels) {
+  std::stringstream source;
+  for (unsigned int i = 0; i < numKernels; ++i) {
+    source << "extern \"C\" __global__ void k" << i
+           << "(int* p) { if (p != nullptr) { *p = " << i << "; } }\n";
+  }
+  return source.str();
+}
+
+HIPPerfStartup::HIPPerfStartup()
+    : cold_(false), numKernels_(0), numTargets_(0),
+      fileName_("hipperf_startup.co") {
+  _numSubTests = CompileTest + 1;
+}
+
+HIPPerfStartup::~HIPPerfStartup() {}
+
+bool HIPPerfStartup::kernelCode(unsigned int numKernels,
+                                std::vector<char>** code) {
+  auto it = CodeCache.find(numKernels);
+  if (it == CodeCache.end()) {
+    std::vector<char> binary;
+    if (!compileKernel(kernelSource(numKernels).c_str(), &binary)) {
+      return false;
+    }
+    it = CodeCache.emplace(numKernels, std::move(binary)).first;
+  }
+  *code = &it->second;
+  return true;
+}
+
+void HIPPerfStartup::bundle(const std::vector<char>& code,
+                            unsigned int numTargets,
+                            std::vector<char>* image) const {
+  // The host entry and the extra targets precede the device code object, so
+  // the runtime parses all of them
+  std::vector<std::string> ids;
+  ids.push_back("host-x86_64-unknown-linux--");
+  const std::string processor = arch_.substr(0, arch_.find(':'));
+  for (const char* target : ExtraTargets) {
+    if ((ids.size() < numTargets) && (processor != target)) {
+      ids.push_back(std::string("hipv4-amdgcn-amd-amdhsa--") + target);
+    }
+  }
+  ids.push_back("hipv4-amdgcn-amd-amdhsa--" + arch_);
+
+  size_t header = strlen(BundleMagic) + sizeof(uint64_t);
+  for (const auto& id : ids) {
+    header += 3 * sizeof(uint64_t) + id.size();
+  }
+  auto align = [](size_t offset) {
+    return (offset + BundleAlignment - 1) & ~(BundleAlignment - 1);
+  };
+  size_t offset = align(header);
+  image->assign(offset + (ids.size() - 1) * align(code.size()), 0);
+
+  char* data = image->data();
+  auto write = [&data](const void* value, size_t size) {
+    memcpy(data, value, size);
+    data += size;
+  };
+  const uint64_t count = ids.size();
+  write(BundleMagic, strlen(BundleMagic));
+  write(&count, sizeof(count));
+  for (size_t i = 0; i < ids.size(); ++i) {
+    // The host entry is empty, all targets carry a copy of the code object
+    const uint64_t entry[3] = {offset, (i == 0) ? 0 : code.size(),
+                               ids[i].size()};
+    write(entry, sizeof(entry));
+    write(ids[i].data(), ids[i].size());
+    if (i != 0) {
+      memcpy(image->data() + offset, code.data(), code.size());
+      offset += align(code.size());
+    }
+  }
+}
+
+void HIPPerfStartup::open(unsigned int test, char* units, double& conversion,
+                          unsigned int deviceId) {
+  if (test < 2) {
+    // hipInit and the first allocation skip the device setup of the base
+    BaseTestImp::open();
+    test_ = test;
+    _deviceId = deviceId;
+    cold_ = !Initialized;
+    if (test == 1) {
+      hipError_t error = hipInit(0);
+      CHECK_HIP(error, "hipInit() failed");
+      int count = 0;
+      error = hipGetDeviceCount(&count);
+      CHECK_HIP(error, "hipGetDeviceCount() failed");
+      CHECK_RESULT((deviceId >= static_cast<unsigned int>(count)),
+                   "Invalid device id %u", deviceId);
+    }
+    return;
+  }
+  HIPPerfTestImp::open(test, units, conversion, deviceId);
+  CHECK_RESULT(_errorFlag, "Error opening test");
+  if (test == 2) {
+    CHECK_RESULT(!loadEmptyKernel(), "Empty kernel compilation failed");
+    return;
+  }
+  if (test == CompileTest) {
+    return;
+  }
+  hipDeviceProp_t props;
+  hipError_t error = hipGetDeviceProperties(&props, deviceId);
+  CHECK_HIP(error, "hipGetDeviceProperties() failed");
+  arch_ = props.gcnArchName;
+
+  const unsigned int load = test - 3;
+  numKernels_ = (test < FileLoadTest) ? NumKernels[load / 2] : LoadKernels;
+  numTargets_ = (test < FileLoadTest) ? NumTargets[load % 2]
+                                      : NumTargets[1];
+  std::vector<char>* code = nullptr;
+  CHECK_RESULT(!kernelCode(numKernels_, &code), "Kernel compilation failed");
+  if (test == ElfLoadTest) {
+    image_ = *code;
+    return;
+  }
+  bundle(*code, numTargets_, &image_);
+  if (test == FileLoadTest) {
+    std::ofstream file(fileName_, std::ios::binary);
+    file.write(image_.data(), image_.size());
+    CHECK_RESULT(!file.good(), "Couldn't write %s", fileName_.c_str());
+  }
+}
+
+void HIPPerfStartup::runInit() {
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  hipError_t error = hipInit(0);
+  timer.Stop();
+  CHECK_HIP(error, "hipInit() failed");
+
+  testDescString = std::string("hipInit, ") + (cold_ ? "cold" : "warm") +
+                   " (ms)";
+  _perfInfo = static_cast<float>(timer.GetElapsedTime() * 1000);
+}
+
+void HIPPerfStartup::runMalloc() {
+  void* ptr = nullptr;
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  hipError_t error = hipSetDevice(_deviceId);
+  if (error == hipSuccess) {
+    error = hipMalloc(&ptr, 1024 * 1024);
+  }
+  timer.Stop();
+  CHECK_HIP(error, "The first hipMalloc() failed");
+  hipFree(ptr);
+
+  testDescString = std::string("First hipMalloc, ") +
+                   (cold_ ? "cold" : "warm") + " (ms)";
+  _perfInfo = static_cast<float>(timer.GetElapsedTime() * 1000);
+}
+
+void HIPPerfStartup::runFirstLaunch() {
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  hipError_t error = launchEmptyKernel(stream_);
+  if (error == hipSuccess) {
+    error = hipStreamSynchronize(stream_);
+  }
+  timer.Stop();
+  CHECK_HIP(error, "The first kernel launch failed");
+
+  testDescString = "First kernel launch on a new stream (ms)";
+  _perfInfo = static_cast<float>(timer.GetElapsedTime() * 1000);
+}
+
+void HIPPerfStartup::runLoad() {
+  // The load, the kernel lookup and the first launch until it completes
+  int* ptr = nullptr;
+  void* args[] = {&ptr};
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  hipError_t error = (test_ == FileLoadTest)
+                         ? hipModuleLoad(&module_, fileName_.c_str())
+                         : hipModuleLoadData(&module_, image_.data());
+  if (error == hipSuccess) {
+    error = hipModuleGetFunction(&function_, module_, "k0");
+  }
+  if (error == hipSuccess) {
+    error = hipModuleLaunchKernel(function_, 1, 1, 1, 1, 1, 1, 0, stream_,
+                                  args, nullptr);
+  }
+  if (error == hipSuccess) {
+    error = hipStreamSynchronize(stream_);
+  }
+  timer.Stop();
+  CHECK_HIP(error, "The module load and launch failed");
+
+  std::stringstream stream;
+  if (test_ == FileLoadTest) {
+    stream << "hipModuleLoad, ";
+  } else if (test_ == ElfLoadTest) {
+    stream << "hipModuleLoadData code object, ";
+  } else {
+    stream << "hipModuleLoadData fat binary, ";
+  }
+  stream << numKernels_ << " kernels";
+  if (test_ != ElfLoadTest) {
+    stream << ", " << numTargets_ << " targets";
+  }
+  stream << " (ms)";
+  testDescString = stream.str();
+  _perfInfo = static_cast<float>(timer.GetElapsedTime() * 1000);
+}
+
+void HIPPerfStartup::runCompile() {
+  const std::string source = kernelSource(CompileKernels);
+  std::vector<char> code;
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  bool result = compileKernel(source.c_str(), &code);
+  timer.Stop();
+  CHECK_RESULT(!result, "hiprtc compilation failed");
+
+  std::stringstream stream;
+  stream << "hiprtc compile, " << CompileKernels << " kernels (ms)";
+  testDescString = stream.str();
+  _perfInfo = static_cast<float>(timer.GetElapsedTime() * 1000);
+}
+
+void HIPPerfStartup::run(void) {
+  if (_errorFlag) {
+    return;
+  }
+  if (test_ == 0) {
+    runInit();
+  } else if (test_ == 1) {
+    runMalloc();
+  } else if (test_ == 2) {
+    runFirstLaunch();
+  } else if (test_ == CompileTest) {
+    runCompile();
+  } else {
+    runLoad();
+  }
+}
+
+unsigned int HIPPerfStartup::close(void) {
+  if (test_ == FileLoadTest) {
+    std::remove(fileName_.c_str());
+  }
+  image_.clear();
+  return HIPPerfTestImp::close();
+}
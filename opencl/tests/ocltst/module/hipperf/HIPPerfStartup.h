@@ -0,0 +1,65 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#ifndef _HIPPerfStartup_H_
+#define _HIPPerfStartup_H_
+
+#include <string>
+#include <vector>
+
+#include "HIPPerfTestImp.h"
+
+//! Measures the time to the first kernel: hipInit, the first allocation, the
+//! first launch and the load of fat binaries with many kernels and targets.
+//! hipInit and the first allocation are cold only if no other HIP test ran in
+//! the process before, hence the test runs first in the module
+class HIPPerfStartup : public HIPPerfTestImp {
+ public:
+  HIPPerfStartup();
+  virtual ~HIPPerfStartup();
+
+ public:
+  virtual void open(unsigned int test, char* units, double& conversion,
+                    unsigned int deviceId);
+  virtual void run(void);
+  virtual unsigned int close(void);
+
+ private:
+  //! Returns the hiprtc code object with the number of kernels
+  bool kernelCode(unsigned int numKernels, std::vector<char>** code);
+  //! Wraps the code object into an offload bundle with extra targets
+  void bundle(const std::vector<char>& code, unsigned int numTargets,
+              std::vector<char>* image) const;
+
+  void runInit();
+  void runMalloc();
+  void runFirstLaunch();
+  void runLoad();
+  void runCompile();
+
+  bool cold_;
+  unsigned int numKernels_;
+  unsigned int numTargets_;
+  std::string arch_;
+  std::vector<char> image_;
+  std::string fileName_;
+};
+
+#endif  // _HIPPerfStartup_H_
@@ -0,0 +1,79 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "HIPPerfStreamCreate.h"
+
+#include <Timer.h>
+
+#include <sstream>
+
+static const unsigned int Iterations = 1000;
+
+HIPPerfStreamCreate::HIPPerfStreamCreate() {
+  // Default streams, non-blocking streams and streams with a launch
+  _numSubTests = 3;
+}
+
+HIPPerfStreamCreate::~HIPPerfStreamCreate() {}
+
+void HIPPerfStreamCreate::open(unsigned int test, char* units,
+                               double& conversion, unsigned int deviceId) {
+  HIPPerfTestImp::open(test, units, conversion, deviceId);
+  CHECK_RESULT(_errorFlag, "Error opening test");
+  if (test == 2) {
+    CHECK_RESULT(!loadEmptyKernel(), "Empty kernel compilation failed");
+  }
+}
+
+void HIPPerfStreamCreate::run(void) {
+  if (_errorFlag) {
+    return;
+  }
+  const unsigned int flags =
+      (test_ == 1) ? hipStreamNonBlocking : hipStreamDefault;
+  hipError_t error = hipSuccess;
+
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  for (unsigned int i = 0; i < Iterations; ++i) {
+    hipStream_t stream;
+    error = hipStreamCreateWithFlags(&stream, flags);
+    CHECK_HIP(error, "hipStreamCreateWithFlags() failed");
+    // The first launch binds the stream to a HW queue
+    if (test_ == 2) {
+      error = launchEmptyKernel(stream);
+      CHECK_HIP(error, "Empty kernel launch failed");
+    }
+    error = hipStreamDestroy(stream);
+    CHECK_HIP(error, "hipStreamDestroy() failed");
+  }
+  timer.Stop();
+
+  static const char* Names[] = {"default", "non-blocking", "with a launch"};
+  std::stringstream stream;
+  stream << "hipStreamCreate+Destroy, " << Names[test_] << " (us)";
+  testDescString = stream.str();
+  _perfInfo = static_cast<float>(timer.GetElapsedTime() * 1000000 / Iterations);
+}
+
+unsigned int HIPPerfStreamCreate::close(void) {
+  return HIPPerfTestImp::close();
+}
@@ -0,0 +1,103 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "HIPPerfTestImp.h"
+
+#include <hip/hiprtc.h>
+
+#include <string>
+
+const char* HIPPerfTestImp::EmptyKernel =
+    "extern \"C\" __global__ void empty() {}";
+
+bool HIPPerfTestImp::Initialized = false;
+
+HIPPerfTestImp::HIPPerfTestImp()
+    : test_(0), stream_(nullptr), module_(nullptr), function_(nullptr) {}
+
+HIPPerfTestImp::~HIPPerfTestImp() {}
+
+void HIPPerfTestImp::open(unsigned int test, char* units, double& conversion,
+                          unsigned int deviceId, unsigned int platformIndex) {
+  open(test, units, conversion, deviceId);
+}
+
+void HIPPerfTestImp::open(unsigned int test, char* units, double& conversion,
+                          unsigned int deviceId) {
+  BaseTestImp::open();
+  test_ = test;
+  _deviceId = deviceId;
+  Initialized = true;
+
+  int count = 0;
+  hipError_t error = hipGetDeviceCount(&count);
+  CHECK_HIP(error, "hipGetDeviceCount() failed");
+  CHECK_RESULT((deviceId >= static_cast<unsigned int>(count)),
+               "Invalid device id %u", deviceId);
+  error = hipSetDevice(deviceId);
+  CHECK_HIP(error, "hipSetDevice() failed");
+  error = hipStreamCreate(&stream_);
+  CHECK_HIP(error, "hipStreamCreate() failed");
+}
+
+bool HIPPerfTestImp::compileKernel(const char* source,
+                                   std::vector<char>* code) {
+  hipDeviceProp_t props;
+  if (hipGetDeviceProperties(&props, _deviceId) != hipSuccess) {
+    return false;
+  }
+  hiprtcProgram program;
+  if (hiprtcCreateProgram(&program, source, "kernel.cpp", 0, nullptr,
+                          nullptr) != HIPRTC_SUCCESS) {
+    return false;
+  }
+  const std::string arch = std::string("--offload-arch=") + props.gcnArchName;
+  const char* options[] = {arch.c_str()};
+  size_t size = 0;
+  bool result = (hiprtcCompileProgram(program, 1, options) == HIPRTC_SUCCESS) &&
+                (hiprtcGetCodeSize(program, &size) == HIPRTC_SUCCESS);
+  code->resize(size);
+  result = result && (hiprtcGetCode(program, code->data()) == HIPRTC_SUCCESS);
+  hiprtcDestroyProgram(&program);
+  return result;
+}
+
+bool HIPPerfTestImp::loadKernel(const char* source, const char* name,
+                                hipFunction_t* function) {
+  // A test loads a single module
+  std::vector<char> code;
+  if ((module_ != nullptr) || !compileKernel(source, &code)) {
+    return false;
+  }
+  return (hipModuleLoadData(&module_, code.data()) == hipSuccess) &&
+         (hipModuleGetFunction(function, module_, name) == hipSuccess);
+}
+
+unsigned int HIPPerfTestImp::close(void) {
+  if (stream_ != nullptr) {
+    hipStreamDestroy(stream_);
+    stream_ = nullptr;
+  }
+  if (module_ != nullptr) {
+    hipModuleUnload(module_);
+    module_ = nullptr;
+  }
+  return BaseTestImp::close();
+}
@@ -0,0 +1,80 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#ifndef _HIPPerfTestImp_H_
+#define _HIPPerfTestImp_H_
+
+#include <hip/hip_runtime.h>
+
+#include <vector>
+
+#include "BaseTestImp.h"
+
+#define CHECK_HIP(error, msg)                                           \
+  if ((error) != hipSuccess) {                                          \
+    _errorFlag = true;                                                  \
+    printf("\n\n%s\nError: %s\n\n", msg, hipGetErrorString(error));     \
+    _errorMsg = msg;                                                    \
+    _crcword += 1;                                                      \
+    return;                                                             \
+  }
+
+//! The base of the HIP benchmarks. The tests run on the ocltst harness, but
+//! call only the HIP entry points, hence no OpenCL context is created
+class HIPPerfTestImp : public BaseTestImp {
+ public:
+  HIPPerfTestImp();
+  virtual ~HIPPerfTestImp();
+
+  virtual void open(unsigned int test, char* units, double& conversion,
+                    unsigned int deviceId, unsigned int platformIndex);
+  virtual void open(unsigned int test, char* units, double& conversion,
+                    unsigned int deviceId);
+  virtual unsigned int close(void);
+
+ protected:
+  //! Compiles the kernel source with hiprtc for the test device
+  bool compileKernel(const char* source, std::vector<char>* code);
+
+  //! Compiles the kernel source with hiprtc and loads it on the current device
+  bool loadKernel(const char* source, const char* name,
+                  hipFunction_t* function);
+
+  //! Compiles and loads the empty kernel, which launchEmptyKernel() uses
+  bool loadEmptyKernel() {
+    return loadKernel(EmptyKernel, "empty", &function_);
+  }
+
+  //! Launches a single workitem of the empty kernel into the stream
+  hipError_t launchEmptyKernel(hipStream_t stream) {
+    return hipModuleLaunchKernel(function_, 1, 1, 1, 1, 1, 1, 0, stream,
+                                 nullptr, nullptr);
+  }
+
+  static const char* EmptyKernel;
+  static bool Initialized;  //!< A test of the module has initialized HIP
+
+  unsigned int test_;
+  hipStream_t stream_;
+  hipModule_t module_;
+  hipFunction_t function_;
+};
+
+#endif  // _HIPPerfTestImp_H_
@@ -0,0 +1,212 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "HIPPerfThreadScaling.h"
+
+#include <Timer.h>
+
+#include <sstream>
+#include <thread>
+
+static const unsigned int Threads[] = {1, 2, 4, 8, 16, 32, 64, 128};
+static const unsigned int NumThreads = sizeof(Threads) / sizeof(Threads[0]);
+//! The operations per thread, the stream creation is much slower than others
+static const unsigned int Iterations[] = {2000, 500, 2000, 50, 10000, 10000};
+static const char* Names[] = {
+    "kernel launch",           "hipMalloc+hipFree",
+    "hipEventRecord",          "hipStreamCreate+Destroy",
+    "hipPointerGetAttributes", "hipModuleGetFunction"};
+static const size_t AllocSize = 64 * 1024;
+
+//! Maps the device slot to a device, the test device takes the first slot
+static int slotDevice(unsigned int slot, unsigned int testDevice) {
+  return (slot == 0) ? testDevice : ((slot == testDevice) ? 0 : slot);
+}
+
+HIPPerfThreadScaling::HIPPerfThreadScaling()
+    : operation_(Launch), numDevices_(0), ready_(0), start_(false) {
+  // Every operation on the test device, then spread across all devices
+  _numSubTests = 2 * TotalOperations;
+}
+
+HIPPerfThreadScaling::~HIPPerfThreadScaling() {}
+
+void HIPPerfThreadScaling::open(unsigned int test, char* units,
+                                double& conversion, unsigned int deviceId) {
+  HIPPerfTestImp::open(test, units, conversion, deviceId);
+  CHECK_RESULT(_errorFlag, "Error opening test");
+  operation_ = static_cast<Operation>(test % TotalOperations);
+  numDevices_ = 1;
+  if (test >= TotalOperations) {
+    hipError_t error = hipGetDeviceCount(&numDevices_);
+    CHECK_HIP(error, "hipGetDeviceCount() failed");
+  }
+
+  std::vector<char> code;
+  CHECK_RESULT(!compileKernel(EmptyKernel, &code),
+               "Empty kernel compilation failed");
+  modules_.resize(numDevices_, nullptr);
+  functions_.resize(numDevices_, nullptr);
+  shared_.resize(numDevices_, nullptr);
+  for (int d = 0; d < numDevices_; ++d) {
+    hipError_t error = hipSetDevice(slotDevice(d, deviceId));
+    CHECK_HIP(error, "hipSetDevice() failed");
+    error = hipModuleLoadData(&modules_[d], code.data());
+    CHECK_HIP(error, "hipModuleLoadData() failed");
+    error = hipModuleGetFunction(&functions_[d], modules_[d], "empty");
+    CHECK_HIP(error, "hipModuleGetFunction() failed");
+    // The lookups search for a pointer inside an allocation
+    error = hipMalloc(&shared_[d], AllocSize);
+    CHECK_HIP(error, "hipMalloc() failed");
+  }
+}
+
+bool HIPPerfThreadScaling::worker(unsigned int thread) {
+  const unsigned int slot = thread % numDevices_;
+  hipStream_t stream = nullptr;
+  hipEvent_t event = nullptr;
+  bool result = (hipSetDevice(slotDevice(slot, _deviceId)) == hipSuccess) &&
+                (hipStreamCreateWithFlags(&stream, hipStreamNonBlocking) ==
+                 hipSuccess) &&
+                (hipEventCreateWithFlags(&event, hipEventDisableTiming) ==
+                 hipSuccess);
+
+  // Wait for all threads, so the setup isn't a part of the measurement
+  ++ready_;
+  while (!start_.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+
+  const char* inside = reinterpret_cast<const char*>(shared_[slot]) + 64;
+  for (unsigned int i = 0; result && (i < Iterations[operation_]); ++i) {
+    switch (operation_) {
+      case Launch:
+        result = (hipModuleLaunchKernel(functions_[slot], 1, 1, 1, 1, 1, 1,
+                                        0, stream, nullptr,
+                                        nullptr) == hipSuccess);
+        break;
+      case MallocFree: {
+        void* ptr = nullptr;
+        result = (hipMalloc(&ptr, AllocSize) == hipSuccess) &&
+                 (hipFree(ptr) == hipSuccess);
+        break;
+      }
+      case EventRecord:
+        result = (hipEventRecord(event, stream) == hipSuccess);
+        break;
+      case StreamCreate: {
+        hipStream_t temp;
+        result = (hipStreamCreate(&temp) == hipSuccess) &&
+                 (hipStreamDestroy(temp) == hipSuccess);
+        break;
+      }
+      case PointerAttributes: {
+        hipPointerAttribute_t attributes;
+        result = (hipPointerGetAttributes(&attributes, inside) == hipSuccess);
+        break;
+      }
+      case FunctionLookup: {
+        hipFunction_t function;
+        result = (hipModuleGetFunction(&function, modules_[slot], "empty") ==
+                  hipSuccess);
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  result = result && (hipStreamSynchronize(stream) == hipSuccess);
+  if (event != nullptr) {
+    hipEventDestroy(event);
+  }
+  if (stream != nullptr) {
+    hipStreamDestroy(stream);
+  }
+  return result;
+}
+
+double HIPPerfThreadScaling::measure(unsigned int threads) {
+  std::vector<std::thread> workers;
+  std::vector<char> results(threads, 0);
+  ready_ = 0;
+  start_ = false;
+  for (unsigned int t = 0; t < threads; ++t) {
+    workers.emplace_back([this, t, &results]() { results[t] = worker(t); });
+  }
+  while (ready_.load() != threads) {
+    std::this_thread::yield();
+  }
+
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  start_.store(true, std::memory_order_release);
+  for (auto& it : workers) {
+    it.join();
+  }
+  timer.Stop();
+
+  for (auto it : results) {
+    if (it == 0) {
+      return -1.0;
+    }
+  }
+  return timer.GetElapsedTime();
+}
+
+void HIPPerfThreadScaling::run(void) {
+  if (_errorFlag) {
+    return;
+  }
+  double base = 0.0;
+  double scaling = 0.0;
+  printf("\n%s on %d device(s)\n threads    ops/s   scaling\n",
+         Names[operation_], numDevices_);
+  for (unsigned int i = 0; i < NumThreads; ++i) {
+    const double time = measure(Threads[i]);
+    CHECK_RESULT((time <= 0.0), "%s failed with %u threads", Names[operation_],
+                 Threads[i]);
+    const double rate = Threads[i] * Iterations[operation_] / time;
+    base = (i == 0) ? rate : base;
+    scaling = rate / base;
+    printf("%8u %10.0f %8.2fx\n", Threads[i], rate, scaling);
+  }
+
+  std::stringstream stream;
+  stream << Names[operation_] << ", " << numDevices_ << " device(s), "
+         << Threads[NumThreads - 1] << " vs 1 thread throughput";
+  testDescString = stream.str();
+  _perfInfo = static_cast<float>(scaling);
+}
+
+unsigned int HIPPerfThreadScaling::close(void) {
+  for (size_t d = 0; d < modules_.size(); ++d) {
+    if (shared_[d] != nullptr) {
+      hipFree(shared_[d]);
+    }
+    if (modules_[d] != nullptr) {
+      hipModuleUnload(modules_[d]);
+    }
+  }
+  modules_.clear();
+  functions_.clear();
+  shared_.clear();
+  return HIPPerfTestImp::close();
+}
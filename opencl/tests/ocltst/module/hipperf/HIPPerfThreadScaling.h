@@ -0,0 +1,68 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#ifndef _HIPPerfThreadScaling_H_
+#define _HIPPerfThreadScaling_H_
+
+#include <atomic>
+#include <vector>
+
+#include "HIPPerfTestImp.h"
+
+//! Runs the same HIP operation from 1 to 128 host threads and prints the
+//! throughput curve, which exposes the contention on the runtime locks
+class HIPPerfThreadScaling : public HIPPerfTestImp {
+ public:
+  enum Operation {
+    Launch,             //!< Kernel launches, the queue locks
+    MallocFree,         //!< hipMalloc/hipFree, the MemObjMap update
+    EventRecord,        //!< hipEventRecord, the stream locks
+    StreamCreate,       //!< hipStreamCreate/Destroy, the stream set lock
+    PointerAttributes,  //!< hipPointerGetAttributes, the MemObjMap lookup
+    FunctionLookup,     //!< hipModuleGetFunction, the module symbol lookup
+    TotalOperations
+  };
+
+  HIPPerfThreadScaling();
+  virtual ~HIPPerfThreadScaling();
+
+ public:
+  virtual void open(unsigned int test, char* units, double& conversion,
+                    unsigned int deviceId);
+  virtual void run(void);
+  virtual unsigned int close(void);
+
+ private:
+  //! The body of a worker thread, returns false on an error
+  bool worker(unsigned int thread);
+
+  //! Returns the run time in seconds of all threads, negative on an error
+  double measure(unsigned int threads);
+
+  Operation operation_;
+  int numDevices_;
+  std::vector<hipModule_t> modules_;
+  std::vector<hipFunction_t> functions_;
+  std::vector<void*> shared_;
+  std::atomic<unsigned int> ready_;
+  std::atomic<bool> start_;
+};
+
+#endif  // _HIPPerfThreadScaling_H_
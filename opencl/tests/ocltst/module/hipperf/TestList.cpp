@@ -0,0 +1,67 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "OCLTestListImp.h"
+
+//
+// Includes for tests
+//
+#include "HIPPerfAllocTrace.h"
+#include "HIPPerfCopyPath.h"
+#include "HIPPerfEventRecord.h"
+#include "HIPPerfGraph.h"
+#include "HIPPerfGraphLaunch.h"
+#include "HIPPerfHostcall.h"
+#include "HIPPerfLaunchLatency.h"
+#include "HIPPerfMallocAsync.h"
+#include "HIPPerfPeerCopy.h"
+#include "HIPPerfStartup.h"
+#include "HIPPerfStreamCreate.h"
+#include "HIPPerfThreadScaling.h"
+
+//
+//  Helper macro for adding tests
+//
+template <typename T>
+static void* dictionary_CreateTestFunc(void) {
+  return new T();
+}
+
+#define TEST(name) \
+  { #name, &dictionary_CreateTestFunc < name> }
+
+TestEntry TestList[] = {
+    TEST(HIPPerfStartup),
+    TEST(HIPPerfLaunchLatency),
+    TEST(HIPPerfEventRecord),
+    TEST(HIPPerfMallocAsync),
+    TEST(HIPPerfStreamCreate),
+    TEST(HIPPerfGraphLaunch),
+    TEST(HIPPerfPeerCopy),
+    TEST(HIPPerfCopyPath),
+    TEST(HIPPerfThreadScaling),
+    TEST(HIPPerfAllocTrace),
+    TEST(HIPPerfGraph),
+    TEST(HIPPerfHostcall),
+};
+
+unsigned int TestListCount = sizeof(TestList) / sizeof(TestList[0]);
+unsigned int TestLibVersion = 0;
+const char* TestLibName = "hipperf";
@@ -0,0 +1,316 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "OCLPerfPageableCopy.h"
+
+#include <Timer.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fstream>
+#include <string>
+
+#include "CL/cl.h"
+#include "CL/cl_ext.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Quiet pesky warnings
+#ifdef WIN_OS
+#define SNPRINTF sprintf_s
+#else
+#define SNPRINTF snprintf
+#endif
+
+#define NUM_SIZES 3
+// 1MB, 16MB, 64MB
+static const size_t Sizes[NUM_SIZES] = {1048576, 16777216, 67108864};
+static const unsigned int Iterations[NUM_SIZES] = {100, 20, 8};
+
+#define NUM_MEMORY 4
+static const char* MemoryNames[NUM_MEMORY] = {"warm", "cold", "huge",
+                                              "remote"};
+
+#define NUM_THREADS 2
+static const unsigned int Threads[NUM_THREADS] = {1, 4};
+
+static const size_t HugePageSize = 2 * 1024 * 1024;
+
+// The policy of mbind(), the headers of libnuma aren't required
+static const int MpolBind = 2;
+
+typedef struct _threadInfo {
+  unsigned int threadID_;
+  OCLPerfPageableCopy* testObj_;
+} ThreadInfo;
+
+static void* ThreadMain(void* data) {
+  ThreadInfo* threadData = static_cast<ThreadInfo*>(data);
+  threadData->testObj_->threadEntry(threadData->threadID_);
+  return NULL;
+}
+
+OCLPerfPageableCopy::OCLPerfPageableCopy() {
+  _numSubTests = 2 * NUM_MEMORY * NUM_THREADS * NUM_SIZES;
+}
+
+OCLPerfPageableCopy::~OCLPerfPageableCopy() {}
+
+int OCLPerfPageableCopy::remoteNode() {
+#if defined(__linux__)
+  cl_device_topology_amd topology;
+  error_ = _wrapper->clGetDeviceInfo(devices_[_deviceId],
+                                     CL_DEVICE_TOPOLOGY_AMD, sizeof(topology),
+                                     &topology, NULL);
+  if ((error_ != CL_SUCCESS) ||
+      (topology.raw.type != CL_DEVICE_TOPOLOGY_TYPE_PCIE_AMD)) {
+    return -1;
+  }
+  char path[256];
+  SNPRINTF(path, sizeof(path),
+           "/sys/bus/pci/devices/0000:%02x:%02x.%x/numa_node",
+           topology.pcie.bus & 0xff, topology.pcie.device & 0xff,
+           topology.pcie.function & 0xff);
+  int deviceNode = -1;
+  std::ifstream nodeFile(path);
+  nodeFile >> deviceNode;
+  if (deviceNode < 0) {
+    return -1;
+  }
+  // The online nodes are listed as ranges, e.g. "0-1"
+  std::ifstream onlineFile("/sys/devices/system/node/online");
+  std::string online;
+  onlineFile >> online;
+  size_t pos = 0;
+  while (pos < online.size()) {
+    const size_t end = online.find(',', pos);
+    const std::string range = online.substr(pos, end - pos);
+    const size_t dash = range.find('-');
+    const int first = atoi(range.c_str());
+    const int last =
+        (dash == std::string::npos) ? first : atoi(range.c_str() + dash + 1);
+    for (int node = first; node <= last; ++node) {
+      // The node mask of allocHost() covers 256 nodes
+      if ((node != deviceNode) && (node < 256)) {
+        return node;
+      }
+    }
+    pos = (end == std::string::npos) ? online.size() : end + 1;
+  }
+#endif
+  return -1;
+}
+
+void* OCLPerfPageableCopy::allocHost() {
+#if defined(__linux__)
+  void* ptr = MAP_FAILED;
+  if (memory_ == Huge) {
+    // Reserved huge pages first, the transparent huge pages otherwise
+    ptr = mmap(NULL, bufSize_, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    hugeTlb_ = (ptr != MAP_FAILED);
+    if (!hugeTlb_) {
+      ptr = mmap(NULL, bufSize_, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (ptr != MAP_FAILED) {
+        madvise(ptr, bufSize_, MADV_HUGEPAGE);
+      }
+    }
+  } else {
+    ptr = mmap(NULL, bufSize_, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  }
+  if (ptr == MAP_FAILED) {
+    return NULL;
+  }
+  if (memory_ == Remote) {
+    unsigned long mask[4] = {0};
+    mask[node_ / (8 * sizeof(unsigned long))] |=
+        1UL << (node_ % (8 * sizeof(unsigned long)));
+    if (syscall(SYS_mbind, ptr, bufSize_, MpolBind, mask,
+                8 * sizeof(mask), 0) != 0) {
+      munmap(ptr, bufSize_);
+      return NULL;
+    }
+  }
+  // The cold pages stay untouched, the copy faults them in
+  if (memory_ != Cold) {
+    memset(ptr, 0x5a, bufSize_);
+  }
+  return ptr;
+#else
+  void* ptr = malloc(bufSize_);
+  if (ptr != NULL) {
+    memset(ptr, 0x5a, bufSize_);
+  }
+  return ptr;
+#endif
+}
+
+void OCLPerfPageableCopy::freeHost(void* ptr) {
+#if defined(__linux__)
+  munmap(ptr, bufSize_);
+#else
+  free(ptr);
+#endif
+}
+
+void OCLPerfPageableCopy::open(unsigned int test, char* units,
+                               double& conversion, unsigned int deviceId) {
+  _deviceId = deviceId;
+  skip_ = false;
+  hugeTlb_ = false;
+  node_ = -1;
+  OCLTestImp::open(test, units, conversion, deviceId);
+  CHECK_RESULT((error_ != CL_SUCCESS), "Error opening test");
+
+  bufSize_ = Sizes[test % NUM_SIZES];
+  numIter_ = Iterations[test % NUM_SIZES];
+  numThreads_ = Threads[(test / NUM_SIZES) % NUM_THREADS];
+  memory_ = static_cast<HostMemory>((test / (NUM_SIZES * NUM_THREADS)) %
+                                    NUM_MEMORY);
+  write_ = (test / (NUM_SIZES * NUM_THREADS * NUM_MEMORY)) != 0;
+
+#if !defined(__linux__)
+  if (memory_ != Warm) {
+    skip_ = true;
+    testDescString = "Needs the Linux memory mappings. Test Skipped.";
+    return;
+  }
+#endif
+  if (memory_ == Remote) {
+    node_ = remoteNode();
+    if (node_ < 0) {
+      skip_ = true;
+      testDescString = "No remote NUMA node. Test Skipped.";
+      return;
+    }
+  }
+
+  // Every thread copies with its own queue and buffers
+  for (unsigned int i = 0; i < numThreads_; ++i) {
+    cl_command_queue queue = _wrapper->clCreateCommandQueue(
+        context_, devices_[_deviceId], 0, &error_);
+    CHECK_RESULT((queue == 0), "clCreateCommandQueue() failed");
+    queues_.push_back(queue);
+    cl_mem buffer = _wrapper->clCreateBuffer(context_, CL_MEM_READ_WRITE,
+                                             bufSize_, NULL, &error_);
+    CHECK_RESULT((buffer == 0), "clCreateBuffer() failed");
+    devBuffers_.push_back(buffer);
+    if (memory_ != Cold) {
+      void* ptr = allocHost();
+      CHECK_RESULT((ptr == NULL), "Host memory allocation failed");
+      hostMem_.push_back(ptr);
+    }
+  }
+  errors_.assign(numThreads_, CL_SUCCESS);
+
+  // Warm up, the device memory is allocated on the first use
+  std::vector<char> init(bufSize_, 0);
+  for (unsigned int i = 0; i < numThreads_; ++i) {
+    error_ = _wrapper->clEnqueueWriteBuffer(queues_[i], devBuffers_[i],
+                                            CL_TRUE, 0, bufSize_, init.data(),
+                                            0, NULL, NULL);
+    CHECK_RESULT((error_ != CL_SUCCESS), "clEnqueueWriteBuffer() failed");
+  }
+}
+
+void OCLPerfPageableCopy::threadEntry(unsigned int id) {
+  for (unsigned int i = 0; i < numIter_; ++i) {
+    // The cold memory is mapped again for every copy
+    void* ptr = (memory_ == Cold) ? allocHost() : hostMem_[id];
+    if (ptr == NULL) {
+      errors_[id] = CL_OUT_OF_HOST_MEMORY;
+      return;
+    }
+    cl_int error = write_
+        ? _wrapper->clEnqueueWriteBuffer(queues_[id], devBuffers_[id], CL_TRUE,
+                                         0, bufSize_, ptr, 0, NULL, NULL)
+        : _wrapper->clEnqueueReadBuffer(queues_[id], devBuffers_[id], CL_TRUE,
+                                        0, bufSize_, ptr, 0, NULL, NULL);
+    if (memory_ == Cold) {
+      freeHost(ptr);
+    }
+    if (error != CL_SUCCESS) {
+      errors_[id] = error;
+      return;
+    }
+  }
+}
+
+void OCLPerfPageableCopy::run(void) {
+  if (skip_ || (error_ != CL_SUCCESS)) {
+    return;
+  }
+  CPerfCounter timer;
+  timer.Reset();
+  timer.Start();
+  if (numThreads_ == 1) {
+    threadEntry(0);
+  } else {
+    std::vector<OCLutil::Thread> threads(numThreads_);
+    std::vector<ThreadInfo> threadInfo(numThreads_);
+    for (unsigned int i = 0; i < numThreads_; ++i) {
+      threadInfo[i].threadID_ = i;
+      threadInfo[i].testObj_ = this;
+      threads[i].create(ThreadMain, &threadInfo[i]);
+    }
+    for (unsigned int i = 0; i < numThreads_; ++i) {
+      threads[i].join();
+    }
+  }
+  timer.Stop();
+  for (unsigned int i = 0; i < numThreads_; ++i) {
+    CHECK_RESULT((errors_[i] != CL_SUCCESS), "The pageable copy failed");
+  }
+
+  char memory[32];
+  SNPRINTF(memory, sizeof(memory), "%s%s", MemoryNames[memory_],
+           (memory_ == Huge) ? (hugeTlb_ ? " tlb" : " thp") : "");
+  char buf[256];
+  SNPRINTF(buf, sizeof(buf), "%5s %8d KB, %-10s pages, %d thr (GB/s)",
+           write_ ? "Write" : "Read", static_cast<int>(bufSize_ / 1024),
+           memory, numThreads_);
+  testDescString = buf;
+  const double sec = timer.GetElapsedTime();
+  _perfInfo = static_cast<float>(
+      (static_cast<double>(bufSize_) * numIter_ * numThreads_ * 1e-09) / sec);
+}
+
+unsigned int OCLPerfPageableCopy::close(void) {
+  for (auto ptr : hostMem_) {
+    freeHost(ptr);
+  }
+  hostMem_.clear();
+  for (auto buffer : devBuffers_) {
+    _wrapper->clReleaseMemObject(buffer);
+  }
+  devBuffers_.clear();
+  for (auto queue : queues_) {
+    _wrapper->clReleaseCommandQueue(queue);
+  }
+  queues_.clear();
+  return OCLTestImp::close();
+}
@@ -0,0 +1,71 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#ifndef _OCL_PERF_PAGEABLE_COPY_H_
+#define _OCL_PERF_PAGEABLE_COPY_H_
+
+#include <string>
+#include <vector>
+
+#include "OCLTestImp.h"
+
+//! Reads and writes buffers from pageable host memory under the conditions
+//! the pre-allocated buffers of OCLPerfBufferReadSpeed don't cover: pages
+//! which were never touched, huge pages, memory on a NUMA node remote to the
+//! device and concurrent copies from several threads. The runtime copies
+//! such memory through the staging buffers or pins it per transfer
+class OCLPerfPageableCopy : public OCLTestImp {
+ public:
+  enum HostMemory { Warm, Cold, Huge, Remote };
+
+  OCLPerfPageableCopy();
+  virtual ~OCLPerfPageableCopy();
+
+ public:
+  virtual void open(unsigned int test, char* units, double& conversion,
+                    unsigned int deviceID);
+  virtual void run(void);
+  virtual unsigned int close(void);
+
+  //! The copy loop of a thread
+  void threadEntry(unsigned int id);
+
+ private:
+  //! Allocates the host memory of the subtest, nullptr on failure
+  void* allocHost();
+  void freeHost(void* ptr);
+  //! Finds a NUMA node, which isn't the node of the device
+  int remoteNode();
+
+  bool skip_;
+  bool write_;
+  HostMemory memory_;
+  unsigned int numThreads_;
+  size_t bufSize_;
+  unsigned int numIter_;
+  int node_;
+  bool hugeTlb_;
+  std::vector<cl_command_queue> queues_;
+  std::vector<cl_mem> devBuffers_;
+  std::vector<void*> hostMem_;
+  std::vector<cl_int> errors_;
+};
+
+#endif  // _OCL_PERF_PAGEABLE_COPY_H_
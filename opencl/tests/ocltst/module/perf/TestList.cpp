@@ -62,6 +62,7 @@
 #include "OCLPerfMemCombine.h"
 #include "OCLPerfMemCreate.h"
 #include "OCLPerfMemLatency.h"
+#include "OCLPerfPageableCopy.h"
 #include "OCLPerfPinnedBufferReadSpeed.h"
 #include "OCLPerfPinnedBufferWriteSpeed.h"
 #include "OCLPerfPipeCopySpeed.h"
@@ -182,6 +183,7 @@ TestEntry TestList[] = {
     TEST(OCLPerfDevMemReadSpeed),
     TEST(OCLPerfDevMemWriteSpeed),
     TEST(OCLPerfVerticalFetch),
+    TEST(OCLPerfPageableCopy),
 };
 
 unsigned int TestListCount = sizeof(TestList) / sizeof(TestList[0]);
@@ -0,0 +1,176 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "OCLCommandBuffer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "CL/cl.h"
+
+const static size_t NumElements = 1024 * 1024;
+const static cl_uint NumReplays = 16;
+const static cl_uint FillValue = 7;
+
+const static char* strKernel =
+    "__kernel void increment(global uint* data)                             \n"
+    "{                                                                      \n"
+    "   data[get_global_id(0)] += 1;                                        \n"
+    "}                                                                      \n";
+
+OCLCommandBuffer::OCLCommandBuffer() {
+  _numSubTests = 1;
+  supported_ = false;
+  commandBuffer_ = nullptr;
+}
+
+OCLCommandBuffer::~OCLCommandBuffer() {}
+
+void OCLCommandBuffer::open(unsigned int test, char* units, double& conversion,
+                            unsigned int deviceId) {
+  OCLTestImp::open(test, units, conversion, deviceId);
+  CHECK_RESULT((error_ != CL_SUCCESS), "Error opening test");
+
+  char extensions[4096] = {0};
+  _wrapper->clGetDeviceInfo(devices_[deviceId], CL_DEVICE_EXTENSIONS,
+                            sizeof(extensions), extensions, nullptr);
+  if (!strstr(extensions, "cl_khr_command_buffer")) {
+    printf("cl_khr_command_buffer is required for this test!\n");
+    return;
+  }
+
+#define GET_FUNCTION(var, name)                                      \
+  var = (name##_fn)clGetExtensionFunctionAddressForPlatform(platform_, \
+                                                            #name);    \
+  CHECK_RESULT((var == nullptr), "Failed to get " #name)
+
+  GET_FUNCTION(createCommandBuffer_, clCreateCommandBufferKHR);
+  GET_FUNCTION(finalizeCommandBuffer_, clFinalizeCommandBufferKHR);
+  GET_FUNCTION(releaseCommandBuffer_, clReleaseCommandBufferKHR);
+  GET_FUNCTION(enqueueCommandBuffer_, clEnqueueCommandBufferKHR);
+  GET_FUNCTION(commandFillBuffer_, clCommandFillBufferKHR);
+  GET_FUNCTION(commandNDRangeKernel_, clCommandNDRangeKernelKHR);
+  GET_FUNCTION(commandCopyBuffer_, clCommandCopyBufferKHR);
+  GET_FUNCTION(getCommandBufferInfo_, clGetCommandBufferInfoKHR);
+#undef GET_FUNCTION
+
+  program_ = _wrapper->clCreateProgramWithSource(context_, 1, &strKernel,
+                                                 nullptr, &error_);
+  CHECK_RESULT((error_ != CL_SUCCESS), "clCreateProgramWithSource() failed");
+
+  error_ = _wrapper->clBuildProgram(program_, 1, &devices_[deviceId], nullptr,
+                                    nullptr, nullptr);
+  CHECK_RESULT((error_ != CL_SUCCESS), "clBuildProgram() failed");
+
+  kernel_ = _wrapper->clCreateKernel(program_, "increment", &error_);
+  CHECK_RESULT((error_ != CL_SUCCESS), "clCreateKernel() failed");
+
+  // Counter, copy of the counter and the filled buffer
+  for (int i = 0; i < 3; ++i) {
+    cl_mem buffer =
+        _wrapper->clCreateBuffer(context_, CL_MEM_READ_WRITE,
+                                 NumElements * sizeof(cl_uint), nullptr, &error_);
+    CHECK_RESULT((error_ != CL_SUCCESS), "clCreateBuffer() failed");
+    buffers_.push_back(buffer);
+  }
+  supported_ = true;
+}
+
+void OCLCommandBuffer::run(void) {
+  if (!supported_) {
+    return;
+  }
+  cl_command_queue queue = cmdQueues_[_deviceId];
+  std::vector<cl_uint> values(NumElements, 0);
+  for (auto buffer : buffers_) {
+    error_ = _wrapper->clEnqueueWriteBuffer(queue, buffer, true, 0,
+                                            NumElements * sizeof(cl_uint),
+                                            values.data(), 0, nullptr, nullptr);
+    CHECK_RESULT((error_ != CL_SUCCESS), "clEnqueueWriteBuffer() failed");
+  }
+
+  commandBuffer_ = createCommandBuffer_(1, &queue, nullptr, &error_);
+  CHECK_RESULT((error_ != CL_SUCCESS), "clCreateCommandBufferKHR() failed");
+
+  cl_sync_point_khr syncPoint = 0;
+  error_ = commandFillBuffer_(commandBuffer_, nullptr, buffers_[2], &FillValue,
+                              sizeof(FillValue), 0,
+                              NumElements * sizeof(cl_uint), 0, nullptr,
+                              nullptr, nullptr);
+  CHECK_RESULT((error_ != CL_SUCCESS), "clCommandFillBufferKHR() failed");
+
+  error_ = _wrapper->clSetKernelArg(kernel_, 0, sizeof(cl_mem), &buffers_[0]);
+  CHECK_RESULT((error_ != CL_SUCCESS), "clSetKernelArg() failed");
+  size_t gws[1] = {NumElements};
+  error_ = commandNDRangeKernel_(commandBuffer_, nullptr, nullptr, kernel_, 1,
+                                 nullptr, gws, nullptr, 0, nullptr, &syncPoint,
+                                 nullptr);
+  CHECK_RESULT((error_ != CL_SUCCESS), "clCommandNDRangeKernelKHR() failed");
+
+  // The argument change after the recording mustn't affect the replays
+  error_ = _wrapper->clSetKernelArg(kernel_, 0, sizeof(cl_mem), &buffers_[2]);
+  CHECK_RESULT((error_ != CL_SUCCESS), "clSetKernelArg() failed");
+
+  error_ = commandCopyBuffer_(commandBuffer_, nullptr, buffers_[0], buffers_[1],
+                              0, 0, NumElements * sizeof(cl_uint), 1,
+                              &syncPoint, nullptr, nullptr);
+  CHECK_RESULT((error_ != CL_SUCCESS), "clCommandCopyBufferKHR() failed");
+
+  error_ = finalizeCommandBuffer_(commandBuffer_);
+  CHECK_RESULT((error_ != CL_SUCCESS), "clFinalizeCommandBufferKHR() failed");
+
+  for (cl_uint i = 0; i < NumReplays; ++i) {
+    error_ = enqueueCommandBuffer_(0, nullptr, commandBuffer_, 0, nullptr,
+                                   nullptr);
+    CHECK_RESULT((error_ != CL_SUCCESS), "clEnqueueCommandBufferKHR() failed");
+  }
+  _wrapper->clFinish(queue);
+
+  cl_command_buffer_state_khr state = CL_COMMAND_BUFFER_STATE_RECORDING_KHR;
+  error_ = getCommandBufferInfo_(commandBuffer_, CL_COMMAND_BUFFER_STATE_KHR,
+                                 sizeof(state), &state, nullptr);
+  CHECK_RESULT((error_ != CL_SUCCESS) ||
+                   (state != CL_COMMAND_BUFFER_STATE_EXECUTABLE_KHR),
+               "Command buffer isn't executable after the replays");
+
+  const cl_uint expected[2] = {NumReplays, FillValue};
+  for (int b = 0; b < 2; ++b) {
+    error_ = _wrapper->clEnqueueReadBuffer(queue, buffers_[b + 1], true, 0,
+                                           NumElements * sizeof(cl_uint),
+                                           values.data(), 0, nullptr, nullptr);
+    CHECK_RESULT((error_ != CL_SUCCESS), "clEnqueueReadBuffer() failed");
+    for (size_t i = 0; i < NumElements; ++i) {
+      if (values[i] != expected[b]) {
+        printf("Element %zu: %u != %u\n", i, values[i], expected[b]);
+        CHECK_RESULT(true, "Incorrect result of the command buffer replay");
+      }
+    }
+  }
+}
+
+unsigned int OCLCommandBuffer::close(void) {
+  if (commandBuffer_ != nullptr) {
+    releaseCommandBuffer_(commandBuffer_);
+    commandBuffer_ = nullptr;
+  }
+  return OCLTestImp::close();
+}
@@ -29,6 +29,7 @@
 #include "OCLBlitKernel.h"
 #include "OCLBufferFromImage.h"
 #include "OCLCPUGuardPages.h"
+#include "OCLCommandBuffer.h"
 #include "OCLCreateBuffer.h"
 #include "OCLCreateContext.h"
 #include "OCLCreateImage.h"
@@ -118,6 +119,7 @@ TestEntry TestList[] = {
     TEST(OCLReadWriteImage),
     TEST(OCLStablePState),
     TEST(OCLP2PBuffer),
+    TEST(OCLCommandBuffer),
     // Failures in Linux. IOL doesn't support tiling aperture and Cypress linear
     // image writes TEST(OCLPersistent),
 };
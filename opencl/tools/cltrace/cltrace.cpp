@@ -4,6 +4,7 @@
 
 #include <CL/opencl.h>
 #include <vdi_agent_amd.h>
+#include "cltrace_binary.h"
 
 #if defined(CL_VERSION_2_0)
 /* Deprecated in OpenCL 2.0 */
@@ -18,6 +19,10 @@
 #include <cstring>
 #include <cstdlib>
 #include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <initializer_list>
+#include <type_traits>
 
 #ifdef _MSC_VER
 #include <windows.h>
@@ -26,6 +31,8 @@
 #else
 #include <unistd.h>
 #include <pthread.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #endif
 
 #define CASE(x) case x: return #x;
@@ -4372,6 +4379,231 @@ cleanup(void)
 #define SET_ORIGINAL(DISPATCH) \
     modified_dispatch.DISPATCH = original_dispatch.DISPATCH;
 
+// The binary trace mode. A per call record goes into a memory mapped file,
+// so the hot path is a timestamp, an atomic increment and a few stores,
+// instead of the string formatting of the text mode.
+static CLTraceBinaryHeader *binaryHeader = NULL;
+static CLTraceBinaryRecord *binaryRecords = NULL;
+static size_t binaryMapSize = 0;
+static std::atomic<uint16_t> binaryThreads(0);
+
+// The default size of the binary trace file in MB
+static const uint64_t binaryDefaultSize = 256;
+
+static cl_icd_dispatch_table binary_dispatch;
+
+static inline uint64_t
+binaryTimestamp(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static inline uint16_t
+binaryThreadId(void)
+{
+    static thread_local uint16_t id = ++binaryThreads;
+    return id;
+}
+
+// Collects the handles and the size of a call from its typed arguments
+struct BinaryArgs {
+    uint64_t handle[2];
+    uint64_t size;
+    int handles;
+
+    BinaryArgs() : size(0), handles(0) { handle[0] = handle[1] = 0; }
+
+    template <typename T>
+    void add(const T& arg)
+    {
+        if constexpr (std::is_pointer<T>::value) {
+            if (handles < 2) {
+                handle[handles++] = (uint64_t)(uintptr_t)arg;
+            }
+        }
+        else if constexpr (std::is_same<T, size_t>::value) {
+            size = (uint64_t)arg;
+        }
+    }
+};
+
+template <typename R>
+static inline int64_t
+binaryResult(const R& ret)
+{
+    if constexpr (std::is_pointer<R>::value) {
+        return (int64_t)(intptr_t)ret;
+    }
+    else {
+        return (int64_t)ret;
+    }
+}
+
+static inline void
+binaryRecord(uint16_t call, uint64_t begin, const BinaryArgs& args,
+             int64_t result)
+{
+    const uint64_t end = binaryTimestamp();
+    std::atomic<uint64_t> *count =
+        reinterpret_cast<std::atomic<uint64_t>*>(&binaryHeader->count);
+    const uint64_t index = count->fetch_add(1, std::memory_order_relaxed);
+    if (index >= binaryHeader->capacity) {
+        // The file is full, the decoder reports the dropped calls
+        return;
+    }
+    CLTraceBinaryRecord &r = binaryRecords[index];
+    const uint64_t duration = end - begin;
+    r.duration = duration > UINT32_MAX ? UINT32_MAX : (uint32_t)duration;
+    r.call = call;
+    r.thread = binaryThreadId();
+    r.handle[0] = args.handle[0];
+    r.handle[1] = args.handle[1];
+    r.size = args.size;
+    r.result = result;
+    // A non zero begin marks the record as complete for the decoder
+    r.begin = begin;
+}
+
+// Forwards a call of the dispatch table entry Member and records it
+template <auto Member, uint16_t Call,
+          typename F = typename std::remove_reference<
+              decltype(original_dispatch.*Member)>::type>
+struct BinaryThunk;
+
+template <auto Member, uint16_t Call, typename R, typename... A>
+struct BinaryThunk<Member, Call, R (CL_API_CALL *)(A...)> {
+    static R CL_API_CALL
+    call(A... args)
+    {
+        BinaryArgs a;
+        (void)std::initializer_list<int>{(a.add(args), 0)...};
+        const uint64_t begin = binaryTimestamp();
+        if constexpr (std::is_void<R>::value) {
+            (original_dispatch.*Member)(args...);
+            binaryRecord(Call, begin, a, 0);
+        }
+        else {
+            R ret = (original_dispatch.*Member)(args...);
+            binaryRecord(Call, begin, a, binaryResult(ret));
+            return ret;
+        }
+    }
+};
+
+static void
+binaryCleanup(void)
+{
+    if (binaryHeader == NULL) {
+        return;
+    }
+#ifdef _MSC_VER
+    FlushViewOfFile(binaryHeader, 0);
+    UnmapViewOfFile(binaryHeader);
+#else
+    msync(binaryHeader, binaryMapSize, MS_SYNC);
+    munmap(binaryHeader, binaryMapSize);
+#endif
+    binaryHeader = NULL;
+}
+
+// Maps the trace file and fills binary_dispatch, returns false on a failure
+static bool
+binaryInit(const std::string& fileName)
+{
+    uint64_t megabytes = binaryDefaultSize;
+    const char *sizeEnv = getenv("CL_TRACE_BINARY_SIZE");
+    if (sizeEnv != NULL && strtoull(sizeEnv, NULL, 10) != 0) {
+        megabytes = strtoull(sizeEnv, NULL, 10);
+    }
+    binaryMapSize = (size_t)(megabytes << 20);
+    if (binaryMapSize <= sizeof(CLTraceBinaryHeader)) {
+        return false;
+    }
+
+    void *base = NULL;
+#ifdef _MSC_VER
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE,
+        (DWORD)((uint64_t)binaryMapSize >> 32), (DWORD)binaryMapSize, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) {
+        return false;
+    }
+    base = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, binaryMapSize);
+    CloseHandle(mapping);
+    if (base == NULL) {
+        return false;
+    }
+#else
+    int fd = open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    if (ftruncate(fd, (off_t)binaryMapSize) != 0) {
+        close(fd);
+        return false;
+    }
+    base = mmap(NULL, binaryMapSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+#endif
+
+    binaryHeader = static_cast<CLTraceBinaryHeader*>(base);
+    binaryRecords = reinterpret_cast<CLTraceBinaryRecord*>(binaryHeader + 1);
+    memcpy(binaryHeader->magic, CLTRACE_BINARY_MAGIC,
+           sizeof(binaryHeader->magic));
+    binaryHeader->version = CLTRACE_BINARY_VERSION;
+    binaryHeader->recordSize = sizeof(CLTraceBinaryRecord);
+    binaryHeader->capacity = (binaryMapSize - sizeof(CLTraceBinaryHeader)) /
+        sizeof(CLTraceBinaryRecord);
+    binaryHeader->count = 0;
+    binaryHeader->startTime = binaryTimestamp();
+#if defined(_WIN32)
+    binaryHeader->pid = _getpid();
+#else
+    binaryHeader->pid = getpid();
+#endif
+
+    // Wrap every entry point the runtime provides, the reserved
+    // extension slots are passed through untouched
+    binary_dispatch = original_dispatch;
+#define X(name) \
+    if (original_dispatch.name != NULL) { \
+        binary_dispatch.name = BinaryThunk<&cl_icd_dispatch_table::name, \
+            CLTRACE_CALL_##name>::call; \
+    }
+    CLTRACE_BINARY_CALLS(X)
+#undef X
+
+    std::atexit(binaryCleanup);
+    return true;
+}
+
+// Replaces %pid% in the file name with the id of the process
+static std::string
+getTraceFileName(const char *name)
+{
+    std::string fileName = name;
+    const std::size_t pidPos = fileName.find("%pid%");
+    if (pidPos != std::string::npos) {
+#if defined(_WIN32)
+        const std::int32_t pid = _getpid();
+#else
+        const std::int32_t pid = getpid();
+#endif
+        fileName.replace(pidPos, 5, std::to_string(pid));
+    }
+    return fileName;
+}
+
 int32_t CL_CALLBACK
 vdiAgent_OnLoad(vdi_agent * agent)
 {
@@ -4383,19 +4615,20 @@ vdiAgent_OnLoad(vdi_agent * agent)
         return err;
     }
 
+    const char *binaryEnv = getenv("CL_TRACE_BINARY");
+    if (binaryEnv != NULL && binaryEnv[0] != '\0') {
+        const std::string fileName = getTraceFileName(binaryEnv);
+        if (!binaryInit(fileName)) {
+            std::cerr << "cltrace: couldn't map " << fileName << std::endl;
+            return CL_OUT_OF_RESOURCES;
+        }
+        return agent->SetICDDispatchTable(
+            agent, &binary_dispatch, sizeof(binary_dispatch));
+    }
+
     clTraceLogEnv = getenv("CL_TRACE_OUTPUT");
     if(clTraceLogEnv!=NULL) {
-        std::string clTraceLogStr = clTraceLogEnv;
-        const std::size_t pidPos = clTraceLogStr.find("%pid%");
-        if (pidPos != std::string::npos) {
-#if defined(_WIN32)
-            const std::int32_t pid = _getpid();
-#else
-            const std::int32_t pid = getpid();
-#endif
-            clTraceLogStr.replace(pidPos, 5, std::to_string(pid));
-        }
-        clTraceLog.open(clTraceLogStr);
+        clTraceLog.open(getTraceFileName(clTraceLogEnv));
         cerrStreamBufSave = std::cerr.rdbuf(clTraceLog.rdbuf());
         std::atexit(cleanup);
     }
@@ -4448,4 +4681,5 @@ void CL_CALLBACK
 vdiAgent_OnUnload(vdi_agent * agent)
 {
     clTraceLog.close();
+    binaryCleanup();
 }
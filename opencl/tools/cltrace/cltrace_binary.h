@@ -0,0 +1,172 @@
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+
+#ifndef CLTRACE_BINARY_H_
+#define CLTRACE_BINARY_H_
+
+#include <cstdint>
+
+// Layout of the binary trace, written by cltrace when CL_TRACE_BINARY is set
+// and read back by cltrace_decode. The file is a header followed by fixed
+// size records, which the traced threads append without any locking.
+
+#define CLTRACE_BINARY_MAGIC   "CLTRACEB"
+#define CLTRACE_BINARY_VERSION 1
+
+// The traced calls in the dispatch table order. The position in the list
+// is the call id of a record, hence new entries go to the end only.
+#define CLTRACE_BINARY_CALLS(X) \
+    X(GetPlatformIDs) \
+    X(GetPlatformInfo) \
+    X(GetDeviceIDs) \
+    X(GetDeviceInfo) \
+    X(CreateContext) \
+    X(CreateContextFromType) \
+    X(RetainContext) \
+    X(ReleaseContext) \
+    X(GetContextInfo) \
+    X(CreateCommandQueue) \
+    X(RetainCommandQueue) \
+    X(ReleaseCommandQueue) \
+    X(GetCommandQueueInfo) \
+    X(SetCommandQueueProperty) \
+    X(CreateBuffer) \
+    X(CreateImage2D) \
+    X(CreateImage3D) \
+    X(RetainMemObject) \
+    X(ReleaseMemObject) \
+    X(GetSupportedImageFormats) \
+    X(GetMemObjectInfo) \
+    X(GetImageInfo) \
+    X(CreateSampler) \
+    X(RetainSampler) \
+    X(ReleaseSampler) \
+    X(GetSamplerInfo) \
+    X(CreateProgramWithSource) \
+    X(CreateProgramWithBinary) \
+    X(RetainProgram) \
+    X(ReleaseProgram) \
+    X(BuildProgram) \
+    X(UnloadCompiler) \
+    X(GetProgramInfo) \
+    X(GetProgramBuildInfo) \
+    X(CreateKernel) \
+    X(CreateKernelsInProgram) \
+    X(RetainKernel) \
+    X(ReleaseKernel) \
+    X(SetKernelArg) \
+    X(GetKernelInfo) \
+    X(GetKernelWorkGroupInfo) \
+    X(WaitForEvents) \
+    X(GetEventInfo) \
+    X(RetainEvent) \
+    X(ReleaseEvent) \
+    X(GetEventProfilingInfo) \
+    X(Flush) \
+    X(Finish) \
+    X(EnqueueReadBuffer) \
+    X(EnqueueWriteBuffer) \
+    X(EnqueueCopyBuffer) \
+    X(EnqueueReadImage) \
+    X(EnqueueWriteImage) \
+    X(EnqueueCopyImage) \
+    X(EnqueueCopyImageToBuffer) \
+    X(EnqueueCopyBufferToImage) \
+    X(EnqueueMapBuffer) \
+    X(EnqueueMapImage) \
+    X(EnqueueUnmapMemObject) \
+    X(EnqueueNDRangeKernel) \
+    X(EnqueueTask) \
+    X(EnqueueNativeKernel) \
+    X(EnqueueMarker) \
+    X(EnqueueWaitForEvents) \
+    X(EnqueueBarrier) \
+    X(GetExtensionFunctionAddress) \
+    X(CreateFromGLBuffer) \
+    X(CreateFromGLTexture2D) \
+    X(CreateFromGLTexture3D) \
+    X(CreateFromGLRenderbuffer) \
+    X(GetGLObjectInfo) \
+    X(GetGLTextureInfo) \
+    X(EnqueueAcquireGLObjects) \
+    X(EnqueueReleaseGLObjects) \
+    X(GetGLContextInfoKHR) \
+    X(SetEventCallback) \
+    X(CreateSubBuffer) \
+    X(SetMemObjectDestructorCallback) \
+    X(CreateUserEvent) \
+    X(SetUserEventStatus) \
+    X(EnqueueReadBufferRect) \
+    X(EnqueueWriteBufferRect) \
+    X(EnqueueCopyBufferRect) \
+    X(CreateEventFromGLsyncKHR) \
+    X(CreateSubDevices) \
+    X(RetainDevice) \
+    X(ReleaseDevice) \
+    X(CreateImage) \
+    X(CreateProgramWithBuiltInKernels) \
+    X(CompileProgram) \
+    X(LinkProgram) \
+    X(UnloadPlatformCompiler) \
+    X(GetKernelArgInfo) \
+    X(EnqueueFillBuffer) \
+    X(EnqueueFillImage) \
+    X(EnqueueMigrateMemObjects) \
+    X(EnqueueMarkerWithWaitList) \
+    X(EnqueueBarrierWithWaitList) \
+    X(GetExtensionFunctionAddressForPlatform) \
+    X(CreateFromGLTexture) \
+    X(CreateCommandQueueWithProperties) \
+    X(CreatePipe) \
+    X(GetPipeInfo) \
+    X(SVMAlloc) \
+    X(SVMFree) \
+    X(EnqueueSVMFree) \
+    X(EnqueueSVMMemcpy) \
+    X(EnqueueSVMMemFill) \
+    X(EnqueueSVMMap) \
+    X(EnqueueSVMUnmap) \
+    X(CreateSamplerWithProperties) \
+    X(SetKernelArgSVMPointer) \
+    X(SetKernelExecInfo) \
+    X(GetKernelSubGroupInfoKHR) \
+    X(CloneKernel) \
+    X(CreateProgramWithILKHR) \
+    X(EnqueueSVMMigrateMem) \
+    X(GetDeviceAndHostTimer) \
+    X(GetHostTimer) \
+    X(GetKernelSubGroupInfo) \
+    X(SetDefaultDeviceCommandQueue) \
+    X(SetProgramReleaseCallback) \
+    X(SetProgramSpecializationConstant)
+
+enum CLTraceCallId {
+#define X(name) CLTRACE_CALL_##name,
+    CLTRACE_BINARY_CALLS(X)
+#undef X
+    CLTRACE_CALL_COUNT
+};
+
+struct CLTraceBinaryHeader {
+    char     magic[8];      // CLTRACE_BINARY_MAGIC without the terminator
+    uint32_t version;       // CLTRACE_BINARY_VERSION
+    uint32_t recordSize;    // sizeof(CLTraceBinaryRecord)
+    uint64_t capacity;      // The number of records, which fit into the file
+    uint64_t count;         // The number of the reserved records
+    uint64_t startTime;     // Timestamp of the trace start in ns
+    int32_t  pid;           // Process id of the traced application
+    uint32_t reserved;
+};
+
+struct CLTraceBinaryRecord {
+    uint64_t begin;         // Timestamp of the call in ns
+    uint32_t duration;      // Duration of the call in ns, saturated
+    uint16_t call;          // CLTraceCallId
+    uint16_t thread;        // Sequential id of the calling thread
+    uint64_t handle[2];     // The first two pointer arguments
+    uint64_t size;          // The last size_t argument
+    int64_t  result;        // The returned error code or handle
+};
+
+#endif // CLTRACE_BINARY_H_
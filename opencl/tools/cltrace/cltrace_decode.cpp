@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+
+// Offline decoder of the binary cltrace output (CL_TRACE_BINARY).
+//
+// Usage: cltrace_decode [-s] <trace file>
+//   -s  prints the per call summary instead of the individual calls
+
+#include "cltrace_binary.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+static const char *callNames[] = {
+#define X(name) "cl" #name,
+    CLTRACE_BINARY_CALLS(X)
+#undef X
+};
+
+static const char *
+getCallName(uint16_t call)
+{
+    return call < CLTRACE_CALL_COUNT ? callNames[call] : "<unknown>";
+}
+
+struct Summary {
+    uint64_t calls;
+    uint64_t total;
+    uint64_t max;
+
+    Summary() : calls(0), total(0), max(0) { }
+};
+
+static void
+printCalls(const CLTraceBinaryHeader& header,
+           const std::vector<CLTraceBinaryRecord>& records)
+{
+    for (const auto& r : records) {
+        const uint64_t start = r.begin - header.startTime;
+        printf("%12llu.%03llu [%u] %s(0x%llx,0x%llx,%llu) = %lld  %u ns\n",
+               (unsigned long long)(start / 1000),
+               (unsigned long long)(start % 1000), r.thread,
+               getCallName(r.call), (unsigned long long)r.handle[0],
+               (unsigned long long)r.handle[1], (unsigned long long)r.size,
+               (long long)r.result, r.duration);
+    }
+}
+
+static void
+printSummary(const std::vector<CLTraceBinaryRecord>& records)
+{
+    std::vector<Summary> summary(CLTRACE_CALL_COUNT);
+    for (const auto& r : records) {
+        if (r.call >= CLTRACE_CALL_COUNT) {
+            continue;
+        }
+        Summary &s = summary[r.call];
+        ++s.calls;
+        s.total += r.duration;
+        s.max = std::max<uint64_t>(s.max, r.duration);
+    }
+
+    std::vector<int> order;
+    for (int i = 0; i < CLTRACE_CALL_COUNT; ++i) {
+        if (summary[i].calls != 0) {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&summary](int a, int b) {
+        return summary[a].total > summary[b].total;
+    });
+
+    printf("%-40s %12s %14s %12s %12s\n",
+           "Call", "Count", "Total (ns)", "Avg (ns)", "Max (ns)");
+    for (int i : order) {
+        const Summary &s = summary[i];
+        printf("%-40s %12llu %14llu %12llu %12llu\n", callNames[i],
+               (unsigned long long)s.calls, (unsigned long long)s.total,
+               (unsigned long long)(s.total / s.calls),
+               (unsigned long long)s.max);
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+    bool summary = false;
+    const char *fileName = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-s") == 0) {
+            summary = true;
+        }
+        else {
+            fileName = argv[i];
+        }
+    }
+    if (fileName == NULL) {
+        std::cerr << "Usage: " << argv[0] << " [-s] <trace file>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream file(fileName, std::ios::binary);
+    CLTraceBinaryHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        memcmp(header.magic, CLTRACE_BINARY_MAGIC, sizeof(header.magic))) {
+        std::cerr << fileName << " is not a cltrace binary file" << std::endl;
+        return 1;
+    }
+    if (header.version != CLTRACE_BINARY_VERSION ||
+        header.recordSize != sizeof(CLTraceBinaryRecord)) {
+        std::cerr << fileName << " has the unsupported version "
+                  << header.version << std::endl;
+        return 1;
+    }
+
+    const uint64_t count = std::min(header.count, header.capacity);
+    std::vector<CLTraceBinaryRecord> records(count);
+    if (count != 0 && !file.read(reinterpret_cast<char*>(records.data()),
+                                 count * sizeof(CLTraceBinaryRecord))) {
+        std::cerr << fileName << " is truncated" << std::endl;
+        return 1;
+    }
+
+    // Drop the records, which were reserved but not written before an exit,
+    // and restore the call order, since a record is reserved at the return
+    records.erase(std::remove_if(records.begin(), records.end(),
+        [](const CLTraceBinaryRecord& r) { return r.begin == 0; }),
+        records.end());
+    std::stable_sort(records.begin(), records.end(),
+        [](const CLTraceBinaryRecord& a, const CLTraceBinaryRecord& b) {
+            return a.begin < b.begin;
+        });
+
+    printf("!!! Binary API trace of process %d, %llu calls",
+           header.pid, (unsigned long long)records.size());
+    if (header.count > header.capacity) {
+        printf(", %llu dropped (increase CL_TRACE_BINARY_SIZE)",
+               (unsigned long long)(header.count - header.capacity));
+    }
+    printf("\n");
+
+    if (summary) {
+        printSummary(records);
+    }
+    else {
+        printCalls(header, records);
+    }
+    return 0;
+}
@@ -95,7 +95,8 @@ target_sources(rocclr PRIVATE
   ${ROCCLR_SRC_DIR}/thread/semaphore.cpp
   ${ROCCLR_SRC_DIR}/thread/thread.cpp
   ${ROCCLR_SRC_DIR}/utils/debug.cpp
-  ${ROCCLR_SRC_DIR}/utils/flags.cpp)
+  ${ROCCLR_SRC_DIR}/utils/flags.cpp
+  ${ROCCLR_SRC_DIR}/utils/metrics.cpp)
 
 if(WIN32)
   target_sources(rocclr PRIVATE
@@ -46,6 +46,7 @@ target_sources(rocclr PRIVATE
   ${ROCCLR_SRC_DIR}/device/rocm/rocglinterop.cpp
   ${ROCCLR_SRC_DIR}/device/rocm/rockernel.cpp
   ${ROCCLR_SRC_DIR}/device/rocm/rocmemory.cpp
+  ${ROCCLR_SRC_DIR}/device/rocm/rocpincache.cpp
   ${ROCCLR_SRC_DIR}/device/rocm/rocprintf.cpp
   ${ROCCLR_SRC_DIR}/device/rocm/rocprogram.cpp
   ${ROCCLR_SRC_DIR}/device/rocm/rocsettings.cpp
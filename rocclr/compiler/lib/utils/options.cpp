@@ -27,6 +27,10 @@
 #include <iterator>
 #include <cassert>
 #include <regex>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 #include "options.hpp"
 
 namespace {
@@ -1032,6 +1036,114 @@ static void logInvalidOption(std::string& options, size_t bpos,
     log += msg + "\n";
 }
 
+//! An option of the option string, found by the tokenizer
+struct ParsedOption {
+    int index;          // index of the option descriptor
+    size_t bpos;        // position of the leading '-'
+    size_t sPos;        // position of the option name
+    size_t pos;         // position after the option and its value
+    std::string value;  // value of the option
+    bool isShortName;   // -: short name; --: long name
+    bool isPrefix;      // -f or -m prefixed option
+    bool isNegated;     // -fno- or -mno- prefixed option
+    const char* error;  // log message of an invalid option, which ends the list
+};
+
+// Splits the option string into the option descriptors and their values
+static void
+tokenizeOptions(std::string& options, std::vector<ParsedOption>& parsed)
+{
+    for (size_t pos = options.find_first_not_of(' ', 0);
+         pos != std::string::npos;
+         pos = options.find_first_not_of(" ", pos))
+    {
+        ParsedOption opt = { -1, pos, 0, 0, std::string(), true, false, false, NULL };
+
+        if (options.at(pos) == '-') {
+            pos++;
+        }
+        else {
+            // options should start with "-"
+            opt.error = "  (expected - at the beginning)";
+            parsed.push_back(opt);
+            return;
+        }
+
+        if (options.at(pos) == '-') {
+           opt.isShortName = false;
+           pos++;
+        }
+
+        if ((pos == std::string::npos)
+            || OPTION_valueSeparator(options.at(pos)))
+        {
+            opt.error = "  (expected an option name)";
+            parsed.push_back(opt);
+            return;
+        }
+
+        size_t sPos  = pos;
+        opt.index = getOptionDesc(options, sPos, opt.isShortName, OFA_NORMAL, pos, opt.value);
+        if (opt.index < 0) {
+            size_t sPos1;
+            pos = sPos;
+            if (options.at(pos) == 'f') {
+                opt.isPrefix = true;
+                opt.isNegated = (options.compare(pos+1, (size_t)3, "no-") == 0);
+
+                sPos1 = pos + (opt.isNegated ? 4 : 1);
+                opt.index = getOptionDesc(options, sPos1, opt.isShortName,
+                                          OFA_PREFIX_F, pos, opt.value);
+            }
+            else if (options.at(pos) == 'm') {
+                opt.isPrefix = true;
+                opt.isNegated = (options.compare(pos+1, (size_t)3, "no-") == 0);
+
+                sPos1 = pos + (opt.isNegated ? 4 : 1);
+                opt.index = getOptionDesc(options, sPos1, opt.isShortName,
+                                          OFA_PREFIX_M, pos, opt.value);
+            }
+
+            if (opt.index < 0) {
+                opt.error = "";
+                parsed.push_back(opt);
+                return;
+            }
+        }
+        opt.sPos = sPos;
+        opt.pos = pos;
+        parsed.push_back(opt);
+    }
+}
+
+// Returns the tokenized option string. The programs of an application are usually built
+// with the same options, hence the tokens are cached by the option string
+static std::shared_ptr<const std::vector<ParsedOption>>
+getParsedOptions(std::string& options)
+{
+    static std::mutex cacheLock;
+    static std::unordered_map<std::string,
+                              std::shared_ptr<const std::vector<ParsedOption>>> cache;
+    constexpr size_t MaxCachedOptions = 256;
+    {
+        std::lock_guard<std::mutex> lock(cacheLock);
+        auto it = cache.find(options);
+        if (it != cache.end()) {
+            return it->second;
+        }
+    }
+
+    auto parsed = std::make_shared<std::vector<ParsedOption>>();
+    tokenizeOptions(options, *parsed);
+
+    std::lock_guard<std::mutex> lock(cacheLock);
+    if (cache.size() >= MaxCachedOptions) {
+        cache.clear();
+    }
+    cache.emplace(options, parsed);
+    return parsed;
+}
+
 } // namespace
 
 namespace amd {
@@ -1066,71 +1178,19 @@ parseAllOptions(std::string& options, Options& Opts, bool linkOptsOnly, bool isL
 
     bool isLibLinkOpts = false; // is this set of options for linking library?
     bool firstOpt = true;
-    for (size_t pos = options.find_first_not_of(' ', 0);
-         pos != std::string::npos;
-         pos = options.find_first_not_of(" ", pos))
-    {
-        bool isShortName = true;   // -: short name; --: long name
-
-        // For creating option log
-        size_t bpos = pos;
-
-        if (options.at(pos) == '-') {
-            pos++;
-        }
-        else {
-            // options should start with "-"
-            logInvalidOption(options, bpos, Opts.optionsLog(),
-                             "  (expected - at the beginning)");
+    std::shared_ptr<const std::vector<ParsedOption>> parsed = getParsedOptions(options);
+    for (const ParsedOption& opt : *parsed) {
+        if (opt.error != NULL) {
+            logInvalidOption(options, opt.bpos, Opts.optionsLog(), opt.error);
             return false;
         }
 
-        if (options.at(pos) == '-') {
-           isShortName = false;
-           pos++;
-        }
-
-        if ((pos == std::string::npos)
-            || OPTION_valueSeparator(options.at(pos)))
-        {
-            logInvalidOption(options, bpos, Opts.optionsLog(),
-                             "  (expected an option name)");
-            return false;
-        }
-
-        bool isPrefix_fno = false;
-        bool isPrefix_mno = false;
-        bool isPrefix_option = false;
-
-        std::string value;
-        size_t sPos  = pos;
-        int option_ndx
-            = getOptionDesc(options, sPos, isShortName, OFA_NORMAL, pos, value);
-        if (option_ndx < 0) {
-            size_t sPos1;
-            pos = sPos;
-            if (options.at(pos) == 'f') {
-                isPrefix_option = true;
-                isPrefix_fno = (options.compare(pos+1, (size_t)3, "no-") == 0);
-
-                sPos1 = pos + (isPrefix_fno ? 4 : 1);
-                option_ndx = getOptionDesc(options, sPos1, isShortName,
-                                           OFA_PREFIX_F, pos, value);
-            }
-            else if (options.at(pos) == 'm') {
-                isPrefix_option = true;
-                isPrefix_mno = (options.compare(pos+1, (size_t)3, "no-") == 0);
-
-                sPos1 = pos + (isPrefix_mno ? 4 : 1);
-                option_ndx = getOptionDesc(options, sPos1, isShortName,
-                                           OFA_PREFIX_M, pos, value);
-            }
-
-            if (option_ndx < 0) {
-                logInvalidOption(options, bpos, Opts.optionsLog(), "");
-                return false;
-            }
-        }
+        const int option_ndx = opt.index;
+        const size_t bpos = opt.bpos;
+        const size_t sPos = opt.sPos;
+        const size_t pos = opt.pos;
+        const bool isShortName = opt.isShortName;
+        const std::string& value = opt.value;
 
         od = &OptDescTable[option_ndx];
 
@@ -1189,8 +1249,7 @@ parseAllOptions(std::string& options, Options& Opts, bool linkOptsOnly, bool isL
             if (!(OPTION_info(od) & OA_RUNTIME)) continue;
         }
 
-        if (!processOption(option_ndx, Opts, value, isPrefix_option,
-                           (isPrefix_mno || isPrefix_fno), isLC)) {
+        if (!processOption(option_ndx, Opts, value, opt.isPrefix, opt.isNegated, isLC)) {
             // Keep the optionsLog set in processOption().
             std::string tmpStr("Invalid option: ");
             tmpStr += options.substr(bpos, (pos == std::string::npos)
@@ -43,6 +43,16 @@ const char* BlitLinearSourceCode = BLIT_KERNELS(
 
   extern void __amd_streamOpsWait(__global uint*, __global ulong*, ulong, ulong, ulong);
 
+  typedef struct { ulong handle; } __amd_signal_t;
+
+  extern ulong __ockl_hsa_queue_load_read_index(const __global void*, int);
+
+  extern ulong __ockl_hsa_queue_add_write_index(__global void*, ulong, int);
+
+  extern long __ockl_hsa_signal_load(__amd_signal_t, int);
+
+  extern void __ockl_hsa_signal_store(__amd_signal_t, long, int);
+
   extern void __ockl_dm_init_v1(ulong, ulong, uint, uint);
 
   extern void __ockl_gws_init(uint nwm1, uint rid);
@@ -119,6 +129,36 @@ const char* BlitLinearSourceCode = BLIT_KERNELS(
                               pitch);
   }
 
+  __kernel void __amd_rocclr_fillBufferWide(__global uchar* buf, __constant uchar* pattern,
+                                            uint pattern_size, ulong width, ulong pitch,
+                                            ulong slice_pitch) {
+    __global uchar* row = buf + get_global_id(2) * slice_pitch + get_global_id(1) * pitch;
+    // The head up to the 16 bytes boundary and the tail of the row use byte stores
+    ulong head = min((sizeof(ulong2) - ((ulong)row & (sizeof(ulong2) - 1))) &
+                     (sizeof(ulong2) - 1), width);
+    ulong body = (width - head) / sizeof(ulong2);
+    ulong id = get_global_id(0);
+    if (id == 0) {
+      for (ulong i = 0; i < head; ++i) {
+        row[i] = pattern[i % pattern_size];
+      }
+      for (ulong i = head + body * sizeof(ulong2); i < width; ++i) {
+        row[i] = pattern[i % pattern_size];
+      }
+    }
+    // The grid stride is a multiple of the pattern period, so a work item stores a single value
+    uchar v[sizeof(ulong2)];
+    ulong phase = head + id * sizeof(ulong2);
+    for (uint j = 0; j < sizeof(ulong2); ++j) {
+      v[j] = pattern[(phase + j) % pattern_size];
+    }
+    ulong2 value = as_ulong2(vload16(0, v));
+    __global ulong2* dst = (__global ulong2*)(row + head);
+    for (ulong i = id; i < body; i += get_global_size(0)) {
+      dst[i] = value;
+    }
+  }
+
   __kernel void __amd_rocclr_copyBuffer(__global uchar* src, __global uchar* dst,
                                           ulong size, uint remainder,
                                           uint aligned_size, ulong end_ptr, uint next_chunk) {
@@ -162,6 +202,125 @@ const char* BlitLinearSourceCode = BLIT_KERNELS(
                                                    ulong4 srcRect, ulong4 dstRect, ulong4 size) {
     __amd_copyBufferRectAligned(src, dst, srcRect, dstRect, size);
   }
+
+  __kernel void __amd_rocclr_copyBufferBatch(__global ulong* desc, uint count) {
+    // Each workgroup walks the descriptors {src, dst, size} with a stride of the grid
+    for (uint d = get_group_id(0); d < count; d += get_num_groups(0)) {
+      __global uchar* src = (__global uchar*)desc[3 * d];
+      __global uchar* dst = (__global uchar*)desc[3 * d + 1];
+      ulong size = desc[3 * d + 2];
+      ulong id = get_local_id(0);
+      ulong stride = get_local_size(0);
+      if ((((ulong)src | (ulong)dst | size) & (sizeof(ulong2) - 1)) == 0) {
+        __global ulong2* srcD = (__global ulong2*)(src);
+        __global ulong2* dstD = (__global ulong2*)(dst);
+        for (ulong i = id; i < size / sizeof(ulong2); i += stride) {
+          dstD[i] = srcD[i];
+        }
+      } else if ((((ulong)src | (ulong)dst | size) & (sizeof(uint) - 1)) == 0) {
+        __global uint* srcD = (__global uint*)(src);
+        __global uint* dstD = (__global uint*)(dst);
+        for (ulong i = id; i < size / sizeof(uint); i += stride) {
+          dstD[i] = srcD[i];
+        }
+      } else {
+        for (ulong i = id; i < size; i += stride) {
+          dst[i] = src[i];
+        }
+      }
+    }
+  }
+
+  __kernel void __amd_rocclr_fillBufferBatch(__global ulong* desc, uint count) {
+    // Each workgroup walks the descriptors {dst, value, size} with a stride of the grid
+    for (uint d = get_group_id(0); d < count; d += get_num_groups(0)) {
+      __global uchar* dst = (__global uchar*)desc[3 * d];
+      uchar value = (uchar)desc[3 * d + 1];
+      ulong size = desc[3 * d + 2];
+      ulong id = get_local_id(0);
+      ulong stride = get_local_size(0);
+      if ((((ulong)dst | size) & (sizeof(ulong2) - 1)) == 0) {
+        ulong pattern = (ulong)value * 0x0101010101010101UL;
+        __global ulong2* dstD = (__global ulong2*)(dst);
+        for (ulong i = id; i < size / sizeof(ulong2); i += stride) {
+          dstD[i] = (ulong2)(pattern, pattern);
+        }
+      } else if ((((ulong)dst | size) & (sizeof(uint) - 1)) == 0) {
+        uint pattern = (uint)value * 0x01010101U;
+        __global uint* dstD = (__global uint*)(dst);
+        for (ulong i = id; i < size / sizeof(uint); i += stride) {
+          dstD[i] = pattern;
+        }
+      } else {
+        for (ulong i = id; i < size; i += stride) {
+          dst[i] = value;
+        }
+      }
+    }
+  }
+
+  __kernel void __amd_rocclr_graphCondition(ulong predicate, ulong graph, ulong queue,
+                                            ulong signal, uint loop) {
+    // The leading fields of hsa_queue_t: base address, doorbell and size in packets
+    __global ulong* hsaQueue = (__global ulong*)queue;
+    __global ulong* ring = (__global ulong*)hsaQueue[1];
+    __amd_signal_t doorbell = { hsaQueue[2] };
+    ulong size = ((__global uint*)queue)[6];
+    __amd_signal_t done = { signal };
+    // The device graph header keeps the number of packets and is followed by the packets
+    __global ulong* packets = (__global ulong*)graph;
+    uint count = (uint)packets[0];
+    packets += 8;
+    // Barrier AND packet, which decrements the signal after the body
+    uint barrier = 3 | (1 << 8) | (2 << 9) | (2 << 11);
+    while (true) {
+      uint value = *(volatile __global uint*)predicate;
+      __builtin_amdgcn_fence(__ATOMIC_ACQUIRE, "");
+      if (value == 0) {
+        break;
+      }
+      __ockl_hsa_signal_store(done, 1, __ATOMIC_RELAXED);
+      ulong index = __ockl_hsa_queue_add_write_index(hsaQueue, count + 1, __ATOMIC_RELAXED);
+      ulong read = __ockl_hsa_queue_load_read_index(hsaQueue, __ATOMIC_ACQUIRE);
+      for (uint i = 0; i <= count; ++i) {
+        // Publish the written packets and wait for a free slot
+        while ((index + i - read) >= size) {
+          if (i != 0) {
+            __ockl_hsa_signal_store(doorbell, index + i - 1, __ATOMIC_RELEASE);
+          }
+          __builtin_amdgcn_s_sleep(1);
+          read = __ockl_hsa_queue_load_read_index(hsaQueue, __ATOMIC_ACQUIRE);
+        }
+        __global ulong* dst = ring + ((index + i) & (size - 1)) * 8;
+        uint header = barrier;
+        // Bytes 4-7 of the first qword, i.e. workgroup_size_x/y of a dispatch packet
+        uint rest = 0;
+        if (i < count) {
+          for (uint j = 1; j < 8; ++j) {
+            dst[j] = packets[i * 8 + j];
+          }
+          header = (uint)packets[i * 8];
+          rest = (uint)(packets[i * 8] >> 32);
+        } else {
+          for (uint j = 1; j < 7; ++j) {
+            dst[j] = 0;
+          }
+          dst[7] = signal;
+        }
+        ((__global uint*)dst)[1] = rest;
+        // The header makes the packet valid, hence write it last
+        __builtin_amdgcn_fence(__ATOMIC_RELEASE, "");
+        *(volatile __global uint*)dst = header;
+      }
+      __ockl_hsa_signal_store(doorbell, index + count, __ATOMIC_RELEASE);
+      while (__ockl_hsa_signal_load(done, __ATOMIC_ACQUIRE) != 0) {
+        __builtin_amdgcn_s_sleep(1);
+      }
+      if (loop == 0) {
+        break;
+      }
+    }
+  }
 );
 
 const char* HipExtraSourceCode = BLIT_KERNELS(
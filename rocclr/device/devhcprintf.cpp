@@ -248,29 +248,18 @@ void handlePrintf(uint64_t* output, const uint64_t* input, uint64_t len) {
   *output = format(stream, input, end);
 }
 
-// Extract the format string hash and the format string.
-// The compiler generates the amdhsa.printf metadata in
-// following format for HIP nonhostcall case.
-//    "0:0:<format_string_hash>,<actual_format_string>"
-// i.e the hash is part of the format string itself
-// delimited by character ','.
-bool populateFormatStringHashMap(
-    const std::vector<device::PrintfInfo> &printfInfo,
-    std::map<uint64_t, std::string> &strMap) {
-  for (auto it : printfInfo) {
-    auto Delim = it.fmtString_.find_first_of(',');
-    auto HashStr = it.fmtString_.substr(0, Delim);
-
-    static_assert(sizeof(long long) == sizeof(uint64_t), "unexpected long long type width");
-    auto HashVal = std::strtoull(HashStr.c_str(), NULL, 16);
-    if (strMap.find(HashVal) != strMap.end()) {
-      LogError("Hash value collision detected, printf buffer ill formed");
-      return false;
+// Find the printf info of the format string hash, reported by the device
+// for the HIP nonhostcall case.
+const device::PrintfInfo* findPrintfInfo(const std::vector<device::PrintfInfo>& printfInfo,
+                                         uint64_t hash) {
+  // A kernel has only a few printf calls, so a linear search beats a map.
+  // The hashes were parsed and checked for collisions at the kernel load.
+  for (const auto& it : printfInfo) {
+    if (it.hash_ == hash) {
+      return &it;
     }
-    strMap[HashVal] = it.fmtString_.substr(Delim + 1, it.fmtString_.size());
   }
-
-  return true;
+  return nullptr;
 }
 
 void handlePrintfDelayed(const uint64_t* input, uint64_t len, uint64_t control)
@@ -21,6 +21,7 @@
 #include "utils/debug.hpp"
 #include "top.hpp"
 #include "utils/flags.hpp"
+#include "utils/metrics.hpp"
 
 #include "device/devhcmessages.hpp"
 #include "device/devhostcall.hpp"
@@ -34,6 +35,9 @@
 
 #include <assert.h>
 #include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <map>
 #include <set>
 
 #if defined(__clang__)
@@ -73,7 +77,52 @@ static uint32_t resetReadyFlag(uint32_t control) {
  */
 typedef void (*HostcallFunctionCall)(uint64_t* output, const uint64_t* input);
 
-static void handlePayload(MessageHandler& messages, uint32_t service, uint64_t* payload, const amd::Device &dev) {
+/** \brief Keep the device heap slabs, freed by the kernels, for the next growth.
+ *
+ *  The device library grows its heap with fixed size slabs, so a kernel, which
+ *  repeatedly allocates and frees, would otherwise create and destroy device
+ *  memory on every call. The cache is bounded by DEBUG_CLR_DEVMEM_CACHE_SIZE.
+ */
+class DevmemCache {
+ public:
+  ~DevmemCache() {
+    for (auto& it : slabs_) {
+      it.second->release();
+    }
+  }
+
+  //! Returns a cached slab of the exact size or nullptr
+  amd::Memory* acquire(const amd::Device& dev, size_t size) {
+    auto it = slabs_.find({&dev, size});
+    if (it == slabs_.end()) {
+      return nullptr;
+    }
+    amd::Memory* mem = it->second;
+    slabs_.erase(it);
+    cachedSize_ -= size;
+    return mem;
+  }
+
+  //! Keeps the slab in the cache if it fits, otherwise destroys it
+  void release(const amd::Device& dev, amd::Memory* mem) {
+    const size_t size = mem->getSize();
+    // Sub-buffers of a batched allocation keep the whole allocation alive, hence destroy them
+    if ((mem->parent() != nullptr) || ((cachedSize_ + size) > DEBUG_CLR_DEVMEM_CACHE_SIZE * Mi)) {
+      mem->release();
+      return;
+    }
+    slabs_.insert({{&dev, size}, mem});
+    cachedSize_ += size;
+  }
+
+ private:
+  //! The cached slabs. Accessed by the listener thread only
+  std::multimap<std::pair<const amd::Device*, size_t>, amd::Memory*> slabs_;
+  size_t cachedSize_ = 0;  //!< Total size of the cached slabs
+};
+
+static void handlePayload(MessageHandler& messages, DevmemCache& devmem, uint32_t service,
+                          uint64_t* payload, const amd::Device &dev) {
   switch (service) {
     case SERVICE_FUNCTION_CALL: {
       uint64_t output[2];
@@ -95,15 +144,22 @@ static void handlePayload(MessageHandler& messages, uint32_t service, uint64_t*
         amd::Memory* mem = amd::MemObjMap::FindMemObj(reinterpret_cast<void*>(payload[0]));
         if (mem) {
           amd::MemObjMap::RemoveMemObj(reinterpret_cast<void*>(payload[0]));
-          mem->release();
+          devmem.release(dev, mem);
         } else {
           ClPrint(amd::LOG_ERROR, amd::LOG_ALWAYS, "Hostcall: Unknown pointer %p in devmem service",
                   payload[0]);
         }
       } else {
+        uint64_t va = 0;
+        amd::Memory* cached = devmem.acquire(dev, payload[1]);
+        if (cached != nullptr) {
+          va = cached->getDeviceMemory(dev)->virtualAddress();
+          amd::MemObjMap::AddMemObj(reinterpret_cast<void*>(va), cached);
+          payload[0] = va;
+          return;
+        }
         amd::Context& ctx = dev.context();
         amd::Buffer* buf = new(ctx) amd::Buffer(ctx, CL_MEM_READ_WRITE, payload[1]);
-        uint64_t va = 0;
         if (buf) {
           if (buf->create()) {
             device::Memory* dm = buf->getDeviceMemory(dev);
@@ -123,16 +179,96 @@ static void handlePayload(MessageHandler& messages, uint32_t service, uint64_t*
   }
 }
 
-void HostcallBuffer::processPackets(MessageHandler& messages) {
+/** \brief Serve the device malloc requests of all active work-items in a wave
+ *         with a single device allocation.
+ *
+ *  Every work-item gets a sub-buffer of the shared allocation, so the
+ *  allocation is released when the last work-item frees its pointer.
+ *  Returns false if the packet should be served one work-item at a time.
+ */
+static bool handleDevmemBatch(DevmemCache& devmem, Payload* payload, uint64_t activemask,
+                              const amd::Device& dev) {
+  if (!DEBUG_CLR_HOSTCALL_BATCH_DEVMEM) {
+    return false;
+  }
+  const size_t alignment = std::max(dev.info().memBaseAddrAlign_ / 8, 256U);
+  uint32_t lanes[sizeof(activemask) * 8];
+  size_t offsets[sizeof(activemask) * 8];
+  uint32_t numLanes = 0;
+  size_t totalSize = 0;
+  for (auto mask = activemask; mask != 0;) {
+    auto wi = amd::leastBitSet(mask);
+    mask ^= static_cast<decltype(mask)>(1) << wi;
+    uint64_t* slot = payload->slots[wi];
+    if (slot[0] == 0) {
+      lanes[numLanes] = wi;
+      offsets[numLanes++] = totalSize;
+      totalSize += amd::alignUp(slot[1], alignment);
+    }
+  }
+  // Frees and a single allocation don't benefit from the batching
+  if (numLanes < 2) {
+    return false;
+  }
+
+  amd::Context& ctx = dev.context();
+  amd::Buffer* parent = new (ctx) amd::Buffer(ctx, CL_MEM_READ_WRITE, totalSize);
+  if ((parent == nullptr) || !parent->create()) {
+    if (parent != nullptr) {
+      parent->release();
+    }
+    // Fall back to the separate allocations, which may still fit
+    return false;
+  }
+  for (uint32_t i = 0; i < numLanes; ++i) {
+    uint64_t* slot = payload->slots[lanes[i]];
+    uint64_t va = 0;
+    amd::Buffer* buf = new (ctx) amd::Buffer(*parent, CL_MEM_READ_WRITE, offsets[i], slot[1]);
+    if (buf != nullptr) {
+      if (buf->create()) {
+        va = buf->getDeviceMemory(dev)->virtualAddress();
+        amd::MemObjMap::AddMemObj(reinterpret_cast<void*>(va), buf);
+      } else {
+        buf->release();
+      }
+    }
+    slot[0] = va;
+  }
+  // The sub-buffers keep the allocation alive
+  parent->release();
+
+  // Serve the remaining frees in the wave
+  for (auto mask = activemask; mask != 0;) {
+    auto wi = amd::leastBitSet(mask);
+    mask ^= static_cast<decltype(mask)>(1) << wi;
+    uint64_t* slot = payload->slots[wi];
+    if ((slot[0] != 0) && (std::find(lanes, lanes + numLanes, wi) == (lanes + numLanes))) {
+      amd::Memory* mem = amd::MemObjMap::FindMemObj(reinterpret_cast<void*>(slot[0]));
+      if (mem) {
+        amd::MemObjMap::RemoveMemObj(reinterpret_cast<void*>(slot[0]));
+        devmem.release(dev, mem);
+      } else {
+        ClPrint(amd::LOG_ERROR, amd::LOG_ALWAYS, "Hostcall: Unknown pointer %p in devmem service",
+                slot[0]);
+      }
+    }
+  }
+  return true;
+}
+
+uint32_t HostcallBuffer::processPackets(MessageHandler& messages, DevmemCache& devmem) {
   // Grab the entire ready stack and set the top to 0. New requests from the
   // device will continue pushing on the stack while we process the packets that
   // we have grabbed.
 
   uint64_t ready_stack = std::atomic_exchange_explicit(&ready_stack_, static_cast<uint64_t>(0), std::memory_order_acquire);
   if (!ready_stack) {
-    return;
+    return 0;
   }
 
+  uint32_t count = 0;
+  const uint64_t start = amd::Os::timeNanos();
+
   // Each wave can submit at most one packet at a time. The ready stack cannot
   // contain multiple packets from the same wave, so consuming ready packets in
   // a latest-first order does not affect ordering of hostcall within a wave.
@@ -155,15 +291,23 @@ void HostcallBuffer::processPackets(MessageHandler& messages) {
     }
 #endif
 #endif
+    if ((service == SERVICE_DEVMEM) && handleDevmemBatch(devmem, payload, activemask, *device_)) {
+      // The whole wave was served at once
+      activemask = 0;
+    }
     while (activemask) {
       auto wi = amd::leastBitSet(activemask);
       activemask ^= static_cast<decltype(activemask)>(1) << wi;
       auto slot = payload->slots[wi];
-      handlePayload(messages, service, slot, *device_);
+      handlePayload(messages, devmem, service, slot, *device_);
     }
 
     header->control_.store(resetReadyFlag(header->control_), std::memory_order_release);
+    ++count;
   }
+  served_packets_.fetch_add(count, std::memory_order_relaxed);
+  listener_time_.fetch_add(amd::Os::timeNanos() - start, std::memory_order_relaxed);
+  return count;
 }
 
 static uintptr_t getHeaderStart() {
@@ -215,14 +359,24 @@ void HostcallBuffer::initialize(uint32_t num_packets) {
   }
   free_stack_ = next;
   ready_stack_ = 0;
+  served_packets_ = 0;
+  listener_time_ = 0;
 }
 
-/** \brief Manage a unique listener thread and its associated buffers.
+/** \brief Manage a listener thread and its associated buffers.
+ *
+ *  With DEBUG_CLR_HOSTCALL_PER_DEVICE every device has its own listener, so the
+ *  hostcall throughput scales with the number of GPUs.
  */
 class HostcallListener {
   std::set<HostcallBuffer*> buffers_;
+  amd::Monitor lock_{"Hostcall buffers lock"};  //!< Guards buffers_ against the processing
+  const amd::Device* device_ = nullptr;  //!< The device of the first registered buffer
   device::Signal* doorbell_;
   MessageHandler messages_;
+  DevmemCache devmem_;  //!< Freed device heap slabs of the listener's devices
+  uint64_t wakeups_ = 0;  //!< The number of doorbell wakeups
+  uint64_t packets_ = 0;  //!< The number of served packets
   // Keep track of devices for which signal creation have already been done
   std::set<const amd::Device*> devices_;
 #if defined(__clang__)
@@ -237,12 +391,18 @@ class HostcallListener {
     //! The hostcall listener thread entry point.
     void run(void* data) {
       auto listener = reinterpret_cast<HostcallListener*>(data);
+      if (ROC_NUMA_AFFINITY && DEBUG_CLR_HOSTCALL_PER_DEVICE) {
+        Os::setThreadNumaNode(listener->device_->getPreferredNumaNode());
+      }
       listener->consumePackets();
     }
   } thread_;  //!< The hostcall listener thread.
 
   void consumePackets();
 
+  //! Serves the ready packets of all buffers and returns their number
+  uint32_t drainBuffers();
+
  public:
   /** \brief Add a buffer to the listener.
    *
@@ -263,7 +423,8 @@ class HostcallListener {
 
   /* \brief Return true if no buffers are registered.
   */
-  bool idle() const {
+  bool idle() {
+    amd::ScopedLock lock(lock_);
     return buffers_.empty();
   }
 
@@ -272,36 +433,40 @@ class HostcallListener {
   bool initDevice(const amd::Device &dev);
 };
 
-HostcallListener* hostcallListener = nullptr;
+//! The active listeners, keyed by the device or by nullptr for a single process wide listener
+std::map<const amd::Device*, HostcallListener*> hostcallListeners;
 extern amd::Monitor listenerLock;
+
+static const amd::Device* listenerKey(const amd::Device& dev) {
+  return DEBUG_CLR_HOSTCALL_PER_DEVICE ? &dev : nullptr;
+}
 constexpr static uint64_t kTimeoutFloor = K * K * 4;
 constexpr static uint64_t kTimeoutCeil = K * K * 16;
 static struct Init {
-  enum class State {
-    kDefault = 0,
-    kInit,
-    kDestroy,
-    kExit
-  };
-  volatile State state = State::kDefault;
+  std::atomic<uint32_t> active_{0};   //!< The number of running listener threads
+  std::atomic<bool> destroy_{false};  //!< The process is exiting
   ~Init() {
-    if (state == State::kInit) {
-      state = State::kDestroy;
-      // @note: Under Linux thread destruction can be delayed and
-      // ROCR may crash in a wait for event occasionally. Hence, runtime needs
-      // an early exit. The logic isn't required for Windows.
-      while (IS_LINUX && (state == State::kDestroy)) {}
-    }
+    destroy_ = true;
+    // @note: Under Linux thread destruction can be delayed and
+    // ROCR may crash in a wait for event occasionally. Hence, runtime needs
+    // an early exit. The logic isn't required for Windows.
+    while (IS_LINUX && (active_ != 0)) {}
   }
 } kHostThreadActive;
+
+//! Keeps the listener thread accounted while it runs
+struct ListenerActive {
+  ListenerActive() { kHostThreadActive.active_++; }
+  ~ListenerActive() { kHostThreadActive.active_--; }
+};
+
 void HostcallListener::consumePackets() {
   uint64_t timeout = kTimeoutFloor;
   uint64_t signal_value = SIGNAL_INIT;
-  kHostThreadActive.state = Init::State::kInit;
+  ListenerActive active;
   while (true) {
     while (true) {
-      if (kHostThreadActive.state == Init::State::kDestroy) {
-        kHostThreadActive.state = Init::State::kExit;
+      if (kHostThreadActive.destroy_) {
         return;
       }
       uint64_t new_value = doorbell_->Wait(signal_value, device::Signal::Condition::Ne, timeout);
@@ -321,29 +486,55 @@ void HostcallListener::consumePackets() {
       return;
     }
 
-    if (!idle()) {
-      amd::ScopedLock lock{listenerLock};
-
-      for (auto ii : buffers_) {
-        ii->processPackets(messages_);
+    ++wakeups_;
+    uint64_t packets = drainBuffers();
+
+    // Bursts of hostcalls from many waves ring the doorbell back to back. Keep polling
+    // the buffers for a short window, so the burst is served without a wakeup per call
+    if (DEBUG_CLR_HOSTCALL_SPIN_US != 0) {
+      const uint64_t end = amd::Os::timeNanos() + DEBUG_CLR_HOSTCALL_SPIN_US * K;
+      while (!kHostThreadActive.destroy_ && (amd::Os::timeNanos() < end)) {
+        uint32_t served = drainBuffers();
+        if (served != 0) {
+          packets += served;
+          continue;
+        }
+        amd::Os::spinPause();
       }
     }
+    packets_ += packets;
+    amd::Metrics::add(amd::Metrics::HostcallWakeups);
+    amd::Metrics::add(amd::Metrics::HostcallPackets, packets);
   }
 
   return;
 }
 
+uint32_t HostcallListener::drainBuffers() {
+  amd::ScopedLock lock{lock_};
+  uint32_t served = 0;
+  for (auto ii : buffers_) {
+    if (ii->hasReadyPackets()) {
+      served += ii->processPackets(messages_, devmem_);
+    }
+  }
+  return served;
+}
+
 void HostcallListener::terminate() {
   if (!amd::Os::isThreadAlive(thread_)) {
     return;
   }
-  kHostThreadActive.state = Init::State::kExit;
   doorbell_->Reset(SIGNAL_DONE);
 
   // FIXME_lmoriche: fix termination handshake
   while (thread_.state() < Thread::FINISHED) {
     amd::Os::yield();
   }
+  ClPrint(amd::LOG_INFO, amd::LOG_QUEUE,
+          "Hostcall listener %p served %llu packets in %llu wakeups (%.1f per wakeup)", this,
+          packets_, wakeups_,
+          (wakeups_ != 0) ? static_cast<double>(packets_) / wakeups_ : 0.0);
 
 #if defined(__clang__)
 #if __has_feature(address_sanitizer)
@@ -355,6 +546,7 @@ void HostcallListener::terminate() {
 }
 
 void HostcallListener::addBuffer(HostcallBuffer* buffer) {
+  amd::ScopedLock lock(lock_);
   assert(buffers_.count(buffer) == 0 && "buffer already present");
   buffer->setDoorbell(doorbell_->getHandle());
 #if defined(__clang__)
@@ -366,11 +558,13 @@ void HostcallListener::addBuffer(HostcallBuffer* buffer) {
 }
 
 void HostcallListener::removeBuffer(HostcallBuffer* buffer) {
+  amd::ScopedLock lock(lock_);
   assert(buffers_.count(buffer) != 0 && "unknown buffer");
   buffers_.erase(buffer);
 }
 
 bool HostcallListener::initSignal(const amd::Device &dev) {
+  device_ = &dev;
   doorbell_ = dev.createSignal();
   initDevice(dev);
 #if defined(__clang__)
@@ -417,13 +611,14 @@ bool enableHostcalls(const amd::Device &dev, void* bfr, uint32_t numPackets) {
   buffer->setDevice(&dev);
 
   amd::ScopedLock lock(listenerLock);
+  HostcallListener*& hostcallListener = hostcallListeners[listenerKey(dev)];
   if (!hostcallListener) {
     hostcallListener = new HostcallListener();
     if (!hostcallListener->initSignal(dev)) {
       ClPrint(amd::LOG_ERROR, (amd::LOG_INIT | amd::LOG_QUEUE | amd::LOG_RESOURCE),
               "Failed to launch hostcall listener");
       delete hostcallListener;
-      hostcallListener = nullptr;
+      hostcallListeners.erase(listenerKey(dev));
       return false;
     }
     ClPrint(amd::LOG_INFO, (amd::LOG_INIT | amd::LOG_QUEUE | amd::LOG_RESOURCE),
@@ -445,20 +640,24 @@ bool enableHostcalls(const amd::Device &dev, void* bfr, uint32_t numPackets) {
 }
 
 void disableHostcalls(void* bfr) {
+  HostcallListener* hostcallListener = nullptr;
   {
     amd::ScopedLock lock(listenerLock);
-    if (!hostcallListener) {
-      return;
-    }
     assert(bfr && "expected a hostcall buffer");
     auto buffer = reinterpret_cast<HostcallBuffer*>(bfr);
+    auto it = hostcallListeners.find(listenerKey(*buffer->getDevice()));
+    if (it == hostcallListeners.end()) {
+      return;
+    }
+    hostcallListener = it->second;
     hostcallListener->removeBuffer(buffer);
+    if (!hostcallListener->idle()) {
+      return;
+    }
+    hostcallListeners.erase(it);
   }
-  if (hostcallListener->idle()) {
-    hostcallListener->terminate();
-    delete hostcallListener;
-    hostcallListener = nullptr;
-    ClPrint(amd::LOG_INFO, amd::LOG_INIT, "Terminated hostcall listener");
-  }
+  hostcallListener->terminate();
+  delete hostcallListener;
+  ClPrint(amd::LOG_INFO, amd::LOG_INIT, "Terminated hostcall listener");
 }
 }// namespace amd
@@ -129,6 +129,8 @@ enum ControlWidth {
   CONTROL_WIDTH_RESERVED0 = 31,
 };
 
+class DevmemCache;
+
 /** \brief Shared buffer submitting hostcall requests.
  *
  *  Holds hostcall packets requested by all kernels executing on the
@@ -161,10 +163,18 @@ class HostcallBuffer {
   Payload* getPayload(uint64_t ptr) const;
 
  public:
-  void processPackets(MessageHandler& messages);
+  //! Serves the ready packets and returns their number
+  uint32_t processPackets(MessageHandler& messages, DevmemCache& devmem);
+  //! Returns true if the device pushed packets, which weren't served yet
+  bool hasReadyPackets() const { return ready_stack_.load(std::memory_order_relaxed) != 0; }
   void initialize(uint32_t num_packets);
   void setDoorbell(void* doorbell) { doorbell_ = doorbell; };
   void setDevice(const amd::Device* dptr) { device_ = dptr; };
+  const amd::Device* getDevice() const { return device_; }
+  //! Returns the number of served packets
+  uint64_t servedPackets() const { return served_packets_.load(std::memory_order_relaxed); }
+  //! Returns the time in ns, which the listener spent on the packets of this buffer
+  uint64_t listenerTime() const { return listener_time_.load(std::memory_order_relaxed); }
 
  #if defined(__clang__)
  #if __has_feature(address_sanitizer)
@@ -174,6 +184,11 @@ class HostcallBuffer {
   void setUriLocator(device::UriLocator* uri_l) { uri_locator = uri_l; };
  #endif
  #endif
+
+ private:
+  /** The accounting of the served packets, kept after the device visible fields */
+  std::atomic<uint64_t> served_packets_;
+  std::atomic<uint64_t> listener_time_;
 };
 
 static_assert(std::is_standard_layout<HostcallBuffer>::value,
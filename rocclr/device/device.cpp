@@ -305,17 +305,32 @@ Context* Device::glb_ctx_ = nullptr;
 Monitor Device::p2p_stage_ops_(true);
 Memory* Device::p2p_stage_ = nullptr;
 
-Monitor MemObjMap::AllocatedLock_ ROCCLR_INIT_PRIORITY(101) ("Guards MemObjMap allocation list");
+std::shared_mutex MemObjMap::AllocatedLock_ ROCCLR_INIT_PRIORITY(101);
 std::map<uintptr_t, amd::Memory*> MemObjMap::MemObjMap_ ROCCLR_INIT_PRIORITY(101);
 std::map<uintptr_t, amd::Memory*> MemObjMap::VirtualMemObjMap_ ROCCLR_INIT_PRIORITY(101);
+std::atomic<uint64_t> MemObjMap::Generation_ = 0;
+
+namespace {
+//! Per-thread copy of the last range resolved by MemObjMap::FindMemObj().
+//! Streams usually touch the same allocation many times in a row, so the hit path avoids
+//! the shared lock. The entry is valid only while the map generation is unchanged, which
+//! guarantees the memory object hasn't been removed since it was cached.
+struct MemObjLookupCache {
+  uint64_t generation_ = ~0ULL;  //!< Map generation at the time of the lookup
+  uintptr_t base_ = 0;           //!< Start address of the cached allocation
+  size_t size_ = 0;              //!< Size of the cached allocation
+  amd::Memory* mem_ = nullptr;   //!< Cached memory object
+};
+thread_local MemObjLookupCache memObjLookupCache;
+}  // namespace
 
 size_t MemObjMap::size() {
-  amd::ScopedLock lock(AllocatedLock_);
+  std::shared_lock lock(AllocatedLock_);
   return MemObjMap_.size();
 }
 
 void MemObjMap::AddMemObj(const void* k, amd::Memory* v) {
-  amd::ScopedLock lock(AllocatedLock_);
+  std::unique_lock lock(AllocatedLock_);
   auto rval = MemObjMap_.insert({ reinterpret_cast<uintptr_t>(k), v });
   if (!rval.second) {
     DevLogPrintfError("Memobj map already has an entry for ptr: 0x%x",
@@ -324,15 +339,27 @@ void MemObjMap::AddMemObj(const void* k, amd::Memory* v) {
 }
 
 void MemObjMap::RemoveMemObj(const void* k) {
-  amd::ScopedLock lock(AllocatedLock_);
+  std::unique_lock lock(AllocatedLock_);
   auto rval = MemObjMap_.erase(reinterpret_cast<uintptr_t>(k));
   guarantee(rval == 1, "Memobj map does not have ptr: 0x%x",
                         reinterpret_cast<uintptr_t>(k));
+  Generation_.fetch_add(1, std::memory_order_release);
 }
 
 amd::Memory* MemObjMap::FindMemObj(const void* k, size_t* offset) {
-  amd::ScopedLock lock(AllocatedLock_);
   uintptr_t key = reinterpret_cast<uintptr_t>(k);
+
+  // Fast path: the pointer falls in the allocation found by this thread's last lookup
+  MemObjLookupCache& cache = memObjLookupCache;
+  if ((cache.generation_ == Generation_.load(std::memory_order_acquire)) &&
+      (key >= cache.base_) && (key < (cache.base_ + cache.size_))) {
+    if (offset != nullptr) {
+      *offset = key - cache.base_;
+    }
+    return cache.mem_;
+  }
+
+  std::shared_lock lock(AllocatedLock_);
   auto it = MemObjMap_.upper_bound(key);
   if (it == MemObjMap_.begin()) {
     return nullptr;
@@ -344,6 +371,11 @@ amd::Memory* MemObjMap::FindMemObj(const void* k, size_t* offset) {
     if (offset != nullptr) {
       *offset = key - it->first;
     }
+    // Removals are serialized with the shared lock, hence the generation is stable here
+    cache.generation_ = Generation_.load(std::memory_order_relaxed);
+    cache.base_ = it->first;
+    cache.size_ = mem->getSize();
+    cache.mem_ = mem;
     // the k is in the range
     return mem;
   } else {
@@ -351,7 +383,7 @@ amd::Memory* MemObjMap::FindMemObj(const void* k, size_t* offset) {
   }
 }
 void MemObjMap::AddVirtualMemObj(const void* k, amd::Memory* v) {
-  amd::ScopedLock lock(AllocatedLock_);
+  std::unique_lock lock(AllocatedLock_);
   auto rval = VirtualMemObjMap_.insert({ reinterpret_cast<uintptr_t>(k), v });
   if (!rval.second) {
     DevLogPrintfError("Virtual Memobj map already has an entry for ptr: 0x%x",
@@ -360,14 +392,14 @@ void MemObjMap::AddVirtualMemObj(const void* k, amd::Memory* v) {
 }
 
 void MemObjMap::RemoveVirtualMemObj(const void* k) {
-  amd::ScopedLock lock(AllocatedLock_);
+  std::unique_lock lock(AllocatedLock_);
   auto rval = VirtualMemObjMap_.erase(reinterpret_cast<uintptr_t>(k));
   guarantee(rval == 1, "Virtual Memobj map does not have ptr: 0x%x",
                        reinterpret_cast<uintptr_t>(k));
 }
 
 amd::Memory* MemObjMap::FindVirtualMemObj(const void* k) {
-  amd::ScopedLock lock(AllocatedLock_);
+  std::shared_lock lock(AllocatedLock_);
   uintptr_t key = reinterpret_cast<uintptr_t>(k);
   auto it = VirtualMemObjMap_.upper_bound(key);
   if (it == VirtualMemObjMap_.begin()) {
@@ -499,7 +531,7 @@ void MemObjMap::UpdateAccess(amd::Device *peerDev) {
 
   // Provides access to all memory allocated on peerDev but
   // hsa_amd_agents_allow_access was not called because there was no peer
-  amd::ScopedLock lock(AllocatedLock_);
+  std::shared_lock lock(AllocatedLock_);
   for (auto it : MemObjMap_) {
     const std::vector<Device*>& devices = it.second->getContext().devices();
     if (devices.size() == 1 && devices[0] == peerDev) {
@@ -515,7 +547,8 @@ void MemObjMap::UpdateAccess(amd::Device *peerDev) {
 void MemObjMap::Purge(amd::Device* dev) {
   assert(dev != nullptr);
 
-  amd::ScopedLock lock(AllocatedLock_);
+  std::unique_lock lock(AllocatedLock_);
+  Generation_.fetch_add(1, std::memory_order_release);
   for (auto it = MemObjMap_.cbegin(); it != MemObjMap_.cend(); ) {
     amd::Memory* memObj = it->second;
     unsigned int flags = memObj->getMemFlags();
@@ -529,6 +562,53 @@ void MemObjMap::Purge(amd::Device* dev) {
   }
 }
 
+// ================================================================================================
+//! Blit kernel code object prebuilt for a specific target at packaging time
+struct BlitCodeObject {
+  const char* isaName_;  //!< Target ID the code object was built for
+  uint64_t key_;         //!< Hash of the blit source and the build options
+  const void* image_;    //!< Code object image
+  size_t size_;          //!< Size of the code object image
+};
+
+#if !defined(_WIN32)
+//! Optional table of prebuilt blit code objects, linked in by the packaging step
+extern "C" const BlitCodeObject* __rocclr_blit_code_objects(size_t* count)
+    __attribute__((weak));
+#endif
+
+// ================================================================================================
+static uint64_t blitCodeObjectKey(const std::string& source, const std::string& options) {
+  // FNV-1a, stable across builds so the packaging step can reproduce it
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  auto mix = [&hash](const std::string& str) {
+    for (unsigned char c : str) {
+      hash ^= c;
+      hash *= 0x100000001b3ULL;
+    }
+  };
+  mix(source);
+  mix(options);
+  return hash;
+}
+
+// ================================================================================================
+static const BlitCodeObject* findBlitCodeObject(const std::string& isaName, uint64_t key) {
+#if !defined(_WIN32)
+  if (GPU_USE_PREBUILT_BLIT_KERNELS && (__rocclr_blit_code_objects != nullptr)) {
+    size_t count = 0;
+    const BlitCodeObject* table = __rocclr_blit_code_objects(&count);
+    for (size_t i = 0; (table != nullptr) && (i < count); ++i) {
+      if ((table[i].key_ == key) && (isaName == table[i].isaName_)) {
+        return &table[i];
+      }
+    }
+  }
+#endif
+  return nullptr;
+}
+
+// ================================================================================================
 Device::BlitProgram::~BlitProgram() {
   if (program_ != nullptr) {
     program_->release();
@@ -551,14 +631,6 @@ bool Device::BlitProgram::create(amd::Device* device, const std::string& extraKe
     kernels += extraKernels;
   }
 
-  // Create a program with all blit kernels
-  program_ = new Program(*context_, kernels.c_str(), Program::OpenCL_C);
-  if (program_ == nullptr) {
-    DevLogPrintfError("Program creation for Kernel: %s failed\n",
-                      kernels.c_str());
-    return false;
-  }
-
   // Build all kernels
   std::string opt = "-cl-internal-kernel ";
   if (!device->settings().useLightning_) {
@@ -579,6 +651,39 @@ bool Device::BlitProgram::create(amd::Device* device, const std::string& extraKe
   opt += " -fsanitize=address ";
 #endif
 #endif
+
+  // Skip the runtime compilation if the packaging step embedded a matching code object
+  const uint64_t key = blitCodeObjectKey(kernels, opt);
+  const BlitCodeObject* prebuilt = GPU_DUMP_BLIT_KERNELS ? nullptr :
+      findBlitCodeObject(device->isa().isaName(), key);
+  if (prebuilt != nullptr) {
+    program_ = new Program(*context_);
+    if ((program_ != nullptr) &&
+        (program_->addDeviceProgram(*device, prebuilt->image_, prebuilt->size_, false) ==
+         CL_SUCCESS) &&
+        (program_->build(devices, opt.c_str(), nullptr, nullptr) == CL_SUCCESS) &&
+        program_->load()) {
+      ClPrint(amd::LOG_INFO, amd::LOG_INIT, "Using prebuilt blit kernels for %s",
+              device->isa().isaName().c_str());
+      return true;
+    }
+    LogPrintfInfo("Prebuilt blit kernels for %s are unusable, compiling the source",
+                  device->isa().isaName().c_str());
+    if (program_ != nullptr) {
+      program_->release();
+    }
+  }
+  ClPrint(amd::LOG_INFO, amd::LOG_INIT, "Compiling blit kernels for %s, key 0x%llx",
+          device->isa().isaName().c_str(), static_cast<unsigned long long>(key));
+
+  // Create a program with all blit kernels
+  program_ = new Program(*context_, kernels.c_str(), Program::OpenCL_C);
+  if (program_ == nullptr) {
+    DevLogPrintfError("Program creation for Kernel: %s failed\n",
+                      kernels.c_str());
+    return false;
+  }
+
   if ((retval = program_->build(devices, opt.c_str(), nullptr, nullptr, GPU_DUMP_BLIT_KERNELS))
       != CL_SUCCESS) {
     DevLogPrintfError("Build failed for Kernel: %s with error code %d\n",
@@ -880,8 +985,10 @@ bool Device::enableP2P(amd::Device* ptrDev) {
   if (std::find(enabled_p2p_devices_.begin(), enabled_p2p_devices_.end(), peerDev) ==
       enabled_p2p_devices_.end()) {
     enabled_p2p_devices_.push_back(peerDev);
-    // Update access to all old allocations
-    amd::MemObjMap::UpdateAccess(static_cast<amd::Device*>(this));
+    if (!ROC_P2P_LAZY_ACCESS) {
+      // Update access to all old allocations
+      amd::MemObjMap::UpdateAccess(static_cast<amd::Device*>(this));
+    }
   }
   return true;
 }
@@ -45,6 +45,7 @@
 #endif
 #endif
 
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
@@ -53,6 +54,7 @@
 #include <vector>
 #include <map>
 #include <mutex>
+#include <shared_mutex>
 #include <list>
 #include <set>
 #include <unordered_set>
@@ -92,6 +94,10 @@ class SvmUnmapMemoryCommand;
 class SvmPrefetchAsyncCommand;
 class StreamOperationCommand;
 class VirtualMapCommand;
+class CopyMemoryBatchCommand;
+class FillMemoryBatchCommand;
+class GraphConditionCommand;
+class CopyFileToMemoryCommand;
 class ExternalSemaphoreCmd;
 class Isa;
 class Device;
@@ -184,6 +190,8 @@ enum OclExtensions {
   ClKhrMipMapImageWrites,
   ClAmdCopyBufferP2P,
   ClAmdAssemblyProgram,
+  ClKhrCommandBuffer,
+  ClKhrPriorityHints,
 #if defined(_WIN32)
   ClAmdPlanarYuv,
 #endif
@@ -227,6 +235,8 @@ static constexpr const char* OclExtensionsString[] = {"cl_khr_fp64 ",
                                             "cl_khr_mipmap_image_writes ",
                                             "cl_amd_copy_buffer_p2p ",
                                             "cl_amd_assembly_program ",
+                                            "cl_khr_command_buffer ",
+                                            "cl_khr_priority_hints ",
 #if defined(_WIN32)
                                             "cl_amd_planar_yuv",
 #endif
@@ -933,6 +943,9 @@ class Memory : public amd::HeapObject {
     }
   }
 
+  //! Returns the page size, achieved by the allocation. 0 if the backend doesn't track it
+  size_t pageSize() const { return pageSize_; }
+
   //! Set access to the memory in this device.
   void SetAccess(MemAccess memAccess) { memAccess_ = memAccess; }
 
@@ -948,7 +961,8 @@ class Memory : public amd::HeapObject {
     HostMemoryRegistered = 0x00000010,    //!< Host memory was registered
     MemoryCpuUncached = 0x00000020,       //!< Memory is uncached on CPU access(slow read)
     AllowedPeerAccess = 0x00000040,       //!< Memory can be accessed from peer
-    PersistentMap = 0x00000080            //!< Map Peristent memory
+    PersistentMap = 0x00000080,           //!< Map Peristent memory
+    SubAllocatedMemory = 0x00000100       //!< Memory is a block of a larger device chunk
   };
   uint flags_;  //!< Memory object flags
 
@@ -974,6 +988,7 @@ class Memory : public amd::HeapObject {
   virtual void decIndMapCount() {}
 
   size_t size_;  //!< Memory size
+  size_t pageSize_ = 0;  //!< Page size, achieved by the allocation with a large page hint
 
  private:
   //! Disable default copy constructor
@@ -1260,6 +1275,61 @@ class ThreadTrace : public amd::HeapObject {
   ThreadTrace& operator=(const ThreadTrace&);
 };
 
+//! Histogram of latencies with power of 2 buckets
+struct LatencyHistogram {
+  static constexpr uint32_t kNumBuckets = 40;  //!< The last bucket covers 2^39 ns and above
+  uint64_t count_ = 0;                         //!< The number of samples
+  uint64_t sum_ = 0;                           //!< Sum of all samples (ns)
+  uint64_t min_ = std::numeric_limits<uint64_t>::max();  //!< The smallest sample (ns)
+  uint64_t max_ = 0;                           //!< The largest sample (ns)
+  std::array<uint64_t, kNumBuckets> buckets_ = {};  //!< Bucket i counts [2^i, 2^(i+1)) ns
+
+  void add(uint64_t ns) {
+    count_++;
+    sum_ += ns;
+    min_ = std::min(min_, ns);
+    max_ = std::max(max_, ns);
+    uint32_t bucket = (ns == 0) ? 0 : amd::log2(ns);
+    buckets_[std::min(bucket, kNumBuckets - 1)]++;
+  }
+
+  //! Returns the upper bound of the bucket, which holds the requested percentile (ns)
+  uint64_t percentile(uint32_t pct) const {
+    uint64_t target = (count_ * pct + 99) / 100;
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < kNumBuckets; ++i) {
+      total += buckets_[i];
+      if ((total >= target) && (total != 0)) {
+        return std::min(max_, (uint64_t(2) << i) - 1);
+      }
+    }
+    return max_;
+  }
+};
+
+//! Dispatch latencies and host service costs of a kernel
+struct DispatchStats {
+  LatencyHistogram enqueueToDoorbell_;  //!< From the submission to the doorbell write
+  LatencyHistogram doorbellToStart_;    //!< From the doorbell write to the kernel start
+  LatencyHistogram duration_;           //!< The kernel execution time
+  uint64_t hostcallPackets_ = 0;        //!< Hostcall packets, served by the listener
+  uint64_t hostcallTime_ = 0;           //!< Time in ns, the listener spent on the packets
+  uint64_t printfBytes_ = 0;            //!< Bytes of the buffered printf output
+  uint64_t counterSamples_ = 0;         //!< The number of dispatches with counter samples
+  std::vector<uint64_t> counters_;      //!< Sums of the ROC_KERNEL_COUNTERS values
+};
+
+//! Dispatch latencies, indexed by the kernel name
+typedef std::map<std::string, DispatchStats> DispatchStatsMap;
+
+//! GPU idle time between the back to back kernels of a queue
+struct IdleGapStats {
+  LatencyHistogram gaps_;      //!< From the end of a kernel to the start of the next one
+  uint64_t busyTime_ = 0;      //!< Time in ns, the queue executed kernels
+  uint64_t hostBound_ = 0;     //!< Gaps, which ended after the doorbell of the next kernel
+  uint64_t hostBoundTime_ = 0; //!< Idle time in ns, until the doorbell of the next kernel
+};
+
 //! A device execution environment.
 class VirtualDevice : public amd::HeapObject {
  public:
@@ -1308,9 +1378,32 @@ class VirtualDevice : public amd::HeapObject {
   }
   virtual void submitStreamOperation(amd::StreamOperationCommand& cmd) { ShouldNotReachHere(); }
   virtual void submitVirtualMap(amd::VirtualMapCommand& cmd) { ShouldNotReachHere(); }
+  virtual void submitCopyMemoryBatch(amd::CopyMemoryBatchCommand& cmd) { ShouldNotReachHere(); }
+  virtual void submitFillMemoryBatch(amd::FillMemoryBatchCommand& cmd) { ShouldNotReachHere(); }
+  virtual void submitGraphCondition(amd::GraphConditionCommand& cmd) { ShouldNotReachHere(); }
+  virtual void submitCopyFileToMemory(amd::CopyFileToMemoryCommand& cmd) { ShouldNotReachHere(); }
 
   virtual address allocKernelArguments(size_t size, size_t alignment) { return nullptr; }
 
+  //! Defers the doorbell writes of the calling thread until EndDoorbellBatch(),
+  //! so a series of dispatches is exposed to the HW with a single doorbell.
+  //! Must be called under the execution lock
+  virtual void BeginDoorbellBatch() {}
+  //! Rings the doorbell once for all dispatches deferred since BeginDoorbellBatch()
+  virtual void EndDoorbellBatch() {}
+  //! Rings any deferred doorbell. Must be called under the execution lock
+  virtual void RingDeferredDoorbell() {}
+
+  //! Changes the CU mask of the queue, created with a custom CU mask, in place.
+  //! Must be called under the execution lock
+  virtual bool SetCUMask(const std::vector<uint32_t>& cuMask) { return false; }
+
+  //! Returns the dispatch latency histograms, collected on this virtual device
+  virtual void GetDispatchStats(DispatchStatsMap& stats) const {}
+
+  //! Returns the idle gaps between the kernels of this virtual device, ROC_IDLE_GAP_STATS
+  virtual void GetIdleGapStats(IdleGapStats& stats) const {}
+
   //! Get the blit manager object
   device::BlitManager& blitMgr() const { return *blitMgr_; }
 
@@ -1375,12 +1468,15 @@ class MemObjMap : public AllStatic {
   static void RemoveVirtualMemObj(const void* k);  //!< Same as RemoveMemObj but for virtual addressing
   static amd::Memory* FindVirtualMemObj(
       const void* k);  //!< Same as FindMemObj but for virtual addressing
+  //! Returns the generation of the map. Memory objects found with the same generation are alive
+  static uint64_t Generation() { return Generation_.load(std::memory_order_acquire); }
  private:
   static std::map<uintptr_t, amd::Memory*>
       MemObjMap_;                      //!< the mem object<->hostptr information container
   static std::map<uintptr_t, amd::Memory*>
       VirtualMemObjMap_;               //!< the virtual mem object<->hostptr information container
-  static amd::Monitor AllocatedLock_;  //!< amd monitor locker
+  static std::shared_mutex AllocatedLock_;  //!< Shared for lookups, exclusive for updates
+  static std::atomic<uint64_t> Generation_;  //!< Bumped on every removal from MemObjMap_
 };
 
 /// @brief Instruction Set Architecture properties.
@@ -1606,6 +1702,7 @@ class Device : public RuntimeObject {
     uint64_t all_sum;
     struct MGSyncData sgs;
     uint num_wg;
+    uint32_t* barrier;  //!< Hierarchical grid barrier, nullptr for the device library barrier
   };
 
   //Attributes that could be retrived from hsa_amd_memory_pool_link_info_t.
@@ -1641,7 +1738,7 @@ class Device : public RuntimeObject {
   static constexpr size_t kP2PStagingSize = 4 * Mi;
   static constexpr size_t kMGSyncDataSize = sizeof(MGSyncData);
   static constexpr size_t kMGInfoSizePerDevice = kMGSyncDataSize + sizeof(MGSyncInfo);
-  static constexpr size_t kSGInfoSize = kMGSyncDataSize;
+  static constexpr size_t kSGInfoSize = sizeof(MGSyncInfo);
 
   typedef std::list<CommandQueue*> CommandQueues;
 
@@ -1879,6 +1976,24 @@ class Device : public RuntimeObject {
    */
   virtual bool SetMemAccess(void* va_addr, size_t va_size, VmmAccess access_flags) = 0;
 
+  /**
+   * Set Access permisions of several devices for a virtual memory object at once.
+   * The default implementation updates the devices one by one.
+   *
+   * @param va_addr Virtual Address ptr
+   * @param va_size Virtual Address Size
+   * @param access Devices and their access permissions
+   */
+  virtual bool SetMemAccessBatch(void* va_addr, size_t va_size,
+                                 const std::vector<std::pair<Device*, VmmAccess>>& access) {
+    for (const auto& it : access) {
+      if (!it.first->SetMemAccess(va_addr, va_size, it.second)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   /**
    * Get Access permisions for a virtual memory object.
    *
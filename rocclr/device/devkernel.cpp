@@ -32,6 +32,7 @@
 #include "comgrctx.hpp"
 
 #include <map>
+#include <set>
 #include <string>
 #include <sstream>
 
@@ -670,15 +671,48 @@ bool Kernel::createSignature(
   // (offline devices path)
   delete signature_;
   signature_ = new amd::KernelSignature(params, attribs.str(), numParameters, version);
-  if (NULL != signature_) {
-    return true;
+  if (NULL == signature_) {
+    return false;
   }
-  return false;
+  // Precompute the hidden arguments, which need a value from the runtime. A kernel without any
+  // ends up with the plain copy of the explicit arguments at the launch time
+  hiddenArgs_.clear();
+  for (uint32_t i = signature_->numParameters(); i < signature_->numParametersAll(); ++i) {
+    const amd::KernelParameterDescriptor& desc = signature_->at(i);
+    if (desc.info_.oclObject_ != amd::KernelParameterDescriptor::HiddenNone) {
+      hiddenArgs_.push_back({static_cast<uint32_t>(desc.offset_),
+                             static_cast<uint16_t>(desc.size_),
+                             static_cast<uint16_t>(desc.info_.oclObject_)});
+    }
+  }
+  return true;
 }
 
 // ================================================================================================
 Kernel::~Kernel() { delete signature_; }
 
+// ================================================================================================
+bool Kernel::findOccupancy(uint64_t key, Occupancy* occupancy) const {
+  amd::ScopedLock lock(occupancyLock_);
+  auto it = occupancy_.find(key);
+  if (it == occupancy_.end()) {
+    return false;
+  }
+  *occupancy = it->second;
+  return true;
+}
+
+// ================================================================================================
+void Kernel::addOccupancy(uint64_t key, const Occupancy& occupancy) const {
+  // The auto-tuners sweep a limited set of sizes, restart the cache if a sweep doesn't fit
+  constexpr size_t kMaxOccupancyEntries = 1024;
+  amd::ScopedLock lock(occupancyLock_);
+  if (occupancy_.size() >= kMaxOccupancyEntries) {
+    occupancy_.clear();
+  }
+  occupancy_[key] = occupancy;
+}
+
 // ================================================================================================
 #if defined(WITH_COMPILER_LIB)
 std::string Kernel::openclMangledName(const std::string& name) {
@@ -1581,6 +1615,7 @@ void Kernel::InitPrintf(const std::vector<std::string>& printfInfoStrings) {
     }
     // ]
   }
+  InitPrintfSpecs();
 }
 #endif  // defined(USE_COMGR_LIBRARY)
 
@@ -1653,6 +1688,177 @@ void Kernel::InitPrintf(const aclPrintfFmt* aclPrintf) {
       info.arguments_.push_back(*tmp_ptr);
     }
   }
+  InitPrintfSpecs();
 }
 #endif // defined(WITH_COMPILER_LIB)
+
+// ================================================================================================
+//! Returns TRUE if a float value has to be printed with the format
+static bool PrintfCheckFloat(const std::string& fmt) {
+  switch (fmt[fmt.size() - 1]) {
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'g':
+    case 'G':
+    case 'a':
+      return true;
+    default:
+      break;
+  }
+  return false;
+}
+
+//! Finds the vector specifier in the format string and returns the vector width
+static int PrintfCheckVectorSpecifier(const std::string& fmt, size_t startPos, size_t& curPos) {
+  int vectorSize = 0;
+  size_t pos = curPos;
+  size_t size = curPos - startPos;
+
+  if (size >= 3) {
+    size = 0;
+    // no modifiers
+    if (fmt[curPos - 3] == 'v') {
+      size = 2;
+    }
+    // the modifiers are "h" or "l"
+    else if (fmt[curPos - 4] == 'v') {
+      size = 3;
+    }
+    // the modifier is "hh"
+    else if ((curPos >= 5) && (fmt[curPos - 5] == 'v')) {
+      size = 4;
+    }
+    if (size > 0) {
+      curPos = size;
+      pos -= curPos;
+
+      // Get vector size
+      vectorSize = fmt[pos++] - '0';
+      // Printf supports only 2, 3, 4, 8 and 16 wide vectors
+      switch (vectorSize) {
+        case 1:
+          if ((fmt[pos++] - '0') == 6) {
+            vectorSize = 16;
+          } else {
+            vectorSize = 0;
+          }
+          break;
+        case 2:
+        case 3:
+        case 4:
+        case 8:
+          break;
+        default:
+          vectorSize = 0;
+          break;
+      }
+    }
+  }
+
+  return vectorSize;
+}
+
+// ================================================================================================
+void Kernel::InitPrintfSpecs() {
+  static const char* specifiers = "cdieEfgGaosuxXp";
+  static const char* modifiers = "hl";
+  static const char* special = "%n";
+
+  std::set<uint64_t> hashes;
+  for (auto& info : printf_) {
+    info.specs_.clear();
+    if (amd::IS_HIP) {
+      // The compiler generates the amdhsa.printf metadata in following format for HIP
+      // nonhostcall case: "0:0:<format_string_hash>,<actual_format_string>",
+      // i.e the hash is part of the format string itself delimited by character ','
+      auto delim = info.fmtString_.find_first_of(',');
+      info.hash_ = std::strtoull(info.fmtString_.substr(0, delim).c_str(), nullptr, 16);
+      info.fmtOffset_ = (delim == std::string::npos) ? info.fmtString_.size() : (delim + 1);
+      if (!hashes.insert(info.hash_).second) {
+        LogPrintfError("Hash value collision detected in printf strings of kernel %s",
+                       name().c_str());
+      }
+      continue;
+    }
+
+    // Walk through all arguments and find the corresponding specifier in the format string.
+    // Then split the original string into substrings with a single specifier, so the output
+    // can use the standard printf() for each argument
+    std::string str = info.fmtString_;
+    std::string fmt;
+    size_t pos = 0;
+    size_t posStart = 0, posEnd = 0;
+    bool mismatch = false;
+    for (uint j = 0; j < info.arguments_.size(); ++j) {
+      do {
+        posStart = str.find_first_of("%", pos);
+        if (posStart != std::string::npos) {
+          posStart++;
+          // Erase all spaces after %
+          while (str[posStart] == ' ') {
+            str.erase(posStart, 1);
+          }
+          size_t tmp = str.find_first_of(special, posStart);
+          size_t tmp2 = str.find_first_of(specifiers, posStart);
+          // Special cases. Special symbol is located before any specifier
+          if (tmp < tmp2) {
+            posEnd = posStart + 1;
+            fmt = str.substr(pos, posEnd - pos);
+            fmt.erase(posStart - pos - 1, 1);
+            pos = posStart = posEnd;
+            info.specs_.push_back({PrintfSpec::Text, false, 0, 0, fmt, ""});
+            continue;
+          }
+          break;
+        } else if (pos < str.length()) {
+          info.specs_.push_back({PrintfSpec::Text, false, 0, 0, str.substr(pos), ""});
+        }
+      } while (posStart != std::string::npos);
+
+      if (posStart == std::string::npos) {
+        info.specs_.push_back({PrintfSpec::Mismatch, false, 0, j, "", ""});
+        mismatch = true;
+        break;
+      }
+
+      size_t idPos = 0;
+      // Search for the specifier in the format string. It will be a split point for the output
+      posEnd = str.find_first_of(specifiers, posStart);
+      if (posEnd == std::string::npos) {
+        pos = posStart = posEnd;
+        break;
+      }
+      posEnd++;
+
+      size_t curPos = posEnd;
+      int vectorSize = PrintfCheckVectorSpecifier(str, posStart, curPos);
+
+      // Get substring from the last position to the current specifier
+      fmt = str.substr(pos, posEnd - pos);
+
+      // Readjust the string pointer if printf outputs a vector
+      if (vectorSize != 0) {
+        size_t posVecSpec = fmt.length() - (curPos + 1);
+        size_t posVecMod = fmt.find_first_of(modifiers, posVecSpec + 1);
+        size_t posMod = str.find_first_of(modifiers, posStart);
+        if (posMod < posEnd) {
+          fmt = fmt.erase(posVecSpec, posVecMod - posVecSpec);
+        } else {
+          fmt = fmt.erase(posVecSpec, curPos);
+        }
+        idPos = posStart - pos - 1;
+      }
+      pos = posStart = posEnd;
+
+      info.specs_.push_back({PrintfSpec::Argument, PrintfCheckFloat(fmt), vectorSize, j, fmt,
+                             (vectorSize != 0) ? fmt.substr(idPos, fmt.size()) : ""});
+    }
+
+    if (!mismatch && (pos != std::string::npos)) {
+      info.specs_.push_back({PrintfSpec::Text, false, 0, 0, str.substr(pos, str.size() - pos),
+                             ""});
+    }
+  }
+}
 } // namespace amd::device
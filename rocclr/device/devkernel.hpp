@@ -65,8 +65,9 @@ struct KernelParameterDescriptor {
     HiddenSharedBase = 28,
     HiddenQueuePtr = 29,
     HiddenDynamicLdsSize = 30,
-    HiddenLast = 31,
-    MaxSize    = 32,
+    HiddenErrorMailbox = 31,
+    HiddenLast = 32,
+    MaxSize    = 33,
   };
   clk_value_type_t type_;  //!< The parameter's type
   size_t offset_;          //!< Its offset in the parameter's stack
@@ -193,10 +194,28 @@ namespace amd::device {
 
 class Program;
 
+//! A piece of the printf format string, prepared for the output at the kernel load
+struct PrintfSpec {
+  enum Kind : uint8_t {
+    Text = 0,     //!< Plain text, printed as is
+    Argument,     //!< A single specifier, which prints the next argument
+    Mismatch      //!< The format string has less specifiers than arguments
+  };
+  Kind kind_;               //!< The kind of the piece
+  bool printFloat_;         //!< The argument is a floating point value
+  int vectorSize_;          //!< The vector width of the argument or 0 for a scalar
+  uint argument_;           //!< Index of the argument in PrintfInfo::arguments_
+  std::string fmt_;         //!< The text or the format with a single specifier
+  std::string elementFmt_;  //!< The format of the vector elements after the first one
+};
+
 //! Printf info structure
 struct PrintfInfo {
-  std::string fmtString_;        //!< formated string for printf
-  std::vector<uint> arguments_;  //!< passed arguments to the printf() call
+  std::string fmtString_;         //!< formated string for printf
+  std::vector<uint> arguments_;   //!< passed arguments to the printf() call
+  std::vector<PrintfSpec> specs_; //!< The format string split into the pieces for the output
+  uint64_t hash_ = 0;             //!< HIP only: the hash of the format string
+  size_t fmtOffset_ = 0;          //!< HIP only: the offset of the format after the hash
 };
 
 //! \class DeviceKernel, which will contain the common fields for any device
@@ -249,6 +268,17 @@ class Kernel : public amd::HeapObject {
   //! Returns the kernel signature
   const amd::KernelSignature& signature() const { return *signature_; }
 
+  //! A hidden argument, which the runtime fills at the launch time
+  struct HiddenArg {
+    uint32_t offset_;  //!< Offset of the argument in the kernel arguments
+    uint16_t size_;    //!< Size of the argument
+    uint16_t type_;    //!< Hidden type, KernelParameterDescriptor::oclObject_
+  };
+
+  //! Returns the hidden arguments without HiddenNone in the signature order. The list is built
+  //! once with the signature, so the launch doesn't walk all the parameter descriptors
+  const std::vector<HiddenArg>& hiddenArgs() const { return hiddenArgs_; }
+
   //! Returns the kernel name
   const std::string& name() const { return name_; }
 
@@ -277,6 +307,25 @@ class Kernel : public amd::HeapObject {
 
   size_t getWorkGroupSizeHint(int dim) const { return workGroupInfo_.compileSizeHint_[dim]; }
 
+  //! Occupancy of a block size and a dynamic LDS size, cached for the repeated queries
+  struct Occupancy {
+    int maxBlocksPerCU_;    //!< Max number of the blocks per CU
+    int numBlocksPerGrid_;  //!< Number of the blocks for the full occupancy
+    int bestBlockSize_;     //!< Block size with the max occupancy
+  };
+
+  //! Returns the key of the occupancy cache
+  static uint64_t OccupancyKey(int blockSize, size_t dynamicLdsSize, bool potentialBlockSize) {
+    return (static_cast<uint64_t>(dynamicLdsSize) << 32) |
+           (static_cast<uint64_t>(blockSize) << 1) | (potentialBlockSize ? 1 : 0);
+  }
+
+  //! Returns TRUE and the cached occupancy, if the key was queried before
+  bool findOccupancy(uint64_t key, Occupancy* occupancy) const;
+
+  //! Adds the occupancy of the key into the cache
+  void addOccupancy(uint64_t key, const Occupancy& occupancy) const;
+
   //! Returns GPU device object, associated with this kernel
   const amd::Device& device() const { return dev_; }
 
@@ -388,6 +437,8 @@ class Kernel : public amd::HeapObject {
   //! Initializes HSAIL Printf metadata and info
   void InitPrintf(const aclPrintfFmt* aclPrintf);
 #endif
+  //! Parses the printf format strings once, so the output doesn't need to parse them
+  void InitPrintfSpecs();
   //! Returns program associated with this kernel
   const Program& prog() const { return prog_; }
 
@@ -396,7 +447,10 @@ class Kernel : public amd::HeapObject {
   const Program& prog_;             //!< Reference to the parent program
   std::string symbolName_;          //!< kernel symbol name
   WorkGroupInfo workGroupInfo_;     //!< device kernel info structure
+  mutable amd::Monitor occupancyLock_;  //!< Lock to serialize the occupancy cache access
+  mutable std::unordered_map<uint64_t, Occupancy> occupancy_;  //!< Occupancy cache
   amd::KernelSignature* signature_; //!< kernel signature
+  std::vector<HiddenArg> hiddenArgs_;  //!< Hidden arguments, filled at the launch time
   std::string buildLog_;            //!< build log
   std::vector<PrintfInfo> printf_;  //!< Format strings for GPU printf support
   std::string runtimeHandle_;       //!< Runtime handle for context loader
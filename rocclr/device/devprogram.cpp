@@ -27,6 +27,7 @@
 #include "devkernel.hpp"
 #include "utils/macros.hpp"
 #include "utils/options.hpp"
+#include "utils/versions.hpp"
 #if defined(WITH_COMPILER_LIB)
 #include "utils/bif_section_labels.hpp"
 #include "utils/libUtils.h"
@@ -36,6 +37,7 @@
 #include <algorithm>
 #include <atomic>
 #include <cstdio>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
@@ -304,13 +306,45 @@ static amd_comgr_language_t getCOMGRLanguage(bool isHIP, const amd::option::Opti
   return AMD_COMGR_LANGUAGE_NONE;
 }
 
+namespace {
+//! Pool of the configured comgr actions by the language, target and options. A build takes
+//! an action out of the pool, so an action is never used by two builds at the same time
+struct ComgrActionPool {
+  amd::Monitor lock_{true};  //!< Lock to serialize the pool access
+  std::unordered_map<std::string, std::vector<amd_comgr_action_info_t>> idle_;  //!< Idle actions
+  std::unordered_map<uint64_t, std::string> busy_;  //!< The keys of the actions in use
+  size_t idleCount_ = 0;                            //!< The number of idle actions
+};
 
+ComgrActionPool comgrActionPool;
+constexpr size_t kMaxIdleComgrActions = 32;  //!< The max number of idle actions in the pool
+}  // namespace
+
+// ================================================================================================
 amd_comgr_status_t Program::createAction(const amd_comgr_language_t oclver,
                                          const std::vector<std::string>& options,
                                          amd_comgr_action_info_t* action,
                                          bool* hasAction) {
 
   *hasAction = false;
+  std::string key = std::to_string(oclver) + '\0' + device().isa().isaName();
+  for (const auto& option : options) {
+    key += '\0' + option;
+  }
+  {
+    // Builds with the same options reuse the configured action
+    amd::ScopedLock lock(comgrActionPool.lock_);
+    auto it = comgrActionPool.idle_.find(key);
+    if ((it != comgrActionPool.idle_.end()) && !it->second.empty()) {
+      *action = it->second.back();
+      it->second.pop_back();
+      --comgrActionPool.idleCount_;
+      comgrActionPool.busy_.emplace(action->handle, std::move(key));
+      *hasAction = true;
+      return AMD_COMGR_STATUS_SUCCESS;
+    }
+  }
+
   amd_comgr_status_t status = amd::Comgr::create_action_info(action);
 
   if (status == AMD_COMGR_STATUS_SUCCESS) {
@@ -337,9 +371,31 @@ amd_comgr_status_t Program::createAction(const amd_comgr_language_t oclver,
     status = amd::Comgr::action_info_set_logging(*action, true);
   }
 
+  if (status == AMD_COMGR_STATUS_SUCCESS) {
+    amd::ScopedLock lock(comgrActionPool.lock_);
+    comgrActionPool.busy_.emplace(action->handle, std::move(key));
+  }
   return status;
 }
 
+// ================================================================================================
+void Program::releaseAction(amd_comgr_action_info_t action, bool reusable) {
+  {
+    amd::ScopedLock lock(comgrActionPool.lock_);
+    auto it = comgrActionPool.busy_.find(action.handle);
+    if (it != comgrActionPool.busy_.end()) {
+      if (reusable && (comgrActionPool.idleCount_ < kMaxIdleComgrActions)) {
+        comgrActionPool.idle_[it->second].push_back(action);
+        ++comgrActionPool.idleCount_;
+        comgrActionPool.busy_.erase(it);
+        return;
+      }
+      comgrActionPool.busy_.erase(it);
+    }
+  }
+  amd::Comgr::destroy_action_info(action);
+}
+
 bool Program::linkLLVMBitcode(const amd_comgr_data_set_t inputs,
                               const std::vector<std::string>& options,
                               amd::option::Options* amdOptions, amd_comgr_data_set_t* output,
@@ -372,7 +428,7 @@ bool Program::linkLLVMBitcode(const amd_comgr_data_set_t inputs,
   }
 
   if (hasAction) {
-    amd::Comgr::destroy_action_info(action);
+    releaseAction(action);
   }
 
   return (status == AMD_COMGR_STATUS_SUCCESS);
@@ -477,7 +533,7 @@ bool Program::compileToLLVMBitcode(const amd_comgr_data_set_t compileInputs,
   }
 
   if (hasAction) {
-    amd::Comgr::destroy_action_info(action);
+    releaseAction(action);
   }
 
   if (hasDataSetPCH) {
@@ -576,7 +632,8 @@ bool Program::compileAndLinkExecutable(const amd_comgr_data_set_t inputs,
   }
 
   if (hasAction) {
-    amd::Comgr::destroy_action_info(action);
+    // The option list was cleared for the link step, hence the action can't be reused
+    releaseAction(action, false);
   }
 
   if (hasRelocatableData) {
@@ -1731,6 +1788,166 @@ bool Program::trySubstObjFile(const char *SubstCfgFile,
   return true;
 }
 
+// ================================================================================================
+static std::string buildCacheFileName(const std::string& key) {
+  return std::string(AMD_OCL_BUILD_CACHE_PATH) + amd::Os::fileSeparator() + key + ".clbin";
+}
+
+// ================================================================================================
+std::string Program::getBuildCacheKey(const std::string& sourceCode,
+                                      const amd::option::Options* options,
+                                      const std::vector<std::string>& preCompiledHeaders) const {
+  if ((AMD_OCL_BUILD_CACHE_PATH[0] == '\0') || !isLC() || sourceCode.empty() ||
+      (options->oVariables->DumpFlags > 0)) {
+    return std::string();
+  }
+  // Files from the include paths aren't part of the key, so such sources are always compiled
+  const auto& headers = owner()->headers();
+  if ((sourceCode.find("#include") != std::string::npos) ||
+      std::any_of(headers.begin(), headers.end(), [](const std::string& header) {
+        return header.find("#include") != std::string::npos;
+      })) {
+    return std::string();
+  }
+
+  // Two independent hashes make the collisions negligible
+  uint64_t fnv = 0xcbf29ce484222325ULL;
+  uint64_t poly = 0;
+  const auto add = [&fnv, &poly](const std::string& str) {
+    // Mix in the size first, so the concatenation of the inputs is unambiguous
+    const uint64_t size = str.size();
+    const auto mix = [&fnv, &poly](const unsigned char* bytes, size_t count) {
+      for (size_t i = 0; i < count; ++i) {
+        fnv = (fnv ^ bytes[i]) * 0x100000001b3ULL;
+        poly = poly * 0x9e3779b97f4a7c15ULL + bytes[i] + 1;
+      }
+    };
+    mix(reinterpret_cast<const unsigned char*>(&size), sizeof(size));
+    mix(reinterpret_cast<const unsigned char*>(str.data()), str.size());
+  };
+
+  // A runtime or a compiler update must never pick up stale entries
+  add(AMD_PLATFORM_INFO);
+#if defined(USE_COMGR_LIBRARY)
+  size_t comgrMajor = 0, comgrMinor = 0;
+  amd::Comgr::get_version(&comgrMajor, &comgrMinor);
+  add(std::to_string(comgrMajor) + "." + std::to_string(comgrMinor));
+#endif  // defined(USE_COMGR_LIBRARY)
+  add(device().isa().targetId());
+  add(std::to_string(device().settings().enableWgpMode_) +
+      std::to_string(device().settings().lcWavefrontSize64_));
+  // The original options include AMD_OCL_BUILD_OPTIONS and AMD_OCL_BUILD_OPTIONS_APPEND
+  add(options->origOptionStr);
+  for (const auto& option : options->clangOptions) {
+    add(option);
+  }
+  add(options->llvmOptions);
+  add(std::to_string(options->oVariables->OptLevel) + "." +
+      std::to_string(options->oVariables->LCCodeObjectVersion));
+  for (size_t i = 0; i < headers.size(); ++i) {
+    add(owner()->headerNames()[i]);
+    add(headers[i]);
+  }
+  for (const auto& header : preCompiledHeaders) {
+    add(header);
+  }
+  add(sourceCode);
+
+  char key[40];
+  snprintf(key, sizeof(key), "%016llx%016llx", static_cast<unsigned long long>(fnv),
+           static_cast<unsigned long long>(poly));
+  return key;
+}
+
+// ================================================================================================
+bool Program::loadCachedBuild(const std::string& key, amd::option::Options* options) {
+  const std::string fileName = buildCacheFileName(key);
+  std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+  if (!file.good()) {
+    return false;
+  }
+  const std::streamsize size = file.tellg();
+  if (size <= 0) {
+    return false;
+  }
+  std::vector<char> executable(size);
+  file.seekg(0, std::ios::beg);
+  if (!file.read(executable.data(), size)) {
+    return false;
+  }
+
+  internal_ = (compileOptions_.find("-cl-internal-kernel") != std::string::npos);
+  clBinary()->saveBIFBinary(executable.data(), executable.size());
+  if (!createKernels(const_cast<void*>(clBinary()->data().first), clBinary()->data().second,
+                     options->oVariables->UniformWorkGroupSize, internal_)) {
+    // A damaged entry falls back to the compilation
+    LogPrintfWarning("Cannot create kernels from the cached binary %s", fileName.c_str());
+    clBinary()->setBinary(nullptr, 0);
+    return false;
+  }
+  setType(TYPE_EXECUTABLE);
+
+  // Refresh the time stamp, the eviction drops the least recently used entries first
+  std::error_code ec;
+  std::filesystem::last_write_time(fileName, std::filesystem::file_time_type::clock::now(), ec);
+  LogPrintfInfo("OpenCL build cache hit %s", fileName.c_str());
+  return true;
+}
+
+// ================================================================================================
+void Program::storeCachedBuild(const std::string& key) const {
+  const auto binary = clBinary()->data();
+  if ((binary.first == nullptr) || (binary.second == 0)) {
+    return;
+  }
+  if (!amd::Os::createPath(AMD_OCL_BUILD_CACHE_PATH)) {
+    LogPrintfInfo("Cannot create the OpenCL build cache %s", AMD_OCL_BUILD_CACHE_PATH);
+    return;
+  }
+  const std::string fileName = buildCacheFileName(key);
+  // Write a private file and rename it, so other processes never read a partial entry
+  const std::string tmpName = fileName + "." + std::to_string(amd::Os::getProcessId());
+  std::ofstream file(tmpName, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(binary.first), binary.second);
+  file.close();
+  if (!file || (std::rename(tmpName.c_str(), fileName.c_str()) != 0)) {
+    LogPrintfInfo("Cannot store OpenCL build cache file %s", fileName.c_str());
+    std::remove(tmpName.c_str());
+    return;
+  }
+
+  if (AMD_OCL_BUILD_CACHE_MAX_SIZE == 0) {
+    return;
+  }
+  // Evict the least recently used entries until the cache fits into the limit
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  std::vector<std::pair<fs::file_time_type, fs::path>> entries;
+  uint64_t total = 0;
+  for (const auto& entry : fs::directory_iterator(AMD_OCL_BUILD_CACHE_PATH, ec)) {
+    if (!entry.is_regular_file(ec) || (entry.path().extension() != ".clbin")) {
+      continue;
+    }
+    total += entry.file_size(ec);
+    entries.emplace_back(entry.last_write_time(ec), entry.path());
+  }
+  const uint64_t limit = static_cast<uint64_t>(AMD_OCL_BUILD_CACHE_MAX_SIZE) * Mi;
+  if (total <= limit) {
+    return;
+  }
+  std::sort(entries.begin(), entries.end());
+  for (const auto& entry : entries) {
+    if (total <= limit) {
+      break;
+    }
+    const uint64_t size = fs::file_size(entry.second, ec);
+    if (!ec && fs::remove(entry.second, ec)) {
+      total -= std::min(total, size);
+    }
+  }
+}
+
+// ================================================================================================
 int32_t Program::build(const std::string& sourceCode, const char* origOptions,
                        amd::option::Options* options,
                        const std::vector<std::string>& preCompiledHeaders) {
@@ -1774,9 +1991,15 @@ int32_t Program::build(const std::string& sourceCode, const char* origOptions,
     headers.push_back(&tmpHeaders[i]);
     headerIncludeNames.push_back(tmpHeaderNames[i].c_str());
   }
+  std::string cacheKey;
+  bool cached = false;
+  if (buildStatus_ == CL_BUILD_IN_PROGRESS) {
+    cacheKey = getBuildCacheKey(sourceCode, options, preCompiledHeaders);
+    cached = !cacheKey.empty() && loadCachedBuild(cacheKey, options);
+  }
   // Compile the source code if any
   bool compileStatus = true;
-  if ((buildStatus_ == CL_BUILD_IN_PROGRESS) && !sourceCode.empty()) {
+  if ((buildStatus_ == CL_BUILD_IN_PROGRESS) && !cached && !sourceCode.empty()) {
     if (!headerIncludeNames.empty()) {
       compileStatus =
           compileImpl(sourceCode, headers, &headerIncludeNames[0], options, preCompiledHeaders);
@@ -1790,13 +2013,16 @@ int32_t Program::build(const std::string& sourceCode, const char* origOptions,
       buildLog_ = "Internal error: Compilation failed.";
     }
   }
-  if ((buildStatus_ == CL_BUILD_IN_PROGRESS) && !linkImpl(options)) {
+  if ((buildStatus_ == CL_BUILD_IN_PROGRESS) && !cached && !linkImpl(options)) {
     buildStatus_ = CL_BUILD_ERROR;
     if (buildLog_.empty()) {
       buildLog_ += "Internal error: Link failed.\n";
       buildLog_ += "Make sure the system setup is correct.";
     }
   }
+  if ((buildStatus_ == CL_BUILD_IN_PROGRESS) && !cached && !cacheKey.empty()) {
+    storeCachedBuild(cacheKey);
+  }
 
   if (!finiBuild(buildStatus_ == CL_BUILD_IN_PROGRESS)) {
     buildStatus_ = CL_BUILD_ERROR;
@@ -2168,14 +2394,24 @@ bool Program::setBinary(const char* binaryIn, size_t size, const device::Program
     return false;
   }
 
-  if (!clBinary()->setElfIn()) {
-    LogError("Setting input OCL binary failed");
-    return false;
-  }
-  uint16_t type;
-  if (!clBinary()->elfIn()->getType(type)) {
-    LogError("Bad OCL Binary: error loading ELF type!");
-    return false;
+  uint16_t type = ET_NONE;
+  uint16_t machine = EM_NONE;
+  // A HIP code object needs only the ELF header here. The amd::Elf object would copy the whole
+  // image a few times, which multiplies the peak memory of large modules
+  const auto bin = clBinary()->data();
+  const bool hsaCo = amd::IS_HIP &&
+      amd::Elf::getHeaderInfo(bin.first, bin.second, type, machine) &&
+      (machine == EM_AMDGPU) && ((type == ET_DYN) || (type == ET_EXEC));
+  if (!hsaCo) {
+    if (!clBinary()->setElfIn()) {
+      LogError("Setting input OCL binary failed");
+      return false;
+    }
+    if (!clBinary()->elfIn()->getType(type)) {
+      LogError("Bad OCL Binary: error loading ELF type!");
+      return false;
+    }
+    machine = clBinary()->elfIn()->isHsaCo() ? EM_AMDGPU : EM_NONE;
   }
   switch (type) {
     case ET_NONE: {
@@ -2193,7 +2429,7 @@ bool Program::setBinary(const char* binaryIn, size_t size, const device::Program
     case ET_DYN: {
       char* sect = nullptr;
       size_t sz = 0;
-      if (clBinary()->elfIn()->isHsaCo()) {
+      if (machine == EM_AMDGPU) {
         setType(TYPE_EXECUTABLE);
       } else {
         setType(TYPE_LIBRARY);
@@ -2666,6 +2902,7 @@ bool Program::createKernelMetadataMap(void* binary, size_t binSize) {
 
   if (status == AMD_COMGR_STATUS_SUCCESS) {
     status = amd::Comgr::get_metadata_list_size(kernelsMD, &size);
+    kernelMetadataMap_.reserve(size);
   } else if (amd::IS_HIP) {
     // Assume an empty binary. HIP may have binaries with just global variables
     return true;
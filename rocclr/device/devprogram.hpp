@@ -27,6 +27,8 @@
 #include "platform/object.hpp"
 #include "platform/memory.hpp"
 
+#include <unordered_map>
+
 #if defined(USE_COMGR_LIBRARY)
 #include "amd_comgr/amd_comgr.h"
 #endif  // defined(USE_COMGR_LIBRARY)
@@ -163,7 +165,8 @@ class Program : public amd::HeapObject {
 #if defined(USE_COMGR_LIBRARY)
   amd_comgr_metadata_node_t metadata_ = {}; //!< COMgr metadata
   uint32_t codeObjectVer_;                  //!< version of code object
-  std::map<std::string, amd_comgr_metadata_node_t> kernelMetadataMap_; //!< Map of kernel metadata
+  std::unordered_map<std::string, amd_comgr_metadata_node_t>
+      kernelMetadataMap_;                   //!< Map of kernel metadata
 #endif
   //! Sanitizer lock - lock when launching init/fini kernels
   static amd::Monitor initFiniLock_;
@@ -456,6 +459,9 @@ class Program : public amd::HeapObject {
     const std::vector<std::string>& options, amd_comgr_action_info_t* action,
     bool* hasAction);
 
+  //! Returns the action of createAction() into the pool or destroys it, if it isn't reusable
+  void releaseAction(amd_comgr_action_info_t action, bool reusable = true);
+
   //! Create the bitcode of the linked input dataset
   bool linkLLVMBitcode(const amd_comgr_data_set_t inputs,
     const std::vector<std::string>& options,
@@ -481,6 +487,17 @@ class Program : public amd::HeapObject {
                        const std::string& sourceCode,
                        const amd::option::Options* options);
 
+  //! Returns the key of the binary cache entry for the build, empty if it can't be cached
+  std::string getBuildCacheKey(const std::string& sourceCode,
+                               const amd::option::Options* options,
+                               const std::vector<std::string>& preCompiledHeaders) const;
+
+  //! Creates the program from the executable in the binary cache
+  bool loadCachedBuild(const std::string& key, amd::option::Options* options);
+
+  //! Stores the executable of the build in the binary cache and evicts the old entries
+  void storeCachedBuild(const std::string& key) const;
+
   //! Disable default copy constructor
   Program(const Program&);
 
@@ -29,6 +29,7 @@
 #include <string>
 #include <vector>
 #include <tuple>
+#include <set>
 #include <algorithm>
 
 //Address sanitizer runtime entry-function to report the invalid device memory access
@@ -91,6 +92,18 @@ void handleSanitizerService(Payload* packt_payload, uint64_t activemask,
   if (access_info & 1)
     is_write = true;
 
+  // Recoverable reports of the same access from the same code location are printed once,
+  // so the code object lookup and the report don't repeat for every wave in a loop
+  if (!is_abort && DEBUG_CLR_ASAN_DEDUP_REPORTS) {
+    static amd::Monitor reportLock("Sanitizer reports lock", false);
+    static std::set<std::tuple<uint64_t, uint64_t, uint64_t, bool>> reported;
+    amd::ScopedLock lock(reportLock);
+    if (!reported.insert({callstack[0], device_failing_addresses[0], access_size,
+                          is_write}).second) {
+      return;
+    }
+  }
+
   std::string fileuri;
   uint64_t size = 0, offset = 0;
   int64_t  loadAddrAdjust = 0;
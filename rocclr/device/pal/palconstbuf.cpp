@@ -28,14 +28,17 @@ namespace amd::pal {
 // ================================================================================================
 ManagedBuffer::ManagedBuffer(VirtualGPU& gpu, uint32_t size)
     : gpu_(gpu),
-      pool_(MaxNumberOfBuffers),
+      pool_(InitialNumberOfBuffers),
       activeBuffer_(0),
       size_(size),
       wrtOffset_(0),
-      wrtAddress_(nullptr) {}
+      wrtAddress_(nullptr),
+      type_(Resource::Empty) {}
 
 // ================================================================================================
 void ManagedBuffer::release() {
+  ClPrint(amd::LOG_INFO, amd::LOG_RESOURCE, "Managed buffer: %zu buffers, %lu grows, "
+          "%lu wrap stalls", pool_.size(), grows_, wrapStalls_);
   for (auto it : pool_) {
     if ((it.buf != nullptr) && (it.buf->data() != nullptr)) {
       it.buf->unmap(&gpu_);
@@ -46,29 +49,46 @@ void ManagedBuffer::release() {
 
 // ================================================================================================
 bool ManagedBuffer::create(Resource::MemoryType type) {
+  type_ = type;
   for (uint i = 0; i < pool_.size(); ++i) {
-    pool_[i].buf = new Memory(const_cast<pal::Device&>(gpu_.dev()), size_);
-    if (nullptr == pool_[i].buf || !pool_[i].buf->create(type)) {
-      LogPrintfError("We couldn't create HW constant buffer, size(%d)!", size_);
+    if (!createBuffer(&pool_[i])) {
       return false;
     }
-    // Assign virtual gpu to the allocation. Buffer will be used only on a particular queue
-    pool_[i].buf->memRef()->gpu_ = &gpu_;
-    void* wrtAddress = pool_[i].buf->map(&gpu_);
-    if (wrtAddress == nullptr) {
-      LogPrintfError("We couldn't map HW constant buffer, size(%d)!", size_);
-      return false;
-    }
-    // Make sure OCL touches every buffer in the queue to avoid delays on the first submit
-    uint dummy = 0;
-    static constexpr bool Wait = true;
-    // Write 0 for the buffer paging by VidMM
-    pool_[i].buf->writeRawData(gpu_, 0, sizeof(dummy), &dummy, Wait);
   }
   wrtAddress_ = pool_[activeBuffer_].buf->data();
   return true;
 }
 
+// ================================================================================================
+bool ManagedBuffer::createBuffer(TimeStampedBuffer* buffer) {
+  buffer->buf = new Memory(const_cast<pal::Device&>(gpu_.dev()), size_);
+  if (nullptr == buffer->buf || !buffer->buf->create(type_)) {
+    LogPrintfError("We couldn't create HW constant buffer, size(%d)!", size_);
+    return false;
+  }
+  // Assign virtual gpu to the allocation. Buffer will be used only on a particular queue
+  buffer->buf->memRef()->gpu_ = &gpu_;
+  void* wrtAddress = buffer->buf->map(&gpu_);
+  if (wrtAddress == nullptr) {
+    LogPrintfError("We couldn't map HW constant buffer, size(%d)!", size_);
+    return false;
+  }
+  // Make sure OCL touches every buffer in the queue to avoid delays on the first submit
+  uint dummy = 0;
+  static constexpr bool Wait = true;
+  // Write 0 for the buffer paging by VidMM
+  buffer->buf->writeRawData(gpu_, 0, sizeof(dummy), &dummy, Wait);
+  return true;
+}
+
+// ================================================================================================
+bool ManagedBuffer::isIdle(TimeStampedBuffer& buffer) {
+  if (!gpu().dev().settings().disableSdma_ && !gpu().isDone(&buffer.events[SdmaEngine])) {
+    return false;
+  }
+  return gpu().isDone(&buffer.events[MainEngine]);
+}
+
 // ================================================================================================
 address ManagedBuffer::reserve(uint32_t size, uint64_t* gpu_address) {
   // Align to the maximum data size available in OpenCL
@@ -84,12 +104,28 @@ address ManagedBuffer::reserve(uint32_t size, uint64_t* gpu_address) {
   if ((wrtOffset_ + count) > size_) {
     // Get the next buffer in the list
     ++activeBuffer_;
-    activeBuffer_ %= MaxNumberOfBuffers;
-    if (!gpu().dev().settings().disableSdma_) {
-      // Make sure the buffer isn't busy
-      gpu().waitForEvent(&pool_[activeBuffer_].events[SdmaEngine]);
+    activeBuffer_ %= pool_.size();
+    if (!isIdle(pool_[activeBuffer_])) {
+      if (pool_.size() < MaxNumberOfBuffers) {
+        // The GPU still reads the next buffer, so grow the ring instead of the wait.
+        // The new buffer goes before the busy one, which stays the next one for reuse
+        TimeStampedBuffer buffer = {};
+        if (createBuffer(&buffer)) {
+          pool_.insert(pool_.begin() + activeBuffer_, buffer);
+          ++grows_;
+        } else {
+          delete buffer.buf;
+        }
+      }
+      if (!isIdle(pool_[activeBuffer_])) {
+        ++wrapStalls_;
+        if (!gpu().dev().settings().disableSdma_) {
+          // Make sure the buffer isn't busy
+          gpu().waitForEvent(&pool_[activeBuffer_].events[SdmaEngine]);
+        }
+        gpu().waitForEvent(&pool_[activeBuffer_].events[MainEngine]);
+      }
     }
-    gpu().waitForEvent(&pool_[activeBuffer_].events[MainEngine]);
     wrtAddress_ = pool_[activeBuffer_].buf->data();
     wrtOffset_ = 0;
   }
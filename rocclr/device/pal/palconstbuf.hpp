@@ -69,14 +69,29 @@ class ManagedBuffer : public amd::EmbeddedObject {
     volatile auto tmp = *reinterpret_cast<uint64_t*>(pool_[activeBuffer_].buf->data());
   }
 
+  //! Returns the number of the wraps, which waited for the GPU
+  uint64_t wrapStalls() const { return wrapStalls_; }
+
+  //! Returns the number of the buffers, added under pressure
+  uint64_t grows() const { return grows_; }
+
  private:
   struct TimeStampedBuffer {
     Memory* buf;
     GpuEvent events[AllEngines];
   };
 
-  //! The maximum number of the managed buffers
-  static constexpr uint32_t MaxNumberOfBuffers = 3;
+  //! The initial number of the managed buffers
+  static constexpr uint32_t InitialNumberOfBuffers = 3;
+
+  //! The maximum number of the managed buffers, the ring grows to under pressure
+  static constexpr uint32_t MaxNumberOfBuffers = 16;
+
+  //! Allocates and maps a buffer of the ring
+  bool createBuffer(TimeStampedBuffer* buffer);
+
+  //! Returns TRUE if the GPU doesn't access the buffer
+  bool isIdle(TimeStampedBuffer& buffer);
 
   //! Disable copy constructor
   ManagedBuffer(const ManagedBuffer&) = delete;
@@ -90,6 +105,9 @@ class ManagedBuffer : public amd::EmbeddedObject {
   uint32_t size_;                        //!< Constant buffer size
   uint32_t wrtOffset_;                   //!< Current write offset
   address wrtAddress_;                   //!< Write address in CB
+  Resource::MemoryType type_;            //!< Memory type of the buffers
+  uint64_t wrapStalls_ = 0;              //!< The number of the wraps, which waited for the GPU
+  uint64_t grows_ = 0;                   //!< The number of the buffers, added under pressure
 };
 
 //! Constant buffer
@@ -29,6 +29,7 @@
 #include "device/pal/palubercapturemgr.hpp"
 #include "utils/flags.hpp"
 #include "utils/versions.hpp"
+#include "utils/metrics.hpp"
 #include "thread/monitor.hpp"
 #include "device/pal/palprogram.hpp"
 #include "device/pal/palsettings.hpp"
@@ -698,75 +699,78 @@ void NullDevice::fillDeviceInfo(const Pal::DeviceProperties& palProp,
 }
 
 Device::XferBuffers::~XferBuffers() {
+  ClPrint(amd::LOG_INFO, amd::LOG_RESOURCE,
+          "Staging pool: %zu buffers, high-water %zu bytes, misses %lu, grows %lu, trims %lu",
+          freeBuffers_.size(), highWaterBytes(), misses_, grows_, trims_);
   // Destroy temporary buffer for reads
   for (const auto& buf : freeBuffers_) {
-    // CPU optimization: unmap staging buffer just once
-    if (!buf->desc().cardMemory_) {
-      buf->unmap(nullptr);
-    }
-    delete buf;
+    destroy(buf);
   }
   freeBuffers_.clear();
 }
 
-bool Device::XferBuffers::create() {
-  bool result = false;
+// ================================================================================================
+Memory* Device::XferBuffers::allocate() {
   // Create a buffer object
   Memory* xferBuf = new Memory(dev(), bufSize_);
 
   // Try to allocate memory for the transfer buffer
   if ((nullptr == xferBuf) || !xferBuf->create(type_)) {
     delete xferBuf;
-    xferBuf = nullptr;
     LogError("Couldn't allocate a transfer buffer!");
-  } else {
-    result = true;
-    freeBuffers_.push_back(xferBuf);
-    // CPU optimization: map staging buffer just once
-    if (!xferBuf->desc().cardMemory_) {
-      xferBuf->map(nullptr);
-    }
+    return nullptr;
   }
+  // CPU optimization: map staging buffer just once
+  if (!xferBuf->desc().cardMemory_) {
+    xferBuf->map(nullptr);
+  }
+  return xferBuf;
+}
 
-  return result;
+// ================================================================================================
+void Device::XferBuffers::destroy(Memory* buf) {
+  // CPU optimization: unmap staging buffer just once
+  if (!buf->desc().cardMemory_) {
+    buf->unmap(nullptr);
+  }
+  delete buf;
 }
 
+// ================================================================================================
+bool Device::XferBuffers::create() {
+  Memory* xferBuf = allocate();
+  if (xferBuf == nullptr) {
+    return false;
+  }
+  freeBuffers_.push_back(xferBuf);
+  return true;
+}
+
+// ================================================================================================
 Memory& Device::XferBuffers::acquire() {
   Memory* xferBuf = nullptr;
-  size_t listSize;
 
   // Lock the operations with the staged buffer list
   amd::ScopedLock l(lock_);
-  listSize = freeBuffers_.size();
 
   // If the list is empty, then attempt to allocate a staged buffer
-  if (listSize == 0) {
-    // Allocate memory
-    xferBuf = new Memory(dev(), bufSize_);
-
-    // Allocate memory for the transfer buffer
-    if ((nullptr == xferBuf) || !xferBuf->create(type_)) {
-      delete xferBuf;
-      xferBuf = nullptr;
-      LogError("Couldn't allocate a transfer buffer!");
-    } else {
-      ++acquiredCnt_;
-      // CPU optimization: map staging buffer just once
-      if (!xferBuf->desc().cardMemory_) {
-        xferBuf->map(nullptr);
-      }
-    }
+  if (freeBuffers_.empty()) {
+    ++misses_;
+    missed_ = true;
+    amd::Metrics::add(amd::Metrics::StagingPoolMisses);
+    xferBuf = allocate();
   }
 
   if (xferBuf == nullptr) {
     xferBuf = *(freeBuffers_.begin());
     freeBuffers_.erase(freeBuffers_.begin());
-    ++acquiredCnt_;
   }
+  peak_ = std::max(peak_, static_cast<size_t>(++acquiredCnt_));
 
   return *xferBuf;
 }
 
+// ================================================================================================
 void Device::XferBuffers::release(VirtualGPU& gpu, Memory& buffer) {
   // Make sure buffer isn't busy on the current VirtualGPU, because
   // the next aquire can come from different queue
@@ -775,8 +779,46 @@ void Device::XferBuffers::release(VirtualGPU& gpu, Memory& buffer) {
   amd::ScopedLock l(lock_);
   freeBuffers_.push_back(&buffer);
   --acquiredCnt_;
+  adjust();
 }
 
+// ================================================================================================
+void Device::XferBuffers::adjust() {
+  size_t total = freeBuffers_.size() + acquiredCnt_;
+  if (missed_) {
+    // The burst outgrew the pool. Allocate a chunk ahead of the next burst here, since
+    // the transfer is complete and the allocation stays off the acquire path
+    missed_ = false;
+    const size_t target = std::min(peak_ + GrowChunk, std::max(peak_, MaxXferBufListSize));
+    while (total < target) {
+      Memory* xferBuf = allocate();
+      if (xferBuf == nullptr) {
+        break;
+      }
+      freeBuffers_.push_back(xferBuf);
+      ++total;
+      ++grows_;
+      amd::Metrics::add(amd::Metrics::StagingPoolGrows);
+    }
+  }
+
+  if (++releases_ < WindowSize) {
+    return;
+  }
+  // Trim the least recently used buffers above the rolling high-water mark of two windows,
+  // so an idle pool returns the pinned memory, but a periodic burst keeps its buffers
+  const size_t target = std::max<size_t>(std::max(peak_, prevPeak_), 1);
+  while ((total > target) && !freeBuffers_.empty()) {
+    destroy(freeBuffers_.front());
+    freeBuffers_.pop_front();
+    --total;
+    ++trims_;
+    amd::Metrics::add(amd::Metrics::StagingPoolTrims);
+  }
+  prevPeak_ = peak_;
+  peak_ = acquiredCnt_;
+  releases_ = 0;
+}
 
 Device::ScopedLockVgpus::ScopedLockVgpus(const Device& dev) : dev_(dev) {
   // Lock the virtual GPU list
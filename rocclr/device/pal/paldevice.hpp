@@ -284,6 +284,8 @@ class Device : public NullDevice {
   class XferBuffers : public amd::HeapObject {
    public:
     static constexpr size_t MaxXferBufListSize = 8;
+    static constexpr size_t GrowChunk = 2;      //!< Buffers added ahead after a miss
+    static constexpr uint WindowSize = 256;     //!< Releases in the high-water mark window
 
     //! Default constructor
     XferBuffers(const Device& device, Resource::MemoryType type, size_t bufSize)
@@ -306,6 +308,18 @@ class Device : public NullDevice {
     //! Returns the buffer's size for transfer
     size_t bufSize() const { return bufSize_; }
 
+    //! Returns the high-water mark of the bytes in flight over the last two windows
+    size_t highWaterBytes() const { return std::max(peak_, prevPeak_) * bufSize_; }
+
+    //! Returns the number of the acquires, which found no free buffer
+    uint64_t misses() const { return misses_; }
+
+    //! Returns the number of the buffers, allocated ahead of the demand
+    uint64_t grows() const { return grows_; }
+
+    //! Returns the number of the buffers, released above the high-water mark
+    uint64_t trims() const { return trims_; }
+
    private:
     //! Disable copy constructor
     XferBuffers(const XferBuffers&);
@@ -316,10 +330,26 @@ class Device : public NullDevice {
     //! Get device object
     const Device& dev() const { return gpuDevice_; }
 
+    //! Allocates a new staging buffer, returns nullptr on failure
+    Memory* allocate();
+
+    //! Destroys a staging buffer
+    static void destroy(Memory* buf);
+
+    //! Grows or trims the free list to the rolling high-water mark. Called under the lock
+    void adjust();
+
     Resource::MemoryType type_;       //!< The buffer's type
     size_t bufSize_;                  //!< Staged buffer size
     std::list<Memory*> freeBuffers_;  //!< The list of free buffers
     std::atomic<uint> acquiredCnt_;   //!< The total number of acquired buffers
+    size_t peak_ = 0;                 //!< Max acquired buffers in the current window
+    size_t prevPeak_ = 0;             //!< Max acquired buffers in the previous window
+    uint releases_ = 0;               //!< Releases in the current window
+    bool missed_ = false;             //!< An acquire found no free buffer since the last grow
+    uint64_t misses_ = 0;             //!< The total number of the acquire misses
+    uint64_t grows_ = 0;              //!< The total number of the ahead allocations
+    uint64_t trims_ = 0;              //!< The total number of the trimmed buffers
     amd::Monitor lock_;               //!< Stgaed buffer acquire/release lock
     const Device& gpuDevice_;         //!< GPU device object
   };
@@ -41,7 +41,76 @@
 #include "protocols/rgpServer.h"
 #include "protocols/driverControlServer.h"
 
+#include <cstdio>
+
 namespace amd::pal {
+// ================================================================================================
+RgpTraceWriter::RgpTraceWriter(const std::string& prefix, size_t max_backlog)
+    : prefix_(prefix), max_backlog_(max_backlog) {
+  size_t pos = prefix_.find("%p");
+  if (pos != std::string::npos) {
+    prefix_.replace(pos, 2, std::to_string(amd::Os::getProcessId()));
+  }
+  // Every device streams its own segments
+  static std::atomic<uint32_t> devices = 0;
+  prefix_ += "_dev" + std::to_string(devices++);
+  thread_ = std::thread([this]() { Run(); });
+}
+
+// ================================================================================================
+RgpTraceWriter::~RgpTraceWriter() {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    exit_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+// ================================================================================================
+void RgpTraceWriter::Push(void* data, size_t size) {
+  std::unique_lock<std::mutex> lock(lock_);
+  // Wait for the disk if the backlog is full, but always accept a segment into an empty queue
+  cv_.wait(lock, [&]() { return (backlog_ == 0) || ((backlog_ + size) <= max_backlog_); });
+  queue_.emplace_back(data, size);
+  backlog_ += size;
+  cv_.notify_all();
+}
+
+// ================================================================================================
+void RgpTraceWriter::Run() {
+  std::unique_lock<std::mutex> lock(lock_);
+  while (true) {
+    cv_.wait(lock, [&]() { return exit_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      // Exit only after all pending segments are on disk
+      break;
+    }
+    auto segment = queue_.front();
+    queue_.pop_front();
+    const std::string name = prefix_ + "_" + std::to_string(segment_++) + ".rgp";
+    lock.unlock();
+
+    FILE* file = fopen(name.c_str(), "wb");
+    if ((file == nullptr) || (fwrite(segment.first, 1, segment.second, file) != segment.second)) {
+      LogPrintfError("Couldn't write the RGP segment %s", name.c_str());
+    } else {
+      ClPrint(amd::LOG_INFO, amd::LOG_MISC, "RGP segment %s, %zu bytes", name.c_str(),
+              segment.second);
+    }
+    if (file != nullptr) {
+      fclose(file);
+    }
+    amd::AlignedMemory::deallocate(segment.first);
+
+    lock.lock();
+    backlog_ -= segment.second;
+    cv_.notify_all();
+  }
+}
+
 // ================================================================================================
 RgpCaptureMgr::RgpCaptureMgr(Pal::IPlatform* platform, const Device& device)
     : device_(device),
@@ -54,6 +123,9 @@ RgpCaptureMgr::RgpCaptureMgr(Pal::IPlatform* platform, const Device& device)
       se_mask_(0),
       perf_counter_mem_limit_(0),
       perf_counter_frequency_(0),
+      writer_(nullptr),
+      stream_segments_(0),
+      max_stream_segments_(PAL_RGP_STREAM_SEGMENTS),
       value_(0) {
   memset(&trace_, 0, sizeof(trace_));
 }
@@ -110,6 +182,15 @@ bool RgpCaptureMgr::Init(Pal::IPlatform* platform) {
   // Finalize RGP settings
   Finalize();
 
+  // Stream the capture to disk in segments without a connected RGP tool, if requested
+  if ((PAL_RGP_STREAM_FILE != nullptr) && (PAL_RGP_STREAM_FILE[0] != '\0') &&
+      GpuSupportsTracing(device_.properties(), device_.settings())) {
+    writer_ = new RgpTraceWriter(PAL_RGP_STREAM_FILE,
+                                 static_cast<size_t>(PAL_RGP_STREAM_BACKLOG) * Mi);
+    streaming_ = true;
+    trace_enabled_ = true;
+  }
+
   return true;
 }
 
@@ -167,6 +248,7 @@ bool RgpCaptureMgr::Update(Pal::IPlatform* platform) {
 
       trace_enabled_ = false;
     }
+    streaming_ = false;
 
     // Clean up if we failed
     DestroyRGPTracing();
@@ -267,7 +349,7 @@ void RgpCaptureMgr::WaitForDriverResume() {
 // Called before a swap chain presents.  This signals a frame-end boundary and
 // is used to coordinate RGP trace start/stop.
 void RgpCaptureMgr::PostDispatch(VirtualGPU* gpu) {
-  if (rgp_server_->TracesEnabled()) {
+  if (TracesEnabled()) {
     // If there's currently a trace running, submit the trace-end command buffer
     if (trace_.status_ == TraceStatus::Running) {
       amd::ScopedLock traceLock(&trace_mutex_);
@@ -338,14 +420,24 @@ Pal::Result RgpCaptureMgr::CheckForTraceResults() {
       // Get trace data from GPA session
       if (trace_.gpa_session_->GetResults(trace_.gpa_sample_id_, &traceDataSize, pTraceData) ==
           Pal::Result::Success) {
-        // Transmit trace data to anyone who's listening
-        auto devResult =
-            rgp_server_->WriteTraceData(static_cast<Pal::uint8*>(pTraceData), traceDataSize);
+        if (streaming_) {
+          // The writer thread owns the data and saves it into the next segment file
+          writer_->Push(pTraceData, traceDataSize);
+          pTraceData = nullptr;
+          stream_segments_++;
+          success = true;
+        } else {
+          // Transmit trace data to anyone who's listening
+          auto devResult =
+              rgp_server_->WriteTraceData(static_cast<Pal::uint8*>(pTraceData), traceDataSize);
 
-        success = (devResult == DevDriver::Result::Success);
+          success = (devResult == DevDriver::Result::Success);
+        }
       }
 
-      amd::AlignedMemory::deallocate(pTraceData);
+      if (pTraceData != nullptr) {
+        amd::AlignedMemory::deallocate(pTraceData);
+      }
     }
 
     if (success) {
@@ -364,11 +456,12 @@ void RgpCaptureMgr::PreDispatch(VirtualGPU* gpu, const HSAILKernel& kernel, size
   // Wait for the driver to be resumed in case it's been paused.
   WaitForDriverResume();
 
-  if (rgp_server_->TracesEnabled()) {
+  if (TracesEnabled()) {
     amd::ScopedLock traceLock(&trace_mutex_);
 
-    // Check if there's an RGP trace request pending and we're idle
-    if ((trace_.status_ == TraceStatus::Idle) && rgp_server_->IsTracePending()) {
+    // Check if there's an RGP trace request or the next streamed segment pending and we're idle
+    if ((trace_.status_ == TraceStatus::Idle) &&
+        (streaming_ ? IsStreamPending() : rgp_server_->IsTracePending())) {
       // Attempt to start preparing for a trace
       if (PrepareRGPTrace(gpu) == Pal::Result::Success) {
         // Attempt to start the trace immediately if we do not need to prepare
@@ -475,6 +568,71 @@ Pal::Result RgpCaptureMgr::PrepareRGPTrace(VirtualGPU* gpu) {
   // resources against this new one if the device is changing.
   Pal::Result result = Pal::Result::Success;
 
+  if (streaming_) {
+    // The streamed segments use the default SQTT memory and PAL_RGP_DISP_COUNT dispatches
+    num_prep_disp_ = 0;
+    max_sqtt_disp_ = device_.settings().rgpSqttDispCount_;
+    trace_gpu_mem_limit_ = 0;
+    inst_tracing_enabled_ = false;
+    se_mask_ = 0;
+    perf_counters_enabled_ = false;
+    perf_counter_ids_.clear();
+  } else {
+    QueryTraceParameters(gpu);
+  }
+
+  if (static_vm_id_) {
+    result = device_.iDev()->SetStaticVmidMode(true);
+    assert(result == Pal::Result::Success && "Static VM ID setup failed!");
+  }
+
+  if ((result == Pal::Result::Success) && !streaming_) {
+    // Notify the RGP server that we are starting a trace
+    if (rgp_server_->BeginTrace() != DevDriver::Result::Success) {
+      result = Pal::Result::ErrorUnknown;
+    }
+  }
+  // Tell the GPA session class we're starting a trace
+  if (result == Pal::Result::Success) {
+    GpuUtil::GpaSessionBeginInfo info = {};
+
+    info.flags.enableQueueTiming = true;  // trace_.queueTimingEnabled;
+
+    result = trace_.gpa_session_->Begin(info);
+  }
+
+  trace_.prepared_disp_count_ = 0;
+  trace_.sqtt_disp_count_ = 0;
+
+  // Sample the timing clocks prior to starting a trace.
+  if (result == Pal::Result::Success) {
+    trace_.gpa_session_->SampleTimingClocks();
+  }
+
+  if (result == Pal::Result::Success) {
+
+    trace_.begin_queue_ = nullptr;
+    trace_.status_ = TraceStatus::Preparing;
+  } else if (streaming_) {
+    // Don't retry the failed stream on every dispatch
+    LogError("Couldn't start the streamed RGP segment, the streaming is disabled");
+    streaming_ = false;
+  } else {
+    // We failed to prepare for the trace so abort it.
+    if (rgp_server_ != nullptr) {
+      const DevDriver::Result devDriverResult = rgp_server_->AbortTrace();
+
+      // AbortTrace should always succeed unless we've used the api incorrectly.
+      assert(devDriverResult == DevDriver::Result::Success);
+    }
+  }
+
+  return result;
+}
+
+// ================================================================================================
+// Reads the trace parameters of the pending trace request from the RGP server
+void RgpCaptureMgr::QueryTraceParameters(VirtualGPU* gpu) {
   const auto traceParameters = rgp_server_->QueryTraceParameters();
 
   num_prep_disp_ = traceParameters.captureStartIndex;
@@ -498,7 +656,7 @@ Pal::Result RgpCaptureMgr::PrepareRGPTrace(VirtualGPU* gpu) {
 
   Pal::PerfExperimentProperties perf_properties = {};
 
-  result = gpu->dev().iDev()->GetPerfExperimentProperties(&perf_properties);
+  Pal::Result result = gpu->dev().iDev()->GetPerfExperimentProperties(&perf_properties);
 
   // Querying performance properties should never fail
   assert(result == Pal::Result::Success);
@@ -531,50 +689,6 @@ Pal::Result RgpCaptureMgr::PrepareRGPTrace(VirtualGPU* gpu) {
       perf_counter_ids_.push_back(counter_id);
     }
   }
-
-  if (static_vm_id_) {
-    result = device_.iDev()->SetStaticVmidMode(true);
-    assert(result == Pal::Result::Success && "Static VM ID setup failed!");
-  }
-
-  if (result == Pal::Result::Success) {
-    // Notify the RGP server that we are starting a trace
-    if (rgp_server_->BeginTrace() != DevDriver::Result::Success) {
-      result = Pal::Result::ErrorUnknown;
-    }
-  }
-  // Tell the GPA session class we're starting a trace
-  if (result == Pal::Result::Success) {
-    GpuUtil::GpaSessionBeginInfo info = {};
-
-    info.flags.enableQueueTiming = true;  // trace_.queueTimingEnabled;
-
-    result = trace_.gpa_session_->Begin(info);
-  }
-
-  trace_.prepared_disp_count_ = 0;
-  trace_.sqtt_disp_count_ = 0;
-
-  // Sample the timing clocks prior to starting a trace.
-  if (result == Pal::Result::Success) {
-    trace_.gpa_session_->SampleTimingClocks();
-  }
-
-  if (result == Pal::Result::Success) {
-
-    trace_.begin_queue_ = nullptr;
-    trace_.status_ = TraceStatus::Preparing;
-  } else {
-    // We failed to prepare for the trace so abort it.
-    if (rgp_server_ != nullptr) {
-      const DevDriver::Result devDriverResult = rgp_server_->AbortTrace();
-
-      // AbortTrace should always succeed unless we've used the api incorrectly.
-      assert(devDriverResult == DevDriver::Result::Success);
-    }
-  }
-
-  return result;
 }
 
 // ================================================================================================
@@ -746,14 +860,16 @@ void RgpCaptureMgr::FinishRGPTrace(VirtualGPU* gpu, bool aborted) {
     // Check if runtime is waiting for the final trace results
     if (trace_.status_ == TraceStatus::WaitingForResults) {
       // If results are ready, then finish the trace
-      if (CheckForTraceResults() == Pal::Result::Success) {
+      if ((CheckForTraceResults() == Pal::Result::Success) && !streaming_) {
         rgp_server_->EndTrace();
       }
     }
   }
 
   // Inform RGP protocol that we're done with the trace, either by aborting it or finishing normally
-  if (aborted) {
+  if (streaming_) {
+    // The streamed segments don't involve the RGP server
+  } else if (aborted) {
     rgp_server_->AbortTrace();
   } else {
     rgp_server_->EndTrace();
@@ -769,7 +885,9 @@ void RgpCaptureMgr::FinishRGPTrace(VirtualGPU* gpu, bool aborted) {
   }
   // If applicaiton exits, then Windows kills all threads and
   // RGP can't finish data write into a file.
-  amd::Os::sleep(10 * disp_count + 500);
+  if (!streaming_) {
+    amd::Os::sleep(10 * disp_count + 500);
+  }
   // Reset tracing state to idle
   trace_.prepared_disp_count_ = 0;
   trace_.sqtt_disp_count_ = 0;
@@ -787,6 +905,11 @@ void RgpCaptureMgr::DestroyRGPTracing() {
 
   delete user_event_;
 
+  // Write the pending streamed segments
+  delete writer_;
+  writer_ = nullptr;
+  streaming_ = false;
+
   // Destroy the GPA session
   // Util::Destructor(trace_.gpa_session_);
   delete trace_.gpa_session_;
@@ -869,7 +992,7 @@ void RgpCaptureMgr::WriteEventWithDimsMarker(const VirtualGPU* gpu, RgpSqttMarke
 // ================================================================================================
 void RgpCaptureMgr::WriteBarrierStartMarker(const VirtualGPU* gpu,
                                             const Pal::Developer::BarrierData& data) const {
-  if (rgp_server_->TracesEnabled() && (trace_.status_ == TraceStatus::Running)) {
+  if (TracesEnabled() && (trace_.status_ == TraceStatus::Running)) {
     amd::ScopedLock traceLock(&trace_mutex_);
     RgpSqttMarkerBarrierStart marker = {};
 
@@ -887,7 +1010,7 @@ void RgpCaptureMgr::WriteBarrierStartMarker(const VirtualGPU* gpu,
 // ================================================================================================
 void RgpCaptureMgr::WriteBarrierEndMarker(const VirtualGPU* gpu,
                                           const Pal::Developer::BarrierData& data) const {
-  if (rgp_server_->TracesEnabled() && (trace_.status_ == TraceStatus::Running)) {
+  if (TracesEnabled() && (trace_.status_ == TraceStatus::Running)) {
     amd::ScopedLock traceLock(&trace_mutex_);
     // Copy the operations part and include the same data from previous markers
     // within the same barrier sequence to create a full picture of all cache
@@ -20,7 +20,11 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <queue>
+#include <thread>
 #include "device/pal/palcapturemgr.hpp"
 #include "platform/commandqueue.hpp"
 #include "device/blit.hpp"
@@ -311,6 +315,37 @@ struct RgpSqttMarkerUserEventWithString {
   uint32_t stringData[RgpSqttMaxUserEventStringLengthInDwords];  // String data in UTF-8 format
 };
 
+// ================================================================================================
+// Writes the streamed RGP segments into the files on a background thread, so the capture doesn't
+// wait for the disk. The backlog of the pending segments is bounded, hence a slow disk throttles
+// the capture instead of growing the memory usage.
+class RgpTraceWriter {
+ public:
+  RgpTraceWriter(const std::string& prefix, size_t max_backlog);
+
+  //! Writes the pending segments and stops the writer thread
+  ~RgpTraceWriter();
+
+  //! Queues a segment for the write. The writer owns the aligned data after the call
+  void Push(void* data, size_t size);
+
+ private:
+  //! The writer thread loop
+  void Run();
+
+  std::string prefix_;     // The file name prefix of the device segments
+  size_t max_backlog_;     // Max bytes of the pending segments
+  size_t backlog_ = 0;     // Bytes of the pending segments
+  uint32_t segment_ = 0;   // The index of the next written segment
+  bool exit_ = false;      // The writer thread must exit after the pending segments
+  std::deque<std::pair<void*, size_t>> queue_;  // The pending segments
+  std::mutex lock_;                             // Guards the state above
+  std::condition_variable cv_;                  // Signals the queue updates
+  std::thread thread_;                          // The writer thread
+
+  PAL_DISALLOW_COPY_AND_ASSIGN(RgpTraceWriter);
+};
+
 // ================================================================================================
 // This class provides functionality to interact with the GPU Open Developer Mode message passing
 // service and the rest of the driver.
@@ -380,6 +415,7 @@ class RgpCaptureMgr final : public ICaptureMgr {
   void Finalize();
 
   Pal::Result PrepareRGPTrace(VirtualGPU* pQueue);
+  void QueryTraceParameters(VirtualGPU* pQueue);
   Pal::Result BeginRGPTrace(VirtualGPU* pQueue);
   Pal::Result EndRGPHardwareTrace(VirtualGPU* pQueue);
   Pal::Result EndRGPTrace(VirtualGPU* pQueue);
@@ -402,6 +438,14 @@ class RgpCaptureMgr final : public ICaptureMgr {
 
   bool IsQueueTimingActive() const;
 
+  // Returns true if the traces are requested by the RGP server or streamed to disk
+  bool TracesEnabled() const { return streaming_ || rgp_server_->TracesEnabled(); }
+
+  // Returns true if the next streamed segment should start
+  bool IsStreamPending() const {
+    return streaming_ && ((max_stream_segments_ == 0) || (stream_segments_ < max_stream_segments_));
+  }
+
   const Device& device_;
   DevDriver::DevDriverServer* dev_driver_server_;
   DevDriver::RGPProtocol::RGPServer* rgp_server_;
@@ -420,12 +464,17 @@ class RgpCaptureMgr final : public ICaptureMgr {
 
   std::vector<GpuUtil::PerfCounterId> perf_counter_ids_;  // List of perf counter ids
 
+  RgpTraceWriter* writer_;           // Background writer of the streamed segments
+  uint32_t stream_segments_;         // The number of the streamed segments so far
+  uint32_t max_stream_segments_;     // Max streamed segments, 0 if unlimited
+
   union {
     struct {
       uint32_t trace_enabled_: 1;         // True if tracing is currently enabled (master flag)
       uint32_t inst_tracing_enabled_: 1;  // Enable instruction-level SQTT tokens
       uint32_t perf_counters_enabled_: 1; // True if perf counters are enabled
       uint32_t static_vm_id_: 1;          // Static VM ID can be used for capture
+      uint32_t streaming_: 1;             // The capture is streamed to disk in segments
     };
     uint32_t value_;
   };
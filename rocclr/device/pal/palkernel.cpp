@@ -268,7 +268,7 @@ const HSAILProgram& HSAILKernel::prog() const {
 hsa_kernel_dispatch_packet_t* HSAILKernel::loadArguments(
     VirtualGPU& gpu, const amd::Kernel& kernel, const amd::NDRangeContainer& sizes,
     const_address params, size_t ldsAddress, uint64_t vmDefQueue,
-    uint64_t* vmParentWrap, uint32_t* aql_index) const {
+    uint64_t* vmParentWrap, uint32_t* aql_index, address* hostArgs) const {
   // Provide private and local heap addresses
   static constexpr uint AddressShift = LP64_SWITCH(0, 32);
   const_address parameters = params;
@@ -306,10 +306,9 @@ hsa_kernel_dispatch_packet_t* HSAILKernel::loadArguments(
 
   address hidden_arguments = const_cast<address>(parameters);
 
-  // Check if runtime has to setup hidden arguments
-  for (uint32_t i = signature.numParameters(); i < signature.numParametersAll(); ++i) {
-    const auto& it = signature.at(i);
-    switch (it.info_.oclObject_) {
+  // Setup the hidden arguments from the precomputed list
+  for (const auto& it : hiddenArgs()) {
+    switch (it.type_) {
       case amd::KernelParameterDescriptor::HiddenNone:
         break;
       case amd::KernelParameterDescriptor::HiddenGlobalOffsetX:
@@ -481,6 +480,9 @@ hsa_kernel_dispatch_packet_t* HSAILKernel::loadArguments(
   hsaDisp->reserved2 = 0;
   hsaDisp->completion_signal.handle = 0;
   memcpy(aqlArgBuf + argsBufferSize(), hsaDisp, sizeof(hsa_kernel_dispatch_packet_t));
+  if (hostArgs != nullptr) {
+    *hostArgs = aqlArgBuf;
+  }
 
   if (AMD_HSA_BITS_GET(akc_.kernel_code_properties,
                        AMD_KERNEL_CODE_PROPERTIES_ENABLE_SGPR_QUEUE_PTR)) {
@@ -109,7 +109,8 @@ class HSAILKernel : public device::Kernel {
       size_t ldsAddress,                   //!< LDS address that includes all arguments.
       uint64_t vmDefQueue,                 //!< GPU VM default queue pointer
       uint64_t* vmParentWrap,              //!< GPU VM parent aql wrap object
-      uint32_t* aql_index                  //!< AQL packet index in the packets array for debugger
+      uint32_t* aql_index,                 //!< AQL packet index in the packets array for debugger
+      address* hostArgs = nullptr          //!< Host location of the loaded arguments
       ) const;
 
   //! Returns the kernel index in the program
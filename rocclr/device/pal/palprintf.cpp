@@ -29,13 +29,13 @@
 #include <cstdio>
 #include <algorithm>
 #include <cmath>
+#include <string_view>
 
 // Functions defined in devhcprintf.cpp
 namespace amd {
 void handlePrintfDelayed(const uint64_t* input, uint64_t len, uint64_t control);
-bool populateFormatStringHashMap(
-    const std::vector<device::PrintfInfo> &printfInfo,
-    std::map<uint64_t, std::string> &strMap);
+const device::PrintfInfo* findPrintfInfo(const std::vector<device::PrintfInfo>& printfInfo,
+                                         uint64_t hash);
 } // namespace amd
 
 namespace amd::pal {
@@ -172,76 +172,11 @@ bool PrintfDbg::allocate(bool realloc) {
   return (nullptr != dbgBuffer_) ? true : false;
 }
 
-bool PrintfDbg::checkFloat(const std::string& fmt) const {
-  switch (fmt[fmt.size() - 1]) {
-    case 'e':
-    case 'E':
-    case 'f':
-    case 'g':
-    case 'G':
-    case 'a':
-      return true;
-      break;
-    default:
-      break;
-  }
-  return false;
-}
-
 bool PrintfDbg::checkString(const std::string& fmt) const {
   if (fmt[fmt.size() - 1] == 's') return true;
   return false;
 }
 
-int PrintfDbg::checkVectorSpecifier(const std::string& fmt, size_t startPos, size_t& curPos) const {
-  int vectorSize = 0;
-  size_t pos = curPos;
-  size_t size = curPos - startPos;
-
-  if (size >= 3) {
-    size = 0;
-    // no modifiers
-    if (fmt[curPos - 3] == 'v') {
-      size = 2;
-    }
-    // the modifiers are "h" or "l"
-    else if (fmt[curPos - 4] == 'v') {
-      size = 3;
-    }
-    // the modifier is "hh"
-    else if ((curPos >= 5) && (fmt[curPos - 5] == 'v')) {
-      size = 4;
-    }
-    if (size > 0) {
-      curPos = size;
-      pos -= curPos;
-
-      // Get vector size
-      vectorSize = fmt[pos++] - '0';
-      // PrintfDbg supports only 2, 3, 4, 8 and 16 wide vectors
-      switch (vectorSize) {
-        case 1:
-          if ((fmt[pos++] - '0') == 6) {
-            vectorSize = 16;
-          } else {
-            vectorSize = 0;
-          }
-          break;
-        case 2:
-        case 3:
-        case 4:
-        case 8:
-          break;
-        default:
-          vectorSize = 0;
-          break;
-      }
-    }
-  }
-
-  return vectorSize;
-}
-
 static constexpr size_t ConstStr = 0xffffffff;
 static constexpr char Separator[] = ",\0";
 
@@ -370,125 +305,58 @@ size_t PrintfDbg::outputArgument(const std::string& fmt, bool printFloat, size_t
 
 void PrintfDbg::outputDbgBuffer(const device::PrintfInfo& info, const uint32_t* workitemData,
                                 size_t& i) const {
-  static const char* specifiers = "cdieEfgGaosuxXp";
-  static const char* modifiers = "hl";
-  static const char* special = "%n";
   static const std::string sepStr = "%s";
   const uint32_t* s = workitemData;
-  size_t pos = 0;
-
-  // Find the format string
-  std::string str = info.fmtString_;
-  std::string fmt;
-  size_t posStart, posEnd;
-
-  // Print all arguments
-  // Note: the following code walks through all arguments, provided by the kernel and
-  // finds the corresponding specifier in the format string.
-  // Then it splits the original string into substrings with a single specifier and
-  // uses standard PrintfDbg() to print each argument
-  for (uint j = 0; j < info.arguments_.size(); ++j) {
-    do {
-      posStart = str.find_first_of("%", pos);
-      if (posStart != std::string::npos) {
-        posStart++;
-        // Erase all spaces after %
-        while (str[posStart] == ' ') {
-          str.erase(posStart, 1);
-        }
-        size_t tmp = str.find_first_of(special, posStart);
-        size_t tmp2 = str.find_first_of(specifiers, posStart);
-        // Special cases. Special symbol is located before any specifier
-        if (tmp < tmp2) {
-          posEnd = posStart + 1;
-          fmt = str.substr(pos, posEnd - pos);
-          fmt.erase(posStart - pos - 1, 1);
-          pos = posStart = posEnd;
-          outputArgument(sepStr, false, ConstStr, fmt.data());
-          continue;
-        }
-        break;
-      } else if (pos < str.length()) {
-        outputArgument(sepStr, false, ConstStr,
-                       str.substr(pos).data());
-      }
-    } while (posStart != std::string::npos);
-
-    if (posStart != std::string::npos) {
-      bool printFloat = false;
-      int vectorSize = 0;
-      size_t idPos = 0;
-
-      // Search for PrintfDbg specifier in the format string.
-      // It will be a split point for the output
-      posEnd = str.find_first_of(specifiers, posStart);
-      if (posEnd == std::string::npos) {
-        pos = posStart = posEnd;
-        break;
-      }
-      posEnd++;
-
-      size_t curPos = posEnd;
-      vectorSize = checkVectorSpecifier(str, posStart, curPos);
 
-      // Get substring from the last position to the current specifier
-      fmt = str.substr(pos, posEnd - pos);
-
-      // Readjust the string pointer if PrintfDbg outputs a vector
-      if (vectorSize != 0) {
-        size_t posVecSpec = fmt.length() - (curPos + 1);
-        size_t posVecMod = fmt.find_first_of(modifiers, posVecSpec + 1);
-        size_t posMod = str.find_first_of(modifiers, posStart);
-        if (posMod < posEnd) {
-          fmt = fmt.erase(posVecSpec, posVecMod - posVecSpec);
+  // The format string was split into the pieces with a single specifier at the kernel load,
+  // hence use standard printf() for each piece
+  for (const auto& spec : info.specs_) {
+    switch (spec.kind_) {
+      case device::PrintfSpec::Text:
+        outputArgument(sepStr, false, ConstStr, spec.fmt_.data());
+        break;
+      case device::PrintfSpec::Mismatch:
+        amd::Os::printf(
+            "Error: The arguments don't match the printf format string. "
+            "printf(%s)",
+            info.fmtString_.data());
+        return;
+      case device::PrintfSpec::Argument: {
+        const uint argSize = info.arguments_[spec.argument_];
+        // Is it a scalar value?
+        if (spec.vectorSize_ == 0) {
+          size_t length = outputArgument(spec.fmt_, spec.printFloat_, argSize, &s[i]);
+          if (0 == length) {
+            return;
+          }
+          i += amd::alignUp(length, sizeof(uint32_t)) / sizeof(uint32_t);
         } else {
-          fmt = fmt.erase(posVecSpec, curPos);
-        }
-        idPos = posStart - pos - 1;
-      }
-      pos = posStart = posEnd;
+          // 3-component vector's size is defined as 4 * size of each scalar component
+          size_t elemSize = argSize / (spec.vectorSize_ == 3 ? 4 : spec.vectorSize_);
+          size_t k = i * sizeof(uint32_t);
 
-      // Find out if the argument is a float
-      printFloat = checkFloat(fmt);
-
-      // Is it a scalar value?
-      if (vectorSize == 0) {
-        size_t length = outputArgument(fmt, printFloat, info.arguments_[j], &s[i]);
-        if (0 == length) {
-          return;
-        }
-        i += amd::alignUp(length, sizeof(uint32_t)) / sizeof(uint32_t);
-      } else {
-        // 3-component vector's size is defined as 4 * size of each scalar component
-        size_t elemSize = info.arguments_[j] / (vectorSize == 3 ? 4 : vectorSize);
-        size_t k = i * sizeof(uint32_t);
-        std::string elementStr = fmt.substr(idPos, fmt.size());
-
-        // Print first element with full string
-        if (0 == outputArgument(fmt, printFloat, elemSize, &s[i])) {
-          return;
-        }
+          // Print first element with full string
+          if (0 == outputArgument(spec.fmt_, spec.printFloat_, elemSize, &s[i])) {
+            return;
+          }
 
-        // Print other elemnts with separator if available
-        for (int e = 1; e < vectorSize; ++e) {
-          const char* t = reinterpret_cast<const char*>(s);
+          // Print other elemnts with separator if available
+          for (int e = 1; e < spec.vectorSize_; ++e) {
+            const char* t = reinterpret_cast<const char*>(s);
 
-          // Output the vector separator
-          outputArgument(sepStr, false, ConstStr, Separator);
+            // Output the vector separator
+            outputArgument(sepStr, false, ConstStr, Separator);
 
-          // Output the next element
-          outputArgument(elementStr, printFloat, elemSize,
-                         &t[k + e * elemSize]);
+            // Output the next element
+            outputArgument(spec.elementFmt_, spec.printFloat_, elemSize,
+                           &t[k + e * elemSize]);
+          }
+          i += (amd::alignUp(argSize, sizeof(uint32_t))) / sizeof(uint32_t);
         }
-        i += (amd::alignUp(info.arguments_[j], sizeof(uint32_t))) / sizeof(uint32_t);
+        break;
       }
     }
   }
-
-  if (pos != std::string::npos) {
-    fmt = str.substr(pos, str.size() - pos);
-    outputArgument(sepStr, false, ConstStr, fmt.data());
-  }
 }
 
 bool PrintfDbg::clearWorkitems(VirtualGPU& gpu, size_t idxStart, size_t number) const {
@@ -615,9 +483,6 @@ bool PrintfDbgHSA::output(VirtualGPU& gpu, bool printfEnabled,
     size_t bufSize = dev().xferRead().bufSize();
     size_t copySize = offsetSize;
 
-    // Map between 64 bit MD5 format string hash and
-    // actual format string
-    std::map<uint64_t, std::string> StrMap;
 
     while (copySize != 0) {
       // Copy the buffer data (i.e., the printfID followed by the
@@ -641,10 +506,6 @@ bool PrintfDbgHSA::output(VirtualGPU& gpu, bool printfEnabled,
       if (amd::IS_HIP) {
         auto BufferForHIP = reinterpret_cast<uint32_t*>(dbgBufferPtr);
 
-        // Populate string map with hashes and actual
-        // format strings.
-        if(!amd::populateFormatStringHashMap(printfInfo, StrMap))
-          return false;
 
         while (sbt < copySize) {
           auto controlDword = *BufferForHIP++;
@@ -663,13 +524,15 @@ bool PrintfDbgHSA::output(VirtualGPU& gpu, bool printfEnabled,
             // and remaining values are printf arguments.
             // Construct a temporary buffer with actual format
             // string followed by arguments. The format string is
-            // obtained by querying StrMap populated before.
+            // obtained from the printf info, parsed at the kernel load.
             auto ArgsLen = nextOffset - 12;
-            auto Str = StrMap[*PB++];
+            const device::PrintfInfo* info = amd::findPrintfInfo(printfInfo, *PB++);
+            std::string_view Str = (info != nullptr) ?
+                std::string_view(info->fmtString_).substr(info->fmtOffset_) : std::string_view();
             auto StrLenWithNull = Str.size() + 1;
             BufferLen = ArgsLen + amd::alignUp(StrLenWithNull, sizeof(uint64_t));
             PBuffer.resize(BufferLen);
-            memcpy(PBuffer.data(), Str.c_str(), StrLenWithNull);
+            memcpy(PBuffer.data(), Str.data(), Str.size());
             memset(PBuffer.data() + Str.size(), 0, 8 - (StrLenWithNull % 8 ));
             memcpy(PBuffer.data() + amd::alignUp(StrLenWithNull, sizeof(uint64_t)),
                    PB, ArgsLen);
@@ -100,20 +100,10 @@ class PrintfDbg : public amd::HeapObject {
   bool allocate(bool realloc = false  //!< If TRUE then reallocate the debug memory
   );
 
-  //! Returns TRUE if a float value has to be printed
-  bool checkFloat(const std::string& fmt  //!< Format string
-                  ) const;
-
   //! Returns TRUE if a string value has to be printed
   bool checkString(const std::string& fmt  //!< Format string
                    ) const;
 
-  //! Finds the specifier in the format string
-  int checkVectorSpecifier(const std::string& fmt,  //!< Format string
-                           size_t startPos,         //!< Start position for processing
-                           size_t& curPos           //!< End position for processing
-                           ) const;
-
   //! Outputs an argument
   size_t outputArgument(const std::string& fmt,   //!< Format strint
                         bool printFloat,          //!< Argument is a float value
@@ -512,6 +512,14 @@ void Resource::memTypeToHeap(Pal::GpuMemoryCreateInfo* createInfo) {
       createInfo->mallPolicy = Pal::GpuMemMallPolicy::Never;
       break;
   }
+
+  // The per-allocation hints override the global policy
+  if (desc().mallBypass_) {
+    createInfo->mallPolicy = Pal::GpuMemMallPolicy::Never;
+  } else if (desc().mallPreferred_ &&
+             (createInfo->mallPolicy != Pal::GpuMemMallPolicy::Never)) {
+    createInfo->mallPolicy = Pal::GpuMemMallPolicy::Always;
+  }
 }
 
 // ================================================================================================
@@ -1264,6 +1272,11 @@ bool Resource::create(MemoryType memType, CreateParams* params, bool forceLinear
     desc_.type_ = RemoteUSWC;
   }
   desc_.interprocess_ = (nullptr != params) ? params->interprocess_ : false;
+  if ((nullptr != params) && (nullptr != params->owner_)) {
+    const cl_mem_flags flags = params->owner_->getMemFlags();
+    desc_.mallBypass_ = (flags & ROCCLR_MEM_MALL_BYPASS) ? true : false;
+    desc_.mallPreferred_ = !desc_.mallBypass_ && (flags & ROCCLR_MEM_MALL_PREFERRED);
+  }
 
   switch (memoryType()) {
     case OGLInterop:
@@ -1669,10 +1682,11 @@ void Resource::wait(VirtualGPU& gpu, bool waitOnBusyEngine) const {
   GpuEvent* gpuEvent = getGpuEvent(gpu);
 
   // Check if we have to wait unconditionally
-  if (!waitOnBusyEngine ||
-      // or we have to wait only if another engine was used on this resource
-      (gpuEvent->engineId_ != gpu.engineID_)) {
+  if (!waitOnBusyEngine) {
     gpu.waitForEvent(gpuEvent);
+  } else if (gpuEvent->engineId_ != gpu.engineID_) {
+    // Another engine was used on this resource, so the current engine waits for it
+    gpu.syncEngines(gpu.engineID_, gpuEvent);
   }
 
   // If current resource is a view and not in the global heap,
@@ -2038,7 +2052,7 @@ bool MemorySubAllocator::InitAllocator(GpuMemoryReference* mem_ref) {
       new MemBuddyAllocator(device_, device_->settings().subAllocationChunkSize_,
                             device_->settings().subAllocationMinSize_);
   if (!((allocator != nullptr) && (allocator->Init() == Pal::Result::Success) &&
-        heaps_.insert({mem_ref, allocator}).second)) {
+        shards_[threadShard()].heaps_.insert({mem_ref, allocator}).second)) {
     mem_ref->release();
     delete allocator;
     return false;
@@ -2152,71 +2166,101 @@ bool FineUncachedMemorySubAllocator::CreateChunk(const Pal::IGpuMemory* reserved
 // ================================================================================================
 MemorySubAllocator::~MemorySubAllocator() {
   // Release memory heap for suballocations
-  for (const auto& it : heaps_) {
-    it.first->release();
-    delete it.second;
+  for (auto& shard : shards_) {
+    for (const auto& it : shard.heaps_) {
+      it.first->release();
+      delete it.second;
+    }
   }
 }
 
+// ================================================================================================
+uint MemorySubAllocator::threadShard() {
+  // The threads are spread over the shards in the order of their first allocation
+  static std::atomic<uint> nextShard(0);
+  thread_local uint shard = nextShard++ % kNumShards;
+  return shard;
+}
+
+// ================================================================================================
+GpuMemoryReference* MemorySubAllocator::AllocateFromShard(Shard& shard, Pal::gpusize size,
+                                                          Pal::gpusize alignment,
+                                                          const Pal::IGpuMemory* reserved_va,
+                                                          Pal::gpusize* offset) {
+  // Find if current heap has enough empty space
+  for (const auto& it : shard.heaps_) {
+    GpuMemoryReference* mem_ref = it.first;
+    // SVM allocations may required a fixed VA, make sure we find the heap with the same VA
+    if (reserved_va &&
+        (reserved_va->Desc().gpuVirtAddr != mem_ref->iMem()->Desc().gpuVirtAddr)) {
+      continue;
+    }
+    // If we have found a valid chunk, then suballocate memory
+    if (Pal::Result::Success == it.second->Allocate(size, alignment, offset)) {
+      return mem_ref;
+    }
+  }
+  return nullptr;
+}
+
 // ================================================================================================
 GpuMemoryReference* MemorySubAllocator::Allocate(Pal::gpusize size, Pal::gpusize alignment,
                                                  const Pal::IGpuMemory* reserved_va,
                                                  Pal::gpusize* offset) {
-  GpuMemoryReference* mem_ref = nullptr;
-  MemBuddyAllocator* allocator = nullptr;
   // Check if the resource size and alignment are allowed for suballocation
-  if ((size < device_->settings().subAllocationMaxSize_) &&
-      (alignment <= device_->properties().gpuMemoryProperties.fragmentSize)) {
-    uint i = 0;
-    size = amd::alignUp(size, device_->settings().subAllocationMinSize_);
-    do {
-      // Find if current heap has enough empty space
-      for (const auto& it : heaps_) {
-        mem_ref = it.first;
-        allocator = it.second;
-        // SVM allocations may required a fixed VA, make sure we find the heap with the same VA
-        if (reserved_va &&
-            (reserved_va->Desc().gpuVirtAddr != mem_ref->iMem()->Desc().gpuVirtAddr)) {
-          continue;
-        }
-        // If we have found a valid chunk, then suballocate memory
-        if (Pal::Result::Success == allocator->Allocate(size, alignment, offset)) {
-          return mem_ref;
-        }
-      }
-      // We didn't find a valid chunk, so create a new one
-      if (!CreateChunk(reserved_va)) {
-        return nullptr;
-      }
-      i++;
-    } while (i < 2);
+  if ((size >= device_->settings().subAllocationMaxSize_) ||
+      (alignment > device_->properties().gpuMemoryProperties.fragmentSize)) {
+    return nullptr;
   }
-  return nullptr;
+  size = amd::alignUp(size, device_->settings().subAllocationMinSize_);
+  const uint home = threadShard();
+  // Try the chunks of the thread's shard first, then the chunks of the other shards
+  for (uint i = 0; i < kNumShards; ++i) {
+    Shard& shard = shards_[(home + i) % kNumShards];
+    amd::ScopedLock l(shard.lock_);
+    GpuMemoryReference* mem_ref = AllocateFromShard(shard, size, alignment, reserved_va, offset);
+    if (mem_ref != nullptr) {
+      return mem_ref;
+    }
+  }
+  // We didn't find a valid chunk, so create a new one in the thread's shard
+  Shard& shard = shards_[home];
+  amd::ScopedLock l(shard.lock_);
+  if (!CreateChunk(reserved_va)) {
+    return nullptr;
+  }
+  return AllocateFromShard(shard, size, alignment, reserved_va, offset);
 }
 
 // ================================================================================================
-bool MemorySubAllocator::Free(amd::Monitor* monitor, GpuMemoryReference* ref, Pal::gpusize offset) {
-  bool release_mem = false;
-  {
-    amd::ScopedLock l(monitor);
-    // Find if current memory reference is a chunk allocation
-    auto it = heaps_.find(ref);
-    if (it == heaps_.end()) {
-      return false;
-    }
+bool MemorySubAllocator::Free(GpuMemoryReference* ref, Pal::gpusize offset) {
+  const uint home = threadShard();
+  // The memory is usually released by the thread, which allocated it
+  for (uint i = 0; i < kNumShards; ++i) {
+    Shard& shard = shards_[(home + i) % kNumShards];
+    bool release_mem = false;
+    {
+      amd::ScopedLock l(shard.lock_);
+      // Find if current memory reference is a chunk allocation
+      auto it = shard.heaps_.find(ref);
+      if (it == shard.heaps_.end()) {
+        continue;
+      }
 
-    it->second->Free(offset);
-    // If this suballocator empty, then release memory chunk
-    if (it->second->IsEmpty()) {
-      delete it->second;
-      heaps_.erase(it);
-      release_mem = true;
+      it->second->Free(offset);
+      // If this suballocator empty, then release memory chunk
+      if (it->second->IsEmpty()) {
+        delete it->second;
+        shard.heaps_.erase(it);
+        release_mem = true;
+      }
     }
+    if (release_mem) {
+      ref->release();
+    }
+    return true;
   }
-  if (release_mem) {
-    ref->release();
-  }
-  return true;
+  return false;
 }
 
 // ================================================================================================
@@ -2234,14 +2278,14 @@ bool ResourceCache::addGpuMemory(Resource::Descriptor* desc, GpuMemoryReference*
     // We do no sub allocate VA Range.
     result = true;
   } else if ((desc->type_ == Resource::Local) && !desc->SVMRes_) {
-    result = mem_sub_alloc_local_.Free(&lockCacheOps_, ref, offset);
+    result = mem_sub_alloc_local_.Free(ref, offset);
   } else if ((desc->type_ == Resource::Local) && desc->SVMRes_) {
-    result = mem_sub_alloc_coarse_.Free(&lockCacheOps_, ref, offset);
+    result = mem_sub_alloc_coarse_.Free(ref, offset);
   } else if (desc->SVMRes_) {
     if (desc->gl2CacheDisabled_) {
-      result = mem_sub_alloc_fine_uncached_.Free(&lockCacheOps_, ref, offset);
+      result = mem_sub_alloc_fine_uncached_.Free(ref, offset);
     } else {
-      result = mem_sub_alloc_fine_.Free(&lockCacheOps_, ref, offset);
+      result = mem_sub_alloc_fine_.Free(ref, offset);
     }
   }
 
@@ -2250,8 +2294,10 @@ bool ResourceCache::addGpuMemory(Resource::Descriptor* desc, GpuMemoryReference*
     return result;
   }
 
-  // Make sure current allocation isn't bigger than cache
-  if (((desc->type_ == Resource::Local) || (desc->type_ == Resource::Persistent) ||
+  // Make sure current allocation isn't bigger than cache. The allocations with a MALL hint
+  // aren't cached, since the policy is fixed at creation
+  if (!desc->mallPreferred_ && !desc->mallBypass_ &&
+      ((desc->type_ == Resource::Local) || (desc->type_ == Resource::Persistent) ||
        (desc->type_ == Resource::Remote) || (desc->type_ == Resource::RemoteUSWC)) &&
       (size < cacheSizeLimit_ && !(desc->SVMRes_ && desc->reserved_va_))) {
     // Validate the cache size limit. Loop until we have enough space
@@ -2265,8 +2311,12 @@ bool ResourceCache::addGpuMemory(Resource::Descriptor* desc, GpuMemoryReference*
       memcpy(descCached, desc, sizeof(Resource::Descriptor));
 
       amd::ScopedLock l(&lockCacheOps_);
-      // Add the current resource to the cache
-      resCache_.push_front({descCached, ref});
+      // Add the current resource to the cache and to the bucket of its size class
+      const uint64_t key = bucketKey(desc->type_, desc->flags_, size);
+      resCache_.push_front({descCached, ref, key, {}});
+      auto& bucket = buckets_[key];
+      bucket.push_front(resCache_.begin());
+      resCache_.front().bucketPos_ = bucket.begin();
       ref->gpu_ = nullptr;
       cacheSize_ += size;
       if (desc->type_ == Resource::Local) {
@@ -2286,13 +2336,15 @@ GpuMemoryReference* ResourceCache::findGpuMemory(Resource::Descriptor* desc, Pal
                                                  Pal::gpusize alignment,
                                                  const Pal::IGpuMemory* reserved_va,
                                                  Pal::gpusize* offset) {
-  amd::ScopedLock l(&lockCacheOps_);
   GpuMemoryReference* ref = nullptr;
 
-  // Check if the runtime can suballocate memory
+  // Check if the runtime can suballocate memory. The suballocators have their own locks
   if (desc->type_ == Resource::VaRange) {
     // Do not use suballocator for VA_Range.
     return nullptr;
+  } else if (desc->mallPreferred_ || desc->mallBypass_) {
+    // The shared chunks and the cached allocations have the global MALL policy
+    return nullptr;
   } else if ((desc->type_ == Resource::Local) && !desc->SVMRes_) {
     ref = mem_sub_alloc_local_.Allocate(size, alignment, reserved_va, offset);
   } else if ((desc->type_ == Resource::Local) && desc->SVMRes_) {
@@ -2315,28 +2367,31 @@ GpuMemoryReference* ResourceCache::findGpuMemory(Resource::Descriptor* desc, Pal
     return ref;
   }
 
-  // Serach the right resource through the cache list
-  for (const auto& it : resCache_) {
-    Resource::Descriptor* entry = it.first;
-    size_t sizeRes = it.second->iMem()->Desc().size;
-    // Find if we can reuse this entry
-    if ((entry->type_ == desc->type_) && (entry->flags_ == desc->flags_) && (size <= sizeRes) &&
-        (size > (sizeRes >> 1)) && ((it.second->iMem()->Desc().gpuVirtAddr % alignment) == 0) &&
-        (entry->isAllocExecute_ == desc->isAllocExecute_) &&
-        (entry->SVMRes_ == desc->SVMRes_) &&
-        (entry->gl2CacheDisabled_ == desc->gl2CacheDisabled_) &&
-        (entry->interprocess_ == desc->interprocess_)) {
-      ref = it.second;
-      cacheSize_ -= sizeRes;
-      if (entry->type_ == Resource::Local) {
-        lclCacheSize_ -= sizeRes;
-      } else if (entry->type_ == Resource::Persistent) {
-        persistentCacheSize_ -= sizeRes;
+  amd::ScopedLock l(&lockCacheOps_);
+
+  // A reusable resource has the same type and flags and is smaller than twice the requested size,
+  // hence only the size class of the request and the next one are searched
+  const uint64_t key = bucketKey(desc->type_, desc->flags_, size);
+  for (uint64_t sizeClass = 0; sizeClass < 2; ++sizeClass) {
+    auto bucket = buckets_.find(key + sizeClass);
+    if (bucket == buckets_.end()) {
+      continue;
+    }
+    for (auto it : bucket->second) {
+      Resource::Descriptor* entry = it->desc_;
+      size_t sizeRes = it->ref_->iMem()->Desc().size;
+      // Find if we can reuse this entry
+      if ((size <= sizeRes) && (size > (sizeRes >> 1)) &&
+          ((it->ref_->iMem()->Desc().gpuVirtAddr % alignment) == 0) &&
+          (entry->isAllocExecute_ == desc->isAllocExecute_) &&
+          (entry->SVMRes_ == desc->SVMRes_) &&
+          (entry->gl2CacheDisabled_ == desc->gl2CacheDisabled_) &&
+          (entry->interprocess_ == desc->interprocess_)) {
+        ref = it->ref_;
+        // Remove the found entry from the cache
+        removeEntry(it);
+        return ref;
       }
-      delete it.first;
-      // Remove the found etry from the cache
-      resCache_.remove(it);
-      break;
     }
   }
 
@@ -2357,29 +2412,42 @@ bool ResourceCache::free(size_t minCacheEntries) {
   return result;
 }
 
+// ================================================================================================
+void ResourceCache::removeEntry(std::list<CacheEntry>::iterator it) {
+  auto mem_size = it->ref_->iMem()->Desc().size;
+  cacheSize_ -= mem_size;
+  if (it->desc_->type_ == Resource::Local) {
+    lclCacheSize_ -= mem_size;
+  } else if (it->desc_->type_ == Resource::Persistent) {
+    persistentCacheSize_ -= mem_size;
+  }
+  auto bucket = buckets_.find(it->bucket_);
+  bucket->second.erase(it->bucketPos_);
+  if (bucket->second.empty()) {
+    buckets_.erase(bucket);
+  }
+  // Delete Descriptor
+  delete it->desc_;
+  resCache_.erase(it);
+}
+
 // ================================================================================================
 void ResourceCache::removeLast() {
-  std::pair<Resource::Descriptor*, GpuMemoryReference*> entry;
+  GpuMemoryReference* ref = nullptr;
   {
     // Protect access to the global data
     amd::ScopedLock l(&lockCacheOps_);
     if (resCache_.size() > 0) {
-      entry = resCache_.back();
-      resCache_.pop_back();
-      auto mem_size = entry.second->iMem()->Desc().size;
-      cacheSize_ -= mem_size;
-      if (entry.first->type_ == Resource::Local) {
-        lclCacheSize_ -= mem_size;
-      } else if (entry.first->type_ == Resource::Persistent) {
-        persistentCacheSize_ -= mem_size;
-      }
-      // Delete Descriptor
-      delete entry.first;
+      // The back of the list is the least recently used entry of all buckets
+      ref = resCache_.back().ref_;
+      removeEntry(std::prev(resCache_.end()));
     }
   }
 
   // Destroy PAL resource
-  entry.second->release();
+  if (ref != nullptr) {
+    ref->release();
+  }
 }
 
 }  // namespace amd::pal
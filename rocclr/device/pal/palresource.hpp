@@ -218,6 +218,8 @@ class Resource : public amd::HeapObject {
         uint gl2CacheDisabled_ : 1;//!< PAL resource is allocated with GPU L2 cache disabled.
         uint reserved_va_ : 1;     //!< PAL resource was allocated for a reserved VA
         uint interprocess_ : 1;    //!< PAL resource can be shared between processes
+        uint mallPreferred_ : 1;   //!< PAL resource is always put through the MALL
+        uint mallBypass_ : 1;      //!< PAL resource is never put through the MALL
       };
       uint state_;
     };
@@ -533,8 +535,13 @@ class Resource : public amd::HeapObject {
 
 typedef Util::BuddyAllocator<Device> MemBuddyAllocator;
 
+//! Suballocates small resources out of chunks. The chunks are split into shards with independent
+//! locks and a thread allocates from the chunks of its own shard first, so small allocations
+//! from many host threads don't serialize on a single lock
 class MemorySubAllocator : public amd::HeapObject {
  public:
+  static constexpr uint kNumShards = 8;  //!< The number of the shards
+
   MemorySubAllocator(Device* device) : device_(device) {}
 
   ~MemorySubAllocator();
@@ -543,16 +550,30 @@ class MemorySubAllocator : public amd::HeapObject {
   GpuMemoryReference* Allocate(Pal::gpusize size, Pal::gpusize alignment,
                                const Pal::IGpuMemory* reserved_va, Pal::gpusize* offset);
   //! Free suballocation
-  bool Free(amd::Monitor* monitor, GpuMemoryReference* mem_ref, Pal::gpusize offset);
+  bool Free(GpuMemoryReference* mem_ref, Pal::gpusize offset);
 
  protected:
-  //! Allocate new chunk of memory
+  //! The chunks of a shard with their lock
+  struct Shard {
+    Shard() : lock_("PAL suballocator shard", true) {}
+    amd::Monitor lock_;  //!< Serializes the operations on the chunks of the shard
+    std::unordered_map<GpuMemoryReference*, MemBuddyAllocator*> heaps_;  //!< The chunks
+  };
+
+  //! Returns the shard of the current thread
+  static uint threadShard();
+
+  //! Suballocates from the chunks of the shard. The caller holds the shard lock
+  GpuMemoryReference* AllocateFromShard(Shard& shard, Pal::gpusize size, Pal::gpusize alignment,
+                                        const Pal::IGpuMemory* reserved_va, Pal::gpusize* offset);
+
+  //! Allocate new chunk of memory in the shard of the current thread, the caller holds its lock
   virtual bool CreateChunk(const Pal::IGpuMemory* reserved_va);
   bool InitAllocator(GpuMemoryReference* mem_ref);
   void forceResident(GpuMemoryReference* mem_ref);
 
   Device* device_;
-  std::unordered_map<GpuMemoryReference*, MemBuddyAllocator*> heaps_;
+  Shard shards_[kNumShards];  //!< The chunks, split by the thread affinity
 };
 
 class CoarseMemorySubAllocator : public MemorySubAllocator {
@@ -625,6 +646,23 @@ class ResourceCache : public amd::HeapObject {
   //! Disable operator=
   ResourceCache& operator=(const ResourceCache&);
 
+  //! A cached resource. The entries are kept in the LRU order and indexed by the buckets
+  struct CacheEntry {
+    Resource::Descriptor* desc_;  //!< Resource descriptor - cache key
+    GpuMemoryReference* ref_;     //!< The cached resource
+    uint64_t bucket_;             //!< The bucket of the entry
+    std::list<std::list<CacheEntry>::iterator>::iterator bucketPos_;  //!< Position in the bucket
+  };
+
+  //! Returns the bucket of the memory type, the creation flags and the size class
+  static uint64_t bucketKey(Resource::MemoryType type, uint flags, Pal::gpusize size) {
+    return (static_cast<uint64_t>(type) << 40) | (static_cast<uint64_t>(flags) << 8) |
+        amd::log2(size);
+  }
+
+  //! Removes the entry from the LRU list and from its bucket
+  void removeEntry(std::list<CacheEntry>::iterator it);
+
   //! Removes one last entry from the cache
   void removeLast();
 
@@ -635,8 +673,10 @@ class ResourceCache : public amd::HeapObject {
   size_t persistentCacheSize_;  //!< Persistent memory stored in the cache
   const size_t cacheSizeLimit_; //!< Cache size limit in bytes
 
-  //! PAL resource cache
-  std::list<std::pair<Resource::Descriptor*, GpuMemoryReference*> > resCache_;
+  //! PAL resource cache, the most recently used entries at the front
+  std::list<CacheEntry> resCache_;
+  //! The cache entries of a bucket, the most recently used at the front
+  std::unordered_map<uint64_t, std::list<std::list<CacheEntry>::iterator>> buckets_;
 
   MemorySubAllocator mem_sub_alloc_local_;                     //!< Allocator for suballocations in Local
   CoarseMemorySubAllocator mem_sub_alloc_coarse_;              //!< Allocator for suballocations in Coarse SVM
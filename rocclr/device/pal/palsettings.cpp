@@ -498,6 +498,14 @@ void Settings::override() {
     alwaysResident_ = PAL_ALWAYS_RESIDENT;
   }
 
+  // The recorded command buffers don't carry the memory references of the captured dispatches,
+  // hence the reuse requires resident memory. HIP graphs dispatch the packets from the app
+  // thread and rely on the direct dispatch for the order with the other commands
+  if (PAL_REUSE_CMD_BUFFERS && alwaysResident_ && (!amd::IS_HIP || AMD_DIRECT_DISPATCH)) {
+    DEBUG_CLR_GRAPH_PACKET_CAPTURE = true;
+    enableExtension(ClKhrCommandBuffer);
+  }
+
   if (!flagIsDefault(DEBUG_CLR_LIMIT_BLIT_WG)) {
     limit_blit_wg_ = std::max(DEBUG_CLR_LIMIT_BLIT_WG, 0x1U);
   }
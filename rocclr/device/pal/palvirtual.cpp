@@ -143,6 +143,12 @@ VirtualGPU::Queue* VirtualGPU::Queue::Create(VirtualGPU& gpu, Pal::QueueType que
   VirtualGPU::Queue* queue =
       new (allocSize) VirtualGPU::Queue(gpu, palDev, residency_limit, max_command_buffers);
   if (queue != nullptr) {
+    queue->cmdCreateInfo_ = cmdCreateInfo;
+    // The higher priority queues trade more CPU time for the lower sync latency
+    queue->maxSpinTime_ = ((qCreateInfo.priority == Pal::QueuePriority::Normal) ?
+        PAL_FENCE_SPIN_US : PAL_FENCE_SPIN_US_HIGH_PRIORITY) * 1000ULL;
+    // Start with the full spin, until the waits measure the completion times
+    queue->avgCompletion_ = queue->maxSpinTime_ / 2;
     address addrQ = nullptr;
     if (((qCreateInfo.engineType == Pal::EngineTypeCompute) ||
          (qCreateInfo.engineType == Pal::EngineTypeDma)) &&
@@ -310,10 +316,10 @@ void VirtualGPU::Queue::addCmdMemRef(GpuMemoryReference* mem) {
   Pal::IGpuMemory* iMem = mem->iMem();
   auto it = memReferences_.find(mem);
   if (it != memReferences_.end()) {
-    it->second = cmdBufIdSlot_;
+    it->second = cmdBufIdCurrent_;
   } else {
     // Update runtime tracking with TS
-    memReferences_[mem] = cmdBufIdSlot_;
+    memReferences_[mem] = cmdBufIdCurrent_;
     // Update PAL list with the new entry
     Pal::GpuMemoryRef memRef = {};
     memRef.pGpuMemory = iMem;
@@ -415,12 +421,13 @@ bool VirtualGPU::Queue::flush() {
     }
     if (amd::IS_HIP) {
       // HIP disables per resource tracking, because the app may embed SVM ptr into other buffers.
-      // Force CPU sync if there are pending operations on SDMA, until OS fences will be added
-      gpu_.WaitForIdleSdma();
+      // Hence compute waits for the pending operations on SDMA
+      gpu_.syncEngines(MainEngine, &gpu_.events_[SdmaEngine]);
     }
   }
   // Submit command buffer to OS
   Pal::Result result;
+  submitTime_[cmdBufIdSlot_] = amd::Os::timeNanos();
   if (gpu_.rgpCaptureEna()) {
     result = gpu_.dev().captureMgr()->TimedQueueSubmit(iQueue_, cmdBufIdCurrent_, submitInfo);
   } else {
@@ -447,6 +454,10 @@ bool VirtualGPU::Queue::flush() {
     waifForFence<!IbReuse>(cmdBufIdSlot_);
     cmdBufIdCurrent_ = 1;
     cmbBufIdRetired_ = 0;
+    // All submissions are done, so restart the generations of the memory references
+    for (auto& it : memReferences_) {
+      it.second = 0;
+    }
   }
 
   // Wrap current slot
@@ -477,18 +488,8 @@ bool VirtualGPU::Queue::flush() {
   palDoppRefs_.clear();
   palSdiRefs_.clear();
 
-  // Remove old memory references
-  if ((memReferences_.size() > 2048) || (residency_size_ > residency_limit_)) {
-    for (auto it = memReferences_.begin(); it != memReferences_.end();) {
-      if (it->second == cmdBufIdSlot_) {
-        palMems_.push_back(it->first->iMem());
-        residency_size_ -= it->first->iMem()->Desc().size;
-        it = memReferences_.erase(it);
-      } else {
-        ++it;
-      }
-    }
-  }
+  // Remove cold memory references
+  trimMemReferences();
   if (!settings.alwaysResident_ && palMems_.size() != 0) {
     iDev_->RemoveGpuMemoryReferences(palMems_.size(), &palMems_[0], iQueue_);
     palMems_.clear();
@@ -497,6 +498,42 @@ bool VirtualGPU::Queue::flush() {
   return true;
 }
 
+// ================================================================================================
+void VirtualGPU::Queue::trimMemReferences() {
+  const bool overLimit = (memReferences_.size() > MaxMemReferences) ||
+                         ((residency_limit_ != 0) && (residency_size_ > residency_limit_));
+  // The idle references age out once per cycle of the command buffers, hence the hot working set
+  // stays resident across the submissions and KMD receives only the deltas
+  if (!overLimit && (cmdBufIdSlot_ != StartCmdBufIdx)) {
+    return;
+  }
+
+  // Only the references of the retired command buffers can leave the list
+  std::vector<std::pair<uint, GpuMemoryReference*>> retired;
+  for (const auto& it : memReferences_) {
+    if (it.second <= cmbBufIdRetired_) {
+      retired.push_back({it.second, it.first});
+    }
+  }
+  // Evict the oldest generations first. The limit has a hysteresis, so the list isn't trimmed
+  // on every submission of a large working set
+  std::sort(retired.begin(), retired.end());
+  const size_t lowRefs = MaxMemReferences - MaxMemReferences / 8;
+  const uint64_t lowSize = residency_limit_ - residency_limit_ / 8;
+  for (const auto& it : retired) {
+    const bool aged = (cmdBufIdCurrent_ - it.first) > PAL_RESIDENCY_GENERATIONS;
+    const bool over = (memReferences_.size() > lowRefs) ||
+                      ((residency_limit_ != 0) && (residency_size_ > lowSize));
+    if (!aged && !(overLimit && over)) {
+      break;
+    }
+    Pal::IGpuMemory* iMem = it.second->iMem();
+    palMems_.push_back(iMem);
+    residency_size_ -= iMem->Desc().size;
+    memReferences_.erase(it.second);
+  }
+}
+
 // ================================================================================================
 bool VirtualGPU::Queue::waitForEvent(uint id) {
   amd::ScopedLock l(lock_);
@@ -948,6 +985,26 @@ bool VirtualGPU::create(bool profiling, uint deviceQueueSize, uint rtCUs,
       if (nullptr == queues_[SdmaEngine]) {
         return false;
       }
+      if (PAL_ENGINE_SEMAPHORES) {
+        // The dependencies between compute and SDMA are resolved on the GPU, so the engines
+        // overlap the independent work without CPU stalls
+        Pal::QueueSemaphoreCreateInfo semInfo = {};
+        semInfo.flags.timeline = true;
+        semInfo.maxCount = 1;
+        Pal::Result result;
+        size_t semSize = dev().iDev()->GetQueueSemaphoreSize(semInfo, &result);
+        for (uint i = 0; (result == Pal::Result::Success) && (i < AllEngines); ++i) {
+          void* mem = amd::Os::alignedMalloc(semSize, 16);
+          result = dev().iDev()->CreateQueueSemaphore(semInfo, mem, &engineSems_[i]);
+          if (result != Pal::Result::Success) {
+            amd::Os::alignedFree(mem);
+            engineSems_[i] = nullptr;
+          }
+        }
+        if (result != Pal::Result::Success) {
+          LogWarning("PAL couldn't create the engine semaphores, CPU syncs are used instead");
+        }
+      }
     }
   } else {
     LogError("Runtme couldn't find compute queues!");
@@ -1078,6 +1135,11 @@ VirtualGPU::~VirtualGPU() {
     dev().captureMgr()->FinishRGPTrace(this, true);
   }
 
+  for (auto& recorded : recorded_) {
+    releaseRecorded(recorded);
+  }
+  recorded_.clear();
+
   while (!freeCbQueue_.empty()) {
     auto cb = freeCbQueue_.front();
     delete cb;
@@ -1117,6 +1179,14 @@ VirtualGPU::~VirtualGPU() {
     delete queues_[MainEngine];
     delete queues_[SdmaEngine];
 
+    for (auto& sem : engineSems_) {
+      if (sem != nullptr) {
+        sem->Destroy();
+        amd::Os::alignedFree(sem);
+        sem = nullptr;
+      }
+    }
+
     if (nullptr != cmdAllocator_) {
       cmdAllocator_->Destroy();
       delete[] reinterpret_cast<char*>(cmdAllocator_);
@@ -2174,19 +2244,31 @@ void VirtualGPU::submitMigrateMemObjects(amd::MigrateMemObjectsCommand& vcmd) {
   profilingBegin(vcmd, true);
 
   for (const auto& it : vcmd.memObjects()) {
-    // Find device memory
-    pal::Memory* memory = dev().getGpuMemory(it);
-
     if (vcmd.migrationFlags() & CL_MIGRATE_MEM_OBJECT_HOST) {
-      memory->mgpuCacheWriteBack(*this);
-    } else if (vcmd.migrationFlags() & CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED) {
+      // Don't allocate device memory just for the write back. If this device never used
+      // the object, then only the last writer can have newer data than the host
+      const amd::Device* writer = (it->getLastWriter() != nullptr) ? it->getLastWriter() : &dev();
+      pal::Memory* memory = static_cast<pal::Memory*>(it->getDeviceMemory(dev(), false));
+      if (memory == nullptr) {
+        memory = static_cast<pal::Memory*>(it->getDeviceMemory(*writer, false));
+      }
+      if (memory != nullptr) {
+        memory->mgpuCacheWriteBack(*this);
+      }
+      continue;
+    }
+
+    // Find device memory, it's allocated on the first use by this device
+    pal::Memory* memory = dev().getGpuMemory(it);
+    if (vcmd.migrationFlags() & CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED) {
+      // The content isn't needed, so just make this device the owner of the data
+      it->signalWrite(&dev());
+    } else {
       // Synchronize memory from host if necessary.
       // The sync function will perform memory migration from
       // another device if necessary
       device::Memory::SyncFlags syncFlags;
       memory->syncCacheFromHost(*this, syncFlags);
-    } else {
-      LogWarning("Unknown operation for memory migration!");
     }
   }
 
@@ -2258,71 +2340,95 @@ void VirtualGPU::submitVirtualMap(amd::VirtualMapCommand& vcmd) {
   amd::ScopedLock lock(execution());
 
   profilingBegin(vcmd);
-  amd::Memory* phys_mem_obj = vcmd.memory();
-  amd::Memory* vaddr_base_obj = amd::MemObjMap::FindVirtualMemObj(vcmd.ptr());
-  if (vaddr_base_obj == nullptr || !(vaddr_base_obj->getMemFlags() & CL_MEM_VA_RANGE_AMD)) {
-    profilingEnd(vcmd);
-    return;
-  }
 
-  // Create a view, since original base obj will map the whole memory and multimap cases wont work.
-  amd::Memory* vaddr_sub_obj = nullptr;
-  size_t vaddr_offset = 0;
-  if (phys_mem_obj != nullptr) {
-    constexpr bool kParent = false;
-    vaddr_sub_obj = phys_mem_obj->getContext().devices()[0]->CreateVirtualBuffer(
-                      phys_mem_obj->getContext(), const_cast<void*>(vcmd.ptr()),
-                      vcmd.size(), phys_mem_obj->getUserData().deviceId, kParent);
+  // Collect all ranges of the batch, so PAL remaps them with a single paging operation
+  std::vector<Pal::VirtualMemoryRemapRange> ranges;
+  std::vector<std::pair<amd::VirtualMapCommand::Range, amd::Memory*>> views;
+  ranges.reserve(vcmd.count());
+  views.reserve(vcmd.count());
+  bool unmap = false;
+  for (size_t idx = 0; idx < vcmd.count(); ++idx) {
+    const amd::VirtualMapCommand::Range vrange = vcmd.range(idx);
+    amd::Memory* phys_mem_obj = vrange.memory_;
+    amd::Memory* vaddr_base_obj = amd::MemObjMap::FindVirtualMemObj(vrange.ptr_);
+    if (vaddr_base_obj == nullptr || !(vaddr_base_obj->getMemFlags() & CL_MEM_VA_RANGE_AMD)) {
+      continue;
+    }
 
-    // Calculate the offset from the original pointer.
-    vaddr_offset = (reinterpret_cast<address>(vaddr_sub_obj->getSvmPtr())
-                     - reinterpret_cast<address>(vaddr_base_obj->getSvmPtr()));
-  }
+    // Create a view, since original base obj will map the whole memory and multimap cases
+    // wont work.
+    amd::Memory* vaddr_sub_obj = nullptr;
+    size_t vaddr_offset = 0;
+    if (phys_mem_obj != nullptr) {
+      constexpr bool kParent = false;
+      vaddr_sub_obj = phys_mem_obj->getContext().devices()[0]->CreateVirtualBuffer(
+                        phys_mem_obj->getContext(), const_cast<void*>(vrange.ptr_),
+                        vrange.size_, phys_mem_obj->getUserData().deviceId, kParent);
+
+      // Calculate the offset from the original pointer.
+      vaddr_offset = (reinterpret_cast<address>(vaddr_sub_obj->getSvmPtr())
+                       - reinterpret_cast<address>(vaddr_base_obj->getSvmPtr()));
+    } else {
+      unmap = true;
+    }
 
-  // The imem() in the backend is shared between base and sub/view object.
-  pal::Memory* vaddr_pal_mem = dev().getGpuMemory(vaddr_base_obj);
-  Pal::IGpuMemory* phymem_igpu_mem = (phys_mem_obj == nullptr) ?
-      nullptr : dev().getGpuMemory(phys_mem_obj)->iMem();
+    // The imem() in the backend is shared between base and sub/view object.
+    pal::Memory* vaddr_pal_mem = dev().getGpuMemory(vaddr_base_obj);
+    Pal::IGpuMemory* phymem_igpu_mem = (phys_mem_obj == nullptr) ?
+        nullptr : dev().getGpuMemory(phys_mem_obj)->iMem();
 
-  Pal::VirtualMemoryRemapRange range{
-    vaddr_pal_mem->iMem(),
-    vaddr_offset,
-    phymem_igpu_mem,
-    0,
-    vcmd.size(),
-    Pal::VirtualGpuMemAccessMode::NoAccess
-  };
+    ranges.push_back(Pal::VirtualMemoryRemapRange{
+      vaddr_pal_mem->iMem(),
+      vaddr_offset,
+      phymem_igpu_mem,
+      vrange.offset_,
+      vrange.size_,
+      Pal::VirtualGpuMemAccessMode::NoAccess
+    });
+    views.push_back({vrange, vaddr_sub_obj});
+  }
+
+  if (ranges.empty()) {
+    profilingEnd(vcmd);
+    return;
+  }
 
   // Wait for previous operations before unmap
-  if (phys_mem_obj == nullptr) {
+  if (unmap) {
     // @note: Need to verify if compute requires a wait or IB flush is enough
     WaitForIdleCompute();
     WaitForIdleSdma();
   }
 
   eventBegin(MainEngine);
-  auto result = queue(MainEngine).iQueue_->RemapVirtualMemoryPages(1, &range, false, nullptr);
+  auto result = queue(MainEngine).iQueue_->RemapVirtualMemoryPages(
+      static_cast<uint32_t>(ranges.size()), ranges.data(), false, nullptr);
   // Capture GPU event for the paging operation
   GpuEvent event;
   eventEnd(MainEngine, event);
   setGpuEvent(event);
   if (result == Pal::Result::Success) {
-    if (phys_mem_obj != nullptr) {
-      // assert the vaddr_mem_obj wasn't mapped already
-      assert(amd::MemObjMap::FindMemObj(vcmd.ptr()) == nullptr);
-      amd::MemObjMap::AddMemObj(vcmd.ptr(), vaddr_sub_obj);
-      vaddr_sub_obj->getUserData().phys_mem_obj = phys_mem_obj;
-      phys_mem_obj->getUserData().vaddr_mem_obj = vaddr_sub_obj;
-    } else {
-      // assert the vaddr_mem_obj is mapped and needs to be removed
-      amd::Memory* vaddr_sub_obj = amd::MemObjMap::FindMemObj(vcmd.ptr());
-      assert(vaddr_sub_obj != nullptr);
-      assert(vcmd.ptr() == vaddr_sub_obj->getSvmPtr());
-
-      amd::MemObjMap::RemoveMemObj(vcmd.ptr());
-      if (vaddr_sub_obj->getUserData().phys_mem_obj != nullptr) {
-        vaddr_sub_obj->getUserData().phys_mem_obj->getUserData().vaddr_mem_obj = nullptr;
-        vaddr_sub_obj->getUserData().phys_mem_obj = nullptr;
+    for (const auto& view : views) {
+      const void* ptr = view.first.ptr_;
+      amd::Memory* phys_mem_obj = view.first.memory_;
+      if (phys_mem_obj != nullptr) {
+        amd::Memory* vaddr_sub_obj = view.second;
+        // assert the vaddr_mem_obj wasn't mapped already
+        assert(amd::MemObjMap::FindMemObj(ptr) == nullptr);
+        amd::MemObjMap::AddMemObj(ptr, vaddr_sub_obj);
+        vaddr_sub_obj->getUserData().phys_mem_obj = phys_mem_obj;
+        phys_mem_obj->getUserData().vaddr_mem_obj = vaddr_sub_obj;
+      } else {
+        // assert the vaddr_mem_obj is mapped and needs to be removed
+        amd::Memory* vaddr_sub_obj = amd::MemObjMap::FindMemObj(ptr);
+        assert(vaddr_sub_obj != nullptr);
+        assert(ptr == vaddr_sub_obj->getSvmPtr());
+
+        amd::MemObjMap::RemoveMemObj(ptr);
+        if (vaddr_sub_obj->getUserData().phys_mem_obj != nullptr) {
+          vaddr_sub_obj->getUserData().phys_mem_obj->getUserData().vaddr_mem_obj = nullptr;
+          vaddr_sub_obj->getUserData().phys_mem_obj = nullptr;
+        }
       }
     }
   }
@@ -2697,6 +2803,14 @@ bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
     }
   }
 
+  // The captured packet must be a complete dispatch without the runtime work after the execution
+  if (isPacketCapturing() && ((iteration > 1) || printfEnabled || imageBufferWrtBack ||
+                              hsaKernel.dynamicParallelism() || rgpCaptureEna())) {
+    LogPrintfError("Kernel %s can't be captured for a PAL command buffer",
+                   hsaKernel.name().c_str());
+    return false;
+  }
+
   for (int iter = 0; iter < iteration; ++iter) {
     GpuEvent gpuEvent(queues_[MainEngine]->cmdBufId());
     uint32_t id = gpuEvent.id_;
@@ -2737,44 +2851,23 @@ bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
 
     uint64_t vmParentWrap = 0;
     uint32_t aql_index = 0;
+    address hostArgs = nullptr;
     // Program the kernel arguments for the GPU execution
     hsa_kernel_dispatch_packet_t* aqlPkt = hsaKernel.loadArguments(
-        *this, kernel, tmpSizes, parameters, ldsSize + sharedMemBytes, vmDefQueue, &vmParentWrap, &aql_index);
+        *this, kernel, tmpSizes, parameters, ldsSize + sharedMemBytes, vmDefQueue, &vmParentWrap,
+        &aql_index, &hostArgs);
     if (nullptr == aqlPkt) {
       LogError("Couldn't load kernel arguments");
       return false;
     }
-    // Dynamic call stack size is considered to calculate private segment size and scratch regs
-    // in LightningKernel::postLoad(). As it is not called during hipModuleLaunchKernel unlike
-    // hipLaunchKernel/hipLaunchKernelGGL, Updated value is passed to dispatch packet.
-    size_t privateMemSize = hsaKernel.spillSegSize();
-    if ((hsaKernel.workGroupInfo()->usedStackSize_ & 0x1) == 0x1) {
-      privateMemSize = std::max<uint32_t>(static_cast<uint32_t>(device().StackSize()),
-                                hsaKernel.workGroupInfo()->scratchRegs_ * sizeof(uint32_t)) ;
+    if (isPacketCapturing()) {
+      // The packet is dispatched later with dispatchAqlPacket()
+      return captureDispatch(hsaKernel, aqlPkt, hostArgs);
     }
 
     // Set up the dispatch information
     Pal::DispatchAqlParams dispatchParam = {};
-    dispatchParam.pAqlPacket = aqlPkt;
-    if (privateMemSize > 0) {
-      const Device::ScratchBuffer* scratch = dev().scratch(hwRing());
-      dispatchParam.scratchAddr = scratch->memObj_->vmAddress();
-      dispatchParam.scratchSize = scratch->size_;
-      dispatchParam.scratchOffset = scratch->offset_;
-      dispatchParam.workitemPrivateSegmentSize = privateMemSize;
-    }
-    dispatchParam.pCpuAqlCode = hsaKernel.cpuAqlCode();
-    dispatchParam.hsaQueueVa = hsaQueueMem_->vmAddress();
-    if (!hsaKernel.prog().isLC() && hsaKernel.workGroupInfo()->wavesPerSimdHint_ != 0) {
-      constexpr uint32_t kWavesPerSimdLimit = 4;
-      dispatchParam.wavesPerSh = kWavesPerSimdLimit *
-        dev().info().cuPerShaderArray_ * dev().info().simdPerCU_;
-    } else {
-      dispatchParam.wavesPerSh = 0;
-    }
-    dispatchParam.useAtc = dev().settings().svmFineGrainSystem_ ? true : false;
-    dispatchParam.kernargSegmentSize = hsaKernel.argsBufferSize();
-    dispatchParam.aqlPacketIndex = aql_index;
+    setupDispatch(hsaKernel, aqlPkt, aql_index, &dispatchParam);
     // Run AQL dispatch in HW
     eventBegin(MainEngine);
     iCmd()->CmdDispatchAql(dispatchParam);
@@ -2823,6 +2916,227 @@ bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
   return true;
 }
 
+// ================================================================================================
+void VirtualGPU::setupDispatch(const HSAILKernel& hsaKernel, hsa_kernel_dispatch_packet_t* aqlPkt,
+                               uint32_t aqlIndex, Pal::DispatchAqlParams* dispatchParam) {
+  // Dynamic call stack size is considered to calculate private segment size and scratch regs
+  // in LightningKernel::postLoad(). As it is not called during hipModuleLaunchKernel unlike
+  // hipLaunchKernel/hipLaunchKernelGGL, Updated value is passed to dispatch packet.
+  size_t privateMemSize = hsaKernel.spillSegSize();
+  if ((hsaKernel.workGroupInfo()->usedStackSize_ & 0x1) == 0x1) {
+    privateMemSize = std::max<uint32_t>(static_cast<uint32_t>(device().StackSize()),
+                              hsaKernel.workGroupInfo()->scratchRegs_ * sizeof(uint32_t)) ;
+  }
+
+  dispatchParam->pAqlPacket = aqlPkt;
+  if (privateMemSize > 0) {
+    const Device::ScratchBuffer* scratch = dev().scratch(hwRing());
+    dispatchParam->scratchAddr = scratch->memObj_->vmAddress();
+    dispatchParam->scratchSize = scratch->size_;
+    dispatchParam->scratchOffset = scratch->offset_;
+    dispatchParam->workitemPrivateSegmentSize = privateMemSize;
+  }
+  dispatchParam->pCpuAqlCode = hsaKernel.cpuAqlCode();
+  dispatchParam->hsaQueueVa = hsaQueueMem_->vmAddress();
+  if (!hsaKernel.prog().isLC() && hsaKernel.workGroupInfo()->wavesPerSimdHint_ != 0) {
+    constexpr uint32_t kWavesPerSimdLimit = 4;
+    dispatchParam->wavesPerSh = kWavesPerSimdLimit *
+      dev().info().cuPerShaderArray_ * dev().info().simdPerCU_;
+  } else {
+    dispatchParam->wavesPerSh = 0;
+  }
+  dispatchParam->useAtc = dev().settings().svmFineGrainSystem_ ? true : false;
+  dispatchParam->kernargSegmentSize = hsaKernel.argsBufferSize();
+  dispatchParam->aqlPacketIndex = aqlIndex;
+}
+
+// ================================================================================================
+bool VirtualGPU::captureDispatch(const HSAILKernel& hsaKernel,
+                                 hsa_kernel_dispatch_packet_t* aqlPkt, address hostArgs) {
+  // Move the arguments into the capture pool, which keeps them for the lifetime of the packet
+  const size_t argsSize = hsaKernel.argsBufferSize();
+  address argBuffer = currCmd_->getKernArgOffset(
+      argsSize, std::max<uint32_t>(hsaKernel.KernargSegmentAlignment(), 16));
+  if (argBuffer == nullptr) {
+    LogError("Couldn't allocate the captured kernel arguments");
+    return false;
+  }
+  memcpy(argBuffer, hostArgs, argsSize);
+  currCmd_->SetKernelName(hsaKernel.name());
+
+  auto packet = reinterpret_cast<hsa_kernel_dispatch_packet_t*>(
+      const_cast<uint8_t*>(currCmd_->getAqlPacket()));
+  *packet = *aqlPkt;
+  packet->kernarg_address = currCmd_->getKernArgAddress(argBuffer);
+  // PAL doesn't use the reserved field, so it keeps the kernel for the dispatch parameters
+  packet->reserved2 = reinterpret_cast<uint64_t>(&hsaKernel);
+  return true;
+}
+
+// ================================================================================================
+uint32_t VirtualGPU::dispatchCaptured(Pal::ICmdBuffer* iCmd, const uint8_t* packet) {
+  auto captured = reinterpret_cast<const hsa_kernel_dispatch_packet_t*>(packet);
+  const HSAILKernel& hsaKernel = *reinterpret_cast<const HSAILKernel*>(captured->reserved2);
+
+  uint32_t aqlIndex = 0;
+  hsa_kernel_dispatch_packet_t* aqlPkt = GetAqlPacketSlot(&aqlIndex);
+  *aqlPkt = *captured;
+  aqlPkt->reserved2 = 0;
+
+  Pal::DispatchAqlParams dispatchParam = {};
+  setupDispatch(hsaKernel, aqlPkt, aqlIndex, &dispatchParam);
+  // The captured packets are ordered, as the kernel launches of a queue
+  writeBarrier(iCmd, RgpSqqtBarrierReason::MemDependency);
+  iCmd->CmdDispatchAql(dispatchParam);
+  return aqlIndex;
+}
+
+// ================================================================================================
+bool VirtualGPU::dispatchAqlPacket(uint8_t* aqlpacket, const std::string& kernelName,
+                                   amd::AccumulateCommand* vcmd) {
+  if (vcmd != nullptr) {
+    vcmd->addKernelName(kernelName);
+  }
+  amd::ScopedLock lock(execution());
+  if (deferDispatches_) {
+    deferredPackets_.push_back(aqlpacket);
+    return true;
+  }
+  GpuEvent gpuEvent(queues_[MainEngine]->cmdBufId());
+  eventBegin(MainEngine);
+  uint32_t aqlIndex = dispatchCaptured(iCmd(), aqlpacket);
+  eventEnd(MainEngine, gpuEvent);
+  AqlPacketUpdateTs(aqlIndex, gpuEvent);
+  constexpr bool kNeedFLush = false;
+  setGpuEvent(gpuEvent, kNeedFLush);
+  return true;
+}
+
+// ================================================================================================
+void VirtualGPU::BeginDoorbellBatch() {
+  amd::ScopedLock lock(execution());
+  deferDispatches_ = true;
+}
+
+// ================================================================================================
+void VirtualGPU::EndDoorbellBatch() {
+  amd::ScopedLock lock(execution());
+  deferDispatches_ = false;
+  flushDeferredDispatches();
+}
+
+// ================================================================================================
+void VirtualGPU::flushDeferredDispatches() {
+  if (deferredPackets_.empty()) {
+    return;
+  }
+  RecordedDispatches* recorded = recordDispatches(deferredPackets_);
+
+  GpuEvent gpuEvent(queues_[MainEngine]->cmdBufId());
+  eventBegin(MainEngine);
+  if (recorded != nullptr) {
+    // Only the kernel arguments could change since the recording and they are in memory
+    iCmd()->CmdExecuteNestedCmdBuffers(1, &recorded->iCmd_);
+  } else {
+    for (auto packet : deferredPackets_) {
+      dispatchCaptured(iCmd(), packet);
+    }
+  }
+  eventEnd(MainEngine, gpuEvent);
+  if (recorded != nullptr) {
+    recorded->event_ = gpuEvent;
+  }
+  // The following commands don't track the memory, written by the captured dispatches
+  addBarrier(RgpSqqtBarrierReason::MemDependency);
+  constexpr bool kNeedFLush = false;
+  setGpuEvent(gpuEvent, kNeedFLush);
+  deferredPackets_.clear();
+}
+
+// ================================================================================================
+VirtualGPU::RecordedDispatches* VirtualGPU::recordDispatches(
+    const std::vector<const uint8_t*>& packets) {
+  if (PAL_REUSE_CMD_BUFFERS_CACHE == 0) {
+    return nullptr;
+  }
+  // A graph update rewrites the packets in place, hence the digest covers the contents.
+  // The scratch buffer may grow after the recording, so it invalidates the recording also
+  uint64_t digest = 0xcbf29ce484222325ULL;
+  auto fold = [&digest](uint64_t value) { digest = (digest ^ value) * 0x100000001b3ULL; };
+  for (auto packet : packets) {
+    auto words = reinterpret_cast<const uint64_t*>(packet);
+    for (size_t i = 0; i < sizeof(hsa_kernel_dispatch_packet_t) / sizeof(uint64_t); ++i) {
+      fold(words[i]);
+    }
+  }
+  const Device::ScratchBuffer* scratch = dev().scratch(hwRing());
+  if (scratch->memObj_ != nullptr) {
+    fold(scratch->memObj_->vmAddress());
+    fold(scratch->size_);
+  }
+
+  for (auto it = recorded_.begin(); it != recorded_.end(); ++it) {
+    if ((it->digest_ == digest) && (it->packets_ == packets)) {
+      recorded_.splice(recorded_.begin(), recorded_, it);
+      return &recorded_.front();
+    }
+  }
+
+  if (recorded_.size() >= PAL_REUSE_CMD_BUFFERS_CACHE) {
+    releaseRecorded(recorded_.back());
+    recorded_.pop_back();
+  }
+
+  RecordedDispatches recorded;
+  Pal::CmdBufferCreateInfo createInfo = queues_[MainEngine]->cmdCreateInfo();
+  createInfo.flags.nested = true;
+  Pal::Result result;
+  size_t cmdSize = dev().iDev()->GetCmdBufferSize(createInfo, &result);
+  if (result != Pal::Result::Success) {
+    LogError("PAL failed to find the size of a nested command buffer!");
+    return nullptr;
+  }
+  recorded.memory_ = new uint8_t[cmdSize];
+  result = dev().iDev()->CreateCmdBuffer(createInfo, recorded.memory_, &recorded.iCmd_);
+  if (result != Pal::Result::Success) {
+    LogError("PAL failed to create a nested command buffer!");
+    recorded.iCmd_ = nullptr;
+    releaseRecorded(recorded);
+    return nullptr;
+  }
+  // The command buffer is resubmitted, hence it can't be optimized for one submission
+  Pal::CmdBufferBuildInfo buildInfo = {};
+  if (Pal::Result::Success != recorded.iCmd_->Begin(buildInfo)) {
+    LogError("PAL failed to begin a nested command buffer!");
+    releaseRecorded(recorded);
+    return nullptr;
+  }
+  for (auto packet : packets) {
+    dispatchCaptured(recorded.iCmd_, packet);
+  }
+  if (Pal::Result::Success != recorded.iCmd_->End()) {
+    LogError("PAL failed to finalize a nested command buffer!");
+    releaseRecorded(recorded);
+    return nullptr;
+  }
+  recorded.packets_ = packets;
+  recorded.digest_ = digest;
+  recorded_.push_front(std::move(recorded));
+  return &recorded_.front();
+}
+
+// ================================================================================================
+void VirtualGPU::releaseRecorded(RecordedDispatches& recorded) {
+  // The command buffer can't be destroyed while the GPU executes it
+  waitForEvent(&recorded.event_);
+  if (recorded.iCmd_ != nullptr) {
+    recorded.iCmd_->Destroy();
+    recorded.iCmd_ = nullptr;
+  }
+  delete[] recorded.memory_;
+  recorded.memory_ = nullptr;
+}
+
 // ================================================================================================
 void VirtualGPU::submitNativeFn(amd::NativeFnCommand& vcmd) {
   // Make sure VirtualGPU has an exclusive access to the resources
@@ -3234,6 +3548,10 @@ void VirtualGPU::flush(amd::Command* list, bool wait) {
   CommandBatch* cb = nullptr;
   bool gpuCommand = false;
 
+  if (!deferredPackets_.empty()) {
+    flushDeferredDispatches();
+  }
+
   for (uint i = 0; i < AllEngines; ++i) {
     if (events_[i].isValid()) {
       gpuCommand = true;
@@ -3414,6 +3732,14 @@ bool VirtualGPU::allocConstantBuffers() {
 }
 
 void VirtualGPU::profilingBegin(amd::Command& command, bool drmProfiling) {
+  if (command.getPktCapturingState()) {
+    // The capture doesn't submit anything, hence it doesn't need a timestamp
+    currCmd_ = &command;
+    return;
+  }
+  if (!deferredPackets_.empty()) {
+    flushDeferredDispatches();
+  }
   // Is profiling enabled?
   if (command.profilingInfo().enabled_) {
     // Allocate a timestamp object from the cache
@@ -3429,6 +3755,7 @@ void VirtualGPU::profilingBegin(amd::Command& command, bool drmProfiling) {
 }
 
 void VirtualGPU::profilingEnd(amd::Command& command) {
+  currCmd_ = nullptr;
   // Get the TimeStamp object associated witht the current command
   TimeStamp* ts = !command.data().empty() ? reinterpret_cast<TimeStamp*>(command.data().back())
                                             : nullptr;
@@ -3863,6 +4190,39 @@ bool VirtualGPU::validateSdmaOverlap(const Resource& src, const Resource& dst) {
   return false;
 }
 
+// ================================================================================================
+void VirtualGPU::syncEngines(EngineType engine, GpuEvent* event) {
+  if (!event->isValid() || (event->engineId_ == engine)) {
+    return;
+  }
+  const EngineType signaler = static_cast<EngineType>(event->engineId_);
+  if ((engineSems_[MainEngine] == nullptr) || (engineSems_[SdmaEngine] == nullptr) ||
+      (queues_[engine] == nullptr)) {
+    waitForEvent(event);
+    return;
+  }
+  // Skip the submissions, which the engine waits for already. The IDs restart on a wrap
+  if ((event->id_ <= syncedIds_[signaler]) &&
+      (syncedIds_[signaler] <= queues_[signaler]->cmdBufId())) {
+    return;
+  }
+  // Check the status, that also submits the command buffer of the event
+  if (isDone(event)) {
+    return;
+  }
+  // The semaphore is signaled after all previous submissions on the queue
+  const uint64_t value = ++engineSemValues_[signaler];
+  {
+    amd::ScopedLock l(queues_[signaler]->lock_);
+    queues_[signaler]->iQueue_->SignalQueueSemaphore(engineSems_[signaler], value);
+  }
+  {
+    amd::ScopedLock l(queues_[engine]->lock_);
+    queues_[engine]->iQueue_->WaitQueueSemaphore(engineSems_[signaler], value);
+  }
+  syncedIds_[signaler] = event->id_;
+}
+
 // ================================================================================================
 void* VirtualGPU::getOrCreateHostcallBuffer() {
   if (hostcallBuffer_ != nullptr) {
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <list>
 #include <queue>
 #include "device/pal/paldefs.hpp"
 #include "device/pal/palconstbuf.hpp"
@@ -82,8 +83,9 @@ class VirtualGPU : public device::VirtualDevice {
     static constexpr uint MaxCommands = 256;
     static constexpr uint StartCmdBufIdx = 1;
     static constexpr uint FirstMemoryReference = 0x80000000;
+    static constexpr size_t MaxMemReferences = 2048;
     static constexpr uint64_t WaitTimeoutInNsec = 6000000000;
-    static constexpr uint64_t PollIntervalInNsec = 200000;
+    static constexpr uint64_t MinSpinInNsec = 5000;
 
     Queue(const Queue&) = delete;
     Queue& operator=(const Queue&) = delete;
@@ -103,6 +105,7 @@ class VirtualGPU : public device::VirtualDevice {
           iQueue_(nullptr),
           iCmdBuffs_(max_command_buffers, nullptr),
           iCmdFences_(max_command_buffers, nullptr),
+          submitTime_(max_command_buffers, 0),
           last_kernel_(nullptr),
           gpu_(gpu),
           iDev_(iDev),
@@ -141,18 +144,29 @@ class VirtualGPU : public device::VirtualDevice {
       Pal::Result result = Pal::Result::Success;
       uint64_t start;
       uint64_t end;
+      uint64_t spinTime = 0;
+      bool pending = false;
       if (!ibReuse) {
         start = amd::Os::timeNanos();
+        // Spin only if the submission is expected to complete within the spin limit,
+        // otherwise the OS wait doesn't add much to the execution time
+        const uint64_t expected = submitTime_[cbId] + 2 * avgCompletion_;
+        if (expected < (start + maxSpinTime_)) {
+          spinTime = (expected > start) ? std::max(expected - start, MinSpinInNsec) :
+                                          MinSpinInNsec;
+          spinTime = std::min(spinTime, maxSpinTime_);
+        }
       }
       while ((Pal::Result::Success != (result = iCmdFences_[cbId]->GetStatus())) || ibReuse) {
         if (result == Pal::Result::ErrorFenceNeverSubmitted) {
           result = Pal::Result::Success;
           break;
         }
+        pending = true;
         if (!ibReuse) {
           end = amd::Os::timeNanos();
         }
-        if (!ibReuse && ((end - start) < PollIntervalInNsec)) {
+        if (!ibReuse && ((end - start) < spinTime)) {
           amd::Os::yield();
           continue;
         }
@@ -170,6 +184,12 @@ class VirtualGPU : public device::VirtualDevice {
           break;
         }
       }
+      if (!ibReuse && pending && (result == Pal::Result::Success)) {
+        // The wait observed the completion, so it estimates the execution time.
+        // Already signaled fences don't, since the app could do CPU work after the submission
+        const uint64_t sample = amd::Os::timeNanos() - submitTime_[cbId];
+        avgCompletion_ = (avgCompletion_ * 7 + sample) / 8;
+      }
       return (result == Pal::Result::Success) ? true : false;
     }
 
@@ -185,6 +205,9 @@ class VirtualGPU : public device::VirtualDevice {
 
     Pal::ICmdBuffer* iCmd() const { return iCmdBuffs_[cmdBufIdSlot_]; }
 
+    //! Returns the creation info of the queue command buffers
+    const Pal::CmdBufferCreateInfo& cmdCreateInfo() const { return cmdCreateInfo_; }
+
     uint cmdBufId() const { return cmdBufIdCurrent_; }
 
     static uint32_t AllocedQueues(const VirtualGPU& gpu, Pal::EngineType type);
@@ -193,18 +216,23 @@ class VirtualGPU : public device::VirtualDevice {
     Pal::IQueue* iQueue_;                      //!< PAL queue object
     std::vector<Pal::ICmdBuffer*> iCmdBuffs_;  //!< PAL command buffers
     std::vector<Pal::IFence*> iCmdFences_;     //!< PAL fences, associated with CMD
+    std::vector<uint64_t> submitTime_;         //!< CPU time of the submissions in ns
     const amd::Kernel* last_kernel_;           //!< Last submitted kernel
     AqlPacketMgmt* aql_mgmt_;                  //!< AQL packet emulation managment
     void* info_ = nullptr;                     //!< Queue info for RT queues
 
    private:
     void DumpMemoryReferences() const;
+
+    //! Removes the cold memory references from the residency list
+    void trimMemReferences();
     VirtualGPU& gpu_;        //!< ROCCLR virtual GPU object
     Pal::IDevice* iDev_;     //!< PAL device
     uint cmdBufIdSlot_;      //!< Command buffer ID slot for submissions
     uint cmdBufIdCurrent_;   //!< Current global command buffer ID
     uint cmbBufIdRetired_;   //!< The last retired command buffer ID
     uint cmdCnt_;            //!< Counter of commands
+    //! Memory references and the command buffer ID of the last use
     std::unordered_map<GpuMemoryReference*, uint> memReferences_;
     Util::VirtualLinearAllocator vlAlloc_;
     std::vector<Pal::GpuMemoryRef> palMemRefs_;
@@ -215,6 +243,9 @@ class VirtualGPU : public device::VirtualDevice {
     uint64_t residency_size_;   //!< Resource residency size
     uint64_t residency_limit_;  //!< Enables residency limit
     uint max_command_buffers_;
+    Pal::CmdBufferCreateInfo cmdCreateInfo_ = {};  //!< Creation info of the command buffers
+    uint64_t maxSpinTime_ = 0;                     //!< Spin limit before the OS wait in ns
+    mutable uint64_t avgCompletion_ = 0;           //!< Average completion time of a submission
   };
 
   struct CommandBatch : public amd::HeapObject {
@@ -357,10 +388,19 @@ class VirtualGPU : public device::VirtualDevice {
 
   void HiddenHeapInit() {}
 
-  inline bool dispatchAqlPacket(uint8_t* aqlpacket, const std::string& kernelName,
-                                amd::AccumulateCommand* vcmd = nullptr) {
-    vcmd->addKernelName(kernelName);
-    return false;
+  //! Dispatches a packet, captured by submitKernelInternal()
+  bool dispatchAqlPacket(uint8_t* aqlpacket, const std::string& kernelName,
+                         amd::AccumulateCommand* vcmd = nullptr);
+
+  //! Defers the captured dispatches until EndDoorbellBatch()
+  void BeginDoorbellBatch();
+
+  //! Executes the deferred dispatches from a recorded command buffer
+  void EndDoorbellBatch();
+
+  //! Returns TRUE if the current command captures the AQL packets
+  bool isPacketCapturing() const {
+    return (currCmd_ != nullptr) && currCmd_->getPktCapturingState();
   }
 
   void resetFenceDirty() {}
@@ -492,6 +532,13 @@ class VirtualGPU : public device::VirtualDevice {
 
   void addBarrier(RgpSqqtBarrierReason reason = RgpSqqtBarrierReason::MemDependency,
                   BarrierType type = BarrierType::KernelToKernel) const {
+    writeBarrier(iCmd(), reason, type);
+    queues_[engineID_]->submit<true>(false);
+  }
+
+  //! Writes a barrier into the PAL command buffer without the submission tracking
+  static void writeBarrier(Pal::ICmdBuffer* iCmd, RgpSqqtBarrierReason reason,
+                           BarrierType type = BarrierType::KernelToKernel) {
     Pal::BarrierInfo barrier = {};
     barrier.pipePointWaitCount = 1;
     Pal::HwPipePoint point = Pal::HwPipePostCs;
@@ -516,8 +563,7 @@ class VirtualGPU : public device::VirtualDevice {
     barrier.pTransitions = &trans;
     barrier.waitPoint = Pal::HwPipePreCs;
     barrier.reason = static_cast<uint32_t>(reason);
-    iCmd()->CmdBarrier(barrier);
-    queues_[engineID_]->submit<true>(false);
+    iCmd->CmdBarrier(barrier);
   }
 
   void eventBegin(EngineType engId) const {
@@ -587,10 +633,17 @@ class VirtualGPU : public device::VirtualDevice {
   //! Waits on an outstanding kernel.
   void releaseGpuMemoryFence() {
     if (amd::IS_HIP) {
-      WaitForIdleCompute();
+      // Make SDMA wait for the pending compute work
+      syncEngines(SdmaEngine, &events_[MainEngine]);
     }
   }
 
+  //! Makes the engine wait for a GPU event of another engine. The wait is on the GPU
+  //! with the engine semaphores, if available, otherwise on the CPU
+  void syncEngines(EngineType engine,  //!< Engine, which executes the dependent work
+                   GpuEvent* event     //!< GPU event the engine has to wait for
+  );
+
   //! Updates timestamp for AQL packet index
   void AqlPacketUpdateTs(uint32_t index, GpuEvent gpu_event) {
     // Save the new CB ID for this slot
@@ -668,6 +721,42 @@ class VirtualGPU : public device::VirtualDevice {
                            amd::CopyMetadata()      //!< Memory copy MetaData
   );
 
+  //! Captured dispatches, recorded into a PAL command buffer for the resubmission
+  struct RecordedDispatches {
+    std::vector<const uint8_t*> packets_;  //!< The captured packets in the dispatch order
+    uint64_t digest_ = 0;                  //!< Hash of the packets contents at the recording
+    address memory_ = nullptr;             //!< Storage of the PAL command buffer
+    Pal::ICmdBuffer* iCmd_ = nullptr;      //!< Nested command buffer with the dispatches
+    GpuEvent event_;                       //!< The last execution of the command buffer
+  };
+
+  //! Fills the PAL dispatch parameters of an AQL packet
+  void setupDispatch(const HSAILKernel& hsaKernel,          //!< HSAIL kernel for the dispatch
+                     hsa_kernel_dispatch_packet_t* aqlPkt,  //!< AQL packet of the dispatch
+                     uint32_t aqlIndex,                     //!< AQL packet index
+                     Pal::DispatchAqlParams* dispatchParam  //!< [Return] PAL dispatch parameters
+  );
+
+  //! Saves the AQL packet and the kernel arguments of a dispatch into the current command
+  bool captureDispatch(const HSAILKernel& hsaKernel,          //!< HSAIL kernel for the dispatch
+                       hsa_kernel_dispatch_packet_t* aqlPkt,  //!< AQL packet of the dispatch
+                       address hostArgs                       //!< Host copy of the arguments
+  );
+
+  //! Writes a captured dispatch into the PAL command buffer and returns the AQL packet index
+  uint32_t dispatchCaptured(Pal::ICmdBuffer* iCmd,  //!< PAL command buffer for the dispatch
+                        const uint8_t* packet   //!< The captured AQL packet
+  );
+
+  //! Finds or records the command buffer of the captured dispatches
+  RecordedDispatches* recordDispatches(const std::vector<const uint8_t*>& packets);
+
+  //! Destroys the PAL command buffer of the recorded dispatches
+  void releaseRecorded(RecordedDispatches& recorded);
+
+  //! Submits the deferred captured dispatches, so they stay ordered with the other commands
+  void flushDeferredDispatches();
+
   void PrintChildren(const HSAILKernel& hsaKernel,  //!< The parent HSAIL kernel
                      VirtualGPU* gpuDefQueue        //!< Device queue for children execution
   );
@@ -726,6 +815,16 @@ class VirtualGPU : public device::VirtualDevice {
 
   void* hostcallBuffer_;  //!< Hostcall buffer
 
+  //! Timeline semaphores, signaled by every engine for the waits of the other engines
+  Pal::IQueueSemaphore* engineSems_[AllEngines] = {};
+  uint64_t engineSemValues_[AllEngines] = {};  //!< The last signaled values of the semaphores
+  uint syncedIds_[AllEngines] = {};            //!< The last command buffers, waited on the GPU
+
+  amd::Command* currCmd_ = nullptr;               //!< Current command under capture
+  bool deferDispatches_ = false;                  //!< The captured dispatches are deferred
+  std::vector<const uint8_t*> deferredPackets_;   //!< Deferred captured packets
+  std::list<RecordedDispatches> recorded_;        //!< Recorded dispatches, the last used first
+
   using KernelArgImpl = device::Settings::KernelArgImpl;
 };
 
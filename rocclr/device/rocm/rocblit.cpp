@@ -22,10 +22,20 @@
 #include "device/rocm/rocdevice.hpp"
 #include "device/rocm/rocblit.hpp"
 #include "device/rocm/rocmemory.hpp"
+#include "device/rocm/rocpincache.hpp"
 #include "device/rocm/rockernel.hpp"
 #include "device/rocm/rocsched.hpp"
 #include "utils/debug.hpp"
+#include "utils/metrics.hpp"
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+
+// The AVX paths are built with the target attributes and selected at runtime
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ROC_NONTEMPORAL_X86 1
+#include <immintrin.h>
+#endif
 
 namespace amd::roc {
 DmaBlitManager::DmaBlitManager(VirtualGPU& gpu, Setup setup)
@@ -109,13 +119,14 @@ bool DmaBlitManager::readBuffer(device::Memory& srcMemory, void* dstHost,
           pinAllocSize = amd::alignUp(tmpSize, PinnedMemoryAlignment);
           partial = 0;
         }
-        amd::Coord3D dst(partial, 0, 0);
         amd::Coord3D srcPin(origin[0] + offset, 0, 0);
         amd::Coord3D copySizePin(tmpSize, 0, 0);
         size_t partial2;
 
         // Allocate a GPU resource for pinning
         pinned = pinHostMemory(tmpHost, pinAllocSize, partial2);
+        // A cached pinned range may start before the aligned host address
+        amd::Coord3D dst(partial + partial2, 0, 0);
         if (pinned != nullptr) {
           // Get device memory for this virtual device
           Memory* dstMemory = dev().getRocMemory(pinned);
@@ -138,7 +149,7 @@ bool DmaBlitManager::readBuffer(device::Memory& srcMemory, void* dstHost,
     }
 
     if (0 != srcSize) {
-      Memory& xferBuf = dev().xferRead().acquire();
+      Memory& xferBuf = dev().xferRead().acquire(gpu());
 
       // Read memory using a staging resource
       if (!readMemoryStaged(gpuMem(srcMemory), dstHost, xferBuf, origin[0], offset, srcSize,
@@ -170,7 +181,7 @@ bool DmaBlitManager::readBufferRect(device::Memory& srcMemory, void* dstHost,
     gpu().Barriers().WaitCurrent();
     return HostBlitManager::readBufferRect(srcMemory, dstHost, bufRect, hostRect, size, entire, copyMetadata);
   } else {
-    Memory& xferBuf = dev().xferRead().acquire();
+    Memory& xferBuf = dev().xferRead().acquire(gpu());
     address staging = xferBuf.getDeviceMemory();
     const_address src = gpuMem(srcMemory).getDeviceMemory();
 
@@ -230,6 +241,87 @@ bool DmaBlitManager::writeMemoryStaged(const void* srcHost, Memory& dstMemory, a
   return retval;
 }
 
+// ================================================================================================
+bool DmaBlitManager::writeBufferFromFile(amd::Os::FileDesc fileDesc, uint64_t fileOffset,
+                                         device::Memory& dstMemory, size_t origin,
+                                         size_t size) const {
+  // The second descriptor bypasses the page cache, so the storage DMA writes the target directly
+  amd::Os::FileDesc directDesc = amd::Os::FDescInit();
+  const bool direct = amd::Os::GetDirectFileHandle(fileDesc, &directDesc);
+
+  // Reads the aligned part of a region with the direct descriptor and the rest with the original
+  auto readFile = [&](address buf, uint64_t offset, size_t bytes, bool bufferedTail) -> size_t {
+    size_t done = 0;
+    if (direct && amd::isMultipleOf(offset, DirectIoAlignment) &&
+        amd::isMultipleOf(reinterpret_cast<uintptr_t>(buf), DirectIoAlignment)) {
+      const size_t aligned = amd::alignDown(bytes, DirectIoAlignment);
+      if (aligned != 0) {
+        int64_t read = amd::Os::ReadFileDesc(directDesc, buf, aligned, offset);
+        done = (read > 0) ? static_cast<size_t>(read) : 0;
+      }
+    }
+    if (bufferedTail && (done < bytes)) {
+      int64_t read = amd::Os::ReadFileDesc(fileDesc, buf + done, bytes - done, offset + done);
+      done += (read > 0) ? static_cast<size_t>(read) : 0;
+    }
+    return done;
+  };
+
+  Memory& gpuMemory = gpuMem(dstMemory);
+  bool result = true;
+  size_t done = 0;
+  if (dstMemory.isHostMemDirectAccess()) {
+    // Stall GPU before CPU access
+    gpu().releaseGpuMemoryFence();
+    void* dst = dstMemory.cpuMap(vDev_);
+    if (dst == nullptr) {
+      LogError("Couldn't map GPU memory for the file read");
+      result = false;
+    } else {
+      done = readFile(reinterpret_cast<address>(dst) + origin, fileOffset, size, true);
+      dstMemory.cpuUnmap(vDev_);
+    }
+  } else {
+    if (direct && dev().info().largeBar_ && (gpuMemory.getKind() == Memory::MEMORY_KIND_NORMAL) &&
+        (&gpuMemory.dev() == &dev()) && (dstMemory.owner() != nullptr) &&
+        !dstMemory.owner()->ipcShared()) {
+      // Try peer to peer DMA from the storage into the BAR, which the kernel rejects
+      // when the platform doesn't support it
+      gpu().releaseGpuMemoryFence();
+      done = readFile(gpuMemory.getDeviceMemory() + origin, fileOffset, size, false);
+      if ((done != 0) && (dev().info().hdpMemFlushCntl != nullptr)) {
+        *dev().info().hdpMemFlushCntl = 1u;
+        auto kSentinel = *reinterpret_cast<volatile int*>(dev().info().hdpMemFlushCntl);
+      }
+      ClPrint(amd::LOG_DEBUG, amd::LOG_COPY, "P2P file read of %zu bytes out of %zu", done, size);
+    }
+
+    if (done < size) {
+      // Reserve the extra space for the alignment of unbuffered reads
+      const size_t remain = size - done;
+      address staging = gpu().Staging().Acquire(
+          std::min(remain, dev().settings().stagedXferSize_) + DirectIoAlignment);
+      staging = amd::alignUp(staging, DirectIoAlignment);
+      const uint64_t stagedOffset = fileOffset + done;
+      StagingFill fill = [&](address slot, size_t offset, size_t bytes) {
+        return (readFile(slot, stagedOffset + offset, bytes, true) == bytes);
+      };
+      result = hsaCopyStaged(nullptr, gpuMemory.getDeviceMemory() + origin + done, remain,
+                             staging, true, fill);
+      done = (result) ? size : done;
+    }
+  }
+
+  if (direct) {
+    amd::Os::CloseFileHandle(directDesc);
+  }
+  if (!result || (done != size)) {
+    LogPrintfError("File read of %zu bytes at offset %lu failed", size, fileOffset);
+    return false;
+  }
+  return true;
+}
+
 // ================================================================================================
 bool DmaBlitManager::writeBuffer(const void* srcHost, device::Memory& dstMemory,
                                  const amd::Coord3D& origin, const amd::Coord3D& size,
@@ -277,13 +369,14 @@ bool DmaBlitManager::writeBuffer(const void* srcHost, device::Memory& dstMemory,
           pinAllocSize = amd::alignUp(tmpSize, PinnedMemoryAlignment);
           partial = 0;
         }
-        amd::Coord3D src(partial, 0, 0);
         amd::Coord3D dstPin(origin[0] + offset, 0, 0);
         amd::Coord3D copySizePin(tmpSize, 0, 0);
         size_t partial2;
 
         // Allocate a GPU resource for pinning
         pinned = pinHostMemory(tmpHost, pinAllocSize, partial2);
+        // A cached pinned range may start before the aligned host address
+        amd::Coord3D src(partial + partial2, 0, 0);
 
         if (pinned != nullptr) {
           // Get device memory for this virtual device
@@ -530,6 +623,10 @@ bool DmaBlitManager::copyImageToBuffer(device::Memory& srcMemory, device::Memory
   if (setup_.disableCopyImageToBuffer_) {
     result = HostBlitManager::copyImageToBuffer(srcMemory, dstMemory, srcOrigin, dstOrigin, size,
                                                 entire, rowPitch, slicePitch, copyMetadata);
+  } else if (dev().settings().imageDMA_ &&
+             copyImageLinear(srcMemory, dstMemory, srcOrigin, dstOrigin, size, rowPitch,
+                             slicePitch)) {
+    result = true;
   } else {
     Image& srcImage = static_cast<roc::Image&>(srcMemory);
     Buffer& dstBuffer = static_cast<roc::Buffer&>(dstMemory);
@@ -576,6 +673,10 @@ bool DmaBlitManager::copyBufferToImage(device::Memory& srcMemory, device::Memory
   if (setup_.disableCopyBufferToImage_) {
     result = HostBlitManager::copyBufferToImage(srcMemory, dstMemory, srcOrigin, dstOrigin, size,
                                                 entire, rowPitch, slicePitch, copyMetadata);
+  } else if (dev().settings().imageDMA_ &&
+             copyImageLinear(srcMemory, dstMemory, srcOrigin, dstOrigin, size, rowPitch,
+                             slicePitch)) {
+    result = true;
   } else {
     Buffer& srcBuffer = static_cast<roc::Buffer&>(srcMemory);
     Image& dstImage = static_cast<roc::Image&>(dstMemory);
@@ -609,6 +710,52 @@ bool DmaBlitManager::copyBufferToImage(device::Memory& srcMemory, device::Memory
   return result;
 }
 
+// ================================================================================================
+bool DmaBlitManager::copyImageLinear(device::Memory& srcMemory, device::Memory& dstMemory,
+                                     const amd::Coord3D& srcOrigin, const amd::Coord3D& dstOrigin,
+                                     const amd::Coord3D& size, size_t rowPitch,
+                                     size_t slicePitch) const {
+  amd::Image* srcImage = srcMemory.owner()->asImage();
+  amd::Image* dstImage = dstMemory.owner()->asImage();
+  const amd::Image* image = (srcImage != nullptr) ? srcImage : dstImage;
+  if (image == nullptr) {
+    return false;
+  }
+  const size_t elementSize = image->getImageFormat().getElementSize();
+  if ((srcImage != nullptr) && (dstImage != nullptr) &&
+      (dstImage->getImageFormat().getElementSize() != elementSize)) {
+    return false;
+  }
+  const size_t region[3] = {size[0] * elementSize, size[1], size[2]};
+
+  // Describes the region of either side as a plain rectangle in the memory
+  auto linearRect = [&](device::Memory& memory, const amd::Coord3D& origin,
+                        amd::BufferRect* rect) {
+    amd::Image* img = memory.owner()->asImage();
+    if (img == nullptr) {
+      const size_t start[3] = {origin[0], 0, 0};
+      return rect->create(start, region, rowPitch, slicePitch);
+    }
+    const size_t pitch = static_cast<Image&>(gpuMem(memory)).LinearRowPitch();
+    // Tiled layouts need the image swizzle, which only the kernel blits handle
+    if ((pitch == 0) || (img->getType() == CL_MEM_OBJECT_IMAGE1D_ARRAY)) {
+      return false;
+    }
+    const size_t start[3] = {origin[0] * elementSize, origin[1], origin[2]};
+    return rect->create(start, region, pitch, pitch * img->getHeight());
+  };
+
+  amd::BufferRect srcRect;
+  amd::BufferRect dstRect;
+  if (!linearRect(srcMemory, srcOrigin, &srcRect) || !linearRect(dstMemory, dstOrigin, &dstRect)) {
+    return false;
+  }
+  ClPrint(amd::LOG_DEBUG, amd::LOG_COPY, "SDMA copy of a linear image region %zux%zux%zu",
+          size[0], size[1], size[2]);
+  return DmaBlitManager::copyBufferRect(srcMemory, dstMemory, srcRect, dstRect,
+                                        amd::Coord3D(region[0], region[1], region[2]), false);
+}
+
 // ================================================================================================
 bool DmaBlitManager::copyImage(device::Memory& srcMemory, device::Memory& dstMemory,
                                const amd::Coord3D& srcOrigin, const amd::Coord3D& dstOrigin,
@@ -709,11 +856,38 @@ bool DmaBlitManager::hsaCopy(const Memory& srcMemory, const Memory& dstMemory,
   // Check if host wait has to be forced
   bool forceHostWait = forceHostWaitFunc(size[0]);
 
+  // Large copies are split across the free SDMA engines, since one engine can't saturate the link
+  uint32_t stripeMask = 0;
+  uint32_t stripeCount = 1;
+  if ((ROC_SDMA_STRIPE_SIZE != 0) && (ROC_SDMA_STRIPE_ENGINES > 1) &&
+      (engine != HwQueueEngine::Unknown) &&
+      (size[0] >= static_cast<size_t>(ROC_SDMA_STRIPE_SIZE) * Mi)) {
+    if (hsa_amd_memory_copy_engine_status(dstAgent, srcAgent, &freeEngineMask) ==
+        HSA_STATUS_SUCCESS) {
+      uint32_t engineMask = freeEngineMask & ((engine == HwQueueEngine::SdmaRead) ?
+                                              sdmaEngineReadMask_ : sdmaEngineWriteMask_);
+      stripeCount = 0;
+      // Pick the rightmost free engines up to the limit
+      for (; (engineMask != 0) && (stripeCount < ROC_SDMA_STRIPE_ENGINES); ++stripeCount) {
+        stripeMask |= engineMask - (engineMask & (engineMask - 1));
+        engineMask &= engineMask - 1;
+      }
+      if (stripeCount < 2) {
+        stripeMask = 0;
+        stripeCount = 1;
+      }
+    }
+  }
+
   auto wait_events = gpu().Barriers().WaitingSignal(engine);
-  hsa_signal_t active = gpu().Barriers().ActiveSignal(kInitSignalValueOne, gpu().timestamp(),
+  // Every striped copy decrements the completion signal, hence it joins all of them
+  hsa_signal_t active = gpu().Barriers().ActiveSignal(stripeCount, gpu().timestamp(),
                                                       forceHostWait);
 
-  if (!kUseRegularCopyApi && engine != HwQueueEngine::Unknown) {
+  if (stripeMask != 0) {
+    status = hsaCopyStriped(dst, dstAgent, src, srcAgent, size[0], wait_events, active,
+                            stripeMask, stripeCount, forceSDMA);
+  } else if (!kUseRegularCopyApi && engine != HwQueueEngine::Unknown) {
     if (copyMask == 0) {
       if (sdmaEngineRetainCount_) {
         // Check if there a recently used SDMA engine for the stream
@@ -773,15 +947,80 @@ bool DmaBlitManager::hsaCopy(const Memory& srcMemory, const Memory& dstMemory,
   return (status == HSA_STATUS_SUCCESS);
 }
 
+// ================================================================================================
+hsa_status_t DmaBlitManager::hsaCopyStriped(address dst, hsa_agent_t dstAgent, const_address src,
+                                            hsa_agent_t srcAgent, size_t size,
+                                            const std::vector<hsa_signal_t>& wait_events,
+                                            hsa_signal_t active, uint32_t stripeMask,
+                                            uint32_t stripeCount, bool forceSDMA) const {
+  constexpr size_t kStripeAlignment = 4 * Ki;
+  const size_t stripeSize = amd::alignUp(size / stripeCount, kStripeAlignment);
+  hsa_status_t status = HSA_STATUS_SUCCESS;
+  size_t offset = 0;
+  uint32_t issued = 0;
+
+  for (; (issued < stripeCount) && (offset < size); ++issued) {
+    const size_t copySize = (issued == (stripeCount - 1)) ? (size - offset) :
+                                                            std::min(stripeSize, size - offset);
+    const uint32_t engineBit = stripeMask - (stripeMask & (stripeMask - 1));
+    stripeMask &= stripeMask - 1;
+    hsa_amd_sdma_engine_id_t copyEngine = static_cast<hsa_amd_sdma_engine_id_t>(engineBit);
+
+    ClPrint(amd::LOG_DEBUG, amd::LOG_COPY,
+            "HSA Async Copy stripe %d/%d on copy_engine=0x%x, dst=0x%zx, src=0x%zx, size=%ld, "
+            "completion_signal=0x%zx", issued + 1, stripeCount, copyEngine, dst + offset,
+            src + offset, copySize, active.handle);
+
+    status = hsa_amd_memory_async_copy_on_engine(dst + offset, dstAgent, src + offset, srcAgent,
+                                                copySize, wait_events.size(), wait_events.data(),
+                                                active, copyEngine, forceSDMA);
+    if (status != HSA_STATUS_SUCCESS) {
+      break;
+    }
+    offset += copySize;
+  }
+
+  if ((issued > 0) && (issued < stripeCount)) {
+    // Some stripes are in flight, hence the signal must still reach zero.
+    // Copy the rest on any engine and account the stripes, which won't be issued
+    if (stripeCount - issued > 1) {
+      hsa_signal_subtract_screlease(active, stripeCount - issued - 1);
+    }
+    if (offset < size) {
+      status = hsa_amd_memory_async_copy(dst + offset, dstAgent, src + offset, srcAgent,
+                                         size - offset, wait_events.size(), wait_events.data(),
+                                         active);
+    } else {
+      hsa_signal_subtract_screlease(active, 1);
+      status = HSA_STATUS_SUCCESS;
+    }
+    if (status != HSA_STATUS_SUCCESS) {
+      // The issued stripes can't be cancelled, so wait for them before the blit fallback
+      hsa_signal_subtract_screlease(active, 1);
+      hsa_signal_wait_scacquire(active, HSA_SIGNAL_CONDITION_EQ, 0, UINT64_MAX,
+                                HSA_WAIT_STATE_BLOCKED);
+    }
+  }
+  return status;
+}
+
 // ================================================================================================
 bool DmaBlitManager::hsaCopyStaged(const_address hostSrc, address hostDst, size_t size,
-                                   address staging, bool hostToDev) const {
+                                   address staging, bool hostToDev,
+                                   const StagingFill& fill) const {
+  amd::Metrics::add(amd::Metrics::StagingCopies);
+  amd::Metrics::add(amd::Metrics::StagingBytes, size);
+
   // Stall GPU, sicne CPU copy is possible
   gpu().releaseGpuMemoryFence(hostToDev);
 
   // No allocation is necessary for Full Profile
   hsa_status_t status;
   if (dev().agent_profile() == HSA_PROFILE_FULL) {
+    if (fill) {
+      gpu().releaseGpuMemoryFence();
+      return fill(hostDst, 0, size);
+    }
     status = hsa_memory_copy(hostDst, hostSrc, size);
     if (status != HSA_STATUS_SUCCESS) {
       LogPrintfError("Hsa copy of data failed with code %d", status);
@@ -789,77 +1028,103 @@ bool DmaBlitManager::hsaCopyStaged(const_address hostSrc, address hostDst, size_
     return (status == HSA_STATUS_SUCCESS);
   }
 
-  size_t totalSize = size;
-  size_t offset = 0;
+  // The staging buffer is split into a ring of slots. CPU copy of one slot overlaps
+  // with DMA of the others
+  const size_t capacity = std::min(size, dev().settings().stagedXferSize_);
+  size_t numSlots = std::max(ROC_STAGING_RING_SIZE, 1u);
+  size_t slotSize = amd::alignDown(capacity / numSlots, 4 * Ki);
+  if ((numSlots == 1) || (slotSize < MinStagingSlotSize)) {
+    numSlots = 1;
+    slotSize = capacity;
+  }
+  const size_t numChunks = (size + slotSize - 1) / slotSize;
+  std::vector<hsa_signal_t> slotSignals(numSlots);
 
-  address hsaBuffer = staging;
+  const hsa_agent_t hostAgent = dev().getCpuAgent();
+  HwQueueEngine engine = HwQueueEngine::Unknown;
+  if (hostAgent.handle == dev().getBackendDevice().handle) {
+    engine = (hostToDev) ? HwQueueEngine::SdmaWrite : HwQueueEngine::SdmaRead;
+  }
+  gpu().Barriers().SetActiveEngine(engine);
 
-  // Allocate requested size of memory
-  while (totalSize > 0) {
-    size = std::min(totalSize, dev().settings().stagedXferSize_);
+  hsa_signal_t last = {};
+  // Issues DMA of the chunk, which uses the next slot of the ring
+  auto issueCopy = [&](size_t chunk) -> bool {
+    const size_t offset = chunk * slotSize;
+    const size_t copySize = std::min(slotSize, size - offset);
+    address slot = staging + (chunk % numSlots) * slotSize;
 
-    // Copy data from Host to Device
+    auto wait_events = gpu().Barriers().WaitingSignal(engine);
+    if (last.handle != 0) {
+      // Keep the order of chunks, since the barrier tracker follows the last signal only
+      wait_events.push_back(last);
+    }
+    hsa_signal_t active = gpu().Barriers().ActiveSignal(kInitSignalValueOne, gpu().timestamp());
     if (hostToDev) {
-      const hsa_agent_t srcAgent = dev().getCpuAgent();
-
-      HwQueueEngine engine = HwQueueEngine::Unknown;
-      if (srcAgent.handle == dev().getBackendDevice().handle) {
-        engine = HwQueueEngine::SdmaWrite;
-      }
-      gpu().Barriers().SetActiveEngine(engine);
-      auto wait_events = gpu().Barriers().WaitingSignal(engine);
-      hsa_signal_t active = gpu().Barriers().ActiveSignal(kInitSignalValueOne, gpu().timestamp());
-
-      memcpy(hsaBuffer, hostSrc + offset, size);
-      status = hsa_amd_memory_async_copy(
-          hostDst + offset, dev().getBackendDevice(), hsaBuffer, srcAgent, size,
-          wait_events.size(), wait_events.data(), active);
+      status = hsa_amd_memory_async_copy(hostDst + offset, dev().getBackendDevice(), slot,
+                                         hostAgent, copySize, wait_events.size(),
+                                         wait_events.data(), active);
       ClPrint(amd::LOG_DEBUG, amd::LOG_COPY,
           "HSA Async Copy staged H2D dst=0x%zx, src=0x%zx, size=%ld, completion_signal=0x%zx",
-          hostDst + offset, hsaBuffer, size, active.handle);
-
-      if (status != HSA_STATUS_SUCCESS) {
-        gpu().Barriers().ResetCurrentSignal();
-        LogPrintfError("Hsa copy from host to device failed with code %d", status);
-        return false;
-      }
-      totalSize -= size;
-      if (totalSize > 0) {
-        // Wait if there are extra copies, which don't fit in a single staging buffer
-        gpu().Barriers().WaitCurrent();
-      }
-      offset += size;
-      continue;
-    }
-
-    const hsa_agent_t dstAgent = dev().getCpuAgent();
-
-    HwQueueEngine engine = HwQueueEngine::Unknown;
-    if (dstAgent.handle == dev().getBackendDevice().handle) {
-      engine = HwQueueEngine::SdmaRead;
-    }
-    gpu().Barriers().SetActiveEngine(engine);
-    auto wait_events = gpu().Barriers().WaitingSignal(engine);
-    hsa_signal_t active = gpu().Barriers().ActiveSignal(kInitSignalValueOne, gpu().timestamp());
-
-    // Copy data from Device to Host
-    status = hsa_amd_memory_async_copy(
-        hsaBuffer, dstAgent, hostSrc + offset, dev().getBackendDevice(), size,
-        wait_events.size(), wait_events.data(), active);
-    ClPrint(amd::LOG_DEBUG, amd::LOG_COPY,
-            "HSA Async Copy staged D2H dst=0x%zx, src=0x%zx, size=%ld, completion_signal=0x%zx",
-            hsaBuffer, hostSrc + offset, size, active.handle);
-
-    if (status == HSA_STATUS_SUCCESS) {
-      gpu().Barriers().WaitCurrent();
-      memcpy(hostDst + offset, hsaBuffer, size);
+          hostDst + offset, slot, copySize, active.handle);
     } else {
+      status = hsa_amd_memory_async_copy(slot, hostAgent, hostSrc + offset,
+                                         dev().getBackendDevice(), copySize, wait_events.size(),
+                                         wait_events.data(), active);
+      ClPrint(amd::LOG_DEBUG, amd::LOG_COPY,
+          "HSA Async Copy staged D2H dst=0x%zx, src=0x%zx, size=%ld, completion_signal=0x%zx",
+          slot, hostSrc + offset, copySize, active.handle);
+    }
+    if (status != HSA_STATUS_SUCCESS) {
       gpu().Barriers().ResetCurrentSignal();
-      LogPrintfError("Hsa copy from device to host failed with code %d", status);
+      LogPrintfError("Hsa staged copy failed with code %d", status);
       return false;
     }
-    totalSize -= size;
-    offset += size;
+    slotSignals[chunk % numSlots] = active;
+    last = active;
+    return true;
+  };
+  // Waits until DMA is done with the slot of the chunk
+  auto waitSlot = [&](size_t chunk) {
+    hsa_signal_t signal = slotSignals[chunk % numSlots];
+    if (signal.handle != 0) {
+      gpu().RingDeferredDoorbell();
+      WaitForSignal(signal, gpu().ActiveWait());
+    }
+  };
+
+  if (hostToDev) {
+    for (size_t chunk = 0; chunk < numChunks; ++chunk) {
+      const size_t offset = chunk * slotSize;
+      // A previous DMA can still read the slot
+      waitSlot(chunk);
+      address slot = staging + (chunk % numSlots) * slotSize;
+      const size_t copySize = std::min(slotSize, size - offset);
+      if (fill) {
+        if (!fill(slot, offset, copySize)) {
+          return false;
+        }
+      } else {
+        memcpy(slot, hostSrc + offset, copySize);
+      }
+      if (!issueCopy(chunk)) {
+        return false;
+      }
+    }
+  } else {
+    size_t issued = 0;
+    for (size_t chunk = 0; chunk < numChunks; ++chunk) {
+      // Keep DMA ahead of the CPU copy for the whole ring
+      for (; (issued < numChunks) && (issued < (chunk + numSlots)); ++issued) {
+        if (!issueCopy(issued)) {
+          return false;
+        }
+      }
+      const size_t offset = chunk * slotSize;
+      waitSlot(chunk);
+      memcpy(hostDst + offset, staging + (chunk % numSlots) * slotSize,
+             std::min(slotSize, size - offset));
+    }
   }
 
   gpu().addSystemScope();
@@ -872,7 +1137,9 @@ KernelBlitManager::KernelBlitManager(VirtualGPU& gpu, Setup setup)
     : DmaBlitManager(gpu, setup),
       program_(nullptr),
       xferBufferSize_(0),
-      lockXferOps_(true) /* Transfer Ops Lock*/ {
+      lockXferOps_(true) /* Transfer Ops Lock*/,
+      cpuWriteLimit_(ROC_CPU_WRITE_SIZE * Ki),
+      cpuWriteCalibrated_(false) {
   for (uint i = 0; i < BlitTotal; ++i) {
     kernels_[i] = nullptr;
   }
@@ -987,9 +1254,6 @@ bool KernelBlitManager::copyBufferToImage(device::Memory& srcMemory, device::Mem
 
   amd::ScopedLock k(lockXferOps_);
   bool result = false;
-  amd::Image* dstImage = static_cast<amd::Image*>(dstMemory.owner());
-  size_t imgRowPitch = size[0] * dstImage->getImageFormat().getElementSize();
-  size_t imgSlicePitch = imgRowPitch * size[1];
 
   if (setup_.disableCopyBufferToImage_) {
     result = HostBlitManager::copyBufferToImage(srcMemory, dstMemory, srcOrigin, dstOrigin, size,
@@ -997,20 +1261,13 @@ bool KernelBlitManager::copyBufferToImage(device::Memory& srcMemory, device::Mem
     synchronize();
     return result;
   }
-  // Check if buffer is in system memory with direct access
-  else if (srcMemory.isHostMemDirectAccess() &&
-           (((rowPitch == 0) && (slicePitch == 0)) ||
-            ((rowPitch == imgRowPitch) && ((slicePitch == 0) || (slicePitch == imgSlicePitch))))) {
-    // First attempt to do this all with DMA,
-    // but there are restriciton with older hardware
-    if (dev().settings().imageDMA_) {
-      result = DmaBlitManager::copyBufferToImage(srcMemory, dstMemory, srcOrigin, dstOrigin, size,
-                                                 entire, rowPitch, slicePitch, copyMetadata);
-      if (result) {
-        synchronize();
-        return result;
-      }
-    }
+  // Linear images are plain pitched memory, which SDMA copies without the compute queue.
+  // Tiled images keep the kernel path
+  else if (dev().settings().imageDMA_ &&
+           copyImageLinear(srcMemory, dstMemory, srcOrigin, dstOrigin, size, rowPitch,
+                           slicePitch)) {
+    synchronize();
+    return true;
   }
 
   if (!result) {
@@ -1203,9 +1460,6 @@ bool KernelBlitManager::copyImageToBuffer(device::Memory& srcMemory, device::Mem
 
   amd::ScopedLock k(lockXferOps_);
   bool result = false;
-  amd::Image* srcImage = static_cast<amd::Image*>(srcMemory.owner());
-  size_t imgRowPitch = size[0] * srcImage->getImageFormat().getElementSize();
-  size_t imgSlicePitch = imgRowPitch * size[1];
 
   if (setup_.disableCopyImageToBuffer_) {
     result = DmaBlitManager::copyImageToBuffer(srcMemory, dstMemory, srcOrigin, dstOrigin, size,
@@ -1213,22 +1467,13 @@ bool KernelBlitManager::copyImageToBuffer(device::Memory& srcMemory, device::Mem
     synchronize();
     return result;
   }
-  // Check if buffer is in system memory with direct access
-  else if (dstMemory.isHostMemDirectAccess() &&
-           (((rowPitch == 0) && (slicePitch == 0)) ||
-            ((rowPitch == imgRowPitch) && ((slicePitch == 0) || (slicePitch == imgSlicePitch))))) {
-    // First attempt to do this all with DMA,
-    // but there are restriciton with older hardware
-    // If the dest buffer is external physical(SDI), copy two step as
-    // single step SDMA is causing corruption and the cause is under investigation
-    if (dev().settings().imageDMA_) {
-      result = DmaBlitManager::copyImageToBuffer(srcMemory, dstMemory, srcOrigin, dstOrigin, size,
-                                                 entire, rowPitch, slicePitch, copyMetadata);
-      if (result) {
-        synchronize();
-        return result;
-      }
-    }
+  // Linear images are plain pitched memory, which SDMA copies without the compute queue.
+  // Tiled images keep the kernel path
+  else if (dev().settings().imageDMA_ &&
+           copyImageLinear(srcMemory, dstMemory, srcOrigin, dstOrigin, size, rowPitch,
+                           slicePitch)) {
+    synchronize();
+    return true;
   }
 
   if (!result) {
@@ -1400,6 +1645,14 @@ bool KernelBlitManager::copyImage(device::Memory& srcMemory, device::Memory& dst
 
   amd::ScopedLock k(lockXferOps_);
   bool result = false;
+
+  // Copies between linear images don't need the image swizzle of the kernel path
+  if (dev().settings().imageDMA_ && !setup_.disableCopyImage_ &&
+      copyImageLinear(srcMemory, dstMemory, srcOrigin, dstOrigin, size)) {
+    synchronize();
+    return true;
+  }
+
   Memory* srcView = &gpuMem(srcMemory);
   Memory* dstView = &gpuMem(dstMemory);
   amd::Image* srcImage = static_cast<amd::Image*>(srcMemory.owner());
@@ -1694,9 +1947,11 @@ bool KernelBlitManager::copyBufferRect(device::Memory& srcMemory, device::Memory
   amd::ScopedLock k(lockXferOps_);
   bool result = false;
   bool rejected = false;
+  // Graph replay submits only the captured AQL packets, so SDMA can't be used under capture
+  const bool capturing = gpu().isPacketCapturing();
 
   // Fall into the ROC path for rejected transfers
-  if (dev().info().pcie_atomics_ && (setup_.disableCopyBufferRect_ ||
+  if (dev().info().pcie_atomics_ && !capturing && (setup_.disableCopyBufferRect_ ||
       srcMemory.isHostMemDirectAccess() || dstMemory.isHostMemDirectAccess())) {
     result = DmaBlitManager::copyBufferRect(srcMemory, dstMemory, srcRectIn, dstRectIn, sizeIn, entire,
                                            copyMetadata);
@@ -1707,6 +1962,27 @@ bool KernelBlitManager::copyBufferRect(device::Memory& srcMemory, device::Memory
     }
   }
 
+  // Strided device copies on SDMA leave the CUs to concurrent kernels. SDMA rect copies
+  // require dword aligned pitches, otherwise the DMA path would split the copy into rows
+  const auto enginePreference = copyMetadata.copyEnginePreference_;
+  if (!setup_.disableCopyBufferRect_ && !capturing && !srcMemory.isHostMemDirectAccess() &&
+      !dstMemory.isHostMemDirectAccess() && (&gpuMem(srcMemory).dev() == &gpuMem(dstMemory).dev()) &&
+      ((enginePreference == amd::CopyMetadata::CopyEnginePreference::SDMA) ||
+       ((enginePreference == amd::CopyMetadata::CopyEnginePreference::NONE) &&
+        ROC_SDMA_RECT_COPY &&
+        ((sizeIn[0] * sizeIn[1] * sizeIn[2]) > dev().settings().sdmaCopyThreshold_))) &&
+      ((srcRectIn.rowPitch_ % sizeof(uint32_t)) == 0) &&
+      ((srcRectIn.slicePitch_ % sizeof(uint32_t)) == 0) &&
+      ((dstRectIn.rowPitch_ % sizeof(uint32_t)) == 0) &&
+      ((dstRectIn.slicePitch_ % sizeof(uint32_t)) == 0)) {
+    result = DmaBlitManager::copyBufferRect(srcMemory, dstMemory, srcRectIn, dstRectIn, sizeIn,
+                                            entire, copyMetadata);
+    if (result) {
+      synchronize();
+      return result;
+    }
+  }
+
   uint blitType = BlitCopyBufferRect;
   size_t dim = 3;
   size_t globalWorkOffset[3] = {0, 0, 0};
@@ -1920,6 +2196,110 @@ bool KernelBlitManager::readBufferRect(device::Memory& srcMemory, void* dstHost,
   return result;
 }
 
+// ================================================================================================
+// ================================================================================================
+#if defined(ROC_NONTEMPORAL_X86)
+static constexpr size_t kStreamLine = 64;
+
+// Partial lines go through the regular stores, so every streamed line is complete.
+// Returns the size of the unaligned head, which was already written
+static inline size_t nontemporalHead(address dst, const_address src, size_t size) {
+  size_t head =
+      (kStreamLine - (reinterpret_cast<uintptr_t>(dst) & (kStreamLine - 1))) & (kStreamLine - 1);
+  head = std::min(head, size);
+  std::memcpy(dst, src, head);
+  return head;
+}
+
+static __attribute__((target("avx2"))) void nontemporalWriteAvx2(address dst, const_address src,
+                                                                 size_t size) {
+  const size_t head = nontemporalHead(dst, src, size);
+  dst += head;
+  src += head;
+  size -= head;
+  for (; size >= kStreamLine; size -= kStreamLine, dst += kStreamLine, src += kStreamLine) {
+    const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), lo);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 32), hi);
+  }
+  std::memcpy(dst, src, size);
+  // Drain the write combining buffers
+  _mm_sfence();
+}
+
+static __attribute__((target("avx512f"))) void nontemporalWriteAvx512(address dst,
+                                                                     const_address src,
+                                                                     size_t size) {
+  const size_t head = nontemporalHead(dst, src, size);
+  dst += head;
+  src += head;
+  size -= head;
+  for (; size >= kStreamLine; size -= kStreamLine, dst += kStreamLine, src += kStreamLine) {
+    _mm512_stream_si512(reinterpret_cast<__m512i*>(dst),
+                        _mm512_loadu_si512(reinterpret_cast<const void*>(src)));
+  }
+  std::memcpy(dst, src, size);
+  _mm_sfence();
+}
+#endif
+
+// Streams host data into the write combined BAR mapping of device memory
+static void nontemporalWrite(address dst, const_address src, size_t size) {
+#if defined(ROC_NONTEMPORAL_X86)
+  static const bool avx512 = __builtin_cpu_supports("avx512f");
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  if (avx512) {
+    nontemporalWriteAvx512(dst, src, size);
+    return;
+  }
+  if (avx2) {
+    nontemporalWriteAvx2(dst, src, size);
+    return;
+  }
+#endif
+  std::memcpy(dst, src, size);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+// ================================================================================================
+bool KernelBlitManager::cpuWriteAllowed(device::Memory& dstMemory, size_t size) const {
+  if (!dev().info().largeBar_ || (size > cpuWriteLimit_)) {
+    return false;
+  }
+  const Memory& mem = gpuMem(dstMemory);
+  const amd::Memory* owner = dstMemory.owner();
+  if ((owner == nullptr) || (&mem.dev() != &dev()) ||
+      (mem.getKind() != Memory::MEMORY_KIND_NORMAL) || owner->ipcShared()) {
+    return false;
+  }
+  // Virtual and imported allocations may have no CPU mapping at the device address
+  constexpr cl_mem_flags kNoCpuMap = CL_MEM_VA_RANGE_AMD | ROCCLR_MEM_PHYMEM |
+                                     ROCCLR_MEM_INTERPROCESS;
+  if ((owner->getMemFlags() & kNoCpuMap) ||
+      ((owner->parent() != nullptr) && (owner->parent()->getMemFlags() & kNoCpuMap))) {
+    return false;
+  }
+  // The CPU writes are ordered with the queue only if nothing is in flight
+  return gpu().isIdle();
+}
+
+// ================================================================================================
+void KernelBlitManager::writeBufferCpu(const void* srcHost, device::Memory& dstMemory,
+                                       const amd::Coord3D& origin,
+                                       const amd::Coord3D& size) const {
+  address dst = gpuMem(dstMemory).getDeviceMemory() + origin[0];
+  nontemporalWrite(dst, reinterpret_cast<const_address>(srcHost), size[0]);
+
+  // Make sure the data passed HDP, before the GPU accesses it
+  if (dev().info().hdpMemFlushCntl != nullptr) {
+    *dev().info().hdpMemFlushCntl = 1u;
+    auto kSentinel = *reinterpret_cast<volatile int*>(dev().info().hdpMemFlushCntl);
+  } else if (size[0] != 0) {
+    auto kSentinel = *reinterpret_cast<volatile unsigned char*>(dst + size[0] - 1);
+  }
+}
+
 // ================================================================================================
 bool KernelBlitManager::writeBuffer(const void* srcHost, device::Memory& dstMemory,
                                     const amd::Coord3D& origin, const amd::Coord3D& size,
@@ -1935,42 +2315,69 @@ bool KernelBlitManager::writeBuffer(const void* srcHost, device::Memory& dstMemo
     result = HostBlitManager::writeBuffer(srcHost, dstMemory, origin, size, entire, copyMetadata);
     synchronize();
     return result;
-  } else {
-    size_t pinSize = size[0];
-
-    // Check if a pinned transfer can be executed with a single pin
-    // If sdmaCopyThreshold is set ignore pinning restrictions and always pin to make sure we use
-    // Blit for copies
-    if (((pinSize <= dev().settings().pinnedXferSize_) && (pinSize > MinSizeForPinnedTransfer)) ||
-        (pinSize <= dev().settings().sdmaCopyThreshold_)) {
-      size_t partial;
-      amd::Memory* amdMemory = pinHostMemory(srcHost, pinSize, partial);
-
-      if (amdMemory == nullptr) {
-        // Force SW copy
-        result = DmaBlitManager::writeBuffer(srcHost, dstMemory, origin, size, entire, copyMetadata);
-        synchronize();
-        return result;
-      }
+  }
 
-      // Readjust destination offset
-      const amd::Coord3D srcOrigin(partial);
+  // Small copies skip the GPU engines and go over the large BAR. The first copy above the
+  // calibration size times both paths and lowers the limit to the size, where they break even
+  uint64_t cpuNanos = 0;
+  uint64_t gpuStart = 0;
+  if (cpuWriteAllowed(dstMemory, size[0])) {
+    if (cpuWriteCalibrated_ || (size[0] < kCpuWriteCalibrationSize)) {
+      writeBufferCpu(srcHost, dstMemory, origin, size);
+      synchronize();
+      return true;
+    }
+    uint64_t start = amd::Os::timeNanos();
+    writeBufferCpu(srcHost, dstMemory, origin, size);
+    gpuStart = amd::Os::timeNanos();
+    cpuNanos = std::max<uint64_t>(gpuStart - start, 1);
+  }
 
-      // Get device memory for this virtual device
-      Memory* srcMemory = dev().getRocMemory(amdMemory);
+  size_t pinSize = size[0];
 
-      // Copy buffer
-      result = copyBuffer(*srcMemory, dstMemory, srcOrigin, origin, size, entire, copyMetadata);
+  // Check if a pinned transfer can be executed with a single pin
+  // If sdmaCopyThreshold is set ignore pinning restrictions and always pin to make sure we use
+  // Blit for copies
+  if (((pinSize <= dev().settings().pinnedXferSize_) && (pinSize > MinSizeForPinnedTransfer)) ||
+      (pinSize <= dev().settings().sdmaCopyThreshold_)) {
+    size_t partial;
+    amd::Memory* amdMemory = pinHostMemory(srcHost, pinSize, partial);
 
-      // Add pinned memory for a later release
-      gpu().addPinnedMem(amdMemory);
-    } else {
+    if (amdMemory == nullptr) {
+      // Force SW copy
       result = DmaBlitManager::writeBuffer(srcHost, dstMemory, origin, size, entire, copyMetadata);
+      synchronize();
+      return result;
     }
+
+    // Readjust destination offset
+    const amd::Coord3D srcOrigin(partial);
+
+    // Get device memory for this virtual device
+    Memory* srcMemory = dev().getRocMemory(amdMemory);
+
+    // Copy buffer
+    result = copyBuffer(*srcMemory, dstMemory, srcOrigin, origin, size, entire, copyMetadata);
+
+    // Add pinned memory for a later release
+    gpu().addPinnedMem(amdMemory);
+  } else {
+    result = DmaBlitManager::writeBuffer(srcHost, dstMemory, origin, size, entire, copyMetadata);
   }
 
   synchronize();
 
+  if ((gpuStart != 0) && result) {
+    gpu().releaseGpuMemoryFence();
+    uint64_t gpuNanos = amd::Os::timeNanos() - gpuStart;
+    // The GPU path cost is mostly the fixed submission latency for small copies
+    double limit = static_cast<double>(gpuNanos) * size[0] / cpuNanos;
+    cpuWriteLimit_ = std::min(cpuWriteLimit_, static_cast<size_t>(limit));
+    cpuWriteCalibrated_ = true;
+    ClPrint(amd::LOG_INFO, amd::LOG_COPY, "CPU write %zu bytes: %lu ns, GPU: %lu ns, limit %zu",
+            size[0], cpuNanos, gpuNanos, cpuWriteLimit_);
+  }
+
   return result;
 }
 
@@ -2036,6 +2443,14 @@ bool KernelBlitManager::fillBuffer(device::Memory& memory, const void* pattern,
 
   guarantee(size[0] > 0 && size[1] > 0 && size[2] > 0, "Dimension cannot be 0");
 
+  // A host fill would run once at capture time instead of on every graph replay
+  forceBlit |= gpu().isPacketCapturing();
+
+  if (!setup_.disableFillBuffer_ && (forceBlit || !memory.isHostMemDirectAccess()) &&
+      (kernels_[FillBufferWide] != nullptr) && (patternSize <= kCBSize)) {
+    return fillBufferWide(memory, pattern, patternSize, surface, origin, size);
+  }
+
   if (size[1] == 1 && size[2] == 1) {
     return fillBuffer1D(memory, pattern, patternSize, surface, origin, size, entire, forceBlit);
   } else if (size[2] == 1) {
@@ -2056,6 +2471,64 @@ bool KernelBlitManager::fillBuffer(device::Memory& memory, const void* pattern,
   }
 }
 
+// ================================================================================================
+bool KernelBlitManager::fillBufferWide(device::Memory& memory, const void* pattern,
+                                       size_t patternSize, const amd::Coord3D& surface,
+                                       const amd::Coord3D& origin,
+                                       const amd::Coord3D& size) const {
+  amd::ScopedLock k(lockXferOps_);
+  constexpr uint32_t kFillType = FillBufferWide;
+  constexpr size_t kStoreSize = 2 * sizeof(uint64_t);
+
+  uint64_t width = size[0];
+  uint64_t pitch = surface[0];
+  uint64_t slicePitch = surface[0] * surface[2];
+  // 3D fills take the origin in rows and slices, see fillBuffer()
+  size_t offset = origin[0];
+  if (size[2] > 1) {
+    offset += origin[1] * pitch + origin[2] * slicePitch;
+  }
+
+  // The pattern repeats every lcm(patternSize, kStoreSize) bytes. The grid stride over
+  // the row body must be a multiple of that period for a fixed value per work item
+  size_t periodStores = patternSize / std::min(patternSize & (~patternSize + 1), kStoreSize);
+  const size_t localWorkSize = 64;
+  const size_t granularity = localWorkSize * periodStores;
+  size_t workX = std::min<size_t>(width / kStoreSize + 1,
+                                  dev().settings().limit_blit_wg_ * 256);
+  workX = ((workX + granularity - 1) / granularity) * granularity;
+
+  size_t globalWorkOffset[3] = {0, 0, 0};
+  size_t globalWorkSize[3] = {workX, size[1], size[2]};
+  size_t localWorkSizes[3] = {localWorkSize, 1, 1};
+
+  cl_mem mem = as_cl<amd::Memory>(memory.owner());
+  setArgument(kernels_[kFillType], 0, sizeof(cl_mem), &mem, offset);
+
+  auto constBuf = gpu().allocKernArg(kCBSize, kCBAlignment);
+  memcpy(constBuf, pattern, patternSize);
+  constexpr bool kDirectVa = true;
+  setArgument(kernels_[kFillType], 1, sizeof(cl_mem), constBuf, 0, nullptr, kDirectVa);
+
+  uint32_t kpattern_size = patternSize;
+  setArgument(kernels_[kFillType], 2, sizeof(kpattern_size), &kpattern_size);
+  setArgument(kernels_[kFillType], 3, sizeof(width), &width);
+  setArgument(kernels_[kFillType], 4, sizeof(pitch), &pitch);
+  setArgument(kernels_[kFillType], 5, sizeof(slicePitch), &slicePitch);
+
+  // Create ND range object for the kernel's execution
+  amd::NDRangeContainer ndrange(3, globalWorkOffset, globalWorkSize, localWorkSizes);
+
+  // Execute the blit
+  address parameters = captureArguments(kernels_[kFillType]);
+  bool result = gpu().submitKernelInternal(ndrange, *kernels_[kFillType], parameters, nullptr);
+  releaseArguments(parameters);
+
+  synchronize();
+
+  return result;
+}
+
 // ================================================================================================
 bool KernelBlitManager::fillBuffer1D(device::Memory& memory, const void* pattern,
                                      size_t patternSize, const amd::Coord3D& surface,
@@ -2235,6 +2708,50 @@ bool KernelBlitManager::fillBuffer3D(device::Memory& memory, const void* pattern
   ShouldNotReachHere();
   return false;
 }
+// ================================================================================================
+KernelBlitManager::CopyPathTuner::CopyPathTuner() {
+  memset(table_, 0, sizeof(table_));
+}
+
+// ================================================================================================
+uint KernelBlitManager::CopyPathTuner::Bucket(size_t size) {
+  uint bucket = std::min(std::max(amd::log2(size), MinBucket), MaxBucket);
+  return bucket - MinBucket;
+}
+
+// ================================================================================================
+bool KernelBlitManager::CopyPathTuner::Select(Direction dir, size_t size, Path* path) const {
+  const Entry& entry = table_[dir][Bucket(size)];
+  const uint32_t samples = ROC_COPY_AUTOTUNE_SAMPLES;
+
+  if ((entry.samples_[Sdma] < samples) || (entry.samples_[Kernel] < samples)) {
+    // Still learning, alternate the engines until both have enough samples
+    *path = (entry.samples_[Sdma] <= entry.samples_[Kernel]) ? Sdma : Kernel;
+    return true;
+  }
+
+  double sdma = entry.nsPerByte_[Sdma] / entry.samples_[Sdma];
+  double kernel = entry.nsPerByte_[Kernel] / entry.samples_[Kernel];
+  *path = (sdma < kernel) ? Sdma : Kernel;
+  return false;
+}
+
+// ================================================================================================
+void KernelBlitManager::CopyPathTuner::Record(Direction dir, size_t size, Path path,
+                                              uint64_t nanos) {
+  Entry& entry = table_[dir][Bucket(size)];
+  entry.nsPerByte_[path] += static_cast<double>(nanos) / size;
+  entry.samples_[path]++;
+
+  if ((entry.samples_[Sdma] == ROC_COPY_AUTOTUNE_SAMPLES) &&
+      (entry.samples_[Kernel] == ROC_COPY_AUTOTUNE_SAMPLES)) {
+    ClPrint(amd::LOG_INFO, amd::LOG_COPY,
+            "Copy tuner: direction %d, size 2^%d, SDMA %f ns/B, kernel %f ns/B", dir,
+            Bucket(size) + MinBucket, entry.nsPerByte_[Sdma] / entry.samples_[Sdma],
+            entry.nsPerByte_[Kernel] / entry.samples_[Kernel]);
+  }
+}
+
 // ================================================================================================
 bool KernelBlitManager::copyBuffer(device::Memory& srcMemory, device::Memory& dstMemory,
                                    const amd::Coord3D& srcOrigin, const amd::Coord3D& dstOrigin,
@@ -2262,7 +2779,9 @@ bool KernelBlitManager::copyBuffer(device::Memory& srcMemory, device::Memory& ds
 #endif
 #endif
 
-  bool useShaderCopyPath = setup_.disableHwlCopyBuffer_ ||
+  // Graph replay submits only the captured AQL packets, so SDMA can't be used under capture
+  const bool capturing = gpu().isPacketCapturing();
+  bool useShaderCopyPath = setup_.disableHwlCopyBuffer_ || capturing ||
       (sizeIn[0] <= dev().settings().sdmaCopyThreshold_) ||
       (!(p2p || asan || ipcShared) &&
            (!srcMemory.isHostMemDirectAccess() && !dstMemory.isHostMemDirectAccess() &&
@@ -2270,6 +2789,29 @@ bool KernelBlitManager::copyBuffer(device::Memory& srcMemory, device::Memory& ds
               amd::CopyMetadata::CopyEnginePreference::SDMA)) ||
        (copyMetadata.copyEnginePreference_ == amd::CopyMetadata::CopyEnginePreference::BLIT));
 
+  // Let the tuner pick the engine when both are valid and the caller has no preference
+  bool timed = false;
+  uint64_t start = 0;
+  CopyPathTuner::Direction dir = CopyPathTuner::DeviceToDevice;
+  if ((ROC_COPY_AUTOTUNE_SAMPLES > 0) && !setup_.disableHwlCopyBuffer_ && !capturing &&
+      (&gpuMem(srcMemory).dev() == &gpuMem(dstMemory).dev()) && !(asan || ipcShared) &&
+      (sizeIn[0] >= (size_t(1) << CopyPathTuner::MinBucket)) &&
+      (copyMetadata.copyEnginePreference_ == amd::CopyMetadata::CopyEnginePreference::NONE)) {
+    if (srcMemory.isHostMemDirectAccess()) {
+      dir = CopyPathTuner::HostToDevice;
+    } else if (dstMemory.isHostMemDirectAccess()) {
+      dir = CopyPathTuner::DeviceToHost;
+    }
+    CopyPathTuner::Path path;
+    timed = copyTuner_.Select(dir, sizeIn[0], &path);
+    useShaderCopyPath = (path == CopyPathTuner::Kernel);
+    if (timed) {
+      // Drain the queue, so only this copy is measured
+      gpu().releaseGpuMemoryFence();
+      start = amd::Os::timeNanos();
+    }
+  }
+
   if (!useShaderCopyPath) {
     if (amd::IS_HIP) {
       // Update the command type for ROC profiler
@@ -2283,6 +2825,7 @@ bool KernelBlitManager::copyBuffer(device::Memory& srcMemory, device::Memory& ds
     result = DmaBlitManager::copyBuffer(srcMemory, dstMemory, srcOrigin, dstOrigin, sizeIn, entire,
                                         copyMetadata);
   }
+  CopyPathTuner::Path usedPath = result ? CopyPathTuner::Sdma : CopyPathTuner::Kernel;
 
   if (!result) {
     constexpr uint32_t kBlitType = BlitCopyBuffer;
@@ -2336,6 +2879,120 @@ bool KernelBlitManager::copyBuffer(device::Memory& srcMemory, device::Memory& ds
     releaseArguments(parameters);
   }
 
+  if (timed && result) {
+    gpu().releaseGpuMemoryFence();
+    copyTuner_.Record(dir, sizeIn[0], usedPath, amd::Os::timeNanos() - start);
+  }
+
+  synchronize();
+
+  return result;
+}
+
+// ================================================================================================
+bool KernelBlitManager::copyBufferBatch(const BatchCopyDesc* descs, size_t count) const {
+  constexpr uint32_t kBlitType = BlitCopyBufferBatch;
+  if (kernels_[kBlitType] == nullptr) {
+    return false;
+  }
+
+  amd::ScopedLock k(lockXferOps_);
+  bool result = true;
+  const size_t localWorkSize = 256;
+
+  for (size_t first = 0; result && (first < count); first += MaxBatchCopies) {
+    uint32_t numCopies = static_cast<uint32_t>(std::min(count - first, MaxBatchCopies));
+    size_t tableSize = numCopies * sizeof(BatchCopyDesc);
+
+    // The descriptor table lives in the kernel arguments pool, so it's recycled with the dispatch
+    auto table = gpu().allocKernArg(tableSize, kCBAlignment);
+    memcpy(table, descs + first, tableSize);
+    constexpr bool kDirectVa = true;
+    setArgument(kernels_[kBlitType], 0, sizeof(cl_mem), table, 0, nullptr, kDirectVa);
+    setArgument(kernels_[kBlitType], 1, sizeof(numCopies), &numCopies);
+
+    // A workgroup per copy, since the batched copies are expected to be small
+    size_t globalWorkSize = numCopies * localWorkSize;
+
+    // Create ND range object for the kernel's execution
+    amd::NDRangeContainer ndrange(1, nullptr, &globalWorkSize, &localWorkSize);
+
+    // Execute the blit
+    address parameters = captureArguments(kernels_[kBlitType]);
+    result = gpu().submitKernelInternal(ndrange, *kernels_[kBlitType], parameters, nullptr);
+    releaseArguments(parameters);
+  }
+
+  synchronize();
+
+  return result;
+}
+
+// ================================================================================================
+bool KernelBlitManager::fillBufferBatch(const BatchFillDesc* descs, size_t count) const {
+  constexpr uint32_t kBlitType = FillBufferBatch;
+  if (kernels_[kBlitType] == nullptr) {
+    return false;
+  }
+
+  amd::ScopedLock k(lockXferOps_);
+  bool result = true;
+  const size_t localWorkSize = 256;
+
+  for (size_t first = 0; result && (first < count); first += MaxBatchCopies) {
+    uint32_t numFills = static_cast<uint32_t>(std::min(count - first, MaxBatchCopies));
+    size_t tableSize = numFills * sizeof(BatchFillDesc);
+
+    // The descriptor table lives in the kernel arguments pool, so it's recycled with the dispatch
+    auto table = gpu().allocKernArg(tableSize, kCBAlignment);
+    memcpy(table, descs + first, tableSize);
+    constexpr bool kDirectVa = true;
+    setArgument(kernels_[kBlitType], 0, sizeof(cl_mem), table, 0, nullptr, kDirectVa);
+    setArgument(kernels_[kBlitType], 1, sizeof(numFills), &numFills);
+
+    // A workgroup per fill, since the batched fills are expected to be small
+    size_t globalWorkSize = numFills * localWorkSize;
+
+    // Create ND range object for the kernel's execution
+    amd::NDRangeContainer ndrange(1, nullptr, &globalWorkSize, &localWorkSize);
+
+    // Execute the blit
+    address parameters = captureArguments(kernels_[kBlitType]);
+    result = gpu().submitKernelInternal(ndrange, *kernels_[kBlitType], parameters, nullptr);
+    releaseArguments(parameters);
+  }
+
+  synchronize();
+
+  return result;
+}
+
+// ================================================================================================
+bool KernelBlitManager::graphCondition(uint64_t predicate, uint64_t packets, uint64_t queue,
+                                       uint64_t signal, bool loop) const {
+  constexpr uint32_t kBlitType = BlitGraphCondition;
+  if (kernels_[kBlitType] == nullptr) {
+    return false;
+  }
+
+  amd::ScopedLock k(lockXferOps_);
+  const uint32_t repeat = loop ? 1 : 0;
+  setArgument(kernels_[kBlitType], 0, sizeof(predicate), &predicate);
+  setArgument(kernels_[kBlitType], 1, sizeof(packets), &packets);
+  setArgument(kernels_[kBlitType], 2, sizeof(queue), &queue);
+  setArgument(kernels_[kBlitType], 3, sizeof(signal), &signal);
+  setArgument(kernels_[kBlitType], 4, sizeof(repeat), &repeat);
+
+  // A single work item evaluates the predicate and dispatches the body
+  size_t globalWorkSize = 1;
+  size_t localWorkSize = 1;
+  amd::NDRangeContainer ndrange(1, nullptr, &globalWorkSize, &localWorkSize);
+
+  // Execute the blit
+  address parameters = captureArguments(kernels_[kBlitType]);
+  bool result = gpu().submitKernelInternal(ndrange, *kernels_[kBlitType], parameters, nullptr);
+  releaseArguments(parameters);
+
   synchronize();
 
   return result;
@@ -2640,8 +3297,19 @@ amd::Memory* DmaBlitManager::pinHostMemory(const void* hostMem, size_t pinSize,
     return amdMemory;
   }
 
+  // Check the process wide cache, which may have a larger pinned range with the same memory
+  size_t offset = 0;
+  amdMemory = PinnedMemoryCache::Find(dev(), tmpHost, pinAllocSize, &offset);
+  if (nullptr != amdMemory) {
+    partial += offset;
+    return amdMemory;
+  }
+
   amdMemory = new (*context_) amd::Buffer(*context_, CL_MEM_USE_HOST_PTR, pinAllocSize);
-  amdMemory->setVirtualDevice(&gpu());
+  if ((amdMemory != nullptr) && (ROC_PINNED_CACHE_SIZE == 0)) {
+    // The cached pinned memory is shared by all queues, hence only uncached one belongs to gpu()
+    amdMemory->setVirtualDevice(&gpu());
+  }
   if ((amdMemory != nullptr) && !amdMemory->create(tmpHost, SysMem)) {
     DevLogPrintfError("Buffer create failed, Buffer: 0x%x \n", amdMemory);
     amdMemory->release();
@@ -2663,6 +3331,10 @@ amd::Memory* DmaBlitManager::pinHostMemory(const void* hostMem, size_t pinSize,
     }
   }
 
+  if (amdMemory != nullptr) {
+    PinnedMemoryCache::Insert(dev(), amdMemory);
+  }
+
   return amdMemory;
 }
 
@@ -2764,11 +3436,7 @@ bool KernelBlitManager::runScheduler(uint64_t vqVM, amd::Memory* schedulerParam,
   }
   releaseArguments(parameters);
 
-  if (!WaitForSignal(schedulerSignal)) {
-    LogWarning("Failed schedulerSignal wait");
-    return false;
-  }
-
+  // The caller waits for schedulerSignal on the GPU and before the next launch
   return true;
 }
 
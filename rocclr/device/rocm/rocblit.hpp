@@ -207,8 +207,31 @@ class DmaBlitManager : public device::HostBlitManager {
     return false;
   }
 
+  //! Streams a file region into a buffer object
+  bool writeBufferFromFile(amd::Os::FileDesc fileDesc,  //!< Source file descriptor
+                           uint64_t fileOffset,         //!< Offset in the file
+                           device::Memory& dstMemory,   //!< Destination memory object
+                           size_t origin,               //!< Destination origin
+                           size_t size                  //!< Size of the copy region
+                           ) const;
+
  protected:
   static constexpr uint MaxPinnedBuffers = 4;
+  static constexpr size_t MinStagingSlotSize = 64 * Ki;  //!< The smallest slot of staging ring
+  static constexpr size_t DirectIoAlignment = 4 * Ki;    //!< Alignment of unbuffered file reads
+
+  //! Copies between images with the linear layout and buffers with SDMA rect copies
+  bool copyImageLinear(device::Memory& srcMemory,      //!< Source memory object
+                       device::Memory& dstMemory,      //!< Destination memory object
+                       const amd::Coord3D& srcOrigin,  //!< Source origin
+                       const amd::Coord3D& dstOrigin,  //!< Destination origin
+                       const amd::Coord3D& size,       //!< Size of the copy region
+                       size_t rowPitch = 0,            //!< Pitch for the buffer
+                       size_t slicePitch = 0           //!< Slice for the buffer
+                       ) const;
+
+  //! Fills a staging slot with the data for the offset in the copy
+  typedef std::function<bool(address slot, size_t offset, size_t size)> StagingFill;
 
   //! Synchronizes the blit operations if necessary
   inline void synchronize() const;
@@ -233,6 +256,12 @@ class DmaBlitManager : public device::HostBlitManager {
                const amd::Coord3D& dstOrigin, const amd::Coord3D& size,
                amd::CopyMetadata copyMetadata) const;
 
+  //! Splits the copy across the SDMA engines in the mask, all stripes share the completion signal
+  hsa_status_t hsaCopyStriped(address dst, hsa_agent_t dstAgent, const_address src,
+                              hsa_agent_t srcAgent, size_t size,
+                              const std::vector<hsa_signal_t>& wait_events, hsa_signal_t active,
+                              uint32_t stripeMask, uint32_t stripeCount, bool forceSDMA) const;
+
   const size_t MinSizeForPinnedTransfer;
   bool completeOperation_;                    //!< DMA blit manager must complete operation
   amd::Context* context_;                     //!< A dummy context
@@ -274,7 +303,9 @@ class DmaBlitManager : public device::HostBlitManager {
                      address hostDst,        //!< Destination buffer address for copying
                      size_t size,            //!< Size of data to copy in bytes
                      address staging,        //!< Staging resource
-                     bool hostToDev          //!< True if data is copied from Host To Device
+                     bool hostToDev,         //!< True if data is copied from Host To Device
+                     const StagingFill& fill =
+                         nullptr             //!< Fills the slots instead of hostSrc copies
                      ) const;
 
   bool forceHostWaitFunc(size_t copy_size) const;
@@ -286,10 +317,14 @@ class KernelBlitManager : public DmaBlitManager {
   enum {
     FillBufferAligned = 0,
     FillBufferAligned2D,
+    FillBufferWide,
     BlitCopyBuffer,
     BlitCopyBufferAligned,
     BlitCopyBufferRect,
     BlitCopyBufferRectAligned,
+    BlitCopyBufferBatch,
+    FillBufferBatch,
+    BlitGraphCondition,
     StreamOpsWrite,
     StreamOpsWait,
     Scheduler,
@@ -379,6 +414,39 @@ class KernelBlitManager : public DmaBlitManager {
                                     amd::CopyMetadata()   //!< Memory copy MetaData
                           ) const;
 
+  //! Descriptor of a single copy in the batch, the layout is read by the blit kernel
+  struct BatchCopyDesc {
+    uint64_t src_;   //!< Source device address
+    uint64_t dst_;   //!< Destination device address
+    uint64_t size_;  //!< Size of the copy in bytes
+  };
+
+  //! Executes a list of independent linear copies with a dispatch per MaxBatchCopies
+  bool copyBufferBatch(const BatchCopyDesc* descs,  //!< Copy descriptors
+                       size_t count                 //!< Number of descriptors
+                       ) const;
+
+  //! Descriptor of a single byte fill in the batch, the layout is read by the blit kernel
+  struct BatchFillDesc {
+    uint64_t dst_;    //!< Destination device address
+    uint64_t value_;  //!< Byte value in the lowest 8 bits
+    uint64_t size_;   //!< Size of the fill in bytes
+  };
+
+  //! Executes a list of independent linear byte fills with a dispatch per MaxBatchCopies
+  bool fillBufferBatch(const BatchFillDesc* descs,  //!< Fill descriptors
+                       size_t count                 //!< Number of descriptors
+                       ) const;
+
+  //! Runs the packets of a device graph on the body queue while the predicate isn't zero.
+  //! The blit waits for every iteration on the signal, hence it occupies a single wave
+  bool graphCondition(uint64_t predicate,  //!< Device address of the uint32_t predicate
+                      uint64_t packets,    //!< Device graph with the packets of the body
+                      uint64_t queue,      //!< HSA queue, which runs the body
+                      uint64_t signal,     //!< Signal, which marks the end of an iteration
+                      bool loop            //!< Repeat the body until the predicate is zero
+                      ) const;
+
   //! Copies a buffer object to an image object
   virtual bool copyBufferToImage(device::Memory& srcMemory,      //!< Source memory object
                                  device::Memory& dstMemory,      //!< Destination memory object
@@ -531,6 +599,7 @@ class KernelBlitManager : public DmaBlitManager {
   static constexpr size_t MaxXferBuffers = 2;
   static constexpr uint TransferSplitSize = 1;
   static constexpr uint MaxNumIssuedTransfers = 3;
+  static constexpr size_t MaxBatchCopies = 1024;  //!< Descriptors in a single batch dispatch
 
   //! Copies a buffer object to an image object
   bool copyBufferToImageKernel(device::Memory& srcMemory,      //!< Source memory object
@@ -558,6 +627,27 @@ class KernelBlitManager : public DmaBlitManager {
                                     amd::CopyMetadata()   //!< Memory copy MetaData
                                ) const;
 
+  //! Fills 1D, 2D and 3D regions in a single dispatch with 128 bit stores for any pattern size
+  bool fillBufferWide(device::Memory& memory,      //!< Memory object to fill with pattern
+                      const void* pattern,         //!< Pattern data
+                      size_t patternSize,          //!< Pattern size
+                      const amd::Coord3D& surface, //!< Whole Surface of mem object.
+                      const amd::Coord3D& origin,  //!< Destination origin
+                      const amd::Coord3D& size     //!< Size of the fill region
+                      ) const;
+
+  //! Returns TRUE if the host data can be written by the CPU over the large BAR
+  bool cpuWriteAllowed(device::Memory& dstMemory,        //!< Destination memory object
+                       size_t size                       //!< Size of the copy region
+                       ) const;
+
+  //! Writes host data into the device memory with CPU streaming stores over the large BAR
+  void writeBufferCpu(const void* srcHost,               //!< Source host memory
+                      device::Memory& dstMemory,         //!< Destination memory object
+                      const amd::Coord3D& origin,        //!< Destination origin
+                      const amd::Coord3D& size           //!< Size of the copy region
+                      ) const;
+
   //! Creates a program for all blit operations
   bool createProgram(Device& device  //!< Device object
                      );
@@ -576,9 +666,40 @@ class KernelBlitManager : public DmaBlitManager {
                           const device::Memory* dev_mem = nullptr,
                           bool writeVAImmediate = false) const;
 
+  //! Smallest copy, which times the CPU writes against the GPU engines
+  static constexpr size_t kCpuWriteCalibrationSize = 4 * Ki;
+
   static constexpr uint32_t kCBSize = 0x100;
   static constexpr size_t   kCBAlignment = 0x100;
 
+  //! Learns from timed copies which engine is faster for each direction and size bucket
+  class CopyPathTuner {
+   public:
+    enum Direction { HostToDevice = 0, DeviceToHost, DeviceToDevice, DirectionTotal };
+    enum Path { Sdma = 0, Kernel, PathTotal };
+
+    static constexpr uint MinBucket = 12;  //!< Smallest tuned size, 4KB
+    static constexpr uint MaxBucket = 30;  //!< Sizes above 1GB share the last bucket
+
+    CopyPathTuner();
+
+    //! Returns true if the copy should be timed and sets the engine to use
+    bool Select(Direction dir, size_t size, Path* path) const;
+
+    //! Accounts the time of a completed copy
+    void Record(Direction dir, size_t size, Path path, uint64_t nanos);
+
+   private:
+    struct Entry {
+      uint32_t samples_[PathTotal];  //!< Number of timed copies per engine
+      double nsPerByte_[PathTotal];  //!< Accumulated time per byte, divided by samples_
+    };
+
+    static uint Bucket(size_t size);
+
+    Entry table_[DirectionTotal][MaxBucket - MinBucket + 1];
+  };
+
   inline uint32_t NumBlitKernels() {
     return (dev().info().imageSupport_) ? BlitTotal : BlitLinearTotal;
   }
@@ -593,12 +714,18 @@ class KernelBlitManager : public DmaBlitManager {
   amd::Kernel* kernels_[BlitTotal];   //!< GPU kernels for blit
   size_t xferBufferSize_;             //!< Transfer buffer size
   mutable amd::Monitor  lockXferOps_; //!< Lock transfer operation
+  mutable CopyPathTuner copyTuner_;   //!< Engine selection learned from timed copies
+  mutable size_t cpuWriteLimit_;      //!< CPU write size limit, calibrated on a timed copy
+  mutable bool cpuWriteCalibrated_;   //!< TRUE if cpuWriteLimit_ was calibrated
 };
 
 static const char* BlitName[KernelBlitManager::BlitTotal] = {
-  "__amd_rocclr_fillBufferAligned", "__amd_rocclr_fillBufferAligned2D", "__amd_rocclr_copyBuffer",
+  "__amd_rocclr_fillBufferAligned", "__amd_rocclr_fillBufferAligned2D",
+  "__amd_rocclr_fillBufferWide", "__amd_rocclr_copyBuffer",
   "__amd_rocclr_copyBufferAligned", "__amd_rocclr_copyBufferRect",
-  "__amd_rocclr_copyBufferRectAligned", "__amd_rocclr_streamOpsWrite", "__amd_rocclr_streamOpsWait",
+  "__amd_rocclr_copyBufferRectAligned", "__amd_rocclr_copyBufferBatch",
+  "__amd_rocclr_fillBufferBatch", "__amd_rocclr_graphCondition",
+  "__amd_rocclr_streamOpsWrite", "__amd_rocclr_streamOpsWait",
   "__amd_rocclr_scheduler", "__amd_rocclr_gwsInit", "__amd_rocclr_initHeap",
   "__amd_rocclr_fillImage", "__amd_rocclr_copyImage", "__amd_rocclr_copyImage1DA",
   "__amd_rocclr_copyImageToBuffer", "__amd_rocclr_copyBufferToImage"
@@ -21,6 +21,7 @@
 #include "device/rocm/roccounters.hpp"
 #include "device/rocm/rocvirtual.hpp"
 #include <array>
+#include <sstream>
 
 namespace amd::roc {
 
@@ -614,6 +615,132 @@ hsa_ext_amd_aql_pm4_packet_t* PerfCounterProfile::createStopPacket() {
   return &postPacket_;
 }
 
+// ================================================================================================
+KernelCounterSampler::KernelCounterSampler(VirtualGPU& gpu) : gpu_(gpu) {}
+
+// ================================================================================================
+KernelCounterSampler::~KernelCounterSampler() {
+  for (auto profile : profiles_) {
+    profile->release();
+  }
+}
+
+// ================================================================================================
+bool KernelCounterSampler::create() {
+  // The counters are the ORCA block and event indices, as in the OpenCL perfcounter extension
+  std::stringstream list(ROC_KERNEL_COUNTERS);
+  std::string item;
+  while (std::getline(list, item, ',')) {
+    uint32_t block = 0;
+    uint32_t event = 0;
+    if (sscanf(item.c_str(), "%u:%u", &block, &event) != 2) {
+      LogPrintfWarning("Ignoring the invalid counter \"%s\" in ROC_KERNEL_COUNTERS",
+                       item.c_str());
+      continue;
+    }
+    PerfCounter counter(gpu_.dev(), block, 0, event);
+    if ((counter.gfxVersion() == PerfCounter::ROC_UNSUPPORTED) ||
+        (counter.event().block_name == HSA_VEN_AMD_AQLPROFILE_BLOCKS_NUMBER)) {
+      LogPrintfWarning("Counter %u:%u isn't supported on the device", block, event);
+      continue;
+    }
+    gfxVersion_ = counter.gfxVersion();
+    events_.push_back(counter.event());
+    names_.push_back(std::to_string(block) + ":" + std::to_string(event));
+  }
+  return !events_.empty();
+}
+
+// ================================================================================================
+PerfCounterProfile* KernelCounterSampler::allocProfile() {
+  if (!free_.empty()) {
+    PerfCounterProfile* profile = free_.back();
+    free_.pop_back();
+    return profile;
+  }
+  if (profiles_.size() >= kMaxProfiles) {
+    return nullptr;
+  }
+  PerfCounterProfile* profile = new PerfCounterProfile(gpu_.dev());
+  if (!profile->Create()) {
+    profile->release();
+    return nullptr;
+  }
+  for (const auto& event : events_) {
+    profile->addEvent(event);
+  }
+  if (!profile->initialize()) {
+    profile->release();
+    return nullptr;
+  }
+  profiles_.push_back(profile);
+  return profile;
+}
+
+// ================================================================================================
+bool KernelCounterSampler::begin(const std::string& kernelName) {
+  if ((dispatches_++ % std::max(ROC_KERNEL_COUNTERS_SAMPLE, 1u)) != 0) {
+    return false;
+  }
+  PerfCounterProfile* profile = allocProfile();
+  if (profile == nullptr) {
+    // The application doesn't wait for the queue often enough, skip the dispatch
+    ++skipped_;
+    return false;
+  }
+  if (profile->createStartPacket() == nullptr) {
+    free_.push_back(profile);
+    return false;
+  }
+  const auto output = profile->profile()->output_buffer;
+  memset(output.ptr, 0, output.size);
+  gpu_.dispatchCounterAqlPacket(profile->prePacket(), gfxVersion_, false, profile->api());
+  active_ = {profile, kernelName};
+  return true;
+}
+
+// ================================================================================================
+void KernelCounterSampler::end() {
+  PerfCounterProfile* profile = active_.profile_;
+  if (profile == nullptr) {
+    return;
+  }
+  if (profile->createStopPacket() == nullptr) {
+    free_.push_back(profile);
+  } else {
+    // The barrier bit keeps the stop packet behind the end of the sampled kernel
+    gpu_.dispatchCounterAqlPacket(profile->postPacket(), gfxVersion_, false, profile->api(),
+                                  true);
+    pending_.push_back(std::move(active_));
+  }
+  active_ = {nullptr, ""};
+}
+
+// ================================================================================================
+void KernelCounterSampler::collect() {
+  std::vector<uint64_t> values(events_.size());
+  std::vector<hsa_ven_amd_aqlprofile_info_data_t> data;
+  for (auto& sample : pending_) {
+    data.clear();
+    sample.profile_->api()->hsa_ven_amd_aqlprofile_iterate_data(sample.profile_->profile(),
+                                                                PerfCounterCallback, &data);
+    std::fill(values.begin(), values.end(), 0);
+    for (const auto& it : data) {
+      for (size_t i = 0; i < events_.size(); ++i) {
+        if (it.pmc_data.event.block_name == events_[i].block_name &&
+            it.pmc_data.event.block_index == events_[i].block_index &&
+            it.pmc_data.event.counter_id == events_[i].counter_id) {
+          values[i] += it.pmc_data.result;
+        }
+      }
+    }
+    gpu_.RecordCounterSample(sample.kernel_, values);
+    free_.push_back(sample.profile_);
+  }
+  pending_.clear();
+}
+
+// ================================================================================================
 PerfCounterProfile::~PerfCounterProfile() {
 
   if (completionSignal_.handle != 0) {
@@ -70,6 +70,9 @@ class PerfCounter : public device::PerfCounter {
   //! Returns the profile reference
   PerfCounterProfile*  profileRef() const { return profileRef_; }
 
+  //! Returns the aqlprofile event of the counter
+  const hsa_ven_amd_aqlprofile_event_t& event() const { return event_; }
+
   //! Update the profile associated with the counter
   void  setProfile(PerfCounterProfile* profileRef);
 
@@ -187,6 +190,55 @@ class PerfCounterProfile : public amd::ReferenceCountedObject {
 
 };
 
+//! Samples the counter set of ROC_KERNEL_COUNTERS around the kernel dispatches of a queue
+//! and accumulates the results per kernel name in the dispatch stats of the queue
+class KernelCounterSampler : public amd::HeapObject {
+ public:
+  KernelCounterSampler(VirtualGPU& gpu);
+  ~KernelCounterSampler();
+
+  //! Parses ROC_KERNEL_COUNTERS, returns false if no valid counter was found
+  bool create();
+
+  //! Dispatches the start packet before the kernel, returns false if the dispatch isn't sampled
+  bool begin(const std::string& kernelName);
+
+  //! Dispatches the stop packet after the kernel of the last begin()
+  void end();
+
+  //! Accumulates the results of the sampled dispatches. All dispatches must be complete
+  void collect();
+
+  //! Returns the names of the sampled counters, in the order of DispatchStats::counters_
+  const std::vector<std::string>& names() const { return names_; }
+
+  //! Returns the number of dispatches, which weren't sampled because of the profile pool limit
+  uint64_t skipped() const { return skipped_; }
+
+ private:
+  //! The maximum number of samples in flight between the CPU waits
+  static constexpr size_t kMaxProfiles = 64;
+
+  struct Sample {
+    PerfCounterProfile* profile_;  //!< The profile with the counter results
+    std::string kernel_;           //!< Name of the sampled kernel
+  };
+
+  //! Returns a free profile, creates a new one if the pool limit allows it
+  PerfCounterProfile* allocProfile();
+
+  VirtualGPU& gpu_;                                        //!< The queue of the sampled kernels
+  uint32_t gfxVersion_ = PerfCounter::ROC_UNSUPPORTED;     //!< The IP version of the device
+  std::vector<std::string> names_;                         //!< The counters as "block:event"
+  std::vector<hsa_ven_amd_aqlprofile_event_t> events_;     //!< The counter events
+  std::vector<PerfCounterProfile*> profiles_;              //!< All created profiles
+  std::vector<PerfCounterProfile*> free_;                  //!< Profiles without a sample
+  std::vector<Sample> pending_;                            //!< Samples waiting for the results
+  Sample active_ = {nullptr, ""};                          //!< The sample between begin and end
+  uint64_t dispatches_ = 0;                                //!< The number of the dispatches
+  uint64_t skipped_ = 0;                                   //!< Dispatches over the pool limit
+};
+
 }  // namespace amd::roc
 
 #endif  // ROCCOUNTERS_HPP_
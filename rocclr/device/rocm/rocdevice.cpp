@@ -40,6 +40,7 @@
 #include "device/rocm/rocmemory.hpp"
 #include "device/rocm/rocglinterop.hpp"
 #include "device/rocm/rocsignal.hpp"
+#include "device/rocm/rocpincache.hpp"
 #include "platform/sampler.hpp"
 
 #if defined(__clang__)
@@ -49,6 +50,7 @@
 #endif
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <fstream>
 #include <iostream>
@@ -58,6 +60,7 @@
 #include <numaif.h>
 #endif // ROCCLR_SUPPORT_NUMA_POLICY
 #include <sstream>
+#include <thread>
 #include <vector>
 #endif // WITHOUT_HSA_BaCKEND
 
@@ -121,6 +124,7 @@ namespace amd::roc {
 bool roc::Device::isHsaInitialized_ = false;
 std::vector<hsa_agent_t> roc::Device::gpu_agents_;
 std::vector<AgentInfo> roc::Device::cpu_agents_;
+HmmAccessTracker roc::Device::hmm_tracker_;
 
 address Device::mg_sync_ = nullptr;
 
@@ -179,12 +183,14 @@ Device::Device(hsa_agent_t bkendDevice)
     , alloc_granularity_(0)
     , xferQueue_(nullptr)
     , xferRead_(nullptr)
+    , subAllocator_(nullptr)
     , freeMem_(0)
     , vgpusAccess_(true) /* Virtual GPU List Ops Lock */
     , hsa_exclusive_gpu_access_(false)
     , queuePool_(QueuePriority::Total)
     , coopHostcallBuffer_(nullptr)
     , queueWithCUMaskPool_(QueuePriority::Total)
+    , errorMailboxLock_("Error mailbox lock", false)
     , numOfVgpus_(0)
     , preferred_numa_node_(0)
     , maxSdmaReadMask_(0)
@@ -242,6 +248,19 @@ void Device::checkAtomicSupport() {
 }
 
 Device::~Device() {
+  if (doorbellFlushThread_ != nullptr) {
+    {
+      amd::ScopedLock lock(doorbellFlushLock_);
+      doorbellFlushExit_ = true;
+      doorbellFlushLock_.notifyAll();
+    }
+    while ((doorbellFlushThread_->state() != amd::Thread::FINISHED) &&
+           (doorbellFlushThread_->state() != amd::Thread::FAILED)) {
+      amd::Os::yield();
+    }
+    delete doorbellFlushThread_;
+  }
+  PinnedMemoryCache::ReleaseDevice(*this);
   if (coopHostcallBuffer_) {
     amd::disableHostcalls(coopHostcallBuffer_);
     context().svmFree(coopHostcallBuffer_);
@@ -260,6 +279,14 @@ Device::~Device() {
     p2p_stage_->release();
     p2p_stage_ = nullptr;
   }
+  if (nullptr != p2pRelay_) {
+    memFree(p2pRelay_, kP2PRelaySize);
+    p2pRelay_ = nullptr;
+  }
+  if (nullptr != gridBarrier_) {
+    memFree(gridBarrier_, gridBarrierSize_);
+    gridBarrier_ = nullptr;
+  }
   if (nullptr != mg_sync_) {
     GlbCtx().svmFree(mg_sync_);
     mg_sync_ = nullptr;
@@ -282,14 +309,23 @@ Device::~Device() {
       ClPrint(amd::LOG_INFO, amd::LOG_QUEUE, "Deleting hardware queue %p with refCount 0",
               queue->base_address);
       qIter = it.erase(qIter);
+      destroyErrorMailbox(queue);
       hsa_queue_destroy(queue);
     }
   }
   queuePool_.clear();
 
+  // The transfer queue outlives the buffers, hence take back its cached buffer
+  if ((xferQueue_ != nullptr) && (xferQueue_->xferBuffer() != nullptr)) {
+    xferRead_->release(*xferQueue_->xferBuffer());
+    xferQueue_->setXferBuffer(nullptr);
+  }
   // Destroy temporary buffers for read/write
   delete xferRead_;
 
+  // Release the chunks of small device allocations
+  delete subAllocator_;
+
   // Destroy transfer queue
   delete xferQueue_;
 
@@ -417,8 +453,14 @@ bool Device::XferBuffers::create() {
   return result;
 }
 
-Memory& Device::XferBuffers::acquire() {
-  Memory* xferBuf = nullptr;
+Memory& Device::XferBuffers::acquire(VirtualGPU& gpu) {
+  Memory* xferBuf = gpu.xferBuffer();
+  if (xferBuf != nullptr) {
+    // The queue serializes its copies, hence the cached buffer doesn't need the lock.
+    // The cached buffer stays in acquiredCnt_ until the queue returns it to the pool
+    gpu.setXferBuffer(nullptr);
+    return *xferBuf;
+  }
   size_t listSize;
 
   // Lock the operations with the staged buffer list
@@ -453,12 +495,107 @@ void Device::XferBuffers::release(VirtualGPU& gpu, Memory& buffer) {
   // Make sure buffer isn't busy on the current VirtualGPU, because
   // the next aquire can come from different queue
   //    buffer.wait(gpu);
+  if (gpu.xferBuffer() == nullptr) {
+    // Keep the buffer in the queue for its next staged copy
+    gpu.setXferBuffer(&buffer);
+    return;
+  }
+  release(buffer);
+}
+
+void Device::XferBuffers::release(Memory& buffer) {
   // Lock the operations with the staged buffer list
   amd::ScopedLock l(lock_);
   freeBuffers_.push_back(&buffer);
   --acquiredCnt_;
 }
 
+// ================================================================================================
+Device::MemorySubAllocator::MemorySubAllocator(const Device& device, size_t maxAllocSize)
+    : maxAllocSize_(amd::nextPowerOfTwo(std::max(maxAllocSize, MinBlockSize))),
+      lock_(true), gpuDevice_(device) {
+  // Keep at least 16 blocks of the largest size class in a single chunk
+  chunkSize_ = std::max(2 * Mi, 16 * maxAllocSize_);
+  available_.resize(amd::log2(maxAllocSize_) + 1);
+}
+
+// ================================================================================================
+Device::MemorySubAllocator::~MemorySubAllocator() {
+  for (const auto& it : chunks_) {
+    if (it.second.usedBlocks_ != 0) {
+      ClPrint(amd::LOG_INFO, amd::LOG_MEM, "Releasing chunk %p with %d allocated blocks",
+              it.first, it.second.usedBlocks_);
+    }
+    gpuDevice_.memFree(it.first, chunkSize_);
+  }
+  chunks_.clear();
+}
+
+// ================================================================================================
+void* Device::MemorySubAllocator::Allocate(size_t size) {
+  const uint32_t sizeClass = amd::log2(amd::nextPowerOfTwo(std::max(size, MinBlockSize)));
+  amd::ScopedLock l(lock_);
+  auto& available = available_[sizeClass];
+
+  if (available.empty()) {
+    address base = reinterpret_cast<address>(gpuDevice_.deviceLocalAlloc(chunkSize_));
+    if (base == nullptr) {
+      return nullptr;
+    }
+    Chunk& chunk = chunks_[base];
+    chunk.sizeClass_ = sizeClass;
+    chunk.usedBlocks_ = 0;
+    // Hand out the blocks in address order
+    for (uint32_t i = static_cast<uint32_t>(chunkSize_ >> sizeClass); i > 0; --i) {
+      chunk.freeBlocks_.push_back(i - 1);
+    }
+    available.insert(base);
+    ClPrint(amd::LOG_DEBUG, amd::LOG_MEM, "Created chunk %p, block size 0x%zx", base,
+            static_cast<size_t>(1) << sizeClass);
+  }
+
+  address base = *available.begin();
+  Chunk& chunk = chunks_[base];
+  uint32_t index = chunk.freeBlocks_.back();
+  chunk.freeBlocks_.pop_back();
+  ++chunk.usedBlocks_;
+  if (chunk.freeBlocks_.empty()) {
+    available.erase(base);
+  }
+  return base + (static_cast<size_t>(index) << sizeClass);
+}
+
+// ================================================================================================
+bool Device::MemorySubAllocator::Free(void* ptr) {
+  address block = reinterpret_cast<address>(ptr);
+  amd::ScopedLock l(lock_);
+
+  auto it = chunks_.upper_bound(block);
+  if (it == chunks_.begin()) {
+    return false;
+  }
+  --it;
+  if (block >= (it->first + chunkSize_)) {
+    return false;
+  }
+
+  Chunk& chunk = it->second;
+  assert(amd::isMultipleOf(block - it->first, static_cast<size_t>(1) << chunk.sizeClass_) &&
+         "Invalid suballocated block!");
+  chunk.freeBlocks_.push_back(static_cast<uint32_t>((block - it->first) >> chunk.sizeClass_));
+  --chunk.usedBlocks_;
+
+  auto& available = available_[chunk.sizeClass_];
+  available.insert(it->first);
+  // Release empty chunks, but keep the last one of the size class to avoid thrashing
+  if ((chunk.usedBlocks_ == 0) && (available.size() > 1)) {
+    available.erase(it->first);
+    gpuDevice_.memFree(it->first, chunkSize_);
+    chunks_.erase(it);
+  }
+  return true;
+}
+
 // ================================================================================================
 bool Device::init() {
   ClPrint(amd::LOG_INFO, amd::LOG_INIT, "Initializing HSA stack.");
@@ -549,16 +686,18 @@ bool Device::init() {
 
   LogPrintfInfo("Enumerated GPU agents = %lu", gpu_agents_.size());
 
-  for (auto agent : gpu_agents_) {
+  std::vector<std::unique_ptr<Device>> roc_devices(gpu_agents_.size());
+  auto createDevice = [&roc_devices](size_t idx) {
+    hsa_agent_t agent = gpu_agents_[idx];
     std::unique_ptr<Device> roc_device(new Device(agent));
     if (!roc_device) {
       LogError("Error creating new instance of Device on then heap.");
-      continue;
+      return;
     }
 
     if (!roc_device->create()) {
       LogError("Error creating new instance of Device.");
-      continue;
+      return;
     }
 
     // Setup System Memory to be Non-Coherent per user
@@ -568,7 +707,7 @@ bool Device::init() {
       hsa_status_t err = hsa_amd_coherency_set_type(agent, HSA_AMD_COHERENCY_TYPE_NONCOHERENT);
       if (err != HSA_STATUS_SUCCESS) {
         LogError("Unable to set NC memory policy!");
-        continue;
+        return;
       }
     }
 
@@ -576,8 +715,45 @@ bool Device::init() {
     if (amd::IS_HIP && ROC_GLOBAL_CU_MASK[0] != '\0') {
       roc_device->getGlobalCUMask(ROC_GLOBAL_CU_MASK);
     }
+    roc_devices[idx] = std::move(roc_device);
+  };
 
-    roc_device.release()->registerDevice();
+  // The devices don't share state during the creation, hence bring them up concurrently.
+  // Blit programs and HW queues are created on the first use of a device.
+  if (ROC_PARALLEL_DEVICE_INIT && (gpu_agents_.size() > 1)) {
+    std::vector<std::thread> workers;
+    workers.reserve(gpu_agents_.size() - 1);
+    for (size_t idx = 1; idx < gpu_agents_.size(); ++idx) {
+      workers.emplace_back([&createDevice, idx]() {
+        // The worker must have a runtime thread for the locks in the device creation
+        amd::Thread* thread = amd::Thread::current();
+        const bool hostThread = (thread == nullptr);
+        if (hostThread && (((thread = new amd::HostThread()) == nullptr) ||
+                           (thread != amd::Thread::current()))) {
+          LogError("Unable to create a thread for the device creation");
+          return;
+        }
+        createDevice(idx);
+        if (hostThread) {
+          delete thread;
+        }
+      });
+    }
+    createDevice(0);
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  } else {
+    for (size_t idx = 0; idx < gpu_agents_.size(); ++idx) {
+      createDevice(idx);
+    }
+  }
+
+  // Register in the enumeration order, so device indices don't depend on the creation timing
+  for (auto& roc_device : roc_devices) {
+    if (roc_device) {
+      roc_device.release()->registerDevice();
+    }
   }
 
   // Query active devices only
@@ -637,6 +813,7 @@ bool Device::init() {
 extern const char* SchedulerSourceCode;
 
 void Device::tearDown() {
+  PinnedMemoryCache::TearDown();
   NullDevice::tearDown();
   hsa_shut_down();
 }
@@ -831,6 +1008,14 @@ bool Device::create() {
     }
   }
 
+  if (ROC_MAX_SUBALLOC_SIZE != 0) {
+    subAllocator_ = new MemorySubAllocator(*this, ROC_MAX_SUBALLOC_SIZE * Ki);
+    if (subAllocator_ == nullptr) {
+      LogError("Couldn't create the device memory suballocator");
+      return false;
+    }
+  }
+
   // Create signal for HMM prefetch operation on device
   if (HSA_STATUS_SUCCESS != hsa_signal_create(kInitSignalValueOne, 0, nullptr, &prefetch_signal_)) {
     return false;
@@ -1907,6 +2092,7 @@ device::VirtualDevice* Device::createVirtualDevice(amd::CommandQueue* queue) {
                                             q ? queue->priority()
                                               : amd::CommandQueue::Priority::Normal);
 
+  virtualDevice->SetWaitPolicy(q ? queue->waitPolicy() : amd::CommandQueue::WaitPolicy::Default);
   if (!virtualDevice->create()) {
     delete virtualDevice;
     return nullptr;
@@ -2089,7 +2275,7 @@ device::Memory* Device::createMemory(amd::Memory& owner) const {
     return nullptr;
   }
 
-  if (isP2pEnabled()) {
+  if (isP2pEnabled() && !ROC_P2P_LAZY_ACCESS) {
     memory->setAllowedPeerAccess(true);
   }
   // Initialize if the memory is a pipe object
@@ -2319,6 +2505,92 @@ bool Device::allowPeerAccess(device::Memory* memory) const {
   return true;
 }
 
+// ================================================================================================
+bool Device::isXgmiPeer(const Device& other) {
+  std::vector<LinkAttrType> link_attrs = {{kLinkLinkType, 0}, {kLinkHopCount, 0}};
+  if (!findLinkInfo(other, &link_attrs)) {
+    return false;
+  }
+  return (link_attrs[0].second == HSA_AMD_LINK_INFO_TYPE_XGMI) && (link_attrs[1].second == 1);
+}
+
+// ================================================================================================
+Device* Device::P2PRelayDevice(const Device& dst) {
+  amd::ScopedLock lock(p2pRoutesOps_);
+  auto it = p2pRelays_.find(&dst);
+  if (it != p2pRelays_.end()) {
+    return it->second;
+  }
+
+  Device* relay = nullptr;
+  // A direct xGMI link is always the fastest route, otherwise look for a GPU,
+  // which can forward the data over xGMI on both sides instead of PCIe
+  if ((&dst != this) && !isXgmiPeer(dst)) {
+    for (auto dev : getDevices(CL_DEVICE_TYPE_GPU, false)) {
+      Device* candidate = static_cast<Device*>(dev);
+      if ((candidate != this) && (candidate != &dst) &&
+          isXgmiPeer(*candidate) && candidate->isXgmiPeer(dst)) {
+        relay = candidate;
+        ClPrint(amd::LOG_INFO, amd::LOG_COPY,
+                "P2P copies from agent 0x%lx to 0x%lx relay through 0x%lx",
+                getBackendDevice().handle, dst.getBackendDevice().handle,
+                relay->getBackendDevice().handle);
+        break;
+      }
+    }
+  }
+  p2pRelays_[&dst] = relay;
+  return relay;
+}
+
+// ================================================================================================
+address Device::P2PRelayBuffer() {
+  // The caller must hold P2PRelayOps(), which serializes the relay buffer use
+  if (p2pRelay_ == nullptr) {
+    void* ptr = deviceLocalAlloc(kP2PRelaySize);
+    if (ptr == nullptr) {
+      return nullptr;
+    }
+    // Both peers access the relay buffer with their own copy engines
+    if (!deviceAllowAccess(ptr)) {
+      memFree(ptr, kP2PRelaySize);
+      return nullptr;
+    }
+    p2pRelay_ = reinterpret_cast<address>(ptr);
+  }
+  return p2pRelay_;
+}
+
+// ================================================================================================
+uint32_t* Device::GridBarrier(uint32_t numWorkgroups) {
+  // The caller must hold the cooperative queue lock. The launches on that queue are serialized,
+  // hence a single barrier serves all of them. The line 0 keeps the generation, the line 1 is
+  // the root counter and the leaf counters follow. Every barrier leaves the counters at 0,
+  // so the memory is cleared only once
+  const uint32_t maxWorkgroups = info().maxComputeUnits_ * kGridBarrierWgPerCu;
+  if (numWorkgroups > maxWorkgroups) {
+    return nullptr;
+  }
+  if (gridBarrier_ == nullptr) {
+    const uint32_t leaves = amd::alignUp(maxWorkgroups, kGridBarrierFanIn) / kGridBarrierFanIn;
+    const size_t size = (2 + leaves) * kGridBarrierLine * sizeof(uint32_t);
+    void* ptr = deviceLocalAlloc(size);
+    if (ptr == nullptr) {
+      LogError("Grid barrier allocation failed!");
+      return nullptr;
+    }
+    std::vector<uint32_t> zeros(size / sizeof(uint32_t), 0);
+    if (hsa_memory_copy(ptr, zeros.data(), size) != HSA_STATUS_SUCCESS) {
+      LogError("Grid barrier initialization failed!");
+      memFree(ptr, size);
+      return nullptr;
+    }
+    gridBarrier_ = reinterpret_cast<uint32_t*>(ptr);
+    gridBarrierSize_ = size;
+  }
+  return gridBarrier_;
+}
+
 uint64_t Device::deviceVmemAlloc(size_t size, uint64_t flags) const {
   hsa_amd_vmem_alloc_handle_t hsa_vmem_handle {};
 
@@ -2369,7 +2641,8 @@ void* Device::deviceLocalAlloc(size_t size, bool atomics, bool pseudo_fine_grain
     return nullptr;
   }
 
-  if (isP2pEnabled() && deviceAllowAccess(ptr) == false) {
+  // Lazy peer access grants the access on the first use of the memory object from a peer
+  if (isP2pEnabled() && !ROC_P2P_LAZY_ACCESS && deviceAllowAccess(ptr) == false) {
     LogError("Allow p2p access for memory allocation");
     memFree(ptr, size);
     return nullptr;
@@ -2503,6 +2776,25 @@ bool Device::SetMemAccess(void* va_addr, size_t va_size, VmmAccess access_flags)
   return true;
 }
 
+// ================================================================================================
+bool Device::SetMemAccessBatch(void* va_addr, size_t va_size,
+                               const std::vector<std::pair<amd::Device*, VmmAccess>>& access) {
+  // All agents go into one call, hence ROCr updates the page tables of the range once
+  std::vector<hsa_amd_memory_access_desc_t> desc(access.size());
+  for (size_t i = 0; i < access.size(); ++i) {
+    desc[i].permissions = static_cast<hsa_access_permission_t>(access[i].second);
+    desc[i].agent_handle = static_cast<const Device*>(access[i].first)->getBackendDevice();
+  }
+
+  hsa_status_t hsa_status = hsa_amd_vmem_set_access(va_addr, va_size, desc.data(), desc.size());
+  if (hsa_status != HSA_STATUS_SUCCESS) {
+    LogPrintfError("Failed hsa_amd_vmem_set_access. Failed with status:%d \n", hsa_status);
+    return false;
+  }
+
+  return true;
+}
+
 bool Device::GetMemAccess(void* va_addr, VmmAccess* access_flags_ptr) const {
   hsa_status_t hsa_status = HSA_STATUS_SUCCESS;
   hsa_access_permission_t perms;
@@ -2867,6 +3159,44 @@ bool Device::GetSvmAttributes(void** data, size_t* data_sizes, int* attributes,
   return true;
 }
 
+// ================================================================================================
+HmmAccessTracker::Action HmmAccessTracker::record(const amd::Memory* mem, uint32_t device,
+                                                  bool readOnly, uint32_t threshold) {
+  amd::ScopedLock lock(lock_);
+  Stats& stats = stats_[mem];
+  stats.streak_ = (stats.last_ == device) ? (stats.streak_ + 1) : 1;
+  stats.last_ = device;
+  stats.devices_ |= 1ULL << (device % 64);
+  stats.written_ |= !readOnly;
+
+  if (stats.readMostly_) {
+    if (stats.written_) {
+      // A write invalidates all copies, hence fall back to the migration
+      stats.readMostly_ = false;
+      stats.location_ = ~0u;
+      return Action::UnsetReadMostly;
+    }
+    return Action::Keep;
+  }
+  // Read only data, used by many devices, is duplicated instead of the migration back and forth
+  if (!stats.written_ && (amd::countBitsSet(stats.devices_) > 1)) {
+    stats.readMostly_ = true;
+    return Action::SetReadMostly;
+  }
+  // Move the allocation, once a device keeps accessing it, instead of faulting page by page
+  if ((stats.location_ != device) && (stats.streak_ >= threshold)) {
+    stats.location_ = device;
+    return Action::Migrate;
+  }
+  return Action::Keep;
+}
+
+// ================================================================================================
+void HmmAccessTracker::remove(const amd::Memory* mem) {
+  amd::ScopedLock lock(lock_);
+  stats_.erase(mem);
+}
+
 // ================================================================================================
 bool Device::SvmAllocInit(void* memory, size_t size) const {
   amd::MemoryAdvice advice = amd::MemoryAdvice::SetAccessedBy;
@@ -2948,8 +3278,15 @@ bool Device::IsHwEventReadyForcedWait(const amd::Event& event) const {
 
 // ================================================================================================
 bool Device::IsHwEventReady(const amd::Event& event, bool wait, uint32_t hip_event_flags) const {
-  void* hw_event =
-      (event.NotifyEvent() != nullptr) ? event.NotifyEvent()->HwEvent() : event.HwEvent();
+  const amd::Event& hw_owner = (event.NotifyEvent() != nullptr) ? *event.NotifyEvent() : event;
+  void* hw_event = hw_owner.HwEvent();
+  amd::HostQueue* queue = hw_owner.command().queue();
+  if ((hw_event != nullptr) && (ROC_DOORBELL_COALESCE_PACKETS > 1) && (queue != nullptr) &&
+      (queue->vdev() != nullptr)) {
+    // The query or wait can't succeed until the coalesced doorbell is rung
+    amd::ScopedLock lock(queue->vdev()->execution());
+    queue->vdev()->RingDeferredDoorbell();
+  }
   if (hw_event == nullptr) {
     ClPrint(amd::LOG_INFO, amd::LOG_SIG, "No HW event");
     return false;
@@ -2999,6 +3336,8 @@ static void callbackQueue(hsa_status_t status, hsa_queue_t* queue, void* data) {
         "Callback: Queue %p aborting with error : %s code: 0x%x", queue->base_address,
         errorMsg, status);
     }
+    // Print the device side report of the failure, if the dispatch left one
+    reinterpret_cast<Device*>(data)->ReportQueueError(queue);
     abort();
   }
 }
@@ -3016,7 +3355,28 @@ hsa_queue_t* Device::getQueueFromPool(const uint qIndex) {
       }
     }
   } else {
-    if (qIndex < QueuePriority::Total && queuePool_[qIndex].size() > 0) {
+    if (qIndex < QueuePriority::Total && queuePool_[qIndex].size() > 0 && ROC_QUEUE_LOAD_BALANCE) {
+      // Pick the queue with the lowest load. The load is the number of packets in flight and
+      // the number of dispatches since the last selection. The number of users breaks ties,
+      // so idle queues are still spread evenly.
+      auto lowest = queuePool_[qIndex].end();
+      uint64_t lowestLoad = std::numeric_limits<uint64_t>::max();
+      for (auto it = queuePool_[qIndex].begin(); it != queuePool_[qIndex].end(); ++it) {
+        uint64_t write = hsa_queue_load_write_index_relaxed(it->first);
+        uint64_t read = hsa_queue_load_read_index_relaxed(it->first);
+        uint64_t load = (write - read) + (write - it->second.sampledWriteIndex_);
+        it->second.sampledWriteIndex_ = write;
+        if ((lowest == queuePool_[qIndex].end()) || (load < lowestLoad) ||
+            ((load == lowestLoad) && (it->second.refCount < lowest->second.refCount))) {
+          lowest = it;
+          lowestLoad = load;
+        }
+      }
+      lowest->second.refCount++;
+      ClPrint(amd::LOG_INFO, amd::LOG_QUEUE, "Selected queue refCount: %p (%d), load: %lu",
+              lowest->first->base_address, lowest->second.refCount, lowestLoad);
+      return lowest->first;
+    } else if (qIndex < QueuePriority::Total && queuePool_[qIndex].size() > 0) {
       typedef decltype(queuePool_)::value_type::const_reference PoolRef;
       auto lowest = std::min_element(
           queuePool_[qIndex].begin(), queuePool_[qIndex].end(),
@@ -3030,6 +3390,91 @@ hsa_queue_t* Device::getQueueFromPool(const uint qIndex) {
   return nullptr;
 }
 
+// ================================================================================================
+bool Device::setQueueCUMask(hsa_queue_t* queue, const std::vector<uint32_t>& cuMask) {
+  std::stringstream ss;
+  ss << std::hex;
+  std::vector<uint32_t> mask = {};
+
+  // handle scenarios where cuMask (custom-defined), globalCUMask_ or both are valid and
+  // fill the final mask which will be appiled to the current queue
+  if (cuMask.size() != 0 && info_.globalCUMask_.size() == 0) {
+    mask = cuMask;
+  } else if (cuMask.size() != 0 && info_.globalCUMask_.size() != 0) {
+    for (unsigned int i = 0; i < std::min(cuMask.size(), info_.globalCUMask_.size()); i++) {
+      mask.push_back(cuMask[i] & info_.globalCUMask_[i]);
+    }
+    // check to make sure after ANDing cuMask (custom-defined) with global
+    //CU mask, we have non-zero mask, oterwise just apply global CU mask
+    bool zeroCUMask = true;
+    for (auto m : mask) {
+      if (m != 0) {
+        zeroCUMask = false;
+        break;
+      }
+    }
+    if (zeroCUMask) {
+      mask = info_.globalCUMask_;
+    }
+  } else {
+    mask = info_.globalCUMask_;
+  }
+
+  for (int i = mask.size() - 1; i >= 0; i--) {
+    ss << mask[i];
+  }
+  ClPrint(amd::LOG_INFO, amd::LOG_QUEUE, "Setting CU mask 0x%s for hardware queue %p",
+          ss.str().c_str(), queue->base_address);
+
+  std::vector<uint32_t> final_mask = {};
+  // hsa_amd_queue_cu_set_mask expects each bit in cuMask to represent each CU
+  // For wgp mode: Each wgp consists of 2 CUs and CUs must be adjacent pairwise enabled
+  // Convert each bit in the cuMask from wgp to cu by duplicating it
+  if (settings().enableWgpMode_) {
+    final_mask.resize(mask.size() * 2, 0);
+
+    for (int i = 0; i < mask.size(); i++) {
+      for (int j = 0; j < 16; j++) {
+        // Convert least significant 16 bits
+        if (((mask[i] >> j) & 0x1) == 0x1) {
+          final_mask[2 * i] |= (0x3 << (2 * j));
+        }
+
+        // Convert most significant 16 bits
+        if (((mask[i] >> (16 + j)) & 0x1) == 0x1) {
+          final_mask[2 * i + 1] |= (0x3 << (2 * j));
+        }
+      }
+    }
+  } else {
+    final_mask = mask;
+  }
+
+  hsa_status_t status = hsa_amd_queue_cu_set_mask(queue, final_mask.size() * 32,
+                                                  final_mask.data());
+  if (status != HSA_STATUS_SUCCESS) {
+    DevLogError("Device::setQueueCUMask: hsa_amd_queue_cu_set_mask failed!");
+    return false;
+  }
+  return true;
+}
+
+// ================================================================================================
+std::vector<uint32_t> Device::sharedCUMask() const {
+  std::vector<uint32_t> mask;
+  const uint32_t numCUs = info_.maxComputeUnits_;
+  if ((ROC_HIGH_PRIORITY_RESERVED_CUS == 0) || (ROC_HIGH_PRIORITY_RESERVED_CUS >= numCUs)) {
+    return mask;
+  }
+  // Reserve the last CUs of the mask, since KFD distributes the mask bits over the SEs
+  const uint32_t sharedCUs = numCUs - ROC_HIGH_PRIORITY_RESERVED_CUS;
+  mask.resize((numCUs + 31) / 32, 0);
+  for (uint32_t i = 0; i < sharedCUs; ++i) {
+    mask[i / 32] |= 1u << (i % 32);
+  }
+  return mask;
+}
+
 hsa_queue_t* Device::acquireQueue(uint32_t queue_size_hint, bool coop_queue,
                                   const std::vector<uint32_t>& cuMask,
                                   amd::CommandQueue::Priority priority) {
@@ -3119,71 +3564,21 @@ hsa_queue_t* Device::acquireQueue(uint32_t queue_size_hint, bool coop_queue,
           "size %d with priority %d, cooperative: %i",
           queue, queue->base_address, queue_size, queue_priority, coop_queue);
 
-  hsa_amd_profiling_set_profiler_enabled(queue, 1);
-  if (cuMask.size() != 0 || info_.globalCUMask_.size() != 0) {
-    std::stringstream ss;
-    ss << std::hex;
-    std::vector<uint32_t> mask = {};
-
-    // handle scenarios where cuMask (custom-defined), globalCUMask_ or both are valid and
-    // fill the final mask which will be appiled to the current queue
-    if (cuMask.size() != 0 && info_.globalCUMask_.size() == 0) {
-      mask = cuMask;
-    } else if (cuMask.size() != 0 && info_.globalCUMask_.size() != 0) {
-      for (unsigned int i = 0; i < std::min(cuMask.size(), info_.globalCUMask_.size()); i++) {
-        mask.push_back(cuMask[i] & info_.globalCUMask_[i]);
-      }
-      // check to make sure after ANDing cuMask (custom-defined) with global
-      //CU mask, we have non-zero mask, oterwise just apply global CU mask
-      bool zeroCUMask = true;
-      for (auto m : mask) {
-        if (m != 0) {
-          zeroCUMask = false;
-          break;
-        }
-      }
-      if (zeroCUMask) {
-        mask = info_.globalCUMask_;
-      }
-    } else {
-      mask = info_.globalCUMask_;
-    }
-
-
-    for (int i = mask.size() - 1; i >= 0; i--) {
-      ss << mask[i];
-    }
-    ClPrint(amd::LOG_INFO, amd::LOG_QUEUE, "Setting CU mask 0x%s for hardware queue %p",
-            ss.str().c_str(), queue->base_address);
-
-    std::vector<uint32_t> final_mask = {};
-    // hsa_amd_queue_cu_set_mask expects each bit in cuMask to represent each CU
-    // For wgp mode: Each wgp consists of 2 CUs and CUs must be adjacent pairwise enabled
-    // Convert each bit in the cuMask from wgp to cu by duplicating it
-    if (settings().enableWgpMode_) {
-      final_mask.resize(mask.size() * 2, 0);
-
-      for (int i = 0; i < mask.size(); i++) {
-        for (int j = 0; j < 16; j++) {
-          // Convert least significant 16 bits
-          if (((mask[i] >> j) & 0x1) == 0x1) {
-            final_mask[2 * i] |= (0x3 << (2 * j));
-          }
-
-          // Convert most significant 16 bits
-          if (((mask[i] >> (16 + j)) & 0x1) == 0x1) {
-            final_mask[2 * i + 1] |= (0x3 << (2 * j));
-          }
-        }
-      }
-    } else {
-      final_mask = mask;
-    }
+  if (ROC_DEVICE_ERROR_MAILBOX) {
+    createErrorMailbox(queue);
+  }
 
-    hsa_status_t status = hsa_amd_queue_cu_set_mask(queue,
-                          final_mask.size() * 32, final_mask.data());
-    if (status != HSA_STATUS_SUCCESS) {
-      DevLogError("Device::acquireQueue: hsa_amd_queue_cu_set_mask failed!");
+  hsa_amd_profiling_set_profiler_enabled(queue, 1);
+  // The low and normal priority queues leave the reserved CUs to the high priority queues,
+  // so the high priority waves don't wait for the long kernels. The cooperative queue
+  // keeps all CUs, since the grid size of a cooperative launch is based on all of them
+  std::vector<uint32_t> sharedMask;
+  if (cuMask.empty() && !coop_queue && (qIndex != QueuePriority::High)) {
+    sharedMask = sharedCUMask();
+  }
+  if (cuMask.size() != 0 || info_.globalCUMask_.size() != 0 || sharedMask.size() != 0) {
+    if (!setQueueCUMask(queue, cuMask.empty() ? sharedMask : cuMask)) {
+      destroyErrorMailbox(queue);
       hsa_queue_destroy(queue);
       return nullptr;
     }
@@ -3194,6 +3589,7 @@ hsa_queue_t* Device::acquireQueue(uint32_t queue_size_hint, bool coop_queue,
       assert(result.second && "QueueInfo already exists");
       auto& qInfo = result.first->second;
       qInfo.refCount = 1;
+      qInfo.sampledWriteIndex_ = hsa_queue_load_write_index_relaxed(queue);
 
       return queue;
     }
@@ -3208,6 +3604,8 @@ hsa_queue_t* Device::acquireQueue(uint32_t queue_size_hint, bool coop_queue,
   assert(result.second && "QueueInfo already exists");
   auto &qInfo = result.first->second;
   qInfo.refCount = 1;
+  // The load balancing measures the growth of the write index since the last selection
+  qInfo.sampledWriteIndex_ = hsa_queue_load_write_index_relaxed(queue);
   ClPrint(amd::LOG_INFO, amd::LOG_QUEUE, "acquireQueue refCount: %p (%d)",
           result.first->first->base_address, result.first->second.refCount);
   return queue;
@@ -3236,6 +3634,7 @@ void Device::releaseQueue(hsa_queue_t* queue, const std::vector<uint32_t>& cuMas
         ClPrint(amd::LOG_INFO, amd::LOG_QUEUE, "Deleting hardware queue %p with refCount 0",
                 queue->base_address);
         qIter = it.erase(qIter);
+        destroyErrorMailbox(queue);
         hsa_queue_destroy(queue);
       }
     }
@@ -3243,11 +3642,113 @@ void Device::releaseQueue(hsa_queue_t* queue, const std::vector<uint32_t>& cuMas
   if (coop_queue) { // cooperative queue
       ClPrint(amd::LOG_INFO, amd::LOG_QUEUE, "Deleting CG enabled hardware queue %p ",
                queue->base_address);
+      destroyErrorMailbox(queue);
       hsa_queue_destroy(queue);
   }
 
 }
 
+// ================================================================================================
+void Device::createErrorMailbox(hsa_queue_t* queue) {
+  // Fine grain memory, so the host can read the report while the dispatch is stuck in a trap
+  auto mailbox = reinterpret_cast<ErrorMailbox*>(
+      hostAlloc(sizeof(ErrorMailbox), sizeof(uint64_t), MemorySegment::kAtomics));
+  if (mailbox == nullptr) {
+    // The device library falls back to hostcall for the reports
+    ClPrint(amd::LOG_ERROR, amd::LOG_QUEUE,
+            "Failed to create the error mailbox for hardware queue %p", queue->base_address);
+    return;
+  }
+  memset(mailbox, 0, sizeof(ErrorMailbox));
+  amd::ScopedLock lock(errorMailboxLock_);
+  errorMailboxes_[queue] = mailbox;
+}
+
+// ================================================================================================
+void Device::destroyErrorMailbox(hsa_queue_t* queue) {
+  amd::ScopedLock lock(errorMailboxLock_);
+  auto it = errorMailboxes_.find(queue);
+  if (it != errorMailboxes_.end()) {
+    hostFree(it->second, sizeof(ErrorMailbox));
+    errorMailboxes_.erase(it);
+  }
+}
+
+// ================================================================================================
+ErrorMailbox* Device::QueueErrorMailbox(hsa_queue_t* queue) const {
+  amd::ScopedLock lock(errorMailboxLock_);
+  auto it = errorMailboxes_.find(queue);
+  return (it != errorMailboxes_.end()) ? it->second : nullptr;
+}
+
+// ================================================================================================
+bool Device::ReportQueueError(hsa_queue_t* queue) const {
+  ErrorMailbox* mailbox = QueueErrorMailbox(queue);
+  if ((mailbox == nullptr) || (__atomic_load_n(&mailbox->status_, __ATOMIC_ACQUIRE) == 0)) {
+    return false;
+  }
+  ClPrint(amd::LOG_NONE, amd::LOG_ALWAYS, "Device %s on HWq=%p: kernel object 0x%lx, "
+          "work-group (%u, %u, %u), work-item (%u, %u, %u), file 0x%lx, line %u, "
+          "expression 0x%lx", (mailbox->status_ == 1) ? "assertion" : "abort",
+          queue->base_address, mailbox->kernelObject_, mailbox->workGroup_[0],
+          mailbox->workGroup_[1], mailbox->workGroup_[2], mailbox->workItem_[0],
+          mailbox->workItem_[1], mailbox->workItem_[2], mailbox->file_, mailbox->line_,
+          mailbox->expression_);
+  __atomic_store_n(&mailbox->status_, 0, __ATOMIC_RELEASE);
+  return true;
+}
+
+// ================================================================================================
+void Device::ScheduleDoorbellFlush(VirtualGPU* gpu) {
+  amd::ScopedLock lock(doorbellFlushLock_);
+  if (doorbellFlushThread_ == nullptr) {
+    doorbellFlushThread_ = new DoorbellFlushThread();
+    if ((doorbellFlushThread_ == nullptr) ||
+        (doorbellFlushThread_->state() < amd::Thread::INITIALIZED) ||
+        !doorbellFlushThread_->start(this)) {
+      LogError("Couldn't start the doorbell flush thread!");
+      delete doorbellFlushThread_;
+      doorbellFlushThread_ = nullptr;
+      return;
+    }
+  }
+  doorbellFlushList_.insert(gpu);
+  doorbellFlushLock_.notify();
+}
+
+// ================================================================================================
+void Device::CancelDoorbellFlush(VirtualGPU* gpu) {
+  amd::ScopedLock lock(doorbellFlushLock_);
+  doorbellFlushList_.erase(gpu);
+}
+
+// ================================================================================================
+void Device::flushDoorbells() {
+  doorbellFlushLock_.lock();
+  while (!doorbellFlushExit_) {
+    if (doorbellFlushList_.empty()) {
+      doorbellFlushLock_.wait();
+      continue;
+    }
+    // Give the submissions the coalescing window to ring the doorbells themselves
+    doorbellFlushLock_.unlock();
+    std::this_thread::sleep_for(std::chrono::microseconds(ROC_DOORBELL_COALESCE_US));
+    doorbellFlushLock_.lock();
+    for (auto it = doorbellFlushList_.begin(); it != doorbellFlushList_.end();) {
+      VirtualGPU* gpu = *it;
+      // The lock owner is submitting or waiting on the queue, hence retry on the next tick
+      if (gpu->execution().tryLock()) {
+        gpu->RingDeferredDoorbell();
+        gpu->execution().unlock();
+        it = doorbellFlushList_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  doorbellFlushLock_.unlock();
+}
+
 void* Device::getOrCreateHostcallBuffer(hsa_queue_t* queue, bool coop_queue,
                                         const std::vector<uint32_t>& cuMask) {
   decltype(queuePool_)::value_type::iterator qIter;
@@ -49,6 +49,9 @@
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <map>
+#include <set>
+#include <unordered_map>
 
 /*! \addtogroup HSA
  *  @{
@@ -83,12 +86,14 @@ public:
   HwQueueEngine engine_;  //!< Engine used with this signal
   amd::Monitor  lock_;    //!< Signal lock for update
   bool isPacketDispatch_; //!< True if the packet associated with the signal is dispatch
+  const Device* dev_;     //!< Device, which queue signals this
 
   typedef union {
     struct {
       uint32_t          done_            :  1; //!< True if signal is done
       uint32_t          forceHostWait_   :  1; //!< Force Host Wait for dependency signals
-      uint32_t          reserved_        : 30;
+      uint32_t          interrupt_       :  1; //!< The signal can wake up a host waiter
+      uint32_t          reserved_        : 29;
     };
     uint32_t data_;
   } Flags;
@@ -100,10 +105,12 @@ public:
     , engine_(HwQueueEngine::Compute)
     , lock_(true) /* Signal Ops Lock */
     , isPacketDispatch_(false)
+    , dev_(nullptr)
     {
       signal_.handle = 0;
       flags_.done_ = true;
       flags_.forceHostWait_ = true;
+      flags_.interrupt_ = true;
     }
 
   virtual ~ProfilingSignal();
@@ -255,13 +262,16 @@ class NullDevice : public amd::Device {
     return (memory->getContext().devices().size() > 1);
   }
 
+  //! ROCr can't import the semaphores of other APIs as HSA signals, hence the import fails
+  //! and the caller reports the semaphore as not supported
   virtual bool importExtSemaphore(void** extSemahore, const amd::Os::FileDesc& handle,
                                   amd::ExternalSemaphoreHandleType sem_handle_type) override {
-    ShouldNotReachHere();
+    LogPrintfError("External semaphore type %d isn't supported", sem_handle_type);
     return false;
   }
 
-  void DestroyExtSemaphore(void* extSemaphore) override { ShouldNotReachHere(); }
+  //! No semaphore can be imported, hence there is nothing to destroy
+  void DestroyExtSemaphore(void* extSemaphore) override {}
 
   //! Acquire external graphics API object in the host thread
   //! Needed for OpenGL objects on CPU device
@@ -328,6 +338,51 @@ struct AgentInfo {
   hsa_amd_memory_pool_t ext_fine_grain_pool_;
 };
 
+//! The assert and abort report of a HW queue. The device library fills the fields and sets
+//! status_ last with a system scope release, then traps or completes the dispatch
+struct ErrorMailbox {
+  uint32_t status_;        //!< 0 if empty, 1 for an assert, 2 for an abort
+  uint32_t line_;          //!< Source line of the failed assertion
+  uint64_t file_;          //!< Id of the source file name
+  uint64_t expression_;    //!< Id of the failed expression
+  uint64_t kernelObject_;  //!< Kernel object of the reporting dispatch
+  uint32_t workGroup_[3];  //!< Work-group of the reporting work-item
+  uint32_t workItem_[3];   //!< Local id of the reporting work-item
+};
+
+//! Kernel access statistics of the managed allocations for the automatic migration policy.
+//! A single tracker is shared by all devices, since the placement is a property of the memory
+class HmmAccessTracker {
+ public:
+  enum class Action : uint32_t {
+    Keep = 0,          //!< Keep the current placement
+    Migrate,           //!< Prefetch the allocation to the accessing device
+    SetReadMostly,     //!< Duplicate the read only allocation on all accessing devices
+    UnsetReadMostly    //!< The allocation is written, hence the duplication must stop
+  };
+
+  HmmAccessTracker() : lock_("HMM access tracker", true) {}
+
+  //! Records a kernel access of the managed memory and returns the placement update
+  Action record(const amd::Memory* mem, uint32_t device, bool readOnly, uint32_t threshold);
+
+  //! Drops the statistics of the destroyed memory
+  void remove(const amd::Memory* mem);
+
+ private:
+  struct Stats {
+    uint32_t location_ = ~0u;  //!< The device of the last migration, ~0 if not migrated
+    uint32_t last_ = ~0u;      //!< The last accessing device
+    uint32_t streak_ = 0;      //!< The number of the consecutive accesses from last_
+    uint64_t devices_ = 0;     //!< The mask of the accessing devices
+    bool written_ = false;     //!< A kernel without the const qualifier accessed the memory
+    bool readMostly_ = false;  //!< The runtime set the read mostly attribute
+  };
+
+  amd::Monitor lock_;                                     //!< Guards the statistics
+  std::unordered_map<const amd::Memory*, Stats> stats_;  //!< Statistics of every allocation
+};
+
 //! A HSA device ordinal (physical HSA device)
 class Device : public NullDevice {
  public:
@@ -346,14 +401,19 @@ class Device : public NullDevice {
     //! Creates the xfer buffers object
     bool create();
 
-    //! Acquires an instance of the transfer buffers
-    Memory& acquire();
+    //! Acquires an instance of the transfer buffers. The buffer, cached in the queue,
+    //! is taken first, hence the concurrent staged copies don't wait for the pool lock
+    Memory& acquire(VirtualGPU& gpu  //!< Virual GPU object, which will use the buffer
+                    );
 
     //! Releases transfer buffer
     void release(VirtualGPU& gpu,  //!< Virual GPU object used with the buffer
                  Memory& buffer    //!< Transfer buffer for release
                  );
 
+    //! Returns the transfer buffer into the shared pool
+    void release(Memory& buffer);
+
     //! Returns the buffer's size for transfer
     size_t bufSize() const { return bufSize_; }
 
@@ -374,6 +434,47 @@ class Device : public NullDevice {
     const Device& gpuDevice_;         //!< GPU device object
   };
 
+  //! Suballocator of small device local allocations out of larger chunks
+  class MemorySubAllocator : public amd::HeapObject {
+   public:
+    static constexpr size_t MinBlockSize = 256;  //!< The minimum block size and alignment
+
+    //! Default constructor
+    MemorySubAllocator(const Device& device, size_t maxAllocSize);
+
+    //! Default destructor
+    ~MemorySubAllocator();
+
+    //! Returns true if the allocation size is handled by the suballocator
+    bool IsSubAllocSize(size_t size) const { return (size != 0) && (size <= maxAllocSize_); }
+
+    //! Allocates a block, aligned to its power of two size, from a chunk
+    void* Allocate(size_t size);
+
+    //! Returns the block to its chunk. false if the pointer wasn't suballocated
+    bool Free(void* ptr);
+
+   private:
+    //! Disable copy constructor
+    MemorySubAllocator(const MemorySubAllocator&);
+
+    //! Disable assignment operator
+    MemorySubAllocator& operator=(const MemorySubAllocator&);
+
+    struct Chunk {
+      uint32_t sizeClass_;               //!< Log2 of the block size
+      uint32_t usedBlocks_;              //!< The number of allocated blocks
+      std::vector<uint32_t> freeBlocks_; //!< The indices of free blocks
+    };
+
+    size_t maxAllocSize_;                       //!< The largest suballocated size
+    size_t chunkSize_;                          //!< The size of a single chunk
+    std::map<address, Chunk> chunks_;           //!< All chunks, keyed by base address
+    std::vector<std::set<address>> available_;  //!< Chunks with free blocks per size class
+    amd::Monitor lock_;                         //!< Suballocator lock
+    const Device& gpuDevice_;                   //!< GPU device object
+  };
+
   //! Initialise the whole HSA device subsystem (CAL init, device enumeration, etc).
   static bool init();
   static void tearDown();
@@ -483,6 +584,8 @@ class Device : public NullDevice {
   virtual bool virtualFree(void* addr);
 
   virtual bool SetMemAccess(void* va_addr, size_t va_size, VmmAccess access_flags);
+  virtual bool SetMemAccessBatch(void* va_addr, size_t va_size,
+                                 const std::vector<std::pair<amd::Device*, VmmAccess>>& access);
   virtual bool GetMemAccess(void* va_addr, VmmAccess* access_flags_ptr) const;
   virtual bool ValidateMemAccess(amd::Memory& mem, bool read_write) const { return true; }
 
@@ -523,6 +626,9 @@ class Device : public NullDevice {
   //! Returns transfer buffer object
   XferBuffers& xferRead() const { return *xferRead_; }
 
+  //! Returns the suballocator for small device allocations, nullptr if disabled
+  MemorySubAllocator* subAllocator() const { return subAllocator_; }
+
   //! Returns a ROC memory object from AMD memory object
   roc::Memory* getRocMemory(amd::Memory* mem  //!< Pointer to AMD memory object
                             ) const;
@@ -536,6 +642,26 @@ class Device : public NullDevice {
   //! Returns the list of HSA agents used for IPC memory attach
   const hsa_agent_t* IpcAgents() const { return p2p_agents_list_; }
 
+  //! Size of the device memory a GPU uses to relay peer copies between two other GPUs
+  static constexpr size_t kP2PRelaySize = 8 * Mi;
+
+  //! Returns a GPU with single hop xGMI links to this device and dst, if they aren't linked
+  Device* P2PRelayDevice(const Device& dst);
+
+  //! Returns the lock object, which serializes peer copies relayed through this device
+  amd::Monitor& P2PRelayOps() const { return p2pRelayOps_; }
+
+  //! Returns the relay buffer in this device memory, allocated on the first use
+  address P2PRelayBuffer();
+
+  //! Counters of the hierarchical grid barrier, the layout matches the device headers
+  static constexpr uint32_t kGridBarrierLine = 32;    //!< Dwords in a counter line (128 bytes)
+  static constexpr uint32_t kGridBarrierFanIn = 16;   //!< Workgroups, which share a leaf counter
+  static constexpr uint32_t kGridBarrierWgPerCu = 64; //!< Max resident workgroups per CU
+
+  //! Returns the hierarchical grid barrier for the launch, nullptr if it doesn't fit
+  uint32_t* GridBarrier(uint32_t numWorkgroups);
+
   // User enabled peer devices
   const bool isP2pEnabled() const { return (enabled_p2p_devices_.size() > 0) ? true : false; }
 
@@ -565,9 +691,30 @@ class Device : public NullDevice {
                             const std::vector<uint32_t>& cuMask = {},
                             amd::CommandQueue::Priority priority = amd::CommandQueue::Priority::Normal);
 
+  //! Applies the CU mask, combined with ROC_GLOBAL_CU_MASK, to the HSA queue.
+  //! The new mask affects only the packets, which CP dispatches after the call
+  bool setQueueCUMask(hsa_queue_t* queue, const std::vector<uint32_t>& cuMask);
+
+  //! Returns the CU mask of the low and normal priority queues, which excludes the CUs,
+  //! reserved with ROC_HIGH_PRIORITY_RESERVED_CUS. Empty if no CUs are reserved
+  std::vector<uint32_t> sharedCUMask() const;
+
   //! Release HSA queue
   void releaseQueue(hsa_queue_t*, const std::vector<uint32_t>& cuMask = {}, bool coop_queue = false);
 
+  //! Returns the error mailbox of the HSA queue, allocated with the queue
+  ErrorMailbox* QueueErrorMailbox(hsa_queue_t* queue) const;
+
+  //! Prints and clears the report in the error mailbox of the queue. Returns true if it was set
+  bool ReportQueueError(hsa_queue_t* queue) const;
+
+  //! Rings the coalesced doorbell of the queue in the flush thread, if no submission or wait
+  //! rings it within ROC_DOORBELL_COALESCE_US. Must be called under the execution lock
+  void ScheduleDoorbellFlush(VirtualGPU* gpu);
+
+  //! Removes the queue from the doorbell flush list before the queue is destroyed
+  void CancelDoorbellFlush(VirtualGPU* gpu);
+
   //! For the given HSA queue, return an existing hostcall buffer or create a
   //! new one. queuePool_ keeps a mapping from HSA queue to hostcall buffer.
   void* getOrCreateHostcallBuffer(hsa_queue_t* queue, bool coop_queue = false,
@@ -587,6 +734,9 @@ class Device : public NullDevice {
   //! Initialize memory in AMD HMM on the current device or keeps it in the host memory
   bool SvmAllocInit(void* memory, size_t size) const;
 
+  //! Returns the access tracker of the automatic HMM migration policy
+  static HmmAccessTracker& hmmTracker() { return hmm_tracker_; }
+
   void getGlobalCUMask(std::string cuMaskStr);
 
   virtual amd::Memory* GetArenaMemObj(const void* ptr, size_t& offset, size_t size = 0);
@@ -625,6 +775,7 @@ class Device : public NullDevice {
   static bool isHsaInitialized_;
   static std::vector<hsa_agent_t> gpu_agents_;
   static std::vector<AgentInfo> cpu_agents_;
+  static HmmAccessTracker hmm_tracker_;  //!< Access statistics of the managed memory
 
   hsa_agent_t cpu_agent_;
   uint32_t preferred_numa_node_;
@@ -650,14 +801,26 @@ class Device : public NullDevice {
   VirtualGPU* xferQueue_;  //!< Transfer queue, created on demand
 
   XferBuffers* xferRead_;   //!< Transfer buffers read
+  MemorySubAllocator* subAllocator_;  //!< Suballocator for small device allocations
   std::atomic<size_t> freeMem_;   //!< Total of free memory available
   mutable amd::Monitor vgpusAccess_;     //!< Lock to serialise virtual gpu list access
   bool hsa_exclusive_gpu_access_;  //!< TRUE if current device was moved into exclusive GPU access mode
   static address mg_sync_;  //!< MGPU grid launch sync memory (SVM location)
 
+  //! Returns TRUE if this device reaches other device memory over a single xGMI hop
+  bool isXgmiPeer(const Device& other);
+
+  std::map<const Device*, Device*> p2pRelays_;  //!< Relay GPU for every peer, nullptr if none
+  amd::Monitor p2pRoutesOps_;                   //!< Lock to serialise the relay cache
+  mutable amd::Monitor p2pRelayOps_;            //!< Lock to serialise the relay buffer use
+  address p2pRelay_ = nullptr;                  //!< Relay buffer in this device memory
+  uint32_t* gridBarrier_ = nullptr;             //!< Counters of the hierarchical grid barrier
+  size_t gridBarrierSize_ = 0;                  //!< Size of the grid barrier in bytes
+
   struct QueueInfo {
     int refCount;
     void* hostcallBuffer_;
+    uint64_t sampledWriteIndex_;  //!< Write index observed at the last queue selection
   };
 
   //! a vector for keeping Pool of HSA queues with low, normal and high priorities for recycling
@@ -674,6 +837,32 @@ class Device : public NullDevice {
   //! Pool of HSA queues with custom CU masks
   std::vector<std::map<hsa_queue_t*, QueueInfo>> queueWithCUMaskPool_;
 
+  //! The assert and abort reports of the device for every HSA queue
+  std::map<hsa_queue_t*, ErrorMailbox*> errorMailboxes_;
+  mutable amd::Monitor errorMailboxLock_;  //!< Guards errorMailboxes_ for the queue callbacks
+
+  //! Allocates the error mailbox of a new HSA queue
+  void createErrorMailbox(hsa_queue_t* queue);
+  //! Frees the error mailbox of a destroyed HSA queue
+  void destroyErrorMailbox(hsa_queue_t* queue);
+
+  //! The thread, which exposes the coalesced packets of the idle direct dispatch queues
+  class DoorbellFlushThread : public amd::Thread {
+   public:
+    DoorbellFlushThread() : amd::Thread("Doorbell Flush Thread", CQ_THREAD_STACK_SIZE) {}
+
+    //! The flush thread entry point
+    void run(void* data) { reinterpret_cast<Device*>(data)->flushDoorbells(); }
+  };
+
+  //! The doorbell flush thread loop
+  void flushDoorbells();
+
+  amd::Monitor doorbellFlushLock_;        //!< Guards the flush list and the thread state
+  std::set<VirtualGPU*> doorbellFlushList_;  //!< Queues with deferred doorbells
+  DoorbellFlushThread* doorbellFlushThread_ = nullptr;  //!< Created on the first deferral
+  bool doorbellFlushExit_ = false;        //!< The flush thread must exit
+
   //! Read and Write mask for device<->host
   uint32_t maxSdmaReadMask_;
   uint32_t maxSdmaWriteMask_;
@@ -658,6 +658,7 @@ void Buffer::destroy() {
       if (isFineGrain) {
         if (memFlags & CL_MEM_ALLOC_HOST_PTR) {
           if (dev().info().hmmSupported_) {
+            Device::hmmTracker().remove(owner());
             // AMD HMM path. Destroy system memory
             if (!(amd::Os::releaseMemory(deviceMemory_, size()))) {
               ClPrint(amd::LOG_DEBUG, amd::LOG_MEM, "[ROCClr] munmap failed \n");
@@ -674,6 +675,8 @@ void Buffer::destroy() {
         } else {
           dev().memFree(deviceMemory_, size());
         }
+      } else if (flags_ & SubAllocatedMemory) {
+        dev().subAllocator()->Free(deviceMemory_);
       } else {
         dev().memFree(deviceMemory_, size());
       }
@@ -799,6 +802,11 @@ bool Buffer::create(bool alloc_local) {
       memFlags |= CL_MEM_SVM_FINE_GRAIN_BUFFER;
     }
     const bool isFineGrain = memFlags & CL_MEM_SVM_FINE_GRAIN_BUFFER;
+    // The page hints align the size and request the contiguous memory for 1GB, so the VM can use
+    // large fragments. Host memory allows 2MB only, since it relies on the transparent huge pages
+    const size_t largePage = ((memFlags & ROCCLR_MEM_LARGE_PAGE_1G) && !isFineGrain) ? 1 * Gi :
+        ((memFlags & (ROCCLR_MEM_LARGE_PAGE_2M | ROCCLR_MEM_LARGE_PAGE_1G)) ? 2 * Mi : 0);
+    const size_t allocSize = (largePage != 0) ? amd::alignUp(size(), largePage) : size();
 
     if (isFineGrain && !(memFlags & CL_MEM_VA_RANGE_AMD)) {
       // Use CPU direct access for the fine grain buffer
@@ -849,15 +857,41 @@ bool Buffer::create(bool alloc_local) {
           // Disable host access to force blit path for memeory writes.
           flags_ &= ~HostMemoryDirectAccess;
         } else {
-          deviceMemory_ = dev().hostAlloc(size(), 1, ((memFlags & CL_MEM_SVM_ATOMICS) != 0)
+          deviceMemory_ = dev().hostAlloc(allocSize, 1, ((memFlags & CL_MEM_SVM_ATOMICS) != 0)
                                                        ? Device::MemorySegment::kAtomics
                                                        : Device::MemorySegment::kNoAtomics);
         }
       } else {
         assert(!isHostMemDirectAccess() && "Runtime doesn't support direct access to GPU memory!");
-        deviceMemory_ = dev().deviceLocalAlloc(size(), (memFlags & CL_MEM_SVM_ATOMICS) != 0,
-                                               (memFlags & ROCCLR_MEM_HSA_UNCACHED) != 0,
-                                               (memFlags & ROCCLR_MEM_HSA_CONTIGUOUS) != 0);
+        auto subAllocator = dev().subAllocator();
+        if ((subAllocator != nullptr) && subAllocator->IsSubAllocSize(size()) &&
+            (largePage == 0) &&
+            !(memFlags & (CL_MEM_SVM_ATOMICS | ROCCLR_MEM_HSA_UNCACHED |
+                          ROCCLR_MEM_HSA_CONTIGUOUS | ROCCLR_MEM_INTERPROCESS))) {
+          // Small plain allocations share a larger chunk of device memory
+          deviceMemory_ = subAllocator->Allocate(size());
+          if (deviceMemory_ != nullptr) {
+            flags_ |= SubAllocatedMemory;
+          }
+        }
+        if (deviceMemory_ == nullptr) {
+          deviceMemory_ = dev().deviceLocalAlloc(allocSize, (memFlags & CL_MEM_SVM_ATOMICS) != 0,
+                                                 (memFlags & ROCCLR_MEM_HSA_UNCACHED) != 0,
+                                                 ((memFlags & ROCCLR_MEM_HSA_CONTIGUOUS) != 0) ||
+                                                 (largePage == 1 * Gi));
+        }
+      }
+      if ((deviceMemory_ != nullptr) && (largePage != 0)) {
+        // The backend doesn't report the fragment size, hence use the largest alignment of the
+        // placement, which the hint could achieve
+        pageSize_ = amd::Os::pageSize();
+        if ((largePage == 1 * Gi) && amd::isMultipleOf(deviceMemory_, 1 * Gi)) {
+          pageSize_ = 1 * Gi;
+        } else if (amd::isMultipleOf(deviceMemory_, 2 * Mi)) {
+          pageSize_ = 2 * Mi;
+        }
+        ClPrint(amd::LOG_INFO, amd::LOG_MEM, "Large page hint %zu for %p, achieved %zu",
+                largePage, deviceMemory_, pageSize_);
       }
       owner()->setSvmPtr(deviceMemory_);
     } else {
@@ -907,6 +941,9 @@ bool Buffer::create(bool alloc_local) {
 
     flags_ |= parentBuffer->isHostMemDirectAccess() ? HostMemoryDirectAccess : 0;
     flags_ |= parentBuffer->isCpuUncached() ? MemoryCpuUncached : 0;
+    if (parentBuffer->IsPersistentDirectMap()) {
+      persistent_host_ptr_ = reinterpret_cast<address>(parentBuffer->PersistentHostPtr()) + offset;
+    }
 
     // Explicitly set the host memory location,
     // because the parent location could change after reallocation
@@ -954,6 +991,14 @@ bool Buffer::create(bool alloc_local) {
     }
     else {
       const_cast<Device&>(dev()).updateFreeMemory(size(), false);
+      // Small buffers, which the host doesn't read, are mapped directly over the large BAR.
+      // The BAR is write-combined, so the host reads would be slower than the staging copies
+      if (dev().info().largeBar_ && (size() <= ROC_BAR_MAP_SIZE * Ki) &&
+          !(memFlags & (CL_MEM_HOST_READ_ONLY | CL_MEM_HOST_NO_ACCESS)) &&
+          ((memFlags & CL_MEM_HOST_WRITE_ONLY) || (memFlags & CL_MEM_READ_ONLY)) &&
+          (owner()->getContext().devices().size() == 1)) {
+        persistent_host_ptr_ = deviceMemory_;
+      }
     }
 
     assert(amd::isMultipleOf(deviceMemory_, static_cast<size_t>(dev().info().memBaseAddrAlign_)));
@@ -1033,6 +1078,10 @@ bool Buffer::create(bool alloc_local) {
 
 // ================================================================================================
 bool Buffer::ExportHandle(void* handle) const {
+  if (flags_ & SubAllocatedMemory) {
+    LogError("IPC export isn't supported for suballocated memory, set ROC_MAX_SUBALLOC_SIZE=0");
+    return false;
+  }
   void* orig_dev_ptr = nullptr;
   if (owner()->getSvmPtr() != nullptr) {
     orig_dev_ptr = owner()->getSvmPtr();
@@ -1346,6 +1395,7 @@ bool Image::createView(const Memory& parent) {
     status = hsa_ext_image_create_with_layout(
              dev().getBackendDevice(), &imageDescriptor_, deviceMemory_, permission_,
              HSA_EXT_IMAGE_DATA_LAYOUT_LINEAR, rowPitch, 0, &hsaImageObject_);
+    linearRowPitch_ = rowPitch;
 
     if (!amd::IS_HIP && dev().settings().imageBufferWar_ &&
         ((ownerImage.getWidth() * ownerImage.getImageFormat().getElementSize()) <
@@ -1380,6 +1430,8 @@ bool Image::createView(const Memory& parent) {
       }
 
       if (workaround) {
+        // The image data moves into a separate image
+        linearRowPitch_ = 0;
         if (ValidateMemory()) {
           status = HSA_STATUS_SUCCESS;
         } else {
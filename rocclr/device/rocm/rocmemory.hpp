@@ -223,6 +223,9 @@ class Image : public roc::Memory {
 
   amd::Image* CopyImageBuffer() const { return copyImageBuffer_; }
 
+  //! Returns the row pitch in bytes of an image with the linear layout, 0 if it's tiled
+  size_t LinearRowPitch() const { return linearRowPitch_; }
+
   virtual uint64_t originalDeviceAddress() const { return reinterpret_cast<uint64_t>(originalDeviceMemory_); }
 
   //! Adds an image view to the view cache for the fast blit manager operations
@@ -253,6 +256,7 @@ class Image : public roc::Memory {
 
   void* originalDeviceMemory_;
   amd::Image* copyImageBuffer_ = nullptr;
+  size_t linearRowPitch_ = 0;            //!< Row pitch of the linear layout, 0 if tiled
   std::vector<amd::Image*>  view_cache_;  //!< Cache of views for fast access
 };
 }
@@ -0,0 +1,331 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#include "device/rocm/rocpincache.hpp"
+#include "thread/thread.hpp"
+#include "utils/debug.hpp"
+#include "utils/flags.hpp"
+#include "utils/metrics.hpp"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/userfaultfd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#if defined(__linux__) && defined(__NR_userfaultfd) && defined(UFFDIO_REGISTER_MODE_WP)
+#define ROC_PINNED_CACHE_UFFD 1
+#ifndef UFFD_USER_MODE_ONLY
+#define UFFD_USER_MODE_ONLY 1
+#endif
+#endif
+
+namespace amd::roc {
+
+amd::Monitor PinnedMemoryCache::lock_(true);
+std::map<PinnedMemoryCache::Key, PinnedMemoryCache::Entry> PinnedMemoryCache::entries_;
+std::list<PinnedMemoryCache::Key> PinnedMemoryCache::lru_;
+std::vector<amd::Memory*> PinnedMemoryCache::retired_;
+size_t PinnedMemoryCache::total_size_ = 0;
+int PinnedMemoryCache::uffd_ = -1;
+int PinnedMemoryCache::wake_fd_ = -1;
+amd::Thread* PinnedMemoryCache::monitor_thread_ = nullptr;
+bool PinnedMemoryCache::monitor_init_ = false;
+
+namespace {
+//! The thread, which receives the mapping change events of the cached ranges
+class PinnedMemoryMonitorThread : public amd::Thread {
+ public:
+  PinnedMemoryMonitorThread()
+      : amd::Thread("Pinned Memory Monitor Thread", CQ_THREAD_STACK_SIZE) {}
+
+  //! The monitor thread entry point
+  void run(void* data) { reinterpret_cast<void (*)()>(data)(); }
+};
+}  // namespace
+
+// ================================================================================================
+bool PinnedMemoryCache::InitMonitor() {
+  monitor_init_ = true;
+#if defined(ROC_PINNED_CACHE_UFFD)
+  // Unprivileged processes can receive the events only in the user mode
+  int fd = syscall(__NR_userfaultfd, O_CLOEXEC | O_NONBLOCK | UFFD_USER_MODE_ONLY);
+  if (fd < 0) {
+    // Older kernels don't know the user mode only flag
+    fd = syscall(__NR_userfaultfd, O_CLOEXEC | O_NONBLOCK);
+  }
+  if (fd < 0) {
+    LogWarning("userfaultfd isn't available, the pinned memory cache is disabled");
+    return false;
+  }
+  struct uffdio_api api = {};
+  api.api = UFFD_API;
+  api.features = UFFD_FEATURE_EVENT_UNMAP | UFFD_FEATURE_EVENT_REMAP | UFFD_FEATURE_EVENT_REMOVE;
+  if (ioctl(fd, UFFDIO_API, &api) != 0) {
+    LogWarning("userfaultfd doesn't report unmap events, the pinned memory cache is disabled");
+    close(fd);
+    return false;
+  }
+  wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (wake_fd_ < 0) {
+    LogError("Couldn't create the pinned memory monitor eventfd");
+    close(fd);
+    return false;
+  }
+  uffd_ = fd;
+  auto thread = new PinnedMemoryMonitorThread();
+  if ((thread == nullptr) || (thread->state() < amd::Thread::INITIALIZED) ||
+      !thread->start(reinterpret_cast<void*>(&PinnedMemoryCache::MonitorEvents))) {
+    LogError("Couldn't start the pinned memory monitor thread");
+    delete thread;
+    uffd_ = -1;
+    close(fd);
+    close(wake_fd_);
+    wake_fd_ = -1;
+    return false;
+  }
+  monitor_thread_ = thread;
+  return true;
+#else
+  return false;
+#endif
+}
+
+// ================================================================================================
+bool PinnedMemoryCache::Register(uintptr_t addr, size_t size) {
+#if defined(ROC_PINNED_CACHE_UFFD)
+  // Write protect mode doesn't trap any access, until the pages are explicitly protected.
+  // The registration is required only for the delivery of non-cooperative events
+  struct uffdio_register reg = {};
+  reg.range.start = addr;
+  reg.range.len = size;
+  reg.mode = UFFDIO_REGISTER_MODE_WP;
+  return ioctl(uffd_, UFFDIO_REGISTER, &reg) == 0;
+#else
+  return false;
+#endif
+}
+
+// ================================================================================================
+void PinnedMemoryCache::Unregister(uintptr_t addr, size_t size) {
+#if defined(ROC_PINNED_CACHE_UFFD)
+  // The call fails harmlessly, if the range was already unmapped
+  struct uffdio_range range = {};
+  range.start = addr;
+  range.len = size;
+  ioctl(uffd_, UFFDIO_UNREGISTER, &range);
+#endif
+}
+
+// ================================================================================================
+void PinnedMemoryCache::MonitorEvents() {
+#if defined(ROC_PINNED_CACHE_UFFD)
+  while (true) {
+    struct pollfd fds[2] = {{uffd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+    int result = poll(fds, 2, -1);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    if (fds[1].revents != 0) {
+      // The runtime shutdown
+      return;
+    }
+    struct uffd_msg msg;
+    if (read(uffd_, &msg, sizeof(msg)) != sizeof(msg)) {
+      if ((errno == EAGAIN) || (errno == EINTR)) {
+        continue;
+      }
+      break;
+    }
+    switch (msg.event) {
+      case UFFD_EVENT_UNMAP:
+      case UFFD_EVENT_REMOVE:
+        Invalidate(msg.arg.remove.start, msg.arg.remove.end - msg.arg.remove.start);
+        break;
+      case UFFD_EVENT_REMAP:
+        Invalidate(msg.arg.remap.from, msg.arg.remap.len);
+        break;
+      default:
+        break;
+    }
+  }
+  LogError("Pinned memory monitor has stopped");
+#endif
+}
+
+// ================================================================================================
+void PinnedMemoryCache::Erase(std::map<Key, Entry>::iterator it) {
+  const uintptr_t start = it->first.second;
+  const size_t size = it->second.size_;
+  total_size_ -= size;
+  retired_.push_back(it->second.memory_);
+  lru_.erase(it->second.lru_);
+  entries_.erase(it);
+  // The range can be cached for other devices, which still need the events
+  for (const auto& entry : entries_) {
+    const uintptr_t other = entry.first.second;
+    if ((other < (start + size)) && (start < (other + entry.second.size_))) {
+      return;
+    }
+  }
+  Unregister(start, size);
+}
+
+// ================================================================================================
+void PinnedMemoryCache::ReleaseRetired() {
+  std::vector<amd::Memory*> retired;
+  {
+    amd::ScopedLock lock(lock_);
+    retired.swap(retired_);
+  }
+  for (auto memory : retired) {
+    memory->release();
+  }
+}
+
+// ================================================================================================
+amd::Memory* PinnedMemoryCache::Find(const amd::Device& dev, const void* addr, size_t size,
+                                     size_t* offset) {
+  if (ROC_PINNED_CACHE_SIZE == 0) {
+    return nullptr;
+  }
+  ReleaseRetired();
+
+  amd::ScopedLock lock(lock_);
+  const uintptr_t start = reinterpret_cast<uintptr_t>(addr);
+  // Find the range with the closest start address below the requested one
+  auto it = entries_.upper_bound({&dev, start});
+  if (it == entries_.begin()) {
+    amd::Metrics::add(amd::Metrics::PinnedCacheMisses);
+    return nullptr;
+  }
+  --it;
+  if ((it->first.first != &dev) || ((start + size) > (it->first.second + it->second.size_))) {
+    amd::Metrics::add(amd::Metrics::PinnedCacheMisses);
+    return nullptr;
+  }
+  amd::Metrics::add(amd::Metrics::PinnedCacheHits);
+  lru_.splice(lru_.begin(), lru_, it->second.lru_);
+  *offset = start - it->first.second;
+  it->second.memory_->retain();
+  return it->second.memory_;
+}
+
+// ================================================================================================
+void PinnedMemoryCache::Insert(const amd::Device& dev, amd::Memory* memory) {
+  const size_t cache_size = static_cast<size_t>(ROC_PINNED_CACHE_SIZE) * Mi;
+  const size_t size = memory->getSize();
+  if ((cache_size == 0) || (size > cache_size)) {
+    return;
+  }
+  ReleaseRetired();
+
+  amd::ScopedLock lock(lock_);
+  if (!monitor_init_) {
+    InitMonitor();
+  }
+  const uintptr_t start = reinterpret_cast<uintptr_t>(memory->getHostMem());
+  const Key key = {&dev, start};
+  if ((uffd_ < 0) || (entries_.find(key) != entries_.end())) {
+    return;
+  }
+  // The range can't be cached, if the kernel can't report unmap events for it
+  if (!Register(start, size)) {
+    ClPrint(amd::LOG_INFO, amd::LOG_MEM, "Pinned cache can't track range: %p, size %zu",
+            memory->getHostMem(), size);
+    return;
+  }
+  lru_.push_front(key);
+  entries_[key] = {size, memory, lru_.begin()};
+  memory->retain();
+  total_size_ += size;
+
+  // Evict the least recently used ranges over the limit
+  while (total_size_ > cache_size) {
+    Erase(entries_.find(lru_.back()));
+  }
+}
+
+// ================================================================================================
+void PinnedMemoryCache::Invalidate(uintptr_t addr, size_t size) {
+  amd::ScopedLock lock(lock_);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    const uintptr_t start = it->first.second;
+    if ((start < (addr + size)) && (addr < (start + it->second.size_))) {
+      ClPrint(amd::LOG_INFO, amd::LOG_MEM, "Pinned cache invalidate: %p, size %zu",
+              reinterpret_cast<void*>(start), it->second.size_);
+      auto erase = it++;
+      Erase(erase);
+    } else {
+      ++it;
+    }
+  }
+}
+
+// ================================================================================================
+void PinnedMemoryCache::ReleaseDevice(const amd::Device& dev) {
+  {
+    amd::ScopedLock lock(lock_);
+    for (auto it = entries_.lower_bound({&dev, 0});
+         (it != entries_.end()) && (it->first.first == &dev);) {
+      auto erase = it++;
+      Erase(erase);
+    }
+  }
+  ReleaseRetired();
+}
+
+// ================================================================================================
+void PinnedMemoryCache::TearDown() {
+#if defined(ROC_PINNED_CACHE_UFFD)
+  if (monitor_thread_ == nullptr) {
+    return;
+  }
+  // Wake up the monitor thread from poll() and wait for the exit. The cache lock can't be held,
+  // since the thread may be in the middle of an invalidation
+  uint64_t value = 1;
+  if (write(wake_fd_, &value, sizeof(value)) != sizeof(value)) {
+    LogError("Couldn't stop the pinned memory monitor thread");
+    return;
+  }
+  while ((monitor_thread_->state() != amd::Thread::FINISHED) &&
+         (monitor_thread_->state() != amd::Thread::FAILED)) {
+    amd::Os::yield();
+  }
+  delete monitor_thread_;
+  monitor_thread_ = nullptr;
+
+  amd::ScopedLock lock(lock_);
+  close(uffd_);
+  uffd_ = -1;
+  close(wake_fd_);
+  wake_fd_ = -1;
+#endif
+}
+
+}  // namespace amd::roc
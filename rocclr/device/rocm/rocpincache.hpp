@@ -0,0 +1,97 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#pragma once
+
+#include "top.hpp"
+#include "device/device.hpp"
+#include "platform/memory.hpp"
+#include "thread/monitor.hpp"
+
+#include <list>
+#include <map>
+#include <vector>
+
+namespace amd::roc {
+
+//! Process wide LRU cache of host ranges, pinned for the transfers of pageable memory.
+//! The cache is shared by all queues and devices. A range stays valid while its mapping is
+//! unchanged, hence the cache watches unmap, remap and remove events of the cached ranges
+//! through userfaultfd and drops the affected entries. If the kernel can't report
+//! the events for a range, then the range isn't cached.
+class PinnedMemoryCache : public AllStatic {
+ public:
+  //! Returns a retained pinned memory object with the host range [addr, addr + size),
+  //! created on the provided device, or nullptr. The offset of addr in the object is returned
+  static amd::Memory* Find(const amd::Device& dev, const void* addr, size_t size,
+                           size_t* offset);
+
+  //! Adds pinned memory, created on the provided device, into the cache
+  static void Insert(const amd::Device& dev, amd::Memory* memory);
+
+  //! Drops all cached ranges, overlapping [addr, addr + size)
+  static void Invalidate(uintptr_t addr, size_t size);
+
+  //! Releases the cached pinned memory of the device before the device is destroyed
+  static void ReleaseDevice(const amd::Device& dev);
+
+  //! Stops the monitor thread and closes userfaultfd at the runtime shutdown
+  static void TearDown();
+
+ private:
+  typedef std::pair<const amd::Device*, uintptr_t> Key;  //!< Device and start of the range
+
+  struct Entry {
+    size_t size_;                         //!< Size of the pinned range
+    amd::Memory* memory_;                 //!< Pinned memory object
+    std::list<Key>::iterator lru_;        //!< Position in the LRU list
+  };
+
+  //! Starts the monitor of the mapping changes, returns false if it isn't available
+  static bool InitMonitor();
+
+  //! Registers the range for the mapping change events
+  static bool Register(uintptr_t addr, size_t size);
+
+  //! Unregisters the range of a dropped entry from the mapping change events
+  static void Unregister(uintptr_t addr, size_t size);
+
+  //! Reads the mapping change events and invalidates the affected ranges
+  static void MonitorEvents();
+
+  //! Releases the pinned memory of invalidated entries
+  //! @note The monitor thread can't release memory, since it may block the munmap() caller
+  static void ReleaseRetired();
+
+  //! Removes the entry from the cache and retires the pinned memory
+  static void Erase(std::map<Key, Entry>::iterator it);
+
+  static amd::Monitor lock_;                  //!< Lock for the cache access
+  static std::map<Key, Entry> entries_;       //!< Cached ranges sorted by device and address
+  static std::list<Key> lru_;                 //!< The most recently used ranges at the front
+  static std::vector<amd::Memory*> retired_;  //!< Invalidated memory, pending release
+  static size_t total_size_;                  //!< Total size of the cached ranges
+  static int uffd_;                           //!< userfaultfd descriptor, -1 if not available
+  static int wake_fd_;                        //!< eventfd, which stops the monitor thread
+  static amd::Thread* monitor_thread_;        //!< The thread, which reads the events
+  static bool monitor_init_;                  //!< Monitor initialization was attempted
+};
+
+}  // namespace amd::roc
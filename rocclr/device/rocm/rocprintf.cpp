@@ -30,21 +30,46 @@
 #include <cstdio>
 #include <algorithm>
 #include <cmath>
+#include <string_view>
+#include <deque>
 
 // Functions defined in devhcprintf.cpp
 namespace amd {
 void handlePrintfDelayed(const uint64_t *input, uint64_t len, uint64_t control);
-bool populateFormatStringHashMap(
-    const std::vector<device::PrintfInfo> &printfInfo,
-    std::map<uint64_t, std::string> &strMap);
+const device::PrintfInfo* findPrintfInfo(const std::vector<device::PrintfInfo>& printfInfo,
+                                         uint64_t hash);
 } // namespace amd
 
 namespace amd::roc {
 
 PrintfDbg::PrintfDbg(Device& device, FILE* file)
-    : dbgBuffer_(nullptr), dbgBuffer_size_(0), dbgFile_(file), gpuDevice_(device) {}
-
-PrintfDbg::~PrintfDbg() { dev().hostFree(dbgBuffer_, dbgBuffer_size_); }
+    : dbgBuffer_(nullptr), dbgBuffer_size_(0), dbgFile_(file), gpuDevice_(device),
+      drainLock_("Printf drain lock", false), activeSlot_(nullptr), drainThread_(nullptr),
+      submitted_(0), completed_(0), terminate_(false) {}
+
+PrintfDbg::~PrintfDbg() {
+  if (drainThread_ != nullptr) {
+    {
+      amd::ScopedLock lock(drainLock_);
+      terminate_ = true;
+      drainLock_.notifyAll();
+    }
+    while ((drainThread_->state() != amd::Thread::FINISHED) &&
+           (drainThread_->state() != amd::Thread::FAILED)) {
+      amd::Os::yield();
+    }
+    delete drainThread_;
+  }
+  for (auto slot : slots_) {
+    dev().hostFree(slot->buffer_, slot->size_);
+    hsa_signal_destroy(slot->signal_);
+    delete slot;
+  }
+  // With the async drain the debug buffer belongs to a slot
+  if (activeSlot_ == nullptr) {
+    dev().hostFree(dbgBuffer_, dbgBuffer_size_);
+  }
+}
 
 bool PrintfDbg::allocate(bool realloc) {
   if (nullptr == dbgBuffer_) {
@@ -61,74 +86,112 @@ bool PrintfDbg::allocate(bool realloc) {
   return (nullptr != dbgBuffer_) ? true : false;
 }
 
-bool PrintfDbg::checkFloat(const std::string& fmt) const {
-  switch (fmt[fmt.size() - 1]) {
-    case 'e':
-    case 'E':
-    case 'f':
-    case 'g':
-    case 'G':
-    case 'a':
-      return true;
-      break;
-    default:
-      break;
+bool PrintfDbg::acquireSlot() {
+  if (activeSlot_ != nullptr) {
+    return true;
   }
-  return false;
+  amd::ScopedLock lock(drainLock_);
+  if (freeSlots_.empty() && (slots_.size() < std::max(ROC_PRINTF_DRAIN_BUFFERS, 1U))) {
+    auto slot = new DrainSlot();
+    slot->size_ = dev().info().printfBufferSize_;
+    slot->buffer_ = reinterpret_cast<address>(dev().hostAlloc(slot->size_, sizeof(void*)));
+    if (slot->buffer_ == nullptr) {
+      delete slot;
+      return false;
+    }
+    if (HSA_STATUS_SUCCESS != hsa_signal_create(0, 0, nullptr, &slot->signal_)) {
+      dev().hostFree(slot->buffer_, slot->size_);
+      delete slot;
+      return false;
+    }
+    slots_.push_back(slot);
+    freeSlots_.push_back(slot);
+  }
+  // All buffers are in flight, hence wait for the drain thread to release one
+  while (freeSlots_.empty()) {
+    drainLock_.wait();
+  }
+  activeSlot_ = freeSlots_.back();
+  freeSlots_.pop_back();
+  dbgBuffer_ = activeSlot_->buffer_;
+  dbgBuffer_size_ = activeSlot_->size_;
+  return true;
 }
 
-bool PrintfDbg::checkString(const std::string& fmt) const {
-  if (fmt[fmt.size() - 1] == 's') return true;
-  return false;
+bool PrintfDbg::submitSlot(VirtualGPU& gpu, const std::vector<device::PrintfInfo>& printfInfo,
+                           const std::string& kernelName) {
+  if (drainThread_ == nullptr) {
+    drainThread_ = new DrainThread();
+    if ((drainThread_ == nullptr) || (drainThread_->state() < amd::Thread::INITIALIZED) ||
+        !drainThread_->start(this)) {
+      LogError("Couldn't start the printf drain thread!");
+      delete drainThread_;
+      drainThread_ = nullptr;
+      return false;
+    }
+  }
+  DrainSlot* slot = activeSlot_;
+  slot->printfInfo_ = printfInfo;
+  slot->kernelName_ = kernelName;
+  slot->gpu_ = &gpu;
+  hsa_signal_store_relaxed(slot->signal_, 1);
+  // The barrier makes the records visible to the host once the kernel is done
+  gpu.signalGpuMemoryFence(slot->signal_);
+
+  amd::ScopedLock lock(drainLock_);
+  pendingSlots_.push_back(slot);
+  ++submitted_;
+  drainLock_.notifyAll();
+  activeSlot_ = nullptr;
+  return true;
 }
 
-int PrintfDbg::checkVectorSpecifier(const std::string& fmt, size_t startPos, size_t& curPos) const {
-  int vectorSize = 0;
-  size_t pos = curPos;
-  size_t size = curPos - startPos;
-
-  if (size >= 3) {
-    size = 0;
-    // no modifiers
-    if (fmt[curPos - 3] == 'v') {
-      size = 2;
+void PrintfDbg::drain() {
+  while (true) {
+    DrainSlot* slot = nullptr;
+    {
+      amd::ScopedLock lock(drainLock_);
+      while (pendingSlots_.empty() && !terminate_) {
+        drainLock_.wait();
+      }
+      if (pendingSlots_.empty()) {
+        break;
+      }
+      slot = pendingSlots_.front();
     }
-    // the modifiers are "h" or "l"
-    else if (fmt[curPos - 4] == 'v') {
-      size = 3;
+    hsa_signal_wait_scacquire(slot->signal_, HSA_SIGNAL_CONDITION_LT, 1, UINT64_MAX,
+                              HSA_WAIT_STATE_BLOCKED);
+    if (!process(slot->buffer_, slot->printfInfo_)) {
+      LogError("Could not print data from the printf buffer!");
     }
-    // the modifier is "hh"
-    else if ((curPos >= 5) && (fmt[curPos - 5] == 'v')) {
-      size = 4;
+    const uint32_t bytes = *reinterpret_cast<const uint32_t*>(slot->buffer_);
+    if (ROC_DISPATCH_STATS && (bytes != 0)) {
+      slot->gpu_->RecordPrintfBytes(slot->kernelName_, bytes);
     }
-    if (size > 0) {
-      curPos = size;
-      pos -= curPos;
-
-      // Get vector size
-      vectorSize = fmt[pos++] - '0';
-      // PrintfDbg supports only 2, 3, 4, 8 and 16 wide vectors
-      switch (vectorSize) {
-        case 1:
-          if ((fmt[pos++] - '0') == 6) {
-            vectorSize = 16;
-          } else {
-            vectorSize = 0;
-          }
-          break;
-        case 2:
-        case 3:
-        case 4:
-        case 8:
-          break;
-        default:
-          vectorSize = 0;
-          break;
-      }
+    {
+      amd::ScopedLock lock(drainLock_);
+      pendingSlots_.pop_front();
+      freeSlots_.push_back(slot);
+      ++completed_;
+      drainLock_.notifyAll();
     }
   }
+}
 
-  return vectorSize;
+void PrintfDbg::flush() {
+  if (drainThread_ == nullptr) {
+    return;
+  }
+  amd::ScopedLock lock(drainLock_);
+  const uint64_t target = submitted_;
+  while (completed_ < target) {
+    drainLock_.wait();
+  }
+}
+
+bool PrintfDbg::checkString(const std::string& fmt) const {
+  if (fmt[fmt.size() - 1] == 's') return true;
+  return false;
 }
 
 static constexpr size_t ConstStr = 0xffffffff;
@@ -259,141 +322,64 @@ size_t PrintfDbg::outputArgument(const std::string& fmt, bool printFloat, size_t
 
 void PrintfDbg::outputDbgBuffer(const device::PrintfInfo& info, const uint32_t* workitemData,
                                 size_t& i) const {
-  static const char* specifiers = "cdieEfgGaosuxXp";
-  static const char* modifiers = "hl";
-  static const char* special = "%n";
   static const std::string sepStr = "%s";
   const uint32_t* s = workitemData;
-  size_t pos = 0;
-
-  // Find the format string
-  std::string str = info.fmtString_;
-  std::string fmt;
-  size_t posStart, posEnd;
-
-  // Print all arguments
-  // Note: the following code walks through all arguments, provided by the
-  // kernel and
-  // finds the corresponding specifier in the format string.
-  // Then it splits the original string into substrings with a single specifier
-  // and
-  // uses standard PrintfDbg() to print each argument
-  for (uint j = 0; j < info.arguments_.size(); ++j) {
-    do {
-      posStart = str.find_first_of("%", pos);
-      if (posStart != std::string::npos) {
-        posStart++;
-        // Erase all spaces after %
-        while (str[posStart] == ' ') {
-          str.erase(posStart, 1);
-        }
-        size_t tmp = str.find_first_of(special, posStart);
-        size_t tmp2 = str.find_first_of(specifiers, posStart);
-        // Special cases. Special symbol is located before any specifier
-        if (tmp < tmp2) {
-          posEnd = posStart + 1;
-          fmt = str.substr(pos, posEnd - pos);
-          fmt.erase(posStart - pos - 1, 1);
-          pos = posStart = posEnd;
-          outputArgument(sepStr, false, ConstStr, fmt.data());
-          continue;
-        }
-        break;
-      } else if (pos < str.length()) {
-        outputArgument(sepStr, false, ConstStr,
-                       str.substr(pos).data());
-      }
-    } while (posStart != std::string::npos);
-
-    if (posStart != std::string::npos) {
-      bool printFloat = false;
-      int vectorSize = 0;
-      size_t idPos = 0;
-
-      // Search for PrintfDbg specifier in the format string.
-      // It will be a split point for the output
-      posEnd = str.find_first_of(specifiers, posStart);
-      if (posEnd == std::string::npos) {
-        pos = posStart = posEnd;
-        break;
-      }
-      posEnd++;
-
-      size_t curPos = posEnd;
-      vectorSize = checkVectorSpecifier(str, posStart, curPos);
 
-      // Get substring from the last position to the current specifier
-      fmt = str.substr(pos, posEnd - pos);
-
-      // Readjust the string pointer if PrintfDbg outputs a vector
-      if (vectorSize != 0) {
-        size_t posVecSpec = fmt.length() - (curPos + 1);
-        size_t posVecMod = fmt.find_first_of(modifiers, posVecSpec + 1);
-        size_t posMod = str.find_first_of(modifiers, posStart);
-        if (posMod < posEnd) {
-          fmt = fmt.erase(posVecSpec, posVecMod - posVecSpec);
+  // The format string was split into the pieces with a single specifier at the kernel load,
+  // hence use standard printf() for each piece
+  for (const auto& spec : info.specs_) {
+    switch (spec.kind_) {
+      case device::PrintfSpec::Text:
+        outputArgument(sepStr, false, ConstStr, spec.fmt_.data());
+        break;
+      case device::PrintfSpec::Mismatch:
+        amd::Os::printf(
+            "Error: The arguments don't match the printf format string. "
+            "printf(%s)",
+            info.fmtString_.data());
+        return;
+      case device::PrintfSpec::Argument: {
+        const uint argSize = info.arguments_[spec.argument_];
+        // Is it a scalar value?
+        if (spec.vectorSize_ == 0) {
+          size_t length = outputArgument(spec.fmt_, spec.printFloat_, argSize, &s[i]);
+          if (0 == length) {
+            return;
+          }
+          i += amd::alignUp(length, sizeof(uint32_t)) / sizeof(uint32_t);
         } else {
-          fmt = fmt.erase(posVecSpec, curPos);
-        }
-        idPos = posStart - pos - 1;
-      }
-      pos = posStart = posEnd;
-
-      // Find out if the argument is a float
-      printFloat = checkFloat(fmt);
+          // 3-component vector's size is defined as 4 * size of each scalar component
+          size_t elemSize = argSize / (spec.vectorSize_ == 3 ? 4 : spec.vectorSize_);
+          size_t k = i * sizeof(uint32_t);
 
-      // Is it a scalar value?
-      if (vectorSize == 0) {
-        size_t length;
-        length = outputArgument(fmt, printFloat, info.arguments_[j], &s[i]);
-        if (0 == length) {
-          return;
-        }
-        i += amd::alignUp(length, sizeof(uint32_t)) / sizeof(uint32_t);
-      } else {
-        // 3-component vector's size is defined as 4 * size of each scalar
-        // component
-        size_t elemSize = info.arguments_[j] / (vectorSize == 3 ? 4 : vectorSize);
-        size_t k = i * sizeof(uint32_t);
-        std::string elementStr = fmt.substr(idPos, fmt.size());
-
-        // Print first element with full string
-        if (0 == outputArgument(fmt, printFloat, elemSize, &s[i])) {
-          return;
-        }
+          // Print first element with full string
+          if (0 == outputArgument(spec.fmt_, spec.printFloat_, elemSize, &s[i])) {
+            return;
+          }
 
-        // Print other elemnts with separator if available
-        for (int e = 1; e < vectorSize; ++e) {
-          const char* t = reinterpret_cast<const char*>(s);
+          // Print other elemnts with separator if available
+          for (int e = 1; e < spec.vectorSize_; ++e) {
+            const char* t = reinterpret_cast<const char*>(s);
 
-          // Output the vector separator
-          outputArgument(sepStr, false, ConstStr, reinterpret_cast<const uint32_t*>(Separator));
+            // Output the vector separator
+            outputArgument(sepStr, false, ConstStr, reinterpret_cast<const uint32_t*>(Separator));
 
-          // Output the next element
-          outputArgument(elementStr, printFloat, elemSize,
-                         reinterpret_cast<const uint32_t*>(&t[k + e * elemSize]));
+            // Output the next element
+            outputArgument(spec.elementFmt_, spec.printFloat_, elemSize,
+                           reinterpret_cast<const uint32_t*>(&t[k + e * elemSize]));
+          }
+          i += (amd::alignUp(argSize, sizeof(uint32_t))) / sizeof(uint32_t);
         }
-        i += (amd::alignUp(info.arguments_[j], sizeof(uint32_t))) / sizeof(uint32_t);
+        break;
       }
-    } else {
-      amd::Os::printf(
-          "Error: The arguments don't match the printf format string. "
-          "printf(%s)",
-          info.fmtString_.data());
-      return;
     }
   }
-
-  if (pos != std::string::npos) {
-    fmt = str.substr(pos, str.size() - pos);
-    outputArgument(sepStr, false, ConstStr, reinterpret_cast<const uint32_t*>(fmt.data()));
-  }
 }
 
 bool PrintfDbg::init(bool printfEnabled) {
   // Set up debug output buffer (if printf active)
   if (printfEnabled) {
-    if (!allocate()) {
+    if (ROC_PRINTF_ASYNC_DRAIN ? !acquireSlot() : !allocate()) {
       return false;
     }
 
@@ -421,115 +407,124 @@ bool PrintfDbg::init(bool printfEnabled) {
 }
 
 bool PrintfDbg::output(VirtualGPU& gpu, bool printfEnabled,
-                       const std::vector<device::PrintfInfo>& printfInfo) {
+                       const std::vector<device::PrintfInfo>& printfInfo,
+                       const std::string& kernelName) {
   if (printfEnabled) {
-    uint32_t offsetSize = 0;
+    // Don't stall the submission on the kernel and let the drain thread print the records
+    if (ROC_PRINTF_ASYNC_DRAIN) {
+      return submitSlot(gpu, printfInfo, kernelName);
+    }
 
     // Wait until outstanding kernels finish
     gpu.releaseGpuMemoryFence();
 
-    // Get memory pointer to the staged buffer
-    uint32_t* dbgBufferPtr = reinterpret_cast<uint32_t*>(dbgBuffer_);
-    if (nullptr == dbgBufferPtr) {
-      return false;
+    const uint32_t bytes = *reinterpret_cast<const uint32_t*>(dbgBuffer_);
+    if (ROC_DISPATCH_STATS && (bytes != 0)) {
+      gpu.RecordPrintfBytes(kernelName, bytes);
     }
+    return process(dbgBuffer_, printfInfo);
+  }
 
-    offsetSize = *dbgBufferPtr;
-
-    if (offsetSize == 0) {
-      return true;
-    }
+  return true;
+}
 
-    // Get a pointer to the buffer data
-    dbgBufferPtr = reinterpret_cast<uint32_t*>(dbgBuffer_ + 2 * sizeof(uint32_t));
-    if (nullptr == dbgBufferPtr) {
-      return false;
-    }
+bool PrintfDbg::process(const_address buffer,
+                        const std::vector<device::PrintfInfo>& printfInfo) const {
+  uint32_t offsetSize = 0;
 
-    uint sb = 0;
-    uint sbt = 0;
-
-    // Handle HIP nonhostcall printf here, However longterm goal
-    // should be to have common implementation for both HIP and OpenCL
-    if (amd::IS_HIP) {
-      // Map between 64 bit MD5 format string hash and
-      // actual format string
-      std::map<uint64_t, std::string> StrMap;
-
-      auto BufferForHIP = reinterpret_cast<uint32_t*>(dbgBufferPtr);
-
-      // Populate string map with hashes and actual
-      // format strings.
-      if(!amd::populateFormatStringHashMap(printfInfo, StrMap))
-        return false;
-
-      while (sbt < offsetSize)
-      {
-        auto controlDword = *BufferForHIP++;
-        auto PB = (uint64_t*)BufferForHIP;
-
-        uint64_t nextOffset  = controlDword >> 2;
-
-        std::vector<uint8_t> PBuffer;
-        uint64_t BufferLen = 0;
-        if (controlDword & 2U) {
-          // Process the contsant format string case.
-          // The first value is the 64 bit format string hash
-          // and remaining values are printf arguments.
-          // Construct a temporary buffer with actual format
-          // string followed by arguments. The format string is
-          // obtained by querying StrMap populated before.
-          auto ArgsLen = nextOffset - 12;
-          auto Str = StrMap[*PB++];
-          auto StrLenWithNull = Str.size() + 1;
-          BufferLen = ArgsLen + amd::alignUp(StrLenWithNull, sizeof(uint64_t));
-          PBuffer.resize(BufferLen);
-          memcpy(PBuffer.data(), Str.c_str(), StrLenWithNull);
-          memset(PBuffer.data() + Str.size(), 0, 8 - (StrLenWithNull % 8 ));
-          memcpy(PBuffer.data() + amd::alignUp(StrLenWithNull, sizeof(uint64_t)),
-          PB, ArgsLen);
-        }
-        else {
-            // Process Non constant format string case.
-            // Here, The buffer itself contains the actual
-            // format string and hence just copy the contents
-            // of format string and arguments into a temporary
-            // buffer
-            BufferLen = nextOffset - /*ControlDWord*/4;
-            PBuffer.resize(BufferLen);
-            memcpy(PBuffer.data(), BufferForHIP, nextOffset);
-        }
+  // Get memory pointer to the staged buffer
+  const uint32_t* dbgBufferPtr = reinterpret_cast<const uint32_t*>(buffer);
+  if (nullptr == dbgBufferPtr) {
+    return false;
+  }
 
-        // Handle printing
-        amd::handlePrintfDelayed((uint64_t*)PBuffer.data(), BufferLen / 8,
-                            controlDword);
-        BufferForHIP += (nextOffset / 4) - /*ControlDWord*/1;
-        sbt += nextOffset;
-      }
+  offsetSize = *dbgBufferPtr;
 
-      return true;
-    }
+  if (offsetSize == 0) {
+    return true;
+  }
 
-    // parse the debug buffer
-    while (sbt < offsetSize) {
-      if (*dbgBufferPtr >= printfInfo.size()) {
-        LogError("Couldn't find the reported PrintfID!");
-        return false;
+  // Get a pointer to the buffer data
+  dbgBufferPtr = reinterpret_cast<const uint32_t*>(buffer + 2 * sizeof(uint32_t));
+
+  uint sb = 0;
+  uint sbt = 0;
+
+  // Handle HIP nonhostcall printf here, However longterm goal
+  // should be to have common implementation for both HIP and OpenCL
+  if (amd::IS_HIP) {
+
+    auto BufferForHIP = dbgBufferPtr;
+
+
+    while (sbt < offsetSize)
+    {
+      auto controlDword = *BufferForHIP++;
+      auto PB = (const uint64_t*)BufferForHIP;
+
+      uint64_t nextOffset  = controlDword >> 2;
+
+      std::vector<uint8_t> PBuffer;
+      uint64_t BufferLen = 0;
+      if (controlDword & 2U) {
+        // Process the contsant format string case.
+        // The first value is the 64 bit format string hash
+        // and remaining values are printf arguments.
+        // Construct a temporary buffer with actual format
+        // string followed by arguments. The format string is
+        // obtained from the printf info, parsed at the kernel load.
+        auto ArgsLen = nextOffset - 12;
+        const device::PrintfInfo* info = amd::findPrintfInfo(printfInfo, *PB++);
+        std::string_view Str = (info != nullptr) ?
+            std::string_view(info->fmtString_).substr(info->fmtOffset_) : std::string_view();
+        auto StrLenWithNull = Str.size() + 1;
+        BufferLen = ArgsLen + amd::alignUp(StrLenWithNull, sizeof(uint64_t));
+        PBuffer.resize(BufferLen);
+        memcpy(PBuffer.data(), Str.data(), Str.size());
+        memset(PBuffer.data() + Str.size(), 0, 8 - (StrLenWithNull % 8 ));
+        memcpy(PBuffer.data() + amd::alignUp(StrLenWithNull, sizeof(uint64_t)),
+        PB, ArgsLen);
       }
-      const device::PrintfInfo& info = printfInfo[(*dbgBufferPtr)];
-      sb += sizeof(uint32_t);
-      for (const auto& ita : info.arguments_) {
-        sb += ita;
+      else {
+          // Process Non constant format string case.
+          // Here, The buffer itself contains the actual
+          // format string and hence just copy the contents
+          // of format string and arguments into a temporary
+          // buffer
+          BufferLen = nextOffset - /*ControlDWord*/4;
+          PBuffer.resize(BufferLen);
+          memcpy(PBuffer.data(), BufferForHIP, nextOffset);
       }
 
-      size_t idx = 1;
-      // There's something in the debug buffer
-      outputDbgBuffer(info, dbgBufferPtr, idx);
+      // Handle printing
+      amd::handlePrintfDelayed((uint64_t*)PBuffer.data(), BufferLen / 8,
+                          controlDword);
+      BufferForHIP += (nextOffset / 4) - /*ControlDWord*/1;
+      sbt += nextOffset;
+    }
+
+    return true;
+  }
 
-      sbt += sb;
-      dbgBufferPtr += sb / sizeof(uint32_t);
-      sb = 0;
+  // parse the debug buffer
+  while (sbt < offsetSize) {
+    if (*dbgBufferPtr >= printfInfo.size()) {
+      LogError("Couldn't find the reported PrintfID!");
+      return false;
+    }
+    const device::PrintfInfo& info = printfInfo[(*dbgBufferPtr)];
+    sb += sizeof(uint32_t);
+    for (const auto& ita : info.arguments_) {
+      sb += ita;
     }
+
+    size_t idx = 1;
+    // There's something in the debug buffer
+    outputDbgBuffer(info, dbgBufferPtr, idx);
+
+    sbt += sb;
+    dbgBufferPtr += sb / sizeof(uint32_t);
+    sb = 0;
   }
 
   return true;
@@ -66,18 +66,51 @@ class PrintfDbg : public amd::HeapObject {
   //! Prints the kernel's debug informaiton from the buffer
   bool output(VirtualGPU& gpu,
               bool printfEnabled,                        //!< checks for printf
-              const std::vector<device::PrintfInfo>& printfInfo  //!< printf info
+              const std::vector<device::PrintfInfo>& printfInfo,  //!< printf info
+              const std::string& kernelName              //!< The kernel for the dispatch stats
               );
 
   //! Returns debug buffer object
   address dbgBuffer() const { return dbgBuffer_; }
 
+  //! Waits until the drain thread has printed all submitted buffers
+  void flush();
+
  protected:
+  //! The printf buffer of a finished dispatch, waiting for the processing in the drain thread
+  struct DrainSlot {
+    address buffer_;       //!< Buffer with printf records
+    size_t size_;          //!< Size of the buffer
+    hsa_signal_t signal_;  //!< Signaled by the barrier after the kernel
+    std::vector<device::PrintfInfo> printfInfo_;  //!< printf info of the kernel
+    std::string kernelName_;  //!< The kernel for the dispatch stats
+    VirtualGPU* gpu_;         //!< The queue of the dispatch
+  };
+
+  //! The thread, which formats the printf records of the finished kernels
+  class DrainThread : public amd::Thread {
+   public:
+    DrainThread() : amd::Thread("Printf Drain Thread", CQ_THREAD_STACK_SIZE) {}
+
+    //! The drain thread entry point
+    void run(void* data) { reinterpret_cast<PrintfDbg*>(data)->drain(); }
+  };
+
   address dbgBuffer_;      //!< Buffer to hold debug output
   size_t dbgBuffer_size_;  //!< Size of the debugger buffer
   FILE* dbgFile_;          //!< Debug file
   Device& gpuDevice_;      //!< GPU device object
 
+  amd::Monitor drainLock_;               //!< Guards the slot lists and the counters
+  std::vector<DrainSlot*> slots_;        //!< All allocated slots
+  std::vector<DrainSlot*> freeSlots_;    //!< Slots, available for the next dispatch
+  std::deque<DrainSlot*> pendingSlots_;  //!< Submitted slots in the dispatch order
+  DrainSlot* activeSlot_;                //!< The slot of the current dispatch
+  DrainThread* drainThread_;             //!< The drain thread, created on the first submit
+  uint64_t submitted_;                   //!< The number of submitted slots
+  uint64_t completed_;                   //!< The number of processed slots
+  bool terminate_;                       //!< The drain thread must exit
+
   //! Gets GPU device object
   Device& dev() const { return gpuDevice_; }
 
@@ -85,20 +118,27 @@ class PrintfDbg : public amd::HeapObject {
   bool allocate(bool realloc = false  //!< If TRUE then reallocate the debug memory
                 );
 
-  //! Returns TRUE if a float value has to be printed
-  bool checkFloat(const std::string& fmt  //!< Format string
-                  ) const;
+  //! Finds a free slot for the next dispatch with ROC_PRINTF_ASYNC_DRAIN
+  bool acquireSlot();
+
+  //! Submits the active slot into the drain thread after the kernel's dispatch
+  bool submitSlot(VirtualGPU& gpu,
+                  const std::vector<device::PrintfInfo>& printfInfo,  //!< printf info
+                  const std::string& kernelName  //!< The kernel for the dispatch stats
+                  );
+
+  //! The drain thread loop
+  void drain();
+
+  //! Prints the records from the debug buffer
+  bool process(const_address buffer,                              //!< The debug buffer
+               const std::vector<device::PrintfInfo>& printfInfo  //!< printf info
+               ) const;
 
   //! Returns TRUE if a string value has to be printed
   bool checkString(const std::string& fmt  //!< Format string
                    ) const;
 
-  //! Finds the specifier in the format string
-  int checkVectorSpecifier(const std::string& fmt,  //!< Format string
-                           size_t startPos,         //!< Start position for processing
-                           size_t& curPos           //!< End position for processing
-                           ) const;
-
   //! Outputs an argument
   size_t outputArgument(const std::string& fmt,   //!< Format strint
                         bool printFloat,          //!< Argument is a float value
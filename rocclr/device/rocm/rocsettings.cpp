@@ -50,8 +50,8 @@ Settings::Settings() {
   char* nonCoherentMode = getenv("OPENCL_USE_NC_MEMORY_POLICY");
   enableNCMode_ = (nonCoherentMode) ? true : false;
 
-  // Disable image DMA by default (ROCM runtime doesn't support it)
-  imageDMA_ = false;
+  // ROCr has no SDMA path for the tiled layouts, so image DMA covers the linear images only
+  imageDMA_ = GPU_IMAGE_DMA;
 
   stagedXferRead_ = true;
   stagedXferWrite_ = true;
@@ -147,6 +147,8 @@ bool Settings::create(bool fullProfile, const amd::Isa& isa,
   enableExtension(ClKhrSubGroups);
   enableExtension(ClKhrDepthImages);
   enableExtension(ClAmdCopyBufferP2P);
+  enableExtension(ClKhrCommandBuffer);
+  enableExtension(ClKhrPriorityHints);
   enableExtension(ClKhrFp16);
   supportDepthsRGB_ = true;
 
@@ -36,7 +36,8 @@ class Settings : public device::Settings {
     EnableSystemMemory    = 0x01, //!< Forces system memory preference by default
     EnableMallocPrefetch  = 0x02, //!< Skips default prefetch after allocation
     EnableSvmTracking     = 0x04, //!< Enables SW SVM tracking
-    EnableDebugSvm        = 0x08  //!< Extra debug flag (reserved for runtime developers)
+    EnableDebugSvm        = 0x08, //!< Extra debug flag (reserved for runtime developers)
+    EnableAutoMigration   = 0x10  //!< Migrates managed memory from the kernel access statistics
   };
 
   union {
@@ -21,9 +21,18 @@
 #if defined(__clang__)
 #if __has_feature(address_sanitizer)
 #include "rocurilocator.hpp"
+#include <algorithm>
 #include <sstream>
 
 namespace amd::roc {
+UriLocator::~UriLocator() {
+  for (auto& it : decodedUris_) {
+    if (amd::Os::isValidFileDesc(it.second.fd_)) {
+      amd::Os::CloseFileHandle(it.second.fd_);
+    }
+  }
+}
+
 hsa_status_t UriLocator::createUriRangeTable() {
   auto execCb = [] (hsa_executable_t exec,
     void *data) -> hsa_status_t {
@@ -93,7 +102,21 @@ hsa_status_t UriLocator::createUriRangeTable() {
     return HSA_STATUS_ERROR;
 
   uint64_t callbackArgs[2] = {(uint64_t)& fn_table_, (uint64_t) &rangeTab_};
-  return fn_table_.hsa_ven_amd_loader_iterate_executables(execCb, (void*) callbackArgs);
+  hsa_status_t status =
+      fn_table_.hsa_ven_amd_loader_iterate_executables(execCb, (void*) callbackArgs);
+  std::sort(rangeTab_.begin(), rangeTab_.end(),
+            [](const UriRange& a, const UriRange& b) { return a.startAddr_ < b.startAddr_; });
+  return status;
+}
+
+const UriLocator::UriRange* UriLocator::findRange(uint64_t device_pc) const {
+  auto it = std::upper_bound(rangeTab_.begin(), rangeTab_.end(), device_pc,
+      [](uint64_t pc, const UriRange& range) { return pc < range.startAddr_; });
+  if (it == rangeTab_.begin()) {
+    return nullptr;
+  }
+  --it;
+  return (device_pc <= it->endAddr_) ? &(*it) : nullptr;
 }
 
 // Encoding of uniform-resource-identifier(URI) is detailed in
@@ -105,6 +128,14 @@ std::pair<uint64_t, uint64_t> UriLocator::decodeUriAndGetFd(UriInfo& uri,
   uint64_t offset = 0, size = 0;
   if (uri.uriPath.size() == 0)
     return {0,0};
+  // Many reports come from the same code object, so don't parse and open it again
+  auto cached = decodedUris_.find(uri.uriPath);
+  if (cached != decodedUris_.end()) {
+    uri.uriPath = cached->second.path_;
+    *uri_fd = cached->second.fd_;
+    return {cached->second.offset_, cached->second.size_};
+  }
+  const std::string encodedUri = uri.uriPath;
   auto pos = uri.uriPath.find("//");
   if (pos == std::string::npos || uri.uriPath.substr(0, pos) != "file:") {
     uri.uriPath="";
@@ -152,6 +183,7 @@ std::pair<uint64_t, uint64_t> UriLocator::decodeUriAndGetFd(UriInfo& uri,
   // and set offset to begin at 0.
   if (size == 0)
     size = fd_size;
+  decodedUris_[encodedUri] = DecodedUri{uri.uriPath, *uri_fd, offset, size};
   return {offset, size};
 }
 
@@ -172,9 +204,19 @@ UriLocator::UriInfo UriLocator::lookUpUri(uint64_t device_pc) {
     init_ = true;
   }
 
-  for(auto& seg : rangeTab_)
-    if (seg.startAddr_ <= device_pc && device_pc <= seg.endAddr_)
-     return UriInfo{seg.Uri_.c_str(), seg.elfDelta_};
+  const UriRange* seg = findRange(device_pc);
+  if (seg == nullptr) {
+    // The code object could be loaded after the table was built, hence refresh it
+    rangeTab_.clear();
+    if (createUriRangeTable() != HSA_STATUS_SUCCESS) {
+      rangeTab_.clear();
+      return errorstate;
+    }
+    seg = findRange(device_pc);
+  }
+  if (seg != nullptr) {
+    return UriInfo{seg->Uri_.c_str(), seg->elfDelta_};
+  }
 
   return errorstate;
 }
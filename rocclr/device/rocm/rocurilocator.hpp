@@ -24,6 +24,7 @@
 #include "device/devurilocator.hpp"
 #include "hsa/hsa_ven_amd_loader.h"
 
+#include <unordered_map>
 #include <vector>
 namespace amd::roc {
 class UriLocator : public device::UriLocator {
@@ -33,12 +34,23 @@ class UriLocator : public device::UriLocator {
     int64_t elfDelta_;
     std::string  Uri_;
   };
-  std::vector<UriRange> rangeTab_;
+  std::vector<UriRange> rangeTab_;  //!< Loaded code objects, sorted by the start address
   hsa_ven_amd_loader_1_03_pfn_t fn_table_;
 
+  //! A decoded URI with the opened file of the code object
+  struct DecodedUri {
+    std::string path_;
+    amd::Os::FileDesc fd_;
+    uint64_t offset_, size_;
+  };
+  std::unordered_map<std::string, DecodedUri> decodedUris_;  //!< Decoded URIs of the reports
+
   hsa_status_t createUriRangeTable();
+
+  //! Finds the code object, which holds the device PC
+  const UriRange* findRange(uint64_t device_pc) const;
   public:
-   virtual ~UriLocator() {}
+   virtual ~UriLocator();
    virtual UriInfo lookUpUri(uint64_t device_pc) override;
    virtual std::pair<uint64_t, uint64_t> decodeUriAndGetFd(UriInfo& uri_path,
      amd::Os::FileDesc* uri_fd) override;
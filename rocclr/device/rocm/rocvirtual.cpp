@@ -33,6 +33,7 @@
 #include "platform/memory.hpp"
 #include "platform/sampler.hpp"
 #include "utils/debug.hpp"
+#include "utils/metrics.hpp"
 #include "os/os.hpp"
 #include "hsa/amd_hsa_kernel_code.h"
 #include "hsa/amd_hsa_queue.h"
@@ -91,6 +92,11 @@ static constexpr uint16_t kNopPacketHeader =
     (HSA_FENCE_SCOPE_NONE << HSA_PACKET_HEADER_ACQUIRE_FENCE_SCOPE) |
     (HSA_FENCE_SCOPE_NONE << HSA_PACKET_HEADER_RELEASE_FENCE_SCOPE);
 
+static constexpr uint16_t kBarrierPacketAgentScopeHeader =
+    (HSA_PACKET_TYPE_BARRIER_AND << HSA_PACKET_HEADER_TYPE) | (1 << HSA_PACKET_HEADER_BARRIER) |
+    (HSA_FENCE_SCOPE_AGENT << HSA_PACKET_HEADER_ACQUIRE_FENCE_SCOPE) |
+    (HSA_FENCE_SCOPE_AGENT << HSA_PACKET_HEADER_RELEASE_FENCE_SCOPE);
+
 static constexpr uint16_t kBarrierPacketAcquireHeader =
     (HSA_PACKET_TYPE_BARRIER_AND << HSA_PACKET_HEADER_TYPE) | (1 << HSA_PACKET_HEADER_BARRIER) |
     (HSA_FENCE_SCOPE_SYSTEM << HSA_PACKET_HEADER_ACQUIRE_FENCE_SCOPE) |
@@ -113,12 +119,23 @@ static constexpr uint16_t kBarrierVendorPacketNopScopeHeader =
     (HSA_FENCE_SCOPE_NONE << HSA_PACKET_HEADER_ACQUIRE_FENCE_SCOPE) |
     (HSA_FENCE_SCOPE_NONE << HSA_PACKET_HEADER_RELEASE_FENCE_SCOPE);
 
+static constexpr uint16_t kBarrierVendorPacketAgentScopeHeader =
+    (HSA_PACKET_TYPE_VENDOR_SPECIFIC << HSA_PACKET_HEADER_TYPE) |
+    (1 << HSA_PACKET_HEADER_BARRIER) |
+    (HSA_FENCE_SCOPE_AGENT << HSA_PACKET_HEADER_ACQUIRE_FENCE_SCOPE) |
+    (HSA_FENCE_SCOPE_AGENT << HSA_PACKET_HEADER_RELEASE_FENCE_SCOPE);
+
 static constexpr hsa_barrier_and_packet_t kBarrierAcquirePacket = {
     kBarrierPacketAcquireHeader, 0, 0, {{0}}, 0, {0}};
 
 static constexpr hsa_barrier_and_packet_t kBarrierReleasePacket = {
     kBarrierPacketReleaseHeader, 0, 0, {{0}}, 0, {0}};
 
+// Adaptive wait: extra active wait time, the active wait limit (ns) and history length
+static constexpr uint64_t kAdaptiveWaitMargin = 10 * K;
+static constexpr uint64_t kAdaptiveWaitMaxSpin = 2000 * K;
+static constexpr uint64_t kAdaptiveWaitHistory = 8;
+
 double Timestamp::ticksToTime_ = 0;
 
 static unsigned extractAqlBits(unsigned v, unsigned pos, unsigned width) {
@@ -165,6 +182,12 @@ void Timestamp::checkGpuTime() {
           static_cast<amd::AccumulateCommand&>(command()).addTimestamps(time.start, time.end);
         }
 
+        if ((doorbell_ != 0) && it->isPacketDispatch_ && (it->engine_ == HwQueueEngine::Compute)) {
+          gpu()->RecordDispatchGpuTime(kernelName_, doorbell_, time.start * ticksToTime_,
+                                       time.end * ticksToTime_);
+          doorbell_ = 0;
+        }
+
         ClPrint(amd::LOG_INFO, amd::LOG_TS, "Signal = (0x%lx), Translated start/end = %ld / %ld, "
           "Elapsed = %ld ns, ticks start/end = %ld / %ld, Ticks elapsed = %ld", it->signal_.handle,
           time.start, time.end, time.end - time.start, amdSignal->start_ts, amdSignal->end_ts,
@@ -252,59 +275,78 @@ bool HsaAmdSignalHandler(hsa_signal_value_t value, void* arg) {
 
 // ================================================================================================
 bool VirtualGPU::MemoryDependency::create(size_t numMemObj) {
-  if (numMemObj > 0) {
-    // Allocate the array of memory objects for dependency tracking
-    memObjectsInQueue_ = new MemoryState[numMemObj];
-    if (nullptr == memObjectsInQueue_) {
-      return false;
+  // The number of tracked objects isn't limited, since the busy ranges are kept
+  // in the sorted index. GPU_NUM_MEM_DEPENDENCY = 0 still disables the tracking.
+  enabled_ = (numMemObj > 0);
+  if (enabled_) {
+    curKernel_.reserve(numMemObj);
+  }
+  return true;
+}
+
+// ================================================================================================
+void VirtualGPU::MemoryDependency::RangeIndex::insert(uint64_t start, uint64_t end) {
+  // Find the first range, which may overlap or touch the new one
+  auto it = ranges_.upper_bound(start);
+  if (it != ranges_.begin()) {
+    auto prev = std::prev(it);
+    if (prev->second >= start) {
+      it = prev;
     }
-    memset(memObjectsInQueue_, 0, sizeof(MemoryState) * numMemObj);
-    maxMemObjectsInQueue_ = numMemObj;
   }
+  // Merge all covered ranges into a single one
+  while ((it != ranges_.end()) && (it->first <= end)) {
+    start = std::min(start, it->first);
+    end = std::max(end, it->second);
+    it = ranges_.erase(it);
+  }
+  ranges_.emplace_hint(it, start, end);
+}
 
-  return true;
+// ================================================================================================
+bool VirtualGPU::MemoryDependency::RangeIndex::overlaps(uint64_t start, uint64_t end) const {
+  // The ranges don't overlap, hence only the last range with busy start below the end
+  // can cover the current range
+  auto it = ranges_.lower_bound(end);
+  if (it == ranges_.begin()) {
+    return false;
+  }
+  return std::prev(it)->second > start;
 }
 
 // ================================================================================================
-void VirtualGPU::MemoryDependency::validate(VirtualGPU& gpu, const Memory* memory, bool readOnly) {
-  bool flushL1Cache = false;
+void VirtualGPU::MemoryDependency::newKernel() {
+  // Move the objects of the last kernel into the busy ranges of the queue
+  for (const auto& it : curKernel_) {
+    accessed_.insert(it.start_, it.end_);
+    if (!it.readOnly_) {
+      written_.insert(it.start_, it.end_);
+    }
+  }
+  curKernel_.clear();
+}
 
-  if (maxMemObjectsInQueue_ == 0) {
+// ================================================================================================
+void VirtualGPU::MemoryDependency::validate(VirtualGPU& gpu, const Memory* memory, bool readOnly) {
+  if (!enabled_) {
     // Sync AQL packets
     gpu.setAqlHeader(gpu.dispatchPacketHeader_);
     return;
   }
 
   uint64_t curStart = reinterpret_cast<uint64_t>(memory->getDeviceMemory());
-  uint64_t curEnd = curStart + memory->size();
+  // Empty objects still occupy the start address for the dependency check
+  uint64_t curEnd = curStart + std::max<size_t>(memory->size(), 1);
 
-  // Loop through all memory objects in the queue and find dependency
+  // Check if the queue already contains this mem object and GPU operations aren't readonly.
+  // If the busy region was written, then any access requires a sync,
+  // otherwise the sync is required for a write only.
   // @note don't include objects from the current kernel
-  for (size_t j = 0; j < endMemObjectsInQueue_; ++j) {
-    // Check if the queue already contains this mem object and
-    // GPU operations aren't readonly
-    uint64_t busyStart = memObjectsInQueue_[j].start_;
-    uint64_t busyEnd = memObjectsInQueue_[j].end_;
-
-    // Check if the start inside the busy region
-    if ((((curStart >= busyStart) && (curStart < busyEnd)) ||
-         // Check if the end inside the busy region
-         ((curEnd > busyStart) && (curEnd <= busyEnd)) ||
-         // Check if the start/end cover the busy region
-         ((curStart <= busyStart) && (curEnd >= busyEnd))) &&
-        // If the buys region was written or the current one is for write
-        (!memObjectsInQueue_[j].readOnly_ || !readOnly)) {
-      flushL1Cache = true;
-      break;
-    }
-  }
-
-  // Did we reach the limit?
-  if (maxMemObjectsInQueue_ <= numMemObjectsInQueue_) {
-    flushL1Cache = true;
-  }
+  bool flushL1Cache = readOnly ? written_.overlaps(curStart, curEnd) :
+                                 accessed_.overlaps(curStart, curEnd);
 
   if (flushL1Cache) {
+    amd::Metrics::add(amd::Metrics::MemDependencyBarriers);
     // Sync AQL packets
     gpu.setAqlHeader(gpu.dispatchPacketHeader_);
 
@@ -316,45 +358,16 @@ void VirtualGPU::MemoryDependency::validate(VirtualGPU& gpu, const Memory* memor
   // Insert current memory object into the queue always,
   // since runtime calls flush before kernel execution and it has to keep
   // current kernel in tracking
-  memObjectsInQueue_[numMemObjectsInQueue_].start_ = curStart;
-  memObjectsInQueue_[numMemObjectsInQueue_].end_ = curEnd;
-  memObjectsInQueue_[numMemObjectsInQueue_].readOnly_ = readOnly;
-  numMemObjectsInQueue_++;
+  curKernel_.push_back({curStart, curEnd, readOnly});
 }
 
 // ================================================================================================
 void VirtualGPU::MemoryDependency::clear(bool all) {
-  if (numMemObjectsInQueue_ > 0) {
-    if (all) {
-      endMemObjectsInQueue_ = numMemObjectsInQueue_;
-    }
-
-    // If the current launch didn't start from the beginning, then move the data
-    if (0 != endMemObjectsInQueue_) {
-      // Preserve all objects from the current kernel
-      size_t i, j;
-      for (i = 0, j = endMemObjectsInQueue_; j < numMemObjectsInQueue_; i++, j++) {
-        memObjectsInQueue_[i].start_ = memObjectsInQueue_[j].start_;
-        memObjectsInQueue_[i].end_ = memObjectsInQueue_[j].end_;
-        memObjectsInQueue_[i].readOnly_ = memObjectsInQueue_[j].readOnly_;
-      }
-    } else if (numMemObjectsInQueue_ >= maxMemObjectsInQueue_) {
-      // note: The array growth shouldn't occur under the normal conditions,
-      // but in a case when SVM path sends the amount of SVM ptrs over
-      // the max size of kernel arguments
-      MemoryState* ptr  = new MemoryState[maxMemObjectsInQueue_ << 1];
-      if (nullptr == ptr) {
-        numMemObjectsInQueue_ = 0;
-        return;
-      }
-      maxMemObjectsInQueue_ <<= 1;
-      memcpy(ptr, memObjectsInQueue_, sizeof(MemoryState) * numMemObjectsInQueue_);
-      delete[] memObjectsInQueue_;
-      memObjectsInQueue_= ptr;
-    }
-
-    numMemObjectsInQueue_ -= endMemObjectsInQueue_;
-    endMemObjectsInQueue_ = 0;
+  // Release all objects from the previous kernels
+  accessed_.clear();
+  written_.clear();
+  if (all) {
+    curKernel_.clear();
   }
 }
 
@@ -366,21 +379,38 @@ VirtualGPU::HwQueueTracker::~HwQueueTracker() {
   }
 }
 
+// ================================================================================================
+bool VirtualGPU::HwQueueTracker::CreateSignal(ProfilingSignal* signal, bool interrupt) {
+  const Settings& settings = gpu_.dev().settings();
+  hsa_agent_t agent = gpu_.gpu_device();
+  hsa_agent_t* agents = &agent;
+  uint32_t num_agents = 1;
+  if (settings.system_scope_signal_) {
+    agents = nullptr;
+    num_agents = 0;
+  } else if (Device::getGpuAgents().size() > 1) {
+    // Other GPUs can wait for this queue with a barrier packet, hence they must be consumers
+    agents = const_cast<hsa_agent_t*>(Device::getGpuAgents().data());
+    num_agents = Device::getGpuAgents().size();
+  }
+  signal->dev_ = &gpu_.dev();
+  signal->flags_.interrupt_ = interrupt;
+  if (!interrupt) {
+    return (HSA_STATUS_SUCCESS == hsa_amd_signal_create(0, num_agents, agents,
+        HSA_AMD_SIGNAL_AMD_GPU_ONLY, &signal->signal_));
+  }
+  return (HSA_STATUS_SUCCESS == hsa_signal_create(0, num_agents, agents, &signal->signal_));
+}
+
 // ================================================================================================
 bool VirtualGPU::HwQueueTracker::Create() {
   uint kSignalListSize = ROC_SIGNAL_POOL_SIZE;
 
   signal_list_.resize(kSignalListSize);
 
-  hsa_agent_t agent = gpu_.gpu_device();
-  const Settings& settings = gpu_.dev().settings();
-  hsa_agent_t* agents = (settings.system_scope_signal_) ? nullptr : &agent;
-  uint32_t num_agents = (settings.system_scope_signal_) ? 0 : 1;
-
   for (uint i = 0; i < kSignalListSize; ++i) {
     std::unique_ptr<ProfilingSignal> signal(new ProfilingSignal());
-    if ((signal == nullptr) ||
-        (HSA_STATUS_SUCCESS != hsa_signal_create(0, num_agents, agents, &signal->signal_))) {
+    if ((signal == nullptr) || !CreateSignal(signal.get())) {
       return false;
     }
     signal_list_[i] = signal.release();
@@ -395,16 +425,13 @@ hsa_signal_t VirtualGPU::HwQueueTracker::ActiveSignal(
 
   // Peep signal +2 ahead to see if its done
   auto temp_id = (current_id_ + 2) % signal_list_.size();
-  // If GPU is still busy with processing, then add more signals to avoid more frequent stalls
+  // If GPU is still busy with processing, then add more signals to avoid more frequent stalls.
+  // The initial pool keeps the interrupt signals for the host waits. The signals of a deep
+  // pipeline are mostly GPU waited, hence the extra ones don't take the limited KFD events
   if (hsa_signal_load_relaxed(signal_list_[temp_id]->signal_) > 0) {
     std::unique_ptr<ProfilingSignal> signal(new ProfilingSignal());
     if (signal != nullptr) {
-      hsa_agent_t agent = gpu_.gpu_device();
-      const Settings& settings = gpu_.dev().settings();
-      hsa_agent_t* agents = (settings.system_scope_signal_) ? nullptr : &agent;
-      uint32_t num_agents = (settings.system_scope_signal_) ? 0 : 1;
-
-      if (HSA_STATUS_SUCCESS == hsa_signal_create(0, num_agents, agents, &signal->signal_)) {
+      if (CreateSignal(signal.get(), false)) {
         // Find valid new index
         ++current_id_ %= signal_list_.size();
         // Insert the new signal into the current slot and ignore any wait
@@ -420,25 +447,37 @@ hsa_signal_t VirtualGPU::HwQueueTracker::ActiveSignal(
     // Find valid index
     ++current_id_ %= signal_list_.size();
 
+    const bool busy = hsa_signal_load_relaxed(signal_list_[current_id_]->signal_) > 0;
+    const uint64_t start = busy ? amd::Os::timeNanos() : 0;
+
     // Make sure the previous operation on the current signal is done
     WaitCurrent();
 
     // Have to wait the next signal in the queue to avoid a race condition between
     // a GPU waiter(which may be not triggered yet) and CPU signal reset below
     WaitNext();
+
+    if (busy) {
+      // The pool is exhausted, since the signal creation failed or the GPU is behind
+      amd::Metrics::add(amd::Metrics::SignalPoolWaits);
+      amd::Metrics::record(amd::Metrics::SignalPoolWaitTime, amd::Os::timeNanos() - start);
+    }
   }
 
-  if (signal_list_[current_id_]->referenceCount() > 1) {
+  // The async handler of a callback or a batch waits for the signal on the host
+  const bool enqueHandler = AMD_DIRECT_DISPATCH && (ts != nullptr) &&
+      ((ts->command().Callback() != nullptr) || (ts->command().GetBatchHead() != nullptr)) &&
+      !ts->command().CpuWaitRequested();
+  // The signal of a marker becomes the HW event of the command, which the host can wait for
+  const bool hostWait = enqueHandler ||
+      (AMD_DIRECT_DISPATCH && (ts != nullptr) && ts->command().profilingInfo().marker_ts_);
+  if ((signal_list_[current_id_]->referenceCount() > 1) ||
+      (hostWait && !signal_list_[current_id_]->flags_.interrupt_)) {
     // The signal was assigned to the global marker's event, hence runtime can't reuse it
-    // and needs a new signal
+    // and needs a new signal. The host waits also need an interrupt signal
     std::unique_ptr<ProfilingSignal> signal(new ProfilingSignal());
     if (signal != nullptr) {
-      hsa_agent_t agent = gpu_.gpu_device();
-      const Settings& settings = gpu_.dev().settings();
-      hsa_agent_t* agents = (settings.system_scope_signal_) ? nullptr : &agent;
-      uint32_t num_agents = (settings.system_scope_signal_) ? 0 : 1;
-
-      if (HSA_STATUS_SUCCESS == hsa_signal_create(0, num_agents, agents, &signal->signal_)) {
+      if (CreateSignal(signal.get())) {
         signal_list_[current_id_]->release();
         signal_list_[current_id_] = signal.release();
       } else {
@@ -461,10 +500,6 @@ hsa_signal_t VirtualGPU::HwQueueTracker::ActiveSignal(
     prof_signal->ts_ = ts;
     ts->AddProfilingSignal(prof_signal);
     if (AMD_DIRECT_DISPATCH) {
-      bool enqueHandler = false;
-      enqueHandler = (ts->command().Callback() != nullptr ||
-                      ts->command().GetBatchHead() != nullptr )  &&
-                      !ts->command().CpuWaitRequested();
       // If direct dispatch is enabled and the batch head isn't null, then it's a marker and
       // requires the batch update upon HSA signal completion
       if (enqueHandler) {
@@ -545,6 +580,12 @@ std::vector<hsa_signal_t>& VirtualGPU::HwQueueTracker::WaitingSignal(HwQueueEngi
   for (uint32_t i = 0; i < external_signals_.size(); ++i) {
     // Early signal status check
     if (hsa_signal_load_relaxed(external_signals_[i]->signal_) > 0) {
+      if ((external_signals_[i]->dev_ != nullptr) && (external_signals_[i]->dev_ != &gpu_.dev())) {
+        // Another GPU signals the dependency. Always wait with a barrier on this queue,
+        // since a host wait would stall the submitting thread behind the other device
+        waiting_signals_.push_back(external_signals_[i]->signal_);
+        continue;
+      }
       const Settings& settings = gpu_.dev().settings();
       // Actively wait on CPU to avoid extra overheads of signal tracking on GPU.
       // For small copies set forced wait
@@ -568,6 +609,8 @@ std::vector<hsa_signal_t>& VirtualGPU::HwQueueTracker::WaitingSignal(HwQueueEngi
 
 // ================================================================================================
 bool VirtualGPU::HwQueueTracker::CpuWaitForSignal(ProfilingSignal* signal) {
+  // The HW can't make progress on the packets with a deferred doorbell
+  gpu_.RingDeferredDoorbell();
   // Wait for the current signal
   if (signal->ts_ != nullptr) {
     // Update timestamp values if requested
@@ -579,7 +622,7 @@ bool VirtualGPU::HwQueueTracker::CpuWaitForSignal(ProfilingSignal* signal) {
     amd::ScopedLock lock(signal->LockSignalOps());
     ClPrint(amd::LOG_DEBUG, amd::LOG_COPY, "Host wait on completion_signal=0x%zx",
             signal->signal_.handle);
-    if (!WaitForSignal(signal->signal_, gpu_.ActiveWait())) {
+    if (!gpu_.WaitForSignalWithPolicy(signal->signal_)) {
       LogPrintfError("Failed signal [0x%lx] wait", signal->signal_);
       return false;
     }
@@ -604,7 +647,7 @@ bool VirtualGPU::processMemObjects(const amd::Kernel& kernel, const_address para
   const amd::KernelSignature& signature = kernel.signature();
   const amd::KernelParameters& kernelParams = kernel.parameters();
 
-  if (!cooperativeGroups && memoryDependency().maxMemObjectsInQueue() != 0) {
+  if (!cooperativeGroups && memoryDependency().enabled()) {
     // AQL packets
     setAqlHeader(dispatchPacketHeaderNoSync_);
   }
@@ -654,6 +697,11 @@ bool VirtualGPU::processMemObjects(const amd::Kernel& kernel, const_address para
   size_t execInfoOffset = kernelParams.getExecInfoOffset();
   bool sync = true;
 
+  // Managed memory, allocated with hipMallocManaged()
+  constexpr cl_mem_flags kManagedMemory = CL_MEM_SVM_FINE_GRAIN_BUFFER | CL_MEM_ALLOC_HOST_PTR;
+  const bool hmmAutoMigrate = dev().info().hmmSupported_ &&
+      ((dev().settings().hmmFlags_ & Settings::Hmm::EnableAutoMigration) != 0);
+
   amd::Memory* memory = nullptr;
   // get svm non arugment information
   void* const* svmPtrArray = reinterpret_cast<void* const*>(params + execInfoOffset);
@@ -671,6 +719,9 @@ bool VirtualGPU::processMemObjects(const amd::Kernel& kernel, const_address para
         continue;
       }
     } else {
+      if (ROC_P2P_LAZY_ACCESS && !validatePeerAccess(*memory)) {
+        return false;
+      }
       Memory* rocMemory = static_cast<Memory*>(memory->getDeviceMemory(dev()));
       if (nullptr != rocMemory) {
         // Synchronize data with other memory instances if necessary
@@ -727,6 +778,9 @@ bool VirtualGPU::processMemObjects(const amd::Kernel& kernel, const_address para
           }
         }
         else {
+          if (ROC_P2P_LAZY_ACCESS && !validatePeerAccess(*mem)) {
+            return false;
+          }
           gpuMem = static_cast<Memory*>(mem->getDeviceMemory(dev()));
 
           const void* globalAddress = *reinterpret_cast<const void* const*>(params + desc.offset_);
@@ -752,6 +806,10 @@ bool VirtualGPU::processMemObjects(const amd::Kernel& kernel, const_address para
             mem->signalWrite(&dev());
           }
 
+          if (hmmAutoMigrate && ((mem->getMemFlags() & kManagedMemory) == kManagedMemory)) {
+            applyHmmPolicy(*mem, readOnly);
+          }
+
           if (desc.info_.oclObject_ == amd::KernelParameterDescriptor::ImageObject) {
             Image* image = static_cast<Image*>(mem->getDeviceMemory(dev()));
 
@@ -834,11 +892,262 @@ bool VirtualGPU::processMemObjects(const amd::Kernel& kernel, const_address para
   return true;
 }
 
+// ================================================================================================
+bool VirtualGPU::validatePeerAccess(amd::Memory& mem) {
+  const std::vector<amd::Device*>& devices = mem.getContext().devices();
+  if (mem.isArena() || (devices.size() != 1) || (devices[0] == &dev())) {
+    return true;
+  }
+  // The memory belongs to a peer device, which didn't map it for the peers at allocation
+  device::Memory* peerMem = mem.getDeviceMemory(*devices[0]);
+  if ((peerMem == nullptr) || peerMem->getAllowedPeerAccess()) {
+    return true;
+  }
+  void* ptr = reinterpret_cast<void*>(peerMem->originalDeviceAddress());
+  if (!devices[0]->deviceAllowAccess(ptr)) {
+    return false;
+  }
+  peerMem->setAllowedPeerAccess(true);
+  ClPrint(amd::LOG_INFO, amd::LOG_MEM, "Lazy peer access for %p on the first kernel use", ptr);
+  return true;
+}
+
+// ================================================================================================
+void VirtualGPU::applyHmmPolicy(const amd::Memory& mem, bool readOnly) {
+  const HmmAccessTracker::Action action = Device::hmmTracker().record(&mem, dev().index(),
+      readOnly, ROC_HMM_MIGRATE_THRESHOLD);
+  switch (action) {
+    case HmmAccessTracker::Action::Migrate: {
+      // Migrate the whole allocation before the dispatch, instead of the page faults in the kernel
+      auto wait_events = Barriers().WaitingSignal(HwQueueEngine::Unknown);
+      hsa_signal_t active = Barriers().ActiveSignal();
+      hsa_status_t status = hsa_amd_svm_prefetch_async(mem.getSvmPtr(), mem.getSize(),
+          dev().getBackendDevice(), wait_events.size(), wait_events.data(), active);
+      if ((status != HSA_STATUS_SUCCESS) || !Barriers().WaitCurrent()) {
+        Barriers().ResetCurrentSignal();
+        LogWarning("The automatic HMM migration failed");
+      }
+      addSystemScope();
+      ClPrint(amd::LOG_INFO, amd::LOG_MEM, "HMM migration of [%p-%p] to device %u",
+              mem.getSvmPtr(), reinterpret_cast<address>(mem.getSvmPtr()) + mem.getSize(),
+              dev().index());
+      break;
+    }
+    case HmmAccessTracker::Action::SetReadMostly:
+    case HmmAccessTracker::Action::UnsetReadMostly: {
+      const bool set = (action == HmmAccessTracker::Action::SetReadMostly);
+      dev().SetSvmAttributes(mem.getSvmPtr(), mem.getSize(), set ?
+          amd::MemoryAdvice::SetReadMostly : amd::MemoryAdvice::UnsetReadMostly);
+      ClPrint(amd::LOG_INFO, amd::LOG_MEM, "HMM read mostly %s for [%p-%p]",
+              set ? "set" : "unset", mem.getSvmPtr(),
+              reinterpret_cast<address>(mem.getSvmPtr()) + mem.getSize());
+      break;
+    }
+    default:
+      break;
+  }
+}
+
 // ================================================================================================
 static inline void packet_store_release(uint32_t* packet, uint16_t header, uint16_t rest) {
   __atomic_store_n(packet, header | (rest << 16), __ATOMIC_RELEASE);
 }
 
+// ================================================================================================
+void VirtualGPU::PublishAqlPacket(uint64_t index, uint32_t* aql_loc, uint16_t header,
+                                  uint16_t rest) {
+  if (header != 0) {
+    packet_store_release(aql_loc, header, rest);
+  }
+  if (doorbell_batch_owner_ == std::this_thread::get_id()) {
+    // The doorbell will be rung once at the end of the batch
+    deferred_doorbell_ = index;
+    return;
+  }
+  if (coalesce_doorbell_) {
+    if (coalesced_packets_++ == 0) {
+      coalesce_start_ = amd::Os::timeNanos();
+    }
+    const uint32_t maxPackets = (ROC_DOORBELL_COALESCE_PACKETS > 1) ?
+        ROC_DOORBELL_COALESCE_PACKETS : kAdaptiveFlushPackets;
+    // Defer the doorbell until the packet or time threshold is reached
+    bool defer = (coalesced_packets_ < maxPackets) &&
+        ((amd::Os::timeNanos() - coalesce_start_) < ROC_DOORBELL_COALESCE_US * K);
+    if (defer && adaptive_flush_) {
+      // The CP fetched all exposed packets, so the GPU is about to go idle without the new ones
+      defer = exposed_packets_ > hsa_queue_load_read_index_relaxed(gpu_queue_);
+    }
+    if (defer) {
+      if ((coalesced_packets_ == 1) && !adaptive_flush_) {
+        // Direct dispatch may not submit or wait again, so expose the packets in the background
+        roc_device_.ScheduleDoorbellFlush(this);
+      }
+      deferred_doorbell_ = index;
+      return;
+    }
+  }
+  // A doorbell with the latest index exposes any deferred packets too
+  deferred_doorbell_ = index;
+  RingDeferredDoorbell();
+}
+
+// ================================================================================================
+bool VirtualGPU::WaitForSignalWithPolicy(hsa_signal_t signal) {
+  switch (wait_policy_) {
+    case amd::CommandQueue::WaitPolicy::Spin:
+      return WaitForSignal(signal, true);
+    case amd::CommandQueue::WaitPolicy::Blocking:
+      return WaitForSignalHybrid(signal, 0);
+    case amd::CommandQueue::WaitPolicy::Adaptive: {
+      // Spin a bit longer than the expected completion time, since the blocked wait
+      // requires an interrupt and a thread wake-up
+      uint64_t expected = expected_wait_.load(std::memory_order_relaxed);
+      uint64_t spin = std::min(expected + expected / 4 + kAdaptiveWaitMargin, kAdaptiveWaitMaxSpin);
+      uint64_t start = amd::Os::timeNanos();
+      bool result = WaitForSignalHybrid(signal, spin);
+      uint64_t elapsed = amd::Os::timeNanos() - start;
+      // Learn the completion time with an exponential moving average, clamping the outliers,
+      // so a single long wait doesn't switch the queue to the long spins
+      elapsed = std::min(elapsed, kAdaptiveWaitMaxSpin * 2);
+      expected_wait_.store((expected * (kAdaptiveWaitHistory - 1) + elapsed) /
+                           kAdaptiveWaitHistory, std::memory_order_relaxed);
+      return result;
+    }
+    case amd::CommandQueue::WaitPolicy::Default:
+    default:
+      return WaitForSignal(signal, ActiveWait());
+  }
+}
+
+// ================================================================================================
+void VirtualGPU::GetDispatchStats(device::DispatchStatsMap& stats) const {
+  amd::ScopedLock lock(dispatch_stats_lock_);
+  stats.clear();
+  stats.insert(dispatch_stats_.begin(), dispatch_stats_.end());
+}
+
+// ================================================================================================
+void VirtualGPU::GetIdleGapStats(device::IdleGapStats& stats) const {
+  amd::ScopedLock lock(dispatch_stats_lock_);
+  stats = idle_gaps_;
+}
+
+// ================================================================================================
+void VirtualGPU::RecordDispatchGpuTime(const std::string& name, uint64_t doorbell, uint64_t start,
+                                       uint64_t end) {
+  amd::ScopedLock lock(dispatch_stats_lock_);
+  auto& stats = dispatch_stats_[name];
+  // GPU and CPU time domains may drift slightly, hence ignore a start before the doorbell
+  stats.doorbellToStart_.add((start > doorbell) ? (start - doorbell) : 0);
+  stats.duration_.add((end > start) ? (end - start) : 0);
+
+  if (ROC_IDLE_GAP_STATS && (end > start)) {
+    // The timestamps may be processed out of order, hence a kernel, which started before
+    // the latest end, overlaps with the previous work and doesn't add a gap
+    if ((last_kernel_end_ != 0) && (start > last_kernel_end_)) {
+      idle_gaps_.gaps_.add(start - last_kernel_end_);
+      // A doorbell after the previous end means the GPU waited for the host submission
+      if (doorbell > last_kernel_end_) {
+        idle_gaps_.hostBound_++;
+        idle_gaps_.hostBoundTime_ += std::min(doorbell, start) - last_kernel_end_;
+      }
+    }
+    idle_gaps_.busyTime_ += end - std::max(start, std::min(end, last_kernel_end_));
+    last_kernel_end_ = std::max(last_kernel_end_, end);
+  }
+}
+
+// ================================================================================================
+void VirtualGPU::RecordPrintfBytes(const std::string& name, uint64_t bytes) {
+  amd::ScopedLock lock(dispatch_stats_lock_);
+  dispatch_stats_[name].printfBytes_ += bytes;
+}
+
+// ================================================================================================
+void VirtualGPU::RecordCounterSample(const std::string& name,
+                                     const std::vector<uint64_t>& values) {
+  amd::ScopedLock lock(dispatch_stats_lock_);
+  auto& stats = dispatch_stats_[name];
+  stats.counters_.resize(values.size(), 0);
+  for (size_t i = 0; i < values.size(); ++i) {
+    stats.counters_[i] += values[i];
+  }
+  ++stats.counterSamples_;
+}
+
+// ================================================================================================
+void VirtualGPU::AccountHostcalls() {
+  if (hostcall_buffer_ == nullptr) {
+    return;
+  }
+  const uint64_t packets = hostcall_buffer_->servedPackets();
+  const uint64_t time = hostcall_buffer_->listenerTime();
+  if (packets != hostcall_packets_) {
+    // Note: the kernels of a queue execute in order, but the HW queue and its hostcall buffer
+    // can be shared with other streams, hence the numbers are an approximation
+    amd::ScopedLock lock(dispatch_stats_lock_);
+    auto& stats = dispatch_stats_[hostcall_kernel_];
+    stats.hostcallPackets_ += packets - hostcall_packets_;
+    stats.hostcallTime_ += time - hostcall_time_;
+  }
+  hostcall_packets_ = packets;
+  hostcall_time_ = time;
+}
+
+// ================================================================================================
+void* VirtualGPU::getHostcallBuffer(bool coopGroups) {
+  // Most queues never launch a hostcall kernel, hence the device creates the buffer on demand.
+  // Keep it locally to avoid the queue pool search on every launch
+  void*& buffer = coopGroups ? coop_hostcall_buffer_ : queue_hostcall_buffer_;
+  if (buffer == nullptr) {
+    buffer = roc_device_.getOrCreateHostcallBuffer(gpu_queue_, coopGroups, cuMask_);
+  }
+  return buffer;
+}
+
+// ================================================================================================
+bool VirtualGPU::SetCUMask(const std::vector<uint32_t>& cuMask) {
+  // The queues without a custom mask are shared between the streams, hence can't be changed
+  if (cuMask_.empty() || cuMask.empty()) {
+    return false;
+  }
+  // The deferred dispatches must be exposed to CP with the old mask
+  RingDeferredDoorbell();
+  return roc_device_.setQueueCUMask(gpu_queue_, cuMask);
+}
+
+// ================================================================================================
+void VirtualGPU::BeginDoorbellBatch() {
+  if (doorbell_batch_depth_++ == 0) {
+    doorbell_batch_owner_ = std::this_thread::get_id();
+  }
+}
+
+// ================================================================================================
+void VirtualGPU::EndDoorbellBatch() {
+  assert(doorbell_batch_depth_ > 0 && "Unbalanced doorbell batch!");
+  if (--doorbell_batch_depth_ == 0) {
+    doorbell_batch_owner_ = std::thread::id();
+    RingDeferredDoorbell();
+  }
+}
+
+// ================================================================================================
+void VirtualGPU::RingDeferredDoorbell() {
+  if (deferred_doorbell_ != kNoDeferredDoorbell) {
+    if (hdp_flush_pending_) {
+      // A single HDP flush covers the kernargs of all coalesced dispatches
+      *dev().info().hdpMemFlushCntl = 1u;
+      auto kSentinel = *reinterpret_cast<volatile int*>(dev().info().hdpMemFlushCntl);
+      hdp_flush_pending_ = false;
+    }
+    hsa_signal_store_screlease(gpu_queue_->doorbell_signal, deferred_doorbell_);
+    exposed_packets_ = deferred_doorbell_ + 1;
+    deferred_doorbell_ = kNoDeferredDoorbell;
+    coalesced_packets_ = 0;
+  }
+}
+
 // ================================================================================================
 template <typename AqlPacket>
 bool VirtualGPU::dispatchGenericAqlPacket(
@@ -889,6 +1198,7 @@ bool VirtualGPU::dispatchGenericAqlPacket(
 
   // Make sure the slot is free for usage
   while ((index - hsa_queue_load_read_index_scacquire(gpu_queue_)) >= sw_queue_size) {
+    RingDeferredDoorbell();
     amd::Os::yield();
   }
 
@@ -904,9 +1214,7 @@ bool VirtualGPU::dispatchGenericAqlPacket(
 
   AqlPacket* aql_loc = &((AqlPacket*)(gpu_queue_->base_address))[index & queueMask];
   *aql_loc = *packet;
-  if (header != 0) {
-    packet_store_release(reinterpret_cast<uint32_t*>(aql_loc), header, rest);
-  }
+  PublishAqlPacket(index, reinterpret_cast<uint32_t*>(aql_loc), header, rest);
   ClPrint(amd::LOG_DEBUG, amd::LOG_AQL,
           "SWq=0x%zx, HWq=0x%zx, id=%d, Dispatch Header = "
           "0x%x (type=%d, barrier=%d, acquire=%d, release=%d), "
@@ -934,8 +1242,6 @@ bool VirtualGPU::dispatchGenericAqlPacket(
           reinterpret_cast<hsa_kernel_dispatch_packet_t*>(packet)->reserved2, read,
           index);
 
-  hsa_signal_store_screlease(gpu_queue_->doorbell_signal, index);
-
   // Mark the flag indicating if a dispatch is outstanding.
   // We are not waiting after every dispatch.
   hasPendingDispatch_ = true;
@@ -1023,7 +1329,8 @@ inline bool VirtualGPU::dispatchAqlPacket(
 // ================================================================================================
 bool VirtualGPU::dispatchCounterAqlPacket(hsa_ext_amd_aql_pm4_packet_t* packet,
                                           const uint32_t gfxVersion, bool blocking,
-                                          const hsa_ven_amd_aqlprofile_1_00_pfn_t* extApi) {
+                                          const hsa_ven_amd_aqlprofile_1_00_pfn_t* extApi,
+                                          bool barrier) {
 
 
   // PM4 IB packet submission is different between GFX8 and GFX9:
@@ -1033,7 +1340,8 @@ bool VirtualGPU::dispatchCounterAqlPacket(hsa_ext_amd_aql_pm4_packet_t* packet,
     case PerfCounter::ROC_GFX9:
     case PerfCounter::ROC_GFX10:
       {
-        packet->header = HSA_PACKET_TYPE_VENDOR_SPECIFIC << HSA_PACKET_HEADER_TYPE;
+        packet->header = (HSA_PACKET_TYPE_VENDOR_SPECIFIC << HSA_PACKET_HEADER_TYPE) |
+                         ((barrier ? 1 : 0) << HSA_PACKET_HEADER_BARRIER);
         return dispatchGenericAqlPacket(packet, 0, 0, blocking);
       }
       break;
@@ -1083,13 +1391,13 @@ void VirtualGPU::dispatchBarrierPacket(uint16_t packetHeader, bool skipSignal,
     addSystemScope_ = false;
   }
 
-  while ((index - hsa_queue_load_read_index_scacquire(gpu_queue_)) >= queueMask);
+  while ((index - hsa_queue_load_read_index_scacquire(gpu_queue_)) >= queueMask) {
+    RingDeferredDoorbell();
+  }
   hsa_barrier_and_packet_t* aql_loc =
     &(reinterpret_cast<hsa_barrier_and_packet_t*>(gpu_queue_->base_address))[index & queueMask];
   *aql_loc = barrier_packet_;
-  __atomic_store_n(reinterpret_cast<uint32_t*>(aql_loc), packetHeader, __ATOMIC_RELEASE);
-
-  hsa_signal_store_screlease(gpu_queue_->doorbell_signal, index);
+  PublishAqlPacket(index, reinterpret_cast<uint32_t*>(aql_loc), packetHeader, 0);
   ClPrint(amd::LOG_DEBUG, amd::LOG_AQL,
           "SWq=0x%zx, HWq=0x%zx, id=%d, BarrierAND Header = 0x%x (type=%d, barrier=%d, acquire=%d,"
           " release=%d), "
@@ -1161,13 +1469,13 @@ void VirtualGPU::dispatchBarrierValuePacket(uint16_t packetHeader, bool resolveD
   }
 
   uint64_t index = hsa_queue_add_write_index_screlease(gpu_queue_, 1);
-  while ((index - hsa_queue_load_read_index_scacquire(gpu_queue_)) >= queueMask);
+  while ((index - hsa_queue_load_read_index_scacquire(gpu_queue_)) >= queueMask) {
+    RingDeferredDoorbell();
+  }
   hsa_amd_barrier_value_packet_t* aql_loc = &(reinterpret_cast<hsa_amd_barrier_value_packet_t*>(
       gpu_queue_->base_address))[index & queueMask];
   *aql_loc = barrier_value_packet_;
-  packet_store_release(reinterpret_cast<uint32_t*>(aql_loc), packetHeader, rest);
-
-  hsa_signal_store_screlease(gpu_queue_->doorbell_signal, index);
+  PublishAqlPacket(index, reinterpret_cast<uint32_t*>(aql_loc), packetHeader, rest);
 
   ClPrint(amd::LOG_DEBUG, amd::LOG_AQL,
           "SWq=0x%zx, HWq=0x%zx, id=%d, BarrierValue Header = 0x%x AmdFormat = 0x%x "
@@ -1213,10 +1521,44 @@ bool VirtualGPU::releaseGpuMemoryFence(bool skip_cpu_wait) {
     Barriers().WaitCurrent();
 
     ResetQueueStates();
+
+    if (ROC_DISPATCH_STATS) {
+      AccountHostcalls();
+    }
+
+    // All sampled dispatches are complete, hence the counter results are valid
+    if (counter_sampler_ != nullptr) {
+      counter_sampler_->collect();
+    }
+
+    // Make sure the printf output of the finished kernels is visible after the wait
+    if (printfdbg_ != nullptr) {
+      printfdbg_->flush();
+    }
+
+    // A device assert or abort, which didn't trap the queue, leaves only the mailbox report
+    if ((error_mailbox_ != nullptr) &&
+        (__atomic_load_n(&error_mailbox_->status_, __ATOMIC_ACQUIRE) != 0)) {
+      roc_device_.ReportQueueError(gpu_queue_);
+      abort();
+    }
   }
   return true;
 }
 
+// ================================================================================================
+void VirtualGPU::signalGpuMemoryFence(hsa_signal_t signal) {
+  dispatchBarrierPacket(kBarrierPacketHeader, false, signal);
+  // The signal can be waited on another thread, hence don't keep the doorbell deferred
+  RingDeferredDoorbell();
+}
+
+// ================================================================================================
+bool VirtualGPU::isIdle() {
+  return !hasPendingDispatch_ && Barriers().IsExternalSignalListEmpty() &&
+         (hsa_signal_load_relaxed(Barriers().GetLastSignal()->signal_) == 0);
+}
+
 // ================================================================================================
 VirtualGPU::VirtualGPU(Device& device, bool profiling, bool cooperative,
                        const std::vector<uint32_t>& cuMask,
@@ -1232,6 +1574,7 @@ VirtualGPU::VirtualGPU(Device& device, bool profiling, bool cooperative,
       schedulerParam_(nullptr),
       schedulerQueue_(nullptr),
       schedulerSignal_({0}),
+      schedulerPending_(false),
       barriers_(*this),
       kernarg_pool_signal_(KernelArgPoolNumSignal),
       managed_buffer_(*this, ManagedBuffer::kPoolNumSignals * device.settings().stagedXferSize_),
@@ -1254,6 +1597,7 @@ VirtualGPU::VirtualGPU(Device& device, bool profiling, bool cooperative,
 
   kernarg_pool_base_ = nullptr;
   kernarg_pool_size_ = 0;
+  kernarg_pool_init_size_ = 0;
   kernarg_pool_cur_offset_ = 0;
 
   if (device.settings().fenceScopeAgent_) {
@@ -1288,8 +1632,73 @@ VirtualGPU::VirtualGPU(Device& device, bool profiling, bool cooperative,
 
 // ================================================================================================
 VirtualGPU::~VirtualGPU() {
+  roc_device_.CancelDoorbellFlush(this);
+  if (counter_sampler_ != nullptr) {
+    releaseGpuMemoryFence();
+  }
+  if (ROC_DISPATCH_STATS_DUMP || ROC_IDLE_GAP_STATS || (counter_sampler_ != nullptr)) {
+    if (printfdbg_ != nullptr) {
+      printfdbg_->flush();
+    }
+    AccountHostcalls();
+    amd::ScopedLock lock(dispatch_stats_lock_);
+    for (const auto& it : dispatch_stats_) {
+      const device::LatencyHistogram* histograms[] = {
+          &it.second.enqueueToDoorbell_, &it.second.doorbellToStart_, &it.second.duration_};
+      const char* names[] = {"enqueue-to-doorbell", "doorbell-to-start", "duration"};
+      for (uint i = 0; i < 3; ++i) {
+        const auto& h = *histograms[i];
+        if (h.count_ != 0) {
+          ClPrint(amd::LOG_NONE, amd::LOG_ALWAYS, "HWq=0x%zx, kernel %s, %s: count %lu, "
+                  "avg %lu ns, min %lu ns, p50 %lu ns, p99 %lu ns, max %lu ns",
+                  gpu_queue_, it.first.c_str(), names[i], h.count_, h.sum_ / h.count_, h.min_,
+                  h.percentile(50), h.percentile(99), h.max_);
+        }
+      }
+      if ((it.second.hostcallPackets_ != 0) || (it.second.printfBytes_ != 0)) {
+        ClPrint(amd::LOG_NONE, amd::LOG_ALWAYS, "HWq=0x%zx, kernel %s, hostcall: packets %lu, "
+                "listener %lu ns, printf %lu bytes", gpu_queue_, it.first.c_str(),
+                it.second.hostcallPackets_, it.second.hostcallTime_, it.second.printfBytes_);
+      }
+      if (it.second.counterSamples_ != 0) {
+        std::string values;
+        const auto& names = counter_sampler_->names();
+        for (size_t i = 0; i < it.second.counters_.size(); ++i) {
+          values += " " + names[i] + "=" +
+              std::to_string(it.second.counters_[i] / it.second.counterSamples_);
+        }
+        ClPrint(amd::LOG_NONE, amd::LOG_ALWAYS, "HWq=0x%zx, kernel %s, counters: samples %lu, "
+                "avg%s", gpu_queue_, it.first.c_str(), it.second.counterSamples_,
+                values.c_str());
+      }
+    }
+    const auto& gaps = idle_gaps_.gaps_;
+    if (ROC_IDLE_GAP_STATS && (gaps.count_ != 0)) {
+      const uint64_t idle = gaps.sum_;
+      ClPrint(amd::LOG_NONE, amd::LOG_ALWAYS, "HWq=0x%zx, idle gaps: count %lu, avg %lu ns, "
+              "p50 %lu ns, p99 %lu ns, max %lu ns, busy %lu%%, host bound %lu gaps (%lu%% of "
+              "the idle time)", gpu_queue_, gaps.count_, idle / gaps.count_,
+              gaps.percentile(50), gaps.percentile(99), gaps.max_,
+              (idle_gaps_.busyTime_ * 100) / (idle_gaps_.busyTime_ + idle),
+              idle_gaps_.hostBound_, (idle != 0) ? (idle_gaps_.hostBoundTime_ * 100) / idle : 0);
+    }
+    if ((counter_sampler_ != nullptr) && (counter_sampler_->skipped() != 0)) {
+      ClPrint(amd::LOG_NONE, amd::LOG_ALWAYS, "HWq=0x%zx, counters: %lu dispatches weren't "
+              "sampled, since the queue had too many samples in flight", gpu_queue_,
+              counter_sampler_->skipped());
+    }
+  }
+  delete counter_sampler_;
+  counter_sampler_ = nullptr;
+
   delete blitMgr_;
 
+  if (xfer_buffer_ != nullptr) {
+    // Return the cached staging buffer to the device pool
+    roc_device_.xferRead().release(*xfer_buffer_);
+    xfer_buffer_ = nullptr;
+  }
+
   if (tracking_created_) {
     // Release the resources of signal
     releaseGpuMemoryFence();
@@ -1308,6 +1717,7 @@ VirtualGPU::~VirtualGPU() {
   delete printfdbg_;
 
   if (0 != schedulerSignal_.handle) {
+    waitScheduler();
     hsa_signal_destroy(schedulerSignal_);
   }
 
@@ -1344,11 +1754,26 @@ bool VirtualGPU::create() {
   gpu_queue_ = roc_device_.acquireQueue(queue_size, cooperative_, cuMask_, priority_);
   if (!gpu_queue_) return false;
 
+  error_mailbox_ = roc_device_.QueueErrorMailbox(gpu_queue_);
+  coalesce_doorbell_ = AMD_DIRECT_DISPATCH && (ROC_DOORBELL_COALESCE_PACKETS > 1);
+  // The queue thread rings the deferred doorbell before it sleeps, so the adaptive policy
+  // never leaves packets behind without more work. Direct dispatch has no such point.
+  adaptive_flush_ = !AMD_DIRECT_DISPATCH && ROC_ADAPTIVE_FLUSH;
+  coalesce_doorbell_ |= adaptive_flush_;
+
   if (!initPool(dev().settings().kernargPoolSize_)) {
     LogError("Couldn't allocate arguments/signals for the queue");
     return false;
   }
 
+  if (ROC_KERNEL_COUNTERS[0] != '\0') {
+    counter_sampler_ = new KernelCounterSampler(*this);
+    if (!counter_sampler_->create()) {
+      delete counter_sampler_;
+      counter_sampler_ = nullptr;
+    }
+  }
+
   device::BlitManager::Setup blitSetup;
   blitMgr_ = new KernelBlitManager(*this, blitSetup);
   if ((nullptr == blitMgr_) || !blitMgr_->create(roc_device_)) {
@@ -1361,13 +1786,6 @@ bool VirtualGPU::create() {
   barrier_packet_.header = kInvalidAql;
   barrier_value_packet_.header.header = kInvalidAql;
 
-  // Create a object of PrintfDbg
-  printfdbg_ = new PrintfDbg(roc_device_);
-  if (nullptr == printfdbg_) {
-    LogError("\nCould not create printfDbg Object!");
-    return false;
-  }
-
   // Initialize timestamp conversion factor
   if (Timestamp::getGpuTicksToTime() == 0) {
     uint64_t frequency;
@@ -1444,6 +1862,7 @@ address VirtualGPU::ManagedBuffer::Acquire(uint32_t size) {
     // Get the next chunk
     active_chunk_ = ++active_chunk_ % kPoolNumSignals;
     // Make sure the new active chunk is free
+    gpu_.RingDeferredDoorbell();
     bool test = WaitForSignal(pool_signal_[active_chunk_], gpu_.ActiveWait());
     assert(test && "Runtime can't fail a wait for chunk!");
     // Make sure the current offset matches the new chunk to avoid possible overlaps
@@ -1458,23 +1877,30 @@ address VirtualGPU::ManagedBuffer::Acquire(uint32_t size) {
 }
 
 // ================================================================================================
-bool VirtualGPU::initPool(size_t kernarg_pool_size) {
-  kernarg_pool_size_ = kernarg_pool_size;
-  kernarg_pool_chunk_end_ = kernarg_pool_size_ / KernelArgPoolNumSignal;
-  active_chunk_ = 0;
+address VirtualGPU::allocKernArgPoolMemory(size_t size) {
+  address base = nullptr;
   if ((dev().settings().kernel_arg_impl_ != KernelArgImpl::HostKernelArgs) &&
       roc_device_.info().largeBar_) {
-    kernarg_pool_base_ =
-      reinterpret_cast<address>(roc_device_.deviceLocalAlloc(kernarg_pool_size_));
-    if (kernarg_pool_base_ != nullptr) {
+    base = reinterpret_cast<address>(roc_device_.deviceLocalAlloc(size));
+    if (base != nullptr) {
       // @note Workaround first access penalty.
       // KFD may update CPU page tables on the first CPU access
-      *kernarg_pool_base_ = 0;
+      *base = 0;
     }
   } else {
-    kernarg_pool_base_ = reinterpret_cast<address>(roc_device_.hostAlloc(kernarg_pool_size_, 0,
-                                                   Device::MemorySegment::kKernArg));
+    base = reinterpret_cast<address>(roc_device_.hostAlloc(size, 0,
+                                     Device::MemorySegment::kKernArg));
   }
+  return base;
+}
+
+// ================================================================================================
+bool VirtualGPU::initPool(size_t kernarg_pool_size) {
+  kernarg_pool_size_ = kernarg_pool_size;
+  kernarg_pool_init_size_ = kernarg_pool_size;
+  kernarg_pool_chunk_end_ = kernarg_pool_size_ / KernelArgPoolNumSignal;
+  active_chunk_ = 0;
+  kernarg_pool_base_ = allocKernArgPoolMemory(kernarg_pool_size_);
   if (kernarg_pool_base_ == nullptr) {
     return false;
   }
@@ -1489,6 +1915,12 @@ bool VirtualGPU::initPool(size_t kernarg_pool_size) {
 
 // ================================================================================================
 void VirtualGPU::destroyPool() {
+  ClPrint(amd::LOG_INFO, amd::LOG_KERN, "Kernarg pool stats: size %u, wraps %lu, forced syncs %lu,"
+          " grows %lu, shrinks %lu", kernarg_pool_size_, kernarg_pool_stats_.wraps_,
+          kernarg_pool_stats_.forcedSyncs_, kernarg_pool_stats_.grows_,
+          kernarg_pool_stats_.shrinks_);
+  constexpr bool kIdle = true;
+  releaseRetiredKernArgPools(kIdle);
   for (auto& it : kernarg_pool_signal_) {
     if (it.handle != 0) {
       hsa_signal_destroy(it);
@@ -1499,6 +1931,98 @@ void VirtualGPU::destroyPool() {
   }
 }
 
+// ================================================================================================
+void VirtualGPU::resetKernArgPool() {
+  constexpr bool kIdle = true;
+  releaseRetiredKernArgPools(kIdle);
+
+  // Return to the initial size if a grown pool stays mostly unused for a while
+  constexpr uint32_t kKernArgPoolShrinkResets = 256;
+  if (kernarg_pool_size_ > kernarg_pool_init_size_) {
+    if (!kernarg_pool_wrapped_ &&
+        (kernarg_pool_cur_offset_ <= kernarg_pool_init_size_ / KernelArgPoolNumSignal)) {
+      ++kernarg_pool_idle_resets_;
+    } else {
+      kernarg_pool_idle_resets_ = 0;
+    }
+    if (kernarg_pool_idle_resets_ >= kKernArgPoolShrinkResets) {
+      address base = allocKernArgPoolMemory(kernarg_pool_init_size_);
+      if (base != nullptr) {
+        ClPrint(amd::LOG_INFO, amd::LOG_KERN, "Shrink kernarg pool from %u to %u bytes",
+                kernarg_pool_size_, kernarg_pool_init_size_);
+        roc_device_.hostFree(kernarg_pool_base_, kernarg_pool_size_);
+        kernarg_pool_base_ = base;
+        kernarg_pool_size_ = kernarg_pool_init_size_;
+        kernarg_pool_stats_.shrinks_++;
+      }
+      kernarg_pool_idle_resets_ = 0;
+    }
+  }
+
+  kernarg_pool_wrapped_ = false;
+  kernarg_pool_cur_offset_ = 0;
+  kernarg_pool_chunk_end_ = kernarg_pool_size_ / KernelArgPoolNumSignal;
+  active_chunk_ = 0;
+}
+
+// ================================================================================================
+bool VirtualGPU::growKernArgPool() {
+  uint64_t new_size = static_cast<uint64_t>(kernarg_pool_size_) * 2;
+  if (new_size > ROC_KERNARG_POOL_MAX_SIZE) {
+    return false;
+  }
+  address base = allocKernArgPoolMemory(new_size);
+  if (base == nullptr) {
+    return false;
+  }
+  // The chunk signals of the old pool are still in flight, hence the new pool needs new signals
+  std::vector<hsa_signal_t> signals(KernelArgPoolNumSignal);
+  hsa_agent_t agent = gpu_device();
+  for (auto& it : signals) {
+    if (HSA_STATUS_SUCCESS != hsa_signal_create(0, 1, &agent, &it)) {
+      for (auto& sig : signals) {
+        if (sig.handle != 0) {
+          hsa_signal_destroy(sig);
+        }
+      }
+      roc_device_.hostFree(base, new_size);
+      return false;
+    }
+  }
+  ClPrint(amd::LOG_INFO, amd::LOG_KERN, "Grow kernarg pool from %u to %lu bytes",
+          kernarg_pool_size_, new_size);
+
+  kernarg_retired_pools_.push_back({kernarg_pool_base_, kernarg_pool_size_,
+                                    std::move(kernarg_pool_signal_)});
+  kernarg_pool_signal_ = std::move(signals);
+  kernarg_pool_base_ = base;
+  kernarg_pool_size_ = static_cast<uint32_t>(new_size);
+  kernarg_pool_cur_offset_ = 0;
+  kernarg_pool_chunk_end_ = kernarg_pool_size_ / KernelArgPoolNumSignal;
+  active_chunk_ = 0;
+  kernarg_pool_idle_resets_ = 0;
+  kernarg_pool_stats_.grows_++;
+  return true;
+}
+
+// ================================================================================================
+void VirtualGPU::releaseRetiredKernArgPools(bool idle) {
+  for (auto it = kernarg_retired_pools_.begin(); it != kernarg_retired_pools_.end();) {
+    // The pool is free when the barriers for all chunks are done
+    bool done = idle || std::all_of(it->signals_.begin(), it->signals_.end(),
+        [](hsa_signal_t signal) { return hsa_signal_load_relaxed(signal) <= 0; });
+    if (done) {
+      for (auto& signal : it->signals_) {
+        hsa_signal_destroy(signal);
+      }
+      roc_device_.hostFree(it->base_, it->size_);
+      it = kernarg_retired_pools_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 // ================================================================================================
 void* VirtualGPU::allocKernArg(size_t size, size_t alignment) {
   assert(alignment != 0);
@@ -1516,9 +2040,25 @@ void* VirtualGPU::allocKernArg(size_t size, size_t alignment) {
             active_chunk_);
     // Dispatch a barrier packet into the queue
     dispatchBarrierPacket(kBarrierPacketHeader, true, kernarg_pool_signal_[active_chunk_]);
+    kernarg_pool_stats_.wraps_++;
+    amd::Metrics::add(amd::Metrics::KernArgPoolWraps);
+    kernarg_pool_wrapped_ = true;
+    releaseRetiredKernArgPools(false);
     // Get the next chunk
     active_chunk_ = ++active_chunk_ % KernelArgPoolNumSignal;
+    if (hsa_signal_load_relaxed(kernarg_pool_signal_[active_chunk_]) > 0) {
+      // The HW still uses the next chunk. Switch to a bigger pool instead of a stall
+      if ((size + alignment <= kernarg_pool_size_ * 2 / KernelArgPoolNumSignal) &&
+          growKernArgPool()) {
+        result = amd::alignUp(kernarg_pool_base_, alignment);
+        kernarg_pool_cur_offset_ = (result + size) - kernarg_pool_base_;
+        return result;
+      }
+      kernarg_pool_stats_.forcedSyncs_++;
+      amd::Metrics::add(amd::Metrics::KernArgPoolForcedSyncs);
+    }
     // Make sure the new active chunk is free
+    RingDeferredDoorbell();
     bool test = WaitForSignal(kernarg_pool_signal_[active_chunk_], ActiveWait());
     assert(test && "Runtime can't fail a wait for chunk!");
     // Make sure the current offset matches the new chunk to avoid possible overlaps
@@ -1625,6 +2165,11 @@ void VirtualGPU::updateCommandsState(amd::Command* list) const {
   uint64_t endTimeStamp = 0;
   uint64_t startTimeStamp = endTimeStamp;
 
+  // CL_RUNNING is observable only through the profiling data, the status callbacks and the
+  // agent events. The other commands of the batch go straight to CL_COMPLETE, which halves
+  // the status transitions on large flushes.
+  const bool postEvents = amd::Agent::shouldPostEventEvents();
+
   if (current->profilingInfo().enabled_) {
     // TODO: use GPU timestamp when available.
     endTimeStamp = amd::Os::timeNanos();
@@ -1678,7 +2223,9 @@ void VirtualGPU::updateCommandsState(amd::Command* list) const {
     }
 
     if (current->status() == CL_SUBMITTED) {
-      current->setStatus(CL_RUNNING, startTimeStamp);
+      if (current->profilingInfo().enabled_ || (current->Callback() != nullptr) || postEvents) {
+        current->setStatus(CL_RUNNING, startTimeStamp);
+      }
       current->setStatus(CL_COMPLETE, endTimeStamp);
     } else if (current->status() != CL_COMPLETE) {
       LogPrintfError("Unexpected command status - %d.", current->status());
@@ -1919,19 +2466,26 @@ void VirtualGPU::submitSvmPrefetchAsync(amd::SvmPrefetchAsyncCommand& cmd) {
   profilingBegin(cmd);
 
   if (dev().info().hmmSupported_) {
-    // Initialize signal for the barrier
-    auto wait_events = Barriers().WaitingSignal(HwQueueEngine::Unknown);
-    hsa_signal_t active = Barriers().ActiveSignal(kInitSignalValueOne, timestamp_);
-
     // Find the requested agent for the transfer
     hsa_agent_t agent = (cmd.cpu_access() ||
         (dev().settings().hmmFlags_ & Settings::Hmm::EnableSystemMemory)) ?
         dev().getCpuAgent() : (static_cast<const roc::Device*>(cmd.device()))->getBackendDevice();
 
-    // Initiate a prefetch command
-    hsa_status_t status = hsa_amd_svm_prefetch_async(
-        const_cast<void*>(cmd.dev_ptr()), cmd.count(), agent,
-        wait_events.size(), wait_events.data(), active);
+    hsa_status_t status = HSA_STATUS_SUCCESS;
+    for (const auto& range : cmd.ranges()) {
+      // Initialize signal for the barrier. Every range waits for the previous one, hence
+      // the last signal tracks the whole batch and the host waits only once.
+      auto wait_events = Barriers().WaitingSignal(HwQueueEngine::Unknown);
+      hsa_signal_t active = Barriers().ActiveSignal(kInitSignalValueOne, timestamp_);
+
+      // Initiate a prefetch command
+      status = hsa_amd_svm_prefetch_async(
+          const_cast<void*>(range.dev_ptr_), range.count_, agent,
+          wait_events.size(), wait_events.data(), active);
+      if (status != HSA_STATUS_SUCCESS) {
+        break;
+      }
+    }
 
     // Wait for the prefetch. Should skip wait, but may require extra tracking for kernel execution
     if ((status != HSA_STATUS_SUCCESS) || !Barriers().WaitCurrent()) {
@@ -2062,6 +2616,133 @@ void VirtualGPU::submitCopyMemory(amd::CopyMemoryCommand& cmd) {
   profilingEnd(cmd);
 }
 
+// ================================================================================================
+void VirtualGPU::submitCopyMemoryBatch(amd::CopyMemoryBatchCommand& cmd) {
+  // Make sure VirtualGPU has an exclusive access to the resources
+  amd::ScopedLock lock(execution());
+
+  profilingBegin(cmd, true);
+
+  std::vector<KernelBlitManager::BatchCopyDesc> descs;
+  descs.reserve(cmd.copies().size());
+  for (const auto& copy : cmd.copies()) {
+    Memory* src = dev().getRocMemory(copy.src_);
+    Memory* dst = dev().getRocMemory(copy.dst_);
+    descs.push_back({src->virtualAddress() + copy.srcOffset_,
+                     dst->virtualAddress() + copy.dstOffset_, copy.size_});
+    copy.dst_->signalWrite(&dev());
+  }
+
+  // The descriptors hide the memory objects from the dependency tracker,
+  // hence order the batch with barriers on both sides
+  bool tracking = memoryDependency().enabled();
+  if (tracking) {
+    releaseGpuMemoryFence(kSkipCpuWait);
+  }
+  if (!static_cast<KernelBlitManager&>(blitMgr()).copyBufferBatch(descs.data(), descs.size())) {
+    LogError("Batched copy failed!");
+    cmd.setStatus(CL_INVALID_OPERATION);
+  }
+  if (tracking) {
+    releaseGpuMemoryFence(kSkipCpuWait);
+    memoryDependency().clear();
+  }
+
+  profilingEnd(cmd);
+}
+
+// ================================================================================================
+void VirtualGPU::submitFillMemoryBatch(amd::FillMemoryBatchCommand& cmd) {
+  // Make sure VirtualGPU has an exclusive access to the resources
+  amd::ScopedLock lock(execution());
+
+  profilingBegin(cmd, true);
+
+  std::vector<KernelBlitManager::BatchFillDesc> descs;
+  descs.reserve(cmd.fills().size());
+  for (const auto& fill : cmd.fills()) {
+    Memory* dst = dev().getRocMemory(fill.dst_);
+    descs.push_back({dst->virtualAddress() + fill.offset_, fill.value_, fill.size_});
+    fill.dst_->signalWrite(&dev());
+  }
+
+  // The descriptors hide the memory objects from the dependency tracker,
+  // hence order the batch with barriers on both sides
+  bool tracking = memoryDependency().enabled();
+  if (tracking) {
+    releaseGpuMemoryFence(kSkipCpuWait);
+  }
+  if (!static_cast<KernelBlitManager&>(blitMgr()).fillBufferBatch(descs.data(), descs.size())) {
+    LogError("Batched fill failed!");
+    cmd.setStatus(CL_INVALID_OPERATION);
+  }
+  if (tracking) {
+    releaseGpuMemoryFence(kSkipCpuWait);
+    memoryDependency().clear();
+  }
+
+  profilingEnd(cmd);
+}
+
+// ================================================================================================
+void VirtualGPU::submitCopyFileToMemory(amd::CopyFileToMemoryCommand& cmd) {
+  // Make sure VirtualGPU has an exclusive access to the resources
+  amd::ScopedLock lock(execution());
+
+  profilingBegin(cmd, true);
+
+  Memory* devMem = dev().getRocMemory(&cmd.destination());
+
+  // Synchronize memory from host if necessary
+  device::Memory::SyncFlags syncFlags;
+  syncFlags.skipEntire_ = (cmd.offset() == 0) && (cmd.size() == cmd.destination().getSize());
+  devMem->syncCacheFromHost(*this, syncFlags);
+
+  if (!static_cast<DmaBlitManager&>(blitMgr()).writeBufferFromFile(
+          cmd.fileDesc(), cmd.fileOffset(), *devMem, cmd.offset(), cmd.size())) {
+    LogError("submitCopyFileToMemory failed!");
+    cmd.setStatus(CL_INVALID_OPERATION);
+  }
+
+  cmd.destination().signalWrite(&dev());
+
+  profilingEnd(cmd);
+}
+
+// ================================================================================================
+void VirtualGPU::submitGraphCondition(amd::GraphConditionCommand& cmd) {
+  // Make sure VirtualGPU has an exclusive access to the resources
+  amd::ScopedLock lock(execution());
+
+  profilingBegin(cmd, true);
+
+  // The blit waits for the body, hence the body on the same queue would never start
+  auto body = static_cast<VirtualGPU*>(cmd.bodyQueue().vdev());
+  if ((body == nullptr) || (body->gpu_queue_ == gpu_queue_)) {
+    LogError("Graph condition requires a separate HW queue for the body!");
+    cmd.setStatus(CL_INVALID_OPERATION);
+  } else {
+    // The body may access any memory, hence order the blit with barriers on both sides
+    bool tracking = memoryDependency().enabled();
+    if (tracking) {
+      releaseGpuMemoryFence(kSkipCpuWait);
+    }
+    if (!static_cast<KernelBlitManager&>(blitMgr()).graphCondition(
+            reinterpret_cast<uint64_t>(cmd.predicate()), reinterpret_cast<uint64_t>(cmd.packets()),
+            reinterpret_cast<uint64_t>(body->gpu_queue_),
+            reinterpret_cast<uint64_t>(cmd.signal()), cmd.loop())) {
+      LogError("Graph condition failed!");
+      cmd.setStatus(CL_INVALID_OPERATION);
+    }
+    if (tracking) {
+      releaseGpuMemoryFence(kSkipCpuWait);
+      memoryDependency().clear();
+    }
+  }
+
+  profilingEnd(cmd);
+}
+
 // ================================================================================================
 void VirtualGPU::submitSvmCopyMemory(amd::SvmCopyMemoryCommand& cmd) {
   // Make sure VirtualGPU has an exclusive access to the resources
@@ -2144,6 +2825,77 @@ void VirtualGPU::submitSvmCopyMemory(amd::SvmCopyMemoryCommand& cmd) {
   profilingEnd(cmd);
 }
 
+// ================================================================================================
+bool VirtualGPU::copyP2PRelay(const Memory& srcMem, const Memory& dstMem, size_t srcOffset,
+                              size_t dstOffset, size_t size, Device& relay) {
+  // Sync the current queue, since the relay copies run on the copy engines of the peers
+  releaseGpuMemoryFence();
+
+  amd::ScopedLock lock(relay.P2PRelayOps());
+  address stage = relay.P2PRelayBuffer();
+  // The relay copy engine writes the destination memory directly
+  if ((stage == nullptr) || !relay.allowPeerAccess(const_cast<Memory*>(&dstMem))) {
+    return false;
+  }
+
+  // The relay buffer is split into 2 slots, so the copy into one slot can overlap
+  // with the copy out of the other slot
+  constexpr uint kSlots = 2;
+  constexpr size_t kSlotSize = Device::kP2PRelaySize / kSlots;
+  hsa_signal_t toRelay[kSlots] = {};
+  hsa_signal_t fromRelay[kSlots] = {};
+  bool result = true;
+  for (uint i = 0; i < kSlots; ++i) {
+    if ((hsa_signal_create(0, 0, nullptr, &toRelay[i]) != HSA_STATUS_SUCCESS) ||
+        (hsa_signal_create(0, 0, nullptr, &fromRelay[i]) != HSA_STATUS_SUCCESS)) {
+      LogError("Failed to create the signals for the P2P relay copy");
+      result = false;
+    }
+  }
+
+  const address src = srcMem.getDeviceMemory() + srcOffset;
+  const address dst = dstMem.getDeviceMemory() + dstOffset;
+  const hsa_agent_t srcAgent = srcMem.dev().getBackendDevice();
+  const hsa_agent_t dstAgent = dstMem.dev().getBackendDevice();
+  const hsa_agent_t relayAgent = relay.getBackendDevice();
+
+  for (size_t offset = 0, chunk = 0; result && (offset < size); offset += kSlotSize, ++chunk) {
+    const uint slot = chunk % kSlots;
+    const size_t copySize = std::min(kSlotSize, size - offset);
+    address slotMem = stage + slot * kSlotSize;
+    // Wait until the previous chunk leaves the slot, before the signals are armed again
+    WaitForSignal(fromRelay[slot], ActiveWait());
+    hsa_signal_store_relaxed(toRelay[slot], kInitSignalValueOne);
+    hsa_signal_store_relaxed(fromRelay[slot], kInitSignalValueOne);
+
+    hsa_status_t status = hsa_amd_memory_async_copy(slotMem, relayAgent, src + offset, srcAgent,
+                                                    copySize, 0, nullptr, toRelay[slot]);
+    if (status == HSA_STATUS_SUCCESS) {
+      status = hsa_amd_memory_async_copy(dst + offset, dstAgent, slotMem, relayAgent,
+                                         copySize, 1, &toRelay[slot], fromRelay[slot]);
+    } else {
+      hsa_signal_store_relaxed(toRelay[slot], 0);
+    }
+    if (status != HSA_STATUS_SUCCESS) {
+      LogPrintfError("P2P relay copy failed with status: %d", status);
+      WaitForSignal(toRelay[slot], ActiveWait());
+      hsa_signal_store_relaxed(fromRelay[slot], 0);
+      result = false;
+    }
+  }
+
+  for (uint i = 0; i < kSlots; ++i) {
+    if (fromRelay[i].handle != 0) {
+      WaitForSignal(fromRelay[i], ActiveWait());
+      hsa_signal_destroy(fromRelay[i]);
+    }
+    if (toRelay[i].handle != 0) {
+      hsa_signal_destroy(toRelay[i]);
+    }
+  }
+  return result;
+}
+
 // ================================================================================================
 void VirtualGPU::submitCopyMemoryP2P(amd::CopyMemoryP2PCommand& cmd) {
   // Make sure VirtualGPU has an exclusive access to the resources
@@ -2184,7 +2936,17 @@ void VirtualGPU::submitCopyMemoryP2P(amd::CopyMemoryP2PCommand& cmd) {
       amd::Coord3D srcOrigin(cmd.srcOrigin()[0]);
       amd::Coord3D dstOrigin(cmd.dstOrigin()[0]);
 
-      if (p2pAllowed) {
+      // Large copies between GPUs without a direct xGMI link may relay through
+      // a GPU, which is linked to both peers
+      Device* relay = nullptr;
+      if ((ROC_P2P_RELAY_SIZE != 0) && (size[0] >= ROC_P2P_RELAY_SIZE * Ki)) {
+        relay = const_cast<Device&>(srcDevMem->dev()).P2PRelayDevice(dstDevMem->dev());
+      }
+
+      if ((relay != nullptr) &&
+          copyP2PRelay(*srcDevMem, *dstDevMem, srcOrigin[0], dstOrigin[0], size[0], *relay)) {
+        result = true;
+      } else if (p2pAllowed) {
           result = blitMgr().copyBuffer(*srcDevMem, *dstDevMem, srcOrigin, dstOrigin,
                                         size, cmd.isEntireMemory());
       }
@@ -2424,7 +3186,8 @@ void VirtualGPU::submitMapMemory(amd::MapMemoryCommand& cmd) {
       dev().addVACache(devMemory);
     }
   } else if (devMemory->IsPersistentDirectMap()) {
-    // Persistent memory - NOP map
+    // Persistent memory - NOP map, but the host accesses the memory directly
+    releaseGpuMemoryFence();
   } else if (mapFlag & (CL_MAP_READ | CL_MAP_WRITE)) {
     bool result = false;
     roc::Memory* hsaMemory = static_cast<roc::Memory*>(devMemory);
@@ -2751,54 +3514,62 @@ void VirtualGPU::submitVirtualMap(amd::VirtualMapCommand& vcmd) {
 
   profilingBegin(vcmd);
 
-  // Find the amd::Memory object for virtual ptr. vcmd.ptr() is vaddr.
-  amd::Memory* vaddr_base_obj = amd::MemObjMap::FindVirtualMemObj(vcmd.ptr());
-  if (vaddr_base_obj == nullptr || !(vaddr_base_obj->getMemFlags() & CL_MEM_VA_RANGE_AMD)) {
-    profilingEnd(vcmd);
-    return;
-  }
-
-  // Get the amd::Memory object for the physical address
-  amd::Memory* phys_mem_obj = vcmd.memory();
-  hsa_status_t hsa_status = HSA_STATUS_SUCCESS;
-
-  // If Physical address is not set, then it is map command. If set, it is unmap command.
-  if (phys_mem_obj != nullptr) {
-    constexpr bool kParent = false;
-    amd::Memory* vaddr_sub_obj = phys_mem_obj->getContext().devices()[0]->CreateVirtualBuffer(
-                                 phys_mem_obj->getContext(), const_cast<void*>(vcmd.ptr()),
-                                 vcmd.size(), phys_mem_obj->getUserData().deviceId, kParent);
-    // Map the physical to virtual address the hsa api
-    hsa_amd_vmem_alloc_handle_t opaque_hsa_handle;
-    opaque_hsa_handle.handle = phys_mem_obj->getUserData().hsa_handle;
-    if ((hsa_status = hsa_amd_vmem_map(vaddr_sub_obj->getSvmPtr(), vcmd.size(),
-                        vaddr_sub_obj->getOffset(), opaque_hsa_handle, 0)) == HSA_STATUS_SUCCESS) {
-      assert(amd::MemObjMap::FindMemObj(vcmd.ptr()) == nullptr);
-      amd::MemObjMap::AddMemObj(vcmd.ptr(), vaddr_sub_obj);
-      vaddr_sub_obj->getUserData().phys_mem_obj = phys_mem_obj;
-      phys_mem_obj->getUserData().vaddr_mem_obj = vaddr_sub_obj;
-    } else {
-      LogError("HSA Command: hsa_amd_vmem_map failed!");
+  bool drained = false;
+  for (size_t idx = 0; idx < vcmd.count(); ++idx) {
+    const amd::VirtualMapCommand::Range range = vcmd.range(idx);
+    // Find the amd::Memory object for virtual ptr. range.ptr_ is vaddr.
+    amd::Memory* vaddr_base_obj = amd::MemObjMap::FindVirtualMemObj(range.ptr_);
+    if (vaddr_base_obj == nullptr || !(vaddr_base_obj->getMemFlags() & CL_MEM_VA_RANGE_AMD)) {
+      continue;
     }
-  } else {
-    dispatchBarrierPacket(kBarrierPacketHeader, false);
-    Barriers().WaitCurrent();
 
-    amd::Memory* vaddr_sub_obj = amd::MemObjMap::FindMemObj(vcmd.ptr());
-    assert(vaddr_sub_obj != nullptr);
-
-    // Unmap the object, since the physical addr is set.
-    if ((hsa_status = hsa_amd_vmem_unmap(vaddr_sub_obj->getSvmPtr(), vcmd.size()))
-                        == HSA_STATUS_SUCCESS) {
-      // assert the va is mapped and needs to be removed
-      vaddr_sub_obj->getContext().devices()[0]->DestroyVirtualBuffer(vaddr_sub_obj);
-      amd::MemObjMap::RemoveMemObj(vcmd.ptr());
-      if (vaddr_sub_obj->getUserData().phys_mem_obj != nullptr) {
-        vaddr_sub_obj->getUserData().phys_mem_obj->getUserData().vaddr_mem_obj = nullptr;
-        vaddr_sub_obj->getUserData().phys_mem_obj = nullptr;
+    // Get the amd::Memory object for the physical address
+    amd::Memory* phys_mem_obj = range.memory_;
+    hsa_status_t hsa_status = HSA_STATUS_SUCCESS;
+
+    // If Physical address is not set, then it is map command. If set, it is unmap command.
+    if (phys_mem_obj != nullptr) {
+      constexpr bool kParent = false;
+      amd::Memory* vaddr_sub_obj = phys_mem_obj->getContext().devices()[0]->CreateVirtualBuffer(
+                                   phys_mem_obj->getContext(), const_cast<void*>(range.ptr_),
+                                   range.size_, phys_mem_obj->getUserData().deviceId, kParent);
+      // Map the physical to virtual address the hsa api
+      hsa_amd_vmem_alloc_handle_t opaque_hsa_handle;
+      opaque_hsa_handle.handle = phys_mem_obj->getUserData().hsa_handle;
+      if ((hsa_status = hsa_amd_vmem_map(vaddr_sub_obj->getSvmPtr(), range.size_,
+                          vaddr_sub_obj->getOffset() + range.offset_, opaque_hsa_handle,
+                          0)) == HSA_STATUS_SUCCESS) {
+        assert(amd::MemObjMap::FindMemObj(range.ptr_) == nullptr);
+        amd::MemObjMap::AddMemObj(range.ptr_, vaddr_sub_obj);
+        vaddr_sub_obj->getUserData().phys_mem_obj = phys_mem_obj;
+        phys_mem_obj->getUserData().vaddr_mem_obj = vaddr_sub_obj;
+      } else {
+        LogError("HSA Command: hsa_amd_vmem_map failed!");
       }
     } else {
-      LogError("HSA Command: hsa_amd_vmem_unmap failed");
+      // A single drain covers all unmaps of the batch, since the maps don't submit GPU work
+      if (!drained) {
+        dispatchBarrierPacket(kBarrierPacketHeader, false);
+        Barriers().WaitCurrent();
+        drained = true;
+      }
+
+      amd::Memory* vaddr_sub_obj = amd::MemObjMap::FindMemObj(range.ptr_);
+      assert(vaddr_sub_obj != nullptr);
+
+      // Unmap the object, since the physical addr is set.
+      if ((hsa_status = hsa_amd_vmem_unmap(vaddr_sub_obj->getSvmPtr(), range.size_))
+                          == HSA_STATUS_SUCCESS) {
+        // assert the va is mapped and needs to be removed
+        vaddr_sub_obj->getContext().devices()[0]->DestroyVirtualBuffer(vaddr_sub_obj);
+        amd::MemObjMap::RemoveMemObj(range.ptr_);
+        if (vaddr_sub_obj->getUserData().phys_mem_obj != nullptr) {
+          vaddr_sub_obj->getUserData().phys_mem_obj->getUserData().vaddr_mem_obj = nullptr;
+          vaddr_sub_obj->getUserData().phys_mem_obj = nullptr;
+        }
+      } else {
+        LogError("HSA Command: hsa_amd_vmem_unmap failed");
+      }
     }
   }
 
@@ -2852,23 +3623,37 @@ void VirtualGPU::submitMigrateMemObjects(amd::MigrateMemObjectsCommand& vcmd) {
   profilingBegin(vcmd);
 
   for (auto itr : vcmd.memObjects()) {
-    // Find device memory
-    Memory* memory = dev().getRocMemory(&(*itr));
-
     if (vcmd.migrationFlags() & CL_MIGRATE_MEM_OBJECT_HOST) {
+      // Don't allocate device memory just for the write back. If this device never used
+      // the object, then only the last writer can have newer data than the host
+      const amd::Device* writer = (itr->getLastWriter() != nullptr) ?
+          itr->getLastWriter() : &dev();
+      Memory* memory = static_cast<Memory*>(itr->getDeviceMemory(dev(), false));
+      if (memory == nullptr) {
+        memory = static_cast<Memory*>(itr->getDeviceMemory(*writer, false));
+      }
+      if (memory == nullptr) {
+        continue;
+      }
       if (!memory->isHostMemDirectAccess()) {
         // Make sure GPU finished operation before synchronization with the backing store
         releaseGpuMemoryFence();
       }
       memory->mgpuCacheWriteBack(*this);
-    } else if (vcmd.migrationFlags() & CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED) {
+      continue;
+    }
+
+    // Find device memory, it's allocated on the first use by this device
+    Memory* memory = dev().getRocMemory(&(*itr));
+    if (vcmd.migrationFlags() & CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED) {
+      // The content isn't needed, so just make this device the owner of the data
+      itr->signalWrite(&dev());
+    } else {
       // Synchronize memory from host if necessary.
       // The sync function will perform memory migration from
       // another device if necessary
       device::Memory::SyncFlags syncFlags;
       memory->syncCacheFromHost(*this, syncFlags);
-    } else {
-      LogWarning("Unknown operation for memory migration!");
     }
   }
 
@@ -2901,6 +3686,18 @@ static void callbackQueue(hsa_status_t status, hsa_queue_t* queue, void* data) {
   }
 }
 
+// ================================================================================================
+bool VirtualGPU::waitScheduler() {
+  if (schedulerPending_) {
+    schedulerPending_ = false;
+    if (!WaitForSignal(schedulerSignal_)) {
+      LogWarning("Failed schedulerSignal wait");
+      return false;
+    }
+  }
+  return true;
+}
+
 // ================================================================================================
 bool VirtualGPU::createSchedulerParam()
 {
@@ -2986,6 +3783,7 @@ bool VirtualGPU::createVirtualQueue(uint deviceQueueSize)
     return true;
   } else {
     if (0 != deviceQueueSize_) {
+      waitScheduler();
       virtualQueue_->release();
       virtualQueue_ = nullptr;
       deviceQueueSize_ = 0;
@@ -3130,6 +3928,12 @@ bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
     const amd::Kernel& kernel, const_address parameters, void* eventHandle,
     uint32_t sharedMemBytes, amd::NDRangeKernelCommand* vcmd,
     hsa_kernel_dispatch_packet_t* aql_packet) {
+  uint64_t submit_time = 0;
+  if (ROC_DISPATCH_STATS) {
+    submit_time = (vcmd != nullptr && vcmd->profilingInfo().enabled_ &&
+                   vcmd->profilingInfo().queued_ != 0) ?
+                  vcmd->profilingInfo().queued_ : amd::Os::timeNanos();
+  }
   device::Kernel* devKernel = const_cast<device::Kernel*>(kernel.getDeviceKernel(dev()));
   Kernel& gpuKernel = static_cast<Kernel&>(*devKernel);
   size_t ldsUsage = gpuKernel.WorkgroupGroupSegmentByteSize();
@@ -3144,11 +3948,21 @@ bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
     return false;
   }
 
-  // Init PrintfDbg object if printf is enabled.
+  // Init PrintfDbg object if printf is enabled. The object and the debug buffer are created on
+  // the first launch of a kernel with printf, since most queues never run one
   bool printfEnabled = (gpuKernel.printfInfo().size() > 0) ? true : false;
-  if (!printfDbg()->init(printfEnabled)) {
-    LogError("\nPrintfDbg object initialization failed!");
-    return false;
+  if (printfEnabled) {
+    if (printfdbg_ == nullptr) {
+      printfdbg_ = new PrintfDbg(roc_device_);
+      if (nullptr == printfdbg_) {
+        LogError("\nCould not create printfDbg Object!");
+        return false;
+      }
+    }
+    if (!printfDbg()->init(printfEnabled)) {
+      LogError("\nPrintfDbg object initialization failed!");
+      return false;
+    }
   }
 
   const amd::KernelSignature& signature = kernel.signature();
@@ -3179,7 +3993,7 @@ bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
 
   amd::Memory* const* memories =
       reinterpret_cast<amd::Memory* const*>(parameters + kernelParams.memoryObjOffset());
-  bool isGraphCapture = currCmd_ != nullptr && currCmd_->getPktCapturingState();
+  bool isGraphCapture = isPacketCapturing();
   for (int j = 0; j < iteration; j++) {
     // Reset global size for dimension dim if split is needed
     if (dim != -1) {
@@ -3198,10 +4012,9 @@ bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
     // Calculate local size if it wasn't provided
     devKernel->FindLocalWorkSize(sizes.dimensions(), sizes.global(), local);
 
-    // Check if runtime has to setup hidden arguments
-    for (uint32_t i = signature.numParameters(); i < signature.numParametersAll(); ++i) {
-      const auto& it = signature.at(i);
-      switch (it.info_.oclObject_) {
+    // Setup the hidden arguments from the precomputed list of the kernel
+    for (const auto& it : devKernel->hiddenArgs()) {
+      switch (it.type_) {
         case amd::KernelParameterDescriptor::HiddenNone:
           break;
         case amd::KernelParameterDescriptor::HiddenGlobalOffsetX: {
@@ -3221,8 +4034,9 @@ bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
           break;
         }
         case amd::KernelParameterDescriptor::HiddenPrintfBuffer: {
-          uintptr_t bufferPtr = reinterpret_cast<uintptr_t>(printfDbg()->dbgBuffer());
-          if (printfEnabled && bufferPtr) {
+          uintptr_t bufferPtr = printfEnabled ?
+              reinterpret_cast<uintptr_t>(printfDbg()->dbgBuffer()) : 0;
+          if (bufferPtr) {
             WriteAqlArgAt(hidden_arguments, bufferPtr, it.size_, it.offset_);
           }
           break;
@@ -3230,12 +4044,21 @@ bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
         case amd::KernelParameterDescriptor::HiddenHostcallBuffer: {
           if (amd::IS_HIP) {
             if (dev().info().pcie_atomics_) {
-              uintptr_t buffer = reinterpret_cast<uintptr_t>(
-                roc_device_.getOrCreateHostcallBuffer(gpu_queue_, coopGroups, cuMask_));
+              uintptr_t buffer = reinterpret_cast<uintptr_t>(getHostcallBuffer(coopGroups));
               if (!buffer) {
                 LogError("Kernel expects a hostcall buffer, but none found");
                 return false;
               }
+              if (ROC_DISPATCH_STATS) {
+                // Close the accounting of the previous kernel before this one starts calls
+                AccountHostcalls();
+                if (hostcall_buffer_ != reinterpret_cast<amd::HostcallBuffer*>(buffer)) {
+                  hostcall_buffer_ = reinterpret_cast<amd::HostcallBuffer*>(buffer);
+                  hostcall_packets_ = hostcall_buffer_->servedPackets();
+                  hostcall_time_ = hostcall_buffer_->listenerTime();
+                }
+                hostcall_kernel_ = gpuKernel.name();
+              }
               WriteAqlArgAt(hidden_arguments, buffer, it.size_, it.offset_);
             } else {
               LogError("Pcie atomics not enabled, hostcall not supported");
@@ -3259,6 +4082,10 @@ bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
         case amd::KernelParameterDescriptor::HiddenCompletionAction: {
           uint64_t spVA = 0;
           if (nullptr != schedulerParam_ && devKernel->dynamicParallelism()) {
+            // The scheduler of the previous launch reads the parent wrap until it's done
+            if (!waitScheduler()) {
+              return false;
+            }
             Memory* schedulerMem = dev().getRocMemory(schedulerParam_);
             AmdAqlWrap* wrap = reinterpret_cast<AmdAqlWrap*>(
                                reinterpret_cast<uint64_t>(schedulerParam_->getHostMem()) + sizeof(SchedulerParam));
@@ -3294,6 +4121,9 @@ bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
             syncInfo->prev_sum = vcmd->prevGridSum();
             syncInfo->all_sum = vcmd->allGridSum();
             syncInfo->num_wg = vcmd->numWorkgroups();
+            // The device headers fall back to the device library barrier without the counters
+            syncInfo->barrier = (singleGridSync && vcmd->hierarchicalGridSync()) ?
+                const_cast<Device&>(dev()).GridBarrier(vcmd->numWorkgroups()) : nullptr;
           }
           // Update GPU address for grid sync info. Use the offset adjustment for the right
           // location
@@ -3389,6 +4219,10 @@ bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
         case amd::KernelParameterDescriptor::HiddenDynamicLdsSize:
           WriteAqlArgAt(hidden_arguments, sharedMemBytes, it.size_, it.offset_);
           break;
+        case amd::KernelParameterDescriptor::HiddenErrorMailbox:
+          // Null makes the device library report the asserts over hostcall
+          WriteAqlArgAt(hidden_arguments, error_mailbox_, it.size_, it.offset_);
+          break;
       }
     }
 
@@ -3417,8 +4251,13 @@ bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
         const auto kernArgImpl = dev().settings().kernel_arg_impl_;
 
         if (kernArgImpl == KernelArgImpl::DeviceKernelArgsHDP) {
-          *dev().info().hdpMemFlushCntl = 1u;
-          auto kSentinel = *reinterpret_cast<volatile int*>(dev().info().hdpMemFlushCntl);
+          if (coalesce_doorbell_) {
+            // The flush will occur once, before the coalesced doorbell
+            hdp_flush_pending_ = true;
+          } else {
+            *dev().info().hdpMemFlushCntl = 1u;
+            auto kSentinel = *reinterpret_cast<volatile int*>(dev().info().hdpMemFlushCntl);
+          }
         } else if (kernArgImpl == KernelArgImpl::DeviceKernelArgsReadback &&
                    argSize != 0) {
           _mm_sfence();
@@ -3455,7 +4294,8 @@ bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
     dispatchPacket.workgroup_size_y = sizes.dimensions() > 1 ? local[1] : 1;
     dispatchPacket.workgroup_size_z = sizes.dimensions() > 2 ? local[2] : 1;
 
-    dispatchPacket.kernarg_address = argBuffer;
+    dispatchPacket.kernarg_address = isGraphCapture ? currCmd_->getKernArgAddress(argBuffer) :
+                                                      argBuffer;
     dispatchPacket.group_segment_size = ldsUsage + sharedMemBytes;
     dispatchPacket.private_segment_size = devKernel->workGroupInfo()->privateMemSize_;
 
@@ -3498,26 +4338,48 @@ bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
         return false;
       }
     } else {
+      const bool sampled = (counter_sampler_ != nullptr) &&
+                           counter_sampler_->begin(gpuKernel.name());
       if (!dispatchAqlPacket(&dispatchPacket, aqlHeaderWithOrder,
                              (sizes.dimensions() << HSA_KERNEL_DISPATCH_PACKET_SETUP_DIMENSIONS),
                              GPU_FLUSH_ON_EXECUTION)) {
         return false;
       }
+      if (sampled) {
+        counter_sampler_->end();
+      }
+      if (ROC_DISPATCH_STATS) {
+        uint64_t doorbell = amd::Os::timeNanos();
+        {
+          amd::ScopedLock lock(dispatch_stats_lock_);
+          dispatch_stats_[gpuKernel.name()].enqueueToDoorbell_.add(doorbell - submit_time);
+        }
+        if (timestamp_ != nullptr) {
+          timestamp_->SetDispatchDoorbell(gpuKernel.name(), doorbell);
+        }
+      }
     }
   }
 
   // Output printf buffer
-  if (!printfDbg()->output(*this, printfEnabled, gpuKernel.printfInfo())) {
+  if (printfEnabled &&
+      !printfDbg()->output(*this, printfEnabled, gpuKernel.printfInfo(), gpuKernel.name())) {
     LogError("\nCould not print data from the printf buffer!");
     return false;
   }
 
   if (gpuKernel.dynamicParallelism()) {
     dispatchBarrierPacket(kBarrierPacketHeader, true);
-    if (virtualQueue_ != nullptr) {
-      static_cast<KernelBlitManager&>(blitMgr()).runScheduler(
-          getVQVirtualAddress(), schedulerParam_, schedulerQueue_,
-          schedulerSignal_, schedulerThreads_);
+    if ((virtualQueue_ != nullptr) && waitScheduler() &&
+        static_cast<KernelBlitManager&>(blitMgr()).runScheduler(
+            getVQVirtualAddress(), schedulerParam_, schedulerQueue_,
+            schedulerSignal_, schedulerThreads_)) {
+      // The scheduler signals the completion of all child kernels. Wait for it on the GPU,
+      // hence the host doesn't stall and the later commands still run after the child kernels
+      barrier_packet_.dep_signal[0] = schedulerSignal_;
+      dispatchBarrierPacket(kBarrierPacketHeader, true,
+                            Barriers().ActiveSignal(kInitSignalValueOne, timestamp_));
+      schedulerPending_ = true;
     }
   }
 
@@ -3635,6 +4497,15 @@ void VirtualGPU::submitMarker(amd::Marker& vcmd) {
           } else {
             dispatchBarrierPacket(kNopPacketHeader, false);
           }
+        } else if (releaseFlags == Device::CacheState::kCacheStateAgent) {
+          // Device scope release is enough for the timing and GPU side dependencies. It avoids
+          // L2 writeback, so the per-step timing events don't stall the stream. The system
+          // release is still pending, hence hasPendingDispatch_ isn't reset.
+          if (settings.barrier_value_packet_ && vcmd.profilingInfo().marker_ts_) {
+            dispatchBarrierValuePacket(kBarrierVendorPacketAgentScopeHeader, true);
+          } else {
+            dispatchBarrierPacket(kBarrierPacketAgentScopeHeader, false);
+          }
         } else {
           // Submit a barrier with a cache flushes.
           if (settings.barrier_value_packet_ && vcmd.profilingInfo().marker_ts_) {
@@ -3646,6 +4517,8 @@ void VirtualGPU::submitMarker(amd::Marker& vcmd) {
         }
       }
       profilingEnd(vcmd);
+      // Markers are used for the event records and syncs, expose them to the HW right away
+      RingDeferredDoorbell();
     }
 
   }
@@ -3687,6 +4560,7 @@ void VirtualGPU::submitReleaseExtObjects(amd::ReleaseExtObjectsCommand& vcmd) {
 
 // ================================================================================================
 void VirtualGPU::flush(amd::Command* list, bool wait) {
+  RingDeferredDoorbell();
   // If barrier is requested, then wait for everything, otherwise
   // a per disaptch wait will occur later in updateCommandsState()
   releaseGpuMemoryFence();
@@ -31,11 +31,22 @@
 #include "hsa/hsa_ven_amd_aqlprofile.h"
 #include "rocsched.hpp"
 
+#include <limits>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace amd {
+class HostcallBuffer;
+}
+
 namespace amd::roc {
 class Device;
 class Memory;
+struct ErrorMailbox;
 struct ProfilingSignal;
 class Timestamp;
+class KernelCounterSampler;
 
 // Initial HSA signal value
 constexpr static hsa_signal_value_t kInitSignalValueOne = 1;
@@ -86,6 +97,23 @@ inline bool WaitForSignal(hsa_signal_t signal, bool active_wait = false, bool fo
   return true;
 }
 
+//! Active wait for the provided time, then blocked wait until the signal completion
+inline bool WaitForSignalHybrid(hsa_signal_t signal, uint64_t spin_timeout) {
+  if (hsa_signal_load_relaxed(signal) > 0) {
+    ClPrint(amd::LOG_INFO, amd::LOG_SIG, "Host hybrid wait for Signal = (0x%lx) for %lu ns",
+            signal.handle, spin_timeout);
+    if ((spin_timeout == 0) ||
+        (hsa_signal_wait_scacquire(signal, HSA_SIGNAL_CONDITION_LT, kInitSignalValueOne,
+                                   spin_timeout, HSA_WAIT_STATE_ACTIVE) != 0)) {
+      if (hsa_signal_wait_scacquire(signal, HSA_SIGNAL_CONDITION_LT, kInitSignalValueOne,
+                                    kUnlimitedWait, HSA_WAIT_STATE_BLOCKED) != 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 inline void fetchSignalTime(hsa_signal_t signal, hsa_agent_t gpu_device,
                             uint64_t* start, uint64_t* end) {
   if (start != nullptr && end != nullptr) {
@@ -112,6 +140,8 @@ class Timestamp : public amd::ReferenceCountedObject {
   amd::Monitor  lock_;            //!< Serialize timestamp update
   bool        accum_ena_ = false; //!< If TRUE then the accumulation of execution times has started
   bool        hasHwProfiling_ = false; //!< If TRUE then HwProfiling is enabled for the command
+  uint64_t    doorbell_ = 0;      //!< Host time of the kernel doorbell for the dispatch stats
+  std::string kernelName_;        //!< Kernel name for the dispatch stats
 
   Timestamp(const Timestamp&) = delete;
   Timestamp& operator=(const Timestamp&) = delete;
@@ -128,6 +158,14 @@ class Timestamp : public amd::ReferenceCountedObject {
 
   ~Timestamp() {}
 
+  //! Recycle the storage, since every profiled command creates a timestamp
+  void* operator new(size_t size) {
+    return amd::FreeList<sizeof(Timestamp)>::instance().allocate(size);
+  }
+  void operator delete(void* ptr, size_t size) {
+    amd::FreeList<sizeof(Timestamp)>::instance().release(ptr, size, ROC_EVENT_POOL_SIZE);
+  }
+
   void getTime(uint64_t* start, uint64_t* end) {
     checkGpuTime();
     *start = start_;
@@ -165,6 +203,12 @@ class Timestamp : public amd::ReferenceCountedObject {
   //! Returns amd::command assigned to this timestamp
   amd::Command& command() const { return command_; }
 
+  //! Saves the kernel doorbell time, so the GPU start can be reported in the dispatch stats
+  void SetDispatchDoorbell(const std::string& name, uint64_t doorbell) {
+    kernelName_ = name;
+    doorbell_ = doorbell;
+  }
+
   //! Sets the parsed command
   void setParsedCommand(amd::Command* command) { parsedCommand_ = command; }
 
@@ -213,16 +257,13 @@ class VirtualGPU : public device::VirtualDevice {
   class MemoryDependency : public amd::EmbeddedObject {
    public:
     //! Default constructor
-    MemoryDependency()
-        : memObjectsInQueue_(nullptr), numMemObjectsInQueue_(0), maxMemObjectsInQueue_(0) {}
-
-    ~MemoryDependency() { delete[] memObjectsInQueue_; }
+    MemoryDependency() : enabled_(false) {}
 
     //! Creates memory dependecy structure
     bool create(size_t numMemObj);
 
     //! Notify the tracker about new kernel
-    void newKernel() { endMemObjectsInQueue_ = numMemObjectsInQueue_; }
+    void newKernel();
 
     //! Validates memory object on dependency
     void validate(VirtualGPU& gpu, const Memory* memory, bool readOnly);
@@ -230,25 +271,40 @@ class VirtualGPU : public device::VirtualDevice {
     //! Clear memory dependency
     void clear(bool all = true);
 
-    //! Max number of mem objects in the queue
-    size_t maxMemObjectsInQueue() const { return maxMemObjectsInQueue_; }
+    //! Returns TRUE if the memory dependency tracking is enabled
+    bool enabled() const { return enabled_; }
 
    private:
+    //! Sorted index of non-overlapping busy ranges, keyed by the start address
+    class RangeIndex {
+     public:
+      //! Adds [start, end) range into the index, merging it with the overlapped ranges
+      void insert(uint64_t start, uint64_t end);
+
+      //! Returns TRUE if [start, end) range overlaps with any busy range in the index
+      bool overlaps(uint64_t start, uint64_t end) const;
+
+      void clear() { ranges_.clear(); }
+
+     private:
+      std::map<uint64_t, uint64_t> ranges_;  //!< Busy start address -> busy end address
+    };
+
     struct MemoryState {
       uint64_t start_;  //! Busy memory start address
       uint64_t end_;    //! Busy memory end address
       bool readOnly_;   //! Current GPU state in the queue
     };
 
-    MemoryState* memObjectsInQueue_;  //!< Memory object state in the queue
-    size_t endMemObjectsInQueue_;     //!< End of mem objects in the queue
-    size_t numMemObjectsInQueue_;     //!< Number of mem objects in the queue
-    size_t maxMemObjectsInQueue_;     //!< Maximum number of mem objects in the queue
+    RangeIndex accessed_;  //!< All ranges, accessed by the previous kernels in the queue
+    RangeIndex written_;   //!< Ranges, written by the previous kernels in the queue
+    std::vector<MemoryState> curKernel_;  //!< Mem objects of the current kernel
+    bool enabled_;         //!< Memory dependency tracking is enabled
   };
 
   class HwQueueTracker : public amd::EmbeddedObject {
    public:
-    HwQueueTracker(const VirtualGPU& gpu): gpu_(gpu) {}
+    HwQueueTracker(VirtualGPU& gpu): gpu_(gpu) {}
 
     ~HwQueueTracker();
 
@@ -306,11 +362,15 @@ class VirtualGPU : public device::VirtualDevice {
     //! Wait for the provided signal
     bool CpuWaitForSignal(ProfilingSignal* signal);
 
+    //! Creates the HSA signal of a new profiling signal with the consumers of this queue.
+    //! The signals without interrupt don't take KFD events, but a host wait on them polls
+    bool CreateSignal(ProfilingSignal* signal, bool interrupt = true);
+
     HwQueueEngine engine_ = HwQueueEngine::Unknown; //!< Engine used in the current operations
     std::vector<ProfilingSignal*> signal_list_;     //!< The pool of all signals for processing
     size_t current_id_ = 0;       //!< Last submitted signal
     bool sdma_profiling_ = false; //!< If TRUE, then SDMA profiling is enabled
-    const VirtualGPU& gpu_;       //!< VirtualGPU, associated with this tracker
+    VirtualGPU& gpu_;             //!< VirtualGPU, associated with this tracker
     std::vector<ProfilingSignal*> external_signals_; //!< External signals for a wait in this queue
     std::vector<hsa_signal_t> waiting_signals_;   //!< Current waiting signals in this queue
   };
@@ -354,6 +414,10 @@ class VirtualGPU : public device::VirtualDevice {
   void submitFillMemory(amd::FillMemoryCommand& cmd);
   void submitStreamOperation(amd::StreamOperationCommand& cmd);
   void submitVirtualMap(amd::VirtualMapCommand& cmd);
+  void submitCopyMemoryBatch(amd::CopyMemoryBatchCommand& cmd);
+  void submitFillMemoryBatch(amd::FillMemoryBatchCommand& cmd);
+  void submitGraphCondition(amd::GraphConditionCommand& cmd);
+  void submitCopyFileToMemory(amd::CopyFileToMemoryCommand& cmd);
   void submitMigrateMemObjects(amd::MigrateMemObjectsCommand& cmd);
 
   void submitSvmFreeMemory(amd::SvmFreeMemoryCommand& cmd);
@@ -386,6 +450,9 @@ class VirtualGPU : public device::VirtualDevice {
    */
   bool releaseGpuMemoryFence(bool skip_copy_wait = false);
 
+  //! Sends a system scope barrier, which decrements the signal after the outstanding work
+  void signalGpuMemoryFence(hsa_signal_t signal);
+
   hsa_agent_t gpu_device() const { return gpu_device_; }
   hsa_queue_t* gpu_queue() { return gpu_queue_; }
 
@@ -404,6 +471,12 @@ class VirtualGPU : public device::VirtualDevice {
                          std::vector<device::Memory*>& wrtBackImageBuffer //!< Images for writeback
                          );
 
+  //! Updates the placement of the managed memory, accessed by the current kernel
+  void applyHmmPolicy(const amd::Memory& mem, bool readOnly);
+
+  //! Grants the peer access to the memory of another device on the first use by a kernel
+  bool validatePeerAccess(amd::Memory& mem);
+
   //! Returns a managed buffer for staging copies
   ManagedBuffer& Staging() { return managed_buffer_; }
 
@@ -425,10 +498,47 @@ class VirtualGPU : public device::VirtualDevice {
 
   HwQueueTracker& Barriers() { return barriers_; }
 
+  //! Returns TRUE if all operations submitted to the queue have completed
+  bool isIdle();
+
+  //! Returns TRUE if the current command records AQL packets for a graph replay
+  bool isPacketCapturing() const {
+    return (currCmd_ != nullptr) && currCmd_->getPktCapturingState();
+  }
+
   Timestamp* timestamp() const { return timestamp_; }
 
   void* allocKernArg(size_t size, size_t alignment);
   bool isFenceDirty() const { return fence_dirty_; }
+
+  void GetDispatchStats(device::DispatchStatsMap& stats) const;
+  void GetIdleGapStats(device::IdleGapStats& stats) const;
+  //! Adds the GPU start and end times of a kernel to the dispatch stats
+  void RecordDispatchGpuTime(const std::string& name, uint64_t doorbell, uint64_t start,
+                             uint64_t end);
+  //! Adds the bytes of the buffered printf output of a kernel to the dispatch stats
+  void RecordPrintfBytes(const std::string& name, uint64_t bytes);
+  //! Adds the counter values of a sampled dispatch to the dispatch stats of the kernel
+  void RecordCounterSample(const std::string& name, const std::vector<uint64_t>& values);
+  //! Attributes the hostcall packets, served since the last call, to the last hostcall kernel
+  void AccountHostcalls();
+  //! Returns the hostcall buffer of the queue, created on the first hostcall kernel launch
+  void* getHostcallBuffer(bool coopGroups);
+
+  //! The staged read buffer, which the queue keeps between the reads
+  Memory* xferBuffer() const { return xfer_buffer_; }
+  void setXferBuffer(Memory* buffer) { xfer_buffer_ = buffer; }
+
+  //! Sets the host wait policy for the completion signals of this queue
+  void SetWaitPolicy(amd::CommandQueue::WaitPolicy policy) { wait_policy_ = policy; }
+  //! Waits for the signal, following the wait policy of the queue
+  bool WaitForSignalWithPolicy(hsa_signal_t signal);
+
+  void BeginDoorbellBatch();
+  void EndDoorbellBatch();
+  bool SetCUMask(const std::vector<uint32_t>& cuMask);
+  //! Rings the deferred doorbell, must be done before any wait on the HW progress
+  void RingDeferredDoorbell();
   void HiddenHeapInit();
 
   void setLastUsedSdmaEngine(uint32_t mask) { lastUsedSdmaEngineMask_ = mask; }
@@ -448,9 +558,12 @@ class VirtualGPU : public device::VirtualDevice {
                         uint16_t rest, bool blocking = true);
   template <typename AqlPacket> bool dispatchGenericAqlPacket(AqlPacket* packet, uint16_t header,
                                                               uint16_t rest, bool blocking);
+  //! Publishes the header of the packet in the reserved slot and rings the doorbell
+  void PublishAqlPacket(uint64_t index, uint32_t* aql_loc, uint16_t header, uint16_t rest);
 
   bool dispatchCounterAqlPacket(hsa_ext_amd_aql_pm4_packet_t* packet, const uint32_t gfxVersion,
-                                bool blocking, const hsa_ven_amd_aqlprofile_1_00_pfn_t* extApi);
+                                bool blocking, const hsa_ven_amd_aqlprofile_1_00_pfn_t* extApi,
+                                bool barrier = false);
   void dispatchBarrierPacket(uint16_t packetHeader, bool skipSignal = false,
                              hsa_signal_t signal = hsa_signal_t{0});
   void dispatchBarrierValuePacket(uint16_t packetHeader,
@@ -467,16 +580,22 @@ class VirtualGPU : public device::VirtualDevice {
   bool initPool(size_t kernarg_pool_size);
   void destroyPool();
 
-  void resetKernArgPool() {
-    kernarg_pool_cur_offset_ = 0;
-    kernarg_pool_chunk_end_ = kernarg_pool_size_ / KernelArgPoolNumSignal;
-    active_chunk_ = 0;
-  }
+  //! Resets the kernarg pool, the queue must be idle
+  void resetKernArgPool();
+  //! Allocates memory for the kernarg pool
+  address allocKernArgPoolMemory(size_t size);
+  //! Replaces the kernarg pool with a bigger one, the old pool is retired until the HW is done
+  bool growKernArgPool();
+  //! Releases the retired kernarg pools, which aren't used by the HW anymore
+  void releaseRetiredKernArgPools(bool idle);
 
   uint64_t getVQVirtualAddress();
 
   bool createSchedulerParam();
 
+  //! Waits for the child kernels of the last device enqueue, before runtime reuses the scheduler
+  bool waitScheduler();
+
   //! Returns TRUE if virtual queue was successfully allocatted
   bool createVirtualQueue(uint deviceQueueSize);
 
@@ -505,6 +624,15 @@ class VirtualGPU : public device::VirtualDevice {
                            amd::CopyMetadata()      //!< Memory copy MetaData
                   );
 
+  //! Copies device memory between two peers through the relay GPU memory
+  bool copyP2PRelay(const Memory& srcMem,  //!< source memory on the first peer
+                    const Memory& dstMem,  //!< destination memory on the second peer
+                    size_t srcOffset,      //!< offset in the source memory
+                    size_t dstOffset,      //!< offset in the destination memory
+                    size_t size,           //!< copy size
+                    Device& relay          //!< GPU linked to both peers
+                    );
+
   //! Updates AQL header for the upcomming dispatch
   void setAqlHeader(uint16_t header) { aqlHeader_ = header; }
 
@@ -529,12 +657,40 @@ class VirtualGPU : public device::VirtualDevice {
   Timestamp* timestamp_;
   hsa_agent_t gpu_device_;  //!< Physical device
   hsa_queue_t* gpu_queue_;  //!< Queue associated with a gpu
+  ErrorMailbox* error_mailbox_ = nullptr;  //!< Device assert and abort reports of gpu_queue_
+  static constexpr uint64_t kNoDeferredDoorbell = std::numeric_limits<uint64_t>::max();
+  static constexpr uint32_t kAdaptiveFlushPackets = 64;  //!< Packet limit of the adaptive flush
+  std::thread::id doorbell_batch_owner_;  //!< Thread with deferred doorbell writes, if any
+  uint32_t doorbell_batch_depth_ = 0;     //!< Nesting depth of the doorbell batch
+  uint64_t deferred_doorbell_ = kNoDeferredDoorbell; //!< Write index of the deferred doorbell
+  bool coalesce_doorbell_ = false;  //!< Doorbell coalescing is enabled
+  bool adaptive_flush_ = false;     //!< Coalesce only while the HW has work ahead of the packets
+  uint64_t exposed_packets_ = 0;    //!< The number of packets exposed by the last doorbell
+  bool hdp_flush_pending_ = false;  //!< Kernargs HDP flush is deferred until the doorbell
+  uint32_t coalesced_packets_ = 0;  //!< The number of packets behind the deferred doorbell
+  uint64_t coalesce_start_ = 0;     //!< Time of the first packet behind the deferred doorbell
+  amd::CommandQueue::WaitPolicy wait_policy_ = amd::CommandQueue::WaitPolicy::Default;
+  std::atomic<uint64_t> expected_wait_ = 0; //!< Moving average of the signal completion time (ns)
+
+  //! Dispatch latency histograms, indexed by the kernel name
+  std::unordered_map<std::string, device::DispatchStats> dispatch_stats_;
+  mutable amd::Monitor dispatch_stats_lock_;  //!< Lock for the dispatch latency histograms
+  device::IdleGapStats idle_gaps_;   //!< Idle gaps between the kernels, ROC_IDLE_GAP_STATS
+  uint64_t last_kernel_end_ = 0;     //!< GPU end time of the latest kernel for the idle gaps
+  amd::HostcallBuffer* hostcall_buffer_ = nullptr;  //!< Hostcall buffer of the queue
+  std::string hostcall_kernel_;      //!< The last dispatched kernel, which uses hostcalls
+  uint64_t hostcall_packets_ = 0;    //!< Served packets at the last accounting
+  uint64_t hostcall_time_ = 0;       //!< Listener time at the last accounting
+  void* queue_hostcall_buffer_ = nullptr;  //!< Hostcall buffer, bound to gpu_queue_
+  Memory* xfer_buffer_ = nullptr;          //!< Staged read buffer, cached between the reads
+  void* coop_hostcall_buffer_ = nullptr;   //!< Hostcall buffer of the cooperative queue
+  KernelCounterSampler* counter_sampler_ = nullptr;  //!< Per kernel counters, ROC_KERNEL_COUNTERS
   hsa_barrier_and_packet_t barrier_packet_;
   hsa_amd_barrier_value_packet_t barrier_value_packet_;
 
   uint32_t dispatch_id_;  //!< This variable must be updated atomically.
   Device& roc_device_;    //!< roc device object
-  PrintfDbg* printfdbg_;
+  PrintfDbg* printfdbg_;  //!< Created on the first launch of a kernel with printf
   MemoryDependency memoryDependency_;  //!< Memory dependency class
   uint16_t aqlHeader_;                 //!< AQL header for dispatch
 
@@ -547,6 +703,7 @@ class VirtualGPU : public device::VirtualDevice {
   amd::Memory* schedulerParam_;
   hsa_queue_t* schedulerQueue_;
   hsa_signal_t schedulerSignal_;
+  bool schedulerPending_;         //!< The scheduler may still run the child kernels
 
   HwQueueTracker  barriers_;      //!< Tracks active barriers in ROCr
 
@@ -559,10 +716,30 @@ class VirtualGPU : public device::VirtualDevice {
   uint32_t  kernarg_pool_cur_offset_;
   std::vector<hsa_signal_t> kernarg_pool_signal_; //!< Pool of HSA signals to manage
                                                   //!< multiple chunks
+  uint32_t  kernarg_pool_init_size_;    //!< The kernarg pool size before any growth
+
+  //! Kernarg pool, replaced by a bigger one, but still referenced by the packets in flight
+  struct RetiredKernArgPool {
+    address base_;                      //!< Base address of the pool
+    uint32_t size_;                     //!< Size of the pool
+    std::vector<hsa_signal_t> signals_; //!< Chunk signals of the pool
+  };
+  std::vector<RetiredKernArgPool> kernarg_retired_pools_;
+
+  //! Kernarg pool usage counters
+  struct KernArgPoolStats {
+    uint64_t wraps_ = 0;        //!< The number of chunk switches
+    uint64_t forcedSyncs_ = 0;  //!< The number of chunk switches, which stalled on the HW
+    uint64_t grows_ = 0;        //!< The number of pool growths
+    uint64_t shrinks_ = 0;      //!< The number of pool shrinks back to the initial size
+  } kernarg_pool_stats_;
+  bool kernarg_pool_wrapped_ = false; //!< The pool switched chunks since the last reset
+  uint32_t kernarg_pool_idle_resets_ = 0; //!< Resets in a row with a low usage of a grown pool
 
   ManagedBuffer managed_buffer_;  //!< Memory manager for staging copies
 
   friend class Timestamp;
+  friend class KernelCounterSampler;
 
   //  PM4 packet for gfx8 performance counter
   enum {
@@ -185,6 +185,7 @@ Elf::Elf (
   _shstrtab_ndx (SHN_UNDEF),
   _strtab_ndx (SHN_UNDEF),
   _symtab_ndx (SHN_UNDEF),
+  _symbolIndexSize (0),
   _successful (false)
 {
   LogElfInfo("fname=%s, rawElfSize=%lu, elfcmd=%d, %s",
@@ -216,6 +217,8 @@ bool Elf::Clear()
 
   _elfio.clean();
   elfMemoryRelease();
+  _symbolIndex.clear();
+  _symbolIndexSize = 0;
 
   // Re-initialize the object
   Init();
@@ -783,8 +786,17 @@ bool Elf::getSymbol(
   Elf_Half sec_ndx = SHN_UNDEF;
 
   // Search by symbolName, sectionName
-  bool ret = symbol_reader.get_symbol(symbolName, ElfSecDesc[id].name, value, size0,
-                    bind, type, sec_ndx, other);
+  bool ret = false;
+  updateSymbolIndex(symbol_reader);
+  auto range = _symbolIndex.equal_range(symbolName);
+  for (auto it = range.first; (it != range.second) && !ret; ++it) {
+    std::string name;
+    if (symbol_reader.get_symbol(it->second, name, value, size0, bind, type, sec_ndx, other) &&
+        (_elfio.sections[sec_ndx] != nullptr) &&
+        (_elfio.sections[sec_ndx]->get_name() == ElfSecDesc[id].name)) {
+      ret = true;
+    }
+  }
 
   if (ret) {
     *buffer = const_cast<char*>(_elfio.sections[sec_ndx]->get_data() + value);
@@ -799,6 +811,28 @@ bool Elf::getSymbol(
   return ret;
 }
 
+void Elf::updateSymbolIndex(const symbol_section_accessor& symbol_reader) const
+{
+  // The index grows with the table, hence every symbol is read once per Elf object
+  const Elf_Xword num = symbol_reader.get_symbols_num();
+  if (_symbolIndexSize == 0) {
+    _symbolIndex.reserve(num);
+  }
+  for (Elf_Xword i = _symbolIndexSize; i < num; ++i) {
+    std::string   name;
+    Elf64_Addr    value = 0;
+    Elf_Xword     size = 0;
+    unsigned char bind = 0;
+    unsigned char type = 0;
+    Elf_Half      sec_ndx = SHN_UNDEF;
+    unsigned char other = 0;
+    if (symbol_reader.get_symbol(i, name, value, size, bind, type, sec_ndx, other)) {
+      _symbolIndex.emplace(std::move(name), i);
+    }
+  }
+  _symbolIndexSize = num;
+}
+
 bool Elf::addNote(
     const char* noteName,
     const char* noteDesc,
@@ -993,6 +1027,26 @@ uint64_t Elf::getElfSize(const void *emi) {
   return total_size;
 }
 
+bool Elf::getHeaderInfo(const void *emi, size_t size, uint16_t& type, uint16_t& machine)
+{
+  if (!isElfMagic(static_cast<const char*>(emi))) {
+    return false;
+  }
+  const unsigned char eclass = static_cast<const unsigned char*>(emi)[EI_CLASS];
+  if ((eclass == ELFCLASS32) && (size >= sizeof(Elf32_Ehdr))) {
+    auto ehdr = static_cast<const Elf32_Ehdr*>(emi);
+    type = ehdr->e_type;
+    machine = ehdr->e_machine;
+  } else if ((eclass == ELFCLASS64) && (size >= sizeof(Elf64_Ehdr))) {
+    auto ehdr = static_cast<const Elf64_Ehdr*>(emi);
+    type = ehdr->e_type;
+    machine = ehdr->e_machine;
+  } else {
+    return false;
+  }
+  return true;
+}
+
 bool Elf::isElfMagic(const char* p)
 {
   if (p == nullptr || strncmp(p, ELFMAG, SELFMAG) != 0) {
@@ -22,6 +22,7 @@
 #define ELF_HPP_
 
 #include <map>
+#include <unordered_map>
 
 #include "top.hpp"
 #include "elfio/elfio.hpp"
@@ -196,6 +197,10 @@ private:
     Elf64_Word    _strtab_ndx; // Indexes of .strtab. Must be valid.
     Elf64_Word    _symtab_ndx; // Indexes of .symtab. May be SHN_UNDEF.
 
+    // Symbol name to .symtab index, extended on lookup with the symbols added since
+    mutable std::unordered_multimap<std::string, Elf_Xword> _symbolIndex;
+    mutable Elf_Xword _symbolIndexSize; // Number of .symtab entries in _symbolIndex
+
     bool _successful;
 
 public:
@@ -338,6 +343,9 @@ public:
     /* Return size of elf file */
     static uint64_t getElfSize(const void *emi);
 
+    /* Return the type and the machine from the header of an elf image without a copy */
+    static bool getHeaderInfo(const void *emi, size_t size, uint16_t& type, uint16_t& machine);
+
     /* is it ELF */
     static bool isElfMagic(const char* p);
 
@@ -354,6 +362,9 @@ private:
      */
     bool InitElf ();
 
+    /* Add the .symtab entries, not indexed yet, to the symbol name index */
+    void updateSymbolIndex(const symbol_section_accessor& symbol_reader) const;
+
     /* Setup a section header */
     bool setupShdr (
         ElfSections id,
@@ -114,6 +114,10 @@ class Os : AllStatic {
   static bool CloseFileHandle(FileDesc fdesc);
   // Given a valid file name, returns file descriptor and file size
   static bool GetFileHandle(const char* fname, FileDesc* fd_ptr, size_t* sz_ptr);
+  // Opens the file of a valid file descriptor once more, bypassing the page cache
+  static bool GetDirectFileHandle(FileDesc fdesc, FileDesc* direct_ptr);
+  // Reads size bytes at the file offset, returns the bytes read until EOF or -1 on failure
+  static int64_t ReadFileDesc(FileDesc fdesc, void* buf, size_t size, uint64_t foffset);
 
   // Returns the file name & file offset of mapped memory if the file is mapped.
   static bool FindFileNameFromAddress(const void* image, std::string* fname_ptr,
@@ -234,6 +238,8 @@ class Os : AllStatic {
 
   //! NUMA related settings
   static void setPreferredNumaNode(uint32_t node);
+  //! Binds the calling thread to the CPUs of the NUMA node (ROC_NUMA_NODE overrides the node)
+  static void setThreadNumaNode(uint32_t node);
 
   // File/Path helper routines:
   //
@@ -325,8 +325,22 @@ void Os::currentStackInfo(address* base, size_t* size) {
 void Os::setCurrentThreadName(const char* name) { ::prctl(PR_SET_NAME, name); }
 
 void Os::setPreferredNumaNode(uint32_t node) {
+  if (AMD_CPU_AFFINITY) {
+    setThreadNumaNode(node);
+  }
+}
+
+void Os::setThreadNumaNode(uint32_t node) {
 #ifdef ROCCLR_SUPPORT_NUMA_POLICY
-  if (AMD_CPU_AFFINITY && (numa_available() >= 0)) {
+  if (numa_available() >= 0) {
+    if (ROC_NUMA_NODE >= 0) {
+      node = ROC_NUMA_NODE;
+    }
+    if (static_cast<int>(node) > numa_max_node()) {
+      ClPrint(amd::LOG_WARNING, amd::LOG_INIT, "NUMA node %u isn't available", node);
+      return;
+    }
+    ClPrint(amd::LOG_INFO, amd::LOG_INIT, "Binding thread to NUMA node %u", node);
     bitmask* bm = numa_allocate_cpumask();
     numa_node_to_cpus(node, bm);
     if (numa_sched_setaffinity(0, bm) < 0) {
@@ -786,6 +800,38 @@ bool Os::GetFileHandle(const char* fname, FileDesc* fd_ptr, size_t* sz_ptr) {
   return true;
 }
 
+bool Os::GetDirectFileHandle(FileDesc fdesc, FileDesc* direct_ptr) {
+  if ((fdesc < 0) || (direct_ptr == nullptr)) {
+    return false;
+  }
+
+  // O_DIRECT can't be toggled safely on a descriptor shared with the app, so open a new one
+  char path[64];
+  snprintf(path, sizeof(path), "/proc/self/fd/%d", fdesc);
+  *direct_ptr = open(path, O_RDONLY | O_DIRECT);
+  return (*direct_ptr >= 0);
+}
+
+int64_t Os::ReadFileDesc(FileDesc fdesc, void* buf, size_t size, uint64_t foffset) {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t bytes = pread(fdesc, reinterpret_cast<char*>(buf) + done, size - done,
+                          static_cast<off_t>(foffset + done));
+    if (bytes < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    if (bytes == 0) {
+      // End of file
+      break;
+    }
+    done += bytes;
+  }
+  return static_cast<int64_t>(done);
+}
+
 bool amd::Os::FindFileNameFromAddress(const void* image, std::string* fname_ptr,
                                       size_t* foffset_ptr) {
 
@@ -252,6 +252,8 @@ void Os::setCurrentThreadName(const char* name) { SetThreadName(GetCurrentThread
 
 void Os::setPreferredNumaNode(uint32_t node) {};
 
+void Os::setThreadNumaNode(uint32_t node) {};
+
 static LONG WINAPI divExceptionFilter(struct _EXCEPTION_POINTERS* ep) {
   DWORD code = ep->ExceptionRecord->ExceptionCode;
 
@@ -608,6 +610,39 @@ bool Os::GetFileHandle(const char* fname, FileDesc* fd_ptr, size_t* sz_ptr) {
   return true;
 }
 
+bool Os::GetDirectFileHandle(FileDesc fdesc, FileDesc* direct_ptr) {
+  if ((fdesc == INVALID_HANDLE_VALUE) || (direct_ptr == nullptr)) {
+    return false;
+  }
+
+  *direct_ptr = ReOpenFile(fdesc, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                           FILE_FLAG_NO_BUFFERING);
+  return (*direct_ptr != INVALID_HANDLE_VALUE);
+}
+
+int64_t Os::ReadFileDesc(FileDesc fdesc, void* buf, size_t size, uint64_t foffset) {
+  size_t done = 0;
+  while (done < size) {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(foffset + done);
+    overlapped.OffsetHigh = static_cast<DWORD>((foffset + done) >> 32);
+    DWORD chunk = static_cast<DWORD>(std::min<size_t>(size - done, 1u << 30));
+    DWORD bytes = 0;
+    if (!ReadFile(fdesc, reinterpret_cast<char*>(buf) + done, chunk, &bytes, &overlapped)) {
+      if (GetLastError() == ERROR_HANDLE_EOF) {
+        break;
+      }
+      return -1;
+    }
+    if (bytes == 0) {
+      // End of file
+      break;
+    }
+    done += bytes;
+  }
+  return static_cast<int64_t>(done);
+}
+
 bool Os::MemoryMapFileDesc(FileDesc fdesc, size_t fsize, size_t foffset, const void** mmap_ptr) {
   if (fdesc == INVALID_HANDLE_VALUE) {
     return false;
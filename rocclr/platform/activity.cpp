@@ -24,6 +24,11 @@
 #include "platform/command_utils.hpp"
 
 #include <atomic>
+#include <condition_variable>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace amd::activity_prof {
 
@@ -42,6 +47,138 @@ static inline size_t linearSize(const amd::Coord3D& size3d) {
   return size;
 }
 
+namespace {
+//! Activity records of a queue, which wait for the delivery to the profiler
+struct ActivityBuffer {
+  std::mutex lock_;                         //!< Guards the records
+  std::vector<activity_record_t> records_;  //!< The records of the queue
+  std::vector<std::string> names_;          //!< Kernel names of the dispatch records
+};
+
+//! Accumulates the activity records per queue and delivers them to the profiler in batches,
+//! when a buffer is full or in the background every ROC_ACTIVITY_FLUSH_INTERVAL ms
+class ActivityBatcher {
+ public:
+  ActivityBatcher() : thread_(&ActivityBatcher::run, this) {}
+
+  //! Queues a copy of the record. The kernel name is copied, since the kernel can be destroyed
+  void add(const activity_record_t& record, const char* kernel_name) {
+    ActivityBuffer* buffer = find(record.device_id, record.queue_id);
+    bool full = false;
+    {
+      std::lock_guard<std::mutex> lock(buffer->lock_);
+      buffer->records_.push_back(record);
+      buffer->names_.emplace_back((kernel_name != nullptr) ? kernel_name : "");
+      full = buffer->records_.size() >= ROC_ACTIVITY_BATCH_SIZE;
+    }
+    if (full) {
+      deliver(*buffer);
+    }
+  }
+
+  //! Delivers the records of all queues
+  void flush() {
+    std::vector<ActivityBuffer*> buffers;
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      for (const auto& it : buffers_) {
+        buffers.push_back(it.second.get());
+      }
+    }
+    for (auto buffer : buffers) {
+      deliver(*buffer);
+    }
+  }
+
+ private:
+  //! Returns the buffer of the queue. The buffers live until the process exit,
+  //! so the last one is cached in the thread
+  ActivityBuffer* find(int device_id, uint64_t queue_id) {
+    thread_local ActivityBuffer* last = nullptr;
+    thread_local std::pair<int, uint64_t> last_key;
+    const auto key = std::make_pair(device_id, queue_id);
+    if ((last != nullptr) && (last_key == key)) {
+      return last;
+    }
+    std::lock_guard<std::mutex> lock(lock_);
+    auto& buffer = buffers_[key];
+    if (buffer == nullptr) {
+      buffer = std::make_unique<ActivityBuffer>();
+      buffer->records_.reserve(ROC_ACTIVITY_BATCH_SIZE);
+      buffer->names_.reserve(ROC_ACTIVITY_BATCH_SIZE);
+    }
+    last = buffer.get();
+    last_key = key;
+    return last;
+  }
+
+  void deliver(ActivityBuffer& buffer) {
+    std::vector<activity_record_t> records;
+    std::vector<std::string> names;
+    // Serialize the deliveries, so the profiler receives the records of a queue in order
+    std::lock_guard<std::mutex> deliver_lock(deliverLock_);
+    {
+      std::lock_guard<std::mutex> lock(buffer.lock_);
+      if (buffer.records_.empty()) {
+        return;
+      }
+      records.swap(buffer.records_);
+      names.swap(buffer.names_);
+      buffer.records_.reserve(ROC_ACTIVITY_BATCH_SIZE);
+      buffer.names_.reserve(ROC_ACTIVITY_BATCH_SIZE);
+    }
+    auto function = report_activity.load(std::memory_order_relaxed);
+    if (function == nullptr) {
+      return;
+    }
+    for (size_t i = 0; i < records.size(); ++i) {
+      if ((records[i].kind == CL_COMMAND_NDRANGE_KERNEL) || (records[i].kind == CL_COMMAND_TASK)) {
+        records[i].kernel_name = names[i].c_str();
+      }
+      function(ACTIVITY_DOMAIN_HIP_OPS, records[i].op, &records[i]);
+    }
+  }
+
+  void run() {
+    std::unique_lock<std::mutex> lock(wakeupLock_);
+    while (true) {
+      wakeup_.wait_for(lock, std::chrono::milliseconds(std::max(ROC_ACTIVITY_FLUSH_INTERVAL, 1U)));
+      flush();
+    }
+  }
+
+  std::mutex lock_;          //!< Guards buffers_
+  std::mutex deliverLock_;   //!< Serializes the calls of the profiler callback
+  std::mutex wakeupLock_;    //!< Lock for the wait of the flush thread
+  std::condition_variable wakeup_;  //!< Wait of the flush thread
+  std::map<std::pair<int, uint64_t>, std::unique_ptr<ActivityBuffer>> buffers_;
+  std::thread thread_;       //!< The flush thread
+};
+
+std::once_flag batcherOnce;
+ActivityBatcher* batcher = nullptr;
+
+// ================================================================================================
+void Deliver(activity_op_t operation_id, activity_record_t& record) {
+  if (ROC_ACTIVITY_BATCH_SIZE > 1) {
+    // The batcher and its thread are never destroyed, since the completion callbacks
+    // can report records during the process exit
+    std::call_once(batcherOnce, [] { batcher = new ActivityBatcher(); });
+    batcher->add(record, (record.kind == CL_COMMAND_NDRANGE_KERNEL ||
+                          record.kind == CL_COMMAND_TASK) ? record.kernel_name : nullptr);
+  } else if (auto function = report_activity.load(std::memory_order_relaxed)) {
+    function(ACTIVITY_DOMAIN_HIP_OPS, operation_id, &record);
+  }
+}
+}  // namespace
+
+// ================================================================================================
+void FlushActivity() {
+  if (batcher != nullptr) {
+    batcher->flush();
+  }
+}
+
 bool IsEnabled(OpId operation_id) {
   if (operation_id < OP_ID_NUMBER)
     if (auto report = report_activity.load(std::memory_order_relaxed))
@@ -110,12 +247,12 @@ void ReportActivity(const amd::Command& command) {
       record.begin_ns = it.first;
       record.end_ns = it.second;
       record.kernel_name = kernel_names[i].c_str();
-      function(ACTIVITY_DOMAIN_HIP_OPS, operation_id, &record);
+      Deliver(operation_id, record);
     }
   } else {
       record.begin_ns = command.profilingInfo().start_;
       record.end_ns = command.profilingInfo().end_;
-      function(ACTIVITY_DOMAIN_HIP_OPS, operation_id, &record);
+      Deliver(operation_id, record);
   }
 }
 
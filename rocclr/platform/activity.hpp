@@ -75,6 +75,8 @@ constexpr OpId OperationId(cl_command_type commandType) {
 
 bool IsEnabled(OpId operation_id);
 void ReportActivity(const amd::Command& command);
+//! Delivers the activity records, batched with ROC_ACTIVITY_BATCH_SIZE, to the profiler
+void FlushActivity();
 
 
 
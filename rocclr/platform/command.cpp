@@ -337,6 +337,22 @@ void* Command::operator new(size_t size) {
   }
 }
 
+// ================================================================================================
+void PacketReplayCommand::submit(device::VirtualDevice& device) {
+  {
+    amd::ScopedLock lock(device.execution());
+    // Publish all packets with a single doorbell write
+    device.BeginDoorbellBatch();
+    for (const auto& it : packets_) {
+      for (auto packet : *it.first) {
+        device.dispatchAqlPacket(packet, *it.second, this);
+      }
+    }
+    device.EndDoorbellBatch();
+  }
+  AccumulateCommand::submit(device);
+}
+
 // ================================================================================================
 void Command::releaseResources() {
   const Command::EventWaitList& events = eventWaitList();
@@ -643,6 +659,10 @@ bool MigrateMemObjectsCommand::validateMemory() {
   if (queue()->context().devices().size() == 1) {
     return true;
   }
+  // A migration to the host doesn't need memory on the queue device
+  if (migrationFlags_ & CL_MIGRATE_MEM_OBJECT_HOST) {
+    return true;
+  }
   for (const auto& it : memObjects_) {
     device::Memory* mem = it->getDeviceMemory(queue()->device());
     if (NULL == mem) {
@@ -798,12 +818,42 @@ bool CopyMemoryP2PCommand::validateMemory() {
   return true;
 }
 
+// ================================================================================================
+SvmPrefetchAsyncCommand::SvmPrefetchAsyncCommand(HostQueue& queue,
+                                                 const EventWaitList& eventWaitList,
+                                                 std::vector<Range>&& ranges, amd::Device* dev,
+                                                 bool cpu_access)
+    : Command(queue, 1, eventWaitList), ranges_(std::move(ranges)),
+      cpu_access_(cpu_access), dev_(dev) {
+  assert(!ranges_.empty() && "invalid");
+  std::sort(ranges_.begin(), ranges_.end(), [](const Range& a, const Range& b) {
+    return a.dev_ptr_ < b.dev_ptr_;
+  });
+  // Merge the ranges, which touch or overlap the previous one
+  size_t last = 0;
+  for (size_t i = 1; i < ranges_.size(); ++i) {
+    const char* start = reinterpret_cast<const char*>(ranges_[last].dev_ptr_);
+    const char* end = start + ranges_[last].count_;
+    const char* begin = reinterpret_cast<const char*>(ranges_[i].dev_ptr_);
+    if (begin <= end) {
+      // Extend the previous range up to the end of the current one
+      ranges_[last].count_ = std::max(end, begin + ranges_[i].count_) - start;
+    } else {
+      ranges_[++last] = ranges_[i];
+    }
+  }
+  ranges_.resize(last + 1);
+}
+
 // ================================================================================================
 bool SvmPrefetchAsyncCommand::validateMemory() {
-  amd::Memory* svmMem = amd::MemObjMap::FindMemObj(dev_ptr());
-  if (nullptr == svmMem) {
-    LogPrintfError("SvmPrefetchAsync received unknown memory for prefetch: %p!", dev_ptr());
-    return false;
+  for (const auto& range : ranges_) {
+    amd::Memory* svmMem = amd::MemObjMap::FindMemObj(range.dev_ptr_);
+    if (nullptr == svmMem) {
+      LogPrintfError("SvmPrefetchAsync received unknown memory for prefetch: %p!",
+                     range.dev_ptr_);
+      return false;
+    }
   }
   return true;
 }
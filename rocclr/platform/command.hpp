@@ -79,7 +79,8 @@ class Event : public RuntimeObject {
   };
 
  public:
-  typedef std::vector<Event*> EventWaitList;
+  //! Most commands wait on a few events at most, hence keep them inline
+  typedef SmallVector<Event*, 4> EventWaitList;
 
  private:
   Monitor lock_;
@@ -250,6 +251,9 @@ union CopyMetadata {
 class GraphKernelArgManager {
  public:
   virtual address AllocKernArg(size_t size, size_t alignment) = 0;
+  //! Returns the kernel args address for the AQL packet. The manager may return
+  //! a different location from AllocKernArg(), where the capture writes the args
+  virtual address KernArgAddress(address kernArg) const { return kernArg; }
 };
 
 /*! \brief An operation that is submitted to a command queue.
@@ -347,6 +351,11 @@ class Command : public Event {
     return graphKernArgMgr_->AllocKernArg(size, alignment);
   }
 
+  //! Returns the kernel args address for the captured AQL packet
+  address getKernArgAddress(address kernArg) const {
+    return graphKernArgMgr_->KernArgAddress(kernArg);
+  }
+
   //! Overload new/delete for fast commands allocation/destruction
   void* operator new(size_t size);
   void operator delete(void* ptr);
@@ -1137,6 +1146,7 @@ class NDRangeKernelCommand : public Command {
     CooperativeGroups = 0x01,
     CooperativeMultiDeviceGroups = 0x02,
     AnyOrderLaunch = 0x04,
+    HierarchicalGridSync = 0x08,
   };
 
   //! Construct an ExecuteKernel command
@@ -1183,6 +1193,11 @@ class NDRangeKernelCommand : public Command {
   //! Returns extra Param, set when using anyorder launch
   bool getAnyOrderLaunchFlag() const { return (extraParam_ & AnyOrderLaunch) ? true : false; }
 
+  //! Return TRUE if the grid sync uses the runtime hierarchical barrier
+  bool hierarchicalGridSync() const {
+    return (extraParam_ & HierarchicalGridSync) ? true : false;
+  }
+
   //! Return the current grid ID for multidevice launch
   uint32_t gridId() const { return gridId_; }
 
@@ -1329,6 +1344,27 @@ class AccumulateCommand : public Command {
   }
 };
 
+/*! \brief Dispatches previously captured AQL packets with a single completion.
+ *
+ *  The packets are dispatched when the command is submitted, so they stay ordered with
+ *  the other commands of the queue, regardless of the direct dispatch mode.
+ */
+class PacketReplayCommand : public AccumulateCommand {
+ public:
+  //! Captured packets of one command and the name of the kernel
+  typedef std::pair<const std::vector<uint8_t*>*, const std::string*> Packets;
+
+  PacketReplayCommand(HostQueue& queue, const EventWaitList& eventWaitList,
+                      std::vector<Packets>&& packets)
+      : AccumulateCommand(queue, eventWaitList), packets_(std::move(packets)) {}
+
+  //! Dispatches the packets and the completion
+  virtual void submit(device::VirtualDevice& device);
+
+ private:
+  std::vector<Packets> packets_;  //!< Packets in the dispatch order, owned by the caller
+};
+
 /*! \brief  Maps CL objects created from external ones and syncs the contents (blocking).
  *
  */
@@ -1767,55 +1803,103 @@ class CopyMemoryP2PCommand : public CopyMemoryCommand {
  *  \details    Prefetches SVM memory into the destination device or CPU
  */
 class SvmPrefetchAsyncCommand : public Command {
-  const void* dev_ptr_;   //!< Device pointer to memory for prefetch
-  size_t count_;          //!< the size for prefetch
-  bool cpu_access_;       //!< Prefetch data into CPU location
-  amd::Device* dev_;      //!< Destination device to prefetch to
+ public:
+  //! A range of the batched prefetch
+  struct Range {
+    const void* dev_ptr_;   //!< Device pointer to memory for prefetch
+    size_t count_;          //!< the size for prefetch
+  };
+
+ private:
+  std::vector<Range> ranges_;  //!< Ranges for prefetch, sorted and coalesced for a batch
+  bool cpu_access_;            //!< Prefetch data into CPU location
+  amd::Device* dev_;           //!< Destination device to prefetch to
 
  public:
   SvmPrefetchAsyncCommand(HostQueue& queue, const EventWaitList& eventWaitList,
                           const void* dev_ptr, size_t count, amd::Device* dev, bool cpu_access)
-      : Command(queue, 1, eventWaitList), dev_ptr_(dev_ptr), count_(count),
+      : Command(queue, 1, eventWaitList), ranges_({{dev_ptr, count}}),
         cpu_access_(cpu_access), dev_(dev) {}
 
+  //! Construct a batched prefetch. Adjacent and overlapping ranges migrate as a single range
+  SvmPrefetchAsyncCommand(HostQueue& queue, const EventWaitList& eventWaitList,
+                          std::vector<Range>&& ranges, amd::Device* dev, bool cpu_access);
+
   virtual void submit(device::VirtualDevice& device) { device.submitSvmPrefetchAsync(*this); }
 
   bool validateMemory();
 
-  const void* dev_ptr() const { return dev_ptr_; }
-  size_t count() const { return count_; }
+  const void* dev_ptr() const { return ranges_[0].dev_ptr_; }
+  size_t count() const { return ranges_[0].count_; }
+  //! Returns all ranges of the prefetch
+  const std::vector<Range>& ranges() const { return ranges_; }
   amd::Device* device() const { return dev_; }
   size_t cpu_access() const { return cpu_access_; }
 };
 
 /*! \brief  A virtual map memory command.
  *
+ *  \details  The command maps a single range or a batch of ranges. The ranges of a batch are
+ *            processed in order with a single submission, i.e. the tile bindings of a sparse array.
  */
 
 class VirtualMapCommand : public Command {
+ public:
+  //! A range of the batched command
+  struct Range {
+    const void* ptr_;  //!< Virtual address to map to the memory
+    size_t size_;      //!< Size of the mapping in bytes
+    Memory* memory_;   //!< Memory to map, nullptr means unmap
+    size_t offset_;    //!< Offset in the physical memory, where the mapping starts
+  };
+
  private:
-  const void* ptr_;     //!< Virtual address to map to the memory
+  const void* ptr_;           //!< Virtual address to map to the memory
+  std::vector<Range> batch_;  //!< All ranges of the batched command, empty for a single range
 
 protected:
   Memory* memory_;  //!< Memory to map, nullptr means unmap
   size_t size_;     //!< Size of the mapping in bytes
+  size_t offset_;   //!< Offset in the physical memory, where the mapping starts
 
 public:
   //! Construct a new VirtualMapCommand
   VirtualMapCommand(HostQueue& queue, const EventWaitList& eventWaitList,
-                   void* ptr, size_t size, Memory* memory)
+                   void* ptr, size_t size, Memory* memory, size_t offset = 0)
       : Command(queue, 1, eventWaitList),
         ptr_(ptr),
+        memory_(memory),
         size_(size),
-        memory_(memory) {
+        offset_(offset) {
     // Sanity checks
     assert(size > 0 && "invalid");
     if (memory_) memory_->retain();
   }
 
+  //! Construct a new batched VirtualMapCommand
+  VirtualMapCommand(HostQueue& queue, const EventWaitList& eventWaitList,
+                    std::vector<Range>&& batch)
+      : Command(queue, 1, eventWaitList),
+        ptr_(batch.empty() ? nullptr : batch[0].ptr_),
+        batch_(std::move(batch)),
+        memory_(nullptr),
+        size_(0),
+        offset_(0) {
+    // Sanity checks
+    assert(!batch_.empty() && "invalid");
+    for (const auto& range : batch_) {
+      assert(range.size_ > 0 && "invalid");
+      if (range.memory_) range.memory_->retain();
+    }
+  }
+
   virtual void releaseResources() {
     if (memory_) memory_->release();
     DEBUG_ONLY(memory_ = nullptr);
+    for (const auto& range : batch_) {
+      if (range.memory_) range.memory_->release();
+    }
+    batch_.clear();
     Command::releaseResources();
   }
 
@@ -1827,6 +1911,196 @@ public:
   size_t size() const { return size_; }
   //! Read the pointer
   const void* ptr() const { return ptr_; }
+  //! Read the offset in the physical memory
+  size_t offset() const { return offset_; }
+
+  //! Returns the number of the ranges in the command
+  size_t count() const { return batch_.empty() ? 1 : batch_.size(); }
+  //! Returns a range of the command
+  Range range(size_t idx) const {
+    return batch_.empty() ? Range{ptr_, size_, memory_, offset_} : batch_[idx];
+  }
+};
+
+/*! \brief  A batch of independent linear copies.
+ *
+ *  \details   The copies have no ordering between each other, so the backend
+ *              may execute all of them in a single operation.
+ */
+
+class CopyMemoryBatchCommand : public Command {
+ public:
+  struct Copy {
+    Memory* src_;       //!< Source memory object
+    Memory* dst_;       //!< Destination memory object
+    size_t srcOffset_;  //!< Offset in bytes in the source
+    size_t dstOffset_;  //!< Offset in bytes in the destination
+    size_t size_;       //!< Number of bytes to copy
+  };
+
+ private:
+  std::vector<Copy> copies_;  //!< The list of copies in the batch
+
+ public:
+  //! Construct a new CopyMemoryBatchCommand
+  CopyMemoryBatchCommand(HostQueue& queue, const EventWaitList& eventWaitList,
+                         std::vector<Copy>&& copies)
+      : Command(queue, CL_COMMAND_COPY_BUFFER, eventWaitList, AMD_SERIALIZE_COPY),
+        copies_(std::move(copies)) {
+    // Sanity checks
+    assert(!copies_.empty() && "invalid");
+    for (auto& copy : copies_) {
+      copy.src_->retain();
+      copy.dst_->retain();
+    }
+  }
+
+  virtual void releaseResources() {
+    for (auto& copy : copies_) {
+      copy.src_->release();
+      copy.dst_->release();
+    }
+    copies_.clear();
+    Command::releaseResources();
+  }
+
+  virtual void submit(device::VirtualDevice& device) { device.submitCopyMemoryBatch(*this); }
+
+  //! Returns the list of copies
+  const std::vector<Copy>& copies() const { return copies_; }
+};
+
+/*! \brief  A batch of independent linear byte fills.
+ *
+ *  \details   The fills have no ordering between each other, so the backend
+ *              may execute all of them in a single operation.
+ */
+
+class FillMemoryBatchCommand : public Command {
+ public:
+  struct Fill {
+    Memory* dst_;    //!< Destination memory object
+    size_t offset_;  //!< Offset in bytes in the destination
+    uint8_t value_;  //!< Byte value of the fill
+    size_t size_;    //!< Number of bytes to fill
+  };
+
+ private:
+  std::vector<Fill> fills_;  //!< The list of fills in the batch
+
+ public:
+  //! Construct a new FillMemoryBatchCommand
+  FillMemoryBatchCommand(HostQueue& queue, const EventWaitList& eventWaitList,
+                         std::vector<Fill>&& fills)
+      : Command(queue, CL_COMMAND_FILL_BUFFER, eventWaitList, AMD_SERIALIZE_COPY),
+        fills_(std::move(fills)) {
+    // Sanity checks
+    assert(!fills_.empty() && "invalid");
+    for (auto& fill : fills_) {
+      fill.dst_->retain();
+    }
+  }
+
+  virtual void releaseResources() {
+    for (auto& fill : fills_) {
+      fill.dst_->release();
+    }
+    fills_.clear();
+    Command::releaseResources();
+  }
+
+  virtual void submit(device::VirtualDevice& device) { device.submitFillMemoryBatch(*this); }
+
+  //! Returns the list of fills
+  const std::vector<Fill>& fills() const { return fills_; }
+};
+
+/*! \brief  Streams a file region into a memory object.
+ *
+ *  \details   The file descriptor belongs to the application and must stay
+ *              open until the command completes.
+ */
+
+class CopyFileToMemoryCommand : public OneMemoryArgCommand {
+ private:
+  Os::FileDesc fileDesc_;  //!< The source file descriptor
+  uint64_t fileOffset_;    //!< Offset in bytes in the file
+  size_t offset_;          //!< Offset in bytes in the destination
+  size_t size_;            //!< Number of bytes to copy
+
+ public:
+  //! Construct a new CopyFileToMemoryCommand
+  CopyFileToMemoryCommand(HostQueue& queue, const EventWaitList& eventWaitList, Memory& memory,
+                          size_t offset, Os::FileDesc fileDesc, uint64_t fileOffset, size_t size)
+      : OneMemoryArgCommand(queue, CL_COMMAND_WRITE_BUFFER, eventWaitList, memory),
+        fileDesc_(fileDesc),
+        fileOffset_(fileOffset),
+        offset_(offset),
+        size_(size) {
+    // Sanity checks
+    assert(size > 0 && "invalid");
+  }
+
+  virtual void submit(device::VirtualDevice& device) { device.submitCopyFileToMemory(*this); }
+
+  //! Return the memory object to write to
+  Memory& destination() const { return *memory_; }
+
+  //! Return the file descriptor to read from
+  Os::FileDesc fileDesc() const { return fileDesc_; }
+
+  //! Return the offset in the file
+  uint64_t fileOffset() const { return fileOffset_; }
+
+  //! Return the offset in the destination memory
+  size_t offset() const { return offset_; }
+
+  //! Return the copy size
+  size_t size() const { return size_; }
+};
+
+/*! \brief  Conditional execution of a graph body.
+ *
+ *  \details   The predicate in device memory is evaluated on the GPU. While it isn't zero, the
+ *              packets of the body are dispatched into the body queue, which must be different
+ *              from the queue of the command.
+ */
+
+class GraphConditionCommand : public Command {
+ private:
+  const void* predicate_;   //!< Device address of the uint32_t predicate
+  const void* packets_;     //!< Device graph: the number of packets, followed by the packets
+  HostQueue* bodyQueue_;    //!< Queue, which executes the body
+  void* signal_;            //!< Signal handle, which marks the end of an iteration
+  bool loop_;               //!< Repeat the body until the predicate is zero
+
+ public:
+  //! Construct a new GraphConditionCommand
+  GraphConditionCommand(HostQueue& queue, const EventWaitList& eventWaitList,
+                        const void* predicate, const void* packets, HostQueue& bodyQueue,
+                        void* signal, bool loop)
+      : Command(queue, ROCCLR_COMMAND_GRAPH_CONDITION, eventWaitList),
+        predicate_(predicate),
+        packets_(packets),
+        bodyQueue_(&bodyQueue),
+        signal_(signal),
+        loop_(loop) {
+    // Sanity checks
+    assert((predicate_ != nullptr) && (packets_ != nullptr) && "invalid");
+  }
+
+  virtual void submit(device::VirtualDevice& device) { device.submitGraphCondition(*this); }
+
+  //! Return the predicate address
+  const void* predicate() const { return predicate_; }
+  //! Return the device graph of the body
+  const void* packets() const { return packets_; }
+  //! Return the queue of the body
+  HostQueue& bodyQueue() const { return *bodyQueue_; }
+  //! Return the signal handle
+  void* signal() const { return signal_; }
+  //! Return true if the body repeats
+  bool loop() const { return loop_; }
 };
 
 //! Union used in memory suballocator, must be updated with the new commands
@@ -1843,6 +2117,7 @@ union ComputeCommand {
   ExternalSemaphoreCmd          cmd9;
   Marker                        cmd10;
   AccumulateCommand             cmd11;
+  PacketReplayCommand           cmd12;
   AcquireExtObjectsCommand      cmd13;
   ReleaseExtObjectsCommand      cmd14;
   PerfCounterCommand            cmd15;
@@ -1858,6 +2133,10 @@ union ComputeCommand {
   CopyMemoryP2PCommand          cmd25;
   SvmPrefetchAsyncCommand       cmd26;
   VirtualMapCommand             cmd27;
+  CopyMemoryBatchCommand        cmd28;
+  CopyFileToMemoryCommand       cmd29;
+  GraphConditionCommand         cmd30;
+  FillMemoryBatchCommand        cmd31;
   ComputeCommand() {}
   ~ComputeCommand() {}
 };
@@ -24,6 +24,8 @@
 // Dummy command types for Stream Wait and Write commands.
 #define ROCCLR_COMMAND_STREAM_WAIT_VALUE 0x4501
 #define ROCCLR_COMMAND_STREAM_WRITE_VALUE 0x4502
+// Dummy command type for the conditional execution of a graph body
+#define ROCCLR_COMMAND_GRAPH_CONDITION 0x4503
 
 // Stream Wait Value Conidtions
 #define ROCCLR_STREAM_WAIT_VALUE_GTE 0x0
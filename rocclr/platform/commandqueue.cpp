@@ -37,6 +37,7 @@ HostQueue::HostQueue(Context& context, Device& device, cl_command_queue_properti
                      uint queueRTCUs, Priority priority, const std::vector<uint32_t>& cuMask)
     : CommandQueue(context, device, props, device.info().queueProperties_, queueRTCUs,
                    priority, cuMask),
+      workerWaiting_(false),
       lastEnqueueCommand_(nullptr),
       head_(nullptr),
       tail_(nullptr),
@@ -197,13 +198,23 @@ void HostQueue::loop(device::VirtualDevice* virtualDevice) {
     // Get one command from the queue
     Command* command = queue_.dequeue();
     if (command == NULL) {
+      {
+        // Expose the deferred packets to the HW, since no more work follows them for now
+        ScopedLock el(virtualDevice->execution());
+        virtualDevice->RingDeferredDoorbell();
+      }
       ScopedLock sl(queueLock_);
+      // Publish the sleep before the last queue check, so a producer either sees
+      // the flag and notifies or its command is dequeued here
+      workerWaiting_.store(true, std::memory_order_seq_cst);
       while ((command = queue_.dequeue()) == NULL) {
         if (!thread_.acceptingCommands_) {
+          workerWaiting_.store(false, std::memory_order_relaxed);
           return;
         }
         queueLock_.wait();
       }
+      workerWaiting_.store(false, std::memory_order_relaxed);
     }
 
     command->retain();
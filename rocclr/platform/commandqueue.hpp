@@ -48,6 +48,13 @@ class CommandQueue : public RuntimeObject {
  public:
   static constexpr uint RealTimeDisabled = 0xffffffff;
   enum class Priority : uint { Low = 0, Normal, Medium, High };
+  //! Host wait policy for the queue completion signals
+  enum class WaitPolicy : uint {
+    Default = 0,  //!< Active wait for a short time, then blocked wait (device settings)
+    Spin,         //!< Active wait only, for the latency critical queues
+    Blocking,     //!< Blocked wait right away, for the background queues
+    Adaptive      //!< Active wait for the predicted completion time, then blocked wait
+  };
 
   struct Properties {
     typedef cl_command_queue_properties value_type;
@@ -111,6 +118,12 @@ class CommandQueue : public RuntimeObject {
   //! Returns the CU mask array
   const std::vector<uint32_t>& cuMask() const { return cuMask_; }
 
+  //! Returns the host wait policy
+  WaitPolicy waitPolicy() const { return waitPolicy_; }
+
+  //! Sets the host wait policy, must be called before the queue creation
+  void setWaitPolicy(WaitPolicy policy) { waitPolicy_ = policy; }
+
   //! Returns the queue lock
   Monitor& lock() { return queueLock_; }
 
@@ -142,6 +155,7 @@ class CommandQueue : public RuntimeObject {
   Device& device_;                      //!< The device
   SharedReference<Context> context_;    //!< The context of this command queue
   const std::vector<uint32_t> cuMask_;  //!< The CU mask
+  WaitPolicy waitPolicy_ = WaitPolicy::Default; //!< Host wait policy
 
  private:
   //! Disable copy constructor
@@ -167,6 +181,10 @@ class HostQueue : public CommandQueue {
     //! The command queue thread entry point.
     void run(void* data) {
       HostQueue* queue = static_cast<HostQueue*>(data);
+      if (ROC_NUMA_AFFINITY) {
+        // Keep the submission thread and its allocations on the socket of the GPU
+        Os::setThreadNumaNode(queue->device().getPreferredNumaNode());
+      }
       virtualDevice_ = queue->device().createVirtualDevice(queue);
       if (virtualDevice_ != nullptr) {
         queue->loop(virtualDevice_);
@@ -196,6 +214,7 @@ class HostQueue : public CommandQueue {
 
  private:
   ConcurrentLinkedQueue<Command*> queue_;  //!< The queue.
+  std::atomic_bool workerWaiting_;         //!< The command loop is parked on queueLock_
 
   Command* lastEnqueueCommand_;  //!< The last submitted command
 
@@ -226,8 +245,13 @@ class HostQueue : public CommandQueue {
 
   //! Signal to start processing the commands in the queue.
   void flush() {
-    ScopedLock sl(queueLock_);
-    queueLock_.notify();
+    // The command loop drains the queue without the lock while it is awake, so the
+    // producers only have to take queueLock_ when the loop went to sleep.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (workerWaiting_.load(std::memory_order_relaxed)) {
+      ScopedLock sl(queueLock_);
+      queueLock_.notify();
+    }
   }
 
   //! Finish all queued commands
@@ -27,6 +27,40 @@
 
 namespace amd {
 
+namespace {
+//! Per-thread memo of the memory objects, resolved for the pointer arguments of the last
+//! launched kernel. Relaunches usually pass the same pointers and change only a few scalars,
+//! so an unchanged pointer reuses the memory object without the MemObjMap lookup.
+struct ArgMemObjCache {
+  const KernelParameters* owner_ = nullptr;  //!< Parameters, which filled the slots
+  uint64_t generation_ = ~0ULL;              //!< MemObjMap generation of the slots
+  std::vector<std::pair<const void*, Memory*>> slots_;  //!< Pointer and its memory object
+};
+thread_local ArgMemObjCache argMemObjCache;
+
+// =================================================================================================
+//! Returns the memory object of the pointer argument in the \a slot of the memory objects
+Memory* FindArgMemObj(const KernelParameters* owner, size_t numSlots, size_t slot,
+                      const void* ptr) {
+  ArgMemObjCache& cache = argMemObjCache;
+  const uint64_t generation = MemObjMap::Generation();
+  if ((cache.owner_ != owner) || (cache.generation_ != generation)) {
+    // A removal from the map may have destroyed the memory objects in the slots
+    cache.owner_ = owner;
+    cache.generation_ = generation;
+    cache.slots_.assign(numSlots, {nullptr, nullptr});
+  }
+  auto& entry = cache.slots_[slot];
+  if ((entry.first == ptr) && (entry.second != nullptr)) {
+    return entry.second;
+  }
+  // The pointers without a memory object aren't cached, since it may be added later
+  entry.first = ptr;
+  entry.second = MemObjMap::FindMemObj(ptr);
+  return entry.second;
+}
+}  // namespace
+
 Kernel::Kernel(Program& program, const Symbol& symbol, const std::string& name)
     : program_(program), symbol_(symbol), name_(name) {
   parameters_ = new (signature()) KernelParameters(const_cast<KernelSignature&>(signature()));
@@ -105,6 +139,27 @@ address KernelParameters::alloc(device::VirtualDevice& vDev) {
 
 // =================================================================================================
 bool KernelParameters::captureAndSet(void** kernelParams, address kernArgs, address mem) {
+  if ((kernelParams == nullptr) && (signature_.packedSize() != 0)) {
+    // The packed buffer has the layout of the kernel arguments, hence copy it at once and
+    // resolve only the memory objects of the pointer arguments
+    ::memcpy(mem, kernArgs, signature_.packedSize());
+    amd::Memory** memories = reinterpret_cast<amd::Memory**>(mem + memoryObjOffset());
+    for (size_t idx = 0; idx < signature_.numParameters(); ++idx) {
+      KernelParameterDescriptor& desc = signature_.params()[idx];
+      if (desc.type_ == T_POINTER) {
+        Memory* memArg = FindArgMemObj(this, signature_.numMemories(), desc.info_.arrayIndex_,
+            *reinterpret_cast<const void* const*>(kernArgs + desc.offset_));
+        memories[desc.info_.arrayIndex_] = memArg;
+        if (memArg != nullptr) {
+          memArg->retain();
+        }
+        desc.info_.rawPointer_ = true;
+      }
+      desc.info_.defined_ = true;
+    }
+    execInfoOffset_ = totalSize_;
+    return true;
+  }
 
   for (size_t idx = 0; idx < signature_.numParameters(); ++idx) {
     KernelParameterDescriptor& desc = signature_.params()[idx];
@@ -121,7 +176,8 @@ bool KernelParameters::captureAndSet(void** kernelParams, address kernArgs, addr
     amd::Memory** memories = reinterpret_cast<amd::Memory**>(mem + memoryObjOffset());
     if (desc.type_ == T_POINTER && (desc.addressQualifier_ != CL_KERNEL_ARG_ADDRESS_LOCAL)) {
       LP64_SWITCH(uint32_value, uint64_value) = *(LP64_SWITCH(uint32_t*, uint64_t*))value;
-      memArg = amd::MemObjMap::FindMemObj(*reinterpret_cast<const void* const*>(value));
+      memArg = FindArgMemObj(this, signature_.numMemories(), desc.info_.arrayIndex_,
+                             *reinterpret_cast<const void* const*>(value));
       memories[desc.info_.arrayIndex_] = memArg;
       if (memArg != nullptr) {
         memArg->retain();
@@ -185,8 +241,8 @@ void KernelParameters::set(size_t index, size_t size, const void* value, bool sv
     if (svmBound) {
       desc.info_.rawPointer_ = true;
       LP64_SWITCH(uint32_value, uint64_value) = *(LP64_SWITCH(uint32_t*, uint64_t*))value;
-      memoryObjects_[desc.info_.arrayIndex_] = amd::MemObjMap::FindMemObj(
-        *reinterpret_cast<const void* const*>(value));
+      memoryObjects_[desc.info_.arrayIndex_] = FindArgMemObj(this, signature_.numMemories(),
+          desc.info_.arrayIndex_, *reinterpret_cast<const void* const*>(value));
     } else if ((value == NULL) || (static_cast<const cl_mem*>(value) == NULL)) {
       desc.info_.rawPointer_ = false;
       memoryObjects_[desc.info_.arrayIndex_] = nullptr;
@@ -386,7 +442,8 @@ KernelSignature::KernelSignature(const std::vector<KernelParameterDescriptor>& p
   , numMemories_(0)
   , numSamplers_(0)
   , numQueues_(0)
-  , version_(version) {
+  , version_(version)
+  , packedSize_(0) {
   size_t maxOffset = 0;
   size_t last = 0;
   // Find the last entry
@@ -431,5 +488,22 @@ KernelSignature::KernelSignature(const std::vector<KernelParameterDescriptor>& p
     // 16 bytes is the current HW alignment for the arguments
     paramsSize_ = alignUp(paramsSize_, 16);
   }
+
+  // A packed buffer can be copied as is, if all explicit arguments are the plain values
+  // or the pointers. The local memory and OCL objects need a conversion
+  size_t packedSize = 0;
+  for (size_t i = 0; i < numParameters_; ++i) {
+    const KernelParameterDescriptor& desc = params_[i];
+    if ((desc.addressQualifier_ == CL_KERNEL_ARG_ADDRESS_LOCAL) || (desc.type_ == T_SAMPLER) ||
+        (desc.type_ == T_QUEUE) ||
+        (desc.info_.oclObject_ == KernelParameterDescriptor::ImageObject) ||
+        (desc.info_.oclObject_ == KernelParameterDescriptor::SamplerObject) ||
+        (desc.info_.oclObject_ == KernelParameterDescriptor::QueueObject)) {
+      packedSize = 0;
+      break;
+    }
+    packedSize = std::max(packedSize, desc.offset_ + desc.size_);
+  }
+  packedSize_ = static_cast<uint32_t>(packedSize);
 }
 }  // namespace amd
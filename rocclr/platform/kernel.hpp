@@ -60,6 +60,7 @@ class KernelSignature : public HeapObject {
   uint32_t  numSamplers_;   //!< The number of sampler objects used in the kernel
   uint32_t  numQueues_;     //!< The number of queue objects used in the kernel
   uint32_t  version_;       //!< The ABI version
+  uint32_t  packedSize_;    //!< The size of a packed buffer, which can be copied as is
 
  public:
   enum {
@@ -71,7 +72,7 @@ class KernelSignature : public HeapObject {
   //! Default constructor
   KernelSignature():
     numParameters_(0), paramsSize_(0), numMemories_(0), numSamplers_(0),
-    numQueues_(0), version_(ABIVersion_0) {}
+    numQueues_(0), version_(ABIVersion_0), packedSize_(0) {}
 
   //! Construct a new signature.
   KernelSignature(const std::vector<KernelParameterDescriptor>& params,
@@ -108,6 +109,10 @@ class KernelSignature : public HeapObject {
   //! Returns the signature version
   uint32_t version() const { return version_; }
 
+  //! Returns the size of the explicit arguments in a packed buffer, which matches
+  //! the kernel arguments layout, or 0 if the arguments require a conversion
+  uint32_t packedSize() const { return packedSize_; }
+
   //! Return the kernel attributes
   const std::string& attributes() const { return attributes_; }
 
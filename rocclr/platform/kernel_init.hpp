@@ -165,7 +165,8 @@ const amd::Kernel::ArgValueKindV3Type amd::Kernel::kArgValueKindV3[] = {
   {"hidden_private_base",       amd::KernelParameterDescriptor::HiddenPrivateBase},
   {"hidden_shared_base",        amd::KernelParameterDescriptor::HiddenSharedBase},
   {"hidden_queue_ptr",          amd::KernelParameterDescriptor::HiddenQueuePtr},
-  {"hidden_dynamic_lds_size",   amd::KernelParameterDescriptor::HiddenDynamicLdsSize}
+  {"hidden_dynamic_lds_size",   amd::KernelParameterDescriptor::HiddenDynamicLdsSize},
+  {"hidden_error_mailbox",      amd::KernelParameterDescriptor::HiddenErrorMailbox}
 };
 
 const amd::Kernel::ArgFieldMapV3Type amd::Kernel::kArgFieldMapV3[] = {
@@ -192,12 +192,17 @@ void Memory::operator delete(void* p, const Context& context) { Memory::operator
 
 void Memory::addSubBuffer(Memory* view) {
   amd::ScopedLock lock(lockMemoryOps());
-  subBuffers_.push_back(view);
+  view->subBufferPos_ = subBuffers_.insert(subBuffers_.end(), view);
+  view->subBufferListed_ = true;
 }
 
 void Memory::removeSubBuffer(Memory* view) {
   amd::ScopedLock lock(lockMemoryOps());
-  subBuffers_.remove(view);
+  // Erase by the saved position, since arenas can carry thousands of subbuffers
+  if ((view->parent_ == this) && view->subBufferListed_) {
+    subBuffers_.erase(view->subBufferPos_);
+    view->subBufferListed_ = false;
+  }
 }
 
 bool Memory::allocHostMemory(void* initFrom, bool allocHostMem, bool forceCopy) {
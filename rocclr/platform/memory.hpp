@@ -45,6 +45,10 @@
 #define ROCCLR_MEM_INTERPROCESS         (1u << 26)
 #define ROCCLR_MEM_PHYMEM               (1u << 25)
 #define ROCCLR_MEM_HSA_CONTIGUOUS       (1u << 24)
+#define ROCCLR_MEM_MALL_PREFERRED       (1u << 23)
+#define ROCCLR_MEM_MALL_BYPASS          (1u << 22)
+#define ROCCLR_MEM_LARGE_PAGE_2M        (1u << 21)
+#define ROCCLR_MEM_LARGE_PAGE_1G        (1u << 20)
 
 namespace amd::device {
 class Memory;
@@ -165,6 +169,8 @@ class Memory : public amd::RuntimeObject {
      size_t depth_ = 0;               //!< Depth value
 
      bool sync_mem_ops_ = false;   //!< Memops sync, when set synchronize all mem operations.
+     bool cacheable_ = false;      //!< hipMalloc() memory, which can be kept in HIP caches
+     bool cached_ = false;         //!< The memory was released into a HIP cache
   };
 
  protected:
@@ -227,6 +233,8 @@ class Memory : public amd::RuntimeObject {
 
   Monitor lockMemoryOps_;          //!< Lock to serialize memory operations
   std::list<Memory*> subBuffers_;  //!< List of all subbuffers for this memory object
+  std::list<Memory*>::iterator subBufferPos_;  //!< The position in the parent's subbuffer list
+  bool subBufferListed_ = false;   //!< The subbuffer is in the parent's list
   device::Memory* svmBase_;        //!< svmBase allocation for MGPU case
 
  protected:
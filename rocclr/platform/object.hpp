@@ -43,7 +43,8 @@
 #define AMD_CL_TYPES_DO(F)                                                                         \
   F(cl_counter_amd, Counter)                                                                       \
   F(cl_perfcounter_amd, PerfCounter)                                                               \
-  F(cl_threadtrace_amd, ThreadTrace)
+  F(cl_threadtrace_amd, ThreadTrace)                                                               \
+  F(cl_command_buffer_khr, CommandBuffer)
 
 #define CL_TYPES_DO(F)                                                                             \
   KHR_CL_TYPES_DO(F)                                                                               \
@@ -144,7 +145,8 @@ class RuntimeObject : public ReferenceCountedObject, public ICDDispatchedObject
     ObjectTypeQueue = 8,
     ObjectTypeSampler = 9,
     ObjectTypeThreadTrace = 10,
-    ObjectTypeVMMAlloc = 11
+    ObjectTypeVMMAlloc = 11,
+    ObjectTypeCommandBuffer = 12
   };
 
   virtual ObjectType objectType() const = 0;
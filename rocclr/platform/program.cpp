@@ -34,6 +34,8 @@
 #include <sstream>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <thread>
 #include <utility>
 
 namespace amd {
@@ -513,9 +515,13 @@ int32_t Program::build(const std::vector<Device*>& devices, const char* options,
   std::string cppstr(options ? options : "");
   optionChangable &= adjustOptionsOnIgnoreEnv(cppstr);
 
+  // Device programs, which require a build, with their options
+  std::vector<std::pair<device::Program*, std::unique_ptr<option::Options>>> builds;
+
   // Build the program programs associated with the given devices.
   for (const auto& it : devices) {
-    option::Options parsedOptions;
+    auto options_ptr = std::make_unique<option::Options>();
+    option::Options& parsedOptions = *options_ptr;
     constexpr bool LinkOptsOnly = false;
     if ((language_ != HIP) && !ParseAllOptions(cppstr, parsedOptions, optionChangable, LinkOptsOnly,
                          it->settings().useLightning_)) {
@@ -555,8 +561,33 @@ int32_t Program::build(const std::vector<Device*>& devices, const char* options,
     if (devProgram->buildStatus() != CL_BUILD_NONE) {
       continue;
     }
-    int32_t result = devProgram->build(sourceCode_, options, &parsedOptions, precompiledHeaders_);
+    builds.emplace_back(devProgram, std::move(options_ptr));
+  }
+
+  // The device programs are independent, so multi-device contexts build them concurrently
+  std::vector<int32_t> results(builds.size(), CL_SUCCESS);
+  auto buildDevice = [&](size_t i) {
+    results[i] = builds[i].first->build(sourceCode_, options, builds[i].second.get(),
+                                        precompiledHeaders_);
+  };
+  if (AMD_OCL_PARALLEL_BUILD && (builds.size() > 1)) {
+    std::vector<std::thread> threads;
+    threads.reserve(builds.size() - 1);
+    for (size_t i = 1; i < builds.size(); ++i) {
+      threads.emplace_back(buildDevice, i);
+    }
+    // The calling thread builds the first device
+    buildDevice(0);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  } else {
+    for (size_t i = 0; i < builds.size(); ++i) {
+      buildDevice(i);
+    }
+  }
 
+  for (const auto result : results) {
     // Check if the previous device failed a build
     if ((result != CL_SUCCESS) && (retval != CL_SUCCESS)) {
       retval = CL_INVALID_OPERATION;
@@ -19,10 +19,12 @@
  THE SOFTWARE. */
 
 #include "platform/runtime.hpp"
+#include "platform/activity.hpp"
 #include "os/os.hpp"
 #include "thread/thread.hpp"
 #include "device/device.hpp"
 #include "utils/flags.hpp"
+#include "utils/metrics.hpp"
 #include "utils/options.hpp"
 #include "platform/context.hpp"
 #include "platform/agent.hpp"
@@ -80,6 +82,7 @@ bool Runtime::init() {
     return false;
   }
 
+  Metrics::init();
   initialized_ = true;
   pid_ = amd::Os::getProcessId();
   return true;
@@ -90,9 +93,13 @@ void Runtime::tearDown() {
     return;
   }
 
+  // Hand the batched activity records to the profiler before the devices go away
+  activity_prof::FlushActivity();
+  Metrics::tearDown();
   Agent::tearDown();
   Device::tearDown();
   option::teardown();
+  log_flush();
   Flag::tearDown();
   if (outFile != stderr && outFile != nullptr) {
     fclose(outFile);
@@ -22,7 +22,10 @@
 #include "thread/semaphore.hpp"
 #include "thread/thread.hpp"
 #include "utils/util.hpp"
+#include "utils/debug.hpp"
+#include "os/os.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <tuple>
@@ -34,16 +37,34 @@ MonitorBase::~MonitorBase() {}
 namespace legacy_monitor {
 
 Monitor::Monitor(bool recursive)
-    : contendersList_(0), onDeck_(0), waitersList_(NULL), owner_(NULL), recursive_(recursive) {}
+    : contendersList_(0), onDeck_(0), waitersList_(NULL), owner_(NULL), recursive_(recursive),
+      spinBudget_(std::min(kMaxSpinIter, std::max(static_cast<int>(DEBUG_CLR_MONITOR_MAX_SPIN),
+                                                   kYieldSpinIter))) {}
+
+void Monitor::updateSpinBudget(int spins, bool acquired) {
+  const int maxSpin = std::max(static_cast<int>(DEBUG_CLR_MONITOR_MAX_SPIN), kYieldSpinIter);
+  int budget = spinBudget_.load(std::memory_order_relaxed);
+  if (acquired) {
+    // The lock was released while spinning: move toward twice the observed hold time
+    int target = std::min(std::max(2 * (spins + 1), kYieldSpinIter), maxSpin);
+    budget = (3 * budget + target + 3) / 4;
+  } else {
+    // The owner held the lock longer than the budget, spinning only burned CPU
+    budget = budget / 2;
+  }
+  spinBudget_.store(std::min(std::max(budget, kYieldSpinIter), maxSpin),
+                    std::memory_order_relaxed);
+}
 
 bool Monitor::trySpinLock() {
   if (tryLock()) {
     return true;
   }
 
-  for (int s = kMaxSpinIter; s > 0; --s) {
+  const int budget = spinBudget_.load(std::memory_order_relaxed);
+  for (int s = 0; s < budget; ++s) {
     // First, be SMT friendly
-    if (s >= (kMaxSpinIter - kMaxReadSpinIter)) {
+    if (s < (budget - kYieldSpinIter)) {
       Os::spinPause();
     }
     // and then SMP friendly
@@ -51,11 +72,14 @@ bool Monitor::trySpinLock() {
       Thread::yield();
     }
     if (!isLocked()) {
-      return tryLock();
+      bool acquired = tryLock();
+      updateSpinBudget(s, acquired);
+      return acquired;
     }
   }
 
   // We could not acquire the lock in the spin loop.
+  updateSpinBudget(budget, false);
   return false;
 }
 
@@ -395,4 +419,28 @@ void Monitor::unlock() {
   finishUnlock();
 }
 } // namespace legacy_monitor
+
+void Monitor::lockWithStats() {
+  if (monitor_->tryLock()) {
+    stats_->acquired_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  uint64_t start = Os::timeNanos();
+  monitor_->lock();
+  stats_->waitNs_.fetch_add(Os::timeNanos() - start, std::memory_order_relaxed);
+  stats_->contended_.fetch_add(1, std::memory_order_relaxed);
+  stats_->acquired_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Monitor::reportStats() const {
+  uint64_t contended = stats_->contended_.load(std::memory_order_relaxed);
+  if (contended != 0) {
+    uint64_t acquired = stats_->acquired_.load(std::memory_order_relaxed);
+    uint64_t waitNs = stats_->waitNs_.load(std::memory_order_relaxed);
+    ClPrint(LOG_INFO, LOG_LOCK,
+            "Monitor %s(%p): acquired %lu, contended %lu (%.1f%%), wait %lu us (avg %lu ns)",
+            (name_ != nullptr) ? name_ : "", this, acquired, contended,
+            (100.0 * contended) / acquired, waitNs / 1000, waitNs / contended);
+  }
+}
 }  // namespace amd
@@ -91,6 +91,8 @@ class Monitor final: public HeapObject, public MonitorBase {
 
   static constexpr int kMaxSpinIter = 55;      //!< Total number of spin iterations.
   static constexpr int kMaxReadSpinIter = 50;  //!< Read iterations before yielding
+  //! Yield iterations at the end of the adaptive spin, also the smallest spin budget
+  static constexpr int kYieldSpinIter = kMaxSpinIter - kMaxReadSpinIter;
 
   /*! Linked list of semaphores the contending threads are waiting on
    *  and main lock.
@@ -108,8 +110,12 @@ class Monitor final: public HeapObject, public MonitorBase {
   uint32_t lockCount_;
   //! True if this is a recursive mutex, false otherwise.
   const bool recursive_;
+  //! Spin iterations before parking, adapted to how long the lock was recently held.
+  std::atomic_int spinBudget_;
 
  private:
+  //! Grow or shrink the spin budget after a spin phase that took \a spins iterations.
+  void updateSpinBudget(int spins, bool acquired);
   //! Finish locking the mutex (contented case).
   void finishLock();
   //! Finish unlocking the mutex (contented case).
@@ -242,24 +248,67 @@ class Monitor final: public HeapObject, public MonitorBase {
 // Monitor API wrapper to user
 class Monitor {
 public:
-  explicit Monitor(bool recursive = false) {
-    if (DEBUG_CLR_USE_STDMUTEX_IN_AMD_MONITOR) {
-      monitor_ = new mutex_monitor::Monitor(recursive);
+  explicit Monitor(bool recursive = false) : name_(nullptr) { init(recursive); }
+
+  /*! \brief Create a named monitor, the name is used in the contention report.
+   *
+   *  \note Named monitors used to bind the name to the recursive flag,
+   *  so they stay recursive by default.
+   */
+  explicit Monitor(const char* name, bool recursive = true) : name_(name) { init(recursive); }
+
+  inline ~Monitor() {
+    if (stats_ != nullptr) {
+      reportStats();
+      delete stats_;
     }
-    else {
-      monitor_ = new legacy_monitor::Monitor(recursive);
+    delete monitor_;
+  };
+  inline bool tryLock() {
+    bool locked = monitor_->tryLock();
+    if (locked && stats_ != nullptr) {
+      stats_->acquired_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return locked;
+  }
+  inline void lock() {
+    if (stats_ == nullptr) {
+      monitor_->lock();
+    } else {
+      lockWithStats();
     }
   }
-  inline ~Monitor() { delete monitor_; };
-  inline bool tryLock() { return monitor_->tryLock(); }
-  inline void lock() { monitor_->lock(); }
   inline void unlock() { monitor_->unlock(); }
   inline void wait() { monitor_->wait(); }
   inline void notify() { monitor_->notify(); }
   inline void notifyAll() { monitor_->notifyAll(); }
 
 private:
+  //! Contention counters, allocated only with DEBUG_CLR_MONITOR_STATS
+  struct Stats : public HeapObject {
+    std::atomic<uint64_t> acquired_{0};   //!< Number of acquisitions
+    std::atomic<uint64_t> contended_{0};  //!< Acquisitions that found the lock owned
+    std::atomic<uint64_t> waitNs_{0};     //!< Total time spent in contended acquisitions
+  };
+
+  void init(bool recursive) {
+    if (DEBUG_CLR_USE_STDMUTEX_IN_AMD_MONITOR) {
+      monitor_ = new mutex_monitor::Monitor(recursive);
+    }
+    else {
+      monitor_ = new legacy_monitor::Monitor(recursive);
+    }
+    stats_ = DEBUG_CLR_MONITOR_STATS ? new Stats() : nullptr;
+  }
+
+  //! Acquire the lock and account the contention
+  void lockWithStats();
+  //! Print the contention counters of this monitor
+  void reportStats() const;
+
   MonitorBase* monitor_;
+  Stats* stats_;         //!< Contention counters, nullptr if disabled
+  const char* name_;     //!< Optional name for the contention report
 };
 
 class ScopedLock : StackObject {
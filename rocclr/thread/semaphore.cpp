@@ -20,6 +20,8 @@
 
 #include "thread/semaphore.hpp"
 #include "thread/thread.hpp"
+#include "os/os.hpp"
+#include "utils/flags.hpp"
 
 #if defined(_WIN32) || defined(__CYGWIN__)
 #include <windows.h>
@@ -83,7 +85,18 @@ void Semaphore::post() {
   }
 }
 
+void Semaphore::spinWait() {
+  // Give a post() that is about to happen a chance to land before parking the thread
+  for (uint s = DEBUG_CLR_SEMAPHORE_SPIN; s > 0; --s) {
+    if (state_.load(std::memory_order_acquire) > 0) {
+      return;
+    }
+    Os::spinPause();
+  }
+}
+
 void Semaphore::wait() {
+  spinWait();
   if (state_-- > 0) {
     return;
   }
@@ -102,6 +115,7 @@ void Semaphore::wait() {
 }
 
 void Semaphore::timedWait(int millis) {
+  spinWait();
   if (state_-- > 0) {
     return;
   }
@@ -52,6 +52,9 @@ class alignas(64) Semaphore : public HeapObject {
   sem_t sem_;  //!< The semaphore object's identifier.
 #endif /*!_WIN32*/
 
+  //! \brief Spin up to DEBUG_CLR_SEMAPHORE_SPIN iterations waiting for a post
+  void spinWait();
+
 public:
   Semaphore();
   ~Semaphore();
@@ -25,6 +25,7 @@
 #include "os/alloc.hpp"
 
 #include <atomic>
+#include <mutex>
 #include <new>
 
 //! \addtogroup Utils
@@ -204,6 +205,61 @@ template <typename T, int N> inline bool ConcurrentLinkedQueue<T, N>::empty() {
   }
 }
 
+/*! \brief A thread-safe list of free storage blocks of one size.
+ *
+ * Recycles the memory of objects, which are created and destroyed at a high rate,
+ * so that they don't go through the system allocator every time. Requests of any
+ * other size, i.e. from larger derived classes, fall through to the allocator.
+ */
+template <size_t Size> class FreeList {
+  struct Block {
+    Block* next_;  //!< Next free block
+  };
+  static_assert(Size >= sizeof(Block), "Block size is too small");
+
+  std::mutex lock_;         //!< Serializes the list updates
+  Block* head_ = nullptr;   //!< The first free block
+  size_t count_ = 0;        //!< Number of free blocks in the list
+
+  FreeList() = default;
+
+ public:
+  //! The list lives until the process exit, since objects can be released very late
+  static FreeList& instance() {
+    static FreeList* list = new FreeList();
+    return *list;
+  }
+
+  //! Returns a free block or new memory
+  void* allocate(size_t size) {
+    if (size == Size) {
+      std::lock_guard<std::mutex> lock(lock_);
+      if (head_ != nullptr) {
+        Block* block = head_;
+        head_ = block->next_;
+        --count_;
+        return block;
+      }
+    }
+    return ::operator new(size);
+  }
+
+  //! Keeps the block for a reuse, unless the list already holds \a limit blocks
+  void release(void* ptr, size_t size, size_t limit) {
+    if (size == Size) {
+      std::lock_guard<std::mutex> lock(lock_);
+      if (count_ < limit) {
+        Block* block = reinterpret_cast<Block*>(ptr);
+        block->next_ = head_;
+        head_ = block;
+        ++count_;
+        return;
+      }
+    }
+    ::operator delete(ptr);
+  }
+};
+
 }  // namespace amd
 
 #endif /*CONCURRENT_HPP_*/
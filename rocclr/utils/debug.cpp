@@ -26,12 +26,19 @@
 #include "utils/flags.hpp"
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstdio>
 #include <cstdarg>
+#include <cstring>
+#include <mutex>
 #include <thread>
 #include <sstream>
 #include <iomanip>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -55,10 +62,228 @@ void truncate_log_file() {
   }
 }
 
+#if !defined(AMD_LOG_LEVEL)
+namespace {
+//! Single producer, single consumer buffer of the formatted log lines of a thread
+class LogBuffer {
+ public:
+  explicit LogBuffer(size_t size) : data_(new char[size]), size_(size) {}
+  ~LogBuffer() { delete[] data_; }
+
+  size_t capacity() const { return size_; }
+
+  //! Copies the line into the buffer, returns false if it doesn't fit
+  bool push(const char* text, size_t size) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    if ((size_ - (head - tail)) < size) {
+      return false;
+    }
+    const size_t offset = head % size_;
+    const size_t first = std::min(size, size_ - offset);
+    memcpy(data_ + offset, text, first);
+    memcpy(data_, text + first, size - first);
+    head_.store(head + size, std::memory_order_release);
+    return true;
+  }
+
+  //! Writes the buffered lines into the file. The caller serializes the consumers
+  void drain(FILE* file) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t head = head_.load(std::memory_order_acquire);
+    if (head == tail) {
+      return;
+    }
+    const size_t offset = tail % size_;
+    const size_t first = std::min(head - tail, size_ - offset);
+    fwrite(data_ + offset, 1, first, file);
+    fwrite(data_, 1, (head - tail) - first, file);
+    tail_.store(head, std::memory_order_release);
+  }
+
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_relaxed);
+  }
+
+  std::atomic<bool> closed_{false};  //!< The thread exited, free the buffer once it's empty
+
+ private:
+  char* data_;                       //!< The lines
+  size_t size_;                      //!< Size of the buffer in bytes
+  std::atomic<size_t> head_{0};      //!< Bytes written by the thread
+  std::atomic<size_t> tail_{0};      //!< Bytes written into the file
+};
+
+//! Marks the buffer of the thread as closed on the thread exit
+struct LogBufferOwner {
+  LogBuffer* buffer_ = nullptr;
+  ~LogBufferOwner() {
+    if (buffer_ != nullptr) {
+      buffer_->closed_.store(true, std::memory_order_release);
+    }
+  }
+};
+thread_local LogBufferOwner threadLog;
+
+//! Writes the log lines of all threads into the log file in the background with AMD_LOG_ASYNC
+class AsyncLogger {
+ public:
+  AsyncLogger() : thread_(&AsyncLogger::run, this) {}
+
+  //! Queues the line, errors are written out before the call returns
+  void write(LogLevel level, const char* text, size_t size) {
+    LogBuffer* buffer = threadLog.buffer_;
+    if (buffer == nullptr) {
+      buffer = new LogBuffer(std::max(AMD_LOG_ASYNC_BUFFER, 4U) * Ki);
+      std::lock_guard<std::mutex> lock(lock_);
+      buffers_.push_back(buffer);
+      threadLog.buffer_ = buffer;
+    }
+    if ((size > buffer->capacity()) || stopped_.load(std::memory_order_acquire)) {
+      // Keep the order of the lines of this thread and write directly
+      std::lock_guard<std::mutex> lock(lock_);
+      drainAll();
+      fwrite(text, 1, size, outFile);
+      fflush(outFile);
+      return;
+    }
+    while (!buffer->push(text, size)) {
+      // The buffer is full, hence don't wait for the logger thread and write it out here
+      std::lock_guard<std::mutex> lock(lock_);
+      drainAll();
+    }
+    if (level <= LOG_ERROR) {
+      // Make sure the errors reach the file, the process may terminate soon
+      std::lock_guard<std::mutex> lock(lock_);
+      drainAll();
+    }
+  }
+
+  //! Writes the remaining lines and terminates the logger thread
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      if (stopped_) {
+        return;
+      }
+      stopped_ = true;
+    }
+    wakeup_.notify_one();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+ private:
+  static constexpr auto kFlushInterval = std::chrono::milliseconds(10);
+
+  void run() {
+    std::unique_lock<std::mutex> lock(lock_);
+    while (!stopped_) {
+      wakeup_.wait_for(lock, kFlushInterval);
+      drainAll();
+    }
+    drainAll();
+  }
+
+  //! Writes the lines of all buffers, must be called under lock_
+  void drainAll() {
+    bool written = false;
+    for (auto it = buffers_.begin(); it != buffers_.end();) {
+      LogBuffer* buffer = *it;
+      // Check closed_ first, so the last lines of an exited thread are drained
+      bool closed = buffer->closed_.load(std::memory_order_acquire);
+      if (!buffer->empty()) {
+        buffer->drain(outFile);
+        written = true;
+      }
+      if (closed) {
+        delete buffer;
+        it = buffers_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if (written) {
+      fflush(outFile);
+      truncate_log_file();
+    }
+  }
+
+  std::mutex lock_;                    //!< Serializes the consumers of the buffers
+  std::condition_variable wakeup_;     //!< Wakes up the logger thread
+  std::vector<LogBuffer*> buffers_;    //!< The buffers of all threads
+  std::atomic<bool> stopped_{false};   //!< The logger thread is terminated
+  std::thread thread_;                 //!< The logger thread
+};
+
+std::once_flag asyncLoggerOnce;
+AsyncLogger* asyncLogger = nullptr;
+}  // namespace
+#endif  // !defined(AMD_LOG_LEVEL)
+
 // ================================================================================================
-void report_warning(const char* message) {
+static void write_log(LogLevel level, const char* text, int size) {
+  if (size <= 0) {
+    return;
+  }
+#if !defined(AMD_LOG_LEVEL)
+  if (AMD_LOG_ASYNC) {
+    // The logger object is never freed, since the threads may log during the process exit
+    std::call_once(asyncLoggerOnce, [] { asyncLogger = new AsyncLogger(); });
+    asyncLogger->write(level, text, size);
+    return;
+  }
+#endif
   truncate_log_file();
-  fprintf(outFile, "Warning: %s\n", message);
+  fwrite(text, 1, size, outFile);
+  fflush(outFile);
+}
+
+// ================================================================================================
+//! Formats a line into the buffer and returns its size, the line is truncated if it doesn't fit
+static int format_line(char* line, size_t size, const char* format, ...) {
+  va_list ap;
+  va_start(ap, format);
+  int result = vsnprintf(line, size, format, ap);
+  va_end(ap);
+  if (result >= static_cast<int>(size)) {
+    // Keep the end of the line
+    line[size - 2] = '\n';
+    result = static_cast<int>(size) - 1;
+  }
+  return result;
+}
+
+// ================================================================================================
+//! Returns the process and thread ids for the log level 4 and above, cached in the thread
+static const char* pid_tid() {
+  if (AMD_LOG_LEVEL < 4) {
+    return "";
+  }
+  thread_local std::string pidtid;
+  if (pidtid.empty()) {
+    std::stringstream str;
+    str << "[pid:" << Os::getProcessId() << " tid: 0x";
+    str << std::hex << std::setw(5) << std::this_thread::get_id() << "]";
+    pidtid = str.str();
+  }
+  return pidtid.c_str();
+}
+
+// ================================================================================================
+void log_flush() {
+#if !defined(AMD_LOG_LEVEL)
+  if (asyncLogger != nullptr) {
+    asyncLogger->stop();
+  }
+#endif
+}
+
+// ================================================================================================
+void report_warning(const char* message) {
+  char line[4096];
+  write_log(LOG_WARNING, line, format_line(line, sizeof(line), "Warning: %s\n", message));
 }
 
 // ================================================================================================
@@ -66,9 +291,9 @@ void log_entry(LogLevel level, const char* file, int line, const char* message)
   if (level == LOG_NONE) {
     return;
   }
-  truncate_log_file();
-  fprintf(outFile, ":%d:%s:%d: %s\n", level, file, line, message);
-  fflush(outFile);
+  char text[4096];
+  write_log(level, text, format_line(text, sizeof(text), ":%d:%s:%d: %s\n", level, file, line,
+                                     message));
 }
 
 // ================================================================================================
@@ -86,20 +311,14 @@ void log_timestamped(LogLevel level, const char* file, int line, const char* mes
     return;
   }
 
-  truncate_log_file();
-  fprintf(outFile, ":% 2d:%15s:% 5d: (%010lld) us %s\n", level, file, line, time / 1000ULL,
-          message);
-  fflush(outFile);
+  char text[4096];
+  write_log(level, text, format_line(text, sizeof(text), ":% 2d:%15s:% 5d: (%010lld) us %s\n",
+                                     level, file, line, time / 1000ULL, message));
 }
 
 // ================================================================================================
 void log_printf(LogLevel level, const char* file, int line, const char* format, ...) {
   va_list ap;
-  std::stringstream pidtid;
-  if (AMD_LOG_LEVEL >= 4) {
-    pidtid << "[pid:" << Os::getProcessId() << " tid: 0x" ;
-    pidtid << std::hex << std::setw(5) << std::this_thread::get_id() << "]";
-  }
 
   va_start(ap, format);
   char message[4096];
@@ -107,38 +326,31 @@ void log_printf(LogLevel level, const char* file, int line, const char* format,
   va_end(ap);
   uint64_t timeUs = Os::timeNanos() / 1000ULL;
 
-  truncate_log_file();
-  fprintf(outFile, ":%d:%-25s:%-4d: %010lu us: %s %s\n", level, file, line,
-    timeUs, pidtid.str().c_str(),message);
-
-  fflush(outFile);
+  char text[4096 + 256];
+  write_log(level, text, format_line(text, sizeof(text), ":%d:%-25s:%-4d: %010lu us: %s %s\n",
+                                     level, file, line, timeUs, pid_tid(), message));
 }
 
 // ================================================================================================
 void log_printf(LogLevel level, const char* file, int line, uint64_t* start,
                 const char* format, ...) {
   va_list ap;
-  std::stringstream pidtid;
-  if (AMD_LOG_LEVEL >= 4) {
-    pidtid << "[pid:" << Os::getProcessId() << " tid: 0x" ;
-    pidtid << std::hex << std::setw(5) << std::this_thread::get_id() << "]";
-  }
   va_start(ap, format);
   char message[4096];
   vsnprintf(message, sizeof(message), format, ap);
   va_end(ap);
   uint64_t timeUs = Os::timeNanos() / 1000ULL;
 
-  truncate_log_file();
-
+  char text[4096 + 256];
+  int size = 0;
   if (start == 0 || *start == 0) {
-    fprintf(outFile, ":%d:%-25s:%-4d: %010lu us: %s %s\n", level, file, line,
-      timeUs, pidtid.str().c_str(), message);
+    size = format_line(text, sizeof(text), ":%d:%-25s:%-4d: %010lu us: %s %s\n", level, file,
+                       line, timeUs, pid_tid(), message);
   } else {
-    fprintf(outFile, ":%d:%-25s:%-4d: %010lu us: %s %s: duration: %lu us\n",
-      level, file, line, timeUs, pidtid.str().c_str(), message, timeUs - *start);
+    size = format_line(text, sizeof(text), ":%d:%-25s:%-4d: %010lu us: %s %s: duration: %lu us\n",
+                       level, file, line, timeUs, pid_tid(), message, timeUs - *start);
   }
-  fflush(outFile);
+  write_log(level, text, size);
   if (*start == 0) {
      *start = timeUs;
   }
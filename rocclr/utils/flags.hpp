@@ -32,6 +32,14 @@ release(cstring, AMD_LOG_LEVEL_FILE, "",                                      \
         "Set output file for AMD_LOG_LEVEL, Default is stderr")               \
 release(size_t, AMD_LOG_LEVEL_SIZE, 2048,                                     \
         "The max size of AMD_LOG generated in MB if printed to a file")       \
+release(bool, AMD_LOG_ASYNC, false,                                           \
+        "Queue the log entries per thread and write them in the background")  \
+release(uint, AMD_LOG_ASYNC_BUFFER, 256,                                      \
+        "Size in KB of the per-thread log buffer with AMD_LOG_ASYNC")         \
+release(cstring, AMD_METRICS_FILE, "",                                        \
+        "Write the runtime metrics into the file, %p is the process id")      \
+release(uint, AMD_METRICS_INTERVAL, 10000,                                    \
+        "Interval in ms of the AMD_METRICS_FILE update, 0 - at exit only")    \
 debug(uint, DEBUG_GPU_FLAGS, 0,                                               \
         "The debug options for GPU device")                                   \
 release(size_t, CQ_THREAD_STACK_SIZE, 256*Ki, /* @todo: that much! */         \
@@ -50,6 +58,9 @@ debug(size_t, MEMOBJ_BASE_ADDR_ALIGN, 4*Ki,                                   \
         "Alignment of the base address of any allocate memory object")        \
 release(uint, ROC_HMM_FLAGS, 0,                                               \
         "ROCm HMM configuration flags")                                       \
+release(uint, ROC_HMM_MIGRATE_THRESHOLD, 2,                                   \
+        "Consecutive kernel accesses of a device, which migrate managed "     \
+        "memory, if ROC_HMM_FLAGS enables the automatic migration")           \
 release(cstring, GPU_DEVICE_ORDINAL, "",                                      \
         "Select the device ordinal (comma seperated list of available devices)") \
 release(bool, REMOTE_ALLOC, false,                                            \
@@ -62,6 +73,8 @@ release(uint, GPU_STAGING_BUFFER_SIZE, 4,                                     \
         "Size of the GPU staging buffer in MiB")                              \
 release(bool, GPU_DUMP_BLIT_KERNELS, false,                                   \
         "Dump the kernels for blit manager")                                  \
+release(bool, GPU_USE_PREBUILT_BLIT_KERNELS, true,                            \
+        "Use blit kernel code objects embedded in the runtime if available")  \
 release(uint, GPU_BLIT_ENGINE_TYPE, 0x0,                                      \
         "Blit engine type: 0 - Default, 1 - Host, 2 - CAL, 3 - Kernel")       \
 release(bool, GPU_FLUSH_ON_EXECUTION, false,                                  \
@@ -76,6 +89,12 @@ release(cstring, AMD_OCL_LINK_OPTIONS, 0,                                     \
         "Set clLinkProgram()'s options (override)")                           \
 release(cstring, AMD_OCL_LINK_OPTIONS_APPEND, 0,                              \
         "Append clLinkProgram()'s options")                                   \
+release(bool, AMD_OCL_PARALLEL_BUILD, true,                                   \
+        "Build the programs of a multi-device context concurrently")          \
+release(cstring, AMD_OCL_BUILD_CACHE_PATH, "",                                \
+        "Directory of the clBuildProgram() binary cache, empty - disabled")   \
+release(uint, AMD_OCL_BUILD_CACHE_MAX_SIZE, 512,                              \
+        "Size limit of the clBuildProgram() cache in MiB, 0 - unlimited")     \
 debug(cstring, AMD_OCL_SUBST_OBJFILE, 0,                                      \
         "Specify binary substitution config file for OpenCL")                 \
 release(size_t, GPU_PINNED_XFER_SIZE, 32,                                     \
@@ -110,6 +129,9 @@ release(bool, HSA_LOCAL_MEMORY_ENABLE, true,                                  \
         "Enable HSA device local memory usage")                               \
 release(uint, HSA_KERNARG_POOL_SIZE, 1024 * 1024,                             \
         "Kernarg pool size")                                                  \
+release(uint, ROC_KERNARG_POOL_MAX_SIZE, 64 * 1024 * 1024,                    \
+        "The size the kernarg pool can grow to instead of a stall on wrap, "  \
+        "0 disables the growth")                                              \
 release(bool, GPU_MIPMAP, true,                                               \
         "Enables GPU mipmap extension")                                       \
 release(uint, GPU_ENABLE_PAL, 2,                                              \
@@ -134,6 +156,13 @@ release(bool, PAL_DISABLE_SDMA, false,                                        \
         "1 = Disable SDMA for PAL")                                           \
 release(uint, PAL_RGP_DISP_COUNT, 10000,                                      \
         "The number of dispatches for RGP capture with SQTT")                 \
+release(cstring, PAL_RGP_STREAM_FILE, "",                                     \
+        "Streams the RGP capture to disk in segments of PAL_RGP_DISP_COUNT "  \
+        "dispatches. The file prefix, %p is replaced with the process id")    \
+release(uint, PAL_RGP_STREAM_SEGMENTS, 0,                                     \
+        "The number of the streamed RGP segments, 0 = until the exit")        \
+release(uint, PAL_RGP_STREAM_BACKLOG, 256,                                    \
+        "Max MB of the streamed RGP segments, which wait for the disk")       \
 release(uint, PAL_MALL_POLICY, 0,                                             \
         "Controls the behaviour of allocations with respect to the MALL"      \
         "0 = MALL policy is decided by KMD"                                   \
@@ -175,6 +204,33 @@ release(uint, HIP_LAUNCH_BLOCKING, 0,                                         \
         "same as AMD_SERIALIZE_KERNEL=2")                                     \
 release(bool, PAL_ALWAYS_RESIDENT, false,                                     \
         "Force memory resources to become resident at allocation time")       \
+release(bool, PAL_REUSE_CMD_BUFFERS, false,                                   \
+        "Record the captured graph and command-buffer dispatches into PAL "   \
+        "command buffers once and resubmit them. Requires resident memory")   \
+release(uint, PAL_REUSE_CMD_BUFFERS_CACHE, 16,                                \
+        "The number of recorded PAL command buffers per queue")               \
+release(bool, PAL_ENGINE_SEMAPHORES, true,                                    \
+        "Use PAL queue semaphores for the dependencies between compute and "  \
+        "SDMA instead of CPU waits")                                          \
+release(uint, PAL_FENCE_SPIN_US, 200,                                         \
+        "Max spin time in us on a PAL fence of a normal priority queue, "     \
+        "before the OS wait")                                                 \
+release(uint, PAL_FENCE_SPIN_US_HIGH_PRIORITY, 1000,                          \
+        "Max spin time in us on a PAL fence of a high priority queue, "       \
+        "before the OS wait")                                                 \
+release(uint, PAL_RESIDENCY_GENERATIONS, 64,                                  \
+        "The number of submissions, after which an unused allocation leaves " \
+        "the residency list of a PAL queue")                                  \
+release(uint, HIP_HOST_MEM_CACHE_SIZE, 0,                                     \
+        "Per device cap in MB of freed pinned memory for reuse, 0 - disable") \
+release(uint, HIP_MALLOC_THREAD_CACHE_SIZE, 0,                                \
+        "Per thread cap in KB of freed small hipMalloc memory for reuse, "    \
+        "0 - disable")                                                        \
+release(uint, HIP_MALLOC_CACHE_SIZE, 64,                                      \
+        "Per device cap in MB of freed small hipMalloc memory, shared by "    \
+        "all thread caches")                                                  \
+release(uint, HIP_MALLOC_CACHE_MAX_ALLOC, 256,                                \
+        "The largest hipMalloc size in KB kept in the allocation caches")     \
 release(uint, HIP_HOST_COHERENT, 0,                                           \
         "Coherent memory in hipExtHostAlloc, 0x1 = memory is coherent with host"\
         "0x0 = memory is not coherent between host and GPU")                  \
@@ -192,6 +248,12 @@ release(uint, ROC_ACTIVE_WAIT_TIMEOUT, 0,                                     \
         "Forces active wait of GPU interrup for the timeout(us)")             \
 release(bool, ROC_ENABLE_LARGE_BAR, true,                                     \
         "Enable Large Bar if supported by the device")                        \
+release(uint, ROC_CPU_WRITE_SIZE, 64,                                         \
+        "The maximum size in KB of host to device copies the CPU writes "     \
+        "directly over the large BAR, 0 disables")                            \
+release(uint, ROC_BAR_MAP_SIZE, 0,                                            \
+        "The maximum size in KB of device buffers the host maps directly "    \
+        "over the large BAR without staging copies, 0 disables")              \
 release(bool, ROC_CPU_WAIT_FOR_SIGNAL, true,                                  \
         "Enable CPU wait for dependent HSA signals.")                         \
 release(bool, ROC_SYSTEM_SCOPE_SIGNAL, true,                                  \
@@ -202,6 +264,44 @@ release(bool, HIP_MEM_POOL_SUPPORT, true,                                     \
         "Enables memory pool support in HIP")                                 \
 release(bool, HIP_MEM_POOL_USE_VM, true,                                      \
         "Enables memory pool support in HIP")                                 \
+release(uint, HIP_MEM_POOL_SLAB_SIZE, 4,                                      \
+        "Memory pool slab size in MB for small allocations, 0 - disable")     \
+release(uint, HIP_MEM_POOL_SLAB_MAX_ALLOC, 64,                                \
+        "Max size in KB of an allocation, carved from a memory pool slab")    \
+release(uint, HIP_MEM_POOL_TRIM_INTERVAL, 0,                                  \
+        "Idle interval in ms for background memory pool trim, 0 - disable")   \
+release(uint, HIP_MEM_POOL_TRIM_AGE, 1000,                                    \
+        "Age in ms after which a freed memory pool block can be trimmed")     \
+release(uint, HIP_BROADCAST_CHUNK_SIZE, 4,                                    \
+        "Chunk size in MB of the pipelined multi-device broadcast, 0 - none") \
+release(bool, HIP_COOP_HIERARCHICAL_SYNC, false,                              \
+        "Use the runtime hierarchical barrier for the grid sync of coop launches")\
+release(bool, HIP_CALLBACK_THREAD, false,                                     \
+        "Run stream callbacks on a device thread without stalling the stream")\
+release(bool, HIP_PAGEABLE_ASYNC_COPY, false,                                 \
+        "Async copies with pageable memory return at once, the host buffer "  \
+        "must stay valid until the stream reaches the copy")                  \
+release(uint, HIP_PAGEABLE_ASYNC_CACHE, 256,                                  \
+        "Max size in MB of the idle staging buffers of pageable async copies")\
+release(uint, HIP_FLIGHT_RECORDER, 1024,                                      \
+        "The number of the last HIP API calls kept per thread, 0 - disable")  \
+release(uint, HIP_FLIGHT_RECORDER_SIGNAL, 0,                                  \
+        "Signal, which dumps the HIP API flight recorder, 0 - none")          \
+release(bool, HIP_FLIGHT_RECORDER_CRASH_DUMP, true,                           \
+        "Dump the HIP API flight recorder on a crash signal")                 \
+release(cstring, HIP_FLIGHT_RECORDER_FILE, "",                                \
+        "Output file for the flight recorder dumps, default is stderr")       \
+release(cstring, HIP_TRACE_EXPORT_FILE, "",                                   \
+        "Write HIP API and GPU activity to a Chrome trace file, %p - pid")    \
+release(bool, HIP_MEM_POOL_COMPACT, false,                                    \
+        "Replace idle physical memory of VM pools with a single allocation, " \
+        "when a large request doesn't fit the fragmented free memory")        \
+release(bool, HIP_MEM_POOL_LAZY_EVENTS, true,                                 \
+        "Track the submission point of hipFreeAsync and create a HIP event "  \
+        "only when another stream contends for the memory")                   \
+release(bool, HIP_MEM_POOL_GRAPH_ARENA, true,                                 \
+        "Back graph allocations, freed inside the graph, with one physical "  \
+        "arena, which is planned and mapped once at graph instantiation")     \
 release(bool, PAL_HIP_IPC_FLAG, true,                                         \
         "Enable interprocess flag for device allocation in PAL HIP")          \
 release(uint, PAL_FORCE_ASIC_REVISION, 0,                                     \
@@ -211,18 +311,97 @@ release(bool, PAL_EMBED_KERNEL_MD, false,                                     \
 release(cstring, ROC_GLOBAL_CU_MASK, "",                                      \
         "Sets a global CU mask (entered as hex value) for all queues,"        \
         "Each active bit represents using one CU (e.g., 0xf enables only 4 CUs)") \
+release(uint, ROC_HIGH_PRIORITY_RESERVED_CUS, 0,                              \
+        "The number of CUs, used only by the high priority queues, 0 - none") \
 release(size_t, PAL_PREPINNED_MEMORY_SIZE, 64,                                \
         "Size in KBytes of prepinned memory")                                 \
 release(bool, AMD_CPU_AFFINITY, false,                                        \
         "Reset CPU affinity of any runtime threads")                          \
+release(bool, ROC_NUMA_AFFINITY, false,                                       \
+        "Bind the worker threads of a GPU to its closest NUMA node")          \
+release(int, ROC_NUMA_NODE, -1,                                               \
+        "NUMA node for ROC_NUMA_AFFINITY, -1 - the node closest to the GPU")  \
+release(bool, DEBUG_CLR_HOSTCALL_PER_DEVICE, true,                            \
+        "Run a separate hostcall listener thread for every device")           \
+release(bool, DEBUG_CLR_HOSTCALL_BATCH_DEVMEM, true,                          \
+        "Serve the device malloc calls of a wave with a single allocation")   \
+release(uint, DEBUG_CLR_DEVMEM_CACHE_SIZE, 64,                                \
+        "Size in MB of the freed device heap slabs, kept for reuse")          \
+release(uint, DEBUG_CLR_HOSTCALL_SPIN_US, 20,                                 \
+        "Time in us the hostcall listener polls for new calls after a wakeup")\
+release(bool, DEBUG_CLR_ASAN_DEDUP_REPORTS, true,                             \
+        "Print a recoverable sanitizer report once per code location")        \
+release(bool, ROC_PRINTF_ASYNC_DRAIN, false,                                  \
+        "Print the buffered device printf output in a background thread")     \
+release(uint, ROC_PRINTF_DRAIN_BUFFERS, 4,                                    \
+        "The number of printf buffers in flight with ROC_PRINTF_ASYNC_DRAIN") \
+release(bool, ROC_DEVICE_ERROR_MAILBOX, true,                                 \
+        "Preallocate a HW queue mailbox for the device assert reports")       \
+release(uint, ROC_ACTIVITY_BATCH_SIZE, 0,                                     \
+        "Activity records per queue, sent to the profiler at once, 0 - off")  \
+release(uint, ROC_ACTIVITY_FLUSH_INTERVAL, 10,                                \
+        "Interval in ms of the batched activity record delivery")             \
+release(cstring, ROC_KERNEL_COUNTERS, "",                                     \
+        "Counters sampled per kernel, as block:event,... ORCA indices")       \
+release(uint, ROC_KERNEL_COUNTERS_SAMPLE, 1,                                  \
+        "Sample the counters on every Nth kernel dispatch of a queue")        \
 release(bool, ROC_USE_FGS_KERNARG, true,                                      \
         "Use fine grain kernel args segment for supported asics")             \
 release(uint, ROC_P2P_SDMA_SIZE, 1024,                                        \
         "The minimum size in KB for P2P transfer with SDMA")                  \
+release(bool, ROC_SDMA_RECT_COPY, false,                                      \
+        "Use SDMA for strided device copies, so they don't take CUs from "    \
+        "concurrent kernels")                                                 \
+release(bool, ROC_P2P_LAZY_ACCESS, false,                                     \
+        "Grant peer access to device memory on the first use by a peer, "     \
+        "instead of all allocations at peer access enable time")              \
+release(uint, ROC_P2P_RELAY_SIZE, 0,                                          \
+        "The minimum size in KB for P2P copies to relay through a GPU with "  \
+        "xGMI links to both peers, 0 disables the relay")                     \
+release(uint, ROC_COPY_AUTOTUNE_SAMPLES, 0,                                   \
+        "Timed copies per size bucket and engine used to learn when SDMA or " \
+        "the blit kernel is faster, 0 keeps the static thresholds")           \
+release(uint, ROC_STAGING_RING_SIZE, 2,                                       \
+        "The number of slots in the staging buffer, CPU copy of one slot "    \
+        "overlaps DMA of the others")                                         \
+release(uint, ROC_SDMA_STRIPE_SIZE, 0,                                        \
+        "The minimum size in MB of a host copy split across SDMA engines, "   \
+        "0 - disable")                                                        \
+release(uint, ROC_SDMA_STRIPE_ENGINES, 4,                                     \
+        "The maximum number of SDMA engines for a single striped copy")       \
 release(uint, ROC_AQL_QUEUE_SIZE, 16384,                                      \
         "AQL queue size in AQL packets")                                      \
 release(uint, ROC_SIGNAL_POOL_SIZE, 64,                                       \
-        "Initial size of HSA signal pool")                                    \
+        "Initial size of HSA signal pool, with the interrupt signals")        \
+release(uint, ROC_EVENT_POOL_SIZE, 4096,                                      \
+        "Freed profiling timestamps kept for reuse, 0 - no recycling")        \
+release(uint, ROC_DOORBELL_COALESCE_PACKETS, 0,                               \
+        "Direct dispatch defers the doorbell until N packets are pending, "   \
+        "0 disables the coalescing")                                          \
+release(uint, ROC_DOORBELL_COALESCE_US, 20,                                   \
+        "The maximum time(us) a coalesced doorbell can be deferred")          \
+release(bool, ROC_ADAPTIVE_FLUSH, false,                                      \
+        "Queue thread defers the doorbells while the GPU is busy and rings "  \
+        "them once it's about to go idle")                                    \
+release(bool, ROC_DISPATCH_STATS, true,                                       \
+        "Collect per queue dispatch latency histograms, GPU times require "   \
+        "the profiling")                                                      \
+release(bool, ROC_DISPATCH_STATS_DUMP, false,                                 \
+        "Print the dispatch latency histograms when the queue is destroyed")  \
+release(bool, ROC_IDLE_GAP_STATS, false,                                      \
+        "Report the GPU idle gaps between kernels per queue, requires the "   \
+        "profiling")                                                          \
+release(bool, ROC_QUEUE_LOAD_BALANCE, true,                                   \
+        "Share the least loaded HW queue, based on live AQL occupancy, once " \
+        "GPU_MAX_HW_QUEUES is reached")                                       \
+release(uint, ROC_PINNED_CACHE_SIZE, 0,                                       \
+        "Size in MB of the process wide cache of pinned host ranges for "     \
+        "pageable copies, 0 - disable")                                       \
+release(uint, ROC_MAX_SUBALLOC_SIZE, 0,                                       \
+        "The maximum size in KB of device allocations suballocated from "     \
+        "larger chunks, 0 - disable")                                         \
+release(bool, ROC_PARALLEL_DEVICE_INIT, true,                                 \
+        "Create the GPU devices concurrently at runtime startup")             \
 release(uint, DEBUG_CLR_LIMIT_BLIT_WG, 16,                                    \
         "Limit the number of workgroups in blit operations")                  \
 release(bool, DEBUG_CLR_BLIT_KERNARG_OPT, false,                              \
@@ -247,16 +426,41 @@ release(cstring, HIPRTC_COMPILE_OPTIONS_APPEND, "",                           \
         "Set compile options needed for hiprtc compilation")                  \
 release(cstring, HIPRTC_LINK_OPTIONS_APPEND, "",                              \
         "Set link options needed for hiprtc compilation")                     \
+release(cstring, HIPRTC_CACHE_PATH, "",                                       \
+        "Directory of the hiprtc compilation cache, empty - disabled")        \
+release(uint, HIPRTC_CACHE_MAX_SIZE, 1024,                                    \
+        "Size limit of the hiprtc compilation cache in MiB, 0 - unlimited")   \
 release(bool, HIP_VMEM_MANAGE_SUPPORT, true,                                  \
         "Virtual Memory Management Support")                                  \
 release(bool, DEBUG_HIP_GRAPH_DOT_PRINT, false,                               \
          "Enable/Disable graph debug dot print dump")                         \
+release(bool, DEBUG_HIP_GRAPH_DOT_TIMING, false,                              \
+        "Profile the graph launches and dump the last one as a dot file with "\
+        "the node times, streams and critical path on hipGraphExecDestroy")   \
 release(bool, DEBUG_HIP_FORCE_ASYNC_QUEUE, false,                             \
         "Forces grpahs into async queue mode. DEBUG_HIP_FORCE_GRAPH_QUEUES must be 1") \
 release(uint, DEBUG_HIP_FORCE_GRAPH_QUEUES, 4,                                \
         "Forces the number of streams for the graph parallel execution")      \
+release(uint, DEBUG_HIP_GRAPH_INSTANTIATE_THREADS, 4,                         \
+        "Max threads, which create the captured commands of a large graph "   \
+        "on instantiation, 0 - disable")                                      \
+release(bool, DEBUG_HIP_GRAPH_FUSE_KERNELS, false,                            \
+        "Launch linear chains of graph kernel nodes on one stream as "        \
+        "back-to-back captured packets with a single completion")             \
+release(bool, DEBUG_HIP_GRAPH_CAPTURE_NODE_ARENA, true,                       \
+        "Allocate the nodes of stream capture graphs from a bump pointer "    \
+        "arena, released with the graph")                                     \
 release(bool, HIP_ALWAYS_USE_NEW_COMGR_UNBUNDLING_ACTION, false,              \
         "Force to always use new comgr unbundling action")                    \
+release(bool, HIP_DEFER_FATBIN_EXTRACTION, true,                              \
+        "Unbundle the code objects of a registered fat binary for a device "  \
+        "on the first kernel or variable lookup on that device")              \
+release(uint, HIP_FATBIN_LOAD_THREADS, 0,                                     \
+        "Threads, which unbundle and build all registered fat binaries for "  \
+        "all devices in the background at init, 0 - disable")                 \
+release(cstring, HIP_CODE_OBJECT_CACHE_PATH, "",                              \
+        "Directory of the persistent cache of code objects, unbundled from "  \
+        "compressed fat binaries, empty - disable")                           \
 release(uint, DEBUG_HIP_BLOCK_SYNC, 50,                                       \
         "Blocks synchronization on CPU until the callback processing is done")\
 release(uint, DEBUG_CLR_MAX_BATCH_SIZE, 1000,                                 \
@@ -267,6 +471,12 @@ release(bool, DEBUG_HIP_KERNARG_COPY_OPT, true,                               \
         "Enable/Disable multiple kern arg copies")                            \
 release(bool, DEBUG_CLR_USE_STDMUTEX_IN_AMD_MONITOR, false,                   \
         "Use std::mutex in amd::monotor")                                     \
+release(uint, DEBUG_CLR_MONITOR_MAX_SPIN, 55,                                 \
+        "Upper bound of the adaptive spin in amd::Monitor before parking")    \
+release(uint, DEBUG_CLR_SEMAPHORE_SPIN, 0,                                    \
+        "Spin iterations in amd::Semaphore::wait() before parking")           \
+release(bool, DEBUG_CLR_MONITOR_STATS, false,                                 \
+        "Report amd::Monitor contention counters at destruction (LOG_LOCK)")  \
 release(bool, DEBUG_CLR_KERNARG_HDP_FLUSH_WA, false,                          \
         "Toggle kernel arg copy workaround")                                  \
 
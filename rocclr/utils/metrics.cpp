@@ -0,0 +1,221 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+
+#include "utils/metrics.hpp"
+#include "utils/flags.hpp"
+#include "utils/debug.hpp"
+#include "os/os.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace amd {
+
+Metrics::CounterSlot Metrics::counters_[Metrics::CounterLast];
+Metrics::HistogramSlot Metrics::histograms_[Metrics::HistogramLast];
+
+namespace {
+
+struct MetricInfo {
+  const char* name_;  //!< Exported name
+  const char* help_;  //!< Help text
+};
+
+#define AMD_METRIC_INFO(id, name, help) {name, help},
+constexpr MetricInfo kCounterInfo[] = {AMD_RUNTIME_COUNTERS(AMD_METRIC_INFO)};
+constexpr MetricInfo kHistogramInfo[] = {AMD_RUNTIME_HISTOGRAMS(AMD_METRIC_INFO)};
+#undef AMD_METRIC_INFO
+
+constexpr const char* kHistogramSuffix[] = {"_count", "_sum", "_max", "_p50", "_p99"};
+
+//! Returns the exported names, the names of the histogram values are built once
+const std::vector<std::string>& exportedNames() {
+  static const std::vector<std::string> names = [] {
+    std::vector<std::string> list;
+    for (const auto& info : kCounterInfo) {
+      list.push_back(info.name_);
+    }
+    for (const auto& info : kHistogramInfo) {
+      for (const auto suffix : kHistogramSuffix) {
+        list.push_back(std::string(info.name_) + suffix);
+      }
+    }
+    return list;
+  }();
+  return names;
+}
+
+//! The periodic dump of AMD_METRICS_FILE
+struct MetricsDumper {
+  std::mutex lock_;
+  std::condition_variable cv_;
+  std::thread thread_;
+  std::string fileName_;
+  bool stop_ = false;
+};
+
+MetricsDumper* dumper = nullptr;
+
+}  // namespace
+
+// ================================================================================================
+void Metrics::record(Histogram id, uint64_t value) {
+  HistogramSlot& slot = histograms_[id];
+  slot.count_.fetch_add(1, std::memory_order_relaxed);
+  slot.sum_.fetch_add(value, std::memory_order_relaxed);
+  uint64_t max = slot.max_.load(std::memory_order_relaxed);
+  while ((value > max) &&
+         !slot.max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+  }
+  const uint32_t bucket = (value == 0) ? 0 : amd::log2(value);
+  slot.buckets_[std::min(bucket, kNumBuckets - 1)].fetch_add(1, std::memory_order_relaxed);
+}
+
+// ================================================================================================
+uint64_t Metrics::HistogramSlot::percentile(uint32_t pct) const {
+  const uint64_t samples = count_.load(std::memory_order_relaxed);
+  const uint64_t target = (samples * pct + 99) / 100;
+  const uint64_t max = max_.load(std::memory_order_relaxed);
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < kNumBuckets; ++i) {
+    total += buckets_[i].load(std::memory_order_relaxed);
+    if ((total >= target) && (total != 0)) {
+      return std::min(max, (i < 63) ? ((uint64_t(2) << i) - 1) : max);
+    }
+  }
+  return max;
+}
+
+// ================================================================================================
+size_t Metrics::count() {
+  return CounterLast + HistogramLast * kHistogramValues;
+}
+
+// ================================================================================================
+size_t Metrics::snapshot(const char** names, uint64_t* values, size_t count) {
+  const auto& exported = exportedNames();
+  size_t index = 0;
+  auto add = [&](uint64_t value) {
+    if (index < count) {
+      if (names != nullptr) {
+        names[index] = exported[index].c_str();
+      }
+      if (values != nullptr) {
+        values[index] = value;
+      }
+      ++index;
+    }
+  };
+  for (const auto& counter : counters_) {
+    add(counter.value_.load(std::memory_order_relaxed));
+  }
+  for (const auto& histogram : histograms_) {
+    add(histogram.count_.load(std::memory_order_relaxed));
+    add(histogram.sum_.load(std::memory_order_relaxed));
+    add(histogram.max_.load(std::memory_order_relaxed));
+    add(histogram.percentile(50));
+    add(histogram.percentile(99));
+  }
+  return index;
+}
+
+// ================================================================================================
+void Metrics::dump(const std::string& fileName) {
+  std::vector<uint64_t> values(count());
+  snapshot(nullptr, values.data(), values.size());
+  const auto& names = exportedNames();
+
+  // Write a temporary file and rename it, so a scraper never reads a partial file
+  const std::string tmpName = fileName + ".tmp";
+  FILE* file = fopen(tmpName.c_str(), "w");
+  if (file == nullptr) {
+    LogPrintfError("Couldn't open the metrics file %s", tmpName.c_str());
+    return;
+  }
+  size_t index = 0;
+  for (const auto& info : kCounterInfo) {
+    fprintf(file, "# HELP amd_runtime_%s %s\n# TYPE amd_runtime_%s counter\n"
+            "amd_runtime_%s %lu\n", info.name_, info.help_, info.name_, info.name_,
+            values[index]);
+    ++index;
+  }
+  for (const auto& info : kHistogramInfo) {
+    fprintf(file, "# HELP amd_runtime_%s %s\n", info.name_, info.help_);
+    for (uint32_t i = 0; i < kHistogramValues; ++i) {
+      fprintf(file, "# TYPE amd_runtime_%s %s\namd_runtime_%s %lu\n", names[index].c_str(),
+              (i < 2) ? "counter" : "gauge", names[index].c_str(), values[index]);
+      ++index;
+    }
+  }
+  fclose(file);
+  if (std::rename(tmpName.c_str(), fileName.c_str()) != 0) {
+    LogPrintfError("Couldn't rename the metrics file to %s", fileName.c_str());
+  }
+}
+
+// ================================================================================================
+void Metrics::init() {
+  if ((AMD_METRICS_FILE == nullptr) || (AMD_METRICS_FILE[0] == '\0') || (dumper != nullptr)) {
+    return;
+  }
+  dumper = new MetricsDumper();
+  dumper->fileName_ = AMD_METRICS_FILE;
+  const size_t pos = dumper->fileName_.find("%p");
+  if (pos != std::string::npos) {
+    dumper->fileName_.replace(pos, 2, std::to_string(amd::Os::getProcessId()));
+  }
+  if (AMD_METRICS_INTERVAL == 0) {
+    // Only the final values at the exit
+    return;
+  }
+  dumper->thread_ = std::thread([]() {
+    std::unique_lock<std::mutex> lock(dumper->lock_);
+    while (!dumper->cv_.wait_for(lock, std::chrono::milliseconds(AMD_METRICS_INTERVAL),
+                                 []() { return dumper->stop_; })) {
+      dump(dumper->fileName_);
+    }
+  });
+}
+
+// ================================================================================================
+void Metrics::tearDown() {
+  if (dumper == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(dumper->lock_);
+    dumper->stop_ = true;
+  }
+  dumper->cv_.notify_one();
+  if (dumper->thread_.joinable()) {
+    dumper->thread_.join();
+  }
+  dump(dumper->fileName_);
+  delete dumper;
+  dumper = nullptr;
+}
+
+}  // namespace amd
@@ -0,0 +1,120 @@
+/* Copyright (c) 2024 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+
+#ifndef METRICS_HPP_
+#define METRICS_HPP_
+
+#include "top.hpp"
+
+#include <atomic>
+#include <string>
+
+namespace amd {
+
+// The runtime metrics: identifier, exported name and help text. The position in the list is
+// the index in the snapshot, hence new entries go to the end only
+#define AMD_RUNTIME_COUNTERS(X)                                                                    \
+  X(StagingCopies, "staging_copies", "Host copies through a staging buffer")                       \
+  X(StagingBytes, "staging_bytes", "Bytes copied through a staging buffer")                        \
+  X(PinnedCacheHits, "pinned_cache_hits", "Pageable copies, which reused a cached pinned range")   \
+  X(PinnedCacheMisses, "pinned_cache_misses", "Pageable copies without a cached pinned range")     \
+  X(MemDependencyBarriers, "mem_dependency_barriers",                                              \
+    "Kernel dispatches, serialized by a memory dependency")                                        \
+  X(KernArgPoolWraps, "kernarg_pool_wraps", "Switches to the next kernarg pool chunk")             \
+  X(KernArgPoolForcedSyncs, "kernarg_pool_forced_syncs",                                           \
+    "Kernarg pool chunk switches, which stalled on the GPU")                                       \
+  X(SignalPoolWaits, "signal_pool_waits", "Waits for a busy signal of the queue signal pool")      \
+  X(HostcallWakeups, "hostcall_wakeups", "Doorbell wakeups of the hostcall listener")              \
+  X(HostcallPackets, "hostcall_packets", "Packets served by the hostcall listener")                \
+  X(HipMallocCacheHits, "hip_malloc_cache_hits", "hipMalloc calls, served by the thread cache")    \
+  X(StagingPoolMisses, "staging_pool_misses", "Staging buffer acquires without a free buffer")     \
+  X(StagingPoolGrows, "staging_pool_grows", "Staging buffers, allocated ahead of the demand")      \
+  X(StagingPoolTrims, "staging_pool_trims", "Staging buffers, freed above the high-water mark")
+
+#define AMD_RUNTIME_HISTOGRAMS(X)                                                                  \
+  X(SignalPoolWaitTime, "signal_pool_wait_ns", "Time of the signal pool waits in ns")
+
+//! Process wide registry of the runtime counters and histograms. The updates are relaxed
+//! atomics, hence they are cheap enough to stay enabled in production
+class Metrics : public AllStatic {
+ public:
+  enum Counter {
+#define AMD_METRIC_ENUM(id, name, help) id,
+    AMD_RUNTIME_COUNTERS(AMD_METRIC_ENUM)
+    CounterLast
+  };
+
+  enum Histogram {
+    AMD_RUNTIME_HISTOGRAMS(AMD_METRIC_ENUM)
+    HistogramLast
+#undef AMD_METRIC_ENUM
+  };
+
+  //! Adds the value to the counter
+  static void add(Counter id, uint64_t value = 1) {
+    counters_[id].value_.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  //! Adds a sample to the histogram
+  static void record(Histogram id, uint64_t value);
+
+  //! Returns the number of the exported values
+  static size_t count();
+
+  //! Copies up to count exported names and values, returns the number of the copied values.
+  //! Every histogram is exported as the _count, _sum, _max, _p50 and _p99 values
+  static size_t snapshot(const char** names, uint64_t* values, size_t count);
+
+  //! Starts the periodic dump into AMD_METRICS_FILE
+  static void init();
+
+  //! Stops the periodic dump and writes the final values
+  static void tearDown();
+
+ private:
+  static constexpr uint32_t kNumBuckets = 64;  //!< log2 buckets of the histograms
+  static constexpr uint32_t kHistogramValues = 5;  //!< Exported values of a histogram
+
+  //! The counters are updated from many threads, hence avoid the false sharing
+  struct alignas(64) CounterSlot {
+    std::atomic<uint64_t> value_{0};
+  };
+
+  struct alignas(64) HistogramSlot {
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+    std::atomic<uint64_t> buckets_[kNumBuckets] = {};
+
+    //! Returns the upper bound of the bucket, which holds the requested percentile
+    uint64_t percentile(uint32_t pct) const;
+  };
+
+  //! Writes all values into the file in the Prometheus text format
+  static void dump(const std::string& fileName);
+
+  static CounterSlot counters_[CounterLast];        //!< The counter values
+  static HistogramSlot histograms_[HistogramLast];  //!< The histogram values
+};
+
+}  // namespace amd
+
+#endif  // METRICS_HPP_
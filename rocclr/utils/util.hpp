@@ -24,7 +24,11 @@
 #include "top.hpp"
 
 #include <atomic>
+#include <cstring>
+#include <initializer_list>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #ifdef _WIN32
 #include <intrin.h>
@@ -284,6 +288,132 @@ inline float half2float(const uint16_t Val) {
   return fArg;
 }
 
+/*! \brief A vector with inline storage for the first \a N elements.
+ *
+ * Short lists, such as the command wait lists built on every API call, don't touch the heap.
+ * Only trivially copyable elements are supported.
+ */
+template <typename T, size_t N> class SmallVector {
+  static_assert(std::is_trivially_copyable<T>::value, "SmallVector needs trivial elements");
+  static_assert(N > 0, "SmallVector needs inline storage");
+
+  T* data_;          //!< Current storage, either inline_ or a heap array
+  size_t size_;      //!< Number of elements
+  size_t capacity_;  //!< Number of elements the current storage can hold
+  T inline_[N];      //!< Inline storage
+
+  bool isInline() const { return data_ == inline_; }
+
+  void grow(size_t capacity) {
+    T* data = new T[capacity];
+    std::memcpy(data, data_, size_ * sizeof(T));
+    if (!isInline()) {
+      delete[] data_;
+    }
+    data_ = data;
+    capacity_ = capacity;
+  }
+
+ public:
+  typedef T value_type;
+  typedef T* iterator;
+  typedef const T* const_iterator;
+
+  SmallVector() : data_(inline_), size_(0), capacity_(N) {}
+  explicit SmallVector(size_t count) : SmallVector() { resize(count); }
+  SmallVector(std::initializer_list<T> list) : SmallVector() {
+    reserve(list.size());
+    for (const auto& value : list) {
+      data_[size_++] = value;
+    }
+  }
+  SmallVector(const SmallVector& other) : SmallVector() { *this = other; }
+  SmallVector(SmallVector&& other) : SmallVector() { *this = std::move(other); }
+
+  ~SmallVector() {
+    if (!isInline()) {
+      delete[] data_;
+    }
+  }
+
+  SmallVector& operator=(const SmallVector& other) {
+    if (this != &other) {
+      size_ = 0;
+      reserve(other.size_);
+      std::memcpy(data_, other.data_, other.size_ * sizeof(T));
+      size_ = other.size_;
+    }
+    return *this;
+  }
+
+  SmallVector& operator=(SmallVector&& other) {
+    if (this == &other) {
+      return *this;
+    }
+    if (other.isInline()) {
+      *this = static_cast<const SmallVector&>(other);
+    } else {
+      // Take over the heap array of the other vector
+      if (!isInline()) {
+        delete[] data_;
+      }
+      data_ = other.data_;
+      size_ = other.size_;
+      capacity_ = other.capacity_;
+      other.data_ = other.inline_;
+      other.capacity_ = N;
+    }
+    other.size_ = 0;
+    return *this;
+  }
+
+  void reserve(size_t capacity) {
+    if (capacity > capacity_) {
+      grow(capacity);
+    }
+  }
+
+  void resize(size_t count) {
+    reserve(count);
+    for (size_t i = size_; i < count; ++i) {
+      data_[i] = T();
+    }
+    size_ = count;
+  }
+
+  void push_back(const T& value) {
+    if (size_ == capacity_) {
+      // The value may live in the current storage
+      const T copy = value;
+      grow(2 * capacity_);
+      data_[size_++] = copy;
+    } else {
+      data_[size_++] = value;
+    }
+  }
+
+  void pop_back() { --size_; }
+  void clear() { size_ = 0; }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  T* data() { return data_; }
+  const T* data() const { return data_; }
+
+  T& operator[](size_t idx) { return data_[idx]; }
+  const T& operator[](size_t idx) const { return data_[idx]; }
+  T& front() { return data_[0]; }
+  const T& front() const { return data_[0]; }
+  T& back() { return data_[size_ - 1]; }
+  const T& back() const { return data_[size_ - 1]; }
+
+  iterator begin() { return data_; }
+  iterator end() { return data_ + size_; }
+  const_iterator begin() const { return data_; }
+  const_iterator end() const { return data_ + size_; }
+};
+
 /*@}*/} // namespace amd
 
 #endif /*UTIL_HPP_*/